@@ -0,0 +1,353 @@
+/**
+ * @file    app_ahrs.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.2.0 (beta)
+ * @brief   Task que calcula a orientacao da placa com LSM6DSL e LIS3MDL
+ * @details
+ * A task assina giroscopio, acelerometro e magnetometro nas taxas que precisa,
+ * roda na taxa efetiva do giroscopio e le as amostras pelo cache de sensores,
+ * de modo que o shell e outras tasks reaproveitam as mesmas leituras. A
+ * conversao para float acontece somente aqui, na entrada do filtro.
+ *
+ * O periodo da task acompanha o ODR do giroscopio (o aviso do registro chega
+ * quando app_motion ou o shell mudam a taxa) e o dt do filtro e medido entre
+ * os instantes de captura das amostras, nao deduzido do periodo em ticks.
+ *
+ * A cada iteracao a aceleracao e levada ao eixo vertical da Terra pela
+ * orientacao estimada, sem a gravidade, e integrada ate alguem consumir com
+ * AppAhrs_GetVertical (app_baro, para a velocidade vertical).
+ *
+ * AppAhrs_Enable(false) libera as assinaturas e para a task, para que os
+ * sensores possam ser desligados enquanto a placa esta parada (app_motion).
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_ahrs.h"
+#include "sensor_cache.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Periodo usado se o giroscopio estiver desligado */
+#define APP_AHRS_DEFAULT_PERIOD_MS		20
+
+/** @brief dt medido acima de N periodos nominais e descartado (pausa, falha) */
+#define APP_AHRS_MAX_DT_PERIODS			4
+
+/** @brief Taxa pedida ao giroscopio e ao acelerometro (mHz) */
+#define APP_AHRS_RATE_MHZ				52000
+
+/** @brief Taxa pedida ao magnetometro (mHz); o rumo muda devagar */
+#define APP_AHRS_MAG_RATE_MHZ			20000
+
+/** @brief Prioridade da task, acima do shell e dos leds */
+#define APP_AHRS_TASK_PRIORITY			4
+
+/** @brief Canais convertidos pelo registro: giroscopio em mdps, acelerometro em mg */
+#define APP_AHRS_MDPS_TO_RAD			(1.0e-3f * 0.017453293f)
+#define APP_AHRS_MG_PER_G				1000.0f
+
+/** @brief rad/s para dps */
+#define APP_AHRS_RAD_TO_DPS				57.29577951f
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static Ahrs_t ahrs;
+
+static AppAhrsOutput_t ahrsOutput;
+
+/** @brief Integrais da aceleracao vertical (AppAhrs_GetVertical) */
+static AppAhrsVertical_t ahrsVertical;
+
+static uint8_t gyro_id = SENSOR_DRV_INVALID;
+static uint8_t acc_id = SENSOR_DRV_INVALID;
+static uint8_t mag_id = SENSOR_DRV_INVALID;
+
+/** @brief Assinaturas de giroscopio, acelerometro e magnetometro */
+static uint8_t ahrsSubs[3] = { SENSOR_DRV_INVALID, SENSOR_DRV_INVALID, SENSOR_DRV_INVALID };
+
+/** @brief LSB do giroscopio para rad/s e LSB do acelerometro por g (de desc->scale) */
+static float gyroToRad = 0.0f;
+static float accPerG = 1.0f;
+
+static volatile bool ahrsEnabled = false;
+static TaskHandle_t ahrsTask = NULL;
+
+/** @brief Sinalizado pelo registro quando a taxa do giroscopio pode ter mudado */
+static volatile bool ahrsRateChanged = true;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppAhrs_Task(void *param);
+
+/**
+ * Assina os sensores nas taxas do filtro ou libera as assinaturas.
+ * @param enable true para assinar.
+ */
+static void AppAhrs_Subscribe(bool enable);
+
+/**
+ * Periodo da task em ticks para o ODR atual do giroscopio, arredondado.
+ * @param nominal_us Saida com o periodo da amostra em us.
+ * @return Periodo em ticks (minimo 1).
+ */
+static TickType_t AppAhrs_Period(uint32_t *nominal_us);
+
+/**
+ * Callback do registro de sensores (SensorDrv_AddNotify).
+ * @param id Canal cujo modo ou taxa mudou.
+ */
+static void AppAhrs_OnChange(uint8_t id);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void AppAhrs_Subscribe(bool enable)
+{
+	uint8_t i;
+
+	for (i = 0; i < 3; i++)
+	{
+		if (ahrsSubs[i] != SENSOR_DRV_INVALID)
+		{
+			SensorDrv_Unsubscribe(ahrsSubs[i]);
+			ahrsSubs[i] = SENSOR_DRV_INVALID;
+		}
+	}
+
+	if (enable == false)
+	{
+		return;
+	}
+
+	/* O filtro integra o giroscopio: ruido baixo vale mais que o consumo */
+	ahrsSubs[0] = SensorDrv_Subscribe(gyro_id, APP_AHRS_RATE_MHZ, SENSOR_POWER_NORMAL);
+	ahrsSubs[1] = SensorDrv_Subscribe(acc_id, APP_AHRS_RATE_MHZ, SENSOR_POWER_NORMAL);
+
+	if (mag_id != SENSOR_DRV_INVALID)
+	{
+		ahrsSubs[2] = SensorDrv_Subscribe(mag_id, APP_AHRS_MAG_RATE_MHZ, SENSOR_POWER_LOW);
+	}
+}
+
+static TickType_t AppAhrs_Period(uint32_t *nominal_us)
+{
+	uint32_t odr;
+	TickType_t period;
+
+	odr = SensorDrv_GetRate(gyro_id);
+	if (odr == 0)
+	{
+		*nominal_us = APP_AHRS_DEFAULT_PERIOD_MS * 1000UL;
+		return pdMS_TO_TICKS(APP_AHRS_DEFAULT_PERIOD_MS);
+	}
+
+	/* odr em mHz: 52 Hz da 19.2 ticks a 1 kHz; truncar perderia amostras */
+	*nominal_us = (uint32_t) (1000000000ULL / odr);
+	period = (TickType_t) (((uint64_t) configTICK_RATE_HZ * 1000UL + odr / 2) / odr);
+
+	return (period == 0) ? 1 : period;
+}
+
+static void AppAhrs_OnChange(uint8_t id)
+{
+	if (id == gyro_id)
+	{
+		ahrsRateChanged = true;
+	}
+}
+
+static void AppAhrs_Task(void *param)
+{
+	TickType_t last_wake, period = 1;
+	int32_t gyro_raw[3] = { 0 }, acc_raw[3] = { 0 }, mag_raw[3] = { 0 };
+	float gyro[3], acc[3], mag[3];
+	uint64_t capture, last_capture = 0;
+	uint32_t nominal_us = 0, start, cycles;
+	float dt, a_up;
+	bool use_mag;
+	uint8_t i;
+
+	AHRS_Init(&ahrs, 1000.0f / APP_AHRS_DEFAULT_PERIOD_MS, AHRS_DEFAULT_KP, AHRS_DEFAULT_KI);
+
+	last_wake = xTaskGetTickCount();
+
+	for (;;)
+	{
+		if (ahrsEnabled == false)
+		{
+			/* O estado do filtro e mantido; ele reconverge apos a pausa */
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			last_wake = xTaskGetTickCount();
+			last_capture = 0;
+			continue;
+		}
+
+		if (ahrsRateChanged == true)
+		{
+			ahrsRateChanged = false;
+			period = AppAhrs_Period(&nominal_us);
+		}
+
+		vTaskDelayUntil(&last_wake, period);
+
+		if (SensorCache_ReadStamped(gyro_id, gyro_raw, false, &capture) != HAL_OK)
+		{
+			continue;
+		}
+
+		/* Hit de cache: a mesma amostra ja entrou no filtro */
+		if (capture == last_capture)
+		{
+			continue;
+		}
+
+		if (SensorCache_Read(acc_id, acc_raw, false) != HAL_OK)
+		{
+			continue;
+		}
+
+		use_mag = (SensorCache_Read(mag_id, mag_raw, false) == HAL_OK);
+
+		/* Primeira amostra, retomada ou buraco longo: usa o periodo nominal */
+		if ((last_capture == 0) || ((capture - last_capture) > (uint64_t) nominal_us * APP_AHRS_MAX_DT_PERIODS))
+		{
+			dt = (float) nominal_us * 1.0e-6f;
+		}
+		else
+		{
+			dt = (float) (capture - last_capture) * 1.0e-6f;
+		}
+		last_capture = capture;
+		AHRS_SetPeriod(&ahrs, dt);
+
+		for (i = 0; i < 3; i++)
+		{
+			gyro[i] = (float) gyro_raw[i] * gyroToRad;
+			acc[i] = (float) acc_raw[i];
+			mag[i] = (float) mag_raw[i];
+		}
+
+		start = Timebase_Cycles32();
+		AHRS_Update(&ahrs, gyro, acc, use_mag ? mag : NULL);
+		cycles = Timebase_Cycles32() - start;
+
+		a_up = AHRS_VerticalAccel(&ahrs, acc, accPerG);
+
+		taskENTER_CRITICAL();
+		ahrsVertical.dp += ahrsVertical.dv * dt + 0.5f * a_up * dt * dt;
+		ahrsVertical.dv += a_up * dt;
+		ahrsVertical.dt += dt;
+		memcpy(ahrsOutput.q, ahrs.q, sizeof(ahrsOutput.q));
+		for (i = 0; i < 3; i++)
+		{
+			ahrsOutput.bias_dps[i] = ahrs.bias[i] * APP_AHRS_RAD_TO_DPS;
+		}
+		ahrsOutput.updates++;
+		ahrsOutput.cycles_last = cycles;
+		if (cycles > ahrsOutput.cycles_max)
+		{
+			ahrsOutput.cycles_max = cycles;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppAhrs_TaskInit(void)
+{
+	BaseType_t xReturned;
+
+	memset(&ahrsOutput, 0, sizeof(ahrsOutput));
+	ahrsOutput.q[0] = 1.0f;
+
+	gyro_id = SensorDrv_Find(SENSOR_TYPE_GYRO, NULL);
+	acc_id = SensorDrv_Find(SENSOR_TYPE_ACCELERO, NULL);
+	mag_id = SensorDrv_Find(SENSOR_TYPE_MAGNETO, NULL);
+
+	/* Sem giroscopio ou acelerometro nao ha o que estimar */
+	if ((gyro_id == SENSOR_DRV_INVALID) || (acc_id == SENSOR_DRV_INVALID))
+	{
+		DBG("AHRS: giroscopio ou acelerometro ausente");
+		return;
+	}
+
+	/* Escala do canal: o acelerometro entrega ug (mg com scale 1000), nao mg */
+	gyroToRad = APP_AHRS_MDPS_TO_RAD / (float) SensorDrv_GetDesc(gyro_id)->scale;
+	accPerG = APP_AHRS_MG_PER_G * (float) SensorDrv_GetDesc(acc_id)->scale;
+
+	AppAhrs_Subscribe(true);
+	ahrsEnabled = true;
+
+	SensorDrv_AddNotify(AppAhrs_OnChange);
+
+	xReturned = xTaskCreate(AppAhrs_Task, "tkAhrs", configMINIMAL_STACK_SIZE * 2, NULL, APP_AHRS_TASK_PRIORITY, &ahrsTask);
+	configASSERT(xReturned);
+}
+
+void AppAhrs_Enable(bool enable)
+{
+	if ((ahrsTask == NULL) || (enable == ahrsEnabled))
+	{
+		return;
+	}
+
+	AppAhrs_Subscribe(enable);
+	ahrsEnabled = enable;
+
+	if (enable == true)
+	{
+		xTaskNotifyGive(ahrsTask);
+	}
+}
+
+bool AppAhrs_IsEnabled(void)
+{
+	return ahrsEnabled;
+}
+
+void AppAhrs_Get(AppAhrsOutput_t *out)
+{
+	Ahrs_t tmp;
+
+	taskENTER_CRITICAL();
+	*out = ahrsOutput;
+	taskEXIT_CRITICAL();
+
+	/* Euler so e calculado sob demanda, fora do laco do filtro */
+	memcpy(tmp.q, out->q, sizeof(tmp.q));
+	AHRS_GetEuler(&tmp, &out->euler);
+}
+
+bool AppAhrs_GetVertical(AppAhrsVertical_t *vert)
+{
+	taskENTER_CRITICAL();
+	*vert = ahrsVertical;
+	memset(&ahrsVertical, 0, sizeof(ahrsVertical));
+	taskEXIT_CRITICAL();
+
+	return (vert->dt > 0.0f);
+}
+
+void AppAhrs_ResetStats(void)
+{
+	taskENTER_CRITICAL();
+	ahrsOutput.cycles_max = 0;
+	taskEXIT_CRITICAL();
+}
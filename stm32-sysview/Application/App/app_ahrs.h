@@ -0,0 +1,87 @@
+/**
+ * @file    app_ahrs.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Task que calcula a orientacao da placa com LSM6DSL e LIS3MDL
+ */
+
+#ifndef _APP_AHRS_H_
+#define _APP_AHRS_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "ahrs/ahrs.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Ultima saida do filtro e custo de processamento */
+typedef struct
+{
+	float q[4];             /**< Quaternion w, x, y, z */
+	AhrsEuler_t euler;      /**< Roll, pitch e yaw em graus */
+	float bias_dps[3];      /**< Bias estimado do giroscopio em dps */
+	uint32_t updates;       /**< Numero de iteracoes executadas */
+	uint32_t cycles_last;   /**< Ciclos de CPU da ultima AHRS_Update */
+	uint32_t cycles_max;    /**< Maior numero de ciclos observado */
+} AppAhrsOutput_t;
+
+/** @brief Aceleracao vertical (Terra, sem gravidade) integrada desde a ultima leitura */
+typedef struct
+{
+	float dv;               /**< Soma de a*dt (m/s) */
+	float dp;               /**< Soma de dv*dt + a*dt^2/2 (m) */
+	float dt;               /**< Intervalo coberto (s) */
+} AppAhrsVertical_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Cria a task do AHRS. A taxa segue o ODR do giroscopio. */
+void AppAhrs_TaskInit(void);
+
+/**
+ * Copia a ultima saida do filtro.
+ * @param out Estrutura de saida.
+ */
+void AppAhrs_Get(AppAhrsOutput_t *out);
+
+/**
+ * Entrega e zera a aceleracao vertical integrada pelo filtro (Libs/altitude).
+ * @param vert Saida.
+ * @return false se nao houve iteracao desde a ultima leitura.
+ */
+bool AppAhrs_GetVertical(AppAhrsVertical_t *vert);
+
+/** @brief Zera o contador de ciclos maximo. */
+void AppAhrs_ResetStats(void);
+
+/**
+ * Pausa ou retoma o filtro. Pausado, as assinaturas sao liberadas e os
+ * sensores podem ser desligados pelo registro.
+ * @param enable true para rodar.
+ */
+void AppAhrs_Enable(bool enable);
+
+/** @brief true se o filtro esta rodando. */
+bool AppAhrs_IsEnabled(void);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_AHRS_H_ */
@@ -0,0 +1,342 @@
+/**
+ * @file    app_audio.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Captura do microfone MEMS pelo DFSDM e processamento em blocos
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_audio.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Acima da telemetria e do shell: o DMA nao espera */
+#define APP_AUDIO_TASK_PRIORITY			3
+
+/** @brief Metade do buffer a cada 10 ms */
+#define APP_AUDIO_BLOCKS_PER_SECOND		100
+
+/** @brief Maior bloco (48 kHz) */
+#define APP_AUDIO_MAX_BLOCK				(48000 / APP_AUDIO_BLOCKS_PER_SECOND)
+
+/** @brief Bits de notificacao da task */
+#define APP_AUDIO_NOTIFY_HALF			0x01UL
+#define APP_AUDIO_NOTIFY_FULL			0x02UL
+#define APP_AUDIO_NOTIFY_ALL			(APP_AUDIO_NOTIFY_HALF | APP_AUDIO_NOTIFY_FULL)
+
+#define APP_AUDIO_MUTEX_TIMEOUT			1000
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Programacao do DFSDM para uma taxa */
+typedef struct
+{
+	uint32_t rate_hz;
+	uint32_t divider;       /**< Clock do DFSDM / clock do microfone */
+	uint32_t fosr;          /**< Decimacao do sinc3 */
+	uint8_t shift;          /**< FOSR^3 >> shift cabe em 16 bits */
+} AppAudioRate_t;
+
+//==============================================================================
+// EXTERN VARIABLES
+//==============================================================================
+
+extern DFSDM_Channel_HandleTypeDef hdfsdm1_channel1;
+extern DFSDM_Filter_HandleTypeDef hdfsdm1_filter2;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static const AppAudioRate_t audioRates[] =
+{
+	{ 16000, 40, 125, 6 },
+	{ 32000, 50, 50, 2 },
+	{ 48000, 32, 52, 3 },
+};
+
+static const AppAudioRate_t *audioRate = &audioRates[0];
+
+/** @brief Duas metades; o DMA escreve a palavra inteira do RDATAR */
+static int32_t audioDma[2 * APP_AUDIO_MAX_BLOCK];
+static int16_t audioPcm[APP_AUDIO_MAX_BLOCK];
+static float audioWork[AUDIO_DSP_WORK_SIZE(APP_AUDIO_FFT_SIZE)];
+
+static AudioDsp_t audioDsp;
+static AppAudioStatus_t audioStatus;
+
+static SemaphoreHandle_t mutex_audio = NULL;
+static TaskHandle_t audioTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppAudio_Task(void *param);
+
+/**
+ * Reprograma o clock do canal e a decimacao do filtro.
+ * @param rate Taxa escolhida.
+ */
+static HAL_StatusTypeDef AppAudio_Config(const AppAudioRate_t *rate);
+
+/**
+ * Converte e processa uma metade do buffer.
+ * @param dma Inicio da metade pronta.
+ */
+static void AppAudio_Block(const int32_t *dma);
+
+/**
+ * Notifica a task pela interrupcao do DMA.
+ * @param bit Metade pronta.
+ */
+static void AppAudio_Notify(uint32_t bit, BaseType_t *pxHigherPriorityTaskWoken);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static HAL_StatusTypeDef AppAudio_Config(const AppAudioRate_t *rate)
+{
+	/* O clock de saida so e reprogramado com todos os canais desligados */
+	HAL_DFSDM_FilterDeInit(&hdfsdm1_filter2);
+	HAL_DFSDM_ChannelDeInit(&hdfsdm1_channel1);
+
+	hdfsdm1_channel1.Init.OutputClock.Divider = rate->divider;
+	if (HAL_DFSDM_ChannelInit(&hdfsdm1_channel1) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	hdfsdm1_filter2.Init.FilterParam.Oversampling = rate->fosr;
+	if (HAL_DFSDM_FilterInit(&hdfsdm1_filter2) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	return HAL_DFSDM_FilterConfigRegChannel(&hdfsdm1_filter2, DFSDM_CHANNEL_1, DFSDM_CONTINUOUS_CONV_ON);
+}
+
+static void AppAudio_Block(const int32_t *dma)
+{
+	uint32_t start, cycles;
+
+	if (xSemaphoreTake(mutex_audio, APP_AUDIO_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return;
+	}
+
+	start = Timebase_Cycles32();
+
+	AudioDsp_FromDfsdm(dma, audioPcm, audioStatus.block, audioRate->shift);
+	AudioDsp_Process(&audioDsp, audioPcm, audioStatus.block);
+
+	cycles = Timebase_Cycles32() - start;
+
+	audioStatus.cycles_last = cycles;
+	audioStatus.cycles_total += cycles;
+	if (cycles > audioStatus.cycles_max)
+	{
+		audioStatus.cycles_max = cycles;
+	}
+
+	xSemaphoreGive(mutex_audio);
+}
+
+static void AppAudio_Notify(uint32_t bit, BaseType_t *pxHigherPriorityTaskWoken)
+{
+	uint32_t pending = 0;
+
+	if (audioTask == NULL)
+	{
+		return;
+	}
+
+	xTaskNotifyAndQueryFromISR(audioTask, bit, eSetBits, &pending, pxHigherPriorityTaskWoken);
+
+	/* A metade ainda pendente e a que o DMA comecou a sobrescrever */
+	if (pending & APP_AUDIO_NOTIFY_ALL)
+	{
+		audioStatus.overruns++;
+	}
+}
+
+static void AppAudio_Task(void *param)
+{
+	uint32_t bits;
+
+	for (;;)
+	{
+		xTaskNotifyWait(0, APP_AUDIO_NOTIFY_ALL, &bits, portMAX_DELAY);
+
+		if (audioStatus.running == false)
+		{
+			continue;
+		}
+
+		if (bits & APP_AUDIO_NOTIFY_HALF)
+		{
+			AppAudio_Block(&audioDma[0]);
+		}
+
+		if (bits & APP_AUDIO_NOTIFY_FULL)
+		{
+			AppAudio_Block(&audioDma[audioStatus.block]);
+		}
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppAudio_TaskInit(void)
+{
+	BaseType_t xReturned;
+
+	memset(&audioStatus, 0, sizeof(audioStatus));
+
+	if (mutex_audio == NULL)
+	{
+		mutex_audio = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_audio);
+		vQueueAddToRegistry(mutex_audio, "audio");
+	}
+
+	xReturned = xTaskCreate(AppAudio_Task, "tkAudio", configMINIMAL_STACK_SIZE * 2, NULL, APP_AUDIO_TASK_PRIORITY, &audioTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppAudio_Start(uint32_t rate_hz)
+{
+	const AppAudioRate_t *rate = NULL;
+	HAL_StatusTypeDef status;
+	uint8_t i;
+
+	for (i = 0; i < sizeof(audioRates) / sizeof(audioRates[0]); i++)
+	{
+		if (audioRates[i].rate_hz == rate_hz)
+		{
+			rate = &audioRates[i];
+		}
+	}
+
+	if (rate == NULL)
+	{
+		return HAL_ERROR;
+	}
+
+	AppAudio_Stop();
+
+	if (xSemaphoreTake(mutex_audio, APP_AUDIO_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	status = AppAudio_Config(rate);
+	if (status == HAL_OK)
+	{
+		audioRate = rate;
+
+		memset(&audioStatus, 0, sizeof(audioStatus));
+		audioStatus.rate_hz = rate->rate_hz;
+		audioStatus.actual_hz = HAL_RCC_GetPCLK2Freq() / rate->divider / rate->fosr;
+		audioStatus.block = (uint16_t) (rate->rate_hz / APP_AUDIO_BLOCKS_PER_SECOND);
+		audioStatus.cycles_budget = SystemCoreClock / APP_AUDIO_BLOCKS_PER_SECOND;
+
+		AudioDsp_Init(&audioDsp, audioStatus.actual_hz, APP_AUDIO_FFT_SIZE, audioWork);
+		memset(audioDma, 0, sizeof(audioDma));
+
+		audioStatus.running = true;
+		status = HAL_DFSDM_FilterRegularStart_DMA(&hdfsdm1_filter2, audioDma, 2U * audioStatus.block);
+		if (status != HAL_OK)
+		{
+			audioStatus.running = false;
+		}
+	}
+
+	xSemaphoreGive(mutex_audio);
+
+	return status;
+}
+
+void AppAudio_Stop(void)
+{
+	xSemaphoreTake(mutex_audio, portMAX_DELAY);
+
+	if (audioStatus.running == true)
+	{
+		HAL_DFSDM_FilterRegularStop_DMA(&hdfsdm1_filter2);
+		audioStatus.running = false;
+	}
+
+	xSemaphoreGive(mutex_audio);
+}
+
+void AppAudio_GetStatus(AppAudioStatus_t *status)
+{
+	xSemaphoreTake(mutex_audio, portMAX_DELAY);
+
+	*status = audioStatus;
+	status->dsp = audioDsp.res;
+
+	xSemaphoreGive(mutex_audio);
+}
+
+float AppAudio_GetBands(float *db, uint8_t bands)
+{
+	uint16_t bins = APP_AUDIO_FFT_SIZE / 2;
+	uint16_t width, b, k;
+	float hz = 0.0f;
+
+	if ((bands == 0) || (bins % bands != 0))
+	{
+		return 0.0f;
+	}
+
+	width = bins / bands;
+
+	xSemaphoreTake(mutex_audio, portMAX_DELAY);
+
+	if (audioDsp.res.spectra > 0)
+	{
+		for (b = 0; b < bands; b++)
+		{
+			db[b] = AUDIO_DSP_MIN_DB;
+			for (k = b * width; k < (b + 1) * width; k++)
+			{
+				if (audioDsp.spectrum[k] > db[b])
+				{
+					db[b] = audioDsp.spectrum[k];
+				}
+			}
+		}
+
+		hz = (float) width * (float) audioDsp.rate_hz / (float) APP_AUDIO_FFT_SIZE;
+	}
+
+	xSemaphoreGive(mutex_audio);
+
+	return hz;
+}
+
+void AppAudio_DmaHalf(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	AppAudio_Notify(APP_AUDIO_NOTIFY_HALF, pxHigherPriorityTaskWoken);
+}
+
+void AppAudio_DmaFull(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	AppAudio_Notify(APP_AUDIO_NOTIFY_FULL, pxHigherPriorityTaskWoken);
+}
@@ -0,0 +1,113 @@
+/**
+ * @file    app_audio.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Captura do microfone MEMS pelo DFSDM e processamento em blocos
+ * @details
+ * O filtro 2 do DFSDM converte o canal 1 (pinos DATIN2/CKOUT do MP34DT01)
+ * continuamente e o DMA1 canal 6 copia as palavras para um buffer circular
+ * de duas metades de 10 ms. As interrupcoes de meia e de transferencia
+ * completa so notificam a task, que converte a metade pronta para PCM 16
+ * bits e passa por Libs/audio_dsp (nivel, atividade e espectro) enquanto o
+ * DMA enche a outra. Se a task ainda nao consumiu a metade anterior quando a
+ * proxima fica pronta, conta um overrun.
+ *
+ * Taxas (clock do DFSDM de 80 MHz, filtro sinc3):
+ *   16000 Hz: divisor 40 (2 MHz), FOSR 125 -> 16000 Hz
+ *   32000 Hz: divisor 50 (1.6 MHz), FOSR 50 -> 32000 Hz
+ *   48000 Hz: divisor 32 (2.5 MHz), FOSR 52 -> 48077 Hz
+ */
+
+#ifndef _APP_AUDIO_H_
+#define _APP_AUDIO_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "audio_dsp/audio_dsp.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Pontos do espectro */
+#define APP_AUDIO_FFT_SIZE			512
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado da captura e resultados do processamento */
+typedef struct
+{
+	bool running;
+	uint32_t rate_hz;       /**< Taxa pedida */
+	uint32_t actual_hz;     /**< Taxa real: clock / divisor / FOSR */
+	uint16_t block;         /**< Amostras por metade do buffer */
+	uint32_t overruns;      /**< Metades sobrescritas antes do processamento */
+	uint32_t cycles_last;   /**< Ciclos do ultimo bloco (conversao e DSP) */
+	uint32_t cycles_max;
+	uint64_t cycles_total;
+	uint32_t cycles_budget; /**< Ciclos disponiveis por bloco */
+	AudioDspResult_t dsp;
+} AppAudioStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Cria a task de audio (parada). */
+void AppAudio_TaskInit(void);
+
+/**
+ * Reprograma o DFSDM para a taxa e inicia a captura.
+ * @param rate_hz 16000, 32000 ou 48000.
+ * @return HAL_OK, HAL_ERROR se a taxa nao for suportada.
+ */
+HAL_StatusTypeDef AppAudio_Start(uint32_t rate_hz);
+
+/** @brief Para a captura. */
+void AppAudio_Stop(void);
+
+/**
+ * Copia o estado e os resultados.
+ * @param status Saida.
+ */
+void AppAudio_GetStatus(AppAudioStatus_t *status);
+
+/**
+ * Resume o ultimo espectro em faixas de mesma largura.
+ * @param db Saida: maior bin de cada faixa em dBFS.
+ * @param bands Faixas (divisor de APP_AUDIO_FFT_SIZE / 2).
+ * @return Largura de cada faixa em Hz, 0 se nao houver espectro.
+ */
+float AppAudio_GetBands(float *db, uint8_t bands);
+
+/**
+ * Chamada na interrupcao de meia transferencia do DMA.
+ * @param pxHigherPriorityTaskWoken Repassado ao FreeRTOS.
+ */
+void AppAudio_DmaHalf(BaseType_t *pxHigherPriorityTaskWoken);
+
+/**
+ * Chamada na interrupcao de transferencia completa do DMA.
+ * @param pxHigherPriorityTaskWoken Repassado ao FreeRTOS.
+ */
+void AppAudio_DmaFull(BaseType_t *pxHigherPriorityTaskWoken);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_AUDIO_H_ */
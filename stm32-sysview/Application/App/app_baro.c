@@ -0,0 +1,394 @@
+/**
+ * @file    app_baro.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Altitude e velocidade vertical pelo FIFO do LPS22HB
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_baro.h"
+#include "app_ahrs.h"
+#include "app_telemetry.h"
+
+#include "lps22hb/lps22hb.h"
+#include "sensor_drv/sensor_drv.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Como a telemetria: o FIFO segura o lote ate ser lido */
+#define APP_BARO_TASK_PRIORITY		2
+
+/**
+ * @brief Sem interrupcao por este tempo, esvazia o FIFO assim mesmo: o
+ * INT_DRDY fica alto enquanto o nivel passa do watermark e uma borda
+ * perdida nao volta.
+ */
+#define APP_BARO_POLL_MS			500
+
+/** @brief Pressao: 4096 LSB/hPa; temperatura: 100 LSB/C */
+#define APP_BARO_LSB_HPA			4096.0f
+#define APP_BARO_LSB_C				100.0f
+
+/** @brief LPF do CI em ODR/9 (SensorDrv_SetFilter) */
+#define APP_BARO_LPF_LEVEL			9
+
+#define APP_BARO_TLM_SIGNALS		2
+
+/** @brief Espera maxima pelo mutex ao montar um quadro de telemetria */
+#define APP_BARO_TLM_TIMEOUT		5
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static AppBaroStatus_t baroStatus;
+
+static Alt_t baroAlt;
+
+/** @brief Lote lido do FIFO (so a task usa) */
+static int32_t baroBatch[LPS22HB_FIFO_SIZE];
+
+static TickType_t startTick, lastTick;
+
+static uint8_t baro_id = SENSOR_DRV_INVALID;
+static uint8_t temp_id = SENSOR_DRV_INVALID;
+static uint8_t baroSub = SENSOR_DRV_INVALID;
+
+/** @brief Contadores do driver no inicio das estatisticas */
+static uint32_t baseTransfers, baseBytes, baseSamples;
+
+static const TlmSignal_t baroSignals[APP_BARO_TLM_SIGNALS] =
+{
+	{ "baro.alt", "cm", 1 },
+	{ "baro.vz", "cm/s", 1 },
+};
+
+static SemaphoreHandle_t mutex_baro = NULL;
+static TaskHandle_t baroTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppBaro_Task(void *param);
+
+/**
+ * Passo do filtro com um lote ja lido (com o mutex).
+ * @param count Amostras em baroBatch.
+ */
+static void AppBaro_Update(uint16_t count);
+
+/**
+ * Leitor de telemetria: 0 = altitude, 1 = velocidade vertical.
+ */
+static bool AppBaro_TlmRead(uint8_t arg, int32_t *value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void AppBaro_Update(uint16_t count)
+{
+	AppAhrsVertical_t vert;
+	TickType_t now = xTaskGetTickCount();
+	int64_t sum = 0;
+	int32_t temp;
+	float odr, age, dt;
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		sum += baroBatch[i];
+	}
+
+	baroStatus.pressure_hpa = (float) sum / ((float) count * APP_BARO_LSB_HPA);
+	baroStatus.baro_m = Alt_FromPressure(baroStatus.pressure_hpa, baroStatus.p0_hpa);
+
+	/* Temperatura da ultima posicao do FIFO, guardada pelo driver */
+	if (SensorDrv_Read(temp_id, &temp) == HAL_OK)
+	{
+		baroStatus.temp_c = (float) temp / APP_BARO_LSB_C;
+	}
+
+	/* A media do lote vale no meio dele */
+	odr = (float) baroStatus.rate_mhz / 1000.0f;
+	age = (odr > 0.0f) ? (float) (count - 1) / (2.0f * odr) : 0.0f;
+	dt = (float) (now - lastTick) / (float) configTICK_RATE_HZ;
+	lastTick = now;
+
+	baroStatus.accel = AppAhrs_GetVertical(&vert);
+
+	if (baroStatus.accel == true)
+	{
+		Alt_Predict(&baroAlt, vert.dv, vert.dp, vert.dt);
+	}
+	else
+	{
+		Alt_Predict(&baroAlt, 0.0f, 0.0f, dt);
+	}
+
+	Alt_Correct(&baroAlt, baroStatus.baro_m, age, dt);
+
+	baroStatus.alt_m = baroAlt.h;
+	baroStatus.vz_ms = baroAlt.v;
+	baroStatus.bias_ms2 = baroAlt.bias;
+	baroStatus.drains++;
+}
+
+static void AppBaro_Task(void *param)
+{
+	uint32_t start, bus, calc;
+	uint16_t count;
+
+	for (;;)
+	{
+		ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(APP_BARO_POLL_MS));
+
+		if (baroStatus.running == false)
+		{
+			continue;
+		}
+
+		/* Rajada unica: STATUS_FIFO e o lote inteiro (HAL bloqueante, conta como CPU) */
+		start = Timebase_Cycles32();
+		count = SensorDrv_ReadBatch(baro_id, baroBatch, LPS22HB_FIFO_SIZE);
+		bus = Timebase_Cycles32() - start;
+
+		if (count == 0)
+		{
+			continue;
+		}
+
+		xSemaphoreTake(mutex_baro, portMAX_DELAY);
+
+		if (baroStatus.running == true)
+		{
+			start = Timebase_Cycles32();
+			AppBaro_Update(count);
+			calc = Timebase_Cycles32() - start;
+
+			baroStatus.cycles_bus = bus;
+			baroStatus.cycles_calc = calc;
+			if (bus + calc > baroStatus.cycles_max)
+			{
+				baroStatus.cycles_max = bus + calc;
+			}
+		}
+
+		xSemaphoreGive(mutex_baro);
+	}
+}
+
+static bool AppBaro_TlmRead(uint8_t arg, int32_t *value)
+{
+	bool ok;
+	float x;
+
+	if (xSemaphoreTake(mutex_baro, APP_BARO_TLM_TIMEOUT) != pdTRUE)
+	{
+		return false;
+	}
+
+	ok = (baroStatus.running == true) && (baroStatus.drains > 0);
+	x = (arg == 0) ? baroStatus.alt_m : baroStatus.vz_ms;
+
+	xSemaphoreGive(mutex_baro);
+
+	/* m e m/s para cm e cm/s */
+	*value = (int32_t) (x * 100.0f + ((x < 0.0f) ? -0.5f : 0.5f));
+
+	return ok;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppBaro_TaskInit(void)
+{
+	BaseType_t xReturned;
+	uint8_t i;
+
+	memset(&baroStatus, 0, sizeof(baroStatus));
+	baroStatus.p0_hpa = ALT_STD_PRESSURE_HPA;
+
+	baro_id = SensorDrv_Find(SENSOR_TYPE_PRESSURE, "LPS22HB");
+	temp_id = SensorDrv_Find(SENSOR_TYPE_TEMPERATURE, "LPS22HB");
+
+	if (mutex_baro == NULL)
+	{
+		mutex_baro = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_baro);
+		vQueueAddToRegistry(mutex_baro, "baro");
+	}
+
+	for (i = 0; i < APP_BARO_TLM_SIGNALS; i++)
+	{
+		AppTelemetry_AddSignal(&baroSignals[i], AppBaro_TlmRead, i);
+	}
+
+	xReturned = xTaskCreate(AppBaro_Task, "tkBaro", configMINIMAL_STACK_SIZE * 2, NULL, APP_BARO_TASK_PRIORITY, &baroTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppBaro_Start(uint32_t rate_mhz, uint8_t watermark)
+{
+	AppAhrsVertical_t vert;
+	HAL_StatusTypeDef status;
+
+	if ((baro_id == SENSOR_DRV_INVALID) || (rate_mhz == 0) || (watermark == 0) || (watermark >= LPS22HB_FIFO_SIZE))
+	{
+		return HAL_ERROR;
+	}
+
+	AppBaro_Stop();
+
+	xSemaphoreTake(mutex_baro, portMAX_DELAY);
+
+	baroSub = SensorDrv_Subscribe(baro_id, rate_mhz, SENSOR_POWER_NORMAL);
+	if (baroSub == SENSOR_DRV_INVALID)
+	{
+		xSemaphoreGive(mutex_baro);
+		return HAL_ERROR;
+	}
+
+	/* Banda de ODR/9: o ruido cai e o atraso fica abaixo da constante do filtro */
+	SensorDrv_SetFilter(baro_id, APP_BARO_LPF_LEVEL);
+
+	status = SensorDrv_Lock();
+	if (status == HAL_OK)
+	{
+		LPS22HB_FifoStart(watermark);
+		SensorDrv_Unlock();
+	}
+	else
+	{
+		SensorDrv_Unsubscribe(baroSub);
+		baroSub = SENSOR_DRV_INVALID;
+		xSemaphoreGive(mutex_baro);
+		return status;
+	}
+
+	Alt_Init(&baroAlt, ALT_DEF_TAU_S);
+
+	/* Descarta o que o AHRS integrou sem consumidor */
+	AppAhrs_GetVertical(&vert);
+
+	baroStatus.rate_mhz = SensorDrv_GetOdr(baro_id);
+	baroStatus.watermark = watermark;
+	baroStatus.interrupts = 0;
+	baroStatus.drains = 0;
+	baroStatus.samples = 0;
+	baroStatus.overruns = 0;
+	baroStatus.cycles_bus = 0;
+	baroStatus.cycles_calc = 0;
+	baroStatus.cycles_max = 0;
+
+	LPS22HB_GetBusStats(&baseTransfers, &baseBytes);
+	LPS22HB_FifoGetStats(&baseSamples, &baroStatus.overruns);
+	startTick = lastTick = xTaskGetTickCount();
+
+	baroStatus.running = true;
+
+	xSemaphoreGive(mutex_baro);
+
+	return HAL_OK;
+}
+
+void AppBaro_Stop(void)
+{
+	xSemaphoreTake(mutex_baro, portMAX_DELAY);
+
+	if (baroSub != SENSOR_DRV_INVALID)
+	{
+		if (SensorDrv_Lock() == HAL_OK)
+		{
+			LPS22HB_FifoStop();
+			SensorDrv_Unlock();
+		}
+
+		SensorDrv_SetFilter(baro_id, 0);
+		SensorDrv_Unsubscribe(baroSub);
+		baroSub = SENSOR_DRV_INVALID;
+	}
+	baroStatus.running = false;
+
+	xSemaphoreGive(mutex_baro);
+}
+
+HAL_StatusTypeDef AppBaro_SetReference(float p0_hpa)
+{
+	if ((p0_hpa < 300.0f) || (p0_hpa > 1100.0f))
+	{
+		return HAL_ERROR;
+	}
+
+	xSemaphoreTake(mutex_baro, portMAX_DELAY);
+
+	/* A proxima medida reinicia a altitude na nova referencia */
+	baroStatus.p0_hpa = p0_hpa;
+	Alt_Init(&baroAlt, ALT_DEF_TAU_S);
+
+	xSemaphoreGive(mutex_baro);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef AppBaro_Zero(void)
+{
+	float p0;
+
+	xSemaphoreTake(mutex_baro, portMAX_DELAY);
+	p0 = (baroStatus.drains > 0) ? Alt_Reference(baroStatus.pressure_hpa, 0.0f) : 0.0f;
+	xSemaphoreGive(mutex_baro);
+
+	if (p0 == 0.0f)
+	{
+		return HAL_BUSY;
+	}
+
+	return AppBaro_SetReference(p0);
+}
+
+void AppBaro_GetStatus(AppBaroStatus_t *status)
+{
+	uint32_t transfers, bytes, samples, overruns;
+
+	LPS22HB_GetBusStats(&transfers, &bytes);
+	LPS22HB_FifoGetStats(&samples, &overruns);
+
+	xSemaphoreTake(mutex_baro, portMAX_DELAY);
+
+	if (baroStatus.running == true)
+	{
+		baroStatus.transfers = transfers - baseTransfers;
+		baroStatus.bytes = bytes - baseBytes;
+		baroStatus.samples = samples - baseSamples;
+		baroStatus.overruns = overruns;
+		baroStatus.elapsed_ms = (xTaskGetTickCount() - startTick) * portTICK_PERIOD_MS;
+	}
+
+	*status = baroStatus;
+
+	xSemaphoreGive(mutex_baro);
+}
+
+void AppBaro_Int(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	if (baroTask == NULL)
+	{
+		return;
+	}
+
+	baroStatus.interrupts++;
+	vTaskNotifyGiveFromISR(baroTask, pxHigherPriorityTaskWoken);
+}
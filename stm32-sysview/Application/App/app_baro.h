@@ -0,0 +1,125 @@
+/**
+ * @file    app_baro.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Altitude e velocidade vertical pelo FIFO do LPS22HB
+ * @details
+ * AppBaro_Start assina a pressao, liga o LPF do CI em ODR/9 e poe o FIFO
+ * do LPS22HB em modo stream com watermark no INT_DRDY (PD10, EXTI10). A
+ * cada watermark a task esvazia o FIFO em uma rajada pelo
+ * SensorDrv_ReadBatch, tira a media do lote e corrige o filtro de
+ * Libs/altitude; a aceleracao vertical vem integrada do AHRS
+ * (AppAhrs_GetVertical). Com o AHRS parado o filtro segue so o barometro.
+ *
+ * Custo a 75 Hz com watermark 16: cerca de 4.7 lotes/s, cada um com a
+ * leitura do STATUS_FIFO e uma rajada de 83 bytes (2 transacoes, 87 bytes,
+ * perto de 7.8 ms de barramento a 100 kHz, 3.7% dele). Lendo uma amostra
+ * por vez seriam 75 transacoes e 75 acordadas por segundo para quase o
+ * mesmo numero de bytes (Tools/altitude). O status mostra os
+ * valores medidos: ciclos de barramento e de calculo por lote e ocupacao
+ * do I2C desde o "start".
+ */
+
+#ifndef _APP_BARO_H_
+#define _APP_BARO_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "altitude/altitude.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define APP_BARO_DEF_RATE_MHZ		75000
+#define APP_BARO_DEF_WATERMARK		16
+
+/** @brief Barramento: 9 bits por byte (com o ACK) a 100 kHz */
+#define APP_BARO_I2C_BITS_BYTE		9
+#define APP_BARO_I2C_HZ				100000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado, estimativas e custos */
+typedef struct
+{
+	bool running;
+	uint32_t rate_mhz;      /**< ODR em uso */
+	uint8_t watermark;
+	float p0_hpa;           /**< Pressao de referencia (altitude zero) */
+	float pressure_hpa;     /**< Media do ultimo lote */
+	float temp_c;
+	float baro_m;           /**< Altitude so do barometro */
+	float alt_m;            /**< Altitude filtrada */
+	float vz_ms;            /**< Velocidade vertical, positiva subindo */
+	float bias_ms2;         /**< Bias estimado da aceleracao vertical */
+	bool accel;             /**< O ultimo passo usou a aceleracao do AHRS */
+	uint32_t interrupts;    /**< Notificacoes do INT_DRDY */
+	uint32_t drains;        /**< Lotes lidos */
+	uint32_t samples;       /**< Amostras lidas */
+	uint32_t overruns;      /**< Lotes que acharam o FIFO sobrescrito */
+	uint32_t cycles_bus;    /**< Ciclos da ultima rajada (I2C bloqueante) */
+	uint32_t cycles_calc;   /**< Ciclos do ultimo passo do filtro */
+	uint32_t cycles_max;    /**< Maior soma dos dois */
+	uint32_t transfers;     /**< Transacoes I2C do driver desde o inicio */
+	uint32_t bytes;
+	uint32_t elapsed_ms;    /**< Tempo desde o inicio */
+} AppBaroStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Cria a task do barometro (parada ate o "start"). */
+void AppBaro_TaskInit(void);
+
+/**
+ * Assina a pressao, liga o FIFO e reinicia o filtro e as estatisticas.
+ * @param rate_mhz Taxa em mHz (o registro escolhe o ODR da lista do driver).
+ * @param watermark Amostras por lote, de 1 a LPS22HB_FIFO_SIZE - 1.
+ */
+HAL_StatusTypeDef AppBaro_Start(uint32_t rate_mhz, uint8_t watermark);
+
+/** @brief Desliga o FIFO e libera a assinatura. */
+void AppBaro_Stop(void);
+
+/**
+ * Troca a pressao de referencia e reinicia o filtro.
+ * @param p0_hpa Pressao ao nivel zero (QNH), em hPa.
+ */
+HAL_StatusTypeDef AppBaro_SetReference(float p0_hpa);
+
+/** @brief Poe a altitude atual em zero (HAL_BUSY sem lote lido). */
+HAL_StatusTypeDef AppBaro_Zero(void);
+
+/**
+ * Copia o estado e as estatisticas.
+ * @param status Saida.
+ */
+void AppBaro_GetStatus(AppBaroStatus_t *status);
+
+/**
+ * Chamada na interrupcao do INT_DRDY do LPS22HB.
+ * @param pxHigherPriorityTaskWoken Repassado ao FreeRTOS.
+ */
+void AppBaro_Int(BaseType_t *pxHigherPriorityTaskWoken);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_BARO_H_ */
@@ -0,0 +1,399 @@
+/**
+ * @file    app_filter.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Cadeias de filtros por canal nas leituras do registro de sensores
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_filter.h"
+
+#include "sensor_drv/sensor_drv.h"
+#include "timebase/timebase.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Estado de um estagio em um eixo */
+typedef union
+{
+	FilterMovAvgF32_t movavg;
+	FilterEmaF32_t ema;
+	FilterBiquadF32_t biquad;
+	FilterFirDecimF32_t fir;
+} AppFilterState_u;
+
+/** @brief Estado interno de uma cadeia */
+typedef struct
+{
+	AppFilterChain_t status;
+	uint8_t axes;
+	AppFilterState_u state[APP_FILTER_STAGES][SENSOR_DRV_MAX_AXES];
+	int32_t last[SENSOR_DRV_MAX_AXES];  /**< Ultima saida, para SensorDrv_Read */
+} AppFilterCtx_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Coeficientes e estados: SRAM2, fora do .bss (refeitos a cada "set") */
+static float filterArena[APP_FILTER_CHAINS][APP_FILTER_ARENA] __attribute__((section(".ram2"), aligned(4)));
+
+static AppFilterCtx_t filterChains[APP_FILTER_CHAINS];
+
+/** @brief Um eixo do bloco em processamento (protegido pelo mutex) */
+static float filterBlock[APP_FILTER_BLOCK];
+
+static SemaphoreHandle_t mutex_filter = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Projeta os estagios de uma cadeia na sua area da SRAM2.
+ * @param chain Indice da cadeia.
+ * @param config Configuracao ja copiada para o status.
+ * @return false se algum estagio for invalido ou nao couber.
+ */
+static bool AppFilter_Build(uint8_t chain, const AppFilterConfig_t *config);
+
+/**
+ * Roda os estagios sobre um eixo do bloco.
+ * @param ctx Cadeia.
+ * @param axis Eixo.
+ * @param x Amostras, filtradas no lugar.
+ * @param count Amostras de entrada.
+ * @return Amostras de saida.
+ */
+static uint16_t AppFilter_RunAxis(AppFilterCtx_t *ctx, uint8_t axis, float *x, uint16_t count);
+
+/**
+ * Filtro instalado no registro (SensorDrvFilter_t).
+ */
+static uint16_t AppFilter_Run(uint8_t id, int32_t *values, uint16_t count, bool hold);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static bool AppFilter_Build(uint8_t chain, const AppFilterConfig_t *config)
+{
+	AppFilterCtx_t *ctx = &filterChains[chain];
+	float *arena = filterArena[chain];
+	const AppFilterStage_t *st;
+	float rate = (float) config->rate_mhz / 1000.0f;
+	float *coeffs;
+	uint16_t used = 0, need, taps = 0, length = 0;
+	uint8_t s, a, stages = 0, factor = 1;
+
+	for (s = 0; s < config->num_stages; s++)
+	{
+		st = &config->stages[s];
+
+		switch (st->kind)
+		{
+		case APP_FILTER_MOVAVG:
+			if ((st->param < 1.0f) || (st->param > APP_FILTER_ARENA))
+			{
+				return false;
+			}
+			length = (uint16_t) st->param;
+			need = (uint16_t) (length * ctx->axes);
+			break;
+
+		case APP_FILTER_EMA:
+			need = 0;
+			if ((st->param <= 0.0f) || (st->param > 1.0f))
+			{
+				return false;
+			}
+			break;
+
+		case APP_FILTER_LOWPASS:
+		case APP_FILTER_HIGHPASS:
+			stages = st->order / 2;
+			need = (uint16_t) (stages * (FILTER_BIQUAD_COEFFS + FILTER_BIQUAD_STATE * ctx->axes));
+			break;
+
+		case APP_FILTER_DECIM:
+			if ((st->param < 1.0f) || (st->param > APP_FILTER_MAX_DECIM))
+			{
+				return false;
+			}
+			factor = (uint8_t) st->param;
+			taps = (uint16_t) (APP_FILTER_DECIM_TAPS * factor + 1);
+			need = (uint16_t) (taps + FILTER_FIR_STATE(taps) * ctx->axes);
+			break;
+
+		default:
+			return false;
+		}
+
+		if (used + need > APP_FILTER_ARENA)
+		{
+			return false;
+		}
+
+		coeffs = &arena[used];
+
+		switch (st->kind)
+		{
+		case APP_FILTER_MOVAVG:
+			for (a = 0; a < ctx->axes; a++)
+			{
+				Filter_MovAvgInitF32(&ctx->state[s][a].movavg, length, &coeffs[a * length]);
+			}
+			break;
+
+		case APP_FILTER_EMA:
+			for (a = 0; a < ctx->axes; a++)
+			{
+				Filter_EmaInitF32(&ctx->state[s][a].ema, st->param);
+			}
+			break;
+
+		case APP_FILTER_LOWPASS:
+		case APP_FILTER_HIGHPASS:
+			if (Filter_DesignButterworth((st->kind == APP_FILTER_LOWPASS) ? FILTER_LOWPASS : FILTER_HIGHPASS, st->order,
+					st->param / rate, coeffs) == 0)
+			{
+				return false;
+			}
+
+			/* Coeficientes divididos entre os eixos; cada eixo tem os seus estados */
+			for (a = 0; a < ctx->axes; a++)
+			{
+				Filter_BiquadInitF32(&ctx->state[s][a].biquad, stages, coeffs,
+						&coeffs[stages * (FILTER_BIQUAD_COEFFS + FILTER_BIQUAD_STATE * a)]);
+			}
+			break;
+
+		default:
+			/* Corte em 80% do novo Nyquist: a banda de transicao cabe nos taps */
+			if (factor > 1)
+			{
+				Filter_DesignFirLowpass(coeffs, taps, 0.4f / (float) factor);
+			}
+			else
+			{
+				memset(coeffs, 0, taps * sizeof(float));
+				coeffs[taps / 2] = 1.0f;
+			}
+
+			for (a = 0; a < ctx->axes; a++)
+			{
+				Filter_FirDecimInitF32(&ctx->state[s][a].fir, taps, factor, coeffs,
+						&coeffs[taps + FILTER_FIR_STATE(taps) * a]);
+			}
+			rate /= (float) factor;
+			break;
+		}
+
+		used += need;
+	}
+
+	ctx->status.arena_used = used;
+	ctx->status.out_rate_mhz = (uint32_t) (rate * 1000.0f + 0.5f);
+
+	return true;
+}
+
+static uint16_t AppFilter_RunAxis(AppFilterCtx_t *ctx, uint8_t axis, float *x, uint16_t count)
+{
+	AppFilterState_u *state;
+	uint8_t s;
+
+	for (s = 0; (s < ctx->status.config.num_stages) && (count > 0); s++)
+	{
+		state = &ctx->state[s][axis];
+
+		switch (ctx->status.config.stages[s].kind)
+		{
+		case APP_FILTER_MOVAVG:
+			Filter_MovAvgF32(&state->movavg, x, x, count);
+			break;
+		case APP_FILTER_EMA:
+			Filter_EmaF32(&state->ema, x, x, count);
+			break;
+		case APP_FILTER_LOWPASS:
+		case APP_FILTER_HIGHPASS:
+			Filter_BiquadF32(&state->biquad, x, x, count);
+			break;
+		default:
+			count = Filter_FirDecimF32(&state->fir, x, x, count);
+			break;
+		}
+	}
+
+	return count;
+}
+
+static uint16_t AppFilter_Run(uint8_t id, int32_t *values, uint16_t count, bool hold)
+{
+	AppFilterCtx_t *ctx = NULL;
+	uint32_t start = Timebase_Cycles32();
+	uint16_t done, n, m = 0, out = 0, i;
+	uint8_t chain, a;
+
+	xSemaphoreTake(mutex_filter, portMAX_DELAY);
+
+	for (chain = 0; chain < APP_FILTER_CHAINS; chain++)
+	{
+		if ((filterChains[chain].status.active == true) && (filterChains[chain].status.config.id == id))
+		{
+			ctx = &filterChains[chain];
+			break;
+		}
+	}
+
+	if (ctx == NULL)
+	{
+		xSemaphoreGive(mutex_filter);
+		return count;
+	}
+
+	/*
+	 * Um eixo por vez em blocos de APP_FILTER_BLOCK. As saidas voltam para o
+	 * inicio de values: o indice de saida nunca passa o de entrada e cada eixo
+	 * so escreve na sua coluna, entao nada ainda nao lido e sobrescrito.
+	 */
+	for (done = 0; done < count; done += n)
+	{
+		n = ((count - done) > APP_FILTER_BLOCK) ? APP_FILTER_BLOCK : (count - done);
+
+		for (a = 0; a < ctx->axes; a++)
+		{
+			for (i = 0; i < n; i++)
+			{
+				filterBlock[i] = (float) values[(done + i) * ctx->axes + a];
+			}
+
+			/* As decimacoes tem a mesma fase em todos os eixos: m e igual para todos */
+			m = AppFilter_RunAxis(ctx, a, filterBlock, n);
+
+			for (i = 0; i < m; i++)
+			{
+				values[(out + i) * ctx->axes + a] = ctx->last[a] = (int32_t) lrintf(filterBlock[i]);
+			}
+		}
+
+		out += m;
+	}
+
+	ctx->status.samples_in += count;
+	ctx->status.samples_out += out;
+
+	if ((hold == true) && (out == 0))
+	{
+		memcpy(values, ctx->last, ctx->axes * sizeof(int32_t));
+		out = 1;
+	}
+
+	ctx->status.cycles += Timebase_Cycles32() - start;
+
+	xSemaphoreGive(mutex_filter);
+
+	return out;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppFilter_Init(void)
+{
+	memset(filterChains, 0, sizeof(filterChains));
+
+	if (mutex_filter == NULL)
+	{
+		mutex_filter = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_filter);
+		vQueueAddToRegistry(mutex_filter, "filter");
+	}
+}
+
+HAL_StatusTypeDef AppFilter_Set(uint8_t chain, const AppFilterConfig_t *config)
+{
+	const SensorChannelDesc_t *desc = SensorDrv_GetDesc(config->id);
+	AppFilterCtx_t *ctx;
+	HAL_StatusTypeDef status = HAL_OK;
+	uint8_t i;
+
+	if ((chain >= APP_FILTER_CHAINS) || (desc == NULL) || (config->rate_mhz == 0) || (config->num_stages == 0)
+			|| (config->num_stages > APP_FILTER_STAGES))
+	{
+		return HAL_ERROR;
+	}
+
+	for (i = 0; i < APP_FILTER_CHAINS; i++)
+	{
+		if ((i != chain) && (filterChains[i].status.active == true) && (filterChains[i].status.config.id == config->id))
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	AppFilter_Clear(chain);
+
+	xSemaphoreTake(mutex_filter, portMAX_DELAY);
+
+	ctx = &filterChains[chain];
+	memset(ctx, 0, sizeof(AppFilterCtx_t));
+	ctx->status.config = *config;
+	ctx->axes = desc->axes;
+
+	if (AppFilter_Build(chain, config) == true)
+	{
+		ctx->status.active = true;
+		SensorDrv_SetPostFilter(config->id, AppFilter_Run);
+	}
+	else
+	{
+		status = HAL_ERROR;
+	}
+
+	xSemaphoreGive(mutex_filter);
+
+	return status;
+}
+
+void AppFilter_Clear(uint8_t chain)
+{
+	if (chain >= APP_FILTER_CHAINS)
+	{
+		return;
+	}
+
+	xSemaphoreTake(mutex_filter, portMAX_DELAY);
+
+	if (filterChains[chain].status.active == true)
+	{
+		SensorDrv_SetPostFilter(filterChains[chain].status.config.id, NULL);
+		filterChains[chain].status.active = false;
+	}
+
+	xSemaphoreGive(mutex_filter);
+}
+
+void AppFilter_GetChain(uint8_t chain, AppFilterChain_t *status)
+{
+	memset(status, 0, sizeof(AppFilterChain_t));
+
+	if (chain >= APP_FILTER_CHAINS)
+	{
+		return;
+	}
+
+	xSemaphoreTake(mutex_filter, portMAX_DELAY);
+	*status = filterChains[chain].status;
+	xSemaphoreGive(mutex_filter);
+}
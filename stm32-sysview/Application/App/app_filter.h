@@ -0,0 +1,134 @@
+/**
+ * @file    app_filter.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Cadeias de filtros por canal nas leituras do registro de sensores
+ * @details
+ * Cada cadeia liga ate APP_FILTER_STAGES estagios de Libs/filter (media
+ * movel, exponencial, Butterworth passa-baixas ou passa-altas e FIR com
+ * decimacao) a um canal do registro, em todos os eixos. A cadeia entra como
+ * SensorDrv_SetPostFilter: toda leitura do canal (cache, telemetria, janelas,
+ * lotes do FIFO) sai filtrada, sem mudar os consumidores.
+ *
+ * O projeto usa a taxa dada no "set", que deve ser a taxa em que o canal e
+ * realmente lido. Os estagios rodam em float sobre blocos de ate
+ * APP_FILTER_BLOCK amostras por eixo; coeficientes e estados ficam na SRAM2,
+ * APP_FILTER_ARENA floats por cadeia. Com decimacao, SensorDrv_ReadBatch
+ * devolve menos amostras e SensorDrv_Read repete a ultima saida.
+ */
+
+#ifndef _APP_FILTER_H_
+#define _APP_FILTER_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "filter/filter.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define APP_FILTER_CHAINS			4
+#define APP_FILTER_STAGES			4
+
+/** @brief Coeficientes e estados de uma cadeia na SRAM2 (em floats) */
+#define APP_FILTER_ARENA			384
+
+/** @brief Amostras por eixo processadas de uma vez */
+#define APP_FILTER_BLOCK			64
+
+/** @brief Maior decimacao de um estagio */
+#define APP_FILTER_MAX_DECIM		8
+
+/** @brief Taps do FIR de decimacao por unidade do fator (mais um) */
+#define APP_FILTER_DECIM_TAPS		8
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Tipos de estagio */
+typedef enum
+{
+	APP_FILTER_MOVAVG = 0,  /**< param = amostras */
+	APP_FILTER_EMA,         /**< param = alpha */
+	APP_FILTER_LOWPASS,     /**< param = corte em Hz, order = ordem */
+	APP_FILTER_HIGHPASS,    /**< param = corte em Hz, order = ordem */
+	APP_FILTER_DECIM        /**< param = fator */
+} AppFilterKind_e;
+
+/** @brief Um estagio da cadeia */
+typedef struct
+{
+	AppFilterKind_e kind;
+	float param;
+	uint8_t order;
+} AppFilterStage_t;
+
+/** @brief Configuracao de uma cadeia */
+typedef struct
+{
+	uint8_t id;             /**< Canal no registro de drivers */
+	uint32_t rate_mhz;      /**< Taxa em que o canal e lido */
+	uint8_t num_stages;
+	AppFilterStage_t stages[APP_FILTER_STAGES];
+} AppFilterConfig_t;
+
+/** @brief Estado de uma cadeia */
+typedef struct
+{
+	bool active;
+	AppFilterConfig_t config;
+	uint32_t out_rate_mhz;  /**< Taxa depois das decimacoes */
+	uint16_t arena_used;    /**< Floats da SRAM2 em uso */
+	uint32_t samples_in;
+	uint32_t samples_out;
+	uint64_t cycles;        /**< Ciclos gastos desde o "set" */
+} AppFilterChain_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Cria o mutex das cadeias (todas desligadas). */
+void AppFilter_Init(void);
+
+/**
+ * Projeta uma cadeia e a instala nas leituras do canal.
+ * @param chain Indice da cadeia.
+ * @param config Canal, taxa e estagios.
+ * @return HAL_OK, HAL_ERROR para parametros invalidos, canal ja filtrado por
+ * outra cadeia ou falta de espaco na SRAM2.
+ */
+HAL_StatusTypeDef AppFilter_Set(uint8_t chain, const AppFilterConfig_t *config);
+
+/**
+ * Remove uma cadeia das leituras do canal.
+ * @param chain Indice da cadeia.
+ */
+void AppFilter_Clear(uint8_t chain);
+
+/**
+ * Copia o estado de uma cadeia.
+ * @param chain Indice da cadeia.
+ * @param status Saida.
+ */
+void AppFilter_GetChain(uint8_t chain, AppFilterChain_t *status);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_FILTER_H_ */
@@ -0,0 +1,376 @@
+/**
+ * @file    app_magcal.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Calibracao do LIS3MDL aplicada no caminho de leitura
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_magcal.h"
+#include "sensor_cache.h"
+
+#include <stddef.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/**
+ * @brief Ultima pagina de 2 KB do banco 2, reservada no linker script
+ * (FLASH com 1022K). Apagar o banco 2 nao trava a execucao no banco 1.
+ */
+#define APP_MAGCAL_FLASH_ADDR			0x080FF800UL
+#define APP_MAGCAL_FLASH_BANK			FLASH_BANK_2
+#define APP_MAGCAL_FLASH_PAGE			255
+
+/** @brief Identificador do registro gravado ("MCA1") */
+#define APP_MAGCAL_MAGIC				0x3141434DUL
+
+/** @brief Fator de esquecimento do calibrador (1 = acumula tudo) */
+#define APP_MAGCAL_LAMBDA				1.0f
+
+/** @brief Amostras entre duas solucoes do ajuste */
+#define APP_MAGCAL_SOLVE_INTERVAL		40
+
+/** @brief Intervalo minimo entre gravacoes na flash */
+#define APP_MAGCAL_SAVE_INTERVAL_MS		(10 * 60 * 1000)
+
+/** @brief Variacao do offset, relativa ao raio, que justifica nova gravacao */
+#define APP_MAGCAL_SAVE_DELTA			0.02f
+
+/** @brief Bits fracionarios da matriz soft-iron aplicada */
+#define APP_MAGCAL_Q					16
+
+#define APP_MAGCAL_UG_TO_GAUSS			1.0e-6f
+#define APP_MAGCAL_GAUSS_TO_UG			1.0e6f
+
+#define APP_MAGCAL_MUTEX_TIMEOUT		1000
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Registro gravado na flash */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t size;
+	MagCalParams_t params;
+	uint32_t crc;
+} AppMagCalRecord_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static MagCal_t magCal;
+
+static SemaphoreHandle_t mutex_magcal = NULL;
+
+/** @brief Parametros aplicados e sua versao inteira usada no caminho de leitura */
+static MagCalParams_t appliedParams;
+static int32_t offsetUg[3];
+static int32_t softQ[3][3];
+
+/** @brief Ultimos parametros gravados na flash */
+static MagCalParams_t storedParams;
+
+static bool applied = false;
+static bool learning = true;
+static bool stored = false;
+
+static uint32_t sinceSolve = 0;
+static TickType_t lastSave = 0;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static uint32_t AppMagCal_Crc32(const void *data, uint32_t len);
+
+/**
+ * Passa a aplicar os parametros informados.
+ * @param params Parametros em gauss.
+ */
+static void AppMagCal_Use(const MagCalParams_t *params);
+
+/**
+ * Le o registro da flash.
+ * @param params Parametros lidos.
+ * @return true se o registro for valido.
+ */
+static bool AppMagCal_Read(MagCalParams_t *params);
+
+/**
+ * Apaga a pagina reservada e grava os parametros.
+ * @param params Parametros a gravar.
+ * @return HAL_OK ou o erro do driver de flash.
+ */
+static HAL_StatusTypeDef AppMagCal_Write(const MagCalParams_t *params);
+
+/** @brief Indica se a solucao atual difere o bastante da gravada. */
+static bool AppMagCal_ShouldSave(void);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint32_t AppMagCal_Crc32(const void *data, uint32_t len)
+{
+	const uint8_t *p = (const uint8_t *) data;
+	uint32_t crc = 0xFFFFFFFFUL;
+	uint8_t bit;
+
+	while (len--)
+	{
+		crc ^= *p++;
+		for (bit = 0; bit < 8; bit++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+		}
+	}
+
+	return ~crc;
+}
+
+static void AppMagCal_Use(const MagCalParams_t *params)
+{
+	float v;
+	uint8_t i, j;
+
+	appliedParams = *params;
+
+	for (i = 0; i < 3; i++)
+	{
+		v = params->offset[i] * APP_MAGCAL_GAUSS_TO_UG;
+		offsetUg[i] = (int32_t) ((v >= 0.0f) ? (v + 0.5f) : (v - 0.5f));
+
+		for (j = 0; j < 3; j++)
+		{
+			v = params->soft[i][j] * (float) (1UL << APP_MAGCAL_Q);
+			softQ[i][j] = (int32_t) ((v >= 0.0f) ? (v + 0.5f) : (v - 0.5f));
+		}
+	}
+
+	applied = true;
+}
+
+static bool AppMagCal_Read(MagCalParams_t *params)
+{
+	const AppMagCalRecord_t *rec = (const AppMagCalRecord_t *) APP_MAGCAL_FLASH_ADDR;
+
+	if ((rec->magic != APP_MAGCAL_MAGIC) || (rec->size != sizeof(AppMagCalRecord_t)))
+	{
+		return false;
+	}
+
+	if (rec->crc != AppMagCal_Crc32(rec, offsetof(AppMagCalRecord_t, crc)))
+	{
+		return false;
+	}
+
+	*params = rec->params;
+
+	return true;
+}
+
+static HAL_StatusTypeDef AppMagCal_Write(const MagCalParams_t *params)
+{
+	FLASH_EraseInitTypeDef erase;
+	union
+	{
+		AppMagCalRecord_t rec;
+		uint64_t dw[(sizeof(AppMagCalRecord_t) + 7) / 8];
+	} buf;
+	HAL_StatusTypeDef status;
+	uint32_t page_error;
+	uint32_t i;
+
+	memset(&buf, 0xFF, sizeof(buf));
+	buf.rec.magic = APP_MAGCAL_MAGIC;
+	buf.rec.size = sizeof(AppMagCalRecord_t);
+	buf.rec.params = *params;
+	buf.rec.crc = AppMagCal_Crc32(&buf.rec, offsetof(AppMagCalRecord_t, crc));
+
+	erase.TypeErase = FLASH_TYPEERASE_PAGES;
+	erase.Banks = APP_MAGCAL_FLASH_BANK;
+	erase.Page = APP_MAGCAL_FLASH_PAGE;
+	erase.NbPages = 1;
+
+	HAL_FLASH_Unlock();
+	__HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_ALL_ERRORS);
+
+	status = HAL_FLASHEx_Erase(&erase, &page_error);
+
+	for (i = 0; (status == HAL_OK) && (i < (sizeof(buf.dw) / sizeof(buf.dw[0]))); i++)
+	{
+		status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, APP_MAGCAL_FLASH_ADDR + (i * 8), buf.dw[i]);
+	}
+
+	HAL_FLASH_Lock();
+
+	if (status == HAL_OK)
+	{
+		storedParams = *params;
+		stored = true;
+		lastSave = xTaskGetTickCount();
+	}
+
+	return status;
+}
+
+static bool AppMagCal_ShouldSave(void)
+{
+	float delta = 0.0f;
+	float diff;
+	uint8_t i;
+
+	if (stored == false)
+	{
+		return true;
+	}
+
+	if ((TickType_t) (xTaskGetTickCount() - lastSave) < pdMS_TO_TICKS(APP_MAGCAL_SAVE_INTERVAL_MS))
+	{
+		return false;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		diff = appliedParams.offset[i] - storedParams.offset[i];
+		delta += (diff >= 0.0f) ? diff : -diff;
+	}
+
+	return (delta > (APP_MAGCAL_SAVE_DELTA * appliedParams.radius));
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppMagCal_Init(void)
+{
+	MagCalParams_t params;
+
+	if (mutex_magcal == NULL)
+	{
+		mutex_magcal = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_magcal);
+		vQueueAddToRegistry(mutex_magcal, "magCal");
+	}
+
+	MagCal_Init(&magCal, APP_MAGCAL_LAMBDA);
+	sinceSolve = 0;
+
+	/* Toda amostra nova do magnetometro passa pela calibracao */
+	SensorCache_SetCorrection(SENSOR_TYPE_MAGNETO, AppMagCal_Process);
+
+	if (AppMagCal_Read(&params) == true)
+	{
+		AppMagCal_Use(&params);
+		MagCal_SetParams(&magCal, &params);
+		storedParams = params;
+		stored = true;
+		lastSave = xTaskGetTickCount();
+	}
+}
+
+void AppMagCal_Process(int32_t mag[3])
+{
+	float m[3];
+	int32_t u[3];
+	int64_t acc;
+	uint8_t i;
+
+	if (xSemaphoreTake(mutex_magcal, APP_MAGCAL_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return;
+	}
+
+	if (learning == true)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			m[i] = (float) mag[i] * APP_MAGCAL_UG_TO_GAUSS;
+		}
+
+		MagCal_AddSample(&magCal, m);
+
+		/* A solucao e cara (Cholesky 9x9), entao so roda a cada N amostras */
+		if (++sinceSolve >= APP_MAGCAL_SOLVE_INTERVAL)
+		{
+			sinceSolve = 0;
+
+			if ((MagCal_Solve(&magCal) == true) && (magCal.quality.converged == true))
+			{
+				AppMagCal_Use(&magCal.params);
+
+				if (AppMagCal_ShouldSave() == true)
+				{
+					AppMagCal_Write(&appliedParams);
+				}
+			}
+		}
+	}
+
+	if (applied == true)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			u[i] = mag[i] - offsetUg[i];
+		}
+
+		for (i = 0; i < 3; i++)
+		{
+			acc = ((int64_t) softQ[i][0] * u[0]) + ((int64_t) softQ[i][1] * u[1]) + ((int64_t) softQ[i][2] * u[2]);
+			mag[i] = (int32_t) ((acc + (1L << (APP_MAGCAL_Q - 1))) >> APP_MAGCAL_Q);
+		}
+	}
+
+	xSemaphoreGive(mutex_magcal);
+}
+
+void AppMagCal_SetLearning(bool enable)
+{
+	xSemaphoreTake(mutex_magcal, portMAX_DELAY);
+	learning = enable;
+	xSemaphoreGive(mutex_magcal);
+}
+
+void AppMagCal_Reset(void)
+{
+	xSemaphoreTake(mutex_magcal, portMAX_DELAY);
+	MagCal_Init(&magCal, APP_MAGCAL_LAMBDA);
+	sinceSolve = 0;
+	xSemaphoreGive(mutex_magcal);
+}
+
+HAL_StatusTypeDef AppMagCal_Save(void)
+{
+	HAL_StatusTypeDef status = HAL_ERROR;
+
+	xSemaphoreTake(mutex_magcal, portMAX_DELAY);
+	if (applied == true)
+	{
+		status = AppMagCal_Write(&appliedParams);
+	}
+	xSemaphoreGive(mutex_magcal);
+
+	return status;
+}
+
+void AppMagCal_GetStatus(AppMagCalStatus_t *status)
+{
+	xSemaphoreTake(mutex_magcal, portMAX_DELAY);
+	status->quality = magCal.quality;
+	status->params = appliedParams;
+	status->applied = applied;
+	status->learning = learning;
+	status->stored = stored && (memcmp(&storedParams, &appliedParams, sizeof(MagCalParams_t)) == 0);
+	xSemaphoreGive(mutex_magcal);
+}
@@ -0,0 +1,85 @@
+/**
+ * @file    app_magcal.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Calibracao do LIS3MDL aplicada no caminho de leitura
+ * @details
+ * Cada leitura do magnetometro feita pelo cache de sensores passa por
+ * AppMagCal_Process, que alimenta o calibrador online com a amostra crua e
+ * devolve a amostra corrigida. Os parametros convergidos sao gravados na
+ * ultima pagina da flash e carregados no boot.
+ */
+
+#ifndef _APP_MAGCAL_H_
+#define _APP_MAGCAL_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "magcal/magcal.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado da calibracao para exibicao */
+typedef struct
+{
+	MagCalQuality_t quality;  /**< Indicadores do ajuste em andamento */
+	MagCalParams_t params;    /**< Parametros aplicados (offset/raio em gauss) */
+	bool applied;             /**< Existe calibracao sendo aplicada */
+	bool learning;            /**< Calibrador recebendo amostras */
+	bool stored;              /**< Parametros aplicados estao gravados na flash */
+} AppMagCalStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Inicializa o calibrador e carrega os parametros da flash. */
+void AppMagCal_Init(void);
+
+/**
+ * Alimenta o calibrador e corrige uma amostra. Chamada no caminho de leitura
+ * do magnetometro.
+ * @param mag Amostra x, y, z em ugauss; corrigida no lugar.
+ */
+void AppMagCal_Process(int32_t mag[3]);
+
+/**
+ * Liga ou desliga o aprendizado online.
+ * @param enable true para acumular amostras.
+ */
+void AppMagCal_SetLearning(bool enable);
+
+/** @brief Descarta o ajuste em andamento (os parametros aplicados continuam). */
+void AppMagCal_Reset(void);
+
+/**
+ * Grava os parametros aplicados na flash.
+ * @return HAL_OK ou o erro do driver de flash.
+ */
+HAL_StatusTypeDef AppMagCal_Save(void);
+
+/**
+ * Retorna o estado atual da calibracao.
+ * @param status Estrutura de saida.
+ */
+void AppMagCal_GetStatus(AppMagCalStatus_t *status);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_MAGCAL_H_ */
@@ -0,0 +1,431 @@
+/**
+ * @file    app_motion.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Deteccao de movimento nas funcoes embarcadas do LSM6DSL
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_motion.h"
+#include "app_ahrs.h"
+#include "sensor_cache.h"
+
+#include "sensor_drv/sensor_drv.h"
+
+#include <string.h>
+#include <stdlib.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Abaixo do AHRS: a captura pode esperar alguns ms */
+#define APP_MOTION_TASK_PRIORITY	3
+
+/** @brief Acelerometro armado: 26 Hz em baixo consumo */
+#define APP_MOTION_IDLE_RATE_MHZ	26000
+
+/** @brief Captura: acelerometro e giroscopio em 208 Hz */
+#define APP_MOTION_CAPTURE_RATE_MHZ	208000
+#define APP_MOTION_SAMPLE_MS		5
+
+/** @brief Confere o pino parado, caso uma borda tenha se perdido */
+#define APP_MOTION_POLL_MS			10000
+
+/** @brief Eventos que entram em captura */
+#define APP_MOTION_ACTIVITY			(LSM6DSL_MOTION_WAKE_UP | LSM6DSL_MOTION_TILT | \
+									 LSM6DSL_MOTION_SIGN_MOTION | LSM6DSL_MOTION_STEP)
+
+/** @brief Tasks enumeradas para achar a IDLE */
+#define APP_MOTION_MAX_TASKS		16
+
+#define APP_MOTION_MUTEX_TIMEOUT	1000
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Limiares: variacao de 63 mg por 1 amostra, queda abaixo de 312 mg por 6 amostras */
+static const LSM6DSL_MotionConfig_t motionConfig =
+{
+	.WakeUp_Threshold = 63,
+	.WakeUp_Duration = 1,
+	.FreeFall_Threshold = 312,
+	.FreeFall_Duration = 6,
+	.SignMotion_Steps = 6,
+};
+
+static AppMotionStatus_t motionStatus;
+
+static uint8_t acc_id = SENSOR_DRV_INVALID;
+static uint8_t gyro_id = SENSOR_DRV_INVALID;
+
+/** @brief Assinatura do estado armado e as duas da captura */
+static uint8_t idleSub = SENSOR_DRV_INVALID;
+static uint8_t captureSubs[2] = { SENSOR_DRV_INVALID, SENSOR_DRV_INVALID };
+
+static TickType_t lastEvent;
+
+/** @brief Contadores da ultima contabilizacao */
+static TickType_t lastTick;
+static uint32_t lastIdle, lastTotal, lastTransfers, lastBytes;
+
+static TaskStatus_t motionTasks[APP_MOTION_MAX_TASKS];
+
+static SemaphoreHandle_t mutex_motion = NULL;
+static TaskHandle_t motionTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppMotion_Task(void *param);
+
+/**
+ * Soma o tempo, a CPU e o trafego desde a ultima chamada no estado atual.
+ */
+static void AppMotion_Account(void);
+
+/**
+ * Troca de estado ajustando as assinaturas e o AHRS.
+ * @param state Novo estado.
+ */
+static void AppMotion_SetState(AppMotionState_e state);
+
+/** @brief Le e conta as fontes de interrupcao do sensor. */
+static void AppMotion_Event(void);
+
+/** @brief Le uma amostra do acelerometro na captura. */
+static void AppMotion_Sample(void);
+
+/**
+ * Libera uma assinatura, se houver.
+ * @param handle Assinatura; invalidada.
+ */
+static void AppMotion_Release(uint8_t *handle);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void AppMotion_Release(uint8_t *handle)
+{
+	if (*handle != SENSOR_DRV_INVALID)
+	{
+		SensorDrv_Unsubscribe(*handle);
+		*handle = SENSOR_DRV_INVALID;
+	}
+}
+
+static void AppMotion_Account(void)
+{
+	AppMotionUsage_t *usage = &motionStatus.usage[motionStatus.state];
+	uint32_t idle = 0, total = 0, transfers, bytes;
+	TickType_t now = xTaskGetTickCount();
+	UBaseType_t count, i;
+
+	count = uxTaskGetSystemState(motionTasks, APP_MOTION_MAX_TASKS, &total);
+	for (i = 0; i < count; i++)
+	{
+		if (strcmp(motionTasks[i].pcTaskName, "IDLE") == 0)
+		{
+			idle = motionTasks[i].ulRunTimeCounter;
+		}
+	}
+
+	LSM6DSL_GetBusStats(&transfers, &bytes);
+
+	usage->time_ms += (now - lastTick) * portTICK_PERIOD_MS;
+	usage->total += total - lastTotal;
+	usage->busy += (total - lastTotal) - (idle - lastIdle);
+	usage->transfers += transfers - lastTransfers;
+	usage->bytes += bytes - lastBytes;
+
+	lastTick = now;
+	lastIdle = idle;
+	lastTotal = total;
+	lastTransfers = transfers;
+	lastBytes = bytes;
+}
+
+static void AppMotion_SetState(AppMotionState_e state)
+{
+	AppMotion_Account();
+
+	if (state == APP_MOTION_CAPTURE)
+	{
+		captureSubs[0] = SensorDrv_Subscribe(acc_id, APP_MOTION_CAPTURE_RATE_MHZ, SENSOR_POWER_NORMAL);
+		captureSubs[1] = SensorDrv_Subscribe(gyro_id, APP_MOTION_CAPTURE_RATE_MHZ, SENSOR_POWER_NORMAL);
+		AppAhrs_Enable(true);
+
+		motionStatus.captures++;
+		lastEvent = xTaskGetTickCount();
+	}
+	else
+	{
+		AppMotion_Release(&captureSubs[0]);
+		AppMotion_Release(&captureSubs[1]);
+		AppAhrs_Enable(state == APP_MOTION_DISARMED);
+	}
+
+	motionStatus.state = state;
+}
+
+static void AppMotion_Event(void)
+{
+	uint8_t src, i;
+
+	if (SensorDrv_Lock() != HAL_OK)
+	{
+		return;
+	}
+
+	src = LSM6DSL_MotionSource();
+	SensorDrv_Unlock();
+
+	for (i = 0; i < sizeof(motionStatus.events) / sizeof(motionStatus.events[0]); i++)
+	{
+		if (src & (1U << i))
+		{
+			motionStatus.events[i]++;
+		}
+	}
+
+	if (src & APP_MOTION_ACTIVITY)
+	{
+		lastEvent = xTaskGetTickCount();
+
+		if (motionStatus.state == APP_MOTION_IDLE)
+		{
+			AppMotion_SetState(APP_MOTION_CAPTURE);
+		}
+	}
+}
+
+static void AppMotion_Sample(void)
+{
+	int32_t acc[3];
+	uint8_t i;
+
+	if (SensorCache_Read(acc_id, acc, false) != HAL_OK)
+	{
+		return;
+	}
+
+	motionStatus.samples++;
+
+	for (i = 0; i < 3; i++)
+	{
+		if (abs(acc[i]) > motionStatus.peak_mg)
+		{
+			motionStatus.peak_mg = abs(acc[i]);
+		}
+	}
+}
+
+static void AppMotion_Task(void *param)
+{
+	TickType_t timeout;
+	uint32_t notified;
+	bool pending;
+
+	for (;;)
+	{
+		switch (motionStatus.state)
+		{
+		case APP_MOTION_IDLE:
+			timeout = pdMS_TO_TICKS(APP_MOTION_POLL_MS);
+			break;
+		case APP_MOTION_CAPTURE:
+			timeout = pdMS_TO_TICKS(APP_MOTION_SAMPLE_MS);
+			break;
+		default:
+			timeout = portMAX_DELAY;
+			break;
+		}
+
+		notified = ulTaskNotifyTake(pdTRUE, timeout);
+
+		if (xSemaphoreTake(mutex_motion, APP_MOTION_MUTEX_TIMEOUT) != pdTRUE)
+		{
+			continue;
+		}
+
+		if (motionStatus.state != APP_MOTION_DISARMED)
+		{
+			/* Wake-up e queda livre ficam travados: o pino alto sem borda e evento perdido */
+			pending = (HAL_GPIO_ReadPin(LSM6DSL_INT1_EXTI11_GPIO_Port, LSM6DSL_INT1_EXTI11_Pin) == GPIO_PIN_SET);
+
+			if ((notified > 0) || (pending == true))
+			{
+				AppMotion_Event();
+			}
+		}
+
+		if (motionStatus.state == APP_MOTION_CAPTURE)
+		{
+			AppMotion_Sample();
+
+			if ((xTaskGetTickCount() - lastEvent) >= pdMS_TO_TICKS(APP_MOTION_HOLD_MS))
+			{
+				AppMotion_SetState(APP_MOTION_IDLE);
+			}
+		}
+
+		xSemaphoreGive(mutex_motion);
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppMotion_TaskInit(void)
+{
+	BaseType_t xReturned;
+
+	memset(&motionStatus, 0, sizeof(motionStatus));
+
+	acc_id = SensorDrv_Find(SENSOR_TYPE_ACCELERO, "LSM6DSL");
+	gyro_id = SensorDrv_Find(SENSOR_TYPE_GYRO, "LSM6DSL");
+
+	if (mutex_motion == NULL)
+	{
+		mutex_motion = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_motion);
+		vQueueAddToRegistry(mutex_motion, "motion");
+	}
+
+	xReturned = xTaskCreate(AppMotion_Task, "tkMotion", configMINIMAL_STACK_SIZE * 2, NULL, APP_MOTION_TASK_PRIORITY, &motionTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppMotion_Arm(uint8_t mask)
+{
+	HAL_StatusTypeDef status;
+
+	if ((acc_id == SENSOR_DRV_INVALID) || (mask == 0) || (mask & ~LSM6DSL_MOTION_ALL))
+	{
+		return HAL_ERROR;
+	}
+
+	AppMotion_Disarm();
+
+	if (xSemaphoreTake(mutex_motion, APP_MOTION_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	/* As funcoes embarcadas rodam no ODR do acelerometro */
+	idleSub = SensorDrv_Subscribe(acc_id, APP_MOTION_IDLE_RATE_MHZ, SENSOR_POWER_LOW);
+
+	status = SensorDrv_Lock();
+	if (status == HAL_OK)
+	{
+		status = LSM6DSL_MotionConfig(&motionConfig);
+		if (status == HAL_OK)
+		{
+			status = LSM6DSL_MotionRoute(mask, 0);
+		}
+
+		/* Descarta eventos travados de antes */
+		LSM6DSL_MotionSource();
+		SensorDrv_Unlock();
+	}
+
+	if (status == HAL_OK)
+	{
+		motionStatus.mask = mask;
+		AppMotion_SetState(APP_MOTION_IDLE);
+	}
+	else
+	{
+		AppMotion_Release(&idleSub);
+	}
+
+	xSemaphoreGive(mutex_motion);
+
+	/* Recalcula o timeout da task */
+	xTaskNotifyGive(motionTask);
+
+	return status;
+}
+
+void AppMotion_Disarm(void)
+{
+	xSemaphoreTake(mutex_motion, portMAX_DELAY);
+
+	if (motionStatus.state != APP_MOTION_DISARMED)
+	{
+		if (SensorDrv_Lock() == HAL_OK)
+		{
+			LSM6DSL_MotionRoute(0, 0);
+			SensorDrv_Unlock();
+		}
+
+		AppMotion_SetState(APP_MOTION_DISARMED);
+		AppMotion_Release(&idleSub);
+		motionStatus.mask = 0;
+	}
+
+	xSemaphoreGive(mutex_motion);
+}
+
+void AppMotion_GetStatus(AppMotionStatus_t *status)
+{
+	xSemaphoreTake(mutex_motion, portMAX_DELAY);
+
+	AppMotion_Account();
+
+	if ((motionStatus.mask & LSM6DSL_MOTION_STEP) && (SensorDrv_Lock() == HAL_OK))
+	{
+		motionStatus.steps = LSM6DSL_StepCount();
+		SensorDrv_Unlock();
+	}
+
+	*status = motionStatus;
+
+	xSemaphoreGive(mutex_motion);
+}
+
+void AppMotion_ResetStats(void)
+{
+	xSemaphoreTake(mutex_motion, portMAX_DELAY);
+
+	AppMotion_Account();
+
+	if ((motionStatus.mask & LSM6DSL_MOTION_STEP) && (SensorDrv_Lock() == HAL_OK))
+	{
+		LSM6DSL_StepReset();
+		SensorDrv_Unlock();
+	}
+
+	motionStatus.interrupts = 0;
+	memset(motionStatus.events, 0, sizeof(motionStatus.events));
+	motionStatus.captures = 0;
+	motionStatus.samples = 0;
+	motionStatus.peak_mg = 0;
+	motionStatus.steps = 0;
+	memset(motionStatus.usage, 0, sizeof(motionStatus.usage));
+
+	xSemaphoreGive(mutex_motion);
+}
+
+void AppMotion_Int(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	if (motionTask == NULL)
+	{
+		return;
+	}
+
+	motionStatus.interrupts++;
+	vTaskNotifyGiveFromISR(motionTask, pxHigherPriorityTaskWoken);
+}
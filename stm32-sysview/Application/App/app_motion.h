@@ -0,0 +1,125 @@
+/**
+ * @file    app_motion.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Deteccao de movimento nas funcoes embarcadas do LSM6DSL
+ * @details
+ * Armado, o acelerometro fica sozinho em 26 Hz de baixo consumo, o AHRS e
+ * pausado (giroscopio desligado) e a deteccao de wake-up, queda livre,
+ * inclinacao, movimento significativo e passos roda dentro do LSM6DSL. O MCU
+ * nao le o sensor: a task dorme ate a interrupcao no INT1 (PD11, EXTI11).
+ *
+ * Wake-up, inclinacao, movimento significativo ou passo entram em captura:
+ * AHRS ligado e acelerometro e giroscopio assinados em 208 Hz. Cada novo
+ * evento prorroga a captura; sem eventos por APP_MOTION_HOLD_MS volta a
+ * dormir. Queda livre so e contada (o impacto em seguida gera um wake-up).
+ *
+ * Para medir o custo da fase parada, a task guarda o trafego I2C do driver e
+ * o tempo de CPU fora da task IDLE (contadores de run-time do FreeRTOS)
+ * separados por estado.
+ */
+
+#ifndef _APP_MOTION_H_
+#define _APP_MOTION_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "lsm6dsl/lsm6dsl.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Eventos armados por padrao */
+#define APP_MOTION_DEFAULT_MASK		(LSM6DSL_MOTION_WAKE_UP | LSM6DSL_MOTION_FREE_FALL | \
+									 LSM6DSL_MOTION_TILT | LSM6DSL_MOTION_SIGN_MOTION)
+
+/** @brief Tempo sem eventos antes de sair da captura */
+#define APP_MOTION_HOLD_MS			5000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estados da deteccao */
+typedef enum
+{
+	APP_MOTION_DISARMED = 0,  /**< Sensores seguem as demais assinaturas */
+	APP_MOTION_IDLE,          /**< Esperando a interrupcao do LSM6DSL */
+	APP_MOTION_CAPTURE,       /**< Amostrando em taxa alta */
+	APP_MOTION_STATE_MAX
+} AppMotionState_e;
+
+/** @brief Tempo, CPU e trafego I2C acumulados em um estado */
+typedef struct
+{
+	uint32_t time_ms;       /**< Tempo no estado */
+	uint32_t busy;          /**< Run-time fora da task IDLE */
+	uint32_t total;         /**< Run-time total */
+	uint32_t transfers;     /**< Transacoes I2C do LSM6DSL */
+	uint32_t bytes;         /**< Bytes no barramento */
+} AppMotionUsage_t;
+
+/** @brief Estado e contadores */
+typedef struct
+{
+	AppMotionState_e state;
+	uint8_t mask;           /**< Eventos armados (LSM6DSL_MOTION_*) */
+	uint32_t interrupts;    /**< Notificacoes do INT1 */
+	uint32_t events[5];     /**< Por evento: wake-up, queda, inclinacao, significativo, passo */
+	uint32_t captures;      /**< Entradas em captura */
+	uint32_t samples;       /**< Amostras lidas em captura */
+	int32_t peak_mg;        /**< Maior modulo de um eixo do acelerometro em captura */
+	uint16_t steps;         /**< Contador do pedometro */
+	AppMotionUsage_t usage[APP_MOTION_STATE_MAX];
+} AppMotionStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Cria a task de movimento (desarmada). */
+void AppMotion_TaskInit(void);
+
+/**
+ * Programa os limiares, roteia os eventos para o INT1 e dorme.
+ * @param mask Eventos LSM6DSL_MOTION_* a armar.
+ * @return HAL_OK, HAL_ERROR/HAL_TIMEOUT se o sensor nao aceitou.
+ */
+HAL_StatusTypeDef AppMotion_Arm(uint8_t mask);
+
+/** @brief Desliga as funcoes embarcadas e devolve o AHRS. */
+void AppMotion_Disarm(void);
+
+/**
+ * Copia o estado e os contadores.
+ * @param status Saida.
+ */
+void AppMotion_GetStatus(AppMotionStatus_t *status);
+
+/** @brief Zera o pedometro e os contadores. */
+void AppMotion_ResetStats(void);
+
+/**
+ * Chamada na interrupcao do INT1 do LSM6DSL.
+ * @param pxHigherPriorityTaskWoken Repassado ao FreeRTOS.
+ */
+void AppMotion_Int(BaseType_t *pxHigherPriorityTaskWoken);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_MOTION_H_ */
@@ -0,0 +1,301 @@
+/**
+ * @file    app_range.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Medidas de distancia do VL53L0X guiadas pela interrupcao do GPIO1
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_range.h"
+
+#include "sensor_drv/sensor_drv.h"
+#include "freertos_utils/freertos_utils.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Como a telemetria: a medida fica no sensor ate ser lida */
+#define APP_RANGE_TASK_PRIORITY		2
+
+/** @brief Sem interrupcao por este tempo, confere o status pelo barramento */
+#define APP_RANGE_POLL_MS			1000
+
+#define APP_RANGE_MUTEX_TIMEOUT		1000
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static AppRangeStatus_t rangeStatus;
+
+/** @brief Soma dos quadrados dos desvios (Welford) */
+static float rangeM2;
+
+static TickType_t firstTick, lastTick;
+
+static uint8_t range_id = SENSOR_DRV_INVALID;
+static uint8_t rangeSub = SENSOR_DRV_INVALID;
+
+/** @brief Contadores do driver no inicio das estatisticas */
+static uint32_t baseTransfers, baseBytes;
+
+static SemaphoreHandle_t mutex_range = NULL;
+static TaskHandle_t rangeTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppRange_Task(void *param);
+
+/** @brief Zera as estatisticas e guarda o trafego atual do driver. */
+static void AppRange_Reset(void);
+
+/**
+ * Soma uma medida as estatisticas.
+ * @param result Medida lida.
+ */
+static void AppRange_Add(const VL53L0X_Result_t *result);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void AppRange_Reset(void)
+{
+	rangeStatus.interrupts = 0;
+	rangeStatus.samples = 0;
+	rangeStatus.invalid = 0;
+	rangeStatus.mean_mm = 0.0f;
+	rangeStatus.std_mm = 0.0f;
+	rangeStatus.interval_ms = 0.0f;
+	rangeM2 = 0.0f;
+
+	VL53L0X_GetBusStats(&baseTransfers, &baseBytes);
+}
+
+static void AppRange_Add(const VL53L0X_Result_t *result)
+{
+	uint32_t valid;
+	float delta;
+
+	rangeStatus.last = *result;
+	rangeStatus.samples++;
+
+	if (result->status != VL53L0X_RANGE_VALID)
+	{
+		rangeStatus.invalid++;
+		return;
+	}
+
+	valid = rangeStatus.samples - rangeStatus.invalid;
+	delta = (float) result->range_mm - rangeStatus.mean_mm;
+	rangeStatus.mean_mm += delta / (float) valid;
+	rangeM2 += delta * ((float) result->range_mm - rangeStatus.mean_mm);
+
+	rangeStatus.std_mm = (valid > 1) ? sqrtf(rangeM2 / (float) (valid - 1)) : 0.0f;
+}
+
+static void AppRange_Task(void *param)
+{
+	VL53L0X_Result_t result;
+	HAL_StatusTypeDef status;
+	uint32_t notified;
+	bool ready;
+
+	for (;;)
+	{
+		notified = ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(APP_RANGE_POLL_MS));
+
+		if (rangeStatus.running == false)
+		{
+			continue;
+		}
+
+		if (SensorDrv_Lock() != HAL_OK)
+		{
+			continue;
+		}
+
+		/* Sem borda: a interrupcao pode ter ficado ativa antes do EXTI ver a subida */
+		ready = (notified > 0) || VL53L0X_DataReady(VL53L0X_I2C_ADDRESS);
+		status = ready ? VL53L0X_ReadResult(VL53L0X_I2C_ADDRESS, &result) : HAL_ERROR;
+
+		SensorDrv_Unlock();
+
+		if (status != HAL_OK)
+		{
+			continue;
+		}
+
+		xSemaphoreTake(mutex_range, portMAX_DELAY);
+
+		if (rangeStatus.samples == 0)
+		{
+			firstTick = xTaskGetTickCount();
+		}
+		lastTick = xTaskGetTickCount();
+
+		AppRange_Add(&result);
+
+		xSemaphoreGive(mutex_range);
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppRange_TaskInit(void)
+{
+	BaseType_t xReturned;
+
+	memset(&rangeStatus, 0, sizeof(rangeStatus));
+
+	range_id = SensorDrv_Find(SENSOR_TYPE_DISTANCE, NULL);
+
+	if (mutex_range == NULL)
+	{
+		mutex_range = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_range);
+		vQueueAddToRegistry(mutex_range, "range");
+	}
+
+	xReturned = xTaskCreate(AppRange_Task, "tkRange", configMINIMAL_STACK_SIZE * 2, NULL, APP_RANGE_TASK_PRIORITY, &rangeTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppRange_Start(uint32_t rate_mhz)
+{
+	if (range_id == SENSOR_DRV_INVALID)
+	{
+		return HAL_ERROR;
+	}
+
+	AppRange_Stop();
+
+	xSemaphoreTake(mutex_range, portMAX_DELAY);
+
+	AppRange_Reset();
+	rangeSub = SensorDrv_Subscribe(range_id, rate_mhz, SENSOR_POWER_NORMAL);
+	rangeStatus.running = (rangeSub != SENSOR_DRV_INVALID);
+	rangeStatus.rate_mhz = rate_mhz;
+
+	/* O GPIO1 usa a linha 7 do EXTI, a mesma do RX do console no STOP2 */
+	if (rangeStatus.running == true)
+	{
+		RTOS_LowPowerLock();
+	}
+
+	xSemaphoreGive(mutex_range);
+
+	return rangeStatus.running ? HAL_OK : HAL_ERROR;
+}
+
+void AppRange_Stop(void)
+{
+	xSemaphoreTake(mutex_range, portMAX_DELAY);
+
+	if (rangeSub != SENSOR_DRV_INVALID)
+	{
+		SensorDrv_Unsubscribe(rangeSub);
+		rangeSub = SENSOR_DRV_INVALID;
+	}
+
+	if (rangeStatus.running == true)
+	{
+		RTOS_LowPowerUnlock();
+	}
+	rangeStatus.running = false;
+
+	xSemaphoreGive(mutex_range);
+}
+
+HAL_StatusTypeDef AppRange_SetBudget(uint32_t budget_us)
+{
+	HAL_StatusTypeDef status;
+
+	if (range_id == SENSOR_DRV_INVALID)
+	{
+		return HAL_ERROR;
+	}
+
+	status = SensorDrv_Lock();
+	if (status != HAL_OK)
+	{
+		return status;
+	}
+
+	status = VL53L0X_SetTimingBudget(VL53L0X_I2C_ADDRESS, budget_us);
+	SensorDrv_Unlock();
+
+	xSemaphoreTake(mutex_range, portMAX_DELAY);
+	AppRange_Reset();
+	xSemaphoreGive(mutex_range);
+
+	return status;
+}
+
+HAL_StatusTypeDef AppRange_Single(VL53L0X_Result_t *result)
+{
+	HAL_StatusTypeDef status;
+
+	if ((range_id == SENSOR_DRV_INVALID) || (rangeStatus.running == true))
+	{
+		return HAL_BUSY;
+	}
+
+	status = SensorDrv_Lock();
+	if (status != HAL_OK)
+	{
+		return status;
+	}
+
+	status = VL53L0X_ReadSingle(VL53L0X_I2C_ADDRESS, result);
+	SensorDrv_Unlock();
+
+	return status;
+}
+
+void AppRange_GetStatus(AppRangeStatus_t *status)
+{
+	uint32_t transfers, bytes;
+
+	VL53L0X_GetBusStats(&transfers, &bytes);
+
+	xSemaphoreTake(mutex_range, portMAX_DELAY);
+
+	rangeStatus.period_ms = VL53L0X_GetPeriod();
+	rangeStatus.budget_us = VL53L0X_GetTimingBudget();
+	rangeStatus.transfers = transfers - baseTransfers;
+	rangeStatus.bytes = bytes - baseBytes;
+	rangeStatus.interval_ms = (rangeStatus.samples > 1) ?
+			(float) ((lastTick - firstTick) * portTICK_PERIOD_MS) / (float) (rangeStatus.samples - 1) : 0.0f;
+
+	*status = rangeStatus;
+
+	xSemaphoreGive(mutex_range);
+}
+
+void AppRange_Int(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	if (rangeTask == NULL)
+	{
+		return;
+	}
+
+	rangeStatus.interrupts++;
+	vTaskNotifyGiveFromISR(rangeTask, pxHigherPriorityTaskWoken);
+}
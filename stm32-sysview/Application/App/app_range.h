@@ -0,0 +1,101 @@
+/**
+ * @file    app_range.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Medidas de distancia do VL53L0X guiadas pela interrupcao do GPIO1
+ * @details
+ * AppRange_Start assina o canal de distancia; o registro escolhe o modo do
+ * sensor (temporizado ou continuo, ver VL53L0X_Driver). A cada medida o
+ * GPIO1 sobe, o EXTI7 acorda a task e ela le o resultado em uma rajada,
+ * sem polling no barramento entre as medidas.
+ *
+ * A task guarda a ultima medida, media e desvio padrao das validas e o
+ * intervalo medido entre interrupcoes, para comparar orcamentos de tempo.
+ */
+
+#ifndef _APP_RANGE_H_
+#define _APP_RANGE_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "vl53l0x/vl53l0x.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado e estatisticas das medidas */
+typedef struct
+{
+	bool running;
+	uint32_t rate_mhz;      /**< Taxa assinada */
+	uint32_t period_ms;     /**< Periodo programado no sensor */
+	uint32_t budget_us;     /**< Orcamento de tempo por medida */
+	VL53L0X_Result_t last;
+	uint32_t interrupts;    /**< Notificacoes do GPIO1 */
+	uint32_t samples;       /**< Medidas lidas */
+	uint32_t invalid;       /**< Medidas sem alvo valido */
+	float mean_mm;          /**< Media das validas */
+	float std_mm;           /**< Desvio padrao das validas */
+	float interval_ms;      /**< Intervalo medio entre interrupcoes */
+	uint32_t transfers;     /**< Transacoes I2C do driver desde o inicio */
+	uint32_t bytes;
+} AppRangeStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Cria a task de distancia (parada). */
+void AppRange_TaskInit(void);
+
+/**
+ * Assina o canal de distancia e zera as estatisticas.
+ * @param rate_mhz Taxa em mHz (o registro escolhe o ODR da lista do driver).
+ */
+HAL_StatusTypeDef AppRange_Start(uint32_t rate_mhz);
+
+/** @brief Libera a assinatura; sem outros assinantes o sensor para. */
+void AppRange_Stop(void);
+
+/**
+ * Troca o orcamento de tempo por medida e zera as estatisticas.
+ * @param budget_us VL53L0X_BUDGET_MIN_US ou mais.
+ */
+HAL_StatusTypeDef AppRange_SetBudget(uint32_t budget_us);
+
+/**
+ * Mede uma vez com o sensor parado.
+ * @param result Saida.
+ */
+HAL_StatusTypeDef AppRange_Single(VL53L0X_Result_t *result);
+
+/**
+ * Copia o estado e as estatisticas.
+ * @param status Saida.
+ */
+void AppRange_GetStatus(AppRangeStatus_t *status);
+
+/**
+ * Chamada na interrupcao do GPIO1 do VL53L0X.
+ * @param pxHigherPriorityTaskWoken Repassado ao FreeRTOS.
+ */
+void AppRange_Int(BaseType_t *pxHigherPriorityTaskWoken);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_RANGE_H_ */
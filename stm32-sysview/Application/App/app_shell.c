@@ -12,16 +12,33 @@
 
 #include "app_shell.h"
 #include "sensores.h"
+#include "sensor_cache.h"
+#include "app_ahrs.h"
+#include "app_magcal.h"
+#include "app_telemetry.h"
+#include "app_audio.h"
+#include "app_motion.h"
+#include "app_range.h"
+#include "app_winstats.h"
+#include "app_vibration.h"
+#include "app_filter.h"
+#include "app_baro.h"
+#include "app_timesync.h"
+#include "app_sysmon.h"
 #include "setup_hw.h"
 
 #include "leds/leds.h"
+#include "imuconv/imuconv.h"
+#include "lsm6dsl/lsm6dsl.h"
 #include "micro-shell/micro-shell.h"
 #include "freertos_utils/freertos_utils.h"
+#include "timebase/timebase.h"
 
 #include <stdio.h>
 #include <string.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include <strings.h>
 
 #if defined(USE_SYSVIEW)
 #include "SEGGER_SYSVIEW.h"
@@ -31,6 +48,12 @@
 // PRIVATE DEFINITIONS
 //==============================================================================
 
+/** @brief Amostras do bloco medido pelo comando imuconv */
+#define SHELL_IMUCONV_SAMPLES	256
+
+/** @brief Faixas mostradas pelo comando "audio spectrum" */
+#define SHELL_AUDIO_BANDS		16
+
 //==============================================================================
 // PRIVATE TYPEDEFS
 //==============================================================================
@@ -39,17 +62,54 @@
 // PRIVATE VARIABLES
 //==============================================================================
 
-Sensors_t StrSensor;
 TaskHandle_t xHandleTaskCPU = NULL;
 BaseType_t xReturned;
 
+/** @brief Assinatura feita pelo shell em cada canal, mais 1 (0 = nenhuma) */
+static uint8_t shellSub[SENSOR_DRV_MAX_CHANNELS];
+
+static const char * const strSensorMode[] = { "off", "oneshot", "cont" };
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
 
 static HAL_StatusTypeDef Help_Commads(void);
 static HAL_StatusTypeDef Sensors_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Sensor_CommandLine(uint16_t argc, uint8_t **argv);
 static HAL_StatusTypeDef Leds_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Cache_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Ahrs_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef MagCal_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Tlm_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef ImuConv_CommandLine(void);
+static HAL_StatusTypeDef Audio_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Motion_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Range_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef WStats_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Vib_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Filter_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Baro_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef TSync_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Load_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef LowPower_CommandLine(uint16_t argc, uint8_t **argv);
+static HAL_StatusTypeDef Top_CommandLine(uint16_t argc, uint8_t **argv);
+
+/**
+ * Interpreta um estagio de filtro: ma:<n>, ema:<alpha>, lp:<hz>:<ordem>,
+ * hp:<hz>:<ordem> ou dec:<fator>.
+ * @param arg Texto do estagio.
+ * @param stage Saida.
+ * @return false se o texto nao for reconhecido.
+ */
+static bool Filter_ParseStage(const char *arg, AppFilterStage_t *stage);
+
+/**
+ * Mede um kernel de conversao com o contador de ciclos.
+ * @return Ciclos gastos no bloco.
+ */
+static uint32_t ImuConv_Measure(void (*kernel)(const ImuConv_t *, const uint8_t *, int32_t *, uint32_t),
+		const ImuConv_t *conv, const uint8_t *bytes, int32_t *out);
 
 //==============================================================================
 // SOURCE CODE
@@ -73,18 +133,38 @@ static HAL_StatusTypeDef Help_Commads(void)
 {
 	SHELL_PRINTF("Supported commands:\r\n");
 	SHELL_PRINTF("> rtos");
-	SHELL_PRINTF("> get <v1>");
+	SHELL_PRINTF("> get <channel|chip> [force]");
 	SHELL_PRINTF("\t temperature");
 	SHELL_PRINTF("\t humidity");
 	SHELL_PRINTF("\t pressure");
 	SHELL_PRINTF("\t gyro");
 	SHELL_PRINTF("\t magneto");
 	SHELL_PRINTF("\t accelero");
+	SHELL_PRINTF("\t distance");
+	SHELL_PRINTF("> sensor [reset|<id> odr <hz>|range <fs>|power <off|low|normal>|sub <hz|off>|filter <n>]");
+	SHELL_PRINTF("> cache [reset]");
+	SHELL_PRINTF("> ahrs [reset]");
+	SHELL_PRINTF("> magcal [start|stop|reset|save]");
+	SHELL_PRINTF("> tlm [start <hz>|stop|mask <hex>|delta <on|off>|list|reset]");
+	SHELL_PRINTF("> imuconv");
+	SHELL_PRINTF("> audio [start <16000|32000|48000>|stop|spectrum]");
+	SHELL_PRINTF("> motion [arm [hex mask]|disarm|reset]");
+	SHELL_PRINTF("> range [start <hz>|stop|single|budget <us>]");
+	SHELL_PRINTF("> wstats [set <slot> <id> <axis> <hz> <s> [s] [s]|clear <slot>|reset]");
+	SHELL_PRINTF("> vib [start [n] [hz] [axis]|stop|band <lo> <hi> [<lo> <hi>...]|bench]");
+	SHELL_PRINTF("> filter [set <chain> <id> <hz> <ma:n|ema:a|lp:hz:ord|hp:hz:ord|dec:m>...|clear <chain>]");
+	SHELL_PRINTF("> baro [start [hz] [wtm]|stop|zero|qnh <hPa>]");
+	SHELL_PRINTF("> tsync [<seq> <t1> <t4>|reset]");
+	SHELL_PRINTF("> load [reset]");
+	SHELL_PRINTF("> lowpower [reset]");
+	SHELL_PRINTF("> top [<ms> [n]|stop|tlm <on|off>|info]");
 	SHELL_PRINTF("> led <v1>");
 	SHELL_PRINTF("\t on");
 	SHELL_PRINTF("\t off");
 	SHELL_PRINTF("\t blink");
 	SHELL_PRINTF("\t heartbeat");
+	SHELL_PRINTF("\t breath");
+	SHELL_PRINTF("\t stats [reset]");
 	SHELL_PRINTF("> consume");
 	SHELL_PRINTF("\t create");
 	SHELL_PRINTF("\t delete");
@@ -94,35 +174,133 @@ static HAL_StatusTypeDef Help_Commads(void)
 
 static HAL_StatusTypeDef Sensors_CommandLine(uint16_t argc, uint8_t **argv)
 {
-	HAL_StatusTypeDef err = HAL_OK;
+	const SensorChannelDesc_t *desc;
+	bool force = false;
+	bool found = false;
+	uint8_t id;
 
-	if (strcmp((const char *) "temperature", (const char *) argv[0]) == 0)
+	if (argc < 1)
 	{
-		Temperature_Test(&StrSensor);
+		return HAL_ERROR;
 	}
-	else if (strcmp((const char *) "humidity", (const char *) argv[0]) == 0)
+
+	/* "force" descarta a copia em cache e obriga a leitura do sensor */
+	if ((argc > 1) && (strcmp((const char *) "force", (const char *) argv[1]) == 0))
 	{
-		Humidity_Test(&StrSensor);
+		force = true;
 	}
-	else if (strcmp((const char *) "pressure", (const char *) argv[0]) == 0)
+
+	/* Aceita o nome da grandeza ("temperature") ou do CI ("lps22hb") */
+	for (id = 0; id < SensorDrv_GetNumChannels(); id++)
 	{
-		Pressure_Test(&StrSensor);
+		desc = SensorDrv_GetDesc(id);
+
+		if ((strcasecmp(desc->name, (const char *) argv[0]) == 0) ||
+				(strcasecmp(SensorDrv_GetOwner(id)->name, (const char *) argv[0]) == 0))
+		{
+			Sensores_PrintChannel(id, force);
+			found = true;
+		}
 	}
-	else if (strcmp((const char *) "gyro", (const char *) argv[0]) == 0)
+
+	return found ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef Sensor_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	const SensorChannelDesc_t *desc;
+	SensorDrvStatus_t status;
+	HAL_StatusTypeDef err = HAL_ERROR;
+	uint32_t rate;
+	uint8_t id, handle;
+
+	/* Sem argumentos: lista os canais registrados, o modo e o trafego gerado */
+	if (argc < 1)
 	{
-		Gyro_Test(&StrSensor);
+		SHELL_PRINTF("%-3s %-8s %-12s %-7s %6s %-7s %9s %9s %4s %8s %8s", "id", "chip", "channel", "unit", "range",
+				"mode", "rate(Hz)", "dem(Hz)", "subs", "reads", "oneshot");
+		for (id = 0; id < SensorDrv_GetNumChannels(); id++)
+		{
+			desc = SensorDrv_GetDesc(id);
+			SensorDrv_GetStatus(id, &status);
+			SHELL_PRINTF("%-3u %-8s %-12s %-7s %6lu %-7s %9.3f %9.3f %4u %8lu %8lu", id, SensorDrv_GetOwner(id)->name,
+					desc->name, desc->unit, SensorDrv_GetRange(id), strSensorMode[status.mode],
+					(float) SensorDrv_GetRate(id) / 1000.0f, (float) status.demand / 1000.0f,
+					status.subscribers, status.reads, status.triggers);
+		}
+
+		return HAL_OK;
 	}
-	else if (strcmp((const char *) "magneto", (const char *) argv[0]) == 0)
+
+	if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
 	{
-		Magneto_Test(&StrSensor);
+		SensorDrv_ResetStats();
+		return HAL_OK;
 	}
-	else if (strcmp((const char *) "accelero", (const char *) argv[0]) == 0)
+
+	id = (uint8_t) atoi((const char *) argv[0]);
+	if ((id >= SensorDrv_GetNumChannels()) || (argc < 3))
 	{
-		Accelero_Test(&StrSensor);
+		return HAL_ERROR;
 	}
-	else
+
+	if (strcmp((const char *) "odr", (const char *) argv[1]) == 0)
 	{
-		err = HAL_ERROR;
+		err = SensorDrv_SetOdr(id, (uint32_t) (atof((const char *) argv[2]) * 1000.0));
+	}
+	else if (strcmp((const char *) "range", (const char *) argv[1]) == 0)
+	{
+		err = SensorDrv_SetRange(id, (uint32_t) atoi((const char *) argv[2]));
+	}
+	else if (strcmp((const char *) "power", (const char *) argv[1]) == 0)
+	{
+		if (strcmp((const char *) "off", (const char *) argv[2]) == 0)
+		{
+			err = SensorDrv_SetPower(id, SENSOR_POWER_OFF);
+		}
+		else if (strcmp((const char *) "low", (const char *) argv[2]) == 0)
+		{
+			err = SensorDrv_SetPower(id, SENSOR_POWER_LOW);
+		}
+		else if (strcmp((const char *) "normal", (const char *) argv[2]) == 0)
+		{
+			err = SensorDrv_SetPower(id, SENSOR_POWER_NORMAL);
+		}
+	}
+	else if (strcmp((const char *) "sub", (const char *) argv[1]) == 0)
+	{
+		/* O shell mantem uma assinatura por canal, trocada a cada comando */
+		if (shellSub[id] != 0)
+		{
+			SensorDrv_Unsubscribe(shellSub[id] - 1);
+			shellSub[id] = 0;
+		}
+
+		err = HAL_OK;
+		if (strcmp((const char *) "off", (const char *) argv[2]) != 0)
+		{
+			rate = (uint32_t) (atof((const char *) argv[2]) * 1000.0);
+			handle = SensorDrv_Subscribe(id, rate, SENSOR_POWER_LOW);
+			if (handle != SENSOR_DRV_INVALID)
+			{
+				shellSub[id] = handle + 1;
+			}
+			else
+			{
+				err = HAL_ERROR;
+			}
+		}
+	}
+	else if (strcmp((const char *) "filter", (const char *) argv[1]) == 0)
+	{
+		err = SensorDrv_SetFilter(id, (uint16_t) atoi((const char *) argv[2]));
+	}
+
+	/* Janela do cache acompanha o novo ODR */
+	if (err == HAL_OK)
+	{
+		SensorCache_Reconfigure();
+		SensorCache_Invalidate(id);
 	}
 
 	return err;
@@ -131,6 +309,12 @@ static HAL_StatusTypeDef Sensors_CommandLine(uint16_t argc, uint8_t **argv)
 static HAL_StatusTypeDef Leds_CommandLine(uint16_t argc, uint8_t **argv)
 {
 	HAL_StatusTypeDef err = HAL_OK;
+	LedsStats_t stats;
+
+	if (argc < 1)
+	{
+		return HAL_ERROR;
+	}
 
 	if (strcmp((const char *) "on", (const char *) argv[0]) == 0)
 	{
@@ -148,6 +332,23 @@ static HAL_StatusTypeDef Leds_CommandLine(uint16_t argc, uint8_t **argv)
 	{
 		Leds_Set(N_LED1, LED_BLINK_HEARTBEAT);
 	}
+	else if (strcmp((const char *) "breath", (const char *) argv[0]) == 0)
+	{
+		Leds_Set(N_LED1, LED_BREATH);
+	}
+	else if (strcmp((const char *) "stats", (const char *) argv[0]) == 0)
+	{
+		if ((argc > 1) && (strcmp((const char *) "reset", (const char *) argv[1]) == 0))
+		{
+			Leds_ResetStats();
+			return HAL_OK;
+		}
+
+		Leds_GetStats(&stats);
+		SHELL_PRINTF("wakeups %lu (%.2f/s), commands %lu, transitions %lu in %lu ms", stats.wakeups,
+				(stats.elapsed_ms > 0) ? (float) stats.wakeups * 1000.0f / (float) stats.elapsed_ms : 0.0f,
+				stats.commands, stats.transitions, stats.elapsed_ms);
+	}
 	else
 	{
 		err = HAL_ERROR;
@@ -156,6 +357,865 @@ static HAL_StatusTypeDef Leds_CommandLine(uint16_t argc, uint8_t **argv)
 	return err;
 }
 
+static HAL_StatusTypeDef Cache_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	SensorCacheStats_t stats;
+	uint8_t id;
+
+	if ((argc > 0) && (strcmp((const char *) "reset", (const char *) argv[0]) == 0))
+	{
+		SensorCache_ResetStats();
+		return HAL_OK;
+	}
+
+	SHELL_PRINTF("%-8s %-12s %10s %10s %10s %8s", "chip", "channel", "hits", "misses", "coalesced", "window");
+	for (id = 0; id < SensorDrv_GetNumChannels(); id++)
+	{
+		SensorCache_GetStats(id, &stats);
+		SHELL_PRINTF("%-8s %-12s %10lu %10lu %10lu %6lums", SensorDrv_GetOwner(id)->name, SensorDrv_GetDesc(id)->name,
+				stats.hits, stats.misses, stats.coalesced,
+				(uint32_t)(stats.validity * portTICK_PERIOD_MS));
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Ahrs_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppAhrsOutput_t out;
+
+	if ((argc > 0) && (strcmp((const char *) "reset", (const char *) argv[0]) == 0))
+	{
+		AppAhrs_ResetStats();
+		return HAL_OK;
+	}
+
+	AppAhrs_Get(&out);
+
+	SHELL_PRINTF("quat:  %.4f %.4f %.4f %.4f", out.q[0], out.q[1], out.q[2], out.q[3]);
+	SHELL_PRINTF("euler: roll %.2f pitch %.2f yaw %.2f deg", out.euler.roll, out.euler.pitch, out.euler.yaw);
+	SHELL_PRINTF("bias:  %.3f %.3f %.3f dps", out.bias_dps[0], out.bias_dps[1], out.bias_dps[2]);
+	SHELL_PRINTF("cost:  %lu cycles (%lu us), max %lu cycles, %lu updates",
+			out.cycles_last, out.cycles_last / (SystemCoreClock / 1000000UL),
+			out.cycles_max, out.updates);
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef MagCal_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppMagCalStatus_t st;
+	uint8_t i;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "start", (const char *) argv[0]) == 0)
+		{
+			AppMagCal_SetLearning(true);
+		}
+		else if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+		{
+			AppMagCal_SetLearning(false);
+		}
+		else if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			AppMagCal_Reset();
+		}
+		else if (strcmp((const char *) "save", (const char *) argv[0]) == 0)
+		{
+			return AppMagCal_Save();
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppMagCal_GetStatus(&st);
+
+	SHELL_PRINTF("learning %d, applied %d, stored %d", st.learning, st.applied, st.stored);
+	SHELL_PRINTF("samples %lu, solves %lu, coverage %u/%u, residual %.2f%%, delta %.3f%%, converged %d",
+			st.quality.samples, st.quality.solves, st.quality.coverage, MAGCAL_NUM_BINS,
+			st.quality.residual * 100.0f, st.quality.delta * 100.0f, st.quality.converged);
+	SHELL_PRINTF("offset: %.4f %.4f %.4f gauss, radius %.4f gauss",
+			st.params.offset[0], st.params.offset[1], st.params.offset[2], st.params.radius);
+	for (i = 0; i < 3; i++)
+	{
+		SHELL_PRINTF("soft[%u]: %.4f %.4f %.4f", i, st.params.soft[i][0], st.params.soft[i][1], st.params.soft[i][2]);
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Tlm_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppTelemetryStats_t st;
+	DebugTxStats_t tx;
+	const TlmSignal_t *sig;
+	uint8_t i;
+
+	if (argc > 0)
+	{
+		if ((strcmp((const char *) "start", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			return AppTelemetry_Start((uint32_t) (atof((const char *) argv[1]) * 1000.0));
+		}
+		else if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+		{
+			AppTelemetry_Stop();
+		}
+		else if ((strcmp((const char *) "mask", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			return AppTelemetry_SetMask((uint32_t) strtoul((const char *) argv[1], NULL, 16));
+		}
+		else if ((strcmp((const char *) "delta", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			AppTelemetry_SetDelta(strcmp((const char *) "on", (const char *) argv[1]) == 0);
+		}
+		else if (strcmp((const char *) "list", (const char *) argv[0]) == 0)
+		{
+			AppTelemetry_GetStats(&st);
+			SHELL_PRINTF("%-3s %-3s %-24s %-7s %8s", "bit", "sel", "signal", "unit", "scale");
+			for (i = 0; i < AppTelemetry_GetNumSignals(); i++)
+			{
+				sig = AppTelemetry_GetSignal(i);
+				SHELL_PRINTF("%-3u %-3s %-24s %-7s %8ld", i, (st.mask & (1UL << i)) ? "*" : "", sig->name, sig->unit, sig->scale);
+			}
+		}
+		else if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			AppTelemetry_ResetStats();
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppTelemetry_GetStats(&st);
+	Debug_GetTxStats(&tx);
+
+	SHELL_PRINTF("running %d, delta %d, rate %.3f Hz, mask 0x%08lX", st.running, st.delta,
+			(float) st.rate_mhz / 1000.0f, st.mask);
+	SHELL_PRINTF("frames %lu (full %lu), dropped %lu, %lu bytes, %.1f bytes/frame",
+			st.frames, st.full, st.dropped, st.bytes,
+			(st.frames > 0) ? (float) st.bytes / (float) st.frames : 0.0f);
+	SHELL_PRINTF("measured %.1f frames/s, %.0f B/s in %lu ms",
+			(st.elapsed_ms > 0) ? (float) st.frames * 1000.0f / (float) st.elapsed_ms : 0.0f,
+			(st.elapsed_ms > 0) ? (float) st.bytes * 1000.0f / (float) st.elapsed_ms : 0.0f,
+			st.elapsed_ms);
+	SHELL_PRINTF("uart tx: %lu bytes, %lu dropped writes, peak queue %u/%u",
+			tx.bytes, tx.dropped, tx.used_max, DEBUG_TX_BUFFER_SIZE);
+
+	return HAL_OK;
+}
+
+static uint32_t ImuConv_Measure(void (*kernel)(const ImuConv_t *, const uint8_t *, int32_t *, uint32_t),
+		const ImuConv_t *conv, const uint8_t *bytes, int32_t *out)
+{
+	uint32_t start, cycles;
+
+	/* Sem interrupcoes no meio: o bloco leva poucas centenas de us */
+	taskENTER_CRITICAL();
+	start = Timebase_Cycles32();
+	kernel(conv, bytes, out, SHELL_IMUCONV_SAMPLES);
+	cycles = Timebase_Cycles32() - start;
+	taskEXIT_CRITICAL();
+
+	return cycles;
+}
+
+static HAL_StatusTypeDef ImuConv_CommandLine(void)
+{
+	static uint8_t bytes[SHELL_IMUCONV_SAMPLES * IMUCONV_SAMPLE_BYTES];
+	static int32_t out[SHELL_IMUCONV_SAMPLES * 3];
+	static int32_t ref[SHELL_IMUCONV_SAMPLES * 3];
+	static const int8_t remap[3] = { 2, -1, 3 };
+	static const int16_t bias[3] = { 12, -30, 7 };
+	uint32_t mhz = SystemCoreClock / 1000000UL;
+	uint32_t fast, slow, i;
+	ImuConv_t conv;
+
+	for (i = 0; i < sizeof(bytes); i++)
+	{
+		bytes[i] = (uint8_t) rand();
+	}
+
+	/* Gyro a 2000 dps com eixos trocados e bias, como no benchmark do PC */
+	ImuConv_Init(&conv, 7000);
+	ImuConv_SetRemap(&conv, remap);
+	ImuConv_SetBias(&conv, bias);
+
+	fast = ImuConv_Measure(ImuConv_Bytes, &conv, bytes, out);
+	slow = ImuConv_Measure(ImuConv_BytesRef, &conv, bytes, ref);
+
+	SHELL_PRINTF("%u samples, %lu MHz", SHELL_IMUCONV_SAMPLES, mhz);
+	SHELL_PRINTF("simd: %lu cycles, %.2f samples/us", fast, (float) SHELL_IMUCONV_SAMPLES * mhz / (float) fast);
+	SHELL_PRINTF("ref:  %lu cycles, %.2f samples/us", slow, (float) SHELL_IMUCONV_SAMPLES * mhz / (float) slow);
+	SHELL_PRINTF("match %d", memcmp(out, ref, sizeof(out)) == 0);
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Audio_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	static const char bar[] = "########################################";
+	float db[SHELL_AUDIO_BANDS];
+	AppAudioStatus_t st;
+	float width;
+	int len;
+	uint8_t i;
+
+	if (argc > 0)
+	{
+		if ((strcmp((const char *) "start", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			return AppAudio_Start((uint32_t) strtoul((const char *) argv[1], NULL, 10));
+		}
+		else if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+		{
+			AppAudio_Stop();
+		}
+		else if (strcmp((const char *) "spectrum", (const char *) argv[0]) == 0)
+		{
+			width = AppAudio_GetBands(db, SHELL_AUDIO_BANDS);
+			if (width == 0.0f)
+			{
+				SHELL_PRINTF("no spectrum yet");
+				return HAL_OK;
+			}
+
+			/* Uma barra a cada 3 dB acima de -120 dBFS */
+			for (i = 0; i < SHELL_AUDIO_BANDS; i++)
+			{
+				len = (int) ((db[i] - AUDIO_DSP_MIN_DB) / 3.0f);
+				len = (len < 0) ? 0 : ((len > (int) sizeof(bar) - 1) ? (int) sizeof(bar) - 1 : len);
+				SHELL_PRINTF("%5.0f-%5.0f Hz %6.1f dBFS %.*s", i * width, (i + 1) * width, db[i], len, bar);
+			}
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppAudio_GetStatus(&st);
+
+	SHELL_PRINTF("running %d, rate %lu Hz (actual %lu Hz), block %u samples, overruns %lu",
+			st.running, st.rate_hz, st.actual_hz, st.block, st.overruns);
+	SHELL_PRINTF("level %.1f dBFS, peak %.1f dBFS, noise %.1f dBFS, active %d",
+			st.dsp.level_db, st.dsp.peak_db, st.dsp.noise_db, st.dsp.active);
+	SHELL_PRINTF("blocks %lu, active %lu, spectra %lu, last peak %.1f Hz at %.1f dBFS",
+			st.dsp.blocks, st.dsp.active_blocks, st.dsp.spectra, st.dsp.peak_hz, st.dsp.peak_bin_db);
+	SHELL_PRINTF("cycles/block last %lu, max %lu, avg %.0f (%.1f%% of %lu)",
+			st.cycles_last, st.cycles_max,
+			(st.dsp.blocks > 0) ? (float) st.cycles_total / (float) st.dsp.blocks : 0.0f,
+			(st.dsp.blocks > 0) ? 100.0f * (float) st.cycles_total / ((float) st.dsp.blocks * (float) st.cycles_budget) : 0.0f,
+			st.cycles_budget);
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Motion_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	static const char * const strState[] = { "disarmed", "idle", "capture" };
+	AppMotionStatus_t st;
+	AppMotionUsage_t *u;
+	uint8_t mask = APP_MOTION_DEFAULT_MASK;
+	uint8_t i;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "arm", (const char *) argv[0]) == 0)
+		{
+			if (argc > 1)
+			{
+				mask = (uint8_t) strtoul((const char *) argv[1], NULL, 16);
+			}
+			return AppMotion_Arm(mask);
+		}
+		else if (strcmp((const char *) "disarm", (const char *) argv[0]) == 0)
+		{
+			AppMotion_Disarm();
+		}
+		else if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			AppMotion_ResetStats();
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppMotion_GetStatus(&st);
+
+	SHELL_PRINTF("state %s, mask 0x%02X, interrupts %lu, captures %lu, samples %lu, peak %ld mg, steps %u",
+			strState[st.state], st.mask, st.interrupts, st.captures, st.samples, st.peak_mg, (unsigned int) st.steps);
+	SHELL_PRINTF("events: wake-up %lu, free-fall %lu, tilt %lu, sign-motion %lu, step %lu",
+			st.events[0], st.events[1], st.events[2], st.events[3], st.events[4]);
+
+	/* CPU fora da IDLE e trafego I2C do LSM6DSL por estado */
+	for (i = 0; i < APP_MOTION_STATE_MAX; i++)
+	{
+		u = &st.usage[i];
+		SHELL_PRINTF("%-8s %8lu ms, cpu %5.2f%%, i2c %lu transfers (%.1f/min), %lu bytes",
+				strState[i], u->time_ms,
+				(u->total > 0) ? 100.0f * (float) u->busy / (float) u->total : 0.0f,
+				u->transfers,
+				(u->time_ms > 0) ? 60000.0f * (float) u->transfers / (float) u->time_ms : 0.0f,
+				u->bytes);
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Range_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	VL53L0X_Result_t res;
+	AppRangeStatus_t st;
+	HAL_StatusTypeDef err;
+
+	if (argc > 0)
+	{
+		if ((strcmp((const char *) "start", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			return AppRange_Start((uint32_t) (strtof((const char *) argv[1], NULL) * 1000.0f));
+		}
+		else if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+		{
+			AppRange_Stop();
+		}
+		else if (strcmp((const char *) "single", (const char *) argv[0]) == 0)
+		{
+			err = AppRange_Single(&res);
+			if (err != HAL_OK)
+			{
+				return err;
+			}
+			SHELL_PRINTF("%u mm, status %u, signal %.2f MCPS, ambient %.2f MCPS, spads %.1f",
+					res.range_mm, res.status, res.signal / 128.0f, res.ambient / 128.0f, res.spads / 256.0f);
+		}
+		else if ((strcmp((const char *) "budget", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			return AppRange_SetBudget((uint32_t) strtoul((const char *) argv[1], NULL, 10));
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppRange_GetStatus(&st);
+
+	SHELL_PRINTF("running %d, rate %.1f Hz, period %lu ms, budget %lu us",
+			st.running, st.rate_mhz / 1000.0f, st.period_ms, st.budget_us);
+	SHELL_PRINTF("last %u mm, status %u, signal %.2f MCPS, ambient %.2f MCPS",
+			st.last.range_mm, st.last.status, st.last.signal / 128.0f, st.last.ambient / 128.0f);
+	SHELL_PRINTF("interrupts %lu, samples %lu, invalid %lu, mean %.1f mm, std %.2f mm, interval %.1f ms",
+			st.interrupts, st.samples, st.invalid, st.mean_mm, st.std_mm, st.interval_ms);
+	SHELL_PRINTF("i2c %lu transfers, %lu bytes (%.1f transfers/sample)", st.transfers, st.bytes,
+			(st.samples > 0) ? (float) st.transfers / (float) st.samples : 0.0f);
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef WStats_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppWStatsConfig_t cfg;
+	AppWStatsSlot_t st;
+	WinStatsResult_t r;
+	uint8_t slot, w;
+	float scale;
+
+	if (argc > 0)
+	{
+		if ((strcmp((const char *) "set", (const char *) argv[0]) == 0) && (argc > 5))
+		{
+			memset(&cfg, 0, sizeof(cfg));
+			slot = (uint8_t) atoi((const char *) argv[1]);
+			cfg.id = (uint8_t) atoi((const char *) argv[2]);
+			cfg.axis = (uint8_t) atoi((const char *) argv[3]);
+			cfg.rate_mhz = (uint32_t) (atof((const char *) argv[4]) * 1000.0);
+
+			for (w = 0; (w < WINSTATS_MAX_WINDOWS) && (5U + w < argc); w++)
+			{
+				cfg.window_ms[w] = (uint32_t) (atof((const char *) argv[5 + w]) * 1000.0);
+			}
+			cfg.num_windows = w;
+
+			if (AppWStats_Set(slot, &cfg) != HAL_OK)
+			{
+				SHELL_PRINTF("needs %lu of %u bytes", AppWStats_MemSize(&cfg), APP_WSTATS_SLOT_BYTES);
+				return HAL_ERROR;
+			}
+		}
+		else if ((strcmp((const char *) "clear", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			AppWStats_Clear((uint8_t) atoi((const char *) argv[1]));
+		}
+		else if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			AppWStats_Reset();
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	for (slot = 0; slot < APP_WSTATS_SLOTS; slot++)
+	{
+		AppWStats_GetSlot(slot, &st);
+		if (st.active == false)
+		{
+			SHELL_PRINTF("slot %u: off", slot);
+			continue;
+		}
+
+		SHELL_PRINTF("slot %u: %s at %.1f Hz, %lu samples, %lu misses, %lu/%u bytes, update %lu cycles (max %lu)",
+				slot, st.name, st.config.rate_mhz / 1000.0f, st.samples, st.misses, st.bytes, APP_WSTATS_SLOT_BYTES,
+				st.cycles_last, st.cycles_max);
+
+		scale = (float) st.scale;
+		for (w = 0; w < st.config.num_windows; w++)
+		{
+			if (AppWStats_GetWindow(slot, w, &r) == false)
+			{
+				continue;
+			}
+			SHELL_PRINTF("\t %6.1f s: n %5u, mean %.3f, std %.3f, min %.3f, max %.3f %s",
+					st.config.window_ms[w] / 1000.0f, r.count, r.mean / scale, r.std / scale,
+					(float) r.min / scale, (float) r.max / scale, st.unit);
+		}
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Vib_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	VibBand_t bands[VIB_MAX_BANDS];
+	AppVibStatus_t st;
+	int64_t host;
+	uint32_t error;
+	uint32_t cycles, cycles_ref;
+	uint16_t size;
+	uint8_t count, i;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "start", (const char *) argv[0]) == 0)
+		{
+			return AppVib_Start((argc > 1) ? (uint16_t) atoi((const char *) argv[1]) : APP_VIB_DEF_SIZE,
+					(argc > 2) ? (uint32_t) (atof((const char *) argv[2]) * 1000.0) : APP_VIB_DEF_RATE_MHZ,
+					(argc > 3) ? (uint8_t) atoi((const char *) argv[3]) : 2);
+		}
+		else if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+		{
+			AppVib_Stop();
+		}
+		else if ((strcmp((const char *) "band", (const char *) argv[0]) == 0) && (argc > 2))
+		{
+			for (count = 0; (count < VIB_MAX_BANDS) && (2U * count + 2U < argc); count++)
+			{
+				bands[count].lo_hz = strtof((const char *) argv[2 * count + 1], NULL);
+				bands[count].hi_hz = strtof((const char *) argv[2 * count + 2], NULL);
+			}
+			return AppVib_SetBands(bands, count);
+		}
+		else if (strcmp((const char *) "bench", (const char *) argv[0]) == 0)
+		{
+			for (size = VIB_MIN_SIZE; size <= APP_VIB_MAX_SIZE; size *= 2)
+			{
+				if (AppVib_Bench(size, &cycles, &cycles_ref) != HAL_OK)
+				{
+					SHELL_PRINTF("stop the analysis first");
+					return HAL_BUSY;
+				}
+				SHELL_PRINTF("fft %4u: radix-2^2 %7lu cycles (%6.1f us), radix-2 %7lu cycles (%6.1f us), %.2fx",
+						size, cycles, cycles * 1e6f / SystemCoreClock, cycles_ref, cycles_ref * 1e6f / SystemCoreClock,
+						(float) cycles_ref / (float) cycles);
+			}
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppVib_GetStatus(&st);
+	count = AppVib_GetBands(bands);
+
+	SHELL_PRINTF("running %d, n %u, axis %c, rate %.1f Hz, resolution %.3f Hz", st.running, st.size, 'x' + st.axis,
+			st.rate_hz, st.result.resolution_hz);
+	SHELL_PRINTF("samples %lu, frames %lu, fifo overruns %lu, restarts %lu, process %lu cycles (%.1f us, max %lu)",
+			st.samples, st.frames, st.overruns, st.restarts, st.cycles_last, st.cycles_last * 1e6f / SystemCoreClock,
+			st.cycles_max);
+
+	if (st.frames == 0)
+	{
+		return HAL_OK;
+	}
+
+	SHELL_PRINTF("rms %.4f m/s2, velocity %.3f mm/s", st.result.rms, st.result.velocity_rms);
+
+	if (AppTimeSync_ToHost(st.frame_us, &host, &error) == true)
+	{
+		SHELL_PRINTF("frame end %lu.%06lu s (PC %ld.%06lu s +- %lu us)", (unsigned long) (st.frame_us / 1000000ULL),
+				(unsigned long) (st.frame_us % 1000000ULL), (long) (host / 1000000LL),
+				(unsigned long) ((host < 0 ? -host : host) % 1000000LL), (unsigned long) error);
+	}
+	else
+	{
+		SHELL_PRINTF("frame end %lu.%06lu s", (unsigned long) (st.frame_us / 1000000ULL),
+				(unsigned long) (st.frame_us % 1000000ULL));
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		SHELL_PRINTF("\t band %6.1f - %6.1f Hz: %.4f m/s2", bands[i].lo_hz, bands[i].hi_hz, st.result.band_rms[i]);
+	}
+
+	for (i = 0; (i < VIB_MAX_PEAKS) && (st.result.peak_hz[i] > 0.0f); i++)
+	{
+		SHELL_PRINTF("\t peak %7.2f Hz: %.4f m/s2", st.result.peak_hz[i], st.result.peak_rms[i]);
+	}
+
+	return HAL_OK;
+}
+
+static bool Filter_ParseStage(const char *arg, AppFilterStage_t *stage)
+{
+	static const char * const names[] = { "ma:", "ema:", "lp:", "hp:", "dec:" };
+	const char *p;
+	char *end;
+	uint8_t k;
+
+	for (k = 0; k < sizeof(names) / sizeof(names[0]); k++)
+	{
+		if (strncmp(arg, names[k], strlen(names[k])) == 0)
+		{
+			break;
+		}
+	}
+
+	if (k == sizeof(names) / sizeof(names[0]))
+	{
+		return false;
+	}
+
+	p = arg + strlen(names[k]);
+	stage->kind = (AppFilterKind_e) k;
+	stage->param = strtof(p, &end);
+	stage->order = 2;
+
+	if (end == p)
+	{
+		return false;
+	}
+
+	if (*end == ':')
+	{
+		stage->order = (uint8_t) atoi(end + 1);
+	}
+
+	return true;
+}
+
+static HAL_StatusTypeDef Filter_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	static const char * const strKind[] = { "ma", "ema", "lp", "hp", "dec" };
+	AppFilterConfig_t cfg;
+	AppFilterChain_t st;
+	const AppFilterStage_t *stage;
+	uint8_t chain, s;
+
+	if (argc > 0)
+	{
+		if ((strcmp((const char *) "set", (const char *) argv[0]) == 0) && (argc > 4))
+		{
+			memset(&cfg, 0, sizeof(cfg));
+			chain = (uint8_t) atoi((const char *) argv[1]);
+			cfg.id = (uint8_t) atoi((const char *) argv[2]);
+			cfg.rate_mhz = (uint32_t) (atof((const char *) argv[3]) * 1000.0);
+
+			for (s = 0; (s < APP_FILTER_STAGES) && (4U + s < argc); s++)
+			{
+				if (Filter_ParseStage((const char *) argv[4 + s], &cfg.stages[s]) == false)
+				{
+					SHELL_PRINTF("invalid stage: %s", argv[4 + s]);
+					return HAL_ERROR;
+				}
+			}
+			cfg.num_stages = s;
+
+			return AppFilter_Set(chain, &cfg);
+		}
+		else if ((strcmp((const char *) "clear", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			AppFilter_Clear((uint8_t) atoi((const char *) argv[1]));
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	for (chain = 0; chain < APP_FILTER_CHAINS; chain++)
+	{
+		AppFilter_GetChain(chain, &st);
+		if (st.active == false)
+		{
+			SHELL_PRINTF("chain %u: off", chain);
+			continue;
+		}
+
+		SHELL_PRINTF("chain %u: id %u, %.1f -> %.1f Hz, %lu in, %lu out, %.1f cycles/sample, %u/%u floats",
+				chain, st.config.id, st.config.rate_mhz / 1000.0f, st.out_rate_mhz / 1000.0f, st.samples_in,
+				st.samples_out, st.samples_in ? (float) st.cycles / (float) st.samples_in : 0.0f, st.arena_used,
+				APP_FILTER_ARENA);
+
+		for (s = 0; s < st.config.num_stages; s++)
+		{
+			stage = &st.config.stages[s];
+			if ((stage->kind == APP_FILTER_LOWPASS) || (stage->kind == APP_FILTER_HIGHPASS))
+			{
+				SHELL_PRINTF("\t %s %.2f Hz, order %u", strKind[stage->kind], stage->param, stage->order);
+			}
+			else
+			{
+				SHELL_PRINTF("\t %s %g", strKind[stage->kind], stage->param);
+			}
+		}
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Baro_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppBaroStatus_t st;
+	uint32_t rate = APP_BARO_DEF_RATE_MHZ;
+	uint8_t wtm = APP_BARO_DEF_WATERMARK;
+	float us, secs;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "start", (const char *) argv[0]) == 0)
+		{
+			if (argc > 1)
+			{
+				rate = (uint32_t) (strtof((const char *) argv[1], NULL) * 1000.0f);
+			}
+			if (argc > 2)
+			{
+				wtm = (uint8_t) atoi((const char *) argv[2]);
+			}
+			return AppBaro_Start(rate, wtm);
+		}
+		else if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+		{
+			AppBaro_Stop();
+		}
+		else if (strcmp((const char *) "zero", (const char *) argv[0]) == 0)
+		{
+			return AppBaro_Zero();
+		}
+		else if ((strcmp((const char *) "qnh", (const char *) argv[0]) == 0) && (argc > 1))
+		{
+			return AppBaro_SetReference(strtof((const char *) argv[1], NULL));
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppBaro_GetStatus(&st);
+
+	us = 1.0e6f / (float) SystemCoreClock;
+	secs = st.elapsed_ms / 1000.0f;
+
+	SHELL_PRINTF("running %d, rate %.1f Hz, watermark %u, p0 %.2f hPa",
+			st.running, st.rate_mhz / 1000.0f, st.watermark, st.p0_hpa);
+	SHELL_PRINTF("pressure %.3f hPa, temp %.2f C, baro %.2f m, alt %.2f m, vz %.2f m/s, bias %.3f m/s2, accel %d",
+			st.pressure_hpa, st.temp_c, st.baro_m, st.alt_m, st.vz_ms, st.bias_ms2, st.accel);
+	SHELL_PRINTF("interrupts %lu, drains %lu, samples %lu (%.1f/drain), overruns %lu",
+			st.interrupts, st.drains, st.samples, st.drains ? (float) st.samples / (float) st.drains : 0.0f, st.overruns);
+	SHELL_PRINTF("cpu: bus %.1f us, filter %.1f us, max %.1f us per drain",
+			st.cycles_bus * us, st.cycles_calc * us, st.cycles_max * us);
+
+	if (secs > 0.0f)
+	{
+		SHELL_PRINTF("i2c %lu transfers, %lu bytes (%.1f transfers/s, %.0f B/s, %.2f%% of the bus)",
+				st.transfers, st.bytes, st.transfers / secs, st.bytes / secs,
+				100.0f * (float) st.bytes * APP_BARO_I2C_BITS_BYTE / (APP_BARO_I2C_HZ * secs));
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef TSync_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppTimeSyncStatus_t st;
+	TSyncEstimate_t chip;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			AppTimeSync_Reset();
+		}
+		else if (argc == 3)
+		{
+			/* Pedido do Tools/timesync: a resposta sai direto, sem o texto do shell */
+			return AppTimeSync_Request((uint32_t) strtoul((const char *) argv[0], NULL, 10),
+					(int64_t) strtoll((const char *) argv[1], NULL, 10),
+					(int64_t) strtoll((const char *) argv[2], NULL, 10));
+		}
+		else
+		{
+			return HAL_ERROR;
+		}
+
+		return HAL_OK;
+	}
+
+	AppTimeSync_GetStatus(&st);
+
+	SHELL_PRINTF("requests %lu (last %lu), exchanges %lu, rejected %lu",
+			st.requests, st.last_seq, st.exchanges, st.rejected);
+
+	if (st.est.valid == true)
+	{
+		SHELL_PRINTF("host: offset %.1f us, drift %.3f ppm, error %.1f us, min delay %.1f us, %u exchanges in the fit",
+				st.est.offset_us, st.est.drift * 1e6, st.est.error_us, st.est.delay_us, st.est.used);
+	}
+
+	LSM6DSL_FifoGetClock(&chip);
+	if (chip.valid == true)
+	{
+		SHELL_PRINTF("lsm6dsl: drift %.1f ppm, error %.1f us, min delay %.1f us",
+				chip.drift * 1e6, chip.error_us, chip.delay_us);
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Load_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	CpuLoadStats_t stats;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			CpuLoad_ResetPeak();
+			return HAL_OK;
+		}
+
+		return HAL_ERROR;
+	}
+
+	CpuLoad_Get(&stats);
+
+	SHELL_PRINTF("cpu load: %u.%u%% (1 s), %u.%u%% (10 s), %u.%u%% (60 s), peak %u.%u%% in %lu s",
+			stats.load_1s / 10, stats.load_1s % 10, stats.load_10s / 10, stats.load_10s % 10,
+			stats.load_60s / 10, stats.load_60s % 10, stats.peak / 10, stats.peak % 10, stats.intervals);
+	SHELL_PRINTF("idle sleeps: %lu in the last second", stats.sleeps);
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef LowPower_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	RtosLowPowerStats_t st;
+	uint32_t now_ua, ref_ua, ms;
+
+	if (argc > 0)
+	{
+		if (strcmp((const char *) "reset", (const char *) argv[0]) == 0)
+		{
+			RTOS_LowPowerResetStats();
+			return HAL_OK;
+		}
+
+		return HAL_ERROR;
+	}
+
+	RTOS_LowPowerGetStats(&st);
+	RTOS_LowPowerEstimate(&st, &now_ua, &ref_ua);
+
+	ms = (st.elapsed_ms > 0) ? st.elapsed_ms : 1;
+
+	SHELL_PRINTF("%lu ms: %.2f wakeups/s (%lu stop2, %lu sleep, %lu short), %.1f ticks/s suppressed",
+			st.elapsed_ms, st.wakeups * 1000.0f / ms, st.stops, st.sleeps, st.short_sleeps, st.suppressed * 1000.0f / ms);
+	SHELL_PRINTF("time: stop2 %.1f%%, sleep %.1f%%, run %.1f%%",
+			(st.elapsed_cycles > 0) ? (100.0f * st.stop_cycles / st.elapsed_cycles) : 0.0f,
+			(st.elapsed_cycles > 0) ? (100.0f * st.sleep_cycles / st.elapsed_cycles) : 0.0f,
+			(st.elapsed_cycles > 0) ? (100.0f * (st.elapsed_cycles - st.stop_cycles - st.sleep_cycles) / st.elapsed_cycles) : 0.0f);
+	SHELL_PRINTF("stop2 refused: lock %lu, console %lu, dma %lu, bus %lu; console wakes %lu",
+			st.blocked[RTOS_LP_BLOCK_LOCK], st.blocked[RTOS_LP_BLOCK_CONSOLE], st.blocked[RTOS_LP_BLOCK_DMA],
+			st.blocked[RTOS_LP_BLOCK_BUS], st.console_wakes);
+	SHELL_PRINTF("mcu estimate (datasheet typ.): %lu uA, %lu uA with 1 kHz tick and sleep idle, saved %ld uA",
+			now_ua, ref_ua, (long) ref_ua - (long) now_ua);
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef Top_CommandLine(uint16_t argc, uint8_t **argv)
+{
+	AppSysMonStats_t st;
+	uint32_t mhz = SystemCoreClock / 1000000UL;
+
+	if (argc == 0)
+	{
+		return AppSysMon_TopStart(0, 0);
+	}
+
+	if (strcmp((const char *) "stop", (const char *) argv[0]) == 0)
+	{
+		AppSysMon_TopStop();
+	}
+	else if ((strcmp((const char *) "tlm", (const char *) argv[0]) == 0) && (argc > 1))
+	{
+		AppSysMon_SetTlm(strcmp((const char *) "on", (const char *) argv[1]) == 0);
+	}
+	else if (strcmp((const char *) "info", (const char *) argv[0]) == 0)
+	{
+		AppSysMon_GetStats(&st);
+		SHELL_PRINTF("top %d, tlm %d, period %lu ms, %lu snapshots", st.top, st.tlm, st.period_ms, st.snapshots);
+		SHELL_PRINTF("snapshot: %lu us, max %lu us", st.cycles / mhz, st.cycles_max / mhz);
+		SHELL_PRINTF("tlm: %lu frames, %lu dropped", st.tlm_frames, st.tlm_dropped);
+	}
+	else
+	{
+		return AppSysMon_TopStart((uint32_t) atoi((const char *) argv[0]),
+				(argc > 1) ? (uint16_t) atoi((const char *) argv[1]) : 0);
+	}
+
+	return HAL_OK;
+}
+
 void Shell_Callback(uint8_t *cmd, uint16_t argc, uint8_t **argv)
 {
 	HAL_StatusTypeDef resp = HAL_ERROR;
@@ -173,10 +1233,78 @@ void Shell_Callback(uint8_t *cmd, uint16_t argc, uint8_t **argv)
 	{
 		resp = Sensors_CommandLine(argc, argv);
 	}
+	else if (strcmp((const char *) "sensor", (const char *) cmd) == 0)
+	{
+		resp = Sensor_CommandLine(argc, argv);
+	}
 	else if (strcmp((const char *) "led", (const char *) cmd) == 0)
 	{
 		resp = Leds_CommandLine(argc, argv);
 	}
+	else if (strcmp((const char *) "cache", (const char *) cmd) == 0)
+	{
+		resp = Cache_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "ahrs", (const char *) cmd) == 0)
+	{
+		resp = Ahrs_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "magcal", (const char *) cmd) == 0)
+	{
+		resp = MagCal_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "tlm", (const char *) cmd) == 0)
+	{
+		resp = Tlm_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "imuconv", (const char *) cmd) == 0)
+	{
+		resp = ImuConv_CommandLine();
+	}
+	else if (strcmp((const char *) "audio", (const char *) cmd) == 0)
+	{
+		resp = Audio_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "motion", (const char *) cmd) == 0)
+	{
+		resp = Motion_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "range", (const char *) cmd) == 0)
+	{
+		resp = Range_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "wstats", (const char *) cmd) == 0)
+	{
+		resp = WStats_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "vib", (const char *) cmd) == 0)
+	{
+		resp = Vib_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "filter", (const char *) cmd) == 0)
+	{
+		resp = Filter_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "baro", (const char *) cmd) == 0)
+	{
+		resp = Baro_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "tsync", (const char *) cmd) == 0)
+	{
+		resp = TSync_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "load", (const char *) cmd) == 0)
+	{
+		resp = Load_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "lowpower", (const char *) cmd) == 0)
+	{
+		resp = LowPower_CommandLine(argc, argv);
+	}
+	else if (strcmp((const char *) "top", (const char *) cmd) == 0)
+	{
+		resp = Top_CommandLine(argc, argv);
+	}
 	else if((strcmp((const char *) "consume", (const char *) cmd) == 0))
 	{
 		if (strcmp((const char *) "create", (const char *) argv[0]) == 0)
@@ -194,6 +1322,7 @@ void Shell_Callback(uint8_t *cmd, uint16_t argc, uint8_t **argv)
 			{
 				//delete task to consume some cpu
 				vTaskDelete( xHandleTaskCPU );
+				xHandleTaskCPU = NULL;
 			}
 		}
 	}
@@ -0,0 +1,346 @@
+/**
+ * @file    app_sysmon.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Monitor do sistema: carga da CPU e tasks no shell e na telemetria
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_sysmon.h"
+#include "app_telemetry.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define APP_SYSMON_TLM_SIGNALS		4
+
+/** @brief Acima das tasks da aplicacao: o top continua vivo com a CPU ocupada */
+#define APP_SYSMON_TASK_PRIORITY	5
+
+/** @brief Mesma pilha do shell: o top imprime pelo Debug_Printf (vsnprintf) */
+#define APP_SYSMON_TASK_STACK		(configMINIMAL_STACK_SIZE * 8)
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Permil = % com uma casa */
+static const TlmSignal_t sysmonSignals[APP_SYSMON_TLM_SIGNALS] =
+{
+	{ "cpu.load1", "%", 10 },
+	{ "cpu.load10", "%", 10 },
+	{ "cpu.load60", "%", 10 },
+	{ "cpu.peak", "%", 10 },
+};
+
+/** @brief Letras do vTaskList para cada eTaskState */
+static const char sysmonStateChar[] = { 'X', 'R', 'B', 'S', 'D' };
+
+/** @brief Foto e sampler: so a task do monitor usa */
+static RtosSnapshot_t sysmonSnap;
+static RtosSampler_t sysmonSampler;
+static uint8_t sysmonOrder[RTOS_SNAP_MAX_TASKS];
+static uint8_t sysmonFrame[TLM_MAX_FRAME];
+static uint16_t sysmonSeq = 0;
+
+/** @brief Telas restantes do top (0 = sem limite) */
+static uint16_t sysmonTopCount = 0;
+
+static AppSysMonStats_t sysmonStats;
+static TaskHandle_t sysmonTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Leitor dos sinais da telemetria.
+ * @param arg Indice em sysmonSignals.
+ * @param value Carga em permil.
+ * @return false ate o primeiro intervalo fechar.
+ */
+static bool AppSysMon_TlmRead(uint8_t arg, int32_t *value);
+
+static void AppSysMon_Task(void *param);
+
+/**
+ * Tira uma foto e calcula o uso no periodo.
+ * @return HAL_OK, HAL_ERROR se houver tasks demais para a foto.
+ */
+static HAL_StatusTypeDef AppSysMon_Sample(void);
+
+/** @brief Imprime a foto ordenada pelo uso da CPU. */
+static void AppSysMon_PrintTop(void);
+
+/** @brief Coloca a foto na fila da serial; descarta o que nao couber. */
+static void AppSysMon_SendTlm(void);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static bool AppSysMon_TlmRead(uint8_t arg, int32_t *value)
+{
+	CpuLoadStats_t stats;
+
+	CpuLoad_Get(&stats);
+
+	switch (arg)
+	{
+	case 0:
+		*value = stats.load_1s;
+		break;
+
+	case 1:
+		*value = stats.load_10s;
+		break;
+
+	case 2:
+		*value = stats.load_60s;
+		break;
+
+	default:
+		*value = stats.peak;
+		break;
+	}
+
+	return (stats.intervals > 0);
+}
+
+static HAL_StatusTypeDef AppSysMon_Sample(void)
+{
+	uint32_t start, cycles;
+
+	start = Timebase_Cycles32();
+
+	if (RTOS_Snapshot(&sysmonSnap) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+	RTOS_SamplerUpdate(&sysmonSampler, &sysmonSnap);
+
+	cycles = Timebase_Cycles32() - start;
+
+	taskENTER_CRITICAL();
+	sysmonStats.snapshots++;
+	sysmonStats.cycles = cycles;
+	sysmonStats.cycles_max = (cycles > sysmonStats.cycles_max) ? cycles : sysmonStats.cycles_max;
+	taskEXIT_CRITICAL();
+
+	return HAL_OK;
+}
+
+static void AppSysMon_PrintTop(void)
+{
+	const RtosTaskInfo_t *task;
+	CpuLoadStats_t load;
+	uint32_t window_ms, us;
+	uint8_t i, k, idx;
+
+	/* Insercao: poucas tasks, ordem decrescente de uso */
+	for (i = 0; i < sysmonSnap.count; i++)
+	{
+		idx = i;
+		for (k = i; (k > 0) && (sysmonSnap.tasks[sysmonOrder[k - 1]].cpu < sysmonSnap.tasks[idx].cpu); k--)
+		{
+			sysmonOrder[k] = sysmonOrder[k - 1];
+		}
+		sysmonOrder[k] = idx;
+	}
+
+	CpuLoad_Get(&load);
+	window_ms = (uint32_t) (((uint64_t) sysmonSnap.interval << TIMEBASE_RUNTIME_SHIFT) / (SystemCoreClock / 1000UL));
+	us = sysmonStats.cycles / (SystemCoreClock / 1000000UL);
+
+	/* Limpa a tela como o top */
+	SHELL_PRINTF("\033[2J\033[Htop: %lu ms, cpu %u.%u%%, heap %lu free, %lu min of %u, %u tasks, sample %lu us",
+			window_ms, load.load_1s / 10, load.load_1s % 10, sysmonSnap.heap_free, sysmonSnap.heap_min,
+			configTOTAL_HEAP_SIZE, sysmonSnap.count, us);
+	SHELL_PRINTF("%4s %-*s %2s %3s %6s %5s", "num", configMAX_TASK_NAME_LEN - 1, "task", "st", "pri", "cpu%", "stack");
+
+	for (i = 0; i < sysmonSnap.count; i++)
+	{
+		task = &sysmonSnap.tasks[sysmonOrder[i]];
+		SHELL_PRINTF("%4u %-*s %2c %3u %4u.%u %5u", task->number, configMAX_TASK_NAME_LEN - 1, task->name,
+				(task->state < sizeof(sysmonStateChar)) ? sysmonStateChar[task->state] : '?',
+				task->priority, task->cpu / 10, task->cpu % 10, task->stack_free);
+	}
+}
+
+static void AppSysMon_SendTlm(void)
+{
+	const RtosTaskInfo_t *info;
+	CpuLoadStats_t load;
+	TlmSystem_t sys;
+	TlmTask_t task;
+	uint32_t sent = 0, dropped = 0;
+	uint16_t len;
+	uint8_t i;
+
+	CpuLoad_Get(&load);
+
+	/* Timestamp no relogio que o app_timesync sincroniza com o PC */
+	sys.timestamp = (uint32_t) (Timebase_Us() / 1000ULL);
+	sys.heap_free = sysmonSnap.heap_free;
+	sys.heap_min = sysmonSnap.heap_min;
+	sys.load = load.load_1s;
+	sys.tasks = sysmonSnap.count;
+
+	len = Tlm_EncodeSystem(sysmonSeq, &sys, sysmonFrame);
+	if (Debug_Write(sysmonFrame, len, 0) == HAL_OK)
+	{
+		sent++;
+
+		for (i = 0; i < sysmonSnap.count; i++)
+		{
+			info = &sysmonSnap.tasks[i];
+			task.name = info->name;
+			task.number = info->number;
+			task.cpu = info->cpu;
+			task.stack_free = info->stack_free;
+			task.index = i;
+			task.state = info->state;
+			task.priority = info->priority;
+
+			len = Tlm_EncodeTask(sysmonSeq, &task, sysmonFrame);
+			if ((len > 0) && (Debug_Write(sysmonFrame, len, 0) == HAL_OK))
+			{
+				sent++;
+			}
+			else
+			{
+				dropped++;
+			}
+		}
+	}
+	else
+	{
+		/* Sem o SYSTEM o receptor descartaria as tasks da foto */
+		dropped += 1 + sysmonSnap.count;
+	}
+
+	sysmonSeq++;
+
+	taskENTER_CRITICAL();
+	sysmonStats.tlm_frames += sent;
+	sysmonStats.tlm_dropped += dropped;
+	taskEXIT_CRITICAL();
+}
+
+static void AppSysMon_Task(void *param)
+{
+	TickType_t last_wake = 0;
+
+	for (;;)
+	{
+		if ((sysmonStats.top == false) && (sysmonStats.tlm == false))
+		{
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			last_wake = xTaskGetTickCount();
+
+			/* Referencia do primeiro periodo; sem ela seria o uso desde o boot */
+			RTOS_SamplerInit(&sysmonSampler);
+			AppSysMon_Sample();
+			continue;
+		}
+
+		vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(sysmonStats.period_ms));
+
+		if (AppSysMon_Sample() != HAL_OK)
+		{
+			continue;
+		}
+
+		if (sysmonStats.top == true)
+		{
+			AppSysMon_PrintTop();
+
+			taskENTER_CRITICAL();
+			if ((sysmonTopCount > 0) && (--sysmonTopCount == 0))
+			{
+				sysmonStats.top = false;
+			}
+			taskEXIT_CRITICAL();
+		}
+
+		if (sysmonStats.tlm == true)
+		{
+			AppSysMon_SendTlm();
+		}
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppSysMon_Init(void)
+{
+	BaseType_t xReturned;
+	uint8_t i;
+
+	CpuLoad_Init();
+
+	for (i = 0; i < APP_SYSMON_TLM_SIGNALS; i++)
+	{
+		AppTelemetry_AddSignal(&sysmonSignals[i], AppSysMon_TlmRead, i);
+	}
+
+	memset(&sysmonStats, 0, sizeof(sysmonStats));
+	sysmonStats.period_ms = APP_SYSMON_DEFAULT_PERIOD_MS;
+	RTOS_SamplerInit(&sysmonSampler);
+
+	xReturned = xTaskCreate(AppSysMon_Task, "tkSysMon", APP_SYSMON_TASK_STACK, NULL, APP_SYSMON_TASK_PRIORITY, &sysmonTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppSysMon_TopStart(uint32_t period_ms, uint16_t count)
+{
+	if ((period_ms > 0) && (pdMS_TO_TICKS(period_ms) == 0))
+	{
+		return HAL_ERROR;
+	}
+
+	taskENTER_CRITICAL();
+	if (period_ms > 0)
+	{
+		sysmonStats.period_ms = period_ms;
+	}
+	sysmonTopCount = count;
+	sysmonStats.top = true;
+	taskEXIT_CRITICAL();
+
+	xTaskNotifyGive(sysmonTask);
+
+	return HAL_OK;
+}
+
+void AppSysMon_TopStop(void)
+{
+	sysmonStats.top = false;
+}
+
+void AppSysMon_SetTlm(bool enable)
+{
+	sysmonStats.tlm = enable;
+
+	if (enable == true)
+	{
+		xTaskNotifyGive(sysmonTask);
+	}
+}
+
+void AppSysMon_GetStats(AppSysMonStats_t *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = sysmonStats;
+	taskEXIT_CRITICAL();
+}
@@ -0,0 +1,96 @@
+/**
+ * @file    app_sysmon.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Monitor do sistema: carga da CPU e tasks no shell e na telemetria
+ * @details
+ * A carga vem do tempo que a task idle passa em WFI (cpuload/cpuload.h).
+ * A telemetria ganha os sinais cpu.load1, cpu.load10, cpu.load60 e
+ * cpu.peak, em % com uma casa (escala 10), lidos da ultima media fechada.
+ *
+ * A task do monitor so acorda com o top ou a foto na telemetria ligados. A
+ * cada periodo tira uma foto das tasks (RTOS_Snapshot) e calcula o uso da
+ * CPU de cada uma no periodo (RTOS_SamplerUpdate). O top imprime a foto
+ * ordenada pelo uso; a telemetria envia a mesma foto em quadros SYSTEM e
+ * TASK (telemetry/telemetry.h) sem esperar pela fila da serial.
+ */
+
+#ifndef _APP_SYSMON_H_
+#define _APP_SYSMON_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "cpuload/cpuload.h"
+#include "freertos_utils/freertos_utils.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Periodo padrao das fotos */
+#define APP_SYSMON_DEFAULT_PERIOD_MS	2000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado e contadores das fotos */
+typedef struct
+{
+	bool top;                   /**< Top imprimindo */
+	bool tlm;                   /**< Fotos na telemetria */
+	uint32_t period_ms;
+	uint32_t snapshots;         /**< Fotos tiradas */
+	uint32_t cycles;            /**< Ciclos da ultima foto com o sampler */
+	uint32_t cycles_max;
+	uint32_t tlm_frames;        /**< Quadros SYSTEM e TASK enviados */
+	uint32_t tlm_dropped;       /**< Quadros descartados com a fila cheia */
+} AppSysMonStats_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Inicia o medidor de carga, registra os sinais (depois do AppTelemetry_TaskInit) e cria a task (parada). */
+void AppSysMon_Init(void);
+
+/**
+ * Liga o top: uma tela por periodo com o uso de cada task no periodo.
+ * @param period_ms Periodo (0 = mantem o atual).
+ * @param count Telas antes de parar sozinho (0 = ate o AppSysMon_TopStop).
+ * @return HAL_OK, HAL_ERROR se o periodo for menor que um tick.
+ */
+HAL_StatusTypeDef AppSysMon_TopStart(uint32_t period_ms, uint16_t count);
+
+/** @brief Para o top. */
+void AppSysMon_TopStop(void);
+
+/**
+ * Liga ou desliga o envio das fotos na telemetria, no periodo do monitor.
+ * @param enable true para enviar.
+ */
+void AppSysMon_SetTlm(bool enable);
+
+/**
+ * Copia o estado e os contadores.
+ * @param stats Destino.
+ */
+void AppSysMon_GetStats(AppSysMonStats_t *stats);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_SYSMON_H_ */
@@ -0,0 +1,493 @@
+/**
+ * @file    app_telemetry.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Envio periodico dos sensores em quadros binarios pela serial
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_telemetry.h"
+#include "sensor_cache.h"
+#include "timebase/timebase.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Abaixo do shell: texto interativo tem preferencia sobre o fluxo */
+#define APP_TLM_TASK_PRIORITY			2
+
+/** @brief Tamanho do nome "CHIP.canal.eixo" */
+#define APP_TLM_NAME_SIZE				24
+
+/** @brief Reenvio do esquema para um receptor que conectou no meio do fluxo */
+#define APP_TLM_SCHEMA_PERIOD_MS		5000
+
+/** @brief Espera por espaco na fila para cada quadro de esquema (ticks) */
+#define APP_TLM_SCHEMA_TIMEOUT			10
+
+/** @brief Taxa maxima: um quadro por tick */
+#define APP_TLM_MAX_RATE_MHZ			(configTICK_RATE_HZ * 1000UL)
+
+#define APP_TLM_MUTEX_TIMEOUT			1000
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Origem de um sinal: registro de drivers ou funcao de leitura */
+typedef struct
+{
+	uint8_t id;
+	uint8_t axis;                   /**< Eixo, ou argumento de reader */
+	AppTelemetryReader_t reader;    /**< NULL para sinais do registro */
+} AppTlmSource_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static TlmSignal_t tlmSignals[TLM_MAX_SIGNALS];
+static AppTlmSource_t tlmSources[TLM_MAX_SIGNALS];
+static char tlmNames[TLM_MAX_SIGNALS][APP_TLM_NAME_SIZE];
+static uint8_t tlmNumSignals = 0;
+
+/** @brief Sinais selecionados, na ordem dos bits da mascara */
+static TlmSignal_t tlmSelected[TLM_MAX_SIGNALS];
+static uint8_t tlmSelectedIndex[TLM_MAX_SIGNALS];
+static uint8_t tlmNumSelected = 0;
+
+static TlmEncoder_t tlmEncoder;
+static uint8_t tlmSchema = 0;
+static bool tlmSchemaPending = false;
+
+/** @brief Assinatura de cada canal, mais 1 (0 = nenhuma) */
+static uint8_t tlmSubs[SENSOR_DRV_MAX_CHANNELS];
+
+static uint8_t tlmFrame[TLM_MAX_FRAME];
+
+static AppTelemetryStats_t tlmStats;
+static TickType_t tlmStart = 0;
+
+static SemaphoreHandle_t mutex_tlm = NULL;
+static TaskHandle_t tlmTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppTelemetry_Task(void *param);
+
+/**
+ * Monta a lista de sinais selecionados e inicia um novo esquema.
+ * @param mask Sinais selecionados.
+ */
+static void AppTelemetry_Select(uint32_t mask);
+
+/**
+ * Libera as assinaturas e, se pedido, assina os canais selecionados.
+ * @param enable true para assinar na taxa atual.
+ */
+static void AppTelemetry_Subscribe(bool enable);
+
+/** @brief Envia um quadro de esquema por sinal selecionado. */
+static void AppTelemetry_SendSchema(void);
+
+/** @brief Le os sinais selecionados e coloca um quadro na fila. */
+static void AppTelemetry_Sample(void);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void AppTelemetry_Select(uint32_t mask)
+{
+	uint8_t i;
+
+	tlmNumSelected = 0;
+	for (i = 0; i < tlmNumSignals; i++)
+	{
+		if (mask & (1UL << i))
+		{
+			tlmSelected[tlmNumSelected] = tlmSignals[i];
+			tlmSelectedIndex[tlmNumSelected] = i;
+			tlmNumSelected++;
+		}
+	}
+
+	tlmStats.mask = mask;
+	tlmSchema = (tlmSchema + 1) & 0x0F;
+	Tlm_Init(&tlmEncoder, tlmSelected, tlmNumSelected, tlmSchema);
+	tlmSchemaPending = true;
+}
+
+static void AppTelemetry_Subscribe(bool enable)
+{
+	uint8_t i, id, handle;
+
+	for (id = 0; id < SENSOR_DRV_MAX_CHANNELS; id++)
+	{
+		if (tlmSubs[id] != 0)
+		{
+			SensorDrv_Unsubscribe(tlmSubs[id] - 1);
+			tlmSubs[id] = 0;
+		}
+	}
+
+	if (enable == false)
+	{
+		return;
+	}
+
+	/* Telemetria aceita o modo de baixo consumo dos sensores */
+	for (i = 0; i < tlmNumSelected; i++)
+	{
+		if (tlmSources[tlmSelectedIndex[i]].reader != NULL)
+		{
+			continue;
+		}
+
+		id = tlmSources[tlmSelectedIndex[i]].id;
+		if (tlmSubs[id] == 0)
+		{
+			handle = SensorDrv_Subscribe(id, tlmStats.rate_mhz, SENSOR_POWER_LOW);
+			if (handle != SENSOR_DRV_INVALID)
+			{
+				tlmSubs[id] = handle + 1;
+			}
+		}
+	}
+}
+
+static void AppTelemetry_SendSchema(void)
+{
+	uint16_t len;
+	uint8_t i;
+
+	for (i = 0; i < tlmNumSelected; i++)
+	{
+		len = Tlm_EncodeSchema(&tlmEncoder, i, tlmFrame);
+		if (len > 0)
+		{
+			Debug_Write(tlmFrame, len, APP_TLM_SCHEMA_TIMEOUT);
+		}
+	}
+}
+
+static void AppTelemetry_Sample(void)
+{
+	const AppTlmSource_t *src;
+	int32_t values[TLM_MAX_SIGNALS];
+	int32_t sample[SENSOR_DRV_MAX_AXES];
+	uint8_t last_id = SENSOR_DRV_INVALID;
+	bool ok = false;
+	uint32_t timestamp_ms;
+	int32_t value;
+	uint16_t len;
+	uint8_t i;
+
+	/* Timestamp no relogio que o app_timesync sincroniza com o PC */
+	timestamp_ms = (uint32_t) (Timebase_Us() / 1000ULL);
+
+	/* Sinais do mesmo canal sao vizinhos: uma leitura do cache por canal */
+	for (i = 0; i < tlmNumSelected; i++)
+	{
+		src = &tlmSources[tlmSelectedIndex[i]];
+
+		if (src->reader != NULL)
+		{
+			values[i] = src->reader(src->axis, &value) ? value : tlmEncoder.prev[i];
+			continue;
+		}
+
+		if (src->id != last_id)
+		{
+			last_id = src->id;
+			ok = (SensorCache_Read(src->id, sample, false) == HAL_OK);
+		}
+
+		/* Falha de leitura repete o ultimo valor enviado */
+		values[i] = ok ? sample[src->axis] : tlmEncoder.prev[i];
+	}
+
+	len = Tlm_EncodeSample(&tlmEncoder, timestamp_ms, values, tlmFrame);
+
+	if (Debug_Write(tlmFrame, len, 0) == HAL_OK)
+	{
+		tlmStats.frames++;
+		tlmStats.bytes += len;
+		if ((tlmFrame[2] & 0x0F) == TLM_FRAME_FULL)
+		{
+			tlmStats.full++;
+		}
+	}
+	else
+	{
+		/* O receptor perdeu a referencia dos DELTA */
+		tlmStats.dropped++;
+		Tlm_ForceKey(&tlmEncoder);
+	}
+}
+
+static void AppTelemetry_Task(void *param)
+{
+	TickType_t last_wake = 0;
+	TickType_t last_schema = 0;
+	TickType_t period;
+
+	for (;;)
+	{
+		if (tlmStats.running == false)
+		{
+			ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+			last_wake = xTaskGetTickCount();
+			continue;
+		}
+
+		period = pdMS_TO_TICKS(1000000UL / tlmStats.rate_mhz);
+		if (period == 0)
+		{
+			period = 1;
+		}
+
+		vTaskDelayUntil(&last_wake, period);
+
+		if (xSemaphoreTake(mutex_tlm, APP_TLM_MUTEX_TIMEOUT) != pdTRUE)
+		{
+			continue;
+		}
+
+		if (tlmStats.running == true)
+		{
+			if ((tlmSchemaPending == true) ||
+					((TickType_t) (xTaskGetTickCount() - last_schema) >= pdMS_TO_TICKS(APP_TLM_SCHEMA_PERIOD_MS)))
+			{
+				AppTelemetry_SendSchema();
+				tlmSchemaPending = false;
+				last_schema = xTaskGetTickCount();
+			}
+
+			AppTelemetry_Sample();
+		}
+
+		xSemaphoreGive(mutex_tlm);
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppTelemetry_TaskInit(void)
+{
+	const SensorChannelDesc_t *desc;
+	BaseType_t xReturned;
+	uint8_t id, axis;
+
+	memset(&tlmStats, 0, sizeof(tlmStats));
+	memset(tlmSubs, 0, sizeof(tlmSubs));
+	tlmNumSignals = 0;
+
+	/* Um sinal por eixo de cada canal registrado */
+	for (id = 0; id < SensorDrv_GetNumChannels(); id++)
+	{
+		desc = SensorDrv_GetDesc(id);
+
+		for (axis = 0; (axis < desc->axes) && (tlmNumSignals < TLM_MAX_SIGNALS); axis++)
+		{
+			if (desc->axes == 1)
+			{
+				snprintf(tlmNames[tlmNumSignals], APP_TLM_NAME_SIZE, "%s.%s", SensorDrv_GetOwner(id)->name, desc->name);
+			}
+			else
+			{
+				snprintf(tlmNames[tlmNumSignals], APP_TLM_NAME_SIZE, "%s.%s.%c", SensorDrv_GetOwner(id)->name, desc->name, 'x' + axis);
+			}
+
+			tlmSignals[tlmNumSignals].name = tlmNames[tlmNumSignals];
+			tlmSignals[tlmNumSignals].unit = desc->unit;
+			tlmSignals[tlmNumSignals].scale = desc->scale;
+			tlmSources[tlmNumSignals].id = id;
+			tlmSources[tlmNumSignals].axis = axis;
+			tlmSources[tlmNumSignals].reader = NULL;
+			tlmNumSignals++;
+		}
+	}
+
+	/* Padrao: todos os sinais, com DELTA */
+	tlmStats.delta = true;
+	Tlm_SetDelta(&tlmEncoder, true, TLM_DEFAULT_KEY_INTERVAL);
+	AppTelemetry_Select((tlmNumSignals >= 32) ? 0xFFFFFFFFUL : ((1UL << tlmNumSignals) - 1));
+
+	if (mutex_tlm == NULL)
+	{
+		mutex_tlm = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_tlm);
+		vQueueAddToRegistry(mutex_tlm, "telemetry");
+	}
+
+	xReturned = xTaskCreate(AppTelemetry_Task, "tkTlm", configMINIMAL_STACK_SIZE * 2, NULL, APP_TLM_TASK_PRIORITY, &tlmTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppTelemetry_Start(uint32_t rate_mhz)
+{
+	if ((rate_mhz == 0) || (rate_mhz > APP_TLM_MAX_RATE_MHZ) || (tlmNumSelected == 0))
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_tlm, APP_TLM_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	tlmStats.rate_mhz = rate_mhz;
+	tlmStats.running = true;
+	tlmSchemaPending = true;
+	tlmStart = xTaskGetTickCount();
+	Tlm_ForceKey(&tlmEncoder);
+	AppTelemetry_Subscribe(true);
+
+	xSemaphoreGive(mutex_tlm);
+
+	xTaskNotifyGive(tlmTask);
+
+	return HAL_OK;
+}
+
+void AppTelemetry_Stop(void)
+{
+	xSemaphoreTake(mutex_tlm, portMAX_DELAY);
+
+	if (tlmStats.running == true)
+	{
+		tlmStats.running = false;
+		tlmStats.elapsed_ms = (xTaskGetTickCount() - tlmStart) * portTICK_PERIOD_MS;
+		AppTelemetry_Subscribe(false);
+	}
+
+	xSemaphoreGive(mutex_tlm);
+}
+
+HAL_StatusTypeDef AppTelemetry_SetMask(uint32_t mask)
+{
+	if (tlmNumSignals < 32)
+	{
+		mask &= (1UL << tlmNumSignals) - 1;
+	}
+
+	if (mask == 0)
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_tlm, APP_TLM_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	AppTelemetry_Select(mask);
+	AppTelemetry_Subscribe(tlmStats.running);
+
+	xSemaphoreGive(mutex_tlm);
+
+	return HAL_OK;
+}
+
+void AppTelemetry_SetDelta(bool delta)
+{
+	xSemaphoreTake(mutex_tlm, portMAX_DELAY);
+	tlmStats.delta = delta;
+	Tlm_SetDelta(&tlmEncoder, delta, TLM_DEFAULT_KEY_INTERVAL);
+	xSemaphoreGive(mutex_tlm);
+}
+
+uint8_t AppTelemetry_AddSignal(const TlmSignal_t *signal, AppTelemetryReader_t reader, uint8_t arg)
+{
+	uint8_t index;
+
+	if ((reader == NULL) || (tlmNumSignals >= TLM_MAX_SIGNALS))
+	{
+		return TLM_MAX_SIGNALS;
+	}
+
+	xSemaphoreTake(mutex_tlm, portMAX_DELAY);
+
+	index = tlmNumSignals;
+	tlmSignals[index] = *signal;
+	tlmSources[index].id = SENSOR_DRV_INVALID;
+	tlmSources[index].axis = arg;
+	tlmSources[index].reader = reader;
+	tlmNumSignals++;
+
+	xSemaphoreGive(mutex_tlm);
+
+	return index;
+}
+
+HAL_StatusTypeDef AppTelemetry_UpdateSignal(uint8_t index, const TlmSignal_t *signal)
+{
+	if (index >= tlmNumSignals)
+	{
+		return HAL_ERROR;
+	}
+
+	xSemaphoreTake(mutex_tlm, portMAX_DELAY);
+
+	tlmSignals[index] = *signal;
+
+	/* O receptor so aceita os dados com o esquema novo */
+	if (tlmStats.mask & (1UL << index))
+	{
+		AppTelemetry_Select(tlmStats.mask);
+	}
+
+	xSemaphoreGive(mutex_tlm);
+
+	return HAL_OK;
+}
+
+uint8_t AppTelemetry_GetNumSignals(void)
+{
+	return tlmNumSignals;
+}
+
+const TlmSignal_t *AppTelemetry_GetSignal(uint8_t index)
+{
+	return (index < tlmNumSignals) ? &tlmSignals[index] : NULL;
+}
+
+void AppTelemetry_GetStats(AppTelemetryStats_t *stats)
+{
+	xSemaphoreTake(mutex_tlm, portMAX_DELAY);
+
+	*stats = tlmStats;
+	if (tlmStats.running == true)
+	{
+		stats->elapsed_ms = (xTaskGetTickCount() - tlmStart) * portTICK_PERIOD_MS;
+	}
+
+	xSemaphoreGive(mutex_tlm);
+}
+
+void AppTelemetry_ResetStats(void)
+{
+	xSemaphoreTake(mutex_tlm, portMAX_DELAY);
+
+	tlmStats.frames = 0;
+	tlmStats.full = 0;
+	tlmStats.bytes = 0;
+	tlmStats.dropped = 0;
+	tlmStats.elapsed_ms = 0;
+	tlmStart = xTaskGetTickCount();
+
+	xSemaphoreGive(mutex_tlm);
+}
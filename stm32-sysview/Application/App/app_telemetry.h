@@ -0,0 +1,134 @@
+/**
+ * @file    app_telemetry.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Envio periodico dos sensores em quadros binarios pela serial
+ * @details
+ * Cada eixo de cada canal do registro de drivers vira um sinal
+ * ("LSM6DSL.gyro.x"). Os sinais selecionados pela mascara sao lidos pelo
+ * cache na taxa pedida, codificados por Libs/telemetry e colocados na fila
+ * de transmissao da serial sem bloquear: se a fila estiver cheia o quadro e
+ * descartado e o proximo sai completo (FULL). O texto do shell pode dividir
+ * a serial com o fluxo; o decodificador do PC ignora o que nao for quadro.
+ *
+ * Outros modulos podem acrescentar sinais calculados (AppTelemetry_AddSignal),
+ * lidos por uma funcao propria em vez do cache.
+ */
+
+#ifndef _APP_TELEMETRY_H_
+#define _APP_TELEMETRY_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "telemetry/telemetry.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/**
+ * @brief Leitura de um sinal acrescentado por outro modulo.
+ * @param arg Valor passado em AppTelemetry_AddSignal.
+ * @param value Saida.
+ * @return false se nao ha valor; o quadro repete o ultimo enviado.
+ */
+typedef bool (*AppTelemetryReader_t)(uint8_t arg, int32_t *value);
+
+/** @brief Estado e contadores do fluxo */
+typedef struct
+{
+	bool running;
+	bool delta;
+	uint32_t rate_mhz;      /**< Taxa de quadros pedida */
+	uint32_t mask;          /**< Sinais selecionados */
+	uint32_t frames;        /**< Quadros de dados enviados */
+	uint32_t full;          /**< Quadros FULL entre os enviados */
+	uint32_t bytes;         /**< Bytes de dados enviados (sem esquema) */
+	uint32_t dropped;       /**< Quadros descartados com a fila cheia */
+	uint32_t elapsed_ms;    /**< Tempo desde o start */
+} AppTelemetryStats_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Monta a lista de sinais a partir do registro e cria a task (parada). */
+void AppTelemetry_TaskInit(void);
+
+/**
+ * Inicia o fluxo. Os canais dos sinais selecionados sao assinados na taxa
+ * dos quadros.
+ * @param rate_mhz Quadros por segundo em mHz (ate 1 kHz).
+ * @return HAL_OK, HAL_ERROR se a taxa for invalida.
+ */
+HAL_StatusTypeDef AppTelemetry_Start(uint32_t rate_mhz);
+
+/** @brief Para o fluxo e libera as assinaturas. */
+void AppTelemetry_Stop(void);
+
+/**
+ * Seleciona os sinais enviados; gera um novo esquema.
+ * @param mask Bit n seleciona o sinal n.
+ * @return HAL_OK, HAL_ERROR se nenhum sinal existente foi selecionado.
+ */
+HAL_StatusTypeDef AppTelemetry_SetMask(uint32_t mask);
+
+/**
+ * Liga ou desliga os quadros DELTA.
+ * @param delta true para enviar diferencas entre quadros FULL.
+ */
+void AppTelemetry_SetDelta(bool delta);
+
+/**
+ * Acrescenta um sinal calculado ao fim da lista (nao selecionado). Deve ser
+ * chamada depois de AppTelemetry_TaskInit.
+ * @param signal Descricao; nome e unidade devem continuar validos.
+ * @param reader Funcao de leitura, chamada pela task de telemetria.
+ * @param arg Repassado a reader.
+ * @return Indice do sinal ou TLM_MAX_SIGNALS se a lista estiver cheia.
+ */
+uint8_t AppTelemetry_AddSignal(const TlmSignal_t *signal, AppTelemetryReader_t reader, uint8_t arg);
+
+/**
+ * Troca a descricao de um sinal; se ele estiver selecionado sai um novo esquema.
+ * @param index Indice do sinal.
+ * @param signal Nova descricao.
+ * @return HAL_OK, HAL_ERROR se o sinal nao existe.
+ */
+HAL_StatusTypeDef AppTelemetry_UpdateSignal(uint8_t index, const TlmSignal_t *signal);
+
+/** @brief Quantidade de sinais disponiveis. */
+uint8_t AppTelemetry_GetNumSignals(void);
+
+/**
+ * @param index Indice do sinal.
+ * @return Descricao do sinal ou NULL.
+ */
+const TlmSignal_t *AppTelemetry_GetSignal(uint8_t index);
+
+/**
+ * Copia o estado e os contadores.
+ * @param stats Saida.
+ */
+void AppTelemetry_GetStats(AppTelemetryStats_t *stats);
+
+/** @brief Zera os contadores. */
+void AppTelemetry_ResetStats(void);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_TELEMETRY_H_ */
@@ -0,0 +1,203 @@
+/**
+ * @file    app_timesync.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Sincronizacao do relogio da placa com o do PC pela serial de debug
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_timesync.h"
+#include "setup_debug.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Maior resposta: "tsync" e tres numeros de ate 20 digitos */
+#define APP_TSYNC_LINE_SIZE			80
+
+/** @brief Espera por espaco na fila de transmissao */
+#define APP_TSYNC_TX_TIMEOUT		100
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Troca aguardando o t4 do PC */
+typedef struct
+{
+	bool valid;
+	uint32_t seq;
+	int64_t t1;             /**< PC */
+	uint64_t t2;            /**< Placa */
+	uint64_t t3;            /**< Placa: inicio estimado da resposta */
+	uint16_t req_bytes;
+	uint16_t rep_bytes;
+} AppTimeSyncPending_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Estimador: so a task do shell altera */
+static TSync_t tsHost;
+
+static AppTimeSyncPending_t tsPending;
+
+/** @brief Copia do estado lida pelas outras tasks */
+static AppTimeSyncStatus_t tsStatus;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Escreve um inteiro de 64 bits em decimal (o printf da newlib-nano nao
+ * tem %llu).
+ * @param out Destino com pelo menos 21 bytes.
+ * @param value Valor.
+ * @return Caracteres escritos, sem o terminador.
+ */
+static int AppTimeSync_FormatU64(char *out, uint64_t value);
+
+/** @brief Publica a reta e os contadores em tsStatus. */
+static void AppTimeSync_Publish(void);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static int AppTimeSync_FormatU64(char *out, uint64_t value)
+{
+	char tmp[20];
+	int n = 0, i;
+
+	do
+	{
+		tmp[n++] = (char) ('0' + (value % 10));
+		value /= 10;
+	} while (value != 0);
+
+	for (i = 0; i < n; i++)
+	{
+		out[i] = tmp[n - 1 - i];
+	}
+	out[n] = '\0';
+
+	return n;
+}
+
+static void AppTimeSync_Publish(void)
+{
+	taskENTER_CRITICAL();
+	tsStatus.est = tsHost.est;
+	tsStatus.exchanges = tsHost.exchanges;
+	tsStatus.rejected = tsHost.rejected;
+	taskEXIT_CRITICAL();
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppTimeSync_Init(uint32_t baud)
+{
+	TSync_Init(&tsHost, baud);
+	memset(&tsPending, 0, sizeof(tsPending));
+	memset(&tsStatus, 0, sizeof(tsStatus));
+}
+
+HAL_StatusTypeDef AppTimeSync_Request(uint32_t seq, int64_t t1, int64_t t4)
+{
+	char line[APP_TSYNC_LINE_SIZE];
+	uint64_t t2, t3 = 0, start = 0;
+	uint16_t req;
+	HAL_StatusTypeDef status;
+	int len;
+
+	/* O terminador deste pedido foi a ultima linha recebida */
+	Debug_GetRxLine(&t2, &req);
+
+	/* O PC mandou o t4 da troca anterior: ela esta completa */
+	if ((tsPending.valid == true) && (tsPending.seq == (seq - 1)))
+	{
+		t3 = tsPending.t3;
+
+		if (t4 != 0)
+		{
+			TSync_Add(&tsHost, tsPending.t1, (int64_t) tsPending.t2, (int64_t) tsPending.t3, t4,
+					tsPending.req_bytes, tsPending.rep_bytes);
+			AppTimeSync_Publish();
+		}
+	}
+
+	len = snprintf(line, sizeof(line), "tsync %lu ", (unsigned long) seq);
+	len += AppTimeSync_FormatU64(&line[len], t2);
+	line[len++] = ' ';
+	len += AppTimeSync_FormatU64(&line[len], t3);
+	line[len++] = '\r';
+	line[len++] = '\n';
+
+	status = Debug_WriteStamp((const uint8_t *) line, (uint16_t) len, APP_TSYNC_TX_TIMEOUT, &start);
+
+	tsPending.valid = (status == HAL_OK);
+	tsPending.seq = seq;
+	tsPending.t1 = t1;
+	tsPending.t2 = t2;
+	tsPending.t3 = start;
+	tsPending.req_bytes = req;
+	tsPending.rep_bytes = (uint16_t) len;
+
+	taskENTER_CRITICAL();
+	tsStatus.requests++;
+	tsStatus.last_seq = seq;
+	tsStatus.last_tick = xTaskGetTickCount();
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+bool AppTimeSync_ToHost(uint64_t board_us, int64_t *host_us, uint32_t *error_us)
+{
+	TSyncEstimate_t est;
+
+	taskENTER_CRITICAL();
+	est = tsStatus.est;
+	taskEXIT_CRITICAL();
+
+	if (est.valid == false)
+	{
+		return false;
+	}
+
+	*host_us = TSync_DevToRef(&est, (int64_t) board_us);
+	if (error_us != NULL)
+	{
+		*error_us = (uint32_t) (est.error_us + 0.5);
+	}
+
+	return true;
+}
+
+void AppTimeSync_GetStatus(AppTimeSyncStatus_t *status)
+{
+	taskENTER_CRITICAL();
+	*status = tsStatus;
+	taskEXIT_CRITICAL();
+}
+
+void AppTimeSync_Reset(void)
+{
+	uint32_t baud = tsHost.baud;
+
+	tsPending.valid = false;
+	TSync_Init(&tsHost, baud);
+	AppTimeSync_Publish();
+}
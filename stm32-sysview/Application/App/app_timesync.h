@@ -0,0 +1,101 @@
+/**
+ * @file    app_timesync.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Sincronizacao do relogio da placa com o do PC pela serial de debug
+ * @details
+ * O PC (Tools/timesync) manda pedidos pelo shell e a placa responde na
+ * mesma serial, em texto:
+ *
+ *   PC -> placa:  tsync <seq> <t1> <t4>\n
+ *   placa -> PC:  tsync <seq> <t2> <t3>\r\n
+ *
+ * t1 e o envio do pedido seq e t2 a sua chegada (o terminador, carimbado na
+ * interrupcao de recepcao). t3 e t4 sao da troca anterior (seq - 1): a
+ * placa so sabe quando a resposta comeca a sair depois de coloca-la na
+ * fila (Debug_WriteStamp), entao manda o t3 na resposta seguinte, e o PC
+ * manda o t4 no pedido seguinte. Com isso os dois lados fecham a troca
+ * seq - 1 com os mesmos quatro instantes e rodam o mesmo estimador
+ * (timesync/timesync.h); zero marca um valor que ainda nao existe.
+ *
+ * Os tempos da placa sao Timebase_Us; os do PC sao os do relogio que ele
+ * escolher, em us. Com a reta ajustada a placa converte os carimbos das
+ * amostras para o relogio do PC, com o erro estimado.
+ */
+
+#ifndef _APP_TIMESYNC_H_
+#define _APP_TIMESYNC_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "timesync/timesync.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado da sincronizacao para exibicao */
+typedef struct
+{
+	TSyncEstimate_t est;    /**< Reta placa - PC */
+	uint32_t requests;      /**< Pedidos respondidos */
+	uint32_t exchanges;     /**< Trocas completas usadas no estimador */
+	uint32_t rejected;      /**< Trocas descartadas */
+	uint32_t last_seq;      /**< Ultimo pedido */
+	TickType_t last_tick;   /**< Tick do ultimo pedido */
+} AppTimeSyncStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Inicia o estimador sem trocas.
+ * @param baud Baud rate da serial de debug.
+ */
+void AppTimeSync_Init(uint32_t baud);
+
+/**
+ * Responde um pedido do PC; chamada pelo shell.
+ * @param seq Numero do pedido.
+ * @param t1 Envio do pedido no relogio do PC (us).
+ * @param t4 Recepcao da resposta anterior no relogio do PC (0 = nenhuma).
+ * @return HAL_OK, ou o erro de Debug_WriteStamp.
+ */
+HAL_StatusTypeDef AppTimeSync_Request(uint32_t seq, int64_t t1, int64_t t4);
+
+/**
+ * Converte um instante da placa para o relogio do PC.
+ * @param board_us Instante em Timebase_Us.
+ * @param host_us Saida no relogio do PC (us).
+ * @param error_us Saida com o erro estimado (pode ser NULL).
+ * @return false enquanto nao ha troca completa.
+ */
+bool AppTimeSync_ToHost(uint64_t board_us, int64_t *host_us, uint32_t *error_us);
+
+/**
+ * Retorna o estado da sincronizacao.
+ * @param status Estrutura de saida.
+ */
+void AppTimeSync_GetStatus(AppTimeSyncStatus_t *status);
+
+/** @brief Descarta as trocas (o PC foi reiniciado ou trocou de relogio). */
+void AppTimeSync_Reset(void);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_TIMESYNC_H_ */
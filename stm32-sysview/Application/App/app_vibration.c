@@ -0,0 +1,412 @@
+/**
+ * @file    app_vibration.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Analise de vibracao pelo FIFO do acelerometro do LSM6DSL
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_vibration.h"
+#include "app_telemetry.h"
+
+#include "lsm6dsl/lsm6dsl.h"
+#include "sensor_drv/sensor_drv.h"
+#include "timebase/timebase.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Como a telemetria: o FIFO segura as amostras entre as leituras */
+#define APP_VIB_TASK_PRIORITY		2
+
+/** @brief Amostras por chamada de SensorDrv_ReadBatch */
+#define APP_VIB_BATCH				32
+
+/** @brief ug -> m/s2 */
+#define APP_VIB_UG_TO_MS2			(9.80665e-6f)
+
+/** @brief Sinais de telemetria: RMS, velocidade RMS e maior pico */
+#define APP_VIB_TLM_SIGNALS			3
+
+/** @brief Espera da telemetria pelo mutex: sem valor, o quadro repete o anterior */
+#define APP_VIB_TLM_TIMEOUT			5
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Quadro e twiddles */
+static float vibWork[VIB_WORK_SIZE(APP_VIB_MAX_SIZE)];
+
+/** @brief Lote do FIFO em ug (XYZ) */
+static int32_t vibBatch[APP_VIB_BATCH * SENSOR_DRV_MAX_AXES];
+
+static Vib_t vib;
+static AppVibStatus_t vibStatus;
+static uint16_t vibFill;
+
+static uint8_t vibBands = 3;
+static VibBand_t vibBand[VIB_MAX_BANDS] = { { 10.0f, 100.0f }, { 100.0f, 300.0f }, { 300.0f, 1000.0f } };
+
+static uint8_t vib_id = SENSOR_DRV_INVALID;
+static uint8_t vibSub = SENSOR_DRV_INVALID;
+
+static const TlmSignal_t vibSignals[APP_VIB_TLM_SIGNALS] =
+{
+	{ "vib.rms", "mm/s2", 1 },
+	{ "vib.vel", "mm/s", 100 },
+	{ "vib.peak", "Hz", 10 },
+};
+
+static SemaphoreHandle_t mutex_vib = NULL;
+static TaskHandle_t vibTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppVib_Task(void *param);
+
+/**
+ * Prepara a analise para a taxa atual e esvazia o quadro.
+ * @param rate_hz ODR do acelerometro.
+ * @return false se a configuracao for invalida.
+ */
+static bool AppVib_Setup(float rate_hz);
+
+/**
+ * Esvazia o FIFO e acumula o eixo no quadro, processando quadros completos.
+ */
+static void AppVib_Drain(void);
+
+/** @brief Processa o quadro completo. */
+static void AppVib_Process(void);
+
+/**
+ * Leitor dos sinais de telemetria.
+ * @param arg Indice do sinal.
+ * @param value Saida.
+ * @return false sem quadro processado.
+ */
+static bool AppVib_TlmRead(uint8_t arg, int32_t *value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static bool AppVib_Setup(float rate_hz)
+{
+	vibFill = 0;
+	vibStatus.rate_hz = rate_hz;
+
+	if (Vib_Init(&vib, vibStatus.size, rate_hz, FFT_WINDOW_HANN, vibWork) == false)
+	{
+		return false;
+	}
+
+	return Vib_SetBands(&vib, vibBand, vibBands);
+}
+
+static void AppVib_Process(void)
+{
+	float rate_hz = (float) SensorDrv_GetOdr(vib_id) / 1000.0f;
+	uint32_t start;
+
+	/* Outro assinante mudou o ODR no meio do quadro: as frequencias estariam erradas */
+	if (rate_hz != vibStatus.rate_hz)
+	{
+		vibStatus.restarts++;
+		AppVib_Setup(rate_hz);
+		return;
+	}
+
+	start = Timebase_Cycles32();
+	Vib_Process(&vib, &vibStatus.result);
+	vibStatus.cycles_last = Timebase_Cycles32() - start;
+
+	if (vibStatus.cycles_last > vibStatus.cycles_max)
+	{
+		vibStatus.cycles_max = vibStatus.cycles_last;
+	}
+
+	vibStatus.frames++;
+	vibFill = 0;
+}
+
+static void AppVib_Drain(void)
+{
+	float *frame = Vib_Frame(&vib);
+	uint64_t first, last;
+	uint16_t count, i;
+
+	do
+	{
+		count = SensorDrv_ReadBatch(vib_id, vibBatch, APP_VIB_BATCH);
+		LSM6DSL_FifoGetBatchStamps(&first, &last);
+		vibStatus.samples += count;
+
+		for (i = 0; i < count; i++)
+		{
+			frame[vibFill++] = (float) vibBatch[i * SENSOR_DRV_MAX_AXES + vibStatus.axis] * APP_VIB_UG_TO_MS2;
+
+			if (vibFill == vibStatus.size)
+			{
+				/* As amostras do lote sao igualmente espacadas entre a primeira e a ultima */
+				vibStatus.frame_us = first + ((count > 1) ? (last - first) * i / (count - 1) : 0);
+				AppVib_Process();
+			}
+		}
+	} while (count == APP_VIB_BATCH);
+}
+
+static void AppVib_Task(void *param)
+{
+	uint32_t samples;
+
+	for (;;)
+	{
+		vTaskDelay(pdMS_TO_TICKS(APP_VIB_POLL_MS));
+
+		xSemaphoreTake(mutex_vib, portMAX_DELAY);
+
+		if (vibStatus.running == true)
+		{
+			AppVib_Drain();
+			LSM6DSL_FifoGetStats(&samples, &vibStatus.overruns);
+		}
+
+		xSemaphoreGive(mutex_vib);
+	}
+}
+
+static bool AppVib_TlmRead(uint8_t arg, int32_t *value)
+{
+	VibResult_t r;
+	bool ok;
+
+	if (xSemaphoreTake(mutex_vib, APP_VIB_TLM_TIMEOUT) != pdTRUE)
+	{
+		return false;
+	}
+
+	ok = (vibStatus.running == true) && (vibStatus.frames > 0);
+	r = vibStatus.result;
+
+	xSemaphoreGive(mutex_vib);
+
+	if (ok == false)
+	{
+		return false;
+	}
+
+	switch (arg)
+	{
+	case 0:
+		*value = (int32_t) (r.rms * 1000.0f + 0.5f);
+		break;
+	case 1:
+		*value = (int32_t) (r.velocity_rms * 100.0f + 0.5f);
+		break;
+	default:
+		*value = (int32_t) (r.peak_hz[0] * 10.0f + 0.5f);
+		break;
+	}
+
+	return true;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppVib_TaskInit(void)
+{
+	BaseType_t xReturned;
+	uint8_t i;
+
+	memset(&vibStatus, 0, sizeof(vibStatus));
+
+	vib_id = SensorDrv_Find(SENSOR_TYPE_ACCELERO, "LSM6DSL");
+
+	if (mutex_vib == NULL)
+	{
+		mutex_vib = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_vib);
+		vQueueAddToRegistry(mutex_vib, "vib");
+	}
+
+	for (i = 0; i < APP_VIB_TLM_SIGNALS; i++)
+	{
+		AppTelemetry_AddSignal(&vibSignals[i], AppVib_TlmRead, i);
+	}
+
+	xReturned = xTaskCreate(AppVib_Task, "tkVib", configMINIMAL_STACK_SIZE * 2, NULL, APP_VIB_TASK_PRIORITY, &vibTask);
+	configASSERT(xReturned);
+}
+
+HAL_StatusTypeDef AppVib_Start(uint16_t size, uint32_t rate_mhz, uint8_t axis)
+{
+	HAL_StatusTypeDef status = HAL_ERROR;
+
+	if ((vib_id == SENSOR_DRV_INVALID) || (size < VIB_MIN_SIZE) || (size > APP_VIB_MAX_SIZE) || ((size & (size - 1)) != 0)
+			|| (rate_mhz == 0) || (rate_mhz > APP_VIB_MAX_RATE_MHZ) || (axis >= SENSOR_DRV_MAX_AXES))
+	{
+		return HAL_ERROR;
+	}
+
+	AppVib_Stop();
+
+	xSemaphoreTake(mutex_vib, portMAX_DELAY);
+
+	memset(&vibStatus, 0, sizeof(vibStatus));
+	vibStatus.size = size;
+	vibStatus.axis = axis;
+
+	/* A assinatura poe o canal em modo continuo; o ODR pode ficar acima do pedido */
+	vibSub = SensorDrv_Subscribe(vib_id, rate_mhz, SENSOR_POWER_NORMAL);
+
+	if ((vibSub != SENSOR_DRV_INVALID) && (SensorDrv_Lock() == HAL_OK))
+	{
+		/* Carimbo do proprio sensor: o quadro fica com o instante da captura */
+		LSM6DSL_FifoSetTimestamp(1);
+		LSM6DSL_FifoStart();
+		SensorDrv_Unlock();
+
+		if (AppVib_Setup((float) SensorDrv_GetOdr(vib_id) / 1000.0f) == true)
+		{
+			vibStatus.running = true;
+			status = HAL_OK;
+		}
+	}
+
+	xSemaphoreGive(mutex_vib);
+
+	if (status != HAL_OK)
+	{
+		AppVib_Stop();
+	}
+
+	return status;
+}
+
+void AppVib_Stop(void)
+{
+	xSemaphoreTake(mutex_vib, portMAX_DELAY);
+
+	if (vibSub != SENSOR_DRV_INVALID)
+	{
+		if (SensorDrv_Lock() == HAL_OK)
+		{
+			LSM6DSL_FifoStop();
+			SensorDrv_Unlock();
+		}
+
+		SensorDrv_Unsubscribe(vibSub);
+		vibSub = SENSOR_DRV_INVALID;
+	}
+	vibStatus.running = false;
+
+	xSemaphoreGive(mutex_vib);
+}
+
+HAL_StatusTypeDef AppVib_SetBands(const VibBand_t *bands, uint8_t count)
+{
+	VibBand_t old[VIB_MAX_BANDS];
+	HAL_StatusTypeDef status = HAL_OK;
+	uint8_t i;
+
+	if (count > VIB_MAX_BANDS)
+	{
+		return HAL_ERROR;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if ((bands[i].lo_hz < 0.0f) || (bands[i].hi_hz <= bands[i].lo_hz))
+		{
+			return HAL_ERROR;
+		}
+	}
+
+	xSemaphoreTake(mutex_vib, portMAX_DELAY);
+
+	memcpy(old, vibBand, sizeof(old));
+	memcpy(vibBand, bands, count * sizeof(VibBand_t));
+	vibBands = count;
+
+	if ((vibStatus.running == true) && (Vib_SetBands(&vib, vibBand, vibBands) == false))
+	{
+		memcpy(vibBand, old, sizeof(old));
+		status = HAL_ERROR;
+	}
+
+	xSemaphoreGive(mutex_vib);
+
+	return status;
+}
+
+uint8_t AppVib_GetBands(VibBand_t *bands)
+{
+	uint8_t count;
+
+	xSemaphoreTake(mutex_vib, portMAX_DELAY);
+	memcpy(bands, vibBand, sizeof(vibBand));
+	count = vibBands;
+	xSemaphoreGive(mutex_vib);
+
+	return count;
+}
+
+void AppVib_GetStatus(AppVibStatus_t *status)
+{
+	xSemaphoreTake(mutex_vib, portMAX_DELAY);
+	*status = vibStatus;
+	xSemaphoreGive(mutex_vib);
+}
+
+HAL_StatusTypeDef AppVib_Bench(uint16_t size, uint32_t *cycles, uint32_t *cycles_ref)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+	FftPlan_t plan;
+	uint32_t start;
+	uint16_t i;
+
+	xSemaphoreTake(mutex_vib, portMAX_DELAY);
+
+	if (vibStatus.running == true)
+	{
+		status = HAL_BUSY;
+	}
+	else if (Fft_Init(&plan, size, vibWork + size) == false)
+	{
+		status = HAL_ERROR;
+	}
+	else
+	{
+		for (i = 0; i < size; i++)
+		{
+			vibWork[i] = (float) (rand() & 0xFFF) - 2048.0f;
+		}
+
+		start = Timebase_Cycles32();
+		Fft_Real(&plan, vibWork);
+		*cycles = Timebase_Cycles32() - start;
+
+		/* A entrada da referencia e o espectro: o custo nao depende dos valores */
+		start = Timebase_Cycles32();
+		Fft_RealRef(&plan, vibWork);
+		*cycles_ref = Timebase_Cycles32() - start;
+	}
+
+	xSemaphoreGive(mutex_vib);
+
+	return status;
+}
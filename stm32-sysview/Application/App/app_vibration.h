@@ -0,0 +1,134 @@
+/**
+ * @file    app_vibration.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Analise de vibracao pelo FIFO do acelerometro do LSM6DSL
+ * @details
+ * Ligada, a task assina o acelerometro na taxa pedida e poe o FIFO do
+ * LSM6DSL em modo continuo. A cada APP_VIB_POLL_MS ela esvazia o FIFO pelo
+ * SensorDrv_ReadBatch (o lote ja vem convertido em ug) e acumula um eixo em
+ * quadros de 256 a 2048 pontos. Cada quadro completo passa por
+ * Libs/vibration (janela de Hann, FFT real radix-2^2) e so as
+ * caracteristicas ficam: RMS total e por banda, picos e velocidade RMS.
+ *
+ * Banda do I2C: o barramento roda a 100 kHz e cada amostra XYZ do FIFO
+ * custa 6 bytes (cerca de 0.55 ms), entao APP_VIB_MAX_RATE_MHZ fica em
+ * 833 Hz (metade do barramento); 1.66 kHz ja nao caberia com os outros
+ * sensores. O FIFO guarda LSM6DSL_FIFO_SAMPLES amostras (0.8 s a 833 Hz).
+ *
+ * O quadro e as twiddles ficam em um buffer estatico de
+ * VIB_WORK_SIZE(APP_VIB_MAX_SIZE) floats (16 KB).
+ */
+
+#ifndef _APP_VIBRATION_H_
+#define _APP_VIBRATION_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "vibration/vibration.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define APP_VIB_MAX_SIZE			VIB_MAX_SIZE
+
+/** @brief Maior taxa pelo limite do I2C a 100 kHz */
+#define APP_VIB_MAX_RATE_MHZ		833000
+
+#define APP_VIB_DEF_SIZE			1024
+#define APP_VIB_DEF_RATE_MHZ		833000
+
+/** @brief Intervalo de leitura do FIFO */
+#define APP_VIB_POLL_MS				50
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado da analise e caracteristicas do ultimo quadro */
+typedef struct
+{
+	bool running;
+	uint16_t size;          /**< Pontos por quadro */
+	uint8_t axis;           /**< 0 = X, 1 = Y, 2 = Z */
+	float rate_hz;          /**< ODR real do acelerometro */
+	uint32_t samples;       /**< Amostras lidas do FIFO */
+	uint32_t frames;        /**< Quadros processados */
+	uint32_t overruns;      /**< Leituras com o FIFO sobrescrito */
+	uint32_t restarts;      /**< Quadros descartados por troca de ODR */
+	uint32_t cycles_last;   /**< Ciclos de Vib_Process no ultimo quadro */
+	uint32_t cycles_max;
+	uint64_t frame_us;      /**< Captura da ultima amostra do ultimo quadro (Timebase_Us) */
+	VibResult_t result;
+} AppVibStatus_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Cria a task de vibracao (parada) e acrescenta RMS, velocidade e pico a
+ * telemetria. Deve ser chamada depois de AppTelemetry_TaskInit.
+ */
+void AppVib_TaskInit(void);
+
+/**
+ * Assina o acelerometro, liga o FIFO e comeca os quadros.
+ * @param size Pontos por quadro (potencia de 2, VIB_MIN_SIZE a APP_VIB_MAX_SIZE).
+ * @param rate_mhz Taxa pedida, ate APP_VIB_MAX_RATE_MHZ.
+ * @param axis Eixo analisado (0 a 2).
+ * @return HAL_OK, HAL_ERROR para parametros invalidos ou sem acelerometro.
+ */
+HAL_StatusTypeDef AppVib_Start(uint16_t size, uint32_t rate_mhz, uint8_t axis);
+
+/** @brief Desliga o FIFO e libera a assinatura. */
+void AppVib_Stop(void);
+
+/**
+ * Troca as bandas de energia (valem a partir do proximo quadro).
+ * @param bands Faixas em Hz.
+ * @param count Ate VIB_MAX_BANDS.
+ * @return HAL_OK, HAL_ERROR se alguma faixa for invalida.
+ */
+HAL_StatusTypeDef AppVib_SetBands(const VibBand_t *bands, uint8_t count);
+
+/**
+ * Bandas configuradas.
+ * @param bands Saida com VIB_MAX_BANDS faixas.
+ * @return Quantidade de bandas.
+ */
+uint8_t AppVib_GetBands(VibBand_t *bands);
+
+/**
+ * Copia o estado e o ultimo resultado.
+ * @param status Saida.
+ */
+void AppVib_GetStatus(AppVibStatus_t *status);
+
+/**
+ * Mede com o DWT uma FFT de cada caminho sobre ruido, no buffer da analise.
+ * @param size Pontos (potencia de 2, FFT_MIN_SIZE a APP_VIB_MAX_SIZE).
+ * @param cycles Ciclos de Fft_Real (radix-2^2).
+ * @param cycles_ref Ciclos de Fft_RealRef (radix-2).
+ * @return HAL_OK, HAL_BUSY com a analise ligada, HAL_ERROR para tamanho invalido.
+ */
+HAL_StatusTypeDef AppVib_Bench(uint16_t size, uint32_t *cycles, uint32_t *cycles_ref);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_VIBRATION_H_ */
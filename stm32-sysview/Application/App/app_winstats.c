@@ -0,0 +1,469 @@
+/**
+ * @file    app_winstats.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Estatisticas em janelas deslizantes dos sinais dos sensores
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "app_winstats.h"
+#include "app_telemetry.h"
+#include "sensor_cache.h"
+#include "timebase/timebase.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Como a telemetria: abaixo do shell e das tasks de sensores */
+#define APP_WSTATS_TASK_PRIORITY	2
+
+/** @brief Taxa maxima: uma amostra por tick */
+#define APP_WSTATS_MAX_RATE_MHZ		(configTICK_RATE_HZ * 1000UL)
+
+#define APP_WSTATS_NAME_SIZE		40
+
+/** @brief Sinais de telemetria por slot: media, desvio, minimo e maximo */
+#define APP_WSTATS_TLM_STATS		4
+
+/** @brief Casa decimal a mais da media e do desvio na telemetria */
+#define APP_WSTATS_TLM_DECIMAL		10
+
+/** @brief Espera da telemetria pelo mutex: sem valor, o quadro repete o anterior */
+#define APP_WSTATS_TLM_TIMEOUT		5
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Estado interno de um slot */
+typedef struct
+{
+	AppWStatsSlot_t status;
+	WinStats_t stats;
+	TickType_t period;
+	TickType_t next;
+	uint8_t sub;                /**< Assinatura do canal */
+	char name[APP_WSTATS_NAME_SIZE];
+	char tlm_names[APP_WSTATS_TLM_STATS][APP_WSTATS_NAME_SIZE];
+	uint8_t tlm_index;          /**< Primeiro sinal na telemetria */
+} AppWStatsCtx_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Historico dos slots: SRAM2, fora do .bss (nao e zerado no boot) */
+static uint8_t wstatsPool[APP_WSTATS_SLOTS][APP_WSTATS_SLOT_BYTES] __attribute__((section(".ram2"), aligned(4)));
+
+static AppWStatsCtx_t wstatsSlots[APP_WSTATS_SLOTS];
+
+static const char * const strStats[APP_WSTATS_TLM_STATS] = { "mean", "std", "min", "max" };
+
+static SemaphoreHandle_t mutex_wstats = NULL;
+static TaskHandle_t wstatsTask = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static void AppWStats_Task(void *param);
+
+/**
+ * Tamanho de cada janela em amostras.
+ * @param config Configuracao.
+ * @param lengths Saida com config->num_windows valores.
+ * @return false se alguma janela nao couber em 16 bits.
+ */
+static bool AppWStats_Lengths(const AppWStatsConfig_t *config, uint16_t *lengths);
+
+/**
+ * Le o canal de um slot e atualiza as janelas.
+ * @param ctx Slot.
+ */
+static void AppWStats_Sample(AppWStatsCtx_t *ctx);
+
+/**
+ * Atualiza nome, unidade e escala dos sinais de telemetria de um slot.
+ * @param slot Indice do slot.
+ */
+static void AppWStats_UpdateTelemetry(uint8_t slot);
+
+/**
+ * Leitura dos sinais de telemetria (AppTelemetryReader_t).
+ * @param arg slot * APP_WSTATS_TLM_STATS + estatistica.
+ */
+static bool AppWStats_TlmRead(uint8_t arg, int32_t *value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static bool AppWStats_Lengths(const AppWStatsConfig_t *config, uint16_t *lengths)
+{
+	uint32_t n;
+	uint8_t i;
+
+	for (i = 0; i < config->num_windows; i++)
+	{
+		n = (uint32_t) (((uint64_t) config->window_ms[i] * config->rate_mhz + 500000ULL) / 1000000ULL);
+		if ((n == 0) || (n > WINSTATS_MAX_LENGTH))
+		{
+			return false;
+		}
+		lengths[i] = (uint16_t) n;
+	}
+
+	return true;
+}
+
+static void AppWStats_Sample(AppWStatsCtx_t *ctx)
+{
+	int32_t sample[SENSOR_DRV_MAX_AXES];
+	uint32_t start;
+
+	if (SensorCache_Read(ctx->status.config.id, sample, false) != HAL_OK)
+	{
+		ctx->status.misses++;
+		return;
+	}
+
+	start = Timebase_Cycles32();
+	WinStats_Push(&ctx->stats, sample[ctx->status.config.axis]);
+	ctx->status.cycles_last = Timebase_Cycles32() - start;
+
+	if (ctx->status.cycles_last > ctx->status.cycles_max)
+	{
+		ctx->status.cycles_max = ctx->status.cycles_last;
+	}
+	ctx->status.samples++;
+}
+
+static void AppWStats_Task(void *param)
+{
+	AppWStatsCtx_t *ctx;
+	TickType_t now, wait;
+	int32_t left;
+	uint8_t i;
+
+	for (;;)
+	{
+		/* Dorme ate o proximo slot vencer ou ate uma reconfiguracao */
+		wait = portMAX_DELAY;
+		now = xTaskGetTickCount();
+
+		xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+		for (i = 0; i < APP_WSTATS_SLOTS; i++)
+		{
+			ctx = &wstatsSlots[i];
+			if (ctx->status.active == true)
+			{
+				left = (int32_t) (ctx->next - now);
+				wait = (left <= 0) ? 0 : (((TickType_t) left < wait) ? (TickType_t) left : wait);
+			}
+		}
+		xSemaphoreGive(mutex_wstats);
+
+		if (wait > 0)
+		{
+			ulTaskNotifyTake(pdTRUE, wait);
+		}
+
+		xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+
+		now = xTaskGetTickCount();
+		for (i = 0; i < APP_WSTATS_SLOTS; i++)
+		{
+			ctx = &wstatsSlots[i];
+			if ((ctx->status.active == false) || ((int32_t) (now - ctx->next) < 0))
+			{
+				continue;
+			}
+
+			AppWStats_Sample(ctx);
+			ctx->next += ctx->period;
+
+			/* Atrasou mais de um periodo: retoma a grade a partir de agora */
+			if ((int32_t) (now - ctx->next) >= 0)
+			{
+				ctx->next = now + ctx->period;
+			}
+		}
+
+		xSemaphoreGive(mutex_wstats);
+	}
+}
+
+static void AppWStats_UpdateTelemetry(uint8_t slot)
+{
+	AppWStatsCtx_t *ctx = &wstatsSlots[slot];
+	TlmSignal_t signal;
+	uint8_t i;
+
+	if (ctx->tlm_index >= TLM_MAX_SIGNALS)
+	{
+		return;
+	}
+
+	for (i = 0; i < APP_WSTATS_TLM_STATS; i++)
+	{
+		if (ctx->status.active == true)
+		{
+			snprintf(ctx->tlm_names[i], APP_WSTATS_NAME_SIZE, "%s.%lus.%s", ctx->name,
+					(unsigned long) ((ctx->status.config.window_ms[0] + 500UL) / 1000UL), strStats[i]);
+			signal.unit = ctx->status.unit;
+			signal.scale = (i < 2) ? ctx->status.scale * APP_WSTATS_TLM_DECIMAL : ctx->status.scale;
+		}
+		else
+		{
+			snprintf(ctx->tlm_names[i], APP_WSTATS_NAME_SIZE, "w%u.%s", slot, strStats[i]);
+			signal.unit = "";
+			signal.scale = 1;
+		}
+
+		signal.name = ctx->tlm_names[i];
+		AppTelemetry_UpdateSignal((uint8_t) (ctx->tlm_index + i), &signal);
+	}
+}
+
+static bool AppWStats_TlmRead(uint8_t arg, int32_t *value)
+{
+	AppWStatsCtx_t *ctx = &wstatsSlots[arg / APP_WSTATS_TLM_STATS];
+	WinStatsResult_t r;
+	bool ok;
+
+	if (xSemaphoreTake(mutex_wstats, APP_WSTATS_TLM_TIMEOUT) != pdTRUE)
+	{
+		return false;
+	}
+
+	ok = (ctx->status.active == true) && WinStats_Get(&ctx->stats, 0, &r);
+
+	xSemaphoreGive(mutex_wstats);
+
+	if (ok == false)
+	{
+		return false;
+	}
+
+	switch (arg % APP_WSTATS_TLM_STATS)
+	{
+	case 0:
+		*value = (int32_t) (r.mean * APP_WSTATS_TLM_DECIMAL + ((r.mean >= 0.0f) ? 0.5f : -0.5f));
+		break;
+	case 1:
+		*value = (int32_t) (r.std * APP_WSTATS_TLM_DECIMAL + 0.5f);
+		break;
+	case 2:
+		*value = r.min;
+		break;
+	default:
+		*value = r.max;
+		break;
+	}
+
+	return true;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AppWStats_TaskInit(void)
+{
+	TlmSignal_t signal = { NULL, "", 1 };
+	BaseType_t xReturned;
+	uint8_t slot, i, index;
+
+	memset(wstatsSlots, 0, sizeof(wstatsSlots));
+
+	if (mutex_wstats == NULL)
+	{
+		mutex_wstats = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_wstats);
+		vQueueAddToRegistry(mutex_wstats, "wstats");
+	}
+
+	/* Sinais reservados na telemetria; ganham nome quando o slot e configurado */
+	for (slot = 0; slot < APP_WSTATS_SLOTS; slot++)
+	{
+		wstatsSlots[slot].sub = SENSOR_DRV_INVALID;
+		wstatsSlots[slot].tlm_index = TLM_MAX_SIGNALS;
+
+		for (i = 0; i < APP_WSTATS_TLM_STATS; i++)
+		{
+			snprintf(wstatsSlots[slot].tlm_names[i], APP_WSTATS_NAME_SIZE, "w%u.%s", slot, strStats[i]);
+			signal.name = wstatsSlots[slot].tlm_names[i];
+
+			index = AppTelemetry_AddSignal(&signal, AppWStats_TlmRead, (uint8_t) (slot * APP_WSTATS_TLM_STATS + i));
+			if (i == 0)
+			{
+				wstatsSlots[slot].tlm_index = index;
+			}
+		}
+	}
+
+	xReturned = xTaskCreate(AppWStats_Task, "tkWStats", configMINIMAL_STACK_SIZE * 2, NULL, APP_WSTATS_TASK_PRIORITY, &wstatsTask);
+	configASSERT(xReturned);
+}
+
+uint32_t AppWStats_MemSize(const AppWStatsConfig_t *config)
+{
+	uint16_t lengths[WINSTATS_MAX_WINDOWS];
+
+	if ((config->num_windows == 0) || (config->num_windows > WINSTATS_MAX_WINDOWS) ||
+			(config->rate_mhz == 0) || (AppWStats_Lengths(config, lengths) == false))
+	{
+		return 0;
+	}
+
+	return WinStats_MemSize(lengths, config->num_windows);
+}
+
+HAL_StatusTypeDef AppWStats_Set(uint8_t slot, const AppWStatsConfig_t *config)
+{
+	const SensorChannelDesc_t *desc;
+	uint16_t lengths[WINSTATS_MAX_WINDOWS];
+	AppWStatsCtx_t *ctx;
+	uint32_t bytes = AppWStats_MemSize(config);
+
+	if ((slot >= APP_WSTATS_SLOTS) || (config->id >= SensorDrv_GetNumChannels()) ||
+			(config->rate_mhz > APP_WSTATS_MAX_RATE_MHZ) || (bytes == 0) || (bytes > APP_WSTATS_SLOT_BYTES))
+	{
+		return HAL_ERROR;
+	}
+
+	desc = SensorDrv_GetDesc(config->id);
+	if (config->axis >= desc->axes)
+	{
+		return HAL_ERROR;
+	}
+
+	AppWStats_Clear(slot);
+	AppWStats_Lengths(config, lengths);
+
+	xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+
+	ctx = &wstatsSlots[slot];
+	WinStats_Init(&ctx->stats, lengths, config->num_windows, wstatsPool[slot], APP_WSTATS_SLOT_BYTES);
+
+	if (desc->axes == 1)
+	{
+		snprintf(ctx->name, APP_WSTATS_NAME_SIZE, "%s.%s", SensorDrv_GetOwner(config->id)->name, desc->name);
+	}
+	else
+	{
+		snprintf(ctx->name, APP_WSTATS_NAME_SIZE, "%s.%s.%c", SensorDrv_GetOwner(config->id)->name, desc->name, 'x' + config->axis);
+	}
+
+	memset(&ctx->status, 0, sizeof(ctx->status));
+	ctx->status.config = *config;
+	ctx->status.name = ctx->name;
+	ctx->status.unit = desc->unit;
+	ctx->status.scale = desc->scale;
+	ctx->status.bytes = bytes;
+
+	ctx->period = pdMS_TO_TICKS(1000000UL / config->rate_mhz);
+	if (ctx->period == 0)
+	{
+		ctx->period = 1;
+	}
+	ctx->next = xTaskGetTickCount();
+
+	/* Como a telemetria, aceita o modo de baixo consumo do sensor */
+	ctx->sub = SensorDrv_Subscribe(config->id, config->rate_mhz, SENSOR_POWER_LOW);
+	ctx->status.active = true;
+
+	xSemaphoreGive(mutex_wstats);
+
+	AppWStats_UpdateTelemetry(slot);
+	xTaskNotifyGive(wstatsTask);
+
+	return HAL_OK;
+}
+
+void AppWStats_Clear(uint8_t slot)
+{
+	AppWStatsCtx_t *ctx;
+	bool was_active;
+
+	if (slot >= APP_WSTATS_SLOTS)
+	{
+		return;
+	}
+
+	xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+
+	ctx = &wstatsSlots[slot];
+	was_active = ctx->status.active;
+	ctx->status.active = false;
+
+	if (ctx->sub != SENSOR_DRV_INVALID)
+	{
+		SensorDrv_Unsubscribe(ctx->sub);
+		ctx->sub = SENSOR_DRV_INVALID;
+	}
+
+	xSemaphoreGive(mutex_wstats);
+
+	if (was_active == true)
+	{
+		AppWStats_UpdateTelemetry(slot);
+	}
+}
+
+void AppWStats_Reset(void)
+{
+	uint8_t i;
+
+	xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+
+	for (i = 0; i < APP_WSTATS_SLOTS; i++)
+	{
+		if (wstatsSlots[i].status.active == true)
+		{
+			WinStats_Reset(&wstatsSlots[i].stats);
+			wstatsSlots[i].status.samples = 0;
+			wstatsSlots[i].status.misses = 0;
+			wstatsSlots[i].status.cycles_max = 0;
+		}
+	}
+
+	xSemaphoreGive(mutex_wstats);
+}
+
+void AppWStats_GetSlot(uint8_t slot, AppWStatsSlot_t *status)
+{
+	if (slot >= APP_WSTATS_SLOTS)
+	{
+		memset(status, 0, sizeof(AppWStatsSlot_t));
+		return;
+	}
+
+	xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+	*status = wstatsSlots[slot].status;
+	xSemaphoreGive(mutex_wstats);
+}
+
+bool AppWStats_GetWindow(uint8_t slot, uint8_t window, WinStatsResult_t *result)
+{
+	bool ok;
+
+	if (slot >= APP_WSTATS_SLOTS)
+	{
+		return false;
+	}
+
+	xSemaphoreTake(mutex_wstats, portMAX_DELAY);
+	ok = (wstatsSlots[slot].status.active == true) && WinStats_Get(&wstatsSlots[slot].stats, window, result);
+	xSemaphoreGive(mutex_wstats);
+
+	return ok;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file    app_winstats.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Estatisticas em janelas deslizantes dos sinais dos sensores
+ * @details
+ * Cada slot amostra um eixo de um canal do registro (pelo cache) numa taxa
+ * propria e mantem ate WINSTATS_MAX_WINDOWS janelas em tempo (ex.: 1 s, 10 s
+ * e 60 s) com media, desvio, minimo, maximo e contagem, atualizadas em O(1)
+ * por Libs/winstats. O historico dos slots fica na SRAM2 (secao .ram2 do
+ * linker), APP_WSTATS_SLOT_BYTES por slot, fora da RAM principal e do heap.
+ *
+ * A primeira janela de cada slot tambem vai para a telemetria como quatro
+ * sinais (media, desvio, minimo e maximo), selecionados pela mascara do
+ * comando "tlm". Media e desvio levam uma casa decimal a mais que o canal.
+ */
+
+#ifndef _APP_WINSTATS_H_
+#define _APP_WINSTATS_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "winstats/winstats.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define APP_WSTATS_SLOTS			4
+
+/** @brief Historico de um slot na SRAM2 (anel e filas de todas as janelas) */
+#define APP_WSTATS_SLOT_BYTES		6144
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Configuracao de um slot */
+typedef struct
+{
+	uint8_t id;             /**< Canal no registro de drivers */
+	uint8_t axis;
+	uint32_t rate_mhz;      /**< Taxa de amostragem */
+	uint8_t num_windows;
+	uint32_t window_ms[WINSTATS_MAX_WINDOWS];
+} AppWStatsConfig_t;
+
+/** @brief Estado de um slot */
+typedef struct
+{
+	bool active;
+	AppWStatsConfig_t config;
+	const char *name;       /**< "CHIP.canal.eixo" */
+	const char *unit;
+	int32_t scale;          /**< LSB por unidade do canal */
+	uint32_t samples;       /**< Amostras recebidas */
+	uint32_t misses;        /**< Leituras do cache que falharam */
+	uint32_t bytes;         /**< Memoria usada na SRAM2 */
+	uint32_t cycles_last;   /**< Ciclos da ultima atualizacao de todas as janelas */
+	uint32_t cycles_max;
+} AppWStatsSlot_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Cria a task de amostragem (sem slots) e acrescenta os sinais dos slots a
+ * telemetria. Deve ser chamada depois de AppTelemetry_TaskInit.
+ */
+void AppWStats_TaskInit(void);
+
+/**
+ * Memoria que uma configuracao ocupa na SRAM2.
+ * @param config Configuracao.
+ * @return Bytes, ou 0 se a configuracao for invalida.
+ */
+uint32_t AppWStats_MemSize(const AppWStatsConfig_t *config);
+
+/**
+ * Configura um slot, descartando o historico dele, e assina o canal na taxa.
+ * @param slot Indice do slot.
+ * @param config Configuracao.
+ * @return HAL_OK, HAL_ERROR se a configuracao for invalida ou nao couber em
+ *         APP_WSTATS_SLOT_BYTES.
+ */
+HAL_StatusTypeDef AppWStats_Set(uint8_t slot, const AppWStatsConfig_t *config);
+
+/**
+ * Desliga um slot e libera a assinatura.
+ * @param slot Indice do slot.
+ */
+void AppWStats_Clear(uint8_t slot);
+
+/** @brief Esvazia as janelas de todos os slots. */
+void AppWStats_Reset(void);
+
+/**
+ * Copia o estado de um slot.
+ * @param slot Indice do slot.
+ * @param status Saida.
+ */
+void AppWStats_GetSlot(uint8_t slot, AppWStatsSlot_t *status);
+
+/**
+ * Le as estatisticas de uma janela, nos LSB do canal.
+ * @param slot Indice do slot.
+ * @param window Indice da janela.
+ * @param result Saida.
+ * @return false se o slot estiver desligado ou a janela vazia.
+ */
+bool AppWStats_GetWindow(uint8_t slot, uint8_t window, WinStatsResult_t *result);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _APP_WINSTATS_H_ */
@@ -0,0 +1,279 @@
+/**
+ * @file    sensor_cache.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Cache de leitura dos sensores com janela de validade por canal
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "sensor_cache.h"
+#include "setup_hw.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Tempo maximo de espera pelo mutex do cache */
+#define SENSOR_CACHE_MUTEX_TIMEOUT		1000
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+typedef struct
+{
+	int32_t value[SENSOR_DRV_MAX_AXES]; /* Ultima amostra lida do sensor */
+	TickType_t stamp;   /* Tick do inicio da transacao que trouxe a amostra */
+	uint64_t capture;   /* Timebase_Us do inicio da transacao que trouxe a amostra */
+	bool valid;         /* Copia em cache possui dado lido */
+	SensorCacheStats_t stats;
+} SensorCacheEntry_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static SensorCacheEntry_t cacheEntry[SENSOR_DRV_MAX_CHANNELS];
+
+static SensorCacheCorrection_t cacheCorrection[SENSOR_TYPE_MAX];
+
+static SemaphoreHandle_t mutex_cache = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Converte um ODR em janela de validade.
+ * @param odr_mhz ODR em mHz (0 = sem taxa continua).
+ * @return Janela em ticks.
+ */
+static TickType_t SensorCache_OdrToTicks(uint32_t odr_mhz);
+
+/**
+ * Chamada pelo registro quando o modo de um canal muda (assinaturas).
+ * @param id Canal alterado.
+ */
+static void SensorCache_OnChange(uint8_t id);
+
+/**
+ * Faz a transacao I2C do canal e atualiza a copia em cache; a copia so muda
+ * quando a leitura da certo.
+ * @param id Canal a ler.
+ * @return Status da leitura.
+ */
+static HAL_StatusTypeDef SensorCache_Fetch(uint8_t id);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static TickType_t SensorCache_OdrToTicks(uint32_t odr_mhz)
+{
+	if (odr_mhz == 0)
+	{
+		return 0;
+	}
+
+	/*
+	 * Periodo em ms arredondado para baixo, contado do inicio da leitura: um
+	 * acerto nunca tem mais de um ODR desde a leitura. O registro ja podia ter
+	 * ate um ODR quando foi lido, entao a amostra entregue tem menos de dois.
+	 */
+	return pdMS_TO_TICKS(1000000UL / odr_mhz);
+}
+
+static void SensorCache_OnChange(uint8_t id)
+{
+	cacheEntry[id].stats.validity = SensorCache_OdrToTicks(SensorDrv_GetRate(id));
+	cacheEntry[id].valid = false;
+}
+
+static HAL_StatusTypeDef SensorCache_Fetch(uint8_t id)
+{
+	const SensorChannelDesc_t *desc = SensorDrv_GetDesc(id);
+	SensorCacheEntry_t *entry = &cacheEntry[id];
+	int32_t value[SENSOR_DRV_MAX_AXES];
+	HAL_StatusTypeDef status;
+	TickType_t stamp;
+	uint64_t capture;
+
+	/* Com BDU os registradores de saida sao lidos como estavam no inicio da transacao */
+	stamp = xTaskGetTickCount();
+	capture = Timebase_Us();
+	status = SensorDrv_Read(id, value);
+
+	if (status != HAL_OK)
+	{
+		entry->valid = false;
+		return status;
+	}
+
+	if (cacheCorrection[desc->type] != NULL)
+	{
+		cacheCorrection[desc->type](value);
+	}
+
+	memcpy(entry->value, value, sizeof(value));
+	entry->stamp = stamp;
+	entry->capture = capture;
+	entry->valid = true;
+
+	return HAL_OK;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void SensorCache_Init(void)
+{
+	memset(&cacheEntry, 0, sizeof(cacheEntry));
+
+	if (mutex_cache == NULL)
+	{
+		mutex_cache = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_cache);
+		vQueueAddToRegistry(mutex_cache, "sensCache");
+	}
+
+	SensorCache_Reconfigure();
+
+	/* Assinaturas novas mudam a taxa dos canais depois do boot */
+	SensorDrv_AddNotify(SensorCache_OnChange);
+}
+
+void SensorCache_Reconfigure(void)
+{
+	uint8_t id;
+
+	if (xSemaphoreTake(mutex_cache, SENSOR_CACHE_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return;
+	}
+
+	for (id = 0; id < SensorDrv_GetNumChannels(); id++)
+	{
+		cacheEntry[id].stats.validity = SensorCache_OdrToTicks(SensorDrv_GetRate(id));
+	}
+
+	xSemaphoreGive(mutex_cache);
+}
+
+HAL_StatusTypeDef SensorCache_Read(uint8_t id, int32_t *value, bool force)
+{
+	return SensorCache_ReadStamped(id, value, force, NULL);
+}
+
+HAL_StatusTypeDef SensorCache_ReadStamped(uint8_t id, int32_t *value, bool force, uint64_t *capture_us)
+{
+	SensorCacheEntry_t *entry;
+	HAL_StatusTypeDef status = HAL_OK;
+	bool waited = false;
+
+	DBG_ASSERT_PARAM(value);
+
+	if (id >= SensorDrv_GetNumChannels())
+	{
+		return HAL_ERROR;
+	}
+
+	/* Se outra task estiver lendo, espera por ela e aproveita o resultado */
+	if (xSemaphoreTake(mutex_cache, 0) != pdTRUE)
+	{
+		waited = true;
+		if (xSemaphoreTake(mutex_cache, SENSOR_CACHE_MUTEX_TIMEOUT) != pdTRUE)
+		{
+			return HAL_TIMEOUT;
+		}
+	}
+
+	entry = &cacheEntry[id];
+
+	if ((force == false) && (entry->valid == true) &&
+			((TickType_t)(xTaskGetTickCount() - entry->stamp) < entry->stats.validity))
+	{
+		entry->stats.hits++;
+		if (waited == true)
+		{
+			entry->stats.coalesced++;
+		}
+	}
+	else
+	{
+		status = SensorCache_Fetch(id);
+		entry->stats.misses++;
+	}
+
+	/* Leitura falha nao devolve a amostra antiga como se fosse nova */
+	if (status == HAL_OK)
+	{
+		memcpy(value, entry->value, SensorDrv_GetDesc(id)->axes * sizeof(int32_t));
+		if (capture_us != NULL)
+		{
+			*capture_us = entry->capture;
+		}
+	}
+
+	xSemaphoreGive(mutex_cache);
+
+	return status;
+}
+
+void SensorCache_Invalidate(uint8_t id)
+{
+	uint8_t i;
+
+	for (i = 0; i < SENSOR_DRV_MAX_CHANNELS; i++)
+	{
+		if ((id == SENSOR_CACHE_ALL) || (id == i))
+		{
+			cacheEntry[i].valid = false;
+		}
+	}
+}
+
+void SensorCache_SetValidity(uint8_t id, TickType_t validity)
+{
+	DBG_ASSERT_PARAM(id < SENSOR_DRV_MAX_CHANNELS);
+
+	cacheEntry[id].stats.validity = validity;
+}
+
+void SensorCache_SetCorrection(SensorType_e type, SensorCacheCorrection_t correction)
+{
+	DBG_ASSERT_PARAM(type < SENSOR_TYPE_MAX);
+
+	cacheCorrection[type] = correction;
+	SensorCache_Invalidate(SENSOR_CACHE_ALL);
+}
+
+void SensorCache_GetStats(uint8_t id, SensorCacheStats_t *stats)
+{
+	DBG_ASSERT_PARAM(id < SENSOR_DRV_MAX_CHANNELS);
+
+	taskENTER_CRITICAL();
+	*stats = cacheEntry[id].stats;
+	taskEXIT_CRITICAL();
+}
+
+void SensorCache_ResetStats(void)
+{
+	uint8_t i;
+
+	taskENTER_CRITICAL();
+	for (i = 0; i < SENSOR_DRV_MAX_CHANNELS; i++)
+	{
+		cacheEntry[i].stats.hits = 0;
+		cacheEntry[i].stats.misses = 0;
+		cacheEntry[i].stats.coalesced = 0;
+	}
+	taskEXIT_CRITICAL();
+}
@@ -0,0 +1,138 @@
+/**
+ * @file    sensor_cache.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0.0 (beta)
+ * @brief   Cache de leitura dos sensores com janela de validade por canal
+ * @details
+ * Cada canal do registro de drivers fica valido por um periodo da sua taxa
+ * efetiva (o ODR, ou a taxa assinada quando o CI opera em conversao unica).
+ * Leituras dentro dessa janela sao atendidas pela copia em RAM, sem acesso
+ * ao barramento I2C. Leituras concorrentes de tasks diferentes sao
+ * serializadas pelo mutex do cache, de modo que apenas a primeira faz a
+ * transacao I2C e as demais recebem o valor recem lido.
+ *
+ * A janela conta do inicio da transacao: um acerto tem menos de um periodo
+ * desde a leitura, e o registro do sensor ja podia ter ate um periodo quando
+ * foi lido, entao a amostra entregue pode ter quase dois periodos.
+ */
+
+#ifndef _SENSOR_CACHE_H_
+#define _SENSOR_CACHE_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Seleciona todos os canais em SensorCache_Invalidate */
+#define SENSOR_CACHE_ALL		SENSOR_DRV_INVALID
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Contadores de uso do cache de um canal */
+typedef struct
+{
+	uint32_t hits;       /**< Leituras atendidas pela copia em RAM */
+	uint32_t misses;     /**< Leituras que geraram transacao I2C */
+	uint32_t coalesced;  /**< Hits de tasks que aguardaram uma leitura em andamento */
+	TickType_t validity; /**< Janela de validade em ticks (0 = sempre le o sensor) */
+} SensorCacheStats_t;
+
+/**
+ * @brief Correcao aplicada a cada amostra nova de um tipo de grandeza, antes
+ * de ser guardada no cache (ex.: calibracao do magnetometro).
+ * @param value Amostra convertida; corrigida no lugar.
+ */
+typedef void (*SensorCacheCorrection_t)(int32_t *value);
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Cria o mutex do cache e calcula a janela de validade de cada canal
+ * registrado a partir do ODR configurado. Deve ser chamada apos o registro
+ * dos drivers (SensorDrv_Register).
+ */
+void SensorCache_Init(void);
+
+/**
+ * Recalcula as janelas de validade lendo novamente o ODR dos canais.
+ * Deve ser chamada sempre que a configuracao de algum sensor mudar.
+ */
+void SensorCache_Reconfigure(void);
+
+/**
+ * Le um canal, usando a copia em cache se ela ainda for valida.
+ * @param id Indice do canal no registro de drivers.
+ * @param value Saida com os eixos do canal, na unidade do canal.
+ * @param force true para ignorar o cache e ler o sensor.
+ * @return HAL_OK, HAL_ERROR se o canal nao existe ou a leitura falhou, ou
+ *         HAL_TIMEOUT se o mutex do cache nao for obtido. Fora de HAL_OK a
+ *         saida nao e escrita.
+ */
+HAL_StatusTypeDef SensorCache_Read(uint8_t id, int32_t *value, bool force);
+
+/**
+ * SensorCache_Read que tambem devolve quando a amostra foi lida do sensor
+ * (um hit devolve o instante da leitura que encheu o cache).
+ * @param id Indice do canal no registro de drivers.
+ * @param value Saida com os eixos do canal, na unidade do canal.
+ * @param force true para ignorar o cache e ler o sensor.
+ * @param capture_us Saida em Timebase_Us (pode ser NULL).
+ * @return Os mesmos de SensorCache_Read.
+ */
+HAL_StatusTypeDef SensorCache_ReadStamped(uint8_t id, int32_t *value, bool force, uint64_t *capture_us);
+
+/**
+ * Invalida a copia em cache, forcando a proxima leitura a acessar o sensor.
+ * @param id Canal a invalidar ou SENSOR_CACHE_ALL para todos.
+ */
+void SensorCache_Invalidate(uint8_t id);
+
+/**
+ * Altera manualmente a janela de validade de um canal.
+ * @param id Canal a configurar.
+ * @param validity Janela em ticks (0 desativa o cache do canal).
+ */
+void SensorCache_SetValidity(uint8_t id, TickType_t validity);
+
+/**
+ * Registra a correcao aplicada as amostras novas de um tipo de grandeza.
+ * @param type Tipo da grandeza.
+ * @param correction Funcao de correcao ou NULL para remover.
+ */
+void SensorCache_SetCorrection(SensorType_e type, SensorCacheCorrection_t correction);
+
+/**
+ * Retorna os contadores de uso do cache de um canal.
+ * @param id Canal consultado.
+ * @param stats Estrutura de saida.
+ */
+void SensorCache_GetStats(uint8_t id, SensorCacheStats_t *stats);
+
+/** @brief Zera os contadores de hit/miss de todos os canais. */
+void SensorCache_ResetStats(void);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_CACHE_H_ */
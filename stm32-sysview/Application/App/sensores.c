@@ -11,13 +11,17 @@
 //==============================================================================
 
 #include "sensores.h"
+#include "sensor_cache.h"
+#include "app_timesync.h"
 #include "setup_hw.h"
 
 #include "hts221/hts221.h"
 #include "lps22hb/lps22hb.h"
 #include "lsm6dsl/lsm6dsl.h"
 #include "lis3mdl/lis3mdl.h"
+#include "vl53l0x/vl53l0x.h"
 
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -25,127 +29,212 @@
 // PRIVATE DEFINITIONS
 //==============================================================================
 
-//==============================================================================
-// PRIVATE TYPEDEFS
-//==============================================================================
+/** @brief Tempo de partida de um canal ligado so para uma leitura do shell */
+#define SENSORES_WAKEUP_MS		100
 
 //==============================================================================
-// PRIVATE VARIABLES
+// PRIVATE TYPEDEFS
 //==============================================================================
 
-//==============================================================================
-// PRIVATE FUNCTIONS
-//==============================================================================
+/** @brief Campo de Sensors_t preenchido por um canal */
+typedef struct
+{
+	SensorType_e type;
+	const char *driver;
+	uint16_t offset;
+	uint8_t size;       /* Tamanho de cada eixo no campo */
+} SensorsField_t;
+
+/** @brief Media/filtro interno aplicado no boot */
+typedef struct
+{
+	SensorType_e type;
+	const char *driver;
+	uint16_t level;
+} SensorsFilter_t;
 
 //==============================================================================
-// SOURCE CODE
+// PRIVATE VARIABLES
 //==============================================================================
 
-void Sensores_Read(Sensors_t *sensors)
+/** @brief Drivers da placa, na ordem de registro */
+static const SensorDriver_t * const boardDrivers[] =
 {
-	sensors->HTS221_temp =  HTS221_T_ReadTemp(HTS221_I2C_ADDRESS);
-	sensors->HTS221_humidity = HTS221_H_ReadHumidity(HTS221_I2C_ADDRESS);
-
-	sensors->LPS22HB_pressure = LPS22HB_P_ReadPressure(LPS22HB_I2C_ADDRESS);
-	sensors->LPS22HB_temp = LPS22HB_T_ReadTemp(LPS22HB_I2C_ADDRESS);
-
-	LSM6DSL_GyroReadXYZAngRate(sensors->LSM6DL_GyroDataXYXZ);
-	LSM6DSL_AccReadXYZ(sensors->LSM6DL_Acce);
-
-	LIS3MDL_MagReadXYZ(sensors->LIS3ML_MagXYZ);
-}
-
-void Sensor_Print(Sensors_t *sensors)
+	&HTS221_Driver,
+	&LPS22HB_Driver,
+	&LSM6DSL_Driver,
+	&LIS3MDL_Driver,
+	&VL53L0X_Driver,
+};
+
+/** @brief Na ordem de SensorsField_e */
+static const SensorsField_t sensorsFields[SENSORS_FIELD_MAX] =
 {
-	DBG("1-TEMPERATURE = %.2f C", sensors->HTS221_temp);
-	DBG("1-HUMIDITY = %2.f %%", sensors->HTS221_humidity);
-	DBG("2-Pressao: %.2f mBar", sensors->HTS221_humidity);
-	DBG("2-Tempetarura: %.2f C", sensors->LPS22HB_temp );
-	DBG("3-GYRO_X = %.2f", sensors->LSM6DL_GyroDataXYXZ[0]);
-	DBG("3-GYRO_Y = %.2f", sensors->LSM6DL_GyroDataXYXZ[1]);
-	DBG("3-GYRO_Z = %.2f",sensors->LSM6DL_GyroDataXYXZ[2]);
-	DBG("3-ACCELERO_X = %d", sensors->LSM6DL_Acce[0]);
-	DBG("3-ACCELERO_Y = %d", sensors->LSM6DL_Acce[1]);
-	DBG("3-ACCELERO_Z = %d", sensors->LSM6DL_Acce[2]);
-	DBG("4-MAGNETO_X = %d", sensors->LIS3ML_MagXYZ[0]);
-	DBG("4-MAGNETO_Y = %d", sensors->LIS3ML_MagXYZ[1]);
-	DBG("4-MAGNETO_Z = %d", sensors->LIS3ML_MagXYZ[2]);
-}
-
-void Sensor_Print_SerialPlot(Sensors_t *sensors) // total 13 signals
-{
-	DBG("%.2f,%.2f,"\
-			"%.2f,%.2f,"\
-			"%.2f,%.2f,%.2f,"\
-			"%d,%d,%d,"\
-			"%d,%d,%d",
-			sensors->HTS221_temp,            sensors->HTS221_humidity,
-			sensors->HTS221_humidity,        sensors->LPS22HB_temp,
-			sensors->LSM6DL_GyroDataXYXZ[0], sensors->LSM6DL_GyroDataXYXZ[1], sensors->LSM6DL_GyroDataXYXZ[2],
-			sensors->LSM6DL_Acce[0],         sensors->LSM6DL_Acce[1],         sensors->LSM6DL_Acce[2],
-			sensors->LIS3ML_MagXYZ[0],       sensors->LIS3ML_MagXYZ[1],       sensors->LIS3ML_MagXYZ[2]);
-}
+	{ SENSOR_TYPE_TEMPERATURE, "HTS221", offsetof(Sensors_t, HTS221_temp), sizeof(int16_t) },
+	{ SENSOR_TYPE_HUMIDITY, "HTS221", offsetof(Sensors_t, HTS221_humidity), sizeof(uint16_t) },
+	{ SENSOR_TYPE_PRESSURE, "LPS22HB", offsetof(Sensors_t, LPS22HB_pressure), sizeof(int32_t) },
+	{ SENSOR_TYPE_TEMPERATURE, "LPS22HB", offsetof(Sensors_t, LPS22HB_temp), sizeof(int16_t) },
+	{ SENSOR_TYPE_GYRO, "LSM6DSL", offsetof(Sensors_t, LSM6DL_GyroDataXYXZ), sizeof(int32_t) },
+	{ SENSOR_TYPE_ACCELERO, "LSM6DSL", offsetof(Sensors_t, LSM6DL_Acce), sizeof(int32_t) },
+	{ SENSOR_TYPE_MAGNETO, "LIS3MDL", offsetof(Sensors_t, LIS3ML_MagXYZ), sizeof(int32_t) },
+};
 
 /**
- * @brief  Test of LPS22HB pressure sensor.
+ * @brief A media fica no CI: HTS221 com 16 amostras de temperatura e 32 de
+ * umidade por saida (AV_CONF) e LPS22HB com o LPF de pressao em ODR/9.
  */
-void Pressure_Test(Sensors_t *sensors)
+static const SensorsFilter_t boardFilters[] =
 {
-	sensors->LPS22HB_pressure = LPS22HB_P_ReadPressure(LPS22HB_I2C_ADDRESS);
-	sensors->LPS22HB_temp = LPS22HB_T_ReadTemp(LPS22HB_I2C_ADDRESS);
+	{ SENSOR_TYPE_TEMPERATURE, "HTS221", 16 },
+	{ SENSOR_TYPE_HUMIDITY, "HTS221", 32 },
+	{ SENSOR_TYPE_PRESSURE, "LPS22HB", 9 },
+};
 
-	DBG("2-Pressao: %.2f mBar", sensors->HTS221_humidity);
-	DBG("2-Tempetarura: %.2f C", sensors->LPS22HB_temp );
-}
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
 
-/**
- * @brief  Test of HTS221 humidity sensor.
- */
-void Humidity_Test(Sensors_t *sensors)
-{
-	DBG("1-HUMIDITY = %2.f %%", sensors->HTS221_humidity);
-	sensors->HTS221_humidity = HTS221_H_ReadHumidity(HTS221_I2C_ADDRESS);
-}
+//==============================================================================
+// SOURCE CODE
+//==============================================================================
 
-/**
- * @brief  Test of HTS221 and LPS22HB temperature sensors.
- */
-void Temperature_Test(Sensors_t *sensors)
+void Sensores_Init(I2C_HandleTypeDef *hi2c)
 {
-	sensors->HTS221_temp =  HTS221_T_ReadTemp(HTS221_I2C_ADDRESS);
-	DBG("1-TEMPERATURE = %.2f C", sensors->HTS221_temp);
+	uint8_t i;
+
+	HTS221_attach(hi2c);
+	LPS22HB_attach(hi2c);
+	LSM6DSL_attach(hi2c);
+	LIS3MDL_attach(hi2c);
+	VL53L0X_attach(hi2c);
+
+	for (i = 0; i < (sizeof(boardDrivers) / sizeof(boardDrivers[0])); i++)
+	{
+		if (SensorDrv_Register(boardDrivers[i]) != HAL_OK)
+		{
+			DBG("Sensor %s nao encontrado", boardDrivers[i]->name);
+		}
+	}
+
+	for (i = 0; i < (sizeof(boardFilters) / sizeof(boardFilters[0])); i++)
+	{
+		SensorDrv_SetFilter(SensorDrv_Find(boardFilters[i].type, boardFilters[i].driver), boardFilters[i].level);
+	}
 }
 
-/**
- * @brief  Test of LSM6DSL accelerometer sensor.
- */
-void Accelero_Test(Sensors_t *sensors)
+void Sensores_Read(Sensors_t *sensors)
 {
-	LSM6DSL_AccReadXYZ(sensors->LSM6DL_Acce);
-	DBG("3-ACCELERO_X = %d", sensors->LSM6DL_Acce[0]);
-	DBG("3-ACCELERO_Y = %d", sensors->LSM6DL_Acce[1]);
-	DBG("3-ACCELERO_Z = %d", sensors->LSM6DL_Acce[2]);
+	const SensorsField_t *field;
+	int32_t value[SENSOR_DRV_MAX_AXES];
+	uint8_t *dst;
+	int16_t tmp;
+	uint8_t i, axis, id;
+
+	for (i = 0; i < (sizeof(sensorsFields) / sizeof(sensorsFields[0])); i++)
+	{
+		field = &sensorsFields[i];
+
+		id = SensorDrv_Find(field->type, field->driver);
+		if (SensorCache_ReadStamped(id, value, false, &sensors->stamp[i]) != HAL_OK)
+		{
+			continue;
+		}
+
+		dst = (uint8_t *) sensors + field->offset;
+		for (axis = 0; axis < SensorDrv_GetDesc(id)->axes; axis++)
+		{
+			if (field->size == sizeof(int16_t))
+			{
+				tmp = (int16_t) value[axis];
+				memcpy(dst + (axis * sizeof(int16_t)), &tmp, sizeof(int16_t));
+			}
+			else
+			{
+				memcpy(dst + (axis * sizeof(int32_t)), &value[axis], sizeof(int32_t));
+			}
+		}
+	}
 }
 
-/**
- * @brief  Test of LIS3MDL gyroscope sensor.
- */
-void Gyro_Test(Sensors_t *sensors)
+void Sensores_PrintChannel(uint8_t id, bool force)
 {
-	LSM6DSL_GyroReadXYZAngRate(sensors->LSM6DL_GyroDataXYXZ);
-	DBG("3-GYRO_X = %.2f", sensors->LSM6DL_GyroDataXYXZ[0]);
-	DBG("3-GYRO_Y = %.2f", sensors->LSM6DL_GyroDataXYXZ[1]);
-	DBG("3-GYRO_Z = %.2f",sensors->LSM6DL_GyroDataXYXZ[2]);
+	const SensorChannelDesc_t *desc = SensorDrv_GetDesc(id);
+	const SensorDriver_t *drv = SensorDrv_GetOwner(id);
+	int32_t value[SENSOR_DRV_MAX_AXES];
+	SensorDrvStatus_t status;
+	uint8_t handle = SENSOR_DRV_INVALID;
+	HAL_StatusTypeDef err;
+	uint64_t capture;
+	int64_t host;
+	uint32_t error;
+	float scale;
+
+	if (desc == NULL)
+	{
+		DBG("Canal %u: erro de leitura", id);
+		return;
+	}
+
+	/* Canal sem assinantes e sem conversao unica: liga so durante a leitura */
+	SensorDrv_GetStatus(id, &status);
+	if ((status.mode == SENSOR_MODE_OFF) && (drv->one_shot == NULL) && (desc->num_odrs > 0))
+	{
+		handle = SensorDrv_Subscribe(id, desc->odrs[0], SENSOR_POWER_NORMAL);
+		vTaskDelay(pdMS_TO_TICKS(SENSORES_WAKEUP_MS + (1000000UL / desc->odrs[0])));
+		force = true;
+	}
+
+	err = SensorCache_ReadStamped(id, value, force, &capture);
+
+	if (handle != SENSOR_DRV_INVALID)
+	{
+		SensorDrv_Unsubscribe(handle);
+	}
+
+	if (err != HAL_OK)
+	{
+		DBG("Canal %u: erro de leitura", id);
+		return;
+	}
+
+	scale = (float) desc->scale;
+
+	if (desc->axes == 1)
+	{
+		DBG("%s %s = %.3f %s", drv->name, desc->name, (float) value[0] / scale, desc->unit);
+	}
+	else
+	{
+		DBG("%s %s = %.3f %.3f %.3f %s", drv->name, desc->name,
+				(float) value[0] / scale, (float) value[1] / scale, (float) value[2] / scale, desc->unit);
+	}
+
+	/* Segundos com 6 casas: o printf da newlib-nano nao tem %llu */
+	if (AppTimeSync_ToHost(capture, &host, &error) == true)
+	{
+		DBG("  lido em %lu.%06lu s (PC %ld.%06lu s +- %lu us)", (unsigned long) (capture / 1000000ULL),
+				(unsigned long) (capture % 1000000ULL), (long) (host / 1000000LL),
+				(unsigned long) ((host < 0 ? -host : host) % 1000000LL), (unsigned long) error);
+	}
+	else
+	{
+		DBG("  lido em %lu.%06lu s", (unsigned long) (capture / 1000000ULL), (unsigned long) (capture % 1000000ULL));
+	}
 }
 
-/**
- * @brief  Test of LIS3MDL magnetometer sensor.
- */
-void Magneto_Test(Sensors_t *sensors)
+void Sensor_Print(Sensors_t *sensors)
 {
-	LIS3MDL_MagReadXYZ(sensors->LIS3ML_MagXYZ);
-
-	DBG("3-MAGNETO_X = %d", sensors->LIS3ML_MagXYZ[0]);
-	DBG("3-MAGNETO_Y = %d", sensors->LIS3ML_MagXYZ[1]);
-	DBG("3-MAGNETO_Z = %d", sensors->LIS3ML_MagXYZ[2]);
+	DBG("1-TEMPERATURE = %.2f C", SENSORS_TEMP_TO_FLOAT(sensors->HTS221_temp));
+	DBG("1-HUMIDITY = %.1f %%", SENSORS_HUMIDITY_TO_FLOAT(sensors->HTS221_humidity));
+	DBG("2-Pressao: %.2f mBar", SENSORS_PRESSURE_TO_FLOAT(sensors->LPS22HB_pressure));
+	DBG("2-Tempetarura: %.2f C", SENSORS_TEMP_TO_FLOAT(sensors->LPS22HB_temp) );
+	DBG("3-GYRO_X = %.2f mdps", SENSORS_GYRO_TO_FLOAT(sensors->LSM6DL_GyroDataXYXZ[0]));
+	DBG("3-GYRO_Y = %.2f mdps", SENSORS_GYRO_TO_FLOAT(sensors->LSM6DL_GyroDataXYXZ[1]));
+	DBG("3-GYRO_Z = %.2f mdps",SENSORS_GYRO_TO_FLOAT(sensors->LSM6DL_GyroDataXYXZ[2]));
+	DBG("3-ACCELERO_X = %.3f mg", SENSORS_ACCELERO_TO_FLOAT(sensors->LSM6DL_Acce[0]));
+	DBG("3-ACCELERO_Y = %.3f mg", SENSORS_ACCELERO_TO_FLOAT(sensors->LSM6DL_Acce[1]));
+	DBG("3-ACCELERO_Z = %.3f mg", SENSORS_ACCELERO_TO_FLOAT(sensors->LSM6DL_Acce[2]));
+	DBG("4-MAGNETO_X = %.3f mgauss", SENSORS_MAGNETO_TO_FLOAT(sensors->LIS3ML_MagXYZ[0]));
+	DBG("4-MAGNETO_Y = %.3f mgauss", SENSORS_MAGNETO_TO_FLOAT(sensors->LIS3ML_MagXYZ[1]));
+	DBG("4-MAGNETO_Z = %.3f mgauss", SENSORS_MAGNETO_TO_FLOAT(sensors->LIS3ML_MagXYZ[2]));
 }
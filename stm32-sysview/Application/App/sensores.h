@@ -15,37 +15,91 @@
 //==============================================================================
 
 #include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+
 #include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/*
+ * Escalas das grandezas de Sensors_t. As amostras sao inteiras do driver ate
+ * a aplicacao; float so deve aparecer na apresentacao (print/plot), usando as
+ * macros SENSORS_xxx_TO_FLOAT.
+ */
+#define SENSORS_TEMP_SCALE          100     /**< LSB por C */
+#define SENSORS_HUMIDITY_SCALE      10      /**< LSB por %RH */
+#define SENSORS_PRESSURE_SCALE      4096    /**< LSB por hPa */
+#define SENSORS_GYRO_SCALE          100     /**< LSB por mdps */
+#define SENSORS_ACCELERO_SCALE      1000    /**< LSB por mg */
+#define SENSORS_MAGNETO_SCALE       1000    /**< LSB por mgauss */
+
+#define SENSORS_TEMP_TO_FLOAT(x)        ((float)(x) / SENSORS_TEMP_SCALE)
+#define SENSORS_HUMIDITY_TO_FLOAT(x)    ((float)(x) / SENSORS_HUMIDITY_SCALE)
+#define SENSORS_PRESSURE_TO_FLOAT(x)    ((float)(x) / SENSORS_PRESSURE_SCALE)
+#define SENSORS_GYRO_TO_FLOAT(x)        ((float)(x) / SENSORS_GYRO_SCALE)
+#define SENSORS_ACCELERO_TO_FLOAT(x)    ((float)(x) / SENSORS_ACCELERO_SCALE)
+#define SENSORS_MAGNETO_TO_FLOAT(x)     ((float)(x) / SENSORS_MAGNETO_SCALE)
 
 //==============================================================================
 // PUBLIC TYPEDEFS
 //==============================================================================
 
+/** @brief Campos de Sensors_t, indice de Sensors_t.stamp */
+typedef enum
+{
+	SENSORS_FIELD_HTS221_TEMP = 0,
+	SENSORS_FIELD_HTS221_HUMIDITY,
+	SENSORS_FIELD_LPS22HB_PRESSURE,
+	SENSORS_FIELD_LPS22HB_TEMP,
+	SENSORS_FIELD_GYRO,
+	SENSORS_FIELD_ACCELERO,
+	SENSORS_FIELD_MAGNETO,
+	SENSORS_FIELD_MAX
+} SensorsField_e;
+
 typedef struct
 {
-	float HTS221_temp;
-	float HTS221_humidity;
-	float LPS22HB_pressure;
-	float LPS22HB_temp;
-	float LSM6DL_GyroDataXYXZ[3];
-	int16_t LSM6DL_Acce[3];
-	int16_t LIS3ML_MagXYZ[3];
+	int16_t HTS221_temp;            /**< 0.01 C */
+	uint16_t HTS221_humidity;       /**< 0.1 %RH */
+	int32_t LPS22HB_pressure;       /**< 1/4096 hPa */
+	int16_t LPS22HB_temp;           /**< 0.01 C */
+	int32_t LSM6DL_GyroDataXYXZ[3]; /**< 0.01 mdps */
+	int32_t LSM6DL_Acce[3];         /**< ug */
+	int32_t LIS3ML_MagXYZ[3];       /**< ugauss */
+	uint64_t stamp[SENSORS_FIELD_MAX]; /**< Timebase_Us da leitura de cada campo (0 = nao lido) */
 }Sensors_t;
 
 //==============================================================================
 // PUBLIC FUNCTIONS
 //==============================================================================
 
+/**
+ * Registra no registro de drivers todos os sensores da placa. CIs que nao
+ * respondem ao WHO_AM_I ficam de fora. Os CIs ficam desligados ate a
+ * primeira assinatura e a media interna recebe a configuracao da placa.
+ * @param hi2c Barramento onde os sensores estao ligados.
+ */
+void Sensores_Init(I2C_HandleTypeDef *hi2c);
+
+/**
+ * Le os campos de Sensors_t pelo cache. Cada campo recebe o instante em que
+ * a amostra foi lida do sensor, que app_timesync converte para o relogio
+ * do PC.
+ * @param sensors Estrutura de saida; campos com erro de leitura ficam como estavam.
+ */
 void Sensores_Read(Sensors_t *sensors);
 void Sensor_Print(Sensors_t *sensors);
-void Sensor_Print_SerialPlot(Sensors_t *sensors);
-
-void Temperature_Test(Sensors_t *sensors);
-void Humidity_Test(Sensors_t *sensors);
-void Pressure_Test(Sensors_t *sensors);
-void Gyro_Test(Sensors_t *sensors);
-void Magneto_Test(Sensors_t *sensors);
-void Accelero_Test(Sensors_t *sensors);
+
+/**
+ * Le um canal pelo cache e imprime o valor na unidade do canal. Um canal
+ * desligado e sem conversao unica e ligado apenas durante a leitura.
+ * @param id Indice do canal no registro de drivers.
+ * @param force true para ignorar o cache.
+ */
+void Sensores_PrintChannel(uint8_t id, bool force);
 
 
 #endif /* _APP_SENSORS_H_ */
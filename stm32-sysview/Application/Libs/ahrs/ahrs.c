@@ -0,0 +1,202 @@
+/**
+ * @file    ahrs.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.1
+ * @brief   Filtro de orientacao (AHRS) de 9 eixos baseado no filtro de Mahony
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "ahrs.h"
+
+#include <math.h>
+#include <stddef.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define AHRS_RAD_TO_DEG		57.29577951f
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+typedef union
+{
+	float f;
+	uint32_t u;
+} AhrsFloatBits_t;
+
+//==============================================================================
+// SOURCE CODE
+//==============================================================================
+
+float AHRS_VerticalAccel(const Ahrs_t *ahrs, const float acc[3], float per_g)
+{
+	float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+	float up;
+
+	/* Vertical da Terra no referencial da placa: terceira linha da matriz de rotacao */
+	up = (acc[0] * 2.0f * ((q1 * q3) - (q0 * q2))) + (acc[1] * 2.0f * ((q0 * q1) + (q2 * q3)))
+			+ (acc[2] * ((q0 * q0) - (q1 * q1) - (q2 * q2) + (q3 * q3)));
+
+	return ((up / per_g) - 1.0f) * AHRS_GRAVITY;
+}
+
+float AHRS_InvSqrt(float x)
+{
+	AhrsFloatBits_t conv;
+	float y;
+
+	/* Constantes otimizadas para uma unica iteracao (Moroz et al., 2018) */
+	conv.f = x;
+	conv.u = 0x5F1FFFF9UL - (conv.u >> 1);
+	y = conv.f;
+
+	return y * 0.703952253f * (2.38924456f - (x * y * y));
+}
+
+void AHRS_Init(Ahrs_t *ahrs, float sample_hz, float kp, float ki)
+{
+	ahrs->q[0] = 1.0f;
+	ahrs->q[1] = 0.0f;
+	ahrs->q[2] = 0.0f;
+	ahrs->q[3] = 0.0f;
+
+	ahrs->bias[0] = 0.0f;
+	ahrs->bias[1] = 0.0f;
+	ahrs->bias[2] = 0.0f;
+
+	ahrs->kp = kp;
+	ahrs->ki = ki;
+	ahrs->dt = 1.0f / sample_hz;
+}
+
+void AHRS_SetPeriod(Ahrs_t *ahrs, float dt)
+{
+	ahrs->dt = dt;
+}
+
+void AHRS_Update(Ahrs_t *ahrs, const float gyro[3], const float acc[3], const float mag[3])
+{
+	float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+	float gx = gyro[0], gy = gyro[1], gz = gyro[2];
+	float ax = acc[0], ay = acc[1], az = acc[2];
+	float mx, my, mz;
+	float q0q0, q0q1, q0q2, q0q3, q1q1, q1q2, q1q3, q2q2, q2q3, q3q3;
+	float hx, hy, bx, bz, norm;
+	float halfvx, halfvy, halfvz;
+	float halfwx, halfwy, halfwz;
+	float halfex, halfey, halfez;
+	float qa, qb, qc;
+
+	norm = (ax * ax) + (ay * ay) + (az * az);
+
+	/* Sem referencia de gravidade so integra o giroscopio */
+	if (norm > 0.0f)
+	{
+		norm = AHRS_InvSqrt(norm);
+		ax *= norm;
+		ay *= norm;
+		az *= norm;
+
+		q0q0 = q0 * q0;
+		q0q1 = q0 * q1;
+		q0q2 = q0 * q2;
+		q0q3 = q0 * q3;
+		q1q1 = q1 * q1;
+		q1q2 = q1 * q2;
+		q1q3 = q1 * q3;
+		q2q2 = q2 * q2;
+		q2q3 = q2 * q3;
+		q3q3 = q3 * q3;
+
+		/* Direcao estimada da gravidade */
+		halfvx = q1q3 - q0q2;
+		halfvy = q0q1 + q2q3;
+		halfvz = q0q0 - 0.5f + q3q3;
+
+		/* Erro = produto vetorial entre medido e estimado */
+		halfex = (ay * halfvz) - (az * halfvy);
+		halfey = (az * halfvx) - (ax * halfvz);
+		halfez = (ax * halfvy) - (ay * halfvx);
+
+		norm = (mag != NULL) ? ((mag[0] * mag[0]) + (mag[1] * mag[1]) + (mag[2] * mag[2])) : 0.0f;
+
+		if (norm > 0.0f)
+		{
+			norm = AHRS_InvSqrt(norm);
+			mx = mag[0] * norm;
+			my = mag[1] * norm;
+			mz = mag[2] * norm;
+
+			/* Campo magnetico no referencial da terra, projetado no plano x-z */
+			hx = 2.0f * ((mx * (0.5f - q2q2 - q3q3)) + (my * (q1q2 - q0q3)) + (mz * (q1q3 + q0q2)));
+			hy = 2.0f * ((mx * (q1q2 + q0q3)) + (my * (0.5f - q1q1 - q3q3)) + (mz * (q2q3 - q0q1)));
+			bz = 2.0f * ((mx * (q1q3 - q0q2)) + (my * (q2q3 + q0q1)) + (mz * (0.5f - q1q1 - q2q2)));
+			norm = (hx * hx) + (hy * hy);
+			bx = norm * AHRS_InvSqrt(norm + 1e-12f);
+
+			/* Direcao estimada do campo magnetico */
+			halfwx = (bx * (0.5f - q2q2 - q3q3)) + (bz * (q1q3 - q0q2));
+			halfwy = (bx * (q1q2 - q0q3)) + (bz * (q0q1 + q2q3));
+			halfwz = (bx * (q0q2 + q1q3)) + (bz * (0.5f - q1q1 - q2q2));
+
+			halfex += (my * halfwz) - (mz * halfwy);
+			halfey += (mz * halfwx) - (mx * halfwz);
+			halfez += (mx * halfwy) - (my * halfwx);
+		}
+
+		/* Termo integral: converge para o bias do giroscopio (com sinal trocado) */
+		if (ahrs->ki > 0.0f)
+		{
+			ahrs->bias[0] -= ahrs->ki * halfex * ahrs->dt;
+			ahrs->bias[1] -= ahrs->ki * halfey * ahrs->dt;
+			ahrs->bias[2] -= ahrs->ki * halfez * ahrs->dt;
+		}
+
+		gx += ahrs->kp * halfex;
+		gy += ahrs->kp * halfey;
+		gz += ahrs->kp * halfez;
+	}
+
+	gx -= ahrs->bias[0];
+	gy -= ahrs->bias[1];
+	gz -= ahrs->bias[2];
+
+	/* Integra a taxa de variacao do quaternion */
+	gx *= 0.5f * ahrs->dt;
+	gy *= 0.5f * ahrs->dt;
+	gz *= 0.5f * ahrs->dt;
+
+	qa = q0;
+	qb = q1;
+	qc = q2;
+	q0 += (-qb * gx) - (qc * gy) - (q3 * gz);
+	q1 += (qa * gx) + (qc * gz) - (q3 * gy);
+	q2 += (qa * gy) - (qb * gz) + (q3 * gx);
+	q3 += (qa * gz) + (qb * gy) - (qc * gx);
+
+	norm = AHRS_InvSqrt((q0 * q0) + (q1 * q1) + (q2 * q2) + (q3 * q3));
+	ahrs->q[0] = q0 * norm;
+	ahrs->q[1] = q1 * norm;
+	ahrs->q[2] = q2 * norm;
+	ahrs->q[3] = q3 * norm;
+}
+
+void AHRS_GetEuler(const Ahrs_t *ahrs, AhrsEuler_t *euler)
+{
+	float q0 = ahrs->q[0], q1 = ahrs->q[1], q2 = ahrs->q[2], q3 = ahrs->q[3];
+	float sinp;
+
+	sinp = 2.0f * ((q0 * q2) - (q1 * q3));
+	sinp = (sinp > 1.0f) ? 1.0f : (sinp < -1.0f) ? -1.0f : sinp;
+
+	euler->roll = atan2f((q0 * q1) + (q2 * q3), 0.5f - (q1 * q1) - (q2 * q2)) * AHRS_RAD_TO_DEG;
+	euler->pitch = asinf(sinp) * AHRS_RAD_TO_DEG;
+	euler->yaw = atan2f((q1 * q2) + (q0 * q3), 0.5f - (q2 * q2) - (q3 * q3)) * AHRS_RAD_TO_DEG;
+}
@@ -0,0 +1,128 @@
+/**
+ * @file    ahrs.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.1
+ * @brief   Filtro de orientacao (AHRS) de 9 eixos baseado no filtro de Mahony
+ * @details
+ * Funde giroscopio, acelerometro e magnetometro em um quaternion. O termo
+ * integral do filtro converge para o bias do giroscopio, que fica disponivel
+ * em Ahrs_t::bias. A lib usa apenas float e nao depende do HAL, podendo ser
+ * compilada tambem no PC.
+ *
+ * Convencoes:
+ *  - giroscopio em rad/s;
+ *  - acelerometro e magnetometro em qualquer unidade (sao normalizados);
+ *  - angulos de Euler em graus, sequencia ZYX (yaw, pitch, roll).
+ */
+
+#ifndef _AHRS_H_
+#define _AHRS_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Ganho proporcional padrao (2 * Kp do artigo de Mahony) */
+#define AHRS_DEFAULT_KP		1.0f
+
+/** @brief Ganho integral padrao, controla a velocidade de estimacao do bias */
+#define AHRS_DEFAULT_KI		0.02f
+
+/** @brief Gravidade padrao em m/s2 */
+#define AHRS_GRAVITY		9.80665f
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Angulos de Euler em graus */
+typedef struct
+{
+	float roll;
+	float pitch;
+	float yaw;
+} AhrsEuler_t;
+
+/** @brief Estado do filtro */
+typedef struct
+{
+	float q[4];     /**< Quaternion w, x, y, z */
+	float bias[3];  /**< Bias estimado do giroscopio em rad/s */
+	float kp;       /**< Ganho proporcional */
+	float ki;       /**< Ganho integral (0 desliga a estimacao do bias) */
+	float dt;       /**< Periodo de amostragem em s */
+} Ahrs_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Inicializa o filtro com quaternion identidade e bias zerado.
+ * @param ahrs Estado do filtro.
+ * @param sample_hz Taxa de atualizacao em Hz.
+ * @param kp Ganho proporcional.
+ * @param ki Ganho integral.
+ */
+void AHRS_Init(Ahrs_t *ahrs, float sample_hz, float kp, float ki);
+
+/**
+ * Altera o periodo de amostragem sem perder o estado do filtro.
+ * @param ahrs Estado do filtro.
+ * @param dt Periodo em s.
+ */
+void AHRS_SetPeriod(Ahrs_t *ahrs, float dt);
+
+/**
+ * Executa uma iteracao do filtro.
+ * @param ahrs Estado do filtro.
+ * @param gyro Velocidade angular x, y, z em rad/s.
+ * @param acc Aceleracao x, y, z.
+ * @param mag Campo magnetico x, y, z ou NULL para operar com 6 eixos.
+ */
+void AHRS_Update(Ahrs_t *ahrs, const float gyro[3], const float acc[3], const float mag[3]);
+
+/**
+ * Converte o quaternion atual em angulos de Euler. Nao e chamada dentro de
+ * AHRS_Update para nao pagar atan2f/asinf a cada amostra.
+ * @param ahrs Estado do filtro.
+ * @param euler Angulos de saida em graus.
+ */
+void AHRS_GetEuler(const Ahrs_t *ahrs, AhrsEuler_t *euler);
+
+/**
+ * Aceleracao ao longo da vertical da Terra, sem a gravidade, pela orientacao
+ * atual. Parada em qualquer posicao a placa le 1 g e o resultado e ~0.
+ * @param ahrs Estado do filtro.
+ * @param acc Aceleracao x, y, z na unidade do sensor.
+ * @param per_g Valor de acc que corresponde a 1 g (ex.: 1000000 para ug).
+ * @return Aceleracao vertical em m/s2, positiva para cima.
+ */
+float AHRS_VerticalAccel(const Ahrs_t *ahrs, const float acc[3], float per_g);
+
+/**
+ * Raiz quadrada inversa rapida: estimativa inicial por manipulacao de bits e
+ * uma iteracao de Newton-Raphson. Erro relativo maximo menor que 0.1%.
+ * @param x Valor positivo.
+ * @return Aproximacao de 1/sqrt(x).
+ */
+float AHRS_InvSqrt(float x);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AHRS_H_ */
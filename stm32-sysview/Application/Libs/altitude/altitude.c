@@ -0,0 +1,89 @@
+/**
+ * @file    altitude.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Altitude barometrica e velocidade vertical por filtro complementar
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "altitude.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Atmosfera padrao: h = 44330.8 * (1 - (p/p0)^(1/5.255)) */
+#define ALT_SCALE_M				44330.8f
+#define ALT_EXPONENT			0.190263f
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+float Alt_FromPressure(float p_hpa, float p0_hpa)
+{
+	return ALT_SCALE_M * (1.0f - powf(p_hpa / p0_hpa, ALT_EXPONENT));
+}
+
+float Alt_Reference(float p_hpa, float h_m)
+{
+	return p_hpa / powf(1.0f - h_m / ALT_SCALE_M, 1.0f / ALT_EXPONENT);
+}
+
+bool Alt_Init(Alt_t *alt, float tau_s)
+{
+	if (tau_s <= 0.0f)
+	{
+		return false;
+	}
+
+	memset(alt, 0, sizeof(Alt_t));
+	alt->k1 = 3.0f / tau_s;
+	alt->k2 = 3.0f / (tau_s * tau_s);
+	alt->k3 = 1.0f / (tau_s * tau_s * tau_s);
+
+	return true;
+}
+
+void Alt_Predict(Alt_t *alt, float dv, float dp, float dt)
+{
+	if (alt->started == false)
+	{
+		return;
+	}
+
+	alt->h += alt->v * dt + dp - 0.5f * alt->bias * dt * dt;
+	alt->v += dv - alt->bias * dt;
+}
+
+void Alt_Correct(Alt_t *alt, float h_m, float age_s, float dt)
+{
+	float e;
+
+	if (alt->started == false)
+	{
+		alt->h = h_m;
+		alt->started = true;
+		return;
+	}
+
+	/* Erro contra a altitude prevista no instante da medida */
+	e = h_m - (alt->h - alt->v * age_s);
+
+	/* Correcoes muito espacadas: ganho limitado para o passo continuar estavel */
+	if (alt->k1 * dt > 1.0f)
+	{
+		dt = 1.0f / alt->k1;
+	}
+
+	alt->h += alt->k1 * dt * e;
+	alt->v += alt->k2 * dt * e;
+	alt->bias -= alt->k3 * dt * e;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file    altitude.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Altitude barometrica e velocidade vertical por filtro complementar
+ * @details
+ * O barometro da a altitude sem deriva mas com ruido de alguns centimetros
+ * e atraso do filtro passa-baixas; o acelerometro (ja no eixo vertical da
+ * Terra, sem a gravidade) responde rapido mas integra deriva. O filtro
+ * complementar de terceira ordem junta os dois: estados altitude h,
+ * velocidade v e bias b do acelerometro, com ganhos 3/tau, 3/tau^2 e
+ * 1/tau^3 (os tres polos em -1/tau). Abaixo de 1/tau a altitude segue o
+ * barometro; acima, o acelerometro.
+ *
+ * A aceleracao entra ja integrada entre duas correcoes (dv = soma de a*dt e
+ * dp = soma de dv*dt + a*dt^2/2), porque o barometro chega em lotes do
+ * FIFO. A correcao aceita uma medida atrasada (a media do lote vale no meio
+ * dele): o erro e medido contra a altitude prevista naquele instante.
+ *
+ * Sem acelerometro (dv = dp = 0) o filtro vira um alfa-beta so com o
+ * barometro. C puro, sem HAL: roda no alvo e no PC (Tools/altitude).
+ */
+
+#ifndef _ALTITUDE_H_
+#define _ALTITUDE_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Pressao padrao ao nivel do mar (hPa) */
+#define ALT_STD_PRESSURE_HPA		1013.25f
+
+/** @brief Constante de tempo padrao do filtro (s) */
+#define ALT_DEF_TAU_S				1.5f
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Estado do filtro */
+typedef struct
+{
+	float h;                /**< Altitude (m) */
+	float v;                /**< Velocidade vertical (m/s, positiva subindo) */
+	float bias;             /**< Bias da aceleracao vertical (m/s2) */
+	float k1, k2, k3;
+	bool started;           /**< A primeira medida inicia h */
+} Alt_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Altitude pela atmosfera padrao.
+ * @param p_hpa Pressao medida.
+ * @param p0_hpa Pressao de referencia (altitude zero).
+ * @return Altitude em m.
+ */
+float Alt_FromPressure(float p_hpa, float p0_hpa);
+
+/**
+ * Pressao de referencia que poe a altitude atual em h_m.
+ * @param p_hpa Pressao medida.
+ * @param h_m Altitude desejada.
+ * @return Pressao de referencia em hPa.
+ */
+float Alt_Reference(float p_hpa, float h_m);
+
+/**
+ * Inicia o filtro (espera a primeira medida).
+ * @param alt Estado.
+ * @param tau_s Constante de tempo, maior que zero.
+ * @return false se tau_s for invalido.
+ */
+bool Alt_Init(Alt_t *alt, float tau_s);
+
+/**
+ * Avanca o filtro com a aceleracao vertical integrada.
+ * @param alt Estado.
+ * @param dv Soma de a*dt no intervalo (m/s).
+ * @param dp Soma de dv*dt + a*dt^2/2 no intervalo (m), com dv partindo de zero.
+ * @param dt Duracao do intervalo (s).
+ */
+void Alt_Predict(Alt_t *alt, float dv, float dp, float dt);
+
+/**
+ * Corrige com uma altitude do barometro.
+ * @param alt Estado.
+ * @param h_m Altitude medida.
+ * @param age_s Quanto tempo antes do estado atual a medida vale.
+ * @param dt Intervalo desde a correcao anterior (s).
+ */
+void Alt_Correct(Alt_t *alt, float h_m, float age_s, float dt);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ALTITUDE_H_ */
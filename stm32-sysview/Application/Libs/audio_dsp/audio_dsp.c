@@ -0,0 +1,254 @@
+/**
+ * @file    audio_dsp.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Estagios de processamento de audio PCM em blocos
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "audio_dsp.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Polo da remocao de DC: corte perto de 8 Hz a 16 kHz */
+#define AUDIO_DSP_DC_POLE			0.995f
+
+/** @brief Ruido de fundo: desce rapido, sobe devagar (fracao por bloco) */
+#define AUDIO_DSP_NOISE_FALL		0.2f
+#define AUDIO_DSP_NOISE_RISE		0.002f
+
+/** @brief Fundo de escala do PCM */
+#define AUDIO_DSP_FULL_SCALE		32768.0f
+
+/** @brief Evita log de zero */
+#define AUDIO_DSP_EPSILON			1e-12f
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Potencia relativa em dB com piso.
+ * @param ratio Potencia relativa ao fundo de escala.
+ */
+static float AudioDsp_Db(float ratio);
+
+/** @brief Atualiza o ruido de fundo e o estado de atividade. */
+static void AudioDsp_Vad(AudioDsp_t *dsp);
+
+/** @brief Calcula o espectro do quadro cheio. */
+static void AudioDsp_Spectrum(AudioDsp_t *dsp);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static float AudioDsp_Db(float ratio)
+{
+	float db = 10.0f * log10f(ratio + AUDIO_DSP_EPSILON);
+
+	return (db < AUDIO_DSP_MIN_DB) ? AUDIO_DSP_MIN_DB : db;
+}
+
+static void AudioDsp_Vad(AudioDsp_t *dsp)
+{
+	AudioDspResult_t *res = &dsp->res;
+
+	if (dsp->noise_init == false)
+	{
+		res->noise_db = res->level_db;
+		dsp->noise_init = true;
+	}
+	else if (res->level_db < res->noise_db)
+	{
+		res->noise_db += AUDIO_DSP_NOISE_FALL * (res->level_db - res->noise_db);
+	}
+	else
+	{
+		/* Fala continua sobe o piso muito devagar */
+		res->noise_db += AUDIO_DSP_NOISE_RISE * (res->level_db - res->noise_db);
+	}
+
+	if ((res->level_db > res->noise_db + dsp->margin_db) && (res->level_db > dsp->min_db))
+	{
+		dsp->hang = dsp->hangover + 1;
+	}
+
+	if (dsp->hang > 0)
+	{
+		dsp->hang--;
+		res->active = true;
+		res->active_blocks++;
+	}
+	else
+	{
+		res->active = false;
+	}
+}
+
+static void AudioDsp_Spectrum(AudioDsp_t *dsp)
+{
+	uint16_t bins = dsp->plan.n / 2;
+	uint16_t k, peak = 1;
+	float a, b, c, delta;
+
+	Fft_Real(&dsp->plan, dsp->frame);
+	Fft_Power(&dsp->plan, dsp->frame, dsp->frame);
+
+	for (k = 0; k < bins; k++)
+	{
+		dsp->spectrum[k] = AudioDsp_Db(dsp->frame[k] / dsp->norm);
+		if ((k > 0) && (dsp->spectrum[k] > dsp->spectrum[peak]))
+		{
+			peak = k;
+		}
+	}
+
+	/* Interpolacao parabolica entre os vizinhos do pico */
+	delta = 0.0f;
+	if (peak + 1 < bins)
+	{
+		a = dsp->spectrum[peak - 1];
+		b = dsp->spectrum[peak];
+		c = dsp->spectrum[peak + 1];
+		if ((a - 2.0f * b + c) < 0.0f)
+		{
+			delta = 0.5f * (a - c) / (a - 2.0f * b + c);
+		}
+	}
+
+	dsp->res.peak_hz = ((float) peak + delta) * (float) dsp->rate_hz / (float) dsp->plan.n;
+	dsp->res.peak_bin_db = dsp->spectrum[peak];
+	dsp->res.spectra++;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void AudioDsp_FromDfsdm(const int32_t *in, int16_t *out, uint32_t count, uint8_t shift)
+{
+	int32_t v;
+
+	while (count--)
+	{
+		/* Bits [7:0] trazem o canal da conversao, nao dado */
+		v = (*in++ >> 8) >> shift;
+		*out++ = (int16_t) ((v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v));
+	}
+}
+
+bool AudioDsp_Init(AudioDsp_t *dsp, uint32_t rate_hz, uint16_t fft_size, float *work)
+{
+	float gain;
+
+	memset(dsp, 0, sizeof(AudioDsp_t));
+
+	if (Fft_Init(&dsp->plan, fft_size, work) == false)
+	{
+		return false;
+	}
+
+	dsp->rate_hz = rate_hz;
+	dsp->margin_db = AUDIO_DSP_DEF_MARGIN_DB;
+	dsp->min_db = AUDIO_DSP_DEF_MIN_DB;
+	dsp->hangover = AUDIO_DSP_DEF_HANGOVER;
+	dsp->fft_gated = true;
+
+	dsp->window = work + fft_size;
+	dsp->frame = dsp->window + fft_size;
+	dsp->spectrum = dsp->frame + fft_size;
+
+	/* Senoide de amplitude 1 aparece com |X| = n * ganho / 2 */
+	gain = Fft_Window(FFT_WINDOW_HANN, dsp->window, fft_size);
+	dsp->norm = 0.25f * (float) fft_size * (float) fft_size * gain * gain;
+
+	AudioDsp_Reset(dsp);
+
+	return true;
+}
+
+void AudioDsp_Reset(AudioDsp_t *dsp)
+{
+	uint16_t k;
+
+	dsp->dc_x = 0.0f;
+	dsp->dc_y = 0.0f;
+	dsp->noise_init = false;
+	dsp->hang = 0;
+	dsp->fill = 0;
+	memset(&dsp->res, 0, sizeof(AudioDspResult_t));
+	dsp->res.level_db = AUDIO_DSP_MIN_DB;
+	dsp->res.peak_db = AUDIO_DSP_MIN_DB;
+	dsp->res.noise_db = AUDIO_DSP_MIN_DB;
+
+	for (k = 0; k < dsp->plan.n / 2; k++)
+	{
+		dsp->spectrum[k] = AUDIO_DSP_MIN_DB;
+	}
+}
+
+bool AudioDsp_Process(AudioDsp_t *dsp, int16_t *pcm, uint32_t count)
+{
+	AudioDspResult_t *res = &dsp->res;
+	float x, y, sum = 0.0f, peak = 0.0f;
+	bool ready = false;
+	uint32_t i;
+
+	if (count == 0)
+	{
+		return false;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		/* y[n] = x[n] - x[n-1] + p * y[n-1] */
+		x = (float) pcm[i];
+		y = x - dsp->dc_x + AUDIO_DSP_DC_POLE * dsp->dc_y;
+		dsp->dc_x = x;
+		dsp->dc_y = y;
+
+		y = (y > 32767.0f) ? 32767.0f : ((y < -32768.0f) ? -32768.0f : y);
+		pcm[i] = (int16_t) y;
+
+		sum += y * y;
+		if (fabsf(y) > peak)
+		{
+			peak = fabsf(y);
+		}
+	}
+
+	res->level_db = AudioDsp_Db(sum / ((float) count * AUDIO_DSP_FULL_SCALE * AUDIO_DSP_FULL_SCALE));
+	res->peak_db = AudioDsp_Db((peak * peak) / (AUDIO_DSP_FULL_SCALE * AUDIO_DSP_FULL_SCALE));
+	res->blocks++;
+
+	AudioDsp_Vad(dsp);
+
+	/* Quadros sem sobreposicao; silencio descarta o quadro inteiro */
+	for (i = 0; i < count; i++)
+	{
+		dsp->frame[dsp->fill] = dsp->window[dsp->fill] * ((float) pcm[i] / AUDIO_DSP_FULL_SCALE);
+		dsp->fill++;
+
+		if (dsp->fill == dsp->plan.n)
+		{
+			dsp->fill = 0;
+			if ((dsp->fft_gated == false) || (res->active == true))
+			{
+				AudioDsp_Spectrum(dsp);
+				ready = true;
+			}
+		}
+	}
+
+	return ready;
+}
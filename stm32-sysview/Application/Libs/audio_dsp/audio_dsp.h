@@ -0,0 +1,137 @@
+/**
+ * @file    audio_dsp.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Estagios de processamento de audio PCM em blocos
+ * @details
+ * Cada bloco de PCM 16 bits passa por:
+ *
+ *   remocao de DC  -> passa-altas de um polo (o microfone MEMS tem offset)
+ *   nivel          -> RMS e pico do bloco em dBFS
+ *   atividade      -> nivel acima do ruido de fundo estimado mais uma margem,
+ *                     com retencao de alguns blocos para nao cortar palavras
+ *   espectro       -> quadros de fft_size amostras com janela de Hann, em
+ *                     dBFS por bin e frequencia de pico; opcionalmente so
+ *                     com atividade, para nao gastar CPU com silencio
+ *
+ * Nao depende do HAL nem do FreeRTOS: o mesmo codigo roda na task de audio
+ * e no PC (Tools/audio) com PCM gravado. Os buffers de trabalho vem do
+ * chamador (AUDIO_DSP_WORK_SIZE floats).
+ */
+
+#ifndef _AUDIO_DSP_H_
+#define _AUDIO_DSP_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "fft/fft.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Floats de trabalho: twiddles, janela, quadro e espectro */
+#define AUDIO_DSP_WORK_SIZE(n)		(3 * (n) + (n) / 2)
+
+/** @brief Piso dos niveis (silencio digital) */
+#define AUDIO_DSP_MIN_DB			(-120.0f)
+
+#define AUDIO_DSP_DEF_MARGIN_DB		10.0f
+#define AUDIO_DSP_DEF_MIN_DB		(-70.0f)
+#define AUDIO_DSP_DEF_HANGOVER		20
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Resultados acumulados */
+typedef struct
+{
+	float level_db;         /**< RMS do ultimo bloco (dBFS) */
+	float peak_db;          /**< Pico do ultimo bloco (dBFS) */
+	float noise_db;         /**< Ruido de fundo estimado (dBFS) */
+	bool active;            /**< Atividade no ultimo bloco */
+	uint32_t blocks;        /**< Blocos processados */
+	uint32_t active_blocks; /**< Blocos com atividade */
+	uint32_t spectra;       /**< Espectros calculados */
+	float peak_hz;          /**< Frequencia do maior bin do ultimo espectro */
+	float peak_bin_db;      /**< Nivel desse bin (dBFS de senoide) */
+} AudioDspResult_t;
+
+/** @brief Configuracao e estado dos estagios */
+typedef struct
+{
+	/* Configuracao */
+	uint32_t rate_hz;
+	float margin_db;        /**< Atividade: acima do ruido por esta margem */
+	float min_db;           /**< Atividade: e acima deste nivel absoluto */
+	uint16_t hangover;      /**< Blocos mantidos ativos depois do ultimo */
+	bool fft_gated;         /**< Espectro so com atividade */
+
+	/* Estado */
+	float dc_x;
+	float dc_y;
+	bool noise_init;
+	uint16_t hang;
+	FftPlan_t plan;
+	float *window;
+	float *frame;
+	float *spectrum;        /**< fft_size / 2 bins em dBFS */
+	float norm;             /**< Potencia de uma senoide de fundo de escala */
+	uint16_t fill;
+
+	AudioDspResult_t res;
+} AudioDsp_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Palavras do registrador de dados do DFSDM (24 bits em [31:8]) para PCM.
+ * @param in Palavras copiadas pelo DMA.
+ * @param out PCM saturado em 16 bits.
+ * @param count Amostras.
+ * @param shift Deslocamento extra para caber o ganho do filtro sinc em 16 bits.
+ */
+void AudioDsp_FromDfsdm(const int32_t *in, int16_t *out, uint32_t count, uint8_t shift);
+
+/**
+ * Configuracao padrao e estado zerado.
+ * @param dsp Estagios.
+ * @param rate_hz Taxa do PCM.
+ * @param fft_size Pontos do espectro (potencia de 2, ate FFT_MAX_SIZE).
+ * @param work AUDIO_DSP_WORK_SIZE(fft_size) floats.
+ * @return false se fft_size for invalido.
+ */
+bool AudioDsp_Init(AudioDsp_t *dsp, uint32_t rate_hz, uint16_t fft_size, float *work);
+
+/** @brief Zera o estado, mantendo a configuracao. */
+void AudioDsp_Reset(AudioDsp_t *dsp);
+
+/**
+ * Processa um bloco.
+ * @param dsp Estagios.
+ * @param pcm Amostras; a remocao de DC e feita no lugar.
+ * @param count Amostras.
+ * @return true se um novo espectro ficou pronto.
+ */
+bool AudioDsp_Process(AudioDsp_t *dsp, int16_t *pcm, uint32_t count);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _AUDIO_DSP_H_ */
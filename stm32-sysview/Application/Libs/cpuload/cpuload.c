@@ -0,0 +1,190 @@
+/**
+ * @file    cpuload.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.2.0
+ * @brief   Carga da CPU medida pelo tempo dormindo na task idle
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "cpuload.h"
+#include "setup_hw.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Um intervalo fechado */
+typedef struct
+{
+	uint32_t idle;          /**< Ciclos dormindo */
+	uint32_t total;         /**< Ciclos do intervalo */
+} CpuLoadSample_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Acumulados pelo hook (modulo 2^32: so a diferenca entre Updates importa) */
+static volatile uint32_t loadIdle = 0;
+static volatile uint32_t loadSleeps = 0;
+
+/** @brief Inicio do intervalo atual; so o CpuLoad_Update altera */
+static uint32_t loadLastIdle = 0;
+static uint32_t loadLastSleeps = 0;
+static uint32_t loadLastCycles = 0;
+
+static CpuLoadSample_t loadWindow[CPULOAD_WINDOW];
+static uint8_t loadNext = 0;
+static uint8_t loadCount = 0;
+
+/** @brief Resultado publicado */
+static CpuLoadStats_t loadStats;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Media dos ultimos intervalos ponderada pelos ciclos.
+ * @param n Intervalos (limitado aos que existem).
+ * @return Carga em permil.
+ */
+static uint16_t CpuLoad_Average(uint8_t n);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint16_t CpuLoad_Average(uint8_t n)
+{
+	uint64_t idle = 0, total = 0;
+	uint8_t i, k;
+
+	n = (n > loadCount) ? loadCount : n;
+
+	for (k = 0; k < n; k++)
+	{
+		i = (uint8_t) ((loadNext + CPULOAD_WINDOW - 1 - k) % CPULOAD_WINDOW);
+		idle += loadWindow[i].idle;
+		total += loadWindow[i].total;
+	}
+
+	if ((total == 0) || (idle >= total))
+	{
+		return 0;
+	}
+
+	return (uint16_t) (CPULOAD_FULL - (idle * CPULOAD_FULL) / total);
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void CpuLoad_Init(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	memset(loadWindow, 0, sizeof(loadWindow));
+	memset(&loadStats, 0, sizeof(loadStats));
+	loadNext = 0;
+	loadCount = 0;
+	loadLastIdle = loadIdle;
+	loadLastSleeps = loadSleeps;
+	loadLastCycles = Timebase_Cycles32();
+
+	__set_PRIMASK(primask);
+}
+
+void CpuLoad_IdleHook(void)
+{
+	uint32_t start;
+
+	/* Com PRIMASK o WFI ainda acorda na interrupcao pendente, que so e atendida depois da leitura */
+	__disable_irq();
+
+	start = Timebase_Cycles32();
+	__DSB();
+	__WFI();
+	loadIdle += Timebase_Cycles32() - start;
+	loadSleeps++;
+
+	__enable_irq();
+}
+
+void CpuLoad_AddIdle(uint32_t cycles)
+{
+	loadIdle += cycles;
+	loadSleeps++;
+}
+
+void CpuLoad_Update(void)
+{
+	CpuLoadSample_t *s = &loadWindow[loadNext];
+	uint32_t primask, now, idle, sleeps;
+	uint16_t load, load10, load60;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	now = Timebase_Cycles32();
+	idle = loadIdle;
+	sleeps = loadSleeps;
+	__set_PRIMASK(primask);
+
+	/* Chamado bem antes do CYCCNT dar a volta (53 s a 80 MHz) */
+	s->idle = idle - loadLastIdle;
+	s->total = now - loadLastCycles;
+
+	loadLastIdle = idle;
+	loadLastCycles = now;
+
+	loadNext = (uint8_t) ((loadNext + 1) % CPULOAD_WINDOW);
+	if (loadCount < CPULOAD_WINDOW)
+	{
+		loadCount++;
+	}
+
+	load = CpuLoad_Average(1);
+	load10 = CpuLoad_Average(10);
+	load60 = CpuLoad_Average(CPULOAD_WINDOW);
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	loadStats.load_1s = load;
+	loadStats.load_10s = load10;
+	loadStats.load_60s = load60;
+	loadStats.peak = (load > loadStats.peak) ? load : loadStats.peak;
+	loadStats.intervals++;
+	loadStats.sleeps = sleeps - loadLastSleeps;
+	__set_PRIMASK(primask);
+
+	loadLastSleeps = sleeps;
+}
+
+void CpuLoad_Get(CpuLoadStats_t *stats)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	*stats = loadStats;
+	__set_PRIMASK(primask);
+}
+
+void CpuLoad_ResetPeak(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	loadStats.peak = loadStats.load_1s;
+	loadStats.intervals = 0;
+	__set_PRIMASK(primask);
+}
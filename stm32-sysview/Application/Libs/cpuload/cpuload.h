@@ -0,0 +1,95 @@
+/**
+ * @file    cpuload.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.2.0
+ * @brief   Carga da CPU medida pelo tempo dormindo na task idle
+ * @details
+ * O vApplicationIdleHook chama CpuLoad_IdleHook, que dorme em WFI ate a
+ * proxima interrupcao e soma os ciclos do CYCCNT (timebase) gastos
+ * dormindo. As interrupcoes ficam mascaradas durante o WFI: o core acorda
+ * com a interrupcao pendente, le o contador e so entao a atende, entao o
+ * tempo das ISRs conta como carga. O CYCCNT continua contando em Sleep.
+ * Com tickless idle o sono e feito pelo port (freertos_lowpower.c), que
+ * informa o tempo dormindo por CpuLoad_AddIdle.
+ *
+ * CpuLoad_Update e chamada a cada segundo pela task default e fecha um
+ * intervalo com os ciclos realmente passados (nao depende do atraso da
+ * task). As medias de 1 s, 10 s e 60 s sao ponderadas pelos ciclos de cada
+ * intervalo; o pico e a maior carga de um intervalo desde o ultimo reset.
+ * Cargas em permil (1000 = 100 %).
+ */
+
+#ifndef _CPULOAD_H_
+#define _CPULOAD_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Intervalos guardados: a maior media */
+#define CPULOAD_WINDOW			60
+
+/** @brief Carga maxima (permil) */
+#define CPULOAD_FULL			1000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+typedef struct
+{
+	uint16_t load_1s;       /**< Ultimo intervalo */
+	uint16_t load_10s;
+	uint16_t load_60s;
+	uint16_t peak;          /**< Maior intervalo desde o reset */
+	uint32_t intervals;     /**< Intervalos fechados desde o reset */
+	uint32_t sleeps;        /**< WFIs no ultimo intervalo */
+} CpuLoadStats_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Zera a janela e comeca um intervalo (depois do Timebase_Init). */
+void CpuLoad_Init(void);
+
+/** @brief Dorme ate a proxima interrupcao contando o tempo; so na task idle. */
+void CpuLoad_IdleHook(void);
+
+/**
+ * Soma um periodo dormindo medido por quem dormiu; com as interrupcoes
+ * mascaradas.
+ * @param cycles Duracao em ciclos do core.
+ */
+void CpuLoad_AddIdle(uint32_t cycles);
+
+/** @brief Fecha o intervalo atual e atualiza as medias; uma vez por segundo. */
+void CpuLoad_Update(void);
+
+/**
+ * Copia as medias atuais.
+ * @param stats Destino.
+ */
+void CpuLoad_Get(CpuLoadStats_t *stats);
+
+/** @brief Zera o pico e o contador de intervalos. */
+void CpuLoad_ResetPeak(void);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _CPULOAD_H_ */
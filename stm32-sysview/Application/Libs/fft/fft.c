@@ -0,0 +1,361 @@
+/**
+ * @file    fft.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   FFT radix-2 e radix-2^2 em float para sinais reais
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "fft.h"
+
+#include <math.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define FFT_PI					3.14159265358979f
+
+/* FFT_USE_RADIX4 pode ser forcado por quem compila (ex.: comparacao no PC) */
+#ifndef FFT_USE_RADIX4
+#if defined(__ARM_ARCH_7EM__)
+#define FFT_USE_RADIX4			1
+#else
+#define FFT_USE_RADIX4			0
+#endif
+#endif
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Reordena m pontos complexos pelos indices com bits invertidos.
+ * @param d 2 * m floats.
+ * @param m Pontos complexos.
+ */
+static void Fft_BitReverse(float *d, uint16_t m);
+
+/**
+ * FFT complexa radix-2 de m pontos intercalados (re, im) no lugar.
+ * @param plan Plano de n = 2 * m pontos reais (twiddles com passo 2).
+ * @param d 2 * m floats.
+ * @param m Pontos complexos.
+ */
+static void Fft_Complex(const FftPlan_t *plan, float *d, uint16_t m);
+
+#if (FFT_USE_RADIX4 == 1)
+/**
+ * FFT complexa radix-2^2 de m pontos intercalados (re, im) no lugar.
+ * @param plan Plano de n = 2 * m pontos reais (twiddles com passo 2).
+ * @param d 2 * m floats.
+ * @param m Pontos complexos.
+ */
+static void Fft_ComplexRadix4(const FftPlan_t *plan, float *d, uint16_t m);
+#endif
+
+/**
+ * Separa a FFT complexa de n/2 pontos no espectro de n pontos reais.
+ * @param plan Plano.
+ * @param buf Saida da FFT complexa; espectro empacotado no retorno.
+ */
+static void Fft_Split(const FftPlan_t *plan, float *buf);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void Fft_BitReverse(float *d, uint16_t m)
+{
+	uint32_t i, j, bit;
+	float tr, ti;
+
+	for (i = 0, j = 0; i < m; i++)
+	{
+		if (i < j)
+		{
+			tr = d[2 * i];
+			ti = d[2 * i + 1];
+			d[2 * i] = d[2 * j];
+			d[2 * i + 1] = d[2 * j + 1];
+			d[2 * j] = tr;
+			d[2 * j + 1] = ti;
+		}
+
+		for (bit = m >> 1; (bit > 0) && (j & bit); bit >>= 1)
+		{
+			j ^= bit;
+		}
+		j |= bit;
+	}
+}
+
+static void Fft_Complex(const FftPlan_t *plan, float *d, uint16_t m)
+{
+	const float *tw = plan->twiddle;
+	uint32_t j, k, h, step;
+	uint32_t a, b;
+	float wr, wi, tr, ti;
+
+	Fft_BitReverse(d, m);
+
+	/* Borboletas: W = exp(-i*2*pi*k/n) = cos - i*sin */
+	for (h = 1; h < m; h <<= 1)
+	{
+		step = plan->n / (2 * h);
+
+		for (j = 0; j < h; j++)
+		{
+			wr = tw[2 * j * step];
+			wi = -tw[2 * j * step + 1];
+
+			for (k = j; k < m; k += 2 * h)
+			{
+				a = 2 * k;
+				b = 2 * (k + h);
+
+				tr = wr * d[b] - wi * d[b + 1];
+				ti = wr * d[b + 1] + wi * d[b];
+
+				d[b] = d[a] - tr;
+				d[b + 1] = d[a + 1] - ti;
+				d[a] += tr;
+				d[a + 1] += ti;
+			}
+		}
+	}
+}
+
+#if (FFT_USE_RADIX4 == 1)
+static void Fft_ComplexRadix4(const FftPlan_t *plan, float *d, uint16_t m)
+{
+	const float *tw = plan->twiddle;
+	uint32_t half = plan->n / 2;
+	uint32_t j, k, h, step, idx;
+	uint32_t a, b, c, e;
+	float w1r, w1i, w2r, w2i, w3r, w3i;
+	float br, bi, cr, ci, er, ei;
+	float s0r, s0i, s1r, s1i, t0r, t0i, t1r, t1i, tr, ti;
+
+	Fft_BitReverse(d, m);
+
+	h = 1;
+
+	/* log2(m) impar: primeiro estagio radix-2, com twiddle 1 */
+	if ((31 - __builtin_clz(m)) & 1)
+	{
+		for (k = 0; k < m; k += 2)
+		{
+			a = 2 * k;
+			tr = d[a + 2];
+			ti = d[a + 3];
+			d[a + 2] = d[a] - tr;
+			d[a + 3] = d[a + 1] - ti;
+			d[a] += tr;
+			d[a + 1] += ti;
+		}
+		h = 2;
+	}
+
+	/*
+	 * Estagios h e 2h juntos sobre os pontos k, k + h, k + 2h, k + 3h:
+	 * com W = exp(-i*2*pi/4h), y0..y3 = x0 +- W^2j x1 +- (W^j x2 + W^3j x3)
+	 * e -i nos termos impares; tres multiplicacoes por grupo de 4 pontos.
+	 */
+	for (; h < m; h <<= 2)
+	{
+		step = plan->n / (4 * h);
+
+		for (j = 0; j < h; j++)
+		{
+			idx = j * step;
+			w1r = tw[2 * idx];
+			w1i = -tw[2 * idx + 1];
+			w2r = tw[4 * idx];
+			w2i = -tw[4 * idx + 1];
+
+			/* Indices a partir de n/2 pela simetria W^(k + n/2) = -W^k */
+			idx *= 3;
+			if (idx < half)
+			{
+				w3r = tw[2 * idx];
+				w3i = -tw[2 * idx + 1];
+			}
+			else
+			{
+				w3r = -tw[2 * (idx - half)];
+				w3i = tw[2 * (idx - half) + 1];
+			}
+
+			for (k = j; k < m; k += 4 * h)
+			{
+				a = 2 * k;
+				b = 2 * (k + h);
+				c = 2 * (k + 2 * h);
+				e = 2 * (k + 3 * h);
+
+				br = w2r * d[b] - w2i * d[b + 1];
+				bi = w2r * d[b + 1] + w2i * d[b];
+				cr = w1r * d[c] - w1i * d[c + 1];
+				ci = w1r * d[c + 1] + w1i * d[c];
+				er = w3r * d[e] - w3i * d[e + 1];
+				ei = w3r * d[e + 1] + w3i * d[e];
+
+				s0r = d[a] + br;
+				s0i = d[a + 1] + bi;
+				s1r = d[a] - br;
+				s1i = d[a + 1] - bi;
+				t0r = cr + er;
+				t0i = ci + ei;
+				t1r = cr - er;
+				t1i = ci - ei;
+
+				/* -i * (t1r + i*t1i) = t1i - i*t1r */
+				d[a] = s0r + t0r;
+				d[a + 1] = s0i + t0i;
+				d[c] = s0r - t0r;
+				d[c + 1] = s0i - t0i;
+				d[b] = s1r + t1i;
+				d[b + 1] = s1i - t1r;
+				d[e] = s1r - t1i;
+				d[e + 1] = s1i + t1r;
+			}
+		}
+	}
+}
+#endif
+
+static void Fft_Split(const FftPlan_t *plan, float *buf)
+{
+	const float *tw = plan->twiddle;
+	uint16_t m = plan->n / 2;
+	uint16_t k, mk;
+	float er, ei, or, oi, wr, wi, tr, ti;
+	float z0r, z0i;
+
+	z0r = buf[0];
+	z0i = buf[1];
+	buf[0] = z0r + z0i;
+	buf[1] = z0r - z0i;
+
+	/*
+	 * Separacao: E = (Z[k] + conj(Z[m-k])) / 2, O = (Z[k] - conj(Z[m-k])) / 2i
+	 * X[k] = E + W^k * O, X[m-k] = conj(E - W^k * O)
+	 */
+	for (k = 1; k <= m / 2; k++)
+	{
+		mk = m - k;
+
+		er = 0.5f * (buf[2 * k] + buf[2 * mk]);
+		ei = 0.5f * (buf[2 * k + 1] - buf[2 * mk + 1]);
+		or = 0.5f * (buf[2 * k + 1] + buf[2 * mk + 1]);
+		oi = -0.5f * (buf[2 * k] - buf[2 * mk]);
+
+		wr = tw[2 * k];
+		wi = -tw[2 * k + 1];
+
+		tr = wr * or - wi * oi;
+		ti = wr * oi + wi * or;
+
+		buf[2 * k] = er + tr;
+		buf[2 * k + 1] = ei + ti;
+		buf[2 * mk] = er - tr;
+		buf[2 * mk + 1] = -(ei - ti);
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+bool Fft_Init(FftPlan_t *plan, uint16_t n, float *twiddle)
+{
+	uint16_t k;
+
+	if ((n < FFT_MIN_SIZE) || (n > FFT_MAX_SIZE) || ((n & (n - 1)) != 0))
+	{
+		return false;
+	}
+
+	plan->n = n;
+	plan->twiddle = twiddle;
+
+	for (k = 0; k < n / 2; k++)
+	{
+		twiddle[2 * k] = cosf(2.0f * FFT_PI * (float) k / (float) n);
+		twiddle[2 * k + 1] = sinf(2.0f * FFT_PI * (float) k / (float) n);
+	}
+
+	return true;
+}
+
+void Fft_Real(const FftPlan_t *plan, float *buf)
+{
+	/* Amostras pares e impares como parte real e imaginaria */
+#if (FFT_USE_RADIX4 == 1)
+	Fft_ComplexRadix4(plan, buf, plan->n / 2);
+#else
+	Fft_Complex(plan, buf, plan->n / 2);
+#endif
+
+	Fft_Split(plan, buf);
+}
+
+void Fft_RealRef(const FftPlan_t *plan, float *buf)
+{
+	Fft_Complex(plan, buf, plan->n / 2);
+	Fft_Split(plan, buf);
+}
+
+void Fft_Power(const FftPlan_t *plan, const float *buf, float *power)
+{
+	uint16_t k;
+
+	/* Em ordem crescente: power pode sobrescrever buf */
+	power[0] = buf[0] * buf[0];
+
+	for (k = 1; k < plan->n / 2; k++)
+	{
+		power[k] = buf[2 * k] * buf[2 * k] + buf[2 * k + 1] * buf[2 * k + 1];
+	}
+}
+
+float Fft_Window(FftWindow_e type, float *w, uint16_t n)
+{
+	float sum = 0.0f;
+	float x;
+	uint16_t i;
+
+	for (i = 0; i < n; i++)
+	{
+		/* Janela periodica: melhor para analise espectral */
+		x = 2.0f * FFT_PI * (float) i / (float) n;
+
+		switch (type)
+		{
+		case FFT_WINDOW_HANN:
+			w[i] = 0.5f - 0.5f * cosf(x);
+			break;
+
+		case FFT_WINDOW_HAMMING:
+			w[i] = 0.54f - 0.46f * cosf(x);
+			break;
+
+		case FFT_WINDOW_BLACKMAN:
+			w[i] = 0.42f - 0.5f * cosf(x) + 0.08f * cosf(2.0f * x);
+			break;
+
+		default:
+			w[i] = 1.0f;
+			break;
+		}
+
+		sum += w[i];
+	}
+
+	return sum / (float) n;
+}
@@ -0,0 +1,118 @@
+/**
+ * @file    fft.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   FFT radix-2 e radix-2^2 em float para sinais reais
+ * @details
+ * Um sinal real de n pontos e transformado como n/2 pontos complexos
+ * seguidos de um passo de separacao, o que custa cerca de metade de uma FFT
+ * complexa de n pontos. As twiddles ficam em um buffer do chamador para o
+ * mesmo codigo servir tamanhos diferentes sem alocacao. C puro, compila
+ * tambem no PC (Tools/audio, Tools/vibration).
+ *
+ * A parte complexa tem dois caminhos, escolhidos por FFT_USE_RADIX4:
+ *   - radix-2^2 (padrao no Cortex-M): dois estagios radix-2 por passada
+ *     sobre grupos de 4 pontos, com metade das leituras e escritas do
+ *     buffer e 3/4 das multiplicacoes complexas; com log2(n/2) impar, um
+ *     estagio radix-2 sem multiplicacoes vem antes;
+ *   - radix-2 de referencia, sempre disponivel por Fft_RealRef para conferir
+ *     o caminho otimizado e medir o ganho.
+ *
+ * Saida de Fft_Real no proprio buffer (formato empacotado):
+ *   buf[0] = X[0] (real), buf[1] = X[n/2] (real),
+ *   buf[2k], buf[2k + 1] = real e imaginario de X[k], 1 <= k < n/2.
+ */
+
+#ifndef _FFT_H_
+#define _FFT_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define FFT_MIN_SIZE			16
+#define FFT_MAX_SIZE			4096
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Tamanho e twiddles de uma transformada */
+typedef struct
+{
+	uint16_t n;             /**< Pontos reais (potencia de 2) */
+	float *twiddle;         /**< cos, sin de 2*pi*k/n para k < n/2 (n floats) */
+} FftPlan_t;
+
+/** @brief Janelas disponiveis */
+typedef enum
+{
+	FFT_WINDOW_RECT = 0,
+	FFT_WINDOW_HANN,
+	FFT_WINDOW_HAMMING,
+	FFT_WINDOW_BLACKMAN
+} FftWindow_e;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Prepara uma transformada de n pontos reais.
+ * @param plan Plano.
+ * @param n Potencia de 2 entre FFT_MIN_SIZE e FFT_MAX_SIZE.
+ * @param twiddle Buffer de n floats, usado enquanto o plano existir.
+ * @return false se n for invalido.
+ */
+bool Fft_Init(FftPlan_t *plan, uint16_t n, float *twiddle);
+
+/**
+ * FFT de n pontos reais no lugar; saida no formato empacotado.
+ * @param plan Plano.
+ * @param buf n amostras na entrada, espectro empacotado na saida.
+ */
+void Fft_Real(const FftPlan_t *plan, float *buf);
+
+/**
+ * Mesma transformada de Fft_Real pelo caminho radix-2 de referencia.
+ * @param plan Plano.
+ * @param buf n amostras na entrada, espectro empacotado na saida.
+ */
+void Fft_RealRef(const FftPlan_t *plan, float *buf);
+
+/**
+ * Potencia |X[k]|^2 de cada bin de 0 a n/2 - 1 (Nyquist descartado).
+ * @param plan Plano.
+ * @param buf Espectro empacotado.
+ * @param power Saida com n/2 valores; pode ser igual a buf.
+ */
+void Fft_Power(const FftPlan_t *plan, const float *buf, float *power);
+
+/**
+ * Coeficientes de uma janela.
+ * @param type Tipo.
+ * @param w Saida com n valores.
+ * @param n Tamanho.
+ * @return Ganho coerente (media dos coeficientes), para corrigir amplitudes.
+ */
+float Fft_Window(FftWindow_e type, float *w, uint16_t n);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FFT_H_ */
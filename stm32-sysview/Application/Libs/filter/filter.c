@@ -0,0 +1,778 @@
+/**
+ * @file    filter.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Filtros digitais em blocos para fluxos de sensores
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "filter.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define FILTER_PI				3.14159265358979f
+
+/** @brief Maior shift dos coeficientes Q (|c| < 256) */
+#define FILTER_MAX_SHIFT		8
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Arredonda e satura um acumulador para Q15.
+ * @param acc Valor ja na escala de saida, com bits de fracao.
+ * @param bits Bits de fracao a descartar.
+ */
+static int16_t Filter_SatQ15(int64_t acc, uint8_t bits);
+
+/**
+ * Arredonda e satura um acumulador para Q31.
+ * @param acc Valor ja na escala de saida, com bits de fracao.
+ * @param bits Bits de fracao a descartar.
+ */
+static int32_t Filter_SatQ31(int64_t acc, uint8_t bits);
+
+/**
+ * Menor shift que faz os coeficientes caberem em [-1, 1) com a resolucao dada.
+ * @param c Coeficientes.
+ * @param count Quantidade.
+ * @param one Valor de 1.0 no formato.
+ */
+static uint8_t Filter_Shift(const float *c, uint16_t count, float one);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static int16_t Filter_SatQ15(int64_t acc, uint8_t bits)
+{
+	acc = (acc + ((int64_t) 1 << (bits - 1))) >> bits;
+
+	if (acc > INT16_MAX)
+	{
+		return INT16_MAX;
+	}
+
+	if (acc < INT16_MIN)
+	{
+		return INT16_MIN;
+	}
+
+	return (int16_t) acc;
+}
+
+static int32_t Filter_SatQ31(int64_t acc, uint8_t bits)
+{
+	acc = (acc + ((int64_t) 1 << (bits - 1))) >> bits;
+
+	if (acc > INT32_MAX)
+	{
+		return INT32_MAX;
+	}
+
+	if (acc < INT32_MIN)
+	{
+		return INT32_MIN;
+	}
+
+	return (int32_t) acc;
+}
+
+static uint8_t Filter_Shift(const float *c, uint16_t count, float one)
+{
+	float peak = 0.0f;
+	uint8_t shift = 0;
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (fabsf(c[i]) > peak)
+		{
+			peak = fabsf(c[i]);
+		}
+	}
+
+	/* O maior coeficiente precisa arredondar para menos que 1.0 */
+	while ((shift < FILTER_MAX_SHIFT) && (floorf(peak * one / (float) (1UL << shift) + 0.5f) >= one))
+	{
+		shift++;
+	}
+
+	return shift;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void Filter_BiquadInitF32(FilterBiquadF32_t *f, uint8_t stages, const float *coeffs, float *state)
+{
+	f->stages = stages;
+	f->coeffs = coeffs;
+	f->state = state;
+	memset(state, 0, stages * FILTER_BIQUAD_STATE * sizeof(float));
+}
+
+void Filter_BiquadInitQ15(FilterBiquadQ15_t *f, uint8_t stages, uint8_t shift, const int16_t *coeffs, int64_t *state)
+{
+	f->stages = stages;
+	f->shift = shift;
+	f->coeffs = coeffs;
+	f->state = state;
+	memset(state, 0, stages * FILTER_BIQUAD_STATE * sizeof(int64_t));
+}
+
+void Filter_BiquadInitQ31(FilterBiquadQ31_t *f, uint8_t stages, uint8_t shift, const int32_t *coeffs, int64_t *state)
+{
+	f->stages = stages;
+	f->shift = shift;
+	f->coeffs = coeffs;
+	f->state = state;
+	memset(state, 0, stages * FILTER_BIQUAD_STATE * sizeof(int64_t));
+}
+
+void Filter_BiquadF32(FilterBiquadF32_t *f, const float *in, float *out, uint16_t count)
+{
+	const float *c = f->coeffs;
+	float *s = f->state;
+	float b0, b1, b2, a1, a2, s1, s2, x, y;
+	const float *src = in;
+	uint16_t i;
+	uint8_t k;
+
+	/* Uma secao por vez sobre o bloco inteiro: coeficientes e estados em registradores */
+	for (k = 0; k < f->stages; k++)
+	{
+		b0 = c[0];
+		b1 = c[1];
+		b2 = c[2];
+		a1 = c[3];
+		a2 = c[4];
+		s1 = s[0];
+		s2 = s[1];
+
+		for (i = 0; i < count; i++)
+		{
+			x = src[i];
+			y = b0 * x + s1;
+			s1 = b1 * x - a1 * y + s2;
+			s2 = b2 * x - a2 * y;
+			out[i] = y;
+		}
+
+		s[0] = s1;
+		s[1] = s2;
+		c += FILTER_BIQUAD_COEFFS;
+		s += FILTER_BIQUAD_STATE;
+		src = out;
+	}
+
+	if ((f->stages == 0) && (out != in))
+	{
+		memmove(out, in, count * sizeof(float));
+	}
+}
+
+void Filter_BiquadQ15(FilterBiquadQ15_t *f, const int16_t *in, int16_t *out, uint16_t count)
+{
+	const int16_t *c = f->coeffs;
+	int64_t *s = f->state;
+	int32_t b0, b1, b2, a1, a2, x, y;
+	int64_t s1, s2;
+	const int16_t *src = in;
+	uint8_t bits = 15 - f->shift;
+	uint16_t i;
+	uint8_t k;
+
+	for (k = 0; k < f->stages; k++)
+	{
+		b0 = c[0];
+		b1 = c[1];
+		b2 = c[2];
+		a1 = c[3];
+		a2 = c[4];
+		s1 = s[0];
+		s2 = s[1];
+
+		for (i = 0; i < count; i++)
+		{
+			x = src[i];
+
+			/* Produtos Q30 na escala 2^-shift; a realimentacao usa a saida ja saturada */
+			y = Filter_SatQ15((int64_t) b0 * x + s1, bits);
+			s1 = (int64_t) b1 * x - (int64_t) a1 * y + s2;
+			s2 = (int64_t) b2 * x - (int64_t) a2 * y;
+			out[i] = (int16_t) y;
+		}
+
+		s[0] = s1;
+		s[1] = s2;
+		c += FILTER_BIQUAD_COEFFS;
+		s += FILTER_BIQUAD_STATE;
+		src = out;
+	}
+
+	if ((f->stages == 0) && (out != in))
+	{
+		memmove(out, in, count * sizeof(int16_t));
+	}
+}
+
+void Filter_BiquadQ31(FilterBiquadQ31_t *f, const int32_t *in, int32_t *out, uint16_t count)
+{
+	const int32_t *c = f->coeffs;
+	int64_t *s = f->state;
+	int32_t b0, b1, b2, a1, a2, x, y;
+	int64_t s1, s2;
+	const int32_t *src = in;
+	uint8_t bits = 29 - f->shift;
+	uint16_t i;
+	uint8_t k;
+
+	for (k = 0; k < f->stages; k++)
+	{
+		b0 = c[0];
+		b1 = c[1];
+		b2 = c[2];
+		a1 = c[3];
+		a2 = c[4];
+		s1 = s[0];
+		s2 = s[1];
+
+		for (i = 0; i < count; i++)
+		{
+			x = src[i];
+
+			/* Q31 x Q31 = Q62: >> 2 deixa espaco para somar tres produtos */
+			y = Filter_SatQ31((((int64_t) b0 * x) >> 2) + s1, bits);
+			s1 = (((int64_t) b1 * x) >> 2) - (((int64_t) a1 * y) >> 2) + s2;
+			s2 = (((int64_t) b2 * x) >> 2) - (((int64_t) a2 * y) >> 2);
+			out[i] = y;
+		}
+
+		s[0] = s1;
+		s[1] = s2;
+		c += FILTER_BIQUAD_COEFFS;
+		s += FILTER_BIQUAD_STATE;
+		src = out;
+	}
+
+	if ((f->stages == 0) && (out != in))
+	{
+		memmove(out, in, count * sizeof(int32_t));
+	}
+}
+
+bool Filter_FirDecimInitF32(FilterFirDecimF32_t *f, uint16_t taps, uint8_t factor, const float *coeffs, float *state)
+{
+	if ((taps == 0) || (factor == 0))
+	{
+		return false;
+	}
+
+	f->taps = taps;
+	f->pos = taps - 1;
+	f->factor = factor;
+	f->phase = 0;
+	f->coeffs = coeffs;
+	f->state = state;
+	memset(state, 0, FILTER_FIR_STATE(taps) * sizeof(float));
+
+	return true;
+}
+
+bool Filter_FirDecimInitQ15(FilterFirDecimQ15_t *f, uint16_t taps, uint8_t factor, const int16_t *coeffs, int16_t *state)
+{
+	if ((taps == 0) || (factor == 0))
+	{
+		return false;
+	}
+
+	f->taps = taps;
+	f->pos = taps - 1;
+	f->factor = factor;
+	f->phase = 0;
+	f->coeffs = coeffs;
+	f->state = state;
+	memset(state, 0, FILTER_FIR_STATE(taps) * sizeof(int16_t));
+
+	return true;
+}
+
+bool Filter_FirDecimInitQ31(FilterFirDecimQ31_t *f, uint16_t taps, uint8_t factor, const int32_t *coeffs, int32_t *state)
+{
+	if ((taps == 0) || (factor == 0))
+	{
+		return false;
+	}
+
+	f->taps = taps;
+	f->pos = taps - 1;
+	f->factor = factor;
+	f->phase = 0;
+	f->coeffs = coeffs;
+	f->state = state;
+	memset(state, 0, FILTER_FIR_STATE(taps) * sizeof(int32_t));
+
+	return true;
+}
+
+uint16_t Filter_FirDecimF32(FilterFirDecimF32_t *f, const float *in, float *out, uint16_t count)
+{
+	const float *h = f->coeffs;
+	const float *w;
+	float acc;
+	uint16_t i, k, n = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		/*
+		 * A amostra vai para pos e pos + taps: a janela state[pos..pos+taps-1]
+		 * tem sempre x[n], x[n-1], ... contiguos, sem teste de volta no laco.
+		 */
+		f->state[f->pos] = in[i];
+		f->state[f->pos + f->taps] = in[i];
+
+		if (f->phase == 0)
+		{
+			w = &f->state[f->pos];
+			for (acc = 0.0f, k = 0; k < f->taps; k++)
+			{
+				acc += h[k] * w[k];
+			}
+
+			/* n <= i: a entrada ja foi lida, entao out pode ser in */
+			out[n++] = acc;
+			f->phase = f->factor;
+		}
+
+		f->phase--;
+		f->pos = (f->pos == 0) ? (f->taps - 1) : (f->pos - 1);
+	}
+
+	return n;
+}
+
+uint16_t Filter_FirDecimQ15(FilterFirDecimQ15_t *f, const int16_t *in, int16_t *out, uint16_t count)
+{
+	const int16_t *h = f->coeffs;
+	const int16_t *w;
+	int64_t acc;
+	uint16_t i, k, n = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		f->state[f->pos] = in[i];
+		f->state[f->pos + f->taps] = in[i];
+
+		if (f->phase == 0)
+		{
+			w = &f->state[f->pos];
+			for (acc = 0, k = 0; k < f->taps; k++)
+			{
+				acc += (int32_t) h[k] * w[k];
+			}
+
+			out[n++] = Filter_SatQ15(acc, 15);
+			f->phase = f->factor;
+		}
+
+		f->phase--;
+		f->pos = (f->pos == 0) ? (f->taps - 1) : (f->pos - 1);
+	}
+
+	return n;
+}
+
+uint16_t Filter_FirDecimQ31(FilterFirDecimQ31_t *f, const int32_t *in, int32_t *out, uint16_t count)
+{
+	const int32_t *h = f->coeffs;
+	const int32_t *w;
+	int64_t acc;
+	uint16_t i, k, n = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		f->state[f->pos] = in[i];
+		f->state[f->pos + f->taps] = in[i];
+
+		if (f->phase == 0)
+		{
+			/* Produtos Q62 em Q55: com soma de |h| < 2 o acumulador fica abaixo de 2^56 */
+			w = &f->state[f->pos];
+			for (acc = 0, k = 0; k < f->taps; k++)
+			{
+				acc += ((int64_t) h[k] * w[k]) >> 7;
+			}
+
+			out[n++] = Filter_SatQ31(acc, 24);
+			f->phase = f->factor;
+		}
+
+		f->phase--;
+		f->pos = (f->pos == 0) ? (f->taps - 1) : (f->pos - 1);
+	}
+
+	return n;
+}
+
+bool Filter_MovAvgInitF32(FilterMovAvgF32_t *f, uint16_t length, float *buf)
+{
+	if (length == 0)
+	{
+		return false;
+	}
+
+	memset(f, 0, sizeof(FilterMovAvgF32_t));
+	f->length = length;
+	f->buf = buf;
+
+	return true;
+}
+
+bool Filter_MovAvgInitQ15(FilterMovAvgQ15_t *f, uint16_t length, int16_t *buf)
+{
+	if (length == 0)
+	{
+		return false;
+	}
+
+	memset(f, 0, sizeof(FilterMovAvgQ15_t));
+	f->length = length;
+	f->buf = buf;
+
+	return true;
+}
+
+bool Filter_MovAvgInitQ31(FilterMovAvgQ31_t *f, uint16_t length, int32_t *buf)
+{
+	if (length == 0)
+	{
+		return false;
+	}
+
+	memset(f, 0, sizeof(FilterMovAvgQ31_t));
+	f->length = length;
+	f->buf = buf;
+
+	return true;
+}
+
+void Filter_MovAvgF32(FilterMovAvgF32_t *f, const float *in, float *out, uint16_t count)
+{
+	float x;
+	uint16_t i, k;
+
+	for (i = 0; i < count; i++)
+	{
+		x = in[i];
+
+		if (f->count < f->length)
+		{
+			f->count++;
+		}
+		else
+		{
+			f->sum -= f->buf[f->pos];
+		}
+
+		f->buf[f->pos] = x;
+		f->sum += x;
+
+		if (++f->pos == f->length)
+		{
+			f->pos = 0;
+
+			/* Soma refeita a cada volta: o erro de arredondamento nao acumula */
+			for (f->sum = 0.0f, k = 0; k < f->count; k++)
+			{
+				f->sum += f->buf[k];
+			}
+		}
+
+		out[i] = f->sum / (float) f->count;
+	}
+}
+
+void Filter_MovAvgQ15(FilterMovAvgQ15_t *f, const int16_t *in, int16_t *out, uint16_t count)
+{
+	int32_t sum;
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (f->count < f->length)
+		{
+			f->count++;
+		}
+		else
+		{
+			f->sum -= f->buf[f->pos];
+		}
+
+		f->buf[f->pos] = in[i];
+		f->sum += in[i];
+
+		if (++f->pos == f->length)
+		{
+			f->pos = 0;
+		}
+
+		/* Divisao arredondada para o mais proximo */
+		sum = f->sum;
+		out[i] = (int16_t) ((sum >= 0) ? (sum + f->count / 2) / f->count : (sum - f->count / 2) / f->count);
+	}
+}
+
+void Filter_MovAvgQ31(FilterMovAvgQ31_t *f, const int32_t *in, int32_t *out, uint16_t count)
+{
+	int64_t sum;
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		if (f->count < f->length)
+		{
+			f->count++;
+		}
+		else
+		{
+			f->sum -= f->buf[f->pos];
+		}
+
+		f->buf[f->pos] = in[i];
+		f->sum += in[i];
+
+		if (++f->pos == f->length)
+		{
+			f->pos = 0;
+		}
+
+		sum = f->sum;
+		out[i] = (int32_t) ((sum >= 0) ? (sum + f->count / 2) / f->count : (sum - f->count / 2) / f->count);
+	}
+}
+
+void Filter_EmaInitF32(FilterEmaF32_t *f, float alpha)
+{
+	f->alpha = alpha;
+	f->y = 0.0f;
+	f->started = false;
+}
+
+void Filter_EmaInitQ15(FilterEmaQ15_t *f, int16_t alpha)
+{
+	f->alpha = alpha;
+	f->y = 0;
+	f->started = false;
+}
+
+void Filter_EmaInitQ31(FilterEmaQ31_t *f, int32_t alpha)
+{
+	f->alpha = alpha;
+	f->y = 0;
+	f->started = false;
+}
+
+void Filter_EmaF32(FilterEmaF32_t *f, const float *in, float *out, uint16_t count)
+{
+	float y = f->y;
+	uint16_t i = 0;
+
+	if ((count > 0) && (f->started == false))
+	{
+		y = in[0];
+		out[i++] = y;
+		f->started = true;
+	}
+
+	for (; i < count; i++)
+	{
+		y += f->alpha * (in[i] - y);
+		out[i] = y;
+	}
+
+	f->y = y;
+}
+
+void Filter_EmaQ15(FilterEmaQ15_t *f, const int16_t *in, int16_t *out, uint16_t count)
+{
+	int64_t d;
+	int32_t y = f->y;
+	uint16_t i = 0;
+
+	if ((count > 0) && (f->started == false))
+	{
+		y = (int32_t) in[0] * 65536;
+		out[i++] = in[0];
+		f->started = true;
+	}
+
+	for (; i < count; i++)
+	{
+		d = (int64_t) in[i] * 65536 - y;
+		y += (int32_t) ((d * f->alpha) >> 15);
+		out[i] = Filter_SatQ15(y, 16);
+	}
+
+	f->y = y;
+}
+
+void Filter_EmaQ31(FilterEmaQ31_t *f, const int32_t *in, int32_t *out, uint16_t count)
+{
+	int64_t d, y = f->y;
+	uint16_t i = 0;
+
+	if ((count > 0) && (f->started == false))
+	{
+		y = (int64_t) in[0] * 65536;
+		out[i++] = in[0];
+		f->started = true;
+	}
+
+	for (; i < count; i++)
+	{
+		/* d * alpha passaria de 64 bits: multiplicacao em duas partes de d */
+		d = (int64_t) in[i] * 65536 - y;
+		y += (((d >> 16) * f->alpha) + (((d & 0xFFFF) * f->alpha) >> 16)) >> 15;
+		out[i] = Filter_SatQ31(y, 16);
+	}
+
+	f->y = y;
+}
+
+uint8_t Filter_DesignButterworth(FilterType_e type, uint8_t order, float fc, float *coeffs)
+{
+	float w0, cw, sw, alpha, a0, q;
+	uint8_t k, stages;
+
+	if ((order < 2) || (order > FILTER_MAX_ORDER) || ((order & 1) != 0) || (fc <= 0.0f) || (fc >= 0.5f))
+	{
+		return 0;
+	}
+
+	stages = order / 2;
+	w0 = 2.0f * FILTER_PI * fc;
+	cw = cosf(w0);
+	sw = sinf(w0);
+
+	for (k = 0; k < stages; k++)
+	{
+		/* Polos de Butterworth: cada par conjugado vira uma secao com esse Q */
+		q = 1.0f / (2.0f * sinf((float) (2 * k + 1) * FILTER_PI / (float) (2 * order)));
+		alpha = sw / (2.0f * q);
+		a0 = 1.0f + alpha;
+
+		if (type == FILTER_HIGHPASS)
+		{
+			coeffs[0] = (1.0f + cw) / 2.0f / a0;
+			coeffs[1] = -(1.0f + cw) / a0;
+		}
+		else
+		{
+			coeffs[0] = (1.0f - cw) / 2.0f / a0;
+			coeffs[1] = (1.0f - cw) / a0;
+		}
+
+		coeffs[2] = coeffs[0];
+		coeffs[3] = -2.0f * cw / a0;
+		coeffs[4] = (1.0f - alpha) / a0;
+		coeffs += FILTER_BIQUAD_COEFFS;
+	}
+
+	return stages;
+}
+
+bool Filter_DesignFirLowpass(float *h, uint16_t taps, float fc)
+{
+	float m, t, sum = 0.0f;
+	uint16_t i;
+
+	if ((taps == 0) || (fc <= 0.0f) || (fc >= 0.5f))
+	{
+		return false;
+	}
+
+	if (taps == 1)
+	{
+		h[0] = 1.0f;
+		return true;
+	}
+
+	m = 0.5f * (float) (taps - 1);
+
+	for (i = 0; i < taps; i++)
+	{
+		t = (float) i - m;
+		h[i] = (t == 0.0f) ? 2.0f * fc : sinf(2.0f * FILTER_PI * fc * t) / (FILTER_PI * t);
+		h[i] *= 0.54f - 0.46f * cosf(2.0f * FILTER_PI * (float) i / (float) (taps - 1));
+		sum += h[i];
+	}
+
+	for (i = 0; i < taps; i++)
+	{
+		h[i] /= sum;
+	}
+
+	return true;
+}
+
+uint8_t Filter_BiquadToQ15(const float *c, uint8_t stages, int16_t *q)
+{
+	uint16_t count = stages * FILTER_BIQUAD_COEFFS;
+	uint8_t shift = Filter_Shift(c, count, 32768.0f);
+	float scale = 32768.0f / (float) (1UL << shift);
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		q[i] = (int16_t) lrintf(fminf(fmaxf(c[i] * scale, -32768.0f), 32767.0f));
+	}
+
+	return shift;
+}
+
+uint8_t Filter_BiquadToQ31(const float *c, uint8_t stages, int32_t *q)
+{
+	uint16_t count = stages * FILTER_BIQUAD_COEFFS;
+	uint8_t shift = Filter_Shift(c, count, 2147483648.0f);
+	double scale = 2147483648.0 / (double) (1UL << shift);
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		q[i] = (int32_t) lrint(fmin(fmax((double) c[i] * scale, -2147483648.0), 2147483647.0));
+	}
+
+	return shift;
+}
+
+void Filter_FloatToQ15(const float *in, int16_t *out, uint16_t count)
+{
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		out[i] = (int16_t) lrintf(fminf(fmaxf(in[i] * 32768.0f, -32768.0f), 32767.0f));
+	}
+}
+
+void Filter_FloatToQ31(const float *in, int32_t *out, uint16_t count)
+{
+	uint16_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		out[i] = (int32_t) lrint(fmin(fmax((double) in[i] * 2147483648.0, -2147483648.0), 2147483647.0));
+	}
+}
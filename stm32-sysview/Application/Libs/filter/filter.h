@@ -0,0 +1,326 @@
+/**
+ * @file    filter.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Filtros digitais em blocos para fluxos de sensores
+ * @details
+ * Cada filtro processa um bloco inteiro por chamada (a entrada pode ser a
+ * propria saida) e guarda o estado entre blocos, entao dividir o sinal em
+ * blocos de qualquer tamanho da o mesmo resultado. Todos existem em float,
+ * Q15 (int16) e Q31 (int32):
+ *
+ *   biquad      -> cascata de secoes de segunda ordem na forma direta II
+ *                  transposta; coeficientes {b0, b1, b2, a1, a2} por secao
+ *                  com y = b0*x + b1*x1 + b2*x2 - a1*y1 - a2*y2
+ *   FIR decim.  -> FIR com decimacao por M: so as saidas mantidas sao
+ *                  calculadas; linha de atraso duplicada para a janela ser
+ *                  sempre contigua (2 * taps posicoes)
+ *   media movel -> soma corrida sobre um anel de length amostras
+ *   exponencial -> y += alpha * (x - y)
+ *
+ * Nos formatos Q os coeficientes do biquad vem divididos por 2^shift (para
+ * caberem em [-1, 1)) e os estados ficam em 64 bits; o FIR acumula em 64
+ * bits e nao estoura se a soma de |h| for menor que 2. A exponencial em Q15 e
+ * Q31 guarda 16 bits extras de fracao no estado, sem a zona morta de 1/alpha
+ * LSB da conta direta.
+ *
+ * Tambem ha projeto em float: biquads de Butterworth (ordem par ate
+ * FILTER_MAX_ORDER) e FIR passa-baixas por janela de Hamming, alem da
+ * conversao dos coeficientes para Q15/Q31. C puro, sem HAL: roda no alvo e
+ * no PC (Tools/filter). A memoria dos estados vem do chamador.
+ */
+
+#ifndef _FILTER_H_
+#define _FILTER_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Coeficientes por secao biquad */
+#define FILTER_BIQUAD_COEFFS		5
+
+/** @brief Estados por secao biquad */
+#define FILTER_BIQUAD_STATE			2
+
+/** @brief Posicoes da linha de atraso de um FIR */
+#define FILTER_FIR_STATE(taps)		(2 * (taps))
+
+/** @brief Maior ordem dos projetos de Butterworth (secoes = ordem / 2) */
+#define FILTER_MAX_ORDER			8
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Tipos de secao biquad do projeto */
+typedef enum
+{
+	FILTER_LOWPASS = 0,
+	FILTER_HIGHPASS
+} FilterType_e;
+
+/** @brief Cascata de biquads em float */
+typedef struct
+{
+	uint8_t stages;
+	const float *coeffs;    /**< 5 por secao */
+	float *state;           /**< 2 por secao */
+} FilterBiquadF32_t;
+
+/** @brief Cascata de biquads em Q15 */
+typedef struct
+{
+	uint8_t stages;
+	uint8_t shift;          /**< Coeficientes divididos por 2^shift */
+	const int16_t *coeffs;
+	int64_t *state;         /**< Q30 */
+} FilterBiquadQ15_t;
+
+/** @brief Cascata de biquads em Q31 */
+typedef struct
+{
+	uint8_t stages;
+	uint8_t shift;          /**< Coeficientes divididos por 2^shift */
+	const int32_t *coeffs;
+	int64_t *state;         /**< Q60: produtos Q62 com 2 bits de guarda */
+} FilterBiquadQ31_t;
+
+/** @brief FIR com decimacao em float */
+typedef struct
+{
+	uint16_t taps;
+	uint16_t pos;           /**< Posicao da proxima amostra na linha */
+	uint8_t factor;
+	uint8_t phase;          /**< Amostras ate a proxima saida */
+	const float *coeffs;
+	float *state;           /**< FILTER_FIR_STATE(taps) */
+} FilterFirDecimF32_t;
+
+/** @brief FIR com decimacao em Q15 */
+typedef struct
+{
+	uint16_t taps;
+	uint16_t pos;
+	uint8_t factor;
+	uint8_t phase;
+	const int16_t *coeffs;
+	int16_t *state;
+} FilterFirDecimQ15_t;
+
+/** @brief FIR com decimacao em Q31 */
+typedef struct
+{
+	uint16_t taps;
+	uint16_t pos;
+	uint8_t factor;
+	uint8_t phase;
+	const int32_t *coeffs;
+	int32_t *state;
+} FilterFirDecimQ31_t;
+
+/** @brief Media movel em float */
+typedef struct
+{
+	uint16_t length;
+	uint16_t pos;
+	uint16_t count;         /**< Amostras no anel (ate length) */
+	float *buf;
+	float sum;              /**< Recalculada a cada volta do anel */
+} FilterMovAvgF32_t;
+
+/** @brief Media movel em Q15 */
+typedef struct
+{
+	uint16_t length;
+	uint16_t pos;
+	uint16_t count;
+	int16_t *buf;
+	int32_t sum;
+} FilterMovAvgQ15_t;
+
+/** @brief Media movel em Q31 */
+typedef struct
+{
+	uint16_t length;
+	uint16_t pos;
+	uint16_t count;
+	int32_t *buf;
+	int64_t sum;
+} FilterMovAvgQ31_t;
+
+/** @brief Exponencial em float */
+typedef struct
+{
+	float alpha;
+	float y;
+	bool started;           /**< A primeira amostra inicia o estado */
+} FilterEmaF32_t;
+
+/** @brief Exponencial em Q15 */
+typedef struct
+{
+	int16_t alpha;          /**< Q15 */
+	int32_t y;              /**< Q31: 16 bits de fracao a mais */
+	bool started;
+} FilterEmaQ15_t;
+
+/** @brief Exponencial em Q31 */
+typedef struct
+{
+	int32_t alpha;          /**< Q31 */
+	int64_t y;              /**< Q47: 16 bits de fracao a mais */
+	bool started;
+} FilterEmaQ31_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Inicia uma cascata de biquads (estado zerado).
+ * @param f Filtro.
+ * @param stages Secoes.
+ * @param coeffs FILTER_BIQUAD_COEFFS por secao.
+ * @param state FILTER_BIQUAD_STATE por secao.
+ */
+void Filter_BiquadInitF32(FilterBiquadF32_t *f, uint8_t stages, const float *coeffs, float *state);
+void Filter_BiquadInitQ15(FilterBiquadQ15_t *f, uint8_t stages, uint8_t shift, const int16_t *coeffs, int64_t *state);
+void Filter_BiquadInitQ31(FilterBiquadQ31_t *f, uint8_t stages, uint8_t shift, const int32_t *coeffs, int64_t *state);
+
+/**
+ * Filtra um bloco.
+ * @param f Filtro.
+ * @param in Entrada.
+ * @param out Saida (pode ser igual a in).
+ * @param count Amostras.
+ */
+void Filter_BiquadF32(FilterBiquadF32_t *f, const float *in, float *out, uint16_t count);
+void Filter_BiquadQ15(FilterBiquadQ15_t *f, const int16_t *in, int16_t *out, uint16_t count);
+void Filter_BiquadQ31(FilterBiquadQ31_t *f, const int32_t *in, int32_t *out, uint16_t count);
+
+/**
+ * Inicia um FIR com decimacao (estado zerado).
+ * @param f Filtro.
+ * @param taps Coeficientes.
+ * @param factor Decimacao (1 = sem decimacao).
+ * @param coeffs Coeficientes h[0..taps-1].
+ * @param state FILTER_FIR_STATE(taps) posicoes.
+ * @return false se taps ou factor forem zero.
+ */
+bool Filter_FirDecimInitF32(FilterFirDecimF32_t *f, uint16_t taps, uint8_t factor, const float *coeffs, float *state);
+bool Filter_FirDecimInitQ15(FilterFirDecimQ15_t *f, uint16_t taps, uint8_t factor, const int16_t *coeffs, int16_t *state);
+bool Filter_FirDecimInitQ31(FilterFirDecimQ31_t *f, uint16_t taps, uint8_t factor, const int32_t *coeffs, int32_t *state);
+
+/**
+ * Filtra e decima um bloco; a fase continua no bloco seguinte.
+ * @param f Filtro.
+ * @param in Entrada.
+ * @param out Saida (pode ser igual a in).
+ * @param count Amostras de entrada.
+ * @return Amostras de saida.
+ */
+uint16_t Filter_FirDecimF32(FilterFirDecimF32_t *f, const float *in, float *out, uint16_t count);
+uint16_t Filter_FirDecimQ15(FilterFirDecimQ15_t *f, const int16_t *in, int16_t *out, uint16_t count);
+uint16_t Filter_FirDecimQ31(FilterFirDecimQ31_t *f, const int32_t *in, int32_t *out, uint16_t count);
+
+/**
+ * Inicia uma media movel (vazia: ate encher, divide pelas amostras recebidas).
+ * @param f Filtro.
+ * @param length Amostras da janela.
+ * @param buf length posicoes.
+ * @return false se length for zero.
+ */
+bool Filter_MovAvgInitF32(FilterMovAvgF32_t *f, uint16_t length, float *buf);
+bool Filter_MovAvgInitQ15(FilterMovAvgQ15_t *f, uint16_t length, int16_t *buf);
+bool Filter_MovAvgInitQ31(FilterMovAvgQ31_t *f, uint16_t length, int32_t *buf);
+
+/**
+ * Filtra um bloco.
+ * @param f Filtro.
+ * @param in Entrada.
+ * @param out Saida (pode ser igual a in).
+ * @param count Amostras.
+ */
+void Filter_MovAvgF32(FilterMovAvgF32_t *f, const float *in, float *out, uint16_t count);
+void Filter_MovAvgQ15(FilterMovAvgQ15_t *f, const int16_t *in, int16_t *out, uint16_t count);
+void Filter_MovAvgQ31(FilterMovAvgQ31_t *f, const int32_t *in, int32_t *out, uint16_t count);
+
+/**
+ * Inicia uma exponencial.
+ * @param f Filtro.
+ * @param alpha Peso da amostra nova, em (0, 1] (Q15/Q31 nos formatos Q).
+ */
+void Filter_EmaInitF32(FilterEmaF32_t *f, float alpha);
+void Filter_EmaInitQ15(FilterEmaQ15_t *f, int16_t alpha);
+void Filter_EmaInitQ31(FilterEmaQ31_t *f, int32_t alpha);
+
+/**
+ * Filtra um bloco.
+ * @param f Filtro.
+ * @param in Entrada.
+ * @param out Saida (pode ser igual a in).
+ * @param count Amostras.
+ */
+void Filter_EmaF32(FilterEmaF32_t *f, const float *in, float *out, uint16_t count);
+void Filter_EmaQ15(FilterEmaQ15_t *f, const int16_t *in, int16_t *out, uint16_t count);
+void Filter_EmaQ31(FilterEmaQ31_t *f, const int32_t *in, int32_t *out, uint16_t count);
+
+/**
+ * Projeta um Butterworth como cascata de biquads.
+ * @param type FILTER_LOWPASS ou FILTER_HIGHPASS.
+ * @param order Ordem par, 2 a FILTER_MAX_ORDER.
+ * @param fc Corte (-3 dB) dividido pela taxa de amostragem, em (0, 0.5).
+ * @param coeffs Saida com order / 2 secoes.
+ * @return Secoes, ou 0 se os parametros forem invalidos.
+ */
+uint8_t Filter_DesignButterworth(FilterType_e type, uint8_t order, float fc, float *coeffs);
+
+/**
+ * Projeta um FIR passa-baixas por janela de Hamming com ganho DC unitario.
+ * @param h Saida com taps coeficientes.
+ * @param taps Coeficientes (impar para atraso inteiro).
+ * @param fc Corte dividido pela taxa de amostragem, em (0, 0.5).
+ * @return false se os parametros forem invalidos.
+ */
+bool Filter_DesignFirLowpass(float *h, uint16_t taps, float fc);
+
+/**
+ * Converte coeficientes de biquad para Q15 ou Q31 com o menor shift que os
+ * faz caber em [-1, 1).
+ * @param c Coeficientes em float (stages * FILTER_BIQUAD_COEFFS).
+ * @param stages Secoes.
+ * @param q Saida.
+ * @return shift a usar no Init.
+ */
+uint8_t Filter_BiquadToQ15(const float *c, uint8_t stages, int16_t *q);
+uint8_t Filter_BiquadToQ31(const float *c, uint8_t stages, int32_t *q);
+
+/**
+ * Converte coeficientes de FIR (ou amostras) de float para Q15 ou Q31 com saturacao.
+ * @param in Valores em [-1, 1).
+ * @param out Saida.
+ * @param count Quantidade.
+ */
+void Filter_FloatToQ15(const float *in, int16_t *out, uint16_t count);
+void Filter_FloatToQ31(const float *in, int32_t *out, uint16_t count);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _FILTER_H_ */
@@ -0,0 +1,682 @@
+/**
+ * @file    freertos_lowpower.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.2.1
+ * @brief   Tick do FreeRTOS no LPTIM1 (LSE) e tickless idle com STOP2
+ * @details
+ * Macros que precisam estar habilitadas no freeRTOS
+ * configUSE_TICKLESS_IDLE  1 (vPortSetupTimerInterrupt e
+ *                             vPortSuppressTicksAndSleep deste arquivo)
+ *
+ * O LPTIM1 conta o LSE livre de 0 a 0xFFFF e o comparador marca a
+ * fronteira do proximo tick. O estado guarda o contador na fronteira do
+ * ultimo tick entregue e o passo ate a seguinte; quem acorda conta quantas
+ * fronteiras passaram pelo contador, entao nenhum tick se perde por
+ * interrupcao atrasada ou sono longo. Os ticks contados e ainda nao
+ * entregues ao kernel ficam em lpOwed e saem na interrupcao do LPTIM1.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "freertos_utils.h"
+#include "task.h"
+#include "timebase/timebase.h"
+#include "cpuload/cpuload.h"
+
+#include <string.h>
+
+#if defined(USE_SYSVIEW)
+#include "SEGGER_SYSVIEW.h"
+#endif
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define RTOS_LP_CLOCK_HZ			LSE_VALUE
+
+/** @brief Passo inteiro do tick e a sobra distribuida pelos ticks (32 e 768 a 1 kHz) */
+#define RTOS_LP_STEP				(RTOS_LP_CLOCK_HZ / configTICK_RATE_HZ)
+#define RTOS_LP_STEP_REM			(RTOS_LP_CLOCK_HZ % configTICK_RATE_HZ)
+
+/**
+ * @brief Maior sono: o contador de 16 bits da a volta em 2 s e a distancia
+ * ate a ultima fronteira entregue tem que caber nele mesmo com atraso.
+ */
+#define RTOS_LP_MAX_IDLE_TICKS		((TickType_t) (60000UL / (RTOS_LP_STEP + 1)))
+
+/** @brief Contagens que a escrita do comparador leva para valer (sincroniza com o LSE) */
+#define RTOS_LP_CMP_MARGIN			3
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Fronteira do ultimo tick contado, passo ate a proxima e sobra acumulada */
+static uint16_t lpTickCnt = 0;
+static uint16_t lpStep = 0;
+static uint32_t lpFrac = 0;
+
+/** @brief Valor escrito no comparador */
+static uint16_t lpCmp = 0;
+
+/** @brief Ticks contados e ainda nao entregues ao kernel */
+static volatile uint32_t lpOwed = 0;
+
+/** @brief Fracao de ciclo que sobrou na conversao do tempo em STOP2 */
+static uint32_t lpCycRem = 0;
+
+/** @brief A volta anterior da idle nao suprimiu ticks */
+static bool lpIdlePending = false;
+
+static volatile uint32_t lpLocks = 0;
+static volatile TickType_t lpAwakeUntil = 0;
+
+static UART_HandleTypeDef *lpConsole = NULL;
+static GPIO_TypeDef *lpConsolePort = NULL;
+static uint16_t lpConsolePin = 0;
+
+static RtosLowPowerStats_t lpStats;
+static uint64_t lpStatsStart = 0;
+
+/** @brief Canais verificados antes do STOP2 */
+static DMA_Channel_TypeDef * const lpDmaChannels[] =
+{
+	DMA1_Channel1, DMA1_Channel2, DMA1_Channel3, DMA1_Channel4, DMA1_Channel5, DMA1_Channel6, DMA1_Channel7,
+	DMA2_Channel1, DMA2_Channel2, DMA2_Channel3, DMA2_Channel4, DMA2_Channel5, DMA2_Channel6, DMA2_Channel7,
+};
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+#if (configUSE_TICKLESS_IDLE > 0)
+
+/**
+ * Le o contador do LPTIM1; no dominio do LSE a leitura so vale quando duas
+ * seguidas batem.
+ * @return Contador.
+ */
+static uint16_t RTOS_LpCount(void);
+
+/**
+ * Espera o contador mudar: alinha a leitura do CYCCNT com uma borda do LSE.
+ * @return Contador depois da borda.
+ */
+static uint16_t RTOS_LpWaitEdge(void);
+
+/**
+ * Proximo passo entre fronteiras de tick.
+ * @param frac Sobra acumulada, atualizada.
+ * @return Contagens do LSE.
+ */
+static uint16_t RTOS_LpNextStep(uint32_t *frac);
+
+/**
+ * Escreve o comparador depois que a escrita anterior terminou.
+ * @param cmp Contagem da proxima interrupcao.
+ */
+static void RTOS_LpSetCompare(uint16_t cmp);
+
+/**
+ * Conta as fronteiras que o contador ja passou e arma o comparador na
+ * seguinte, esperando ela passar se estiver perto demais para a escrita.
+ * @return Ticks contados.
+ */
+static uint32_t RTOS_LpCatchUp(void);
+
+/**
+ * Motivo para nao entrar em STOP2.
+ * @return Motivo, ou RTOS_LP_BLOCK_COUNT quando o STOP2 e permitido.
+ */
+static RtosLowPowerBlock_e RTOS_LpStopBlocker(void);
+
+/** @brief Entra em STOP2 com o RX do console no EXTI e volta com o clock de antes. */
+static void RTOS_LpStop2(void);
+
+/**
+ * Religa o oscilador de entrada do PLL e espera ficar pronto: o STOP2 desliga
+ * HSE e HSI16, e o PLL nao trava sem a fonte.
+ */
+static void RTOS_LpPllSource(void);
+
+/**
+ * Converte contagens do LSE em ciclos do core, guardando a fracao.
+ * @param counts Contagens.
+ * @return Ciclos.
+ */
+static uint32_t RTOS_LpToCycles(uint16_t counts);
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+#if (configUSE_TICKLESS_IDLE > 0)
+
+static uint16_t RTOS_LpCount(void)
+{
+	uint32_t a, b;
+
+	do
+	{
+		a = LPTIM1->CNT;
+		b = LPTIM1->CNT;
+	} while (a != b);
+
+	return (uint16_t) a;
+}
+
+static uint16_t RTOS_LpWaitEdge(void)
+{
+	uint16_t start = RTOS_LpCount();
+	uint16_t now;
+
+	do
+	{
+		now = RTOS_LpCount();
+	} while (now == start);
+
+	return now;
+}
+
+static uint16_t RTOS_LpNextStep(uint32_t *frac)
+{
+	*frac += RTOS_LP_STEP_REM;
+
+	if (*frac >= configTICK_RATE_HZ)
+	{
+		*frac -= configTICK_RATE_HZ;
+		return RTOS_LP_STEP + 1;
+	}
+
+	return RTOS_LP_STEP;
+}
+
+static void RTOS_LpSetCompare(uint16_t cmp)
+{
+	if (cmp == lpCmp)
+	{
+		return;
+	}
+
+	while ((LPTIM1->ISR & LPTIM_ISR_CMPOK) == 0)
+	{
+	}
+
+	LPTIM1->ICR = LPTIM_ICR_CMPOKCF;
+	LPTIM1->CMP = cmp;
+	lpCmp = cmp;
+}
+
+static uint32_t RTOS_LpCatchUp(void)
+{
+	uint32_t ticks = 0;
+	uint16_t now;
+
+	for (;;)
+	{
+		now = RTOS_LpCount();
+
+		while ((uint16_t) (now - lpTickCnt) >= lpStep)
+		{
+			lpTickCnt += lpStep;
+			lpStep = RTOS_LpNextStep(&lpFrac);
+			ticks++;
+		}
+
+		if ((uint16_t) (lpTickCnt + lpStep - now) > RTOS_LP_CMP_MARGIN)
+		{
+			break;
+		}
+	}
+
+	RTOS_LpSetCompare((uint16_t) (lpTickCnt + lpStep));
+
+	return ticks;
+}
+
+static RtosLowPowerBlock_e RTOS_LpStopBlocker(void)
+{
+	uint8_t i;
+
+	if (lpLocks > 0)
+	{
+		return RTOS_LP_BLOCK_LOCK;
+	}
+
+	if ((int32_t) (xTaskGetTickCount() - lpAwakeUntil) < 0)
+	{
+		return RTOS_LP_BLOCK_CONSOLE;
+	}
+
+	for (i = 0; i < (sizeof(lpDmaChannels) / sizeof(lpDmaChannels[0])); i++)
+	{
+		if (((lpDmaChannels[i]->CCR & DMA_CCR_EN) != 0) &&
+				((lpConsole == NULL) || (lpConsole->hdmarx == NULL) || (lpDmaChannels[i] != lpConsole->hdmarx->Instance)))
+		{
+			return RTOS_LP_BLOCK_DMA;
+		}
+	}
+
+	/* Com o clock do periferico desligado os registradores leem zero */
+	if (((I2C1->ISR | I2C2->ISR | I2C3->ISR) & I2C_ISR_BUSY) != 0)
+	{
+		return RTOS_LP_BLOCK_BUS;
+	}
+
+	if (((SPI1->SR | SPI2->SR | SPI3->SR) & SPI_SR_BSY) != 0)
+	{
+		return RTOS_LP_BLOCK_BUS;
+	}
+
+	if ((lpConsole != NULL) && ((lpConsole->Instance->ISR & USART_ISR_TC) == 0))
+	{
+		return RTOS_LP_BLOCK_BUS;
+	}
+
+	return RTOS_LP_BLOCK_COUNT;
+}
+
+static void RTOS_LpStop2(void)
+{
+	uint32_t cr = RCC->CR;
+	uint32_t sw = RCC->CFGR & RCC_CFGR_SW;
+	uint32_t line = 0, shift = 0, exticr = 0, imr = 0, rtsr = 0, ftsr = 0;
+	IRQn_Type irq = EXTI0_IRQn;
+	bool irq_on = false;
+
+	/* RX do console na linha do EXTI do pino: a borda do start bit acorda */
+	if (lpConsolePort != NULL)
+	{
+		line = POSITION_VAL(lpConsolePin);
+		shift = 4 * (line & 3);
+		irq = (line < 5) ? (IRQn_Type) (EXTI0_IRQn + line) : ((line < 10) ? EXTI9_5_IRQn : EXTI15_10_IRQn);
+
+		exticr = SYSCFG->EXTICR[line >> 2];
+		imr = EXTI->IMR1;
+		rtsr = EXTI->RTSR1;
+		ftsr = EXTI->FTSR1;
+		irq_on = (NVIC_GetEnableIRQ(irq) != 0);
+
+		SYSCFG->EXTICR[line >> 2] = (exticr & ~(0xFUL << shift)) | (GPIO_GET_INDEX(lpConsolePort) << shift);
+		EXTI->RTSR1 = rtsr & ~(uint32_t) lpConsolePin;
+		EXTI->FTSR1 = ftsr | lpConsolePin;
+		EXTI->PR1 = lpConsolePin;
+		EXTI->IMR1 = imr | lpConsolePin;
+		NVIC_EnableIRQ(irq);
+	}
+
+	HAL_PWREx_EnterSTOP2Mode(PWR_STOPENTRY_WFI);
+
+	/* Acorda no MSI: religa os PLLs que estavam ligados e volta o clock do sistema */
+	if ((cr & RCC_CR_PLLON) != 0)
+	{
+		RTOS_LpPllSource();
+		SET_BIT(RCC->CR, RCC_CR_PLLON);
+		while ((RCC->CR & RCC_CR_PLLRDY) == 0)
+		{
+		}
+	}
+
+	if ((cr & RCC_CR_PLLSAI1ON) != 0)
+	{
+		RTOS_LpPllSource();
+		SET_BIT(RCC->CR, RCC_CR_PLLSAI1ON);
+		while ((RCC->CR & RCC_CR_PLLSAI1RDY) == 0)
+		{
+		}
+	}
+
+	MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, sw);
+	while ((RCC->CFGR & RCC_CFGR_SWS) != (sw << RCC_CFGR_SWS_Pos))
+	{
+	}
+
+	if (lpConsolePort != NULL)
+	{
+		if ((EXTI->PR1 & lpConsolePin) != 0)
+		{
+			lpStats.console_wakes++;
+			lpAwakeUntil = xTaskGetTickCount() + pdMS_TO_TICKS(RTOS_LP_CONSOLE_AWAKE_MS);
+		}
+
+		/* Pendencia apagada antes de devolver a linha: a callback do pino original nao ve a borda */
+		SYSCFG->EXTICR[line >> 2] = exticr;
+		EXTI->IMR1 = imr;
+		EXTI->RTSR1 = rtsr;
+		EXTI->FTSR1 = ftsr;
+		EXTI->PR1 = lpConsolePin;
+		if (irq_on == false)
+		{
+			NVIC_DisableIRQ(irq);
+			NVIC_ClearPendingIRQ(irq);
+		}
+	}
+}
+
+static void RTOS_LpPllSource(void)
+{
+	/* PLL e PLLSAI1 dividem a mesma fonte (PLLSRC) */
+	switch (RCC->PLLCFGR & RCC_PLLCFGR_PLLSRC)
+	{
+	case RCC_PLLCFGR_PLLSRC_HSE:
+		SET_BIT(RCC->CR, RCC_CR_HSEON);
+		while ((RCC->CR & RCC_CR_HSERDY) == 0)
+		{
+		}
+		break;
+
+	case RCC_PLLCFGR_PLLSRC_HSI:
+		SET_BIT(RCC->CR, RCC_CR_HSION);
+		while ((RCC->CR & RCC_CR_HSIRDY) == 0)
+		{
+		}
+		break;
+
+	default:
+		/* O MSI e o clock de saida do STOP2, mas so serve ao PLL estavel */
+		while ((RCC->CR & RCC_CR_MSIRDY) == 0)
+		{
+		}
+		break;
+	}
+}
+
+static uint32_t RTOS_LpToCycles(uint16_t counts)
+{
+	uint64_t total = (uint64_t) counts * SystemCoreClock + lpCycRem;
+
+	lpCycRem = (uint32_t) (total % RTOS_LP_CLOCK_HZ);
+
+	return (uint32_t) (total / RTOS_LP_CLOCK_HZ);
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+//==============================================================================
+// PORT OF FREERTOS
+//==============================================================================
+
+#if (configUSE_TICKLESS_IDLE > 0)
+
+extern TIM_HandleTypeDef htim17;
+
+void vPortSetupTimerInterrupt(void)
+{
+	/* O HAL_GetTick passa a andar com o tick do kernel */
+	HAL_TIM_Base_Stop_IT(&htim17);
+	__HAL_RCC_TIM17_CLK_DISABLE();
+
+	__HAL_RCC_LPTIM1_CONFIG(RCC_LPTIM1CLKSOURCE_LSE);
+	__HAL_RCC_LPTIM1_CLK_ENABLE();
+	__HAL_RCC_LPTIM1_FORCE_RESET();
+	__HAL_RCC_LPTIM1_RELEASE_RESET();
+
+	/* Clock interno (LSE) sem prescaler; IER so pode ser escrito desligado */
+	LPTIM1->CFGR = 0;
+	LPTIM1->IER = LPTIM_IER_CMPMIE;
+	LPTIM1->CR = LPTIM_CR_ENABLE;
+
+	LPTIM1->ARR = 0xFFFF;
+	while ((LPTIM1->ISR & LPTIM_ISR_ARROK) == 0)
+	{
+	}
+	LPTIM1->ICR = LPTIM_ICR_ARROKCF;
+
+	lpTickCnt = 0;
+	lpFrac = 0;
+	lpOwed = 0;
+	lpStep = RTOS_LpNextStep(&lpFrac);
+
+	/* CMPOK fica ligado: RTOS_LpSetCompare espera por ele antes de cada escrita */
+	lpCmp = lpStep;
+	LPTIM1->CMP = lpCmp;
+	while ((LPTIM1->ISR & LPTIM_ISR_CMPOK) == 0)
+	{
+	}
+
+	/* Linha 32 do EXTI: o LPTIM1 acorda do STOP2 */
+	EXTI->IMR2 |= EXTI_IMR2_IM32;
+
+	HAL_NVIC_SetPriority(LPTIM1_IRQn, configLIBRARY_LOWEST_INTERRUPT_PRIORITY, 0);
+	HAL_NVIC_EnableIRQ(LPTIM1_IRQn);
+
+#if defined(USE_SYSVIEW)
+	/* A gravacao pelo debugger sobrevive ao STOP2; o consumo deixa de valer */
+	DBGMCU->CR |= DBGMCU_CR_DBG_STOP;
+#endif
+
+	lpStatsStart = Timebase_Cycles();
+
+	LPTIM1->CR |= LPTIM_CR_CNTSTRT;
+}
+
+void vPortSuppressTicksAndSleep(TickType_t xExpectedIdleTime)
+{
+	RtosLowPowerBlock_e block;
+	uint32_t frac, start, cycles, ticks, step;
+	uint16_t target, from, to;
+	TickType_t i;
+
+	lpIdlePending = false;
+
+	if (xExpectedIdleTime > RTOS_LP_MAX_IDLE_TICKS)
+	{
+		xExpectedIdleTime = RTOS_LP_MAX_IDLE_TICKS;
+	}
+
+	__disable_irq();
+	__DSB();
+	__ISB();
+
+	/* Uma task ficou pronta, ou ha tick a entregar: a interrupcao vem primeiro */
+	if ((eTaskConfirmSleepModeStatus() == eAbortSleep) || (lpOwed > 0) || ((LPTIM1->ISR & LPTIM_ISR_CMPM) != 0))
+	{
+		__enable_irq();
+		return;
+	}
+
+	/* Fronteira do tick em que a proxima task acorda */
+	target = (uint16_t) (lpTickCnt + lpStep);
+	frac = lpFrac;
+	for (i = 1; i < xExpectedIdleTime; i++)
+	{
+		target += RTOS_LpNextStep(&frac);
+	}
+	RTOS_LpSetCompare(target);
+
+	block = RTOS_LpStopBlocker();
+	if (block == RTOS_LP_BLOCK_COUNT)
+	{
+		from = RTOS_LpWaitEdge();
+		start = Timebase_Cycles32();
+
+		RTOS_LpStop2();
+
+		to = RTOS_LpWaitEdge();
+		cycles = RTOS_LpToCycles((uint16_t) (to - from));
+		Timebase_Correct(start, cycles);
+
+		lpStats.stops++;
+		lpStats.stop_cycles += cycles;
+	}
+	else
+	{
+		start = Timebase_Cycles32();
+		__DSB();
+		__WFI();
+		cycles = Timebase_Cycles32() - start;
+
+		lpStats.blocked[block]++;
+		lpStats.sleeps++;
+		lpStats.sleep_cycles += cycles;
+	}
+
+	lpStats.wakeups++;
+	CpuLoad_AddIdle(cycles);
+
+	/* O ultimo tick fica para a interrupcao: ele pode acordar a task */
+	ticks = RTOS_LpCatchUp();
+	step = (ticks < xExpectedIdleTime) ? ticks : (xExpectedIdleTime - 1);
+
+	vTaskStepTick(step);
+	uwTick += step * uwTickFreq;
+	lpStats.suppressed += step;
+
+	lpOwed += ticks - step;
+	if (lpOwed > 0)
+	{
+		NVIC_SetPendingIRQ(LPTIM1_IRQn);
+	}
+
+	__enable_irq();
+}
+
+void LPTIM1_IRQHandler(void)
+{
+	BaseType_t xSwitchRequired = pdFALSE;
+	uint32_t ticks;
+
+#if defined(USE_SYSVIEW)
+	SEGGER_SYSVIEW_RecordEnterISR();
+#endif
+
+	LPTIM1->ICR = LPTIM_ICR_CMPMCF;
+
+	/* Mesma prioridade do SysTick que substitui: a mais baixa */
+	portDISABLE_INTERRUPTS();
+
+	ticks = lpOwed + RTOS_LpCatchUp();
+	lpOwed = 0;
+
+	while (ticks > 0)
+	{
+		HAL_IncTick();
+		if (xTaskIncrementTick() != pdFALSE)
+		{
+			xSwitchRequired = pdTRUE;
+		}
+		ticks--;
+	}
+
+	portENABLE_INTERRUPTS();
+
+	portEND_SWITCHING_ISR(xSwitchRequired);
+
+#if defined(USE_SYSVIEW)
+	SEGGER_SYSVIEW_RecordExitISR();
+#endif
+}
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void RTOS_LowPowerSetConsole(UART_HandleTypeDef *huart, GPIO_TypeDef *rx_port, uint16_t rx_pin)
+{
+	taskENTER_CRITICAL();
+	lpConsole = huart;
+	lpConsolePort = rx_port;
+	lpConsolePin = rx_pin;
+	taskEXIT_CRITICAL();
+}
+
+void RTOS_LowPowerLock(void)
+{
+	taskENTER_CRITICAL();
+	lpLocks++;
+	taskEXIT_CRITICAL();
+}
+
+void RTOS_LowPowerUnlock(void)
+{
+	taskENTER_CRITICAL();
+	if (lpLocks > 0)
+	{
+		lpLocks--;
+	}
+	taskEXIT_CRITICAL();
+}
+
+void RTOS_LowPowerConsoleActivity(void)
+{
+	lpAwakeUntil = xTaskGetTickCountFromISR() + pdMS_TO_TICKS(RTOS_LP_CONSOLE_AWAKE_MS);
+}
+
+void RTOS_LowPowerIdleHook(void)
+{
+	uint32_t start, cycles;
+
+	/* Duas voltas seguidas sem suprimir: faltam menos de 2 ticks, dorme ate o proximo */
+	if (lpIdlePending == true)
+	{
+		__disable_irq();
+
+		start = Timebase_Cycles32();
+		__DSB();
+		__WFI();
+		cycles = Timebase_Cycles32() - start;
+
+		CpuLoad_AddIdle(cycles);
+		lpStats.wakeups++;
+		lpStats.short_sleeps++;
+		lpStats.sleep_cycles += cycles;
+
+		__enable_irq();
+	}
+
+	lpIdlePending = true;
+}
+
+void RTOS_LowPowerGetStats(RtosLowPowerStats_t *stats)
+{
+	uint64_t now = Timebase_Cycles();
+	uint64_t start;
+
+	taskENTER_CRITICAL();
+	*stats = lpStats;
+	start = lpStatsStart;
+	taskEXIT_CRITICAL();
+
+	stats->elapsed_cycles = now - start;
+	stats->elapsed_ms = (uint32_t) (stats->elapsed_cycles / (Timebase_Hz() / 1000));
+}
+
+void RTOS_LowPowerResetStats(void)
+{
+	taskENTER_CRITICAL();
+	memset(&lpStats, 0, sizeof(lpStats));
+	lpStatsStart = Timebase_Cycles();
+	taskEXIT_CRITICAL();
+}
+
+void RTOS_LowPowerEstimate(const RtosLowPowerStats_t *stats, uint32_t *now_ua, uint32_t *ref_ua)
+{
+	uint64_t total = stats->elapsed_cycles;
+	uint64_t idle = stats->stop_cycles + stats->sleep_cycles;
+	uint64_t run, ticks;
+
+	if ((total == 0) || (idle > total))
+	{
+		*now_ua = 0;
+		*ref_ua = 0;
+		return;
+	}
+
+	run = total - idle;
+
+	*now_ua = (uint32_t) ((run * RTOS_LP_RUN_UA + stats->sleep_cycles * RTOS_LP_SLEEP_UA +
+			stats->stop_cycles * RTOS_LP_STOP2_UA) / total);
+
+	/* Referencia: o mesmo trabalho, a idle em Sleep e os ticks suprimidos acordando o core */
+	ticks = (uint64_t) stats->suppressed * RTOS_LP_TICK_CYCLES;
+	ticks = (ticks > idle) ? idle : ticks;
+	*ref_ua = (uint32_t) (((run + ticks) * RTOS_LP_RUN_UA + (idle - ticks) * RTOS_LP_SLEEP_UA) / total);
+}
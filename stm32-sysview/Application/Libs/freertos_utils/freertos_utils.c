@@ -2,11 +2,14 @@
  * @file    freertos_debug.c
  * @author  Jorge Guzman,
  * @date    Jul 23, 2017
- * @version 0.1.0.
+ * @version 0.3.0.
  * @brief   Biblioteca para monitorar o status do FreeRTOS
  * @details
  * Macros que precisam estar habilitadas no freeRTOS
  * configUSE_IDLE_HOOK  1 (Habilita a funcao vApplicationIdleHook)
+ *
+ * O hook da idle precisa retornar: e a task idle que libera o TCB e a
+ * pilha das tasks apagadas com vTaskDelete.
  */
 
 //==============================================================================
@@ -15,18 +18,34 @@
 
 #include "setup_hw.h"
 #include "task.h"
+#include "freertos_utils.h"
+#include "cpuload/cpuload.h"
+
+#include <string.h>
 
 //==============================================================================
 // PRIVATE DEFINITIONS
 //==============================================================================
 
-#define SIZE_RTOS_BUFF			1024
 #define heap_threshold  		(configTOTAL_HEAP_SIZE/10)*2
 
 //==============================================================================
 // PRIVATE VARIABLES
 //==============================================================================
 
+#if (configGENERATE_RUN_TIME_STATS > 0) && (configUSE_TRACE_FACILITY > 0)
+
+/** @brief Vetor do uxTaskGetSystemState; so usado com o escalonador suspenso */
+static TaskStatus_t rtosStatus[RTOS_SNAP_MAX_TASKS];
+
+/** @brief Foto do RTOS_DBG_ShowStatus */
+static RtosSnapshot_t rtosDbgSnap;
+
+/** @brief Letras do vTaskList para cada eTaskState */
+static const char rtosStateChar[] = { 'X', 'R', 'B', 'S', 'D' };
+
+#endif
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
@@ -38,10 +57,13 @@
 #if configUSE_IDLE_HOOK > 0
 void vApplicationIdleHook(void)
 {
-	for (;;)
-	{
-
-	}
+#if configUSE_TICKLESS_IDLE > 0
+	/* Os sonos longos sao do vPortSuppressTicksAndSleep (freertos_lowpower.c) */
+	RTOS_LowPowerIdleHook();
+#else
+	/* Dorme ate a proxima interrupcao e conta o tempo para a carga da CPU */
+	CpuLoad_IdleHook();
+#endif
 }
 #endif /* configUSE_IDLE_HOOK */
 
@@ -95,18 +117,15 @@ void vApplicationTickHook(void)
 // PUBLIC SOURCE CODE
 //==============================================================================
 
-#if (configGENERATE_RUN_TIME_STATS > 0) && (configUSE_STATS_FORMATTING_FUNCTIONS > 0) && (configUSE_TRACE_FACILITY > 0)
+#if (configGENERATE_RUN_TIME_STATS > 0) && (configUSE_TRACE_FACILITY > 0)
 
-/**
- * @brief Buffer que contem as estatisticas do FreeRTOS
- */
-static uint8_t pcWriteBuffer[SIZE_RTOS_BUFF];
-
-uint8_t *RTOS_DBG_ShowStatus(void)
+void RTOS_DBG_ShowStatus(void)
 {
-	uint16_t heap_curr;
+	RtosTaskInfo_t *task;
 	uint32_t cpu_clock;
 	uint32_t ticks_hz;
+	uint32_t permil;
+	uint8_t i;
 
 	DBG("=================================================");
 	DBG("\t\tCPU");
@@ -116,15 +135,20 @@ uint8_t *RTOS_DBG_ShowStatus(void)
 	DBG("Clock CPU  : %li Hz", cpu_clock);
 	DBG("RTOS ticks : %li Hz", ticks_hz);
 
+	if (RTOS_Snapshot(&rtosDbgSnap) != HAL_OK)
+	{
+		DBG("(X) Mais de %d tasks", RTOS_SNAP_MAX_TASKS);
+		return;
+	}
+
 	DBG("=================================================");
 	DBG("\t\tHEAP");
 	DBG("=================================================");
-	heap_curr = xPortGetFreeHeapSize();
-
 	DBG("Size heap: %i", configTOTAL_HEAP_SIZE);
-	DBG("Free heap: %d", heap_curr);
+	DBG("Free heap: %lu", rtosDbgSnap.heap_free);
+	DBG("Min heap : %lu", rtosDbgSnap.heap_min);
 
-	if (heap_curr < heap_threshold)
+	if (rtosDbgSnap.heap_free < heap_threshold)
 	{
 		DBG("(X) Heap perto do limite");
 	}
@@ -133,17 +157,104 @@ uint8_t *RTOS_DBG_ShowStatus(void)
 	DBG("=================================================");
 	DBG("Task\t\tState\tPrio\tStack\tNum");
 	DBG("=================================================");
-	vTaskList((char *)&pcWriteBuffer);
-	DBG("%s", pcWriteBuffer);
+	for (i = 0; i < rtosDbgSnap.count; i++)
+	{
+		task = &rtosDbgSnap.tasks[i];
+		DBG("%-*s\t%c\t%u\t%u\t%u", configMAX_TASK_NAME_LEN - 1, task->name,
+				(task->state < sizeof(rtosStateChar)) ? rtosStateChar[task->state] : '?',
+				task->priority, task->stack_free, task->number);
+	}
 
-	/* RTOS Run-Time Statistics */
+	/* RTOS Run-Time Statistics (acumuladas desde o boot) */
 	DBG("=================================================");
 	DBG("Task\t\tAbs Time\t%c Time ", 0x25);
 	DBG("=================================================");
-	vTaskGetRunTimeStats((char *)&pcWriteBuffer);
-	DBG("%s", pcWriteBuffer);
+	for (i = 0; i < rtosDbgSnap.count; i++)
+	{
+		task = &rtosDbgSnap.tasks[i];
+		permil = (rtosDbgSnap.runtime > 0) ? (uint32_t) (((uint64_t) task->runtime * RTOS_SNAP_CPU_FULL) / rtosDbgSnap.runtime) : 0;
+		DBG("%-*s\t%lu\t\t%lu.%lu%c", configMAX_TASK_NAME_LEN - 1, task->name, task->runtime, permil / 10, permil % 10, 0x25);
+	}
+}
 
-	return pcWriteBuffer;
+HAL_StatusTypeDef RTOS_Snapshot(RtosSnapshot_t *snap)
+{
+	RtosTaskInfo_t *task;
+	UBaseType_t n, i;
+	uint32_t total = 0;
+
+	/* O vetor e unico: a copia para a foto fica dentro da mesma suspensao */
+	vTaskSuspendAll();
+
+	n = uxTaskGetSystemState(rtosStatus, RTOS_SNAP_MAX_TASKS, &total);
+
+	for (i = 0; i < n; i++)
+	{
+		/* O nome aponta para o TCB: copia antes que a task possa ser apagada */
+		task = &snap->tasks[i];
+		strncpy(task->name, rtosStatus[i].pcTaskName, configMAX_TASK_NAME_LEN - 1);
+		task->name[configMAX_TASK_NAME_LEN - 1] = '\0';
+		task->runtime = rtosStatus[i].ulRunTimeCounter;
+		task->number = (uint16_t) rtosStatus[i].xTaskNumber;
+		task->stack_free = rtosStatus[i].usStackHighWaterMark;
+		task->cpu = 0;
+		task->state = (uint8_t) rtosStatus[i].eCurrentState;
+		task->priority = (uint8_t) rtosStatus[i].uxCurrentPriority;
+		task->base_priority = (uint8_t) rtosStatus[i].uxBasePriority;
+	}
+
+	(void) xTaskResumeAll();
+
+	snap->runtime = total;
+	snap->interval = 0;
+	snap->count = (uint8_t) n;
+	snap->heap_free = xPortGetFreeHeapSize();
+	snap->heap_min = xPortGetMinimumEverFreeHeapSize();
+
+	return (n > 0) ? HAL_OK : HAL_ERROR;
+}
+
+void RTOS_SamplerInit(RtosSampler_t *sampler)
+{
+	memset(sampler, 0, sizeof(RtosSampler_t));
+}
+
+void RTOS_SamplerUpdate(RtosSampler_t *sampler, RtosSnapshot_t *snap)
+{
+	RtosTaskInfo_t *task;
+	uint32_t delta;
+	uint64_t cpu;
+	uint8_t i, k;
+
+	snap->interval = (sampler->valid == true) ? (snap->runtime - sampler->runtime) : snap->runtime;
+
+	for (i = 0; i < snap->count; i++)
+	{
+		task = &snap->tasks[i];
+		delta = task->runtime;
+
+		/* Poucas tasks: a busca linear custa menos que manter um indice */
+		for (k = 0; (sampler->valid == true) && (k < sampler->count); k++)
+		{
+			if (sampler->number[k] == task->number)
+			{
+				delta = task->runtime - sampler->task_runtime[k];
+				break;
+			}
+		}
+
+		cpu = (snap->interval > 0) ? (((uint64_t) delta * RTOS_SNAP_CPU_FULL) / snap->interval) : 0;
+		task->cpu = (uint16_t) ((cpu > RTOS_SNAP_CPU_FULL) ? RTOS_SNAP_CPU_FULL : cpu);
+	}
+
+	for (i = 0; i < snap->count; i++)
+	{
+		sampler->number[i] = snap->tasks[i].number;
+		sampler->task_runtime[i] = snap->tasks[i].runtime;
+	}
+	sampler->count = snap->count;
+	sampler->runtime = snap->runtime;
+	sampler->valid = true;
 }
 
 #else
@@ -154,5 +265,3 @@ __weak void RTOS_DBG_ShowStatus(void)
 }
 
 #endif
-
-
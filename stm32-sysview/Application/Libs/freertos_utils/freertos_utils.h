@@ -2,9 +2,39 @@
  * @file    freertos_debug.h
  * @author  Jorge Guzman,
  * @date    Mai 23, 2018
- * @version 0.1.0.
+ * @version 0.3.2.
  * @brief   Biblioteca para monitorar o status da CPU usando FreeRTOS.
  * @details
+ * Com configUSE_TICKLESS_IDLE o tick do kernel vem do LPTIM1 no LSE
+ * (freertos_lowpower.c) em vez do SysTick: 32768 Hz nao divide 1000 Hz,
+ * entao os passos alternam entre 32 e 33 contagens e a media fica em 1 ms
+ * exato. O mesmo tick conta o HAL_GetTick; o TIM17 so conta ate o
+ * escalonador partir.
+ *
+ * Quando a proxima task acorda em 2 ticks ou mais, a idle suprime os ticks
+ * ate la e dorme. Entra em STOP2 (1-2 uA no MCU) quando nada precisa de
+ * clock: nenhum canal de DMA ligado alem da recepcao circular do console,
+ * I2C, SPI e a transmissao do console parados, nenhuma trava
+ * (RTOS_LowPowerLock) e o console quieto por RTOS_LP_CONSOLE_AWAKE_MS.
+ * Senao dorme em Sleep, com o PLL ligado. Na saida do STOP2 o PLL volta a
+ * ser o clock do sistema antes de qualquer interrupcao ser atendida, o
+ * CYCCNT e adiantado pelo tempo medido no LPTIM1 (Timebase_Correct) e os
+ * ticks passados entram no kernel (vTaskStepTick) e no HAL.
+ *
+ * O RX do console nao acorda do STOP2: a linha do EXTI do pino de RX e
+ * ligada a ele enquanto o MCU dorme, entao o primeiro byte acorda a placa
+ * e se perde; os seguintes chegam, porque cada byte recebido mantem o MCU
+ * fora do STOP2. Os outros canais de DMA ligados impedem o STOP2; a lib de
+ * leds toca no GPIO os padroes so de apagado e aceso do led no PWM e segura
+ * RTOS_LowPowerLock enquanto um padrao precisa do PWM contando. Na saida o
+ * oscilador de entrada do PLL e religado e esperado antes do PLLON.
+ *
+ * RTOS_Snapshot preenche uma foto binaria do sistema (tasks e heap) na
+ * estrutura de quem chama, a partir do uxTaskGetSystemState e sem alocar:
+ * o vTaskList e o vTaskGetRunTimeStats pedem o vetor ao heap e formatam
+ * texto. Os contadores de tempo de execucao sao acumulados desde o boot;
+ * o RtosSampler_t guarda os da foto anterior e transforma cada foto no uso
+ * da CPU de cada task no intervalo entre as duas.
  */
 
 #ifndef __CPU_UTILS_H_
@@ -19,18 +49,166 @@ extern "C" {
 // INCLUDE FILES
 //==============================================================================
 
+#include "setup_hw.h"
+
 #include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Tempo sem STOP2 depois de cada byte recebido pelo console */
+#define RTOS_LP_CONSOLE_AWAKE_MS	5000
+
+/** @brief Consumo tipico do MCU (datasheet, sem perifericos) para a estimativa */
+#define RTOS_LP_RUN_UA				10000	/**< Run a 80 MHz */
+#define RTOS_LP_SLEEP_UA			2600	/**< Sleep a 80 MHz */
+#define RTOS_LP_STOP2_UA			2		/**< STOP2 com LSE e LPTIM1 */
+
+/** @brief Ciclos de um tick do SysTick (entrada, xTaskIncrementTick e saida) */
+#define RTOS_LP_TICK_CYCLES			200
+
+/** @brief Tasks maximas de uma foto (a foto falha se houver mais) */
+#define RTOS_SNAP_MAX_TASKS			24
+
+/** @brief Uso maximo da CPU (permil) */
+#define RTOS_SNAP_CPU_FULL			1000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Motivo para dormir em Sleep em vez de STOP2 */
+typedef enum
+{
+	RTOS_LP_BLOCK_LOCK = 0,     /**< RTOS_LowPowerLock */
+	RTOS_LP_BLOCK_CONSOLE,      /**< Byte recebido ha pouco */
+	RTOS_LP_BLOCK_DMA,          /**< Canal de DMA ligado */
+	RTOS_LP_BLOCK_BUS,          /**< I2C, SPI ou TX do console ocupado */
+	RTOS_LP_BLOCK_COUNT,
+} RtosLowPowerBlock_e;
+
+typedef struct
+{
+	uint32_t wakeups;           /**< Saidas de qualquer sono da idle */
+	uint32_t stops;             /**< Sonos em STOP2 */
+	uint32_t sleeps;            /**< Sonos em Sleep com ticks suprimidos */
+	uint32_t short_sleeps;      /**< WFI ate o proximo tick (menos de 2 ticks livres) */
+	uint32_t console_wakes;     /**< STOP2 interrompidos pelo RX do console */
+	uint32_t suppressed;        /**< Ticks que nao geraram interrupcao */
+	uint32_t blocked[RTOS_LP_BLOCK_COUNT];
+	uint64_t stop_cycles;       /**< Tempo em STOP2, em ciclos do core */
+	uint64_t sleep_cycles;      /**< Tempo em Sleep */
+	uint64_t elapsed_cycles;    /**< Tempo total desde o reset das estatisticas */
+	uint32_t elapsed_ms;
+} RtosLowPowerStats_t;
+
+/** @brief Uma task da foto */
+typedef struct
+{
+	char name[configMAX_TASK_NAME_LEN];
+	uint32_t runtime;           /**< Contador acumulado (portGET_RUN_TIME_COUNTER_VALUE) */
+	uint16_t number;            /**< xTaskNumber: unico, nao e reusado */
+	uint16_t stack_free;        /**< Menor folga da pilha em palavras */
+	uint16_t cpu;               /**< Permil do intervalo (RTOS_SamplerUpdate) */
+	uint8_t state;              /**< eTaskState */
+	uint8_t priority;           /**< Atual (pode estar herdada) */
+	uint8_t base_priority;
+} RtosTaskInfo_t;
+
+/** @brief Foto do sistema */
+typedef struct
+{
+	uint32_t runtime;           /**< Contador total no momento da foto */
+	uint32_t interval;          /**< Tempo desde a foto anterior (RTOS_SamplerUpdate) */
+	uint32_t heap_free;         /**< Bytes */
+	uint32_t heap_min;          /**< Menor heap livre desde o boot */
+	uint8_t count;
+	RtosTaskInfo_t tasks[RTOS_SNAP_MAX_TASKS];
+} RtosSnapshot_t;
+
+/** @brief Contadores da foto anterior, por numero de task */
+typedef struct
+{
+	uint32_t runtime;
+	uint32_t task_runtime[RTOS_SNAP_MAX_TASKS];
+	uint16_t number[RTOS_SNAP_MAX_TASKS];
+	uint8_t count;
+	bool valid;
+} RtosSampler_t;
 
 //==============================================================================
 // PUBLIC FUNCTIONS
 //==============================================================================
 
 /** @brief Function the print in the serial debug the status of FreeRTOS. */
-uint8_t *RTOS_DBG_ShowStatus(void);
-void RTOS_TimerAttachStatics20Khz(void *pTimer20Khz);
-void RTOS_TimerStart20Khz(void);
-void RTOS_TimerStop20Khz(void);
-void RTOS_ISR_Timer20Khz(void);
+void RTOS_DBG_ShowStatus(void);
+
+/**
+ * Tira uma foto das tasks e do heap. O escalonador fica suspenso durante a
+ * leitura (o kernel percorre a pilha de cada task para achar a folga).
+ * @param snap Destino; cpu e interval ficam zerados.
+ * @return HAL_OK, HAL_ERROR se houver mais de RTOS_SNAP_MAX_TASKS tasks.
+ */
+HAL_StatusTypeDef RTOS_Snapshot(RtosSnapshot_t *snap);
+
+/**
+ * Esquece a foto anterior: a proxima atualizacao usa os contadores desde o
+ * boot.
+ * @param sampler Sampler.
+ */
+void RTOS_SamplerInit(RtosSampler_t *sampler);
+
+/**
+ * Calcula o uso da CPU de cada task desde a foto anterior e guarda a atual.
+ * Uma task criada no intervalo conta todo o seu tempo; sem foto anterior o
+ * uso e o acumulado desde o boot. O contador de 32 bits da a volta em
+ * ~57 min: os intervalos devem ser menores.
+ * @param sampler Sampler.
+ * @param snap Foto recem tirada; recebe interval e cpu.
+ */
+void RTOS_SamplerUpdate(RtosSampler_t *sampler, RtosSnapshot_t *snap);
+
+/**
+ * Informa o console usado pelo shell: o canal da recepcao circular pode
+ * ficar ligado em STOP2 e o pino de RX acorda a placa.
+ * @param huart Serial do console.
+ * @param rx_port Porta do pino de RX.
+ * @param rx_pin Pino de RX.
+ */
+void RTOS_LowPowerSetConsole(UART_HandleTypeDef *huart, GPIO_TypeDef *rx_port, uint16_t rx_pin);
+
+/** @brief Impede o STOP2 ate o RTOS_LowPowerUnlock correspondente. */
+void RTOS_LowPowerLock(void);
+
+/** @brief Libera uma trava do RTOS_LowPowerLock. */
+void RTOS_LowPowerUnlock(void);
+
+/** @brief Byte do console recebido: adia o STOP2 (interrupcao). */
+void RTOS_LowPowerConsoleActivity(void);
+
+/** @brief Sono da idle quando nao ha ticks para suprimir; chamado pelo idle hook. */
+void RTOS_LowPowerIdleHook(void);
+
+/**
+ * Copia as estatisticas do sono.
+ * @param stats Destino.
+ */
+void RTOS_LowPowerGetStats(RtosLowPowerStats_t *stats);
+
+/** @brief Zera as estatisticas do sono. */
+void RTOS_LowPowerResetStats(void);
+
+/**
+ * Estima o consumo medio do MCU no periodo das estatisticas com os valores
+ * tipicos do datasheet, e o de referencia: o mesmo trabalho com o tick de
+ * 1 kHz e a idle em Sleep.
+ * @param stats Estatisticas.
+ * @param now_ua Estimativa com o tickless idle.
+ * @param ref_ua Estimativa de referencia.
+ */
+void RTOS_LowPowerEstimate(const RtosLowPowerStats_t *stats, uint32_t *now_ua, uint32_t *ref_ua);
 
 /* C++ detection */
 #ifdef __cplusplus
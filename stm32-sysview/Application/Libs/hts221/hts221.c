@@ -14,12 +14,51 @@
 
 #include "hts221.h"
 
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/* Register of the calibration block read by HTS221_LoadCalibration */
+#define HTS221_CAL(buffer, reg)   REGMAP_AT(buffer, HTS221_H0_RH_X2, reg)
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/**
+ * @brief  Factory calibration points, read once from the device.
+ */
+typedef struct
+{
+	int16_t T0_degC_x8;
+	int16_t T1_degC_x8;
+	int16_t T0_out;
+	int16_t T1_out;
+	int16_t H0_rh_x2;
+	int16_t H1_rh_x2;
+	int16_t H0_T0_out;
+	int16_t H1_T0_out;
+	uint8_t loaded;
+} HTS221_Calib_t;
+
 //==============================================================================
 // PRIVATE VARIABLES
 //==============================================================================
 
 static I2C_HandleTypeDef *pI2C_HTS221 = 0;
 
+static HTS221_Calib_t HTS221_Calib;
+
+/* Channels kept powered through the sensor interface */
+static uint8_t HTS221_PowerMask = (1 << HTS221_CH_TEMPERATURE) | (1 << HTS221_CH_HUMIDITY);
+
+/* ODR code restored when a channel starts converting again */
+static uint8_t HTS221_OdrCode = 0x01;
+
+/* Copy of the control registers, read once in HTS221_Init: updates are write-only */
+static uint8_t HTS221_Ctrl[REGMAP_COUNT(HTS221_CTRL_REG1, HTS221_CTRL_REG3)];
+static uint8_t HTS221_AvConf[1];
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
@@ -41,6 +80,13 @@ static void HTS221_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value);
  */
 static uint8_t HTS221_IO_Read(uint8_t Addr, uint8_t Reg);
 
+/**
+ * @brief  Writes a register of the board device (REGMAP_UPDATE).
+ * @param  Reg: Reg address
+ * @param  Value: Data to be written
+ */
+static void HTS221_WriteReg(uint8_t Reg, uint8_t Value);
+
 /**
  * @brief  Reads multiple data with I2C communication
  *         channel from TouchScreen.
@@ -52,10 +98,126 @@ static uint8_t HTS221_IO_Read(uint8_t Addr, uint8_t Reg);
  */
 static uint16_t HTS221_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length);
 
+/**
+ * @brief  Integer division rounded to the nearest value.
+ * @param  num: Numerator
+ * @param  den: Denominator (must be positive)
+ * @retval Rounded quotient
+ */
+static int32_t HTS221_DivRound(int32_t num, int32_t den);
+
+/**
+ * @brief  Reads the calibration registers into HTS221_Calib.
+ * @param  DeviceAddr: I2C device address
+ */
+static void HTS221_LoadCalibration(uint16_t DeviceAddr);
+
+/**
+ * @brief  Converts a raw T_OUT sample using the calibration points.
+ * @param  T_out: Raw temperature output
+ * @retval Temperature in 0.01 C
+ */
+static int16_t HTS221_T_Convert(int16_t T_out);
+
+/**
+ * @brief  Converts a raw H_OUT sample using the calibration points.
+ * @param  H_T_out: Raw humidity output
+ * @retval Humidity in 0.1 %RH, clamped to 0..1000
+ */
+static uint16_t HTS221_H_Convert(int16_t H_T_out);
+
 //==============================================================================
 // PRIVATE SOURCE CODE
 //==============================================================================
 
+static int32_t HTS221_DivRound(int32_t num, int32_t den)
+{
+	if (num < 0)
+	{
+		return (num - (den / 2)) / den;
+	}
+
+	return (num + (den / 2)) / den;
+}
+
+static void HTS221_LoadCalibration(uint16_t DeviceAddr)
+{
+	/* The whole calibration block in a single burst */
+	uint8_t cal[REGMAP_COUNT(HTS221_H0_RH_X2, HTS221_T1_OUT_H)];
+	uint8_t tmp;
+
+	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_H0_RH_X2 | 0x80), cal, sizeof(cal));
+
+	tmp = HTS221_CAL(cal, HTS221_T0_T1_DEGC_H2);
+
+	HTS221_Calib.T0_degC_x8 = (((uint16_t) (tmp & 0x03)) << 8) | ((uint16_t) HTS221_CAL(cal, HTS221_T0_DEGC_X8));
+	HTS221_Calib.T1_degC_x8 = (((uint16_t) (tmp & 0x0C)) << 6) | ((uint16_t) HTS221_CAL(cal, HTS221_T1_DEGC_X8));
+
+	HTS221_Calib.T0_out = (((uint16_t) HTS221_CAL(cal, HTS221_T0_OUT_H)) << 8) | (uint16_t) HTS221_CAL(cal, HTS221_T0_OUT_L);
+	HTS221_Calib.T1_out = (((uint16_t) HTS221_CAL(cal, HTS221_T1_OUT_H)) << 8) | (uint16_t) HTS221_CAL(cal, HTS221_T1_OUT_L);
+
+	/* Calibration points are kept in 0.5 %RH to preserve the LSB */
+	HTS221_Calib.H0_rh_x2 = HTS221_CAL(cal, HTS221_H0_RH_X2);
+	HTS221_Calib.H1_rh_x2 = HTS221_CAL(cal, HTS221_H1_RH_X2);
+
+	HTS221_Calib.H0_T0_out = (((uint16_t) HTS221_CAL(cal, HTS221_H0_T0_OUT_H)) << 8) | (uint16_t) HTS221_CAL(cal, HTS221_H0_T0_OUT_L);
+	HTS221_Calib.H1_T0_out = (((uint16_t) HTS221_CAL(cal, HTS221_H1_T0_OUT_H)) << 8) | (uint16_t) HTS221_CAL(cal, HTS221_H1_T0_OUT_L);
+
+	HTS221_Calib.loaded = 1;
+}
+
+static int16_t HTS221_T_Convert(int16_t T_out)
+{
+	int32_t num, den;
+
+	den = (int32_t) HTS221_Calib.T1_out - HTS221_Calib.T0_out;
+	if (den == 0)
+	{
+		return 0;
+	}
+
+	/*
+	 * Linear interpolation in 0.01 C using the 1/8 C calibration points:
+	 * degC_x8 * 100 / 8 = degC_x8 * 25 / 2. The 10-bit calibration delta
+	 * times the 16-bit output delta times 25 still fits in 32 bits.
+	 */
+	num = ((int32_t) T_out - HTS221_Calib.T0_out) * (HTS221_Calib.T1_degC_x8 - HTS221_Calib.T0_degC_x8) * 25;
+
+	if (den < 0)
+	{
+		num = -num;
+		den = -den;
+	}
+
+	return (int16_t) (HTS221_DivRound((int32_t) HTS221_Calib.T0_degC_x8 * 25, 2) + HTS221_DivRound(num, den * 2));
+}
+
+static uint16_t HTS221_H_Convert(int16_t H_T_out)
+{
+	int32_t num, den, tmp;
+
+	den = (int32_t) HTS221_Calib.H1_T0_out - HTS221_Calib.H0_T0_out;
+	if (den == 0)
+	{
+		return 0;
+	}
+
+	/* Linear interpolation in 0.1 %RH: rh_x2 * 10 / 2 = rh_x2 * 5 */
+	num = ((int32_t) H_T_out - HTS221_Calib.H0_T0_out) * (HTS221_Calib.H1_rh_x2 - HTS221_Calib.H0_rh_x2) * 5;
+
+	if (den < 0)
+	{
+		num = -num;
+		den = -den;
+	}
+
+	tmp = (HTS221_Calib.H0_rh_x2 * 5) + HTS221_DivRound(num, den);
+
+	tmp = (tmp > 1000) ? 1000 : (tmp < 0) ? 0 : tmp;
+
+	return (uint16_t) tmp;
+}
+
 static uint8_t HTS221_IO_Read(uint8_t Addr, uint8_t Reg)
 {
 	uint8_t read_value = 0;
@@ -87,6 +249,11 @@ static void HTS221_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
 	}
 }
 
+static void HTS221_WriteReg(uint8_t Reg, uint8_t Value)
+{
+	HTS221_IO_Write(HTS221_I2C_ADDRESS, Reg, Value);
+}
+
 static uint16_t HTS221_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length)
 {
 	HAL_StatusTypeDef status = HAL_OK;
@@ -114,24 +281,16 @@ void HTS221_attach(I2C_HandleTypeDef *hI2Handler)
 
 void HTS221_Init(uint16_t DeviceAddr)
 {
-	uint8_t tmp;
+	/* Copy of CTRL_REG1..3 in one burst, AV_CONF apart */
+	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_CTRL_REG1 | 0x80), HTS221_Ctrl, sizeof(HTS221_Ctrl));
+	HTS221_AvConf[0] = HTS221_IO_Read(DeviceAddr, HTS221_AV_CONF_REG);
 
-	/* Read CTRL_REG1 */
-	tmp = HTS221_IO_Read(DeviceAddr, HTS221_CTRL_REG1);
+	/* Enable BDU, set ODR to 1Hz and activate the device in a single write */
+	REGMAP_UPDATE(HTS221_Ctrl, HTS221_CTRL_REG1, HTS221_WriteReg, HTS221_CTRL_REG1,
+			REGMAP_SET(HTS221_PD_FIELD, 1), REGMAP_SET(HTS221_BDU_FIELD, 1), REGMAP_SET(HTS221_ODR_FIELD, 1));
 
-	/* Enable BDU */
-	tmp &= ~HTS221_BDU_MASK;
-	tmp |= (1 << HTS221_BDU_BIT);
-
-	/* Set default ODR */
-	tmp &= ~HTS221_ODR_MASK;
-	tmp |= (uint8_t) 0x01; /* Set ODR to 1Hz */
-
-	/* Activate the device */
-	tmp |= HTS221_PD_MASK;
-
-	/* Apply settings to CTRL_REG1 */
-	HTS221_IO_Write(DeviceAddr, HTS221_CTRL_REG1, tmp);
+	/* Calibration never changes: read it once instead of on every sample */
+	HTS221_LoadCalibration(DeviceAddr);
 }
 
 uint8_t HTS221_H_ReadID(uint16_t DeviceAddr)
@@ -144,64 +303,231 @@ uint8_t HTS221_H_ReadID(uint16_t DeviceAddr)
 	return ctrl;
 }
 
-float HTS221_H_ReadHumidity(uint16_t DeviceAddr)
+uint16_t HTS221_H_ReadHumidity(uint16_t DeviceAddr)
 {
-	int16_t H0_T0_out, H1_T0_out, H_T_out;
-	int16_t H0_rh, H1_rh;
 	uint8_t buffer[2];
-	float tmp_f;
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_H0_RH_X2 | 0x80), buffer, 2);
+	if (HTS221_Calib.loaded == 0)
+	{
+		HTS221_LoadCalibration(DeviceAddr);
+	}
 
-	H0_rh = buffer[0] >> 1;
-	H1_rh = buffer[1] >> 1;
+	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_HR_OUT_L_REG | 0x80), buffer, 2);
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_H0_T0_OUT_L | 0x80), buffer, 2);
+	return HTS221_H_Convert((int16_t) ((((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0]));
+}
 
-	H0_T0_out = (((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0];
+int16_t HTS221_T_ReadTemp(uint16_t DeviceAddr)
+{
+	uint8_t buffer[2];
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_H1_T0_OUT_L | 0x80), buffer, 2);
+	if (HTS221_Calib.loaded == 0)
+	{
+		HTS221_LoadCalibration(DeviceAddr);
+	}
 
-	H1_T0_out = (((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0];
+	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_TEMP_OUT_L_REG | 0x80), buffer, 2);
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_HR_OUT_L_REG | 0x80), buffer, 2);
+	return HTS221_T_Convert((int16_t) ((((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0]));
+}
 
-	H_T_out = (((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0];
+uint32_t HTS221_GetOdr(uint16_t DeviceAddr)
+{
+	static const uint32_t odr_mhz[] = { 0, 1000, 7000, 12500 };
+	uint8_t tmp;
 
-	tmp_f = (float) (H_T_out - H0_T0_out) * (float) (H1_rh - H0_rh) / (float) (H1_T0_out - H0_T0_out) + H0_rh;
+	/* Only the driver writes CTRL_REG1: its copy is current */
+	tmp = REGMAP_AT(HTS221_Ctrl, HTS221_CTRL_REG1, HTS221_CTRL_REG1);
 
-	tmp_f *= 10.0f;
+	/* Device in power-down mode */
+	if ((tmp & HTS221_PD_MASK) == 0)
+	{
+		return 0;
+	}
+
+	return odr_mhz[REGMAP_GET(HTS221_ODR_FIELD, tmp)];
+}
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
 
-	tmp_f = (tmp_f > 1000.0f) ? 1000.0f : (tmp_f < 0.0f) ? 0.0f : tmp_f;
+static const uint32_t HTS221_Odrs[] = { 1000, 7000, 12500 };
 
-	return (tmp_f / 10.0f);
+static const SensorChannelDesc_t HTS221_Channels[] =
+{
+	{ "temperature", SENSOR_TYPE_TEMPERATURE, 1, "C", 100, HTS221_Odrs, 3, NULL, 0 },
+	{ "humidity", SENSOR_TYPE_HUMIDITY, 1, "%RH", 10, HTS221_Odrs, 3, NULL, 0 },
+};
+
+static HAL_StatusTypeDef HTS221_DrvProbe(void)
+{
+	return (HTS221_H_ReadID(HTS221_I2C_ADDRESS) == HTS221_WHO_AM_I_VAL) ? HAL_OK : HAL_ERROR;
 }
 
-float HTS221_T_ReadTemp(uint16_t DeviceAddr)
+static HAL_StatusTypeDef HTS221_DrvInit(void)
 {
-	int16_t T0_out, T1_out, T_out, T0_degC_x8_u16, T1_degC_x8_u16;
-	int16_t T0_degC, T1_degC;
-	uint8_t buffer[4], tmp;
-	float tmp_f;
+	HTS221_Init(HTS221_I2C_ADDRESS);
+	HTS221_OdrCode = 0x01;
+	HTS221_PowerMask = (1 << HTS221_CH_TEMPERATURE) | (1 << HTS221_CH_HUMIDITY);
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_T0_DEGC_X8 | 0x80), buffer, 2);
-	tmp = HTS221_IO_Read(DeviceAddr, HTS221_T0_T1_DEGC_H2);
+	return HAL_OK;
+}
 
-	T0_degC_x8_u16 = (((uint16_t) (tmp & 0x03)) << 8) | ((uint16_t) buffer[0]);
-	T1_degC_x8_u16 = (((uint16_t) (tmp & 0x0C)) << 6) | ((uint16_t) buffer[1]);
-	T0_degC = T0_degC_x8_u16 >> 3;
-	T1_degC = T1_degC_x8_u16 >> 3;
+/**
+ * @brief  Writes PD and the ODR field: the stored code with the device active
+ *         while any channel is in use, power-down otherwise.
+ */
+static void HTS221_DrvApply(void)
+{
+	REGMAP_UPDATE(HTS221_Ctrl, HTS221_CTRL_REG1, HTS221_WriteReg, HTS221_CTRL_REG1,
+			REGMAP_SETV(HTS221_PD_FIELD, HTS221_PowerMask != 0), REGMAP_SETV(HTS221_ODR_FIELD, HTS221_OdrCode));
+}
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_T0_OUT_L | 0x80), buffer, 4);
+static HAL_StatusTypeDef HTS221_DrvSetOdr(uint8_t ch, uint32_t odr_mhz)
+{
+	/* Both channels share CTRL_REG1: ODR codes 1..3 follow HTS221_Odrs */
+	HTS221_OdrCode = (uint8_t) (SensorDrv_OdrIndex(&HTS221_Channels[ch], odr_mhz) + 1);
+	HTS221_DrvApply();
 
-	T0_out = (((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0];
-	T1_out = (((uint16_t) buffer[3]) << 8) | (uint16_t) buffer[2];
+	return HAL_OK;
+}
 
-	HTS221_IO_ReadMultiple(DeviceAddr, (HTS221_TEMP_OUT_L_REG | 0x80), buffer, 2);
+static uint32_t HTS221_DrvGetOdr(uint8_t ch)
+{
+	return HTS221_GetOdr(HTS221_I2C_ADDRESS);
+}
 
-	T_out = (((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0];
+static HAL_StatusTypeDef HTS221_DrvSetPower(uint8_t ch, SensorPower_e power)
+{
+	if (power == SENSOR_POWER_OFF)
+	{
+		HTS221_PowerMask &= ~(1 << ch);
+	}
+	else
+	{
+		HTS221_PowerMask |= (1 << ch);
+	}
 
-	tmp_f = (float) (T_out - T0_out) * (float) (T1_degC - T0_degC) / (float) (T1_out - T0_out) + T0_degC;
+	/* The device only powers down when no channel is in use */
+	HTS221_DrvApply();
 
-	return tmp_f;
+	return HAL_OK;
 }
+
+static HAL_StatusTypeDef HTS221_DrvOneShot(uint8_t ch)
+{
+	uint32_t t;
+
+	/* The other channel is converting: its output registers are already fresh */
+	if (HTS221_PowerMask != 0)
+	{
+		return HAL_OK;
+	}
+
+	/* One-shot needs the device active with ODR = 00 */
+	REGMAP_UPDATE(HTS221_Ctrl, HTS221_CTRL_REG1, HTS221_WriteReg, HTS221_CTRL_REG1,
+			REGMAP_SET(HTS221_PD_FIELD, 1), REGMAP_SET(HTS221_ODR_FIELD, 0));
+
+	/* ONE_SHOT clears itself: written, but not kept in the copy */
+	HTS221_WriteReg(HTS221_CTRL_REG2, REGMAP_AT(HTS221_Ctrl, HTS221_CTRL_REG1, HTS221_CTRL_REG2) |
+			REGMAP_BITS(HTS221_CTRL_REG2, REGMAP_SET(HTS221_ONE_SHOT_FIELD, 1)));
+
+	/* ONE_SHOT is self-cleared when both outputs are updated */
+	for (t = 0; t < HTS221_ONE_SHOT_TIMEOUT_MS; t++)
+	{
+		osDelay(1);
+
+		if ((HTS221_IO_Read(HTS221_I2C_ADDRESS, HTS221_CTRL_REG2) & HTS221_ONE_SHOT_MASK) == 0)
+		{
+			break;
+		}
+	}
+
+	/* Back to power-down until the next read */
+	HTS221_DrvApply();
+
+	return (t < HTS221_ONE_SHOT_TIMEOUT_MS) ? HAL_OK : HAL_TIMEOUT;
+}
+
+static HAL_StatusTypeDef HTS221_DrvSetFilter(uint8_t ch, uint16_t level)
+{
+	/* AVGT averages 2..256 samples, AVGH 4..512, in powers of two */
+	uint16_t samples = (ch == HTS221_CH_TEMPERATURE) ? 2 : 4;
+	uint8_t code = 0;
+
+	while ((code < 7) && (samples < level))
+	{
+		samples <<= 1;
+		code++;
+	}
+
+	if (ch == HTS221_CH_TEMPERATURE)
+	{
+		REGMAP_UPDATE(HTS221_AvConf, HTS221_AV_CONF_REG, HTS221_WriteReg, HTS221_AV_CONF_REG,
+				REGMAP_SETV(HTS221_AVGT_FIELD, code));
+	}
+	else
+	{
+		REGMAP_UPDATE(HTS221_AvConf, HTS221_AV_CONF_REG, HTS221_WriteReg, HTS221_AV_CONF_REG,
+				REGMAP_SETV(HTS221_AVGH_FIELD, code));
+	}
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef HTS221_DrvReadRaw(uint8_t ch, int32_t *raw)
+{
+	uint8_t reg = (ch == HTS221_CH_TEMPERATURE) ? HTS221_TEMP_OUT_L_REG : HTS221_HR_OUT_L_REG;
+	uint8_t buffer[2];
+	HAL_StatusTypeDef status;
+
+	status = (HAL_StatusTypeDef) HTS221_IO_ReadMultiple(HTS221_I2C_ADDRESS, (reg | 0x80), buffer, 2);
+
+	raw[0] = (int16_t) ((((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0]);
+
+	return status;
+}
+
+static void HTS221_DrvConvert(uint8_t ch, const int32_t *raw, int32_t *out, uint16_t count)
+{
+	uint16_t i;
+
+	if (HTS221_Calib.loaded == 0)
+	{
+		HTS221_LoadCalibration(HTS221_I2C_ADDRESS);
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if (ch == HTS221_CH_TEMPERATURE)
+		{
+			out[i] = HTS221_T_Convert((int16_t) raw[i]);
+		}
+		else
+		{
+			out[i] = HTS221_H_Convert((int16_t) raw[i]);
+		}
+	}
+}
+
+const SensorDriver_t HTS221_Driver =
+{
+	.name = "HTS221",
+	.address = HTS221_I2C_ADDRESS,
+	.num_channels = 2,
+	.channels = HTS221_Channels,
+	.shared_odr = true,
+	.probe = HTS221_DrvProbe,
+	.init = HTS221_DrvInit,
+	.set_odr = HTS221_DrvSetOdr,
+	.get_odr = HTS221_DrvGetOdr,
+	.set_range = NULL,
+	.get_range = NULL,
+	.set_power = HTS221_DrvSetPower,
+	.read_raw = HTS221_DrvReadRaw,
+	.read_batch = NULL,
+	.convert = HTS221_DrvConvert,
+	.one_shot = HTS221_DrvOneShot,
+	.set_filter = HTS221_DrvSetFilter,
+};
@@ -48,6 +48,8 @@ extern "C" {
 //==============================================================================
 
 #include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+#include "regmap/regmap.h"
 
 //==============================================================================
 // PUBLIC DEFINES
@@ -55,6 +57,15 @@ extern "C" {
 
 #define HTS221_I2C_ADDRESS   (uint8_t)0xBE
 
+/**
+ * @brief  Channels exported through HTS221_Driver.
+ */
+#define HTS221_CH_TEMPERATURE   0
+#define HTS221_CH_HUMIDITY      1
+
+/* Maximum wait for a one-shot conversion, in ms */
+#define HTS221_ONE_SHOT_TIMEOUT_MS   100
+
 /**
  * @brief  Bitfield positioning.
  */
@@ -112,6 +123,9 @@ extern "C" {
 #define HTS221_AVGH_MASK          (uint8_t)0x07
 #define HTS221_AVGT_MASK          (uint8_t)0x38
 
+#define HTS221_AVGT_FIELD         REGMAP_FIELD(HTS221_AV_CONF_REG, 3, 3)
+#define HTS221_AVGH_FIELD         REGMAP_FIELD(HTS221_AV_CONF_REG, 0, 3)
+
 /**
  * @brief Control register 1.
  *        Read/write
@@ -140,6 +154,10 @@ extern "C" {
 #define HTS221_BDU_MASK       (uint8_t)0x04
 #define HTS221_ODR_MASK       (uint8_t)0x03
 
+#define HTS221_PD_FIELD        REGMAP_FIELD(HTS221_CTRL_REG1, 7, 1)
+#define HTS221_BDU_FIELD       REGMAP_FIELD(HTS221_CTRL_REG1, 2, 1)
+#define HTS221_ODR_FIELD       REGMAP_FIELD(HTS221_CTRL_REG1, 0, 2)
+
 /**
  * @brief Control register 2.
  *        Read/write
@@ -161,6 +179,10 @@ extern "C" {
 #define HTS221_HEATHER_MASK   (uint8_t)0x02
 #define HTS221_ONE_SHOT_MASK  (uint8_t)0x01
 
+#define HTS221_BOOT_FIELD      REGMAP_FIELD(HTS221_CTRL_REG2, 7, 1)
+#define HTS221_HEATHER_FIELD   REGMAP_FIELD(HTS221_CTRL_REG2, 1, 1)
+#define HTS221_ONE_SHOT_FIELD  REGMAP_FIELD(HTS221_CTRL_REG2, 0, 1)
+
 /**
  * @brief Control register 3.
  *        Read/write
@@ -181,6 +203,10 @@ extern "C" {
 #define HTS221_PP_OD_MASK     (uint8_t)0x40
 #define HTS221_DRDY_MASK      (uint8_t)0x04
 
+#define HTS221_DRDY_H_L_FIELD  REGMAP_FIELD(HTS221_CTRL_REG3, 7, 1)
+#define HTS221_PP_OD_FIELD     REGMAP_FIELD(HTS221_CTRL_REG3, 6, 1)
+#define HTS221_DRDY_FIELD      REGMAP_FIELD(HTS221_CTRL_REG3, 2, 1)
+
 /**
  * @brief  Status register.
  *         Read
@@ -288,9 +314,10 @@ uint8_t HTS221_H_ReadID(uint16_t DeviceAddr);
 
 /**
  * @brief  Read humidity value of HTS221
- * @retval humidity value;
+ * @param  DeviceAddr: I2C device address
+ * @retval humidity in 0.1 %RH, clamped to 0..1000
  */
-float HTS221_H_ReadHumidity(uint16_t DeviceAddr);
+uint16_t HTS221_H_ReadHumidity(uint16_t DeviceAddr);
 
 //==============================================================================
 // TEMPERATURE functions
@@ -300,9 +327,25 @@ float HTS221_H_ReadHumidity(uint16_t DeviceAddr);
 /**
  * @brief  Read temperature value of HTS221
  * @param  DeviceAddr: I2C device address
- * @retval temperature value
+ * @retval temperature in 0.01 C
+ */
+int16_t HTS221_T_ReadTemp(uint16_t DeviceAddr);
+
+/**
+ * @brief  Read the output data rate configured in CTRL_REG1.
+ * @param  DeviceAddr: I2C device address
+ * @retval ODR in mHz (0 when powered down or in one-shot mode)
+ */
+uint32_t HTS221_GetOdr(uint16_t DeviceAddr);
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+/**
+ * @brief  HTS221 descriptor for the sensor registry (temperature and humidity).
  */
-float HTS221_T_ReadTemp(uint16_t DeviceAddr);
+extern const SensorDriver_t HTS221_Driver;
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,275 @@
+/**
+ * @file    imuconv.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Conversao em bloco de amostras XYZ de 16 bits dos sensores
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "imuconv.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/* IMUCONV_USE_DSP pode ser forcado por quem compila (ex.: emulacao no PC) */
+#ifndef IMUCONV_USE_DSP
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define IMUCONV_USE_DSP			1
+#else
+#define IMUCONV_USE_DSP			0
+#endif
+#endif
+
+#if (IMUCONV_USE_DSP == 1) && !defined(IMUCONV_HOST_INTRINSICS)
+#include "cmsis_compiler.h"
+#endif
+
+/** @brief Fracao da matriz */
+#define IMUCONV_SHIFT			14
+
+/** @brief Arredondamento somado antes do deslocamento */
+#define IMUCONV_ROUND			(1 << (IMUCONV_SHIFT - 1))
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Atualiza as copias empacotadas usadas pelas instrucoes SIMD. */
+static void ImuConv_Pack(ImuConv_t *conv);
+
+/** @brief Satura em int16. */
+static inline int32_t ImuConv_Sat16(int32_t v);
+
+/** @brief Uma amostra pela aritmetica de referencia. */
+static inline void ImuConv_SampleRef(const ImuConv_t *conv, int32_t x, int32_t y, int32_t z, int32_t *out);
+
+#if (IMUCONV_USE_DSP == 1)
+/**
+ * Uma amostra com X e Y empacotados.
+ * @param xy X na metade baixa, Y na alta.
+ * @param z Z na metade baixa.
+ */
+static inline void ImuConv_SampleDsp(const ImuConv_t *conv, uint32_t xy, uint32_t z, int32_t *out);
+#endif
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void ImuConv_Pack(ImuConv_t *conv)
+{
+	uint8_t i;
+
+	for (i = 0; i < 3; i++)
+	{
+		conv->m_xy[i] = (uint16_t) conv->matrix[i][0] | ((uint32_t) (uint16_t) conv->matrix[i][1] << 16);
+		conv->m_z[i] = (uint16_t) conv->matrix[i][2];
+	}
+
+	conv->b_xy = (uint16_t) conv->bias[0] | ((uint32_t) (uint16_t) conv->bias[1] << 16);
+	conv->b_z = (uint16_t) conv->bias[2];
+}
+
+static inline int32_t ImuConv_Sat16(int32_t v)
+{
+	return (v > INT16_MAX) ? INT16_MAX : ((v < INT16_MIN) ? INT16_MIN : v);
+}
+
+static inline void ImuConv_SampleRef(const ImuConv_t *conv, int32_t x, int32_t y, int32_t z, int32_t *out)
+{
+	int32_t v0, v1, v2;
+	uint32_t acc;
+	uint8_t i;
+
+	v0 = ImuConv_Sat16(x - conv->bias[0]);
+	v1 = ImuConv_Sat16(y - conv->bias[1]);
+	v2 = ImuConv_Sat16(z - conv->bias[2]);
+
+	for (i = 0; i < 3; i++)
+	{
+		/* Soma em 32 bits com wrap, como o SMLAD */
+		acc = (uint32_t) IMUCONV_ROUND;
+		acc += (uint32_t) (conv->matrix[i][0] * v0);
+		acc += (uint32_t) (conv->matrix[i][1] * v1);
+		acc += (uint32_t) (conv->matrix[i][2] * v2);
+
+		out[i] = ImuConv_Sat16((int32_t) acc >> IMUCONV_SHIFT) * conv->scale;
+	}
+}
+
+#if (IMUCONV_USE_DSP == 1)
+static inline void ImuConv_SampleDsp(const ImuConv_t *conv, uint32_t xy, uint32_t z, int32_t *out)
+{
+	int32_t scale = conv->scale;
+	uint32_t acc;
+
+	/* Bias dos dois eixos de uma vez, saturado */
+	xy = __QSUB16(xy, conv->b_xy);
+	z = __QSUB16(z, conv->b_z);
+
+	acc = __SMLAD(z, conv->m_z[0], __SMLAD(xy, conv->m_xy[0], IMUCONV_ROUND));
+	out[0] = __SSAT((int32_t) acc >> IMUCONV_SHIFT, 16) * scale;
+
+	acc = __SMLAD(z, conv->m_z[1], __SMLAD(xy, conv->m_xy[1], IMUCONV_ROUND));
+	out[1] = __SSAT((int32_t) acc >> IMUCONV_SHIFT, 16) * scale;
+
+	acc = __SMLAD(z, conv->m_z[2], __SMLAD(xy, conv->m_xy[2], IMUCONV_ROUND));
+	out[2] = __SSAT((int32_t) acc >> IMUCONV_SHIFT, 16) * scale;
+}
+#endif
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void ImuConv_Init(ImuConv_t *conv, int32_t scale)
+{
+	static const int8_t identity[3] = { 1, 2, 3 };
+
+	memset(conv, 0, sizeof(ImuConv_t));
+	conv->scale = scale;
+	ImuConv_SetRemap(conv, identity);
+}
+
+void ImuConv_SetScale(ImuConv_t *conv, int32_t scale)
+{
+	conv->scale = scale;
+}
+
+void ImuConv_SetBias(ImuConv_t *conv, const int16_t bias[3])
+{
+	memcpy(conv->bias, bias, sizeof(conv->bias));
+	ImuConv_Pack(conv);
+}
+
+void ImuConv_SetRemap(ImuConv_t *conv, const int8_t map[3])
+{
+	uint8_t i, src;
+
+	memset(conv->matrix, 0, sizeof(conv->matrix));
+
+	for (i = 0; i < 3; i++)
+	{
+		src = (uint8_t) ((map[i] < 0) ? -map[i] : map[i]);
+		if ((src >= 1) && (src <= 3))
+		{
+			conv->matrix[i][src - 1] = (map[i] < 0) ? -IMUCONV_ONE : IMUCONV_ONE;
+		}
+	}
+
+	ImuConv_Pack(conv);
+}
+
+void ImuConv_SetMatrix(ImuConv_t *conv, const int16_t matrix[3][3])
+{
+	memcpy(conv->matrix, matrix, sizeof(conv->matrix));
+	ImuConv_Pack(conv);
+}
+
+void ImuConv_Unpack(const uint8_t *bytes, int16_t *out, uint32_t count)
+{
+#if (IMUCONV_USE_DSP == 1)
+	/* Cortex-M4 e little-endian: o formato dos registradores ja e o de int16 */
+	memcpy(out, bytes, count * IMUCONV_SAMPLE_BYTES);
+#else
+	ImuConv_UnpackRef(bytes, out, count);
+#endif
+}
+
+void ImuConv_Bytes(const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t count)
+{
+#if (IMUCONV_USE_DSP == 1)
+	while (count--)
+	{
+		/* LDR/LDRH desalinhados sao permitidos no M4 */
+		ImuConv_SampleDsp(conv, __UNALIGNED_UINT32_READ(bytes), __UNALIGNED_UINT16_READ(bytes + 4), out);
+		bytes += IMUCONV_SAMPLE_BYTES;
+		out += 3;
+	}
+#else
+	ImuConv_BytesRef(conv, bytes, out, count);
+#endif
+}
+
+void ImuConv_Int16(const ImuConv_t *conv, const int16_t *raw, int32_t *out, uint32_t count)
+{
+#if (IMUCONV_USE_DSP == 1)
+	while (count--)
+	{
+		ImuConv_SampleDsp(conv, __UNALIGNED_UINT32_READ(raw), (uint16_t) raw[2], out);
+		raw += 3;
+		out += 3;
+	}
+#else
+	ImuConv_Int16Ref(conv, raw, out, count);
+#endif
+}
+
+void ImuConv_Int32(const ImuConv_t *conv, const int32_t *raw, int32_t *out, uint32_t count)
+{
+#if (IMUCONV_USE_DSP == 1)
+	uint32_t xy, z;
+
+	while (count--)
+	{
+		/* Le tudo antes de escrever: out pode ser o proprio raw */
+		xy = __PKHBT((uint32_t) raw[0], (uint32_t) raw[1], 16);
+		z = (uint16_t) raw[2];
+		ImuConv_SampleDsp(conv, xy, z, out);
+		raw += 3;
+		out += 3;
+	}
+#else
+	ImuConv_Int32Ref(conv, raw, out, count);
+#endif
+}
+
+void ImuConv_UnpackRef(const uint8_t *bytes, int16_t *out, uint32_t count)
+{
+	uint32_t i;
+
+	for (i = 0; i < count * 3; i++)
+	{
+		out[i] = (int16_t) (((uint16_t) bytes[2 * i + 1] << 8) | bytes[2 * i]);
+	}
+}
+
+void ImuConv_BytesRef(const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t count)
+{
+	while (count--)
+	{
+		ImuConv_SampleRef(conv,
+				(int16_t) (((uint16_t) bytes[1] << 8) | bytes[0]),
+				(int16_t) (((uint16_t) bytes[3] << 8) | bytes[2]),
+				(int16_t) (((uint16_t) bytes[5] << 8) | bytes[4]), out);
+		bytes += IMUCONV_SAMPLE_BYTES;
+		out += 3;
+	}
+}
+
+void ImuConv_Int16Ref(const ImuConv_t *conv, const int16_t *raw, int32_t *out, uint32_t count)
+{
+	while (count--)
+	{
+		ImuConv_SampleRef(conv, raw[0], raw[1], raw[2], out);
+		raw += 3;
+		out += 3;
+	}
+}
+
+void ImuConv_Int32Ref(const ImuConv_t *conv, const int32_t *raw, int32_t *out, uint32_t count)
+{
+	while (count--)
+	{
+		ImuConv_SampleRef(conv, (int16_t) raw[0], (int16_t) raw[1], (int16_t) raw[2], out);
+		raw += 3;
+		out += 3;
+	}
+}
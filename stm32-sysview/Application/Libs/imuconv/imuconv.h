@@ -0,0 +1,161 @@
+/**
+ * @file    imuconv.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.1
+ * @brief   Conversao em bloco de amostras XYZ de 16 bits dos sensores
+ * @details
+ * Cada amostra passa por:
+ *
+ *   v = sat16(raw - bias)                  (contagens)
+ *   r = sat16((M * v + 2^13) >> 14)        (M em Q14: remapeamento/alinhamento)
+ *   out = r * scale                        (unidade do canal)
+ *
+ * Com a extensao DSP do Cortex-M4 (__ARM_FEATURE_DSP) os eixos X e Y andam
+ * juntos em uma palavra: QSUB16 tira o bias, SMUAD/SMLAD fazem cada linha da
+ * matriz e SSAT satura. Sem DSP (PC) as versoes de referencia em C fazem a
+ * mesma aritmetica e dao resultados identicos bit a bit; elas ficam sempre
+ * disponiveis com o sufixo Ref para comparacao e benchmark.
+ *
+ * Limite: a soma dos modulos de uma linha de M deve ficar abaixo de 4.0
+ * (65536 em Q14) para o acumulador de 32 bits nao estourar.
+ *
+ * Uso: chamar em blocos (FIFO). Para uma amostra avulsa com M identidade e
+ * sem bias a multiplicacao direta pela escala sai mais barata; e o que os
+ * drivers fazem nas leituras de uma amostra.
+ */
+
+#ifndef _IMUCONV_H_
+#define _IMUCONV_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief 1.0 na matriz (Q14) */
+#define IMUCONV_ONE				16384
+
+/** @brief Bytes de uma amostra XYZ little-endian */
+#define IMUCONV_SAMPLE_BYTES	6
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Parametros de conversao de um canal */
+typedef struct
+{
+	int16_t matrix[3][3];   /**< Q14, linha = eixo de saida */
+	int16_t bias[3];        /**< Contagens subtraidas antes da matriz */
+	int32_t scale;          /**< Multiplicador final (ex.: ug/LSB) */
+
+	/* Copias empacotadas para as instrucoes SIMD (ImuConv_Pack) */
+	uint32_t m_xy[3];       /**< M[i][0] | M[i][1] << 16 */
+	uint32_t m_z[3];        /**< M[i][2] */
+	uint32_t b_xy;          /**< bias[0] | bias[1] << 16 */
+	uint32_t b_z;           /**< bias[2] */
+} ImuConv_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Identidade, sem bias.
+ * @param conv Parametros.
+ * @param scale Multiplicador final.
+ */
+void ImuConv_Init(ImuConv_t *conv, int32_t scale);
+
+/**
+ * Troca o multiplicador final (ex.: apos mudar o fundo de escala).
+ * @param conv Parametros.
+ * @param scale Multiplicador final.
+ */
+void ImuConv_SetScale(ImuConv_t *conv, int32_t scale);
+
+/**
+ * @param conv Parametros.
+ * @param bias Offset em contagens por eixo.
+ */
+void ImuConv_SetBias(ImuConv_t *conv, const int16_t bias[3]);
+
+/**
+ * Troca de eixos com sinal: saida i = sinal(map[i]) * entrada |map[i]| - 1.
+ * Ex.: { 2, -1, 3 } faz x' = y, y' = -x, z' = z.
+ * @param conv Parametros.
+ * @param map Eixo de origem (1 a 3) com sinal, por eixo de saida.
+ */
+void ImuConv_SetRemap(ImuConv_t *conv, const int8_t map[3]);
+
+/**
+ * Matriz completa (remapeamento mais correcao de alinhamento).
+ * @param conv Parametros.
+ * @param matrix Q14.
+ */
+void ImuConv_SetMatrix(ImuConv_t *conv, const int16_t matrix[3][3]);
+
+/**
+ * Bytes little-endian (registradores ou FIFO) para triplas int16.
+ * @param bytes count * IMUCONV_SAMPLE_BYTES bytes.
+ * @param out count * 3 valores.
+ * @param count Amostras.
+ */
+void ImuConv_Unpack(const uint8_t *bytes, int16_t *out, uint32_t count);
+
+/**
+ * Converte amostras lidas direto do sensor.
+ * @param conv Parametros.
+ * @param bytes count * IMUCONV_SAMPLE_BYTES bytes little-endian.
+ * @param out count * 3 valores na unidade do canal.
+ * @param count Amostras.
+ */
+void ImuConv_Bytes(const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t count);
+
+/**
+ * Converte amostras ja montadas em int16.
+ * @param conv Parametros.
+ * @param raw count * 3 contagens.
+ * @param out count * 3 valores na unidade do canal.
+ * @param count Amostras.
+ */
+void ImuConv_Int16(const ImuConv_t *conv, const int16_t *raw, int32_t *out, uint32_t count);
+
+/**
+ * Converte contagens guardadas em int32 (read_raw do registro de drivers).
+ * @param conv Parametros.
+ * @param raw count * 3 contagens (faixa de int16).
+ * @param out count * 3 valores na unidade do canal; pode ser igual a raw.
+ * @param count Amostras.
+ */
+void ImuConv_Int32(const ImuConv_t *conv, const int32_t *raw, int32_t *out, uint32_t count);
+
+/** @brief Referencia em C de ImuConv_Unpack. */
+void ImuConv_UnpackRef(const uint8_t *bytes, int16_t *out, uint32_t count);
+
+/** @brief Referencia em C de ImuConv_Bytes. */
+void ImuConv_BytesRef(const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t count);
+
+/** @brief Referencia em C de ImuConv_Int16. */
+void ImuConv_Int16Ref(const ImuConv_t *conv, const int16_t *raw, int32_t *out, uint32_t count);
+
+/** @brief Referencia em C de ImuConv_Int32. */
+void ImuConv_Int32Ref(const ImuConv_t *conv, const int32_t *raw, int32_t *out, uint32_t count);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _IMUCONV_H_ */
@@ -2,7 +2,7 @@
  * @file    leds.c
  * @author  Jorge Guzman
  * @date    Apr 23, 2014
- * @version 0.3.0
+ * @version 0.7.0
  * @brief   Bibliteoca para o uso dos Leds
  */
 
@@ -17,23 +17,27 @@
 //==============================================================================
 
 #include "bitwise/bitwise.h"
+#include "freertos_utils/freertos_utils.h"
 #include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
 
 //==============================================================================
 // PRIVATE DEFINITIONS
 //==============================================================================
 
-/** @brief intervalo de tempo x10ms de delay para gerar o blink slow*/
-#define configLED_BLINK_SLOW_STEP 			70
+/** @brief meio periodo do blink slow em ms */
+#define configLED_BLINK_SLOW_STEP 			700
 
-/** @brief intervalo de tempo x10ms de delay para gerar o blink fast*/
-#define configLED_BLINK_FAST_STEP 			20
+/** @brief meio periodo do blink fast em ms */
+#define configLED_BLINK_FAST_STEP 			200
 
-/** @brief intervalos de tempo x10ms de delay para gerar o hearbeat fast*/
-#define configLED_BLINK_HEARBEAT_STATE_1 	10
-#define configLED_BLINK_HEARBEAT_STATE_2 	20
-#define configLED_BLINK_HEARBEAT_STATE_3 	10
-#define configLED_BLINK_HEARBEAT_STATE_4 	120
+/** @brief passo da tabela do heartbeat em ms: 100 ligado, 200 desligado, 100 ligado, 1200 desligado */
+#define configLED_BLINK_HEARBEAT_STEP 		100
+
+/** @brief niveis e passo em ms da respiracao (ciclo de 2 s) */
+#define configLED_BREATH_LEVELS 			50
+#define configLED_BREATH_STEP 				40
 
 /** @brief Numero total de leds*/
 #define configMAX_NUM_LEDS 					8
@@ -47,375 +51,486 @@ typedef struct
 	GPIO_TypeDef *gpio;
 	uint16_t pin;
 	LedActive_e active;
+	TIM_HandleTypeDef *htim;	/**< Timer do PWM; NULL = led no GPIO */
+	uint32_t channel;			/**< Canal do PWM */
+	TIM_HandleTypeDef *hstep;	/**< Timer de passo das tabelas */
+	const LedsWave_t *wave;		/**< Padrao atual */
+	bool on_gpio;				/**< Led do PWM com o pino como saida, tocado pela task */
+	bool lp_lock;				/**< Segura RTOS_LowPowerLock: o PWM precisa de clock */
 } gpio_leds;
 
 //==============================================================================
 // PRIVATE VARIABLES
 //==============================================================================
 
-/** @brief Timer used to control the leds status */
-TimerHandle_t timerHendlerLeds;
-
 /**@brief Armazena os pinos I/O que serao usados. */
 gpio_leds leds[configMAX_NUM_LEDS] = {0};
 
-/** @brief Controle imediato do estado das leds */
+/** @brief Ultimo valor escrito nas leds no GPIO */
 uint8_t ledsStatus;
 
-/** @brief Indicao das leds que estao 100% ligadas */
-uint8_t ledsON;
+/**
+ * @brief Padrao pedido para cada led (NULL = desligado). Escrito por
+ * Leds_SetWave de qualquer contexto com um store de 32 bits; a task compara
+ * com leds[i].wave e aplica o que mudou.
+ */
+static const LedsWave_t *volatile ledsRequest[configMAX_NUM_LEDS];
+
+/** @brief Task das leds; NULL antes de Leds_TaskInit */
+static TaskHandle_t ledsTask = NULL;
 
-/** @brief Indicao das Leds que estao picando lentamnete */
-uint8_t leds_blink_slow = 0;
+static const uint16_t leds_levels_off[] = { 0 };
 
-/** @brief Indicao das Leds que estao piscando rapido */
-uint8_t leds_blink_fast = 0;
+static const uint16_t leds_levels_on[] = { LEDS_LEVEL_MAX };
 
-/** @brief Indicao das Leds que estao piscando  */
-uint8_t leds_blink_heartbeat = 0;
+static const uint16_t leds_levels_blink[] = { LEDS_LEVEL_MAX, 0 };
 
-QueueHandle_t QueueLeds = NULL;
+static const uint16_t leds_levels_heartbeat[] =
+{
+	LEDS_LEVEL_MAX, 0, 0, LEDS_LEVEL_MAX,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+/** @brief Preenchida em Leds_TaskInit */
+static uint16_t leds_levels_breath[configLED_BREATH_LEVELS];
+
+static const LedsWave_t ledsWaveOff = { leds_levels_off, 1, 0 };
+static const LedsWave_t ledsWaveOn = { leds_levels_on, 1, 0 };
+static const LedsWave_t ledsWaveSlow = { leds_levels_blink, 2, configLED_BLINK_SLOW_STEP };
+static const LedsWave_t ledsWaveFast = { leds_levels_blink, 2, configLED_BLINK_FAST_STEP };
+static const LedsWave_t ledsWaveHeartbeat = { leds_levels_heartbeat, 16, configLED_BLINK_HEARBEAT_STEP };
+static const LedsWave_t ledsWaveBreath = { leds_levels_breath, configLED_BREATH_LEVELS, configLED_BREATH_STEP };
+
+/** @brief Padrao de cada LedsAction_e */
+static const LedsWave_t *const ledsActionWaves[] =
+{
+	&ledsWaveOff,
+	&ledsWaveOn,
+	&ledsWaveSlow,
+	&ledsWaveFast,
+	&ledsWaveHeartbeat,
+	&ledsWaveBreath,
+};
+
+/** @brief Ticks desde Leds_TaskInit: origem da fase de todos os padroes no GPIO */
+static uint64_t ledsElapsed;
+static TickType_t ledsLast;
+
+/** @brief Contadores da task; ledsStatsStart marca o ultimo reset */
+static LedsStats_t ledsStats;
+static TickType_t ledsStatsStart;
 
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
 
 /**
- * Verifica quais leds serao ligados
- * @param leds_mask: mascara que contem quais leds serao ligados.
+ * Escreve o valor de saida nas leds no GPIO
+ * @param out Valor de saida representado por bits
+ */
+static void Leds_Write(uint8_t out);
+
+/*
+ * Aplica os padroes pedidos em ledsRequest que mudaram.
+ */
+static void Leds_Action(void);
+
+/**
+ * Estado de um led no GPIO tocando uma tabela.
+ * @param wave Tabela.
+ * @param elapsed Ticks desde a origem das fases.
+ * @param remaining Saida com os ticks ate o led mudar, ou portMAX_DELAY.
+ * @return true se o led esta ligado.
  */
-static void Leds_On(uint8_t leds_mask);
+static bool Leds_WaveAt(const LedsWave_t *wave, uint64_t elapsed, TickType_t *remaining);
 
 /**
- * Verifica quais leds serao desligados
- * @param leds_mask: mascara que contem quais leds serao desligados
+ * Nivel de uma tabela no tempo, para um led no PWM tocado pela task.
+ * @param wave Tabela com mais de um nivel.
+ * @param elapsed Ticks desde a origem das fases.
+ * @param remaining Saida com os ticks ate o nivel mudar, ou portMAX_DELAY.
+ * @return Nivel atual.
  */
-static void Leds_Off(uint8_t leds_mask);
+static uint16_t Leds_WaveLevel(const LedsWave_t *wave, uint64_t elapsed, TickType_t *remaining);
 
 /**
- * Escreve o valor de saida
- * @param out Valor de saida representado por bits
+ * Indica se o led e tocado pela task no GPIO: led comum ou led do PWM com uma
+ * tabela so de apagado e aceso.
+ * @param led Led.
+ * @return true se Leds_Run calcula a saida do led.
  */
-static void Leds_Write(uint8_t out);
+static bool Leds_IsGpio(const gpio_leds *led);
 
-/*
- * Funcao para executar uma acao para um determinado led.
- * @param in_leds Indice do led
- * @param action Acao que o led ira executar
+/**
+ * Indica se uma tabela tem niveis intermediarios, que so o PWM reproduz.
+ * @param wave Tabela.
+ * @return true se algum nivel nao e 0 nem LEDS_LEVEL_MAX.
  */
-static void Leds_Action(LedsIndex_e in_leds, LedsAction_e action);
+static bool Leds_NeedsPwm(const LedsWave_t *wave);
 
-/*
- * Task principal da rotina de blink dos leds.
+/**
+ * Troca o pino de um led do PWM entre saida comum e funcao alternativa.
+ * @param led Led com gpio e htim.
+ * @param mode GPIO_MODER_MODE0_0 (saida) ou GPIO_MODER_MODE0_1 (alternativa).
  */
-static void Leds_Task(void *param);
+static void Leds_PinMode(gpio_leds *led, uint32_t mode);
+
+/**
+ * Pega ou solta a trava do STOP2 de um led do PWM.
+ * @param led Led com htim.
+ * @param lock true enquanto o padrao depende do timer contando.
+ */
+static void Leds_LowPowerLock(gpio_leds *led, bool lock);
+
+/**
+ * Indica se a tabela de um led no PWM tem passo longo demais para o timer de
+ * passo (LEDS_STEP_MAX_MS) e e tocada pela task.
+ * @param led Led com htim.
+ * @return true se a task escreve o nivel a cada passo.
+ */
+static bool Leds_PwmBySoftware(const gpio_leds *led);
 
 /**
- * Inverte os leds representados pelos bits 1 da mascara de entrada
- * @param leds_mask: mascara que contem quais leds serao invertidos
+ * Programa o padrao de um led no PWM: tabela so de 0 e maximo no GPIO, nivel
+ * fixo no canal, ou a tabela em DMA circular disparado pelo timer de passo.
+ * @param led Led com htim.
  */
-static void Leds_Reverse(uint8_t leds_mask);
+static void Leds_PwmApply(gpio_leds *led);
 
 /**
- * Funcao usada para monitoramento do status dos leds.
- * @return retorna status dos leds
+ * Calcula a saida das leds no GPIO no tick atual e escreve o que mudou; nos
+ * leds no PWM com passo longo escreve o nivel no canal.
+ * @return Ticks ate a proxima transicao, ou portMAX_DELAY se nada pisca.
+ */
+static TickType_t Leds_Run(void);
+
+/*
+ * Task principal da rotina de blink dos leds.
  */
-static uint8_t Leds_Status(void);
+static void Leds_Task(void *param);
 
 //==============================================================================
 // PRIVATE SOURCE CODE
 //==============================================================================
 
-static void Leds_Reverse(uint8_t leds_mask)
+static void Leds_Write(uint8_t out)
 {
-	/* auxiliar para operacaes logicas */
-	uint8_t leds_temp;
+	GPIO_TypeDef *port[configMAX_NUM_LEDS];
+	uint32_t bsrr[configMAX_NUM_LEDS];
+	uint32_t bits;
+	uint8_t ports = 0;
+	uint8_t index, p;
 
-	/* verifica se a mascara tem algum bit ativo */
-	if (leds_mask)
+	/* junta os pinos de cada porta: metade baixa do BSRR liga, metade alta desliga */
+	for (index = 0; index < configMAX_NUM_LEDS; index++)
 	{
-		/* Tem, entao executa a operacao de inversao */
-		/* copia o status para var temp */
-		leds_temp = ledsStatus;
-
-		/* ativa os bits definidos na mascara */
-		Leds_On(leds_mask);
-
-		/* verifica se o valor e igual ao anterior, isso significa que os bits ja estava ligados */
-		if (leds_temp == ledsStatus)
+		if (Leds_IsGpio(&leds[index]) == false)
 		{
-			/* entao devemos desligar os bits, pois eles ja estavam ativos */
-			Leds_Off(leds_mask);
+			continue;
 		}
-	}
-}
-
-static uint8_t Leds_Status(void)
-{
-	uint8_t index;
-	uint8_t status;
-	status = 0;
 
-	for (index = 0; index < configMAX_NUM_LEDS; index++)
-	{
-		if ((leds[index].gpio != NULL) && (HAL_GPIO_ReadPin(leds[index].gpio, leds[index].pin) == GPIO_PIN_SET))
+		bits = leds[index].pin;
+		if ((tst_bit(out, index) != 0) != (leds[index].active == LED_ATIVE_HIGH))
 		{
-			if (leds[index].active == LED_ATIVE_HIGH)
-			{
-				status |= (1 << index);
-			}
+			bits <<= 16;
 		}
-	}
-	return (status);
-}
 
-static void Leds_On(uint8_t leds_mask)
-{
-	uint8_t aux;
-	/* Executa um OU para ativar os bits */
-	ledsStatus = ledsStatus | leds_mask;
+		for (p = 0; (p < ports) && (port[p] != leds[index].gpio); p++)
+		{
+		}
 
-	/* Atualiza os LEDs no frontal */
-	aux = Leds_Status();
+		if (p == ports)
+		{
+			port[p] = leds[index].gpio;
+			bsrr[p] = 0;
+			ports++;
+		}
 
-	aux |= ledsStatus;
+		bsrr[p] |= bits;
+	}
 
-	Leds_Write(aux);
+	/* um store por porta: os leds da mesma porta mudam juntos, sem ler o ODR */
+	for (p = 0; p < ports; p++)
+	{
+		port[p]->BSRR = bsrr[p];
+	}
 }
 
-static void Leds_Off(uint8_t leds_mask)
+static bool Leds_WaveAt(const LedsWave_t *wave, uint64_t elapsed, TickType_t *remaining)
 {
-	uint8_t aux;
-	uint8_t leds_temp;
-
-	/* devemos desligar os bits */
-	leds_temp = ledsStatus ^ leds_mask;
+	TickType_t step;
+	uint32_t index;
+	uint16_t n;
+	bool on;
 
-	ledsStatus = ledsStatus & leds_temp;
+	*remaining = portMAX_DELAY;
 
-	aux = ledsStatus;
-
-	aux &= ~leds_mask;
-
-	/* Atualiza os LEDs no frontal */
-	Leds_Write(aux);
-}
+	if (wave->count < 2)
+	{
+		return (wave->levels[0] >= (LEDS_LEVEL_MAX / 2));
+	}
 
-static void Leds_Write(uint8_t out)
-{
-	uint8_t index;
+	/* a fase e funcao do tempo desde a origem: atrasos da task nao se acumulam */
+	step = pdMS_TO_TICKS(wave->step_ms);
+	index = (uint32_t) ((elapsed / step) % wave->count);
+	on = (wave->levels[index] >= (LEDS_LEVEL_MAX / 2));
 
-	for (index = 0; index < configMAX_NUM_LEDS; index++)
+	/* proximo passo em que o led muda; passos iguais nao acordam a task */
+	for (n = 1; n < wave->count; n++)
 	{
-		if (leds[index].gpio != NULL)
+		if ((wave->levels[(index + n) % wave->count] >= (LEDS_LEVEL_MAX / 2)) != on)
 		{
-			if (tst_bit(out, index))
-			{
-				HAL_GPIO_WritePin(leds[index].gpio, leds[index].pin, (leds[index].active == LED_ATIVE_HIGH ? GPIO_PIN_SET : GPIO_PIN_RESET));
-			}
-			else
-			{
-				HAL_GPIO_WritePin(leds[index].gpio, leds[index].pin, (leds[index].active == LED_ATIVE_HIGH ? GPIO_PIN_RESET : GPIO_PIN_SET));
-			}
+			*remaining = (TickType_t) (n * step - (TickType_t) (elapsed % step));
+			break;
 		}
 	}
+
+	return on;
 }
 
-static void Leds_Run()
+static uint16_t Leds_WaveLevel(const LedsWave_t *wave, uint64_t elapsed, TickType_t *remaining)
 {
-	static uint8_t state_hearbeat;
-	static uint8_t timer_led_hearbeat_reverse_counter = 1;
-	static uint8_t timer_led_slow_reverse_counter = 0; /* variavel de controle do blink lento */
-	static uint8_t timer_led_fast_reverse_counter = 0; /* controle do blink rapido */
-
-	/* soma 1 nos contadores */
-	timer_led_slow_reverse_counter++;
-	timer_led_fast_reverse_counter++;
-	timer_led_hearbeat_reverse_counter--;
-
-	/* verifica se devemos fazer a reversao para os slow blinks */
-	if (timer_led_slow_reverse_counter == configLED_BLINK_SLOW_STEP)
-	{
-		/* sim, o contador do slow estourou, fazemos a reversao */
-		Leds_Reverse(leds_blink_slow);
+	TickType_t step = pdMS_TO_TICKS(wave->step_ms);
+	uint32_t index = (uint32_t) ((elapsed / step) % wave->count);
+	uint16_t n;
 
-		/* zera o valor do contador apos a reversao */
-		timer_led_slow_reverse_counter = 0;
-	}
-
-	/* verifica se devemos fazer a reversao para os fast blinks */
-	if (timer_led_fast_reverse_counter == configLED_BLINK_FAST_STEP)
-	{
-		/* sim, o contador do slow estourou, fazemos a reversao */
-		Leds_Reverse(leds_blink_fast);
+	*remaining = portMAX_DELAY;
 
-		/* zera o valor do contador apos a reversao */
-		timer_led_fast_reverse_counter = 0;
-	}
-
-	/* verifica se devemos fazer a reversao para os hearbeat blinks */
-	if (timer_led_hearbeat_reverse_counter == 0)
+	for (n = 1; n < wave->count; n++)
 	{
-		switch (state_hearbeat)
+		if (wave->levels[(index + n) % wave->count] != wave->levels[index])
 		{
-		case 0:
-			timer_led_hearbeat_reverse_counter = configLED_BLINK_HEARBEAT_STATE_1;
-			state_hearbeat++;
-			break;
-
-		case 1:
-			timer_led_hearbeat_reverse_counter = configLED_BLINK_HEARBEAT_STATE_2;
-			state_hearbeat++;
-			break;
-
-		case 2:
-			timer_led_hearbeat_reverse_counter = configLED_BLINK_HEARBEAT_STATE_3;
-			state_hearbeat++;
-			break;
-
-		default:
-			timer_led_hearbeat_reverse_counter = configLED_BLINK_HEARBEAT_STATE_4;
-			state_hearbeat = 0;
+			*remaining = (TickType_t) (n * step - (TickType_t) (elapsed % step));
 			break;
 		}
-
-		/* sim, o contador do slow estourou, fazemos a reversao */
-		Leds_Reverse(leds_blink_heartbeat);
 	}
+
+	return wave->levels[index];
 }
 
-static void Leds_Task(void *param)
+static bool Leds_IsGpio(const gpio_leds *led)
 {
+	return (led->gpio != NULL) && ((led->htim == NULL) || (led->on_gpio == true));
+}
 
-	QueueHandle_t *pQueue;
-
-	pQueue = (QueueHandle_t*)param;
-	MsgLed_t MessageLed;
+static bool Leds_NeedsPwm(const LedsWave_t *wave)
+{
+	uint16_t n;
 
-	for(;;)
+	for (n = 0; n < wave->count; n++)
 	{
-		/* Verifica se recebeu algum comando */
-		if(xQueueReceive(pQueue, &MessageLed, 10) == pdTRUE)
+		if ((wave->levels[n] != 0) && (wave->levels[n] != LEDS_LEVEL_MAX))
 		{
-			Leds_Action(MessageLed.index, MessageLed.action);
-		}
-		else
-		{
-			Leds_Run();
+			return true;
 		}
 	}
+
+	return false;
 }
 
-static void Leds_Action(LedsIndex_e in_leds, LedsAction_e action)
+static void Leds_PinMode(gpio_leds *led, uint32_t mode)
 {
-	/* auxiliar para operacoes logicas */
-	uint8_t leds_temp;
+	uint32_t pos = POSITION_VAL(led->pin) * 2U;
 
-	/* verifica qual acao que as leds em questao deve executar */
-	switch (action)
-	{
-	case LED_OFF:
+	MODIFY_REG(led->gpio->MODER, GPIO_MODER_MODE0 << pos, mode << pos);
+}
 
-		/* XOR seguido de um AND para desligar os bits */
-		/* Apaga as leds 100% ligadas */
-		leds_temp = ledsON ^ in_leds;
-		ledsON = ledsON & leds_temp;
+static void Leds_LowPowerLock(gpio_leds *led, bool lock)
+{
+	if (lock == led->lp_lock)
+	{
+		return;
+	}
 
-		/* apaga as leds com blink lento */
-		leds_temp = leds_blink_slow ^ in_leds;
-		leds_blink_slow = leds_blink_slow & leds_temp;
+	led->lp_lock = lock;
 
-		/* apaga as leds com blink rapido */
-		leds_temp = leds_blink_fast ^ in_leds;
-		leds_blink_fast = leds_blink_fast & leds_temp;
+	if (lock == true)
+	{
+		RTOS_LowPowerLock();
+	}
+	else
+	{
+		RTOS_LowPowerUnlock();
+	}
+}
 
-		/* apaga as leds com blink heartbeat */
-		leds_temp = leds_blink_heartbeat ^ in_leds;
-		leds_blink_heartbeat = leds_blink_heartbeat & leds_temp;
+static bool Leds_PwmBySoftware(const gpio_leds *led)
+{
+	return (led->wave->count > 1) && (led->wave->step_ms > LEDS_STEP_MAX_MS);
+}
 
-		/* apaga as leds da mascara */
-		Leds_Off(in_leds);
+static void Leds_PwmApply(gpio_leds *led)
+{
+	DMA_HandleTypeDef *hdma = led->hstep->hdma[TIM_DMA_ID_UPDATE];
+	const LedsWave_t *wave = led->wave;
 
-		break;
+	/* para a tabela anterior */
+	__HAL_TIM_DISABLE_DMA(led->hstep, TIM_DMA_UPDATE);
+	HAL_TIM_Base_Stop(led->hstep);
+	if (hdma->State == HAL_DMA_STATE_BUSY)
+	{
+		HAL_DMA_Abort(hdma);
+	}
 
-	case LED_ON:
+	/*
+	 * Sem clock (STOP2) o PWM para e o DMA nao anda: tabela so de apagado e
+	 * aceso vai para o GPIO, cuja saida se mantem, e toca pela task.
+	 */
+	if ((led->gpio != NULL) && (Leds_NeedsPwm(wave) == false))
+	{
+		Leds_LowPowerLock(led, false);
+		__HAL_TIM_SET_COMPARE(led->htim, led->channel, 0);
 
-		/* devemos ascender as leds em questao */
-		ledsON = ledsON | in_leds;
+		if (led->on_gpio == false)
+		{
+			/* apagado antes de virar saida: Leds_Run acende no passo certo */
+			led->on_gpio = true;
+			ledsStatus &= (uint8_t) ~(1U << (led - leds));
+			Leds_Write(ledsStatus);
+			Leds_PinMode(led, GPIO_MODER_MODE0_0);
+		}
+		return;
+	}
 
-		/* desliga as leds com blink lento */
-		leds_temp = leds_blink_slow ^ in_leds;
-		leds_blink_slow = leds_blink_slow & leds_temp;
+	if (led->on_gpio == true)
+	{
+		led->on_gpio = false;
+		Leds_PinMode(led, GPIO_MODER_MODE0_1);
+	}
 
-		/* desliga as leds com blink rapido */
-		leds_temp = leds_blink_fast ^ in_leds;
-		leds_blink_fast = leds_blink_fast & leds_temp;
+	/* brilho intermediario ou tabela andando precisam do timer: sem STOP2 */
+	Leds_LowPowerLock(led, (Leds_NeedsPwm(wave) == true) || (wave->count > 1));
 
-		/* apaga as leds com blink heartbeat */
-		leds_temp = leds_blink_heartbeat ^ in_leds;
-		leds_blink_heartbeat = leds_blink_heartbeat & leds_temp;
+	__HAL_TIM_SET_COMPARE(led->htim, led->channel, wave->levels[0]);
 
-		/* acende as leds definidas */
-		Leds_On(ledsON);
+	/* passo que o ARR de 16 bits nao conta: Leds_Run escreve cada nivel */
+	if ((wave->count < 2) || (Leds_PwmBySoftware(led) == true))
+	{
+		return;
+	}
 
-		break;
+	/* cada update do timer de passo copia o proximo nivel para o CCR do canal */
+	__HAL_TIM_SET_AUTORELOAD(led->hstep, ((uint32_t) wave->step_ms * (LEDS_STEP_CLOCK_HZ / 1000)) - 1);
+	__HAL_TIM_SET_COUNTER(led->hstep, 0);
+	/* TIM_CHANNEL_x e o deslocamento em bytes do CCRx a partir do CCR1 */
+	HAL_DMA_Start(hdma, (uint32_t) wave->levels, ((uint32_t) &led->htim->Instance->CCR1) + led->channel, wave->count);
+	__HAL_TIM_ENABLE_DMA(led->hstep, TIM_DMA_UPDATE);
 
-	case LED_BLINK_SLOW:
+	/* o update forcado copia levels[0] agora: cada nivel dura um passo inteiro */
+	HAL_TIM_GenerateEvent(led->hstep, TIM_EVENTSOURCE_UPDATE);
+	HAL_TIM_Base_Start(led->hstep);
+}
 
-		/* Apaga as leds 100% ligadas */
-		leds_temp = ledsON ^ in_leds;
-		ledsON = ledsON & leds_temp;
+static TickType_t Leds_Run(void)
+{
+	TickType_t now = xTaskGetTickCount();
+	TickType_t wait = portMAX_DELAY;
+	TickType_t remaining;
+	uint8_t out = 0;
+	uint8_t i;
 
-		/* ativa as leds com blink lento */
-		leds_blink_slow = leds_blink_slow | in_leds;
+	ledsElapsed += (TickType_t) (now - ledsLast);
+	ledsLast = now;
 
-		/* apaga as leds com blink rapido */
-		leds_temp = leds_blink_fast ^ in_leds;
-		leds_blink_fast = leds_blink_fast & leds_temp;
+	for (i = 0; i < configMAX_NUM_LEDS; i++)
+	{
+		/* leds no PWM andam sozinhos, exceto com passo longo demais para o DMA */
+		if ((leds[i].htim != NULL) && (leds[i].on_gpio == false))
+		{
+			if (Leds_PwmBySoftware(&leds[i]) == true)
+			{
+				__HAL_TIM_SET_COMPARE(leds[i].htim, leds[i].channel, Leds_WaveLevel(leds[i].wave, ledsElapsed, &remaining));
+				if (remaining < wait)
+				{
+					wait = remaining;
+				}
+			}
+			continue;
+		}
 
-		/* apaga as leds com blink heartbeat */
-		leds_temp = leds_blink_heartbeat ^ in_leds;
-		leds_blink_heartbeat = leds_blink_heartbeat & leds_temp;
+		if (leds[i].gpio == NULL)
+		{
+			continue;
+		}
 
-		break;
+		if (Leds_WaveAt(leds[i].wave, ledsElapsed, &remaining) == true)
+		{
+			out |= (1 << i);
+		}
 
-	case LED_BLINK_FAST:
+		if (remaining < wait)
+		{
+			wait = remaining;
+		}
+	}
 
-		/* Apaga as leds 100% ligadas */
-		leds_temp = ledsON ^ in_leds;
-		ledsON = ledsON & leds_temp;
+	if (out != ledsStatus)
+	{
+		ledsStatus = out;
+		Leds_Write(out);
+		ledsStats.transitions++;
+	}
 
-		/* apaga as leds com blink lento */
-		leds_temp = leds_blink_slow ^ in_leds;
-		leds_blink_slow = leds_blink_slow & leds_temp;
+	return wait;
+}
 
-		/* ativa as leds com blink rapido */
-		leds_blink_fast = leds_blink_fast | in_leds;
+static void Leds_Task(void *param)
+{
+	TickType_t wait;
+	uint8_t i;
 
-		/* apaga as leds com blink heartbeat */
-		leds_temp = leds_blink_heartbeat ^ in_leds;
-		leds_blink_heartbeat = leds_blink_heartbeat & leds_temp;
+	for (i = 0; i < configMAX_NUM_LEDS; i++)
+	{
+		if (leds[i].htim != NULL)
+		{
+			Leds_PwmApply(&leds[i]);
+		}
+	}
 
-		break;
+	/* Pedidos feitos antes da task rodar */
+	Leds_Action();
 
-	case LED_BLINK_HEARTBEAT:
+	Leds_Write(ledsStatus);
+	wait = Leds_Run();
 
-		/* apaga as leds com blink lento */
-		leds_temp = leds_blink_slow ^ in_leds;
-		leds_blink_slow = leds_blink_slow & leds_temp;
+	for(;;)
+	{
+		/* Dorme ate o proximo comando ou a proxima transicao de algum led no GPIO */
+		if (ulTaskNotifyTake(pdTRUE, wait) != 0)
+		{
+			Leds_Action();
+		}
+		ledsStats.wakeups++;
 
-		/* apaga as leds com blink rapido */
-		leds_temp = leds_blink_fast ^ in_leds;
-		leds_blink_fast = leds_blink_fast & leds_temp;
+		wait = Leds_Run();
+	}
+}
 
-		/* ativa as leds com blink heartbeat */
-		leds_blink_heartbeat = leds_blink_fast | in_leds;
+static void Leds_Action(void)
+{
+	const LedsWave_t *wave;
+	uint8_t i;
 
-		break;
+	/* a saida no GPIO e recalculada por Leds_Run; o PWM e reprogramado aqui */
+	for (i = 0; i < configMAX_NUM_LEDS; i++)
+	{
+		wave = ledsRequest[i];
+		if (wave == NULL)
+		{
+			wave = &ledsWaveOff;
+		}
 
-	default:
-		break;
+		/* varios pedidos entre duas leituras: so o ultimo importa */
+		if (wave != leds[i].wave)
+		{
+			leds[i].wave = wave;
+			ledsStats.commands++;
 
+			if (leds[i].htim != NULL)
+			{
+				Leds_PwmApply(&leds[i]);
+			}
+		}
 	}
 }
 //==============================================================================
@@ -425,29 +540,71 @@ static void Leds_Action(LedsIndex_e in_leds, LedsAction_e action)
 void Leds_TaskInit(void)
 {
 	BaseType_t xReturned;
+	uint32_t x;
+	uint8_t i;
 
-	ledsStatus = 0;
-	ledsON = 0;
-	leds_blink_slow = 0;
-	leds_blink_fast = 0;
+	/* respiracao: triangulo ao quadrado, que o olho percebe quase linear */
+	for (i = 0; i < configLED_BREATH_LEVELS; i++)
+	{
+		x = (i < (configLED_BREATH_LEVELS / 2)) ? i : (configLED_BREATH_LEVELS - i);
+		leds_levels_breath[i] = (uint16_t) ((LEDS_LEVEL_MAX * x * x)
+				/ ((configLED_BREATH_LEVELS / 2) * (configLED_BREATH_LEVELS / 2)));
+	}
+
+	for (i = 0; i < configMAX_NUM_LEDS; i++)
+	{
+		leds[i].wave = &ledsWaveOff;
+	}
 
-	QueueLeds = xQueueCreate(4, sizeof(MsgLed_t));
-	DBG_ASSERT_PARAM(QueueLeds);
-	vQueueAddToRegistry(QueueLeds, (const char *)"Leds");
+	ledsStatus = 0;
+	ledsElapsed = 0;
+	ledsLast = xTaskGetTickCount();
+	Leds_ResetStats();
 
-	xReturned = xTaskCreate(Leds_Task, "LedsTimer", configMINIMAL_STACK_SIZE * 2, QueueLeds, 3, NULL);
+	xReturned = xTaskCreate(Leds_Task, "LedsTimer", configMINIMAL_STACK_SIZE * 2, NULL, 3, &ledsTask);
 	configASSERT(xReturned);
 
 }
 
 void Leds_Set(LedsIndex_e in_leds, LedsAction_e action)
 {
-	MsgLed_t msgLed;
+	if ((uint32_t) action < (sizeof(ledsActionWaves) / sizeof(ledsActionWaves[0])))
+	{
+		Leds_SetWave(in_leds, ledsActionWaves[action]);
+	}
+}
 
-	msgLed.index = in_leds;
-	msgLed.action = action;
+void Leds_SetWave(LedsIndex_e in_leds, const LedsWave_t *wave)
+{
+	BaseType_t woken = pdFALSE;
+	uint8_t i;
+
+	DBG_ASSERT_PARAM((wave != NULL) && (wave->count > 0) && ((wave->count == 1) || (wave->step_ms > 0)));
 
-	xQueueSend(QueueLeds, &msgLed, 1000);
+	/* um store alinhado de 32 bits por led: atomico no Cortex-M4 */
+	for (i = 0; i < configMAX_NUM_LEDS; i++)
+	{
+		if (tst_bit(in_leds, i))
+		{
+			ledsRequest[i] = wave;
+		}
+	}
+
+	/* antes de Leds_TaskInit o pedido fica guardado para a task */
+	if (ledsTask == NULL)
+	{
+		return;
+	}
+
+	if (xPortIsInsideInterrupt() == pdTRUE)
+	{
+		vTaskNotifyGiveFromISR(ledsTask, &woken);
+		portYIELD_FROM_ISR(woken);
+	}
+	else
+	{
+		xTaskNotifyGive(ledsTask);
+	}
 }
 
 
@@ -458,3 +615,33 @@ void Leds_Attach(LedsIndex_e index, GPIO_TypeDef *gpio, uint16_t pin, LedActive_
 	leds[countUntilFirstByteOne(index)].active = active;
 }
 
+void Leds_AttachPwm(LedsIndex_e index, TIM_HandleTypeDef *htim, uint32_t channel, TIM_HandleTypeDef *hstep)
+{
+	gpio_leds *led = &leds[countUntilFirstByteOne(index)];
+
+	DBG_ASSERT_PARAM(hstep->hdma[TIM_DMA_ID_UPDATE]);
+
+	led->htim = htim;
+	led->channel = channel;
+	led->hstep = hstep;
+
+	__HAL_TIM_SET_COMPARE(htim, channel, 0);
+	HAL_TIM_PWM_Start(htim, channel);
+}
+
+void Leds_GetStats(LedsStats_t *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = ledsStats;
+	stats->elapsed_ms = (uint32_t) ((xTaskGetTickCount() - ledsStatsStart) * portTICK_PERIOD_MS);
+	taskEXIT_CRITICAL();
+}
+
+void Leds_ResetStats(void)
+{
+	taskENTER_CRITICAL();
+	memset(&ledsStats, 0, sizeof(ledsStats));
+	ledsStatsStart = xTaskGetTickCount();
+	taskEXIT_CRITICAL();
+}
+
@@ -2,8 +2,31 @@
  * @file    leds.h
  * @author  Jorge Guzman
  * @date    Jan 14, 2015
- * @version 0.1.0
+ * @version 0.5.0
  * @brief   Bibliteoca para o uso dos Leds
+ * @details
+ * Os padroes sao tabelas de niveis (LedsWave_t) tocadas em passos de tempo
+ * fixos. Um led ligado a um GPIO comum e controlado pela task, que acende
+ * o led nos niveis a partir de LEDS_LEVEL_MAX / 2 e so acorda nas mudancas.
+ * Um led num canal de PWM (Leds_AttachPwm) toca a tabela em hardware: um
+ * timer de passo pede um DMA a cada atualizacao, que copia o proximo nivel
+ * para o registrador de comparacao do canal, em modo circular. Depois de
+ * configurado o padrao nao gasta CPU, e aceita niveis intermediarios
+ * (brilho e respiracao). Tabelas com passo acima de LEDS_STEP_MAX_MS, que o
+ * timer de passo nao conta, sao tocadas pela task como as do GPIO, escrevendo
+ * o nivel no canal a cada mudanca.
+ *
+ * Em STOP2 os timers param: o PWM congela e o DMA nao anda. Um led no PWM que
+ * tambem foi registrado com Leds_Attach toca as tabelas so de apagado e
+ * aceso (ligado, blink, heartbeat) no GPIO, com o pino virando saida comum, e
+ * o STOP2 fica livre. Tabelas com niveis intermediarios (respiracao, brilho)
+ * voltam o pino para o PWM e seguram RTOS_LowPowerLock enquanto tocam.
+ *
+ * Os comandos nao passam por fila: cada led tem uma palavra com o padrao
+ * pedido, escrita com um unico store (o ultimo comando vence), e a task e
+ * avisada por notificacao. Leds_Set e Leds_SetWave nao bloqueiam e podem
+ * ser chamadas de qualquer contexto, inclusive de interrupcoes com
+ * prioridade logica ate configMAX_SYSCALL_INTERRUPT_PRIORITY.
  */
 
 #ifndef _LEDS_H_
@@ -32,6 +55,15 @@ extern "C" {
 // PUBLIC DEFINITIONS
 //==============================================================================
 
+/** @brief Nivel de brilho maximo; o timer de PWM deve contar LEDS_LEVEL_MAX passos */
+#define LEDS_LEVEL_MAX			1000
+
+/** @brief Clock do timer de passo das tabelas de PWM */
+#define LEDS_STEP_CLOCK_HZ		10000
+
+/** @brief Maior passo tocado por DMA em led no PWM: o ARR do timer de passo tem 16 bits */
+#define LEDS_STEP_MAX_MS		(0x10000UL / (LEDS_STEP_CLOCK_HZ / 1000))
+
 /** @brief Acoes que o led pode realizar*/
 typedef enum
 {
@@ -39,7 +71,8 @@ typedef enum
 	LED_ON, 			/**< Liga o led*/
 	LED_BLINK_SLOW, 	/**< Faz o led piscar lentamente */
 	LED_BLINK_FAST, 	/**< Faz o led piscar rapidamente */
-	LED_BLINK_HEARTBEAT /**< Faz o led piscar na forma de hearbeat */
+	LED_BLINK_HEARTBEAT,/**< Faz o led piscar na forma de hearbeat */
+	LED_BREATH			/**< Faz o led respirar (liga e desliga suave no PWM) */
 } LedsAction_e;
 
 typedef enum
@@ -66,11 +99,22 @@ typedef enum
 	ALL_LED = 0xFF,
 } LedsIndex_e;
 
+/** @brief Padrao: levels[i] dura step_ms e a tabela se repete */
 typedef struct
 {
-	LedsIndex_e index;
-	LedsAction_e action;
-}MsgLed_t;
+	const uint16_t *levels;	/**< Niveis de 0 a LEDS_LEVEL_MAX */
+	uint16_t count;			/**< Numero de niveis */
+	uint16_t step_ms;		/**< Duracao de cada nivel (ignorada com count 1) */
+} LedsWave_t;
+
+/** @brief Contadores da task das leds */
+typedef struct
+{
+	uint32_t wakeups;		/**< Vezes que a task acordou */
+	uint32_t commands;		/**< Mudancas de padrao aplicadas */
+	uint32_t transitions;	/**< Escritas com mudanca na saida */
+	uint32_t elapsed_ms;	/**< Tempo desde o ultimo reset */
+} LedsStats_t;
 
 //==============================================================================
 // EXTERN VARIABLES
@@ -93,6 +137,15 @@ void Leds_TaskInit(void);
  */
 void Leds_Set(LedsIndex_e in_leds, LedsAction_e action);
 
+/**
+ * Faz os leds tocarem uma tabela qualquer. A tabela nao e copiada e deve
+ * continuar valida enquanto estiver em uso (o DMA le direto dela). Num led
+ * no PWM, passos acima de LEDS_STEP_MAX_MS sao tocados pela task.
+ * @param in_leds indica os leds que serao usados.
+ * @param wave tabela de niveis.
+ */
+void Leds_SetWave(LedsIndex_e in_leds, const LedsWave_t *wave);
+
 /**
  * Funcao que configura um led atribuindo a ele uma representação de pino I/O.
  * @param Led que sera configurado (Range: N_LED1 a N_LED8).
@@ -100,6 +153,31 @@ void Leds_Set(LedsIndex_e in_leds, LedsAction_e action);
  */
 void Leds_Attach(LedsIndex_e index, GPIO_TypeDef *gpio, uint16_t pin, LedActive_e active);
 
+/**
+ * Passa um led para um canal de PWM, com as tabelas tocadas por DMA. Deve ser
+ * chamada antes de Leds_TaskInit, com o pino ja na funcao alternativa. Com o
+ * pino tambem registrado em Leds_Attach as tabelas sem niveis intermediarios
+ * sao tocadas no GPIO, sem impedir o STOP2.
+ * @param index Led que sera configurado (Range: N_LED1 a N_LED8).
+ * @param htim Timer do PWM, com periodo de LEDS_LEVEL_MAX contagens; a
+ * polaridade do led fica na configuracao do canal.
+ * @param channel Canal do PWM (TIM_CHANNEL_x).
+ * @param hstep Timer de passo contando a LEDS_STEP_CLOCK_HZ, com o DMA do
+ * update (hdma[TIM_DMA_ID_UPDATE]) circular, de memoria para periferico, em
+ * half-words. Um timer de passo por led.
+ */
+void Leds_AttachPwm(LedsIndex_e index, TIM_HandleTypeDef *htim, uint32_t channel, TIM_HandleTypeDef *hstep);
+
+/**
+ * Retorna os contadores da task. A task so acorda para comandos e para as
+ * transicoes dos padroes ativos: com as leds fixas fica bloqueada.
+ * @param stats Estrutura de saida.
+ */
+void Leds_GetStats(LedsStats_t *stats);
+
+/** @brief Zera os contadores da task. */
+void Leds_ResetStats(void);
+
 /* C++ detection */
 #ifdef __cplusplus
 }
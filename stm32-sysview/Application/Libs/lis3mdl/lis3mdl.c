@@ -12,6 +12,7 @@
 // INCLUDE FILES
 //==============================================================================
 #include "lis3mdl.h"
+#include "imuconv/imuconv.h"
 
 //==============================================================================
 // PRIVATE VARIABLES
@@ -19,6 +20,16 @@
 
 static I2C_HandleTypeDef *pI2C_LIS3MDL = 0;
 
+/* Sensitivity of the configured full scale (0 = not known yet) */
+static int32_t LIS3MDL_MagSens = 0;
+
+/* Block conversion of the magnetometer (identity, scale = sensitivity) */
+static ImuConv_t LIS3MDL_Conv;
+static uint8_t LIS3MDL_ConvReady = 0;
+
+/* Copy of CTRL_REG1..CTRL_REG5, written in one burst by LIS3MDL_MagInit */
+static uint8_t LIS3MDL_Ctrl[REGMAP_COUNT(LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG5)];
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
@@ -40,6 +51,23 @@ static void LIS3MDL_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value);
  */
 static uint8_t LIS3MDL_IO_Read(uint8_t Addr, uint8_t Reg);
 
+/**
+ * @brief  Writes multiple data with I2C communication.
+ * @param  Addr: I2C address
+ * @param  Reg: Register address (bit 7 set for auto-increment)
+ * @param  Buffer: Pointer to data buffer
+ * @param  Length: Length of the data
+ * @retval None
+ */
+static void LIS3MDL_IO_WriteMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length);
+
+/**
+ * @brief  Writes a register of the board device (REGMAP_UPDATE).
+ * @param  Reg: Reg address
+ * @param  Value: Data to be written
+ */
+static void LIS3MDL_WriteReg(uint8_t Reg, uint8_t Value);
+
 /**
  * @brief  Reads multiple data with I2C communication
  *         channel from TouchScreen.
@@ -70,6 +98,25 @@ static void LIS3MDL_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
 	}
 }
 
+static void LIS3MDL_IO_WriteMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+
+	status = HAL_I2C_Mem_Write(pI2C_LIS3MDL, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, Buffer, Length, 1000);
+
+	/* Check the communication status */
+	if (status != HAL_OK)
+	{
+		/* I2C error occured */
+		DBG("ERRO I2C");
+	}
+}
+
+static void LIS3MDL_WriteReg(uint8_t Reg, uint8_t Value)
+{
+	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, Reg, Value);
+}
+
 static uint8_t LIS3MDL_IO_Read(uint8_t Addr, uint8_t Reg)
 {
 	uint8_t read_value = 0;
@@ -103,6 +150,67 @@ static uint16_t LIS3MDL_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buff
 	return status;
 }
 
+/**
+ * @brief  Magnetometer sensitivity for the FS bits of CTRL_REG2.
+ * @param  ctrl: CTRL_REG2 value
+ * @retval Sensitivity in ugauss/LSB
+ */
+static int32_t LIS3MDL_MagSensitivity(uint8_t ctrl)
+{
+	switch (ctrl & 0x60)
+	{
+	case LIS3MDL_MAG_FS_8_GA:
+		return LIS3MDL_MAG_SENSITIVITY_FOR_FS_8GA_UGAUSS;
+
+	case LIS3MDL_MAG_FS_12_GA:
+		return LIS3MDL_MAG_SENSITIVITY_FOR_FS_12GA_UGAUSS;
+
+	case LIS3MDL_MAG_FS_16_GA:
+		return LIS3MDL_MAG_SENSITIVITY_FOR_FS_16GA_UGAUSS;
+
+	default:
+		return LIS3MDL_MAG_SENSITIVITY_FOR_FS_4GA_UGAUSS;
+	}
+}
+
+/**
+ * @brief  Reads the raw X, Y & Z outputs in a single burst.
+ * @param  raw: Raw X, Y, Z
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef LIS3MDL_MagReadRaw(int32_t *raw)
+{
+	HAL_StatusTypeDef status;
+	uint8_t buffer[6];
+	uint8_t i;
+
+	status = (HAL_StatusTypeDef) LIS3MDL_IO_ReadMultiple(LIS3MDL_MAG_I2C_ADDRESS_HIGH, (LIS3MDL_MAG_OUTX_L | 0x80), buffer, 6);
+
+	for (i = 0; i < 3; i++)
+	{
+		raw[i] = (int16_t) ((((uint16_t) buffer[2 * i + 1]) << 8) + (uint16_t) buffer[2 * i]);
+	}
+
+	return status;
+}
+
+/**
+ * @brief  Conversion parameters with the current sensitivity.
+ * @retval Block conversion parameters
+ */
+static const ImuConv_t *LIS3MDL_GetConv(void)
+{
+	if (LIS3MDL_ConvReady == 0)
+	{
+		ImuConv_Init(&LIS3MDL_Conv, 0);
+		LIS3MDL_ConvReady = 1;
+	}
+
+	ImuConv_SetScale(&LIS3MDL_Conv, LIS3MDL_MagSens);
+
+	return &LIS3MDL_Conv;
+}
+
 //==============================================================================
 // PUBLIC SOURCE CODE
 //==============================================================================
@@ -131,28 +239,28 @@ void LIS3MDL_attach(I2C_HandleTypeDef *hI2Handler)
 
 void LIS3MDL_MagInit(MAGNETO_Init_t LIS3MDL_InitStruct)
 {
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_InitStruct.Register1);
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG2, LIS3MDL_InitStruct.Register2);
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG3, LIS3MDL_InitStruct.Register3);
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG4, LIS3MDL_InitStruct.Register4);
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG5, LIS3MDL_InitStruct.Register5);
-}
+	REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG1) = LIS3MDL_InitStruct.Register1;
+	REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG2) = LIS3MDL_InitStruct.Register2;
+	REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG3) = LIS3MDL_InitStruct.Register3;
+	REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG4) = LIS3MDL_InitStruct.Register4;
+	REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG5) = LIS3MDL_InitStruct.Register5;
 
-void LIS3MDL_MagDeInit(void)
-{
-	uint8_t ctrl = 0x00;
+	/* CTRL_REG1..CTRL_REG5 in one burst (bit 7 of the sub-address: auto-increment) */
+	LIS3MDL_IO_WriteMultiple(LIS3MDL_MAG_I2C_ADDRESS_HIGH, (LIS3MDL_MAG_CTRL_REG1 | 0x80), LIS3MDL_Ctrl, sizeof(LIS3MDL_Ctrl));
 
-	/* Read control register 1 value */
-	ctrl = LIS3MDL_IO_Read(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG3);
+	/* REBOOT and SOFT_RST clear themselves: they are not kept in the copy */
+	REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG2) &=
+			~REGMAP_MASKS(LIS3MDL_MAG_CTRL_REG2, REGMAP_SET(LIS3MDL_REBOOT_FIELD, 0), REGMAP_SET(LIS3MDL_SOFT_RST_FIELD, 0));
 
-	/* Clear Selection Mode bits */
-	ctrl &= ~(LIS3MDL_MAG_SELECTION_MODE);
+	/* Keep the scale so that reads don't need to fetch CTRL_REG2 again */
+	LIS3MDL_MagSens = LIS3MDL_MagSensitivity(LIS3MDL_InitStruct.Register2);
+}
 
+void LIS3MDL_MagDeInit(void)
+{
 	/* Set Power down */
-	ctrl |= LIS3MDL_MAG_POWERDOWN2_MODE;
-
-	/* write back control register */
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG3, ctrl);
+	REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG3,
+			REGMAP_SET(LIS3MDL_MD_FIELD, LIS3MDL_MAG_POWERDOWN2_MODE));
 }
 
 uint8_t LIS3MDL_MagReadID(void)
@@ -164,71 +272,208 @@ uint8_t LIS3MDL_MagReadID(void)
 
 void LIS3MDL_MagLowPower(uint16_t status)
 {
-	uint8_t ctrl = 0;
+	/* Set or clear Low Power Mode */
+	REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG3,
+			REGMAP_SETV(LIS3MDL_LP_FIELD, status != 0));
+}
+
+void LIS3MDL_MagReadXYZ(int32_t* pData)
+{
+	uint8_t i;
+
+	if (LIS3MDL_MagSens == 0)
+	{
+		LIS3MDL_MagSens = LIS3MDL_MagSensitivity(REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG2));
+	}
 
-	/* Read control register 1 value */
-	ctrl = LIS3MDL_IO_Read(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG3);
+	/* Read output register X, Y & Z magnetic field */
+	LIS3MDL_MagReadRaw(pData);
 
-	/* Clear Low Power Mode bit */
-	ctrl &= ~(0x20);
+	/* Obtain the uGauss value for the three axis */
+	for (i = 0; i < 3; i++)
+	{
+		pData[i] *= LIS3MDL_MagSens;
+	}
+}
 
-	/* Set Low Power Mode */
-	if (status)
+uint32_t LIS3MDL_MagGetOdr(void)
+{
+	static const uint32_t odr_mhz[] = { 625, 1250, 2500, 5000, 10000, 20000, 40000, 80000 };
+	static const uint32_t fast_odr_mhz[] = { 1000000, 560000, 300000, 155000 };
+	uint8_t ctrl1 = REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG1);
+	uint8_t ctrl3 = REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG3);
+
+	/* Single-conversion and power-down modes have no continuous data rate */
+	if (REGMAP_GET(LIS3MDL_MD_FIELD, ctrl3) != LIS3MDL_MAG_CONTINUOUS_MODE)
 	{
-		ctrl |= LIS3MDL_MAG_CONFIG_LOWPOWER_MODE;
+		return 0;
 	}
-	else
+
+	/* FAST_ODR: rate depends on the X/Y operating mode */
+	if (REGMAP_GET(LIS3MDL_FAST_ODR_FIELD, ctrl1))
 	{
-		ctrl |= LIS3MDL_MAG_CONFIG_NORMAL_MODE;
+		return fast_odr_mhz[REGMAP_GET(LIS3MDL_OM_XY_FIELD, ctrl1)];
 	}
 
-	/* write back control register */
-	LIS3MDL_IO_Write(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG3, ctrl);
+	return odr_mhz[REGMAP_GET(LIS3MDL_DO_FIELD, ctrl1)];
 }
 
-void LIS3MDL_MagReadXYZ(int16_t* pData)
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+static const uint32_t LIS3MDL_Odrs[] = { 625, 1250, 2500, 5000, 10000, 20000, 40000, 80000 };
+
+static const uint32_t LIS3MDL_Ranges[] = { 4, 8, 12, 16 };
+static const uint8_t LIS3MDL_Fs[] = { LIS3MDL_MAG_FS_4_GA, LIS3MDL_MAG_FS_8_GA, LIS3MDL_MAG_FS_12_GA, LIS3MDL_MAG_FS_16_GA };
+
+static const SensorChannelDesc_t LIS3MDL_Channels[] =
 {
-	int16_t pnRawData[3];
-	uint8_t ctrlm = 0;
-	uint8_t buffer[6];
-	uint8_t i = 0;
-	float sensitivity = 0;
+	{ "magneto", SENSOR_TYPE_MAGNETO, 3, "mgauss", 1000, LIS3MDL_Odrs, 8, LIS3MDL_Ranges, 4 },
+};
 
-	/* Read the magnetometer control register content */
-	ctrlm = LIS3MDL_IO_Read(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_CTRL_REG2);
+static HAL_StatusTypeDef LIS3MDL_DrvProbe(void)
+{
+	return (LIS3MDL_MagReadID() == I_AM_LIS3MDL) ? HAL_OK : HAL_ERROR;
+}
 
-	/* Read output register X, Y & Z acceleration */
-	LIS3MDL_IO_ReadMultiple(LIS3MDL_MAG_I2C_ADDRESS_HIGH, (LIS3MDL_MAG_OUTX_L | 0x80), buffer, 6);
+static HAL_StatusTypeDef LIS3MDL_DrvInit(void)
+{
+	LIS3MDL_myInit();
 
-	for (i = 0; i < 3; i++)
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef LIS3MDL_DrvSetOdr(uint8_t ch, uint32_t odr_mhz)
+{
+	/* DO[2:0] follows LIS3MDL_Odrs; FAST_ODR is left disabled */
+	REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG1,
+			REGMAP_SETV(LIS3MDL_DO_FIELD, SensorDrv_OdrIndex(&LIS3MDL_Channels[ch], odr_mhz)), REGMAP_SET(LIS3MDL_FAST_ODR_FIELD, 0));
+
+	return HAL_OK;
+}
+
+static uint32_t LIS3MDL_DrvGetOdr(uint8_t ch)
+{
+	return LIS3MDL_MagGetOdr();
+}
+
+static HAL_StatusTypeDef LIS3MDL_DrvSetRange(uint8_t ch, uint32_t range)
+{
+	uint8_t fs = LIS3MDL_Fs[SensorDrv_RangeIndex(&LIS3MDL_Channels[ch], range)];
+
+	LIS3MDL_MagSens = LIS3MDL_MagSensitivity(fs);
+	REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG2,
+			REGMAP_SETV(LIS3MDL_FS_FIELD, REGMAP_GET(LIS3MDL_FS_FIELD, fs)));
+
+	return HAL_OK;
+}
+
+static uint32_t LIS3MDL_DrvGetRange(uint8_t ch)
+{
+	return LIS3MDL_Ranges[REGMAP_GET(LIS3MDL_FS_FIELD, REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG2))];
+}
+
+static HAL_StatusTypeDef LIS3MDL_DrvSetPower(uint8_t ch, SensorPower_e power)
+{
+	if (power == SENSOR_POWER_OFF)
 	{
-		pnRawData[i] = ((((uint16_t) buffer[2 * i + 1]) << 8) + (uint16_t) buffer[2 * i]);
+		LIS3MDL_MagDeInit();
+		return HAL_OK;
 	}
 
-	/* Normal mode */
-	/* Switch the sensitivity value set in the CRTL_REG2 */
-	switch (ctrlm & 0x60)
+	/*
+	 * The LP bit would force 0.625 Hz regardless of DO[2:0], so the low power
+	 * state uses the low-power operating mode of the axes and keeps the ODR.
+	 */
+	if (power == SENSOR_POWER_LOW)
+	{
+		REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG1,
+				REGMAP_SET(LIS3MDL_OM_XY_FIELD, REGMAP_GET(LIS3MDL_OM_XY_FIELD, LIS3MDL_MAG_OM_XY_LOWPOWER)));
+		REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG4,
+				REGMAP_SET(LIS3MDL_OM_Z_FIELD, REGMAP_GET(LIS3MDL_OM_Z_FIELD, LIS3MDL_MAG_OM_Z_LOWPOWER)));
+	}
+	else
 	{
-	case LIS3MDL_MAG_FS_4_GA:
-		sensitivity = LIS3MDL_MAG_SENSITIVITY_FOR_FS_4GA;
-		break;
+		REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG1,
+				REGMAP_SET(LIS3MDL_OM_XY_FIELD, REGMAP_GET(LIS3MDL_OM_XY_FIELD, LIS3MDL_MAG_OM_XY_HIGH)));
+		REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG4,
+				REGMAP_SET(LIS3MDL_OM_Z_FIELD, REGMAP_GET(LIS3MDL_OM_Z_FIELD, LIS3MDL_MAG_OM_Z_HIGH)));
+	}
 
-	case LIS3MDL_MAG_FS_8_GA:
-		sensitivity = LIS3MDL_MAG_SENSITIVITY_FOR_FS_8GA;
-		break;
+	REGMAP_UPDATE(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_WriteReg, LIS3MDL_MAG_CTRL_REG3,
+			REGMAP_SET(LIS3MDL_MD_FIELD, LIS3MDL_MAG_CONTINUOUS_MODE), REGMAP_SET(LIS3MDL_LP_FIELD, 0));
 
-	case LIS3MDL_MAG_FS_12_GA:
-		sensitivity = LIS3MDL_MAG_SENSITIVITY_FOR_FS_12GA;
-		break;
+	return HAL_OK;
+}
 
-	case LIS3MDL_MAG_FS_16_GA:
-		sensitivity = LIS3MDL_MAG_SENSITIVITY_FOR_FS_16GA;
-		break;
+static HAL_StatusTypeDef LIS3MDL_DrvOneShot(uint8_t ch)
+{
+	uint8_t *ctrl3 = &REGMAP_AT(LIS3MDL_Ctrl, LIS3MDL_MAG_CTRL_REG1, LIS3MDL_MAG_CTRL_REG3);
+	uint32_t t;
+
+	/*
+	 * Single-measurement mode returns to idle by itself after the conversion:
+	 * the copy keeps idle, the register gets single.
+	 */
+	*ctrl3 = (*ctrl3 & ~REGMAP_MASK(LIS3MDL_MD_FIELD)) | REGMAP_BITS(LIS3MDL_MAG_CTRL_REG3,
+			REGMAP_SET(LIS3MDL_MD_FIELD, LIS3MDL_MAG_POWERDOWN2_MODE));
+	LIS3MDL_WriteReg(LIS3MDL_MAG_CTRL_REG3, (*ctrl3 & ~REGMAP_MASK(LIS3MDL_MD_FIELD)) | REGMAP_BITS(LIS3MDL_MAG_CTRL_REG3,
+			REGMAP_SET(LIS3MDL_MD_FIELD, LIS3MDL_MAG_SINGLE_MODE)));
+
+	for (t = 0; t < LIS3MDL_ONE_SHOT_TIMEOUT_MS; t++)
+	{
+		osDelay(1);
+
+		if (LIS3MDL_IO_Read(LIS3MDL_MAG_I2C_ADDRESS_HIGH, LIS3MDL_MAG_STATUS_REG) & LIS3MDL_MAG_STATUS_ZYXDA)
+		{
+			return HAL_OK;
+		}
 	}
 
-	/* Obtain the mGauss value for the three axis */
+	return HAL_TIMEOUT;
+}
+
+static HAL_StatusTypeDef LIS3MDL_DrvReadRaw(uint8_t ch, int32_t *raw)
+{
+	return LIS3MDL_MagReadRaw(raw);
+}
+
+static void LIS3MDL_DrvConvert(uint8_t ch, const int32_t *raw, int32_t *out, uint16_t count)
+{
+	uint8_t i;
+
+	if (count > 1)
+	{
+		/* Blocks go through the block kernel */
+		ImuConv_Int32(LIS3MDL_GetConv(), raw, out, count);
+		return;
+	}
+
+	/* A single sample costs less as a plain multiply (identity, no bias) */
 	for (i = 0; i < 3; i++)
 	{
-		pData[i] = (int16_t) (pnRawData[i] * sensitivity);
+		out[i] = raw[i] * LIS3MDL_MagSens;
 	}
 }
+
+const SensorDriver_t LIS3MDL_Driver =
+{
+	.name = "LIS3MDL",
+	.address = LIS3MDL_MAG_I2C_ADDRESS_HIGH,
+	.num_channels = 1,
+	.channels = LIS3MDL_Channels,
+	.shared_odr = false,
+	.probe = LIS3MDL_DrvProbe,
+	.init = LIS3MDL_DrvInit,
+	.set_odr = LIS3MDL_DrvSetOdr,
+	.get_odr = LIS3MDL_DrvGetOdr,
+	.set_range = LIS3MDL_DrvSetRange,
+	.get_range = LIS3MDL_DrvGetRange,
+	.set_power = LIS3MDL_DrvSetPower,
+	.read_raw = LIS3MDL_DrvReadRaw,
+	.read_batch = NULL,
+	.convert = LIS3MDL_DrvConvert,
+	.one_shot = LIS3MDL_DrvOneShot,
+	.set_filter = NULL,
+};
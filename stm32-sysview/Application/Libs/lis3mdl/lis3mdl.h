@@ -20,6 +20,8 @@ extern "C" {
 //==============================================================================
 
 #include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+#include "regmap/regmap.h"
 
 //==============================================================================
 // PUBLIC DEFINES
@@ -34,6 +36,12 @@ extern "C" {
 
 #define I_AM_LIS3MDL                        ((uint8_t)0x3D)
 
+/* Channel exported through LIS3MDL_Driver */
+#define LIS3MDL_CH_MAGNETO                  0
+
+/* Maximum wait for a single-measurement conversion, in ms */
+#define LIS3MDL_ONE_SHOT_TIMEOUT_MS         100
+
 /************** Device Register  *******************/
 
 #define LIS3MDL_MAG_WHO_AM_I_REG    0x0F
@@ -125,12 +133,32 @@ extern "C" {
 #define LIS3MDL_MAG_BDU_CONTINUOUS           ((uint8_t) 0x00)
 #define LIS3MDL_MAG_BDU_MSBLSB               ((uint8_t) 0x40)
 
+/* Mag operating mode fields (CTRL_REG1 / CTRL_REG4) */
+#define LIS3MDL_MAG_OM_XY_MASK               ((uint8_t) 0x60)
+#define LIS3MDL_MAG_OM_Z_MASK                ((uint8_t) 0x0C)
+
+/* Control register fields (regmap) */
+#define LIS3MDL_TEMP_EN_FIELD                REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG1, 7, 1)
+#define LIS3MDL_OM_XY_FIELD                  REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG1, 5, 2)
+#define LIS3MDL_DO_FIELD                     REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG1, 2, 3)
+#define LIS3MDL_FAST_ODR_FIELD               REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG1, 1, 1)
+#define LIS3MDL_FS_FIELD                     REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG2, 5, 2)
+#define LIS3MDL_REBOOT_FIELD                 REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG2, 3, 1)
+#define LIS3MDL_SOFT_RST_FIELD               REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG2, 2, 1)
+#define LIS3MDL_LP_FIELD                     REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG3, 5, 1)
+#define LIS3MDL_MD_FIELD                     REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG3, 0, 2)
+#define LIS3MDL_OM_Z_FIELD                   REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG4, 2, 2)
+#define LIS3MDL_BDU_FIELD                    REGMAP_FIELD(LIS3MDL_MAG_CTRL_REG5, 6, 1)
+
+/* Mag new XYZ data available (STATUS_REG) */
+#define LIS3MDL_MAG_STATUS_ZYXDA             ((uint8_t) 0x08)
+
 
 /* Magnetometer_Sensitivity */
-#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_4GA   ((float)0.14f)  /**< Sensitivity value for 4 gauss full scale  [mgauss/LSB] */
-#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_8GA   ((float)0.29f)  /**< Sensitivity value for 8 gauss full scale  [mgauss/LSB] */
-#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_12GA  ((float)0.43f)  /**< Sensitivity value for 12 gauss full scale [mgauss/LSB] */
-#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_16GA  ((float)0.58f)  /**< Sensitivity value for 16 gauss full scale [mgauss/LSB] */
+#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_4GA_UGAUSS   ((int32_t)140)  /**< Sensitivity value for 4 gauss full scale  [ugauss/LSB] */
+#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_8GA_UGAUSS   ((int32_t)290)  /**< Sensitivity value for 8 gauss full scale  [ugauss/LSB] */
+#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_12GA_UGAUSS  ((int32_t)430)  /**< Sensitivity value for 12 gauss full scale [ugauss/LSB] */
+#define LIS3MDL_MAG_SENSITIVITY_FOR_FS_16GA_UGAUSS  ((int32_t)580)  /**< Sensitivity value for 16 gauss full scale [ugauss/LSB] */
 
 //==============================================================================
 // PUBLIC TYPEDEFS
@@ -180,9 +208,24 @@ void LIS3MDL_MagLowPower(uint16_t status);
 
 /**
  * @brief  Read X, Y & Z Magnetometer values
- * @param  pData: Data out pointer
+ * @param  pData: Data out pointer, 3 values in ugauss
+ */
+void LIS3MDL_MagReadXYZ(int32_t* pData);
+
+/**
+ * @brief  Read the output data rate configured in CTRL_REG1/CTRL_REG3.
+ * @retval ODR in mHz (0 in single-conversion or power-down mode)
+ */
+uint32_t LIS3MDL_MagGetOdr(void);
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+/**
+ * @brief  LIS3MDL descriptor for the sensor registry (magnetometer).
  */
-void LIS3MDL_MagReadXYZ(int16_t* pData);
+extern const SensorDriver_t LIS3MDL_Driver;
 
 #ifdef __cplusplus
 }
@@ -14,12 +14,38 @@
 
 #include "lps22hb.h"
 
+#include <string.h>
+
 //==============================================================================
 // PRIVATE VARIABLES
 //==============================================================================
 
 static I2C_HandleTypeDef *pI2C_LPS22HB = 0;
 
+/* ODR code restored when a channel is powered up again */
+static uint8_t LPS22HB_OdrCode = 0x03;
+
+/* Channels kept powered through the sensor interface */
+static uint8_t LPS22HB_PowerMask = (1 << LPS22HB_CH_PRESSURE) | (1 << LPS22HB_CH_TEMPERATURE);
+
+/* Bus traffic counters (LPS22HB_GetBusStats) */
+static uint32_t LPS22HB_BusTransfers = 0;
+static uint32_t LPS22HB_BusBytes = 0;
+
+/* FIFO state, counters and last sample drained (pressure, temperature) */
+static uint8_t LPS22HB_FifoRunning = 0;
+static uint8_t LPS22HB_FifoLastValid = 0;
+static int32_t LPS22HB_FifoLast[2];
+static uint32_t LPS22HB_FifoSamples = 0;
+static uint32_t LPS22HB_FifoOverruns = 0;
+
+/* Burst buffer: the FIFO is only read with the registry lock held */
+static uint8_t LPS22HB_FifoBuffer[LPS22HB_FIFO_SIZE * LPS22HB_FIFO_SLOT_BYTES];
+
+/* Copy of the control registers, read once in LPS22HB_Init: updates are write-only */
+static uint8_t LPS22HB_Ctrl[REGMAP_COUNT(LPS22HB_CTRL_REG1, LPS22HB_CTRL_FIFO_REG)];
+static uint8_t LPS22HB_ResConf[1];
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
@@ -41,6 +67,23 @@ static void LPS22HB_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value);
  */
 static uint8_t LPS22HB_IO_Read(uint8_t Addr, uint8_t Reg);
 
+/**
+ * @brief  Writes a register of the board device (REGMAP_UPDATE).
+ * @param  Reg: Reg address
+ * @param  Value: Data to be written
+ */
+static void LPS22HB_WriteReg(uint8_t Reg, uint8_t Value);
+
+/**
+ * @brief  Reads consecutive registers (IF_ADD_INC is enabled by default).
+ * @param  Addr: I2C address
+ * @param  Reg: First register address
+ * @param  Buffer: Pointer to data buffer
+ * @param  Length: Length of the data
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef LPS22HB_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length);
+
 //==============================================================================
 // PUBLIC SOURCE CODE
 //==============================================================================
@@ -52,6 +95,10 @@ static uint8_t LPS22HB_IO_Read(uint8_t Addr, uint8_t Reg)
 
 	status = HAL_I2C_Mem_Read(pI2C_LPS22HB, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, (uint8_t*) &read_value, 1, 1000);
 
+	/* Device address, register, device address again, data */
+	LPS22HB_BusTransfers++;
+	LPS22HB_BusBytes += 4;
+
 	/* Check the communication status */
 	if (status != HAL_OK)
 	{
@@ -68,6 +115,10 @@ void LPS22HB_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
 
 	status = HAL_I2C_Mem_Write(pI2C_LPS22HB, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, (uint8_t*) &Value, 1, 1000);
 
+	/* Device address, register, data */
+	LPS22HB_BusTransfers++;
+	LPS22HB_BusBytes += 3;
+
 	/* Check the communication status */
 	if (status != HAL_OK)
 	{
@@ -76,6 +127,30 @@ void LPS22HB_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
 	}
 }
 
+static void LPS22HB_WriteReg(uint8_t Reg, uint8_t Value)
+{
+	LPS22HB_IO_Write(LPS22HB_I2C_ADDRESS, Reg, Value);
+}
+
+static HAL_StatusTypeDef LPS22HB_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+
+	status = HAL_I2C_Mem_Read(pI2C_LPS22HB, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, Buffer, Length, 1000);
+
+	LPS22HB_BusTransfers++;
+	LPS22HB_BusBytes += 3 + Length;
+
+	/* Check the communication status */
+	if (status != HAL_OK)
+	{
+		/* I2C error occured */
+		DBG("ERRO I2C");
+	}
+
+	return status;
+}
+
 void LPS22HB_attach(I2C_HandleTypeDef *hI2Handler)
 {
 	pI2C_LPS22HB = hI2Handler;
@@ -96,17 +171,15 @@ uint8_t LPS22HB_P_ReadID(uint16_t DeviceAddr)
 	return ctrl;
 }
 
-float LPS22HB_P_ReadPressure(uint16_t DeviceAddr)
+int32_t LPS22HB_P_ReadPressure(uint16_t DeviceAddr)
 {
 	int32_t raw_press;
 	uint8_t buffer[3];
 	uint32_t tmp = 0;
 	uint8_t i;
 
-	for (i = 0; i < 3; i++)
-	{
-		buffer[i] = LPS22HB_IO_Read(DeviceAddr, (LPS22HB_PRESS_OUT_XL_REG + i));
-	}
+	/* Single burst: XL, L and H belong to the same sample */
+	LPS22HB_IO_ReadMultiple(DeviceAddr, LPS22HB_PRESS_OUT_XL_REG, buffer, 3);
 
 	/* Build the raw data */
 	for (i = 0; i < 3; i++)
@@ -122,9 +195,8 @@ float LPS22HB_P_ReadPressure(uint16_t DeviceAddr)
 
 	raw_press = ((int32_t) tmp);
 
-	raw_press = (raw_press * 100) / 4096;
-
-	return (float) ((float) raw_press / 100.0f);
+	/* Sensitivity is 4096 LSB/hPa: the raw value is returned untouched */
+	return raw_press;
 }
 
 void LPS22HB_T_Init(uint16_t DeviceAddr)
@@ -132,49 +204,354 @@ void LPS22HB_T_Init(uint16_t DeviceAddr)
 	LPS22HB_Init(DeviceAddr);
 }
 
-float LPS22HB_T_ReadTemp(uint16_t DeviceAddr)
+int16_t LPS22HB_T_ReadTemp(uint16_t DeviceAddr)
 {
-	int16_t raw_data;
 	uint8_t buffer[2];
 	uint16_t tmp;
-	uint8_t i;
 
-	for (i = 0; i < 2; i++)
-	{
-		buffer[i] = LPS22HB_IO_Read(DeviceAddr, (LPS22HB_TEMP_OUT_L_REG + i));
-	}
+	LPS22HB_IO_ReadMultiple(DeviceAddr, LPS22HB_TEMP_OUT_L_REG, buffer, 2);
 
 	/* Build the raw tmp */
 	tmp = (((uint16_t) buffer[1]) << 8) + (uint16_t) buffer[0];
 
-	raw_data = (tmp * 10) / 100;
-
-	return ((float) (raw_data / 10.0f));
+	/* Sensitivity is 100 LSB/C: the 2's complement value is already in 0.01 C */
+	return (int16_t) tmp;
 }
 
 void LPS22HB_Init(uint16_t DeviceAddr)
 {
-	uint8_t tmp;
+	/* Copy of CTRL_REG1..FIFO_CTRL in one burst (IF_ADD_INC is set at reset), RES_CONF apart */
+	LPS22HB_IO_ReadMultiple(DeviceAddr, LPS22HB_CTRL_REG1, LPS22HB_Ctrl, sizeof(LPS22HB_Ctrl));
+	LPS22HB_ResConf[0] = LPS22HB_IO_Read(DeviceAddr, LPS22HB_RES_CONF_REG);
+
+	/* Set low current mode */
+	REGMAP_UPDATE(LPS22HB_ResConf, LPS22HB_RES_CONF_REG, LPS22HB_WriteReg, LPS22HB_RES_CONF_REG,
+			REGMAP_SET(LPS22HB_LCEN_FIELD, 1));
+
+	/* Set ODR to 25Hz and enable BDU in a single write */
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG1,
+			REGMAP_SET(LPS22HB_ODR_FIELD, 3), REGMAP_SET(LPS22HB_BDU_FIELD, 1));
+}
+
+uint32_t LPS22HB_GetOdr(uint16_t DeviceAddr)
+{
+	static const uint32_t odr_mhz[] = { 0, 1000, 10000, 25000, 50000, 75000, 0, 0 };
+
+	/* Only the driver writes CTRL_REG1: its copy is current */
+	return odr_mhz[REGMAP_GET(LPS22HB_ODR_FIELD, REGMAP_AT(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_CTRL_REG1))];
+}
+
+void LPS22HB_FifoStart(uint8_t watermark)
+{
+	if (watermark == 0)
+	{
+		watermark = 1;
+	}
+	else if (watermark >= LPS22HB_FIFO_SIZE)
+	{
+		watermark = LPS22HB_FIFO_SIZE - 1;
+	}
+
+	/* Bypass first: clears whatever the FIFO still holds (already empty if the copy says bypass) */
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_FIFO_REG,
+			REGMAP_SET(LPS22HB_FIFO_MODE_FIELD, 0));
+
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG2,
+			REGMAP_SET(LPS22HB_FIFO_EN_FIELD, 1), REGMAP_SET(LPS22HB_WTM_EN_FIELD, 0), REGMAP_SET(LPS22HB_ADD_INC_FIELD, 1));
+
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_FIFO_REG,
+			REGMAP_SET(LPS22HB_FIFO_MODE_FIELD, LPS22HB_FIFO_MODE_STREAM >> 5), REGMAP_SETV(LPS22HB_WTM_POINT_FIELD, watermark));
+
+	/* INT_DRDY push-pull, active high, data signal = FIFO threshold only */
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG3,
+			REGMAP_SET(LPS22HB_INT_H_L_FIELD, 0), REGMAP_SET(LPS22HB_PP_OD_FIELD, 0), REGMAP_SET(LPS22HB_FIFO_FULL_FIELD, 0),
+			REGMAP_SET(LPS22HB_FIFO_FTH_FIELD, 1), REGMAP_SET(LPS22HB_FIFO_OVR_FIELD, 0), REGMAP_SET(LPS22HB_DRDY_FIELD, 0),
+			REGMAP_SET(LPS22HB_INT_S12_FIELD, 0));
+
+	LPS22HB_FifoSamples = 0;
+	LPS22HB_FifoOverruns = 0;
+	LPS22HB_FifoLastValid = 0;
+	LPS22HB_FifoRunning = 1;
+}
+
+void LPS22HB_FifoStop(void)
+{
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG3,
+			REGMAP_SET(LPS22HB_FIFO_FTH_FIELD, 0));
+
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_FIFO_REG,
+			REGMAP_SET(LPS22HB_FIFO_MODE_FIELD, 0));
+
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG2,
+			REGMAP_SET(LPS22HB_FIFO_EN_FIELD, 0));
+
+	LPS22HB_FifoRunning = 0;
+}
+
+uint16_t LPS22HB_FifoRead(int32_t *pressure, int16_t *temp, uint16_t max)
+{
+	uint8_t *slot = LPS22HB_FifoBuffer;
+	uint8_t status;
+	uint16_t count, i;
+	uint32_t tmp;
+
+	if (LPS22HB_FifoRunning == 0)
+	{
+		return 0;
+	}
+
+	status = LPS22HB_IO_Read(LPS22HB_I2C_ADDRESS, LPS22HB_STATUS_FIFO_REG);
+
+	if (status & LPS22HB_OVR_FIFO_MASK)
+	{
+		LPS22HB_FifoOverruns++;
+	}
+
+	count = status & LPS22HB_LEVEL_FIFO_MASK;
+	count = (count > max) ? max : count;
+
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	/* With FIFO_EN the address rolls back from TEMP_OUT_H to PRESS_OUT_XL: one burst pops count slots */
+	if (LPS22HB_IO_ReadMultiple(LPS22HB_I2C_ADDRESS, LPS22HB_PRESS_OUT_XL_REG, LPS22HB_FifoBuffer, count * LPS22HB_FIFO_SLOT_BYTES) != HAL_OK)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < count; i++, slot += LPS22HB_FIFO_SLOT_BYTES)
+	{
+		tmp = ((uint32_t) slot[2] << 16) | ((uint32_t) slot[1] << 8) | (uint32_t) slot[0];
+
+		/* convert the 2's complement 24 bit to 2's complement 32 bit */
+		if (tmp & 0x00800000)
+		{
+			tmp |= 0xFF000000;
+		}
+
+		pressure[i] = (int32_t) tmp;
+
+		if (temp != NULL)
+		{
+			temp[i] = (int16_t) ((((uint16_t) slot[4]) << 8) | (uint16_t) slot[3]);
+		}
+	}
+
+	slot -= LPS22HB_FIFO_SLOT_BYTES;
+	LPS22HB_FifoLast[LPS22HB_CH_PRESSURE] = pressure[count - 1];
+	LPS22HB_FifoLast[LPS22HB_CH_TEMPERATURE] = (int16_t) ((((uint16_t) slot[4]) << 8) | (uint16_t) slot[3]);
+	LPS22HB_FifoLastValid = 1;
+	LPS22HB_FifoSamples += count;
+
+	return count;
+}
+
+void LPS22HB_FifoGetStats(uint32_t *samples, uint32_t *overruns)
+{
+	taskENTER_CRITICAL();
+	*samples = LPS22HB_FifoSamples;
+	*overruns = LPS22HB_FifoOverruns;
+	taskEXIT_CRITICAL();
+}
+
+void LPS22HB_GetBusStats(uint32_t *transfers, uint32_t *bytes)
+{
+	taskENTER_CRITICAL();
+	*transfers = LPS22HB_BusTransfers;
+	*bytes = LPS22HB_BusBytes;
+	taskEXIT_CRITICAL();
+}
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+static const uint32_t LPS22HB_Odrs[] = { 1000, 10000, 25000, 50000, 75000 };
+
+static const SensorChannelDesc_t LPS22HB_Channels[] =
+{
+	{ "pressure", SENSOR_TYPE_PRESSURE, 1, "hPa", 4096, LPS22HB_Odrs, 5, NULL, 0 },
+	{ "temperature", SENSOR_TYPE_TEMPERATURE, 1, "C", 100, LPS22HB_Odrs, 5, NULL, 0 },
+};
+
+static HAL_StatusTypeDef LPS22HB_DrvProbe(void)
+{
+	return (LPS22HB_P_ReadID(LPS22HB_I2C_ADDRESS) == LPS22HB_WHO_AM_I_VAL) ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef LPS22HB_DrvInit(void)
+{
+	LPS22HB_Init(LPS22HB_I2C_ADDRESS);
+	LPS22HB_OdrCode = 0x03;
+	LPS22HB_PowerMask = (1 << LPS22HB_CH_PRESSURE) | (1 << LPS22HB_CH_TEMPERATURE);
+
+	return HAL_OK;
+}
+
+/**
+ * @brief  Writes the ODR field: the stored code while any channel is in use,
+ *         zero (power-down / one-shot) otherwise.
+ */
+static void LPS22HB_DrvApplyOdr(void)
+{
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG1,
+			REGMAP_SETV(LPS22HB_ODR_FIELD, (LPS22HB_PowerMask != 0) ? LPS22HB_OdrCode : 0));
+}
+
+static HAL_StatusTypeDef LPS22HB_DrvSetOdr(uint8_t ch, uint32_t odr_mhz)
+{
+	/* ODR codes 1..5 follow LPS22HB_Odrs; both channels share CTRL_REG1 */
+	LPS22HB_OdrCode = SensorDrv_OdrIndex(&LPS22HB_Channels[ch], odr_mhz) + 1;
+	LPS22HB_DrvApplyOdr();
+
+	return HAL_OK;
+}
+
+static uint32_t LPS22HB_DrvGetOdr(uint8_t ch)
+{
+	return LPS22HB_GetOdr(LPS22HB_I2C_ADDRESS);
+}
+
+static HAL_StatusTypeDef LPS22HB_DrvSetPower(uint8_t ch, SensorPower_e power)
+{
+	if (power == SENSOR_POWER_OFF)
+	{
+		LPS22HB_PowerMask &= ~(1 << ch);
+	}
+	else
+	{
+		LPS22HB_PowerMask |= (1 << ch);
+
+		/* LC_EN: low-current mode trades noise for ~3x less supply current */
+		REGMAP_UPDATE(LPS22HB_ResConf, LPS22HB_RES_CONF_REG, LPS22HB_WriteReg, LPS22HB_RES_CONF_REG,
+				REGMAP_SETV(LPS22HB_LCEN_FIELD, power == SENSOR_POWER_LOW));
+	}
+
+	LPS22HB_DrvApplyOdr();
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef LPS22HB_DrvOneShot(uint8_t ch)
+{
+	uint32_t t;
+
+	/* The other channel is converting: its output registers are already fresh */
+	if (LPS22HB_PowerMask != 0)
+	{
+		return HAL_OK;
+	}
+
+	/* ODR is already 000 (power-down / one-shot) with no channel in use */
+	/* ONE_SHOT clears itself: written, but not kept in the copy */
+	LPS22HB_WriteReg(LPS22HB_CTRL_REG2, REGMAP_AT(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_CTRL_REG2) |
+			REGMAP_BITS(LPS22HB_CTRL_REG2, REGMAP_SET(LPS22HB_ONE_SHOT_FIELD, 1)));
+
+	/* ONE_SHOT is self-cleared when the new dataset is ready */
+	for (t = 0; t < LPS22HB_ONE_SHOT_TIMEOUT_MS; t++)
+	{
+		osDelay(1);
+
+		if ((LPS22HB_IO_Read(LPS22HB_I2C_ADDRESS, LPS22HB_CTRL_REG2) & LPS22HB_ONE_SHOT_MASK) == 0)
+		{
+			return HAL_OK;
+		}
+	}
+
+	return HAL_TIMEOUT;
+}
+
+static HAL_StatusTypeDef LPS22HB_DrvSetFilter(uint8_t ch, uint16_t level)
+{
+	/* Only pressure goes through the LPF: bandwidth ODR/9 or ODR/20 */
+	if (ch != LPS22HB_CH_PRESSURE)
+	{
+		return HAL_ERROR;
+	}
+
+	REGMAP_UPDATE(LPS22HB_Ctrl, LPS22HB_CTRL_REG1, LPS22HB_WriteReg, LPS22HB_CTRL_REG1,
+			REGMAP_SETV(LPS22HB_LPFP_FIELD, level > 1), REGMAP_SETV(LPS22HB_LPFP_CUTOFF_FIELD, level > 9));
+
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef LPS22HB_DrvReadRaw(uint8_t ch, int32_t *raw)
+{
+	HAL_StatusTypeDef status;
+	uint8_t buffer[3];
+	uint32_t tmp;
+
+	/* Reading the output registers would pop the FIFO: hand out the last drained sample */
+	if (LPS22HB_FifoRunning != 0)
+	{
+		raw[0] = LPS22HB_FifoLast[ch];
 
-	/* Set Power mode */
-	tmp = LPS22HB_IO_Read(DeviceAddr, LPS22HB_RES_CONF_REG);
+		return (LPS22HB_FifoLastValid != 0) ? HAL_OK : HAL_BUSY;
+	}
 
-	tmp &= ~LPS22HB_LCEN_MASK;
-	tmp |= (uint8_t) 0x01; /* Set low current mode */
+	if (ch == LPS22HB_CH_PRESSURE)
+	{
+		status = LPS22HB_IO_ReadMultiple(LPS22HB_I2C_ADDRESS, LPS22HB_PRESS_OUT_XL_REG, buffer, 3);
+
+		tmp = ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[1] << 8) | (uint32_t) buffer[0];
+
+		/* convert the 2's complement 24 bit to 2's complement 32 bit */
+		if (tmp & 0x00800000)
+		{
+			tmp |= 0xFF000000;
+		}
+
+		raw[0] = (int32_t) tmp;
+	}
+	else
+	{
+		status = LPS22HB_IO_ReadMultiple(LPS22HB_I2C_ADDRESS, LPS22HB_TEMP_OUT_L_REG, buffer, 2);
 
-	LPS22HB_IO_Write(DeviceAddr, LPS22HB_RES_CONF_REG, tmp);
+		raw[0] = (int16_t) ((((uint16_t) buffer[1]) << 8) | (uint16_t) buffer[0]);
+	}
 
-	/* Read CTRL_REG1 */
-	tmp = LPS22HB_IO_Read(DeviceAddr, LPS22HB_CTRL_REG1);
+	return status;
+}
 
-	/* Set default ODR */
-	tmp &= ~LPS22HB_ODR_MASK;
-	tmp |= (uint8_t) 0x30; /* Set ODR to 25Hz */
+static uint16_t LPS22HB_DrvReadBatch(uint8_t ch, int32_t *raw, uint16_t max)
+{
+	/* Pressure drains the FIFO; temperature keeps the last value of the slot */
+	if ((ch == LPS22HB_CH_PRESSURE) && (LPS22HB_FifoRunning != 0))
+	{
+		return LPS22HB_FifoRead(raw, NULL, max);
+	}
 
-	/* Enable BDU */
-	tmp &= ~LPS22HB_BDU_MASK;
-	tmp |= ((uint8_t) 0x02);
+	return (LPS22HB_DrvReadRaw(ch, raw) == HAL_OK) ? 1 : 0;
+}
 
-	/* Apply settings to CTRL_REG1 */
-	LPS22HB_IO_Write(DeviceAddr, LPS22HB_CTRL_REG1, tmp);
+static void LPS22HB_DrvConvert(uint8_t ch, const int32_t *raw, int32_t *out, uint16_t count)
+{
+	/* 4096 LSB/hPa and 100 LSB/C: the raw outputs are already in channel units */
+	if (out != raw)
+	{
+		memcpy(out, raw, count * sizeof(int32_t));
+	}
 }
+
+const SensorDriver_t LPS22HB_Driver =
+{
+	.name = "LPS22HB",
+	.address = LPS22HB_I2C_ADDRESS,
+	.num_channels = 2,
+	.channels = LPS22HB_Channels,
+	.shared_odr = true,
+	.probe = LPS22HB_DrvProbe,
+	.init = LPS22HB_DrvInit,
+	.set_odr = LPS22HB_DrvSetOdr,
+	.get_odr = LPS22HB_DrvGetOdr,
+	.set_range = NULL,
+	.get_range = NULL,
+	.set_power = LPS22HB_DrvSetPower,
+	.read_raw = LPS22HB_DrvReadRaw,
+	.read_batch = LPS22HB_DrvReadBatch,
+	.convert = LPS22HB_DrvConvert,
+	.one_shot = LPS22HB_DrvOneShot,
+	.set_filter = LPS22HB_DrvSetFilter,
+};
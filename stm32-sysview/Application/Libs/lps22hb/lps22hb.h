@@ -48,6 +48,8 @@ extern "C" {
 //==============================================================================
 
 #include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+#include "regmap/regmap.h"
 
 //==============================================================================
 // PUBLIC DEFINES
@@ -55,6 +57,19 @@ extern "C" {
 
 #define LPS22HB_I2C_ADDRESS  (uint8_t)0xBA
 
+/**
+ * @brief  Channels exported through LPS22HB_Driver.
+ */
+#define LPS22HB_CH_PRESSURE     0
+#define LPS22HB_CH_TEMPERATURE  1
+
+/* Maximum wait for a one-shot conversion, in ms */
+#define LPS22HB_ONE_SHOT_TIMEOUT_MS  100
+
+/* FIFO depth and bytes per slot (PRESS_OUT_XL..TEMP_OUT_H) */
+#define LPS22HB_FIFO_SIZE            32
+#define LPS22HB_FIFO_SLOT_BYTES      5
+
 
 /**
  * @brief  Bitfield positioning.
@@ -112,6 +127,8 @@ extern "C" {
 #define LPS22HB_RES_CONF_REG     (uint8_t)0x1A
 #define LPS22HB_LCEN_MASK        (uint8_t)0x01
 
+#define LPS22HB_LCEN_FIELD       REGMAP_FIELD(LPS22HB_RES_CONF_REG, 0, 1)
+
 /**
  * @brief Control Register 1
  *        Read/write
@@ -142,6 +159,12 @@ extern "C" {
 #define LPS22HB_BDU_MASK                (uint8_t)0x02
 #define LPS22HB_SIM_MASK                (uint8_t)0x01
 
+#define LPS22HB_ODR_FIELD               REGMAP_FIELD(LPS22HB_CTRL_REG1, 4, 3)
+#define LPS22HB_LPFP_FIELD              REGMAP_FIELD(LPS22HB_CTRL_REG1, 3, 1)
+#define LPS22HB_LPFP_CUTOFF_FIELD       REGMAP_FIELD(LPS22HB_CTRL_REG1, 2, 1)
+#define LPS22HB_BDU_FIELD               REGMAP_FIELD(LPS22HB_CTRL_REG1, 1, 1)
+#define LPS22HB_SIM_FIELD               REGMAP_FIELD(LPS22HB_CTRL_REG1, 0, 1)
+
 #define LPS22HB_LPFP_BIT    LPS22HB_BIT(3)
 
 /**
@@ -173,6 +196,14 @@ extern "C" {
 #define LPS22HB_I2C_MASK       (uint8_t)0x08
 #define LPS22HB_ONE_SHOT_MASK  (uint8_t)0x01
 
+#define LPS22HB_BOOT_FIELD     REGMAP_FIELD(LPS22HB_CTRL_REG2, 7, 1)
+#define LPS22HB_FIFO_EN_FIELD  REGMAP_FIELD(LPS22HB_CTRL_REG2, 6, 1)
+#define LPS22HB_WTM_EN_FIELD   REGMAP_FIELD(LPS22HB_CTRL_REG2, 5, 1)
+#define LPS22HB_ADD_INC_FIELD  REGMAP_FIELD(LPS22HB_CTRL_REG2, 4, 1)
+#define LPS22HB_I2C_FIELD      REGMAP_FIELD(LPS22HB_CTRL_REG2, 3, 1)
+#define LPS22HB_SW_RESET_FIELD REGMAP_FIELD(LPS22HB_CTRL_REG2, 2, 1)
+#define LPS22HB_ONE_SHOT_FIELD REGMAP_FIELD(LPS22HB_CTRL_REG2, 0, 1)
+
 /**
  * @brief CTRL Reg3 Interrupt Control Register
  *        Read/write
@@ -207,6 +238,14 @@ extern "C" {
 #define LPS22HB_DRDY_MASK               (uint8_t)0x04
 #define LPS22HB_INT_S12_MASK            (uint8_t)0x03
 
+#define LPS22HB_INT_H_L_FIELD           REGMAP_FIELD(LPS22HB_CTRL_REG3, 7, 1)
+#define LPS22HB_PP_OD_FIELD             REGMAP_FIELD(LPS22HB_CTRL_REG3, 6, 1)
+#define LPS22HB_FIFO_FULL_FIELD         REGMAP_FIELD(LPS22HB_CTRL_REG3, 5, 1)
+#define LPS22HB_FIFO_FTH_FIELD          REGMAP_FIELD(LPS22HB_CTRL_REG3, 4, 1)
+#define LPS22HB_FIFO_OVR_FIELD          REGMAP_FIELD(LPS22HB_CTRL_REG3, 3, 1)
+#define LPS22HB_DRDY_FIELD              REGMAP_FIELD(LPS22HB_CTRL_REG3, 2, 1)
+#define LPS22HB_INT_S12_FIELD           REGMAP_FIELD(LPS22HB_CTRL_REG3, 0, 2)
+
 /**
  * @brief Interrupt Differential configuration Register
  *        Read/write
@@ -378,6 +417,12 @@ extern "C" {
 #define LPS22HB_FIFO_MODE_MASK        (uint8_t)0xE0
 #define LPS22HB_WTM_POINT_MASK        (uint8_t)0x1F
 
+#define LPS22HB_FIFO_MODE_BYPASS      (uint8_t)0x00
+#define LPS22HB_FIFO_MODE_STREAM      (uint8_t)0x40
+
+#define LPS22HB_FIFO_MODE_FIELD       REGMAP_FIELD(LPS22HB_CTRL_FIFO_REG, 5, 3)
+#define LPS22HB_WTM_POINT_FIELD       REGMAP_FIELD(LPS22HB_CTRL_FIFO_REG, 0, 5)
+
 /**
  * @brief FIFO Status register
  *        Read
@@ -458,9 +503,10 @@ uint8_t LPS22HB_P_ReadID(uint16_t DeviceAddr);
 
 /**
  * @brief  Read pressure value of LPS22HB
- * @retval pressure value
+ * @param  DeviceAddr: I2C device address
+ * @retval pressure in 1/4096 hPa (raw 24-bit output, sign extended)
  */
-float LPS22HB_P_ReadPressure(uint16_t DeviceAddr);
+int32_t LPS22HB_P_ReadPressure(uint16_t DeviceAddr);
 
 //==============================================================================
 // TEMPERATURE - PUBLIC FUNCTIONS
@@ -476,9 +522,65 @@ void LPS22HB_T_Init(uint16_t DeviceAddr);
 /**
  * @brief  Read temperature value of LPS22HB
  * @param  DeviceAddr: I2C device address
- * @retval temperature value
+ * @retval temperature in 0.01 C
+ */
+int16_t LPS22HB_T_ReadTemp(uint16_t DeviceAddr);
+
+/**
+ * @brief  Read the output data rate configured in CTRL_REG1.
+ * @param  DeviceAddr: I2C device address
+ * @retval ODR in mHz (0 in one-shot mode)
+ */
+uint32_t LPS22HB_GetOdr(uint16_t DeviceAddr);
+
+//==============================================================================
+// FIFO - PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * @brief  Start the FIFO in stream mode with the watermark (FTH) routed to
+ *         INT_DRDY. While it runs, the output registers belong to the FIFO:
+ *         single reads through the driver return the last sample drained.
+ * @param  watermark: Samples that raise INT_DRDY (1 to LPS22HB_FIFO_SIZE - 1)
+ */
+void LPS22HB_FifoStart(uint8_t watermark);
+
+/**
+ * @brief  Back to bypass mode with the FIFO disabled and INT_DRDY off.
+ */
+void LPS22HB_FifoStop(void);
+
+/**
+ * @brief  Drain up to max samples, oldest first, in a single burst.
+ * @param  pressure: Raw pressure of each sample (1/4096 hPa)
+ * @param  temp: Raw temperature of each sample (0.01 C) or NULL
+ * @param  max: Maximum number of samples
+ * @retval Samples read (0 when stopped or empty)
+ */
+uint16_t LPS22HB_FifoRead(int32_t *pressure, int16_t *temp, uint16_t max);
+
+/**
+ * @brief  FIFO counters since the last LPS22HB_FifoStart.
+ * @param  samples: Samples read
+ * @param  overruns: Reads that found the FIFO overwritten
+ */
+void LPS22HB_FifoGetStats(uint32_t *samples, uint32_t *overruns);
+
+/**
+ * @brief  Bus traffic of the driver since boot.
+ * @param  transfers: I2C transactions
+ * @param  bytes: Bytes on the bus (device and register addresses included)
+ */
+void LPS22HB_GetBusStats(uint32_t *transfers, uint32_t *bytes);
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+/**
+ * @brief  LPS22HB descriptor for the sensor registry (pressure and temperature).
  */
-float LPS22HB_T_ReadTemp(uint16_t DeviceAddr);
+extern const SensorDriver_t LPS22HB_Driver;
 
 #ifdef __cplusplus
 }
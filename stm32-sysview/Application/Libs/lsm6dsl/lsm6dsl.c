@@ -13,6 +13,8 @@
 //==============================================================================
 
 #include "lsm6dsl.h"
+#include "imuconv/imuconv.h"
+#include "timebase/timebase.h"
 
 //==============================================================================
 // PRIVATE VARIABLES
@@ -20,6 +22,50 @@
 
 static I2C_HandleTypeDef *pI2C_LSM6DSL = 0;
 
+/* Sensitivity of the configured full scale (0 = not known yet) */
+static int32_t LSM6DSL_AccSens = 0;
+static int32_t LSM6DSL_GyroSens = 0;
+
+/* ODR codes restored when a channel is powered up again */
+static uint8_t LSM6DSL_AccOdr = LSM6DSL_ODR_52Hz;
+static uint8_t LSM6DSL_GyroOdr = LSM6DSL_ODR_52Hz;
+
+/* Channels kept powered through the sensor interface */
+static uint8_t LSM6DSL_PowerMask = (1 << LSM6DSL_CH_GYRO) | (1 << LSM6DSL_CH_ACCELERO);
+
+/* Block conversion of each channel (identity, scale = sensitivity) */
+static ImuConv_t LSM6DSL_Conv[2];
+static uint8_t LSM6DSL_ConvReady = 0;
+
+/* Bus traffic counters (LSM6DSL_GetBusStats) */
+static uint32_t LSM6DSL_BusTransfers = 0;
+static uint32_t LSM6DSL_BusBytes = 0;
+
+/* Accelerometer FIFO state and counters (LSM6DSL_FifoGetStats) */
+static uint8_t LSM6DSL_FifoRunning = 0;
+static uint32_t LSM6DSL_FifoSamples = 0;
+static uint32_t LSM6DSL_FifoOverruns = 0;
+
+/* FIFO timestamp: requested for the next start and stored by the running FIFO */
+static uint8_t LSM6DSL_FifoStampReq = 0;
+static uint8_t LSM6DSL_FifoStamped = 0;
+
+/* Chip clock against Timebase_Us and the 24-bit counter extended to 64 bits */
+static TSync_t LSM6DSL_Clock;
+static uint32_t LSM6DSL_ClockLast = 0;
+static uint64_t LSM6DSL_ClockTicks = 0;
+
+/* Capture time of the first and last sample of the last read */
+static uint64_t LSM6DSL_BatchFirst = 0;
+static uint64_t LSM6DSL_BatchLast = 0;
+static uint16_t LSM6DSL_BatchCount = 0;
+
+/* Copy of CTRL1_XL..CTRL10_C, read once in LSM6DSL_myInit: updates are write-only */
+static uint8_t LSM6DSL_Ctrl[REGMAP_COUNT(LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL10_C)];
+
+/* Free-fall thresholds of FF_THS[2:0] in mg */
+static const uint16_t LSM6DSL_FreeFallMg[] = { 156, 219, 250, 312, 344, 406, 469, 500 };
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
@@ -52,6 +98,77 @@ static uint8_t LSM6DSL_IO_Read(uint8_t Addr, uint8_t Reg);
  */
 static uint16_t LSM6DSL_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length);
 
+/**
+ * @brief  Writes a register of the board device (REGMAP_UPDATE).
+ * @param  Reg: Reg address
+ * @param  Value: Data to be written
+ */
+static void LSM6DSL_WriteReg(uint8_t Reg, uint8_t Value);
+
+/**
+ * @brief  Accelerometer sensitivity for the FS_XL bits of CTRL1_XL.
+ * @param  ctrl: CTRL1_XL value
+ * @retval Sensitivity in ug/LSB
+ */
+static int32_t LSM6DSL_AccSensitivity(uint8_t ctrl);
+
+/**
+ * @brief  Gyroscope sensitivity for the FS_G bits of CTRL2_G.
+ * @param  ctrl: CTRL2_G value
+ * @retval Sensitivity in 0.01 mdps/LSB
+ */
+static int32_t LSM6DSL_GyroSensitivity(uint8_t ctrl);
+
+/**
+ * @brief  Reads the three 16-bit outputs starting at Reg.
+ * @param  Reg: OUTX_L register of the sensor
+ * @param  raw: Raw X, Y, Z
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef LSM6DSL_ReadRaw(uint8_t Reg, int32_t *raw);
+
+/**
+ * @brief  Conversion parameters of a channel with the current sensitivity.
+ * @param  ch: LSM6DSL_CH_GYRO or LSM6DSL_CH_ACCELERO
+ * @retval Block conversion parameters
+ */
+static const ImuConv_t *LSM6DSL_GetConv(uint8_t ch);
+
+/**
+ * @brief  Writes a register of the embedded functions bank.
+ * @param  Reg: Register address inside the bank
+ * @param  Value: Data to be written
+ */
+static void LSM6DSL_EmbWrite(uint8_t Reg, uint8_t Value);
+
+/**
+ * @brief  Read-modify-write of a register.
+ * @param  Reg: Register address
+ * @param  mask: Bits to change
+ * @param  value: New value of the bits
+ */
+static void LSM6DSL_Update(uint8_t Reg, uint8_t mask, uint8_t value);
+
+/**
+ * @brief  Reads the timestamp registers between two Timebase_Us reads and
+ *         adds the pair to the chip clock line.
+ * @retval HAL status
+ */
+static HAL_StatusTypeDef LSM6DSL_ClockSample(void);
+
+/**
+ * @brief  Capture time of a FIFO timestamp older than the last LSM6DSL_ClockSample.
+ * @param  ts: 24-bit timestamp
+ * @retval Time in Timebase_Us
+ */
+static uint64_t LSM6DSL_ClockToUs(uint32_t ts);
+
+/**
+ * @brief  FIFO_CTRL5 for continuous mode at the accelerometer ODR.
+ * @retval Register value
+ */
+static uint8_t LSM6DSL_FifoCtrl5(void);
+
 //==============================================================================
 // PRIVATE SOURCE CODE
 //==============================================================================
@@ -62,6 +179,10 @@ static void LSM6DSL_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
 
 	status = HAL_I2C_Mem_Write(pI2C_LSM6DSL, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, (uint8_t*) &Value, 1, 1000);
 
+	/* Device address, register, data */
+	LSM6DSL_BusTransfers++;
+	LSM6DSL_BusBytes += 3;
+
 	/* Check the communication status */
 	if (status != HAL_OK)
 	{
@@ -77,6 +198,10 @@ static uint8_t LSM6DSL_IO_Read(uint8_t Addr, uint8_t Reg)
 
 	status = HAL_I2C_Mem_Read(pI2C_LSM6DSL, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, (uint8_t*) &read_value, 1, 1000);
 
+	/* Device address, register, device address again, data */
+	LSM6DSL_BusTransfers++;
+	LSM6DSL_BusBytes += 4;
+
 	/* Check the communication status */
 	if (status != HAL_OK)
 	{
@@ -93,6 +218,9 @@ static uint16_t LSM6DSL_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buff
 
 	status = HAL_I2C_Mem_Read(pI2C_LSM6DSL, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, Buffer, Length, 1000);
 
+	LSM6DSL_BusTransfers++;
+	LSM6DSL_BusBytes += 3 + Length;
+
 	/* Check the communication status */
 	if (status != HAL_OK)
 	{
@@ -103,6 +231,125 @@ static uint16_t LSM6DSL_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buff
 	return status;
 }
 
+static void LSM6DSL_WriteReg(uint8_t Reg, uint8_t Value)
+{
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, Reg, Value);
+}
+
+static int32_t LSM6DSL_AccSensitivity(uint8_t ctrl)
+{
+	switch (ctrl & 0x0C)
+	{
+	case LSM6DSL_ACC_FULLSCALE_4G:
+		return LSM6DSL_ACC_SENSITIVITY_4G_UG;
+
+	case LSM6DSL_ACC_FULLSCALE_8G:
+		return LSM6DSL_ACC_SENSITIVITY_8G_UG;
+
+	case LSM6DSL_ACC_FULLSCALE_16G:
+		return LSM6DSL_ACC_SENSITIVITY_16G_UG;
+
+	default:
+		return LSM6DSL_ACC_SENSITIVITY_2G_UG;
+	}
+}
+
+static int32_t LSM6DSL_GyroSensitivity(uint8_t ctrl)
+{
+	switch (ctrl & 0x0C)
+	{
+	case LSM6DSL_GYRO_FS_500:
+		return LSM6DSL_GYRO_SENSITIVITY_500DPS_10UDPS;
+
+	case LSM6DSL_GYRO_FS_1000:
+		return LSM6DSL_GYRO_SENSITIVITY_1000DPS_10UDPS;
+
+	case LSM6DSL_GYRO_FS_2000:
+		return LSM6DSL_GYRO_SENSITIVITY_2000DPS_10UDPS;
+
+	default:
+		return LSM6DSL_GYRO_SENSITIVITY_245DPS_10UDPS;
+	}
+}
+
+static HAL_StatusTypeDef LSM6DSL_ReadRaw(uint8_t Reg, int32_t *raw)
+{
+	HAL_StatusTypeDef status;
+	uint8_t buffer[6];
+	uint8_t i;
+
+	status = (HAL_StatusTypeDef) LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, Reg, buffer, 6);
+
+	for (i = 0; i < 3; i++)
+	{
+		raw[i] = (int16_t) ((((uint16_t) buffer[2 * i + 1]) << 8) + (uint16_t) buffer[2 * i]);
+	}
+
+	return status;
+}
+
+static const ImuConv_t *LSM6DSL_GetConv(uint8_t ch)
+{
+	if (LSM6DSL_ConvReady == 0)
+	{
+		ImuConv_Init(&LSM6DSL_Conv[LSM6DSL_CH_GYRO], 0);
+		ImuConv_Init(&LSM6DSL_Conv[LSM6DSL_CH_ACCELERO], 0);
+		LSM6DSL_ConvReady = 1;
+	}
+
+	ImuConv_SetScale(&LSM6DSL_Conv[ch], (ch == LSM6DSL_CH_GYRO) ? LSM6DSL_GyroSens : LSM6DSL_AccSens);
+
+	return &LSM6DSL_Conv[ch];
+}
+
+static void LSM6DSL_EmbWrite(uint8_t Reg, uint8_t Value)
+{
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS, LSM6DSL_FUNC_CFG_EN);
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, Reg, Value);
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS, 0x00);
+}
+
+static void LSM6DSL_Update(uint8_t Reg, uint8_t mask, uint8_t value)
+{
+	uint8_t tmp;
+
+	tmp = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, Reg);
+	tmp &= ~mask;
+	tmp |= (value & mask);
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, Reg, tmp);
+}
+
+static HAL_StatusTypeDef LSM6DSL_ClockSample(void)
+{
+	uint8_t buffer[3];
+	uint64_t before, after;
+	uint32_t ts;
+
+	before = Timebase_Us();
+	if (LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_TIMESTAMP0_REG, buffer, 3) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+	after = Timebase_Us();
+
+	/* The counter wraps in 419 s: reads must come more often than that */
+	ts = ((uint32_t) buffer[2] << 16) | ((uint32_t) buffer[1] << 8) | buffer[0];
+	LSM6DSL_ClockTicks += (ts - LSM6DSL_ClockLast) & LSM6DSL_TIMESTAMP_MASK;
+	LSM6DSL_ClockLast = ts;
+
+	TSync_Add(&LSM6DSL_Clock, (int64_t) before, (int64_t) (LSM6DSL_ClockTicks * LSM6DSL_TIMESTAMP_US),
+			(int64_t) (LSM6DSL_ClockTicks * LSM6DSL_TIMESTAMP_US), (int64_t) after, 0, 0);
+
+	return HAL_OK;
+}
+
+static uint64_t LSM6DSL_ClockToUs(uint32_t ts)
+{
+	uint64_t ticks = LSM6DSL_ClockTicks - ((LSM6DSL_ClockLast - ts) & LSM6DSL_TIMESTAMP_MASK);
+
+	return (uint64_t) TSync_DevToRef(&LSM6DSL_Clock.est, (int64_t) (ticks * LSM6DSL_TIMESTAMP_US));
+}
+
 //==============================================================================
 // PUBLIC SOURCE CODE
 //==============================================================================
@@ -112,12 +359,20 @@ void LSM6DSL_attach(I2C_HandleTypeDef *hI2Handler)
 	pI2C_LSM6DSL = hI2Handler;
 }
 
+static uint8_t LSM6DSL_FifoCtrl5(void)
+{
+	return (uint8_t) (((LSM6DSL_AccOdr >> 4) << LSM6DSL_FIFO_ODR_SHIFT) | LSM6DSL_FIFO_MODE_CONTINUOUS);
+}
+
 void LSM6DSL_myInit(void)
 {
 	uint16_t ctrl = 0x0000;
 	GYRO_Init_t LSM6DSL_InitStructure;
 	ACCELERO_Init_t aLSM6DSL_InitStructure;
 
+	/* Copy of the control registers in one burst (IF_INC is set at reset) */
+	LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_Ctrl, sizeof(LSM6DSL_Ctrl));
+
 	/* Inicializa Giroscopio */
 	LSM6DSL_InitStructure.Power_Mode = 0;
 	LSM6DSL_InitStructure.Output_DataRate = LSM6DSL_ODR_52Hz;
@@ -154,237 +409,661 @@ void LSM6DSL_myInit(void)
 
 void LSM6DSL_AccInit(uint16_t InitStruct)
 {
-	uint8_t ctrl = 0x00;
-	uint8_t tmp;
-
-	/* Read CTRL1_XL */
-	tmp = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL1_XL);
+	uint8_t ctrl = (uint8_t) InitStruct;
+	uint8_t ctrl3 = (uint8_t) (InitStruct >> 8);
+
+	/* Write ACC MEMS CTRL1_XL register: FS and Data Rate */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL1_XL,
+			REGMAP_SETV(LSM6DSL_ODR_XL_FIELD, REGMAP_GET(LSM6DSL_ODR_XL_FIELD, ctrl)),
+			REGMAP_SETV(LSM6DSL_FS_XL_FIELD, REGMAP_GET(LSM6DSL_FS_XL_FIELD, ctrl)));
+
+	/* Keep the scale so that reads don't need to fetch CTRL1_XL again */
+	ctrl = REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL1_XL);
+	LSM6DSL_AccSens = LSM6DSL_AccSensitivity(ctrl);
+	LSM6DSL_AccOdr = ctrl & LSM6DSL_ODR_BITPOSITION;
+
+	/* CTRL3_C: BDU and Auto-increment (no write if the gyro already set them) */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL3_C,
+			REGMAP_SETV(LSM6DSL_BDU_FIELD, REGMAP_GET(LSM6DSL_BDU_FIELD, ctrl3)),
+			REGMAP_SETV(LSM6DSL_IF_INC_FIELD, REGMAP_GET(LSM6DSL_IF_INC_FIELD, ctrl3)));
+}
 
-	/* Write value to ACC MEMS CTRL1_XL register: FS and Data Rate */
-	ctrl = (uint8_t) InitStruct;
-	tmp &= ~(0xFC);
-	tmp |= ctrl;
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL1_XL, tmp);
+void LSM6DSL_AccDeInit(void)
+{
+	/* ODR = 0: power down */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL1_XL,
+			REGMAP_SET(LSM6DSL_ODR_XL_FIELD, 0));
+}
 
-	/* Read CTRL3_C */
-	tmp = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL3_C);
+uint8_t LSM6DSL_AccReadID(void)
+{
+	/* Read value at Who am I register address */
+	return (LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_WHO_AM_I_REG));
+}
 
-	/* Write value to ACC MEMS CTRL3_C register: BDU and Auto-increment */
-	ctrl = ((uint8_t) (InitStruct >> 8));
-	tmp &= ~(0x44);
-	tmp |= ctrl;
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL3_C, tmp);
+void LSM6DSL_AccLowPower(uint16_t status)
+{
+	/* Set or clear Low Power Mode in CTRL6_C */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL6_C,
+			REGMAP_SETV(LSM6DSL_LP_XL_FIELD, status != 0));
 }
 
-void LSM6DSL_AccDeInit(void)
+void LSM6DSL_AccReadXYZ(int32_t* pData)
 {
-	uint8_t ctrl = 0x00;
+	uint8_t i;
 
-	/* Read control register 1 value */
-	ctrl = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL1_XL);
+	if (LSM6DSL_AccSens == 0)
+	{
+		LSM6DSL_AccSens = LSM6DSL_AccSensitivity(REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL1_XL));
+	}
 
-	/* Clear ODR bits */
-	ctrl &= ~(LSM6DSL_ODR_BITPOSITION);
+	/* Read output register X, Y & Z acceleration */
+	LSM6DSL_ReadRaw(LSM6DSL_ACC_GYRO_OUTX_L_XL, pData);
 
-	/* Set Power down */
-	ctrl |= LSM6DSL_ODR_POWER_DOWN;
+	/* Obtain the ug value for the three axis */
+	for (i = 0; i < 3; i++)
+	{
+		pData[i] *= LSM6DSL_AccSens;
+	}
+}
 
-	/* write back control register */
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL1_XL, ctrl);
+void LSM6DSL_GyroInit(uint16_t InitStruct)
+{
+	uint8_t ctrl = (uint8_t) InitStruct;
+	uint8_t ctrl3 = (uint8_t) (InitStruct >> 8);
+
+	/* Write GYRO MEMS CTRL2_G register: FS and Data Rate */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL2_G,
+			REGMAP_SETV(LSM6DSL_ODR_G_FIELD, REGMAP_GET(LSM6DSL_ODR_G_FIELD, ctrl)),
+			REGMAP_SETV(LSM6DSL_FS_G_FIELD, REGMAP_GET(LSM6DSL_FS_G_FIELD, ctrl)));
+
+	/* Keep the scale so that reads don't need to fetch CTRL2_G again */
+	ctrl = REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL2_G);
+	LSM6DSL_GyroSens = LSM6DSL_GyroSensitivity(ctrl);
+	LSM6DSL_GyroOdr = ctrl & LSM6DSL_ODR_BITPOSITION;
+
+	/* CTRL3_C: BDU and Auto-increment */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL3_C,
+			REGMAP_SETV(LSM6DSL_BDU_FIELD, REGMAP_GET(LSM6DSL_BDU_FIELD, ctrl3)),
+			REGMAP_SETV(LSM6DSL_IF_INC_FIELD, REGMAP_GET(LSM6DSL_IF_INC_FIELD, ctrl3)));
 }
 
-uint8_t LSM6DSL_AccReadID(void)
+void LSM6DSL_GyroDeInit(void)
+{
+	/* ODR = 0: power down */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL2_G,
+			REGMAP_SET(LSM6DSL_ODR_G_FIELD, 0));
+}
+
+uint8_t LSM6DSL_GyroReadID(void)
 {
 	/* Read value at Who am I register address */
-	return (LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_WHO_AM_I_REG));
+	return LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_WHO_AM_I_REG);
 }
 
-void LSM6DSL_AccLowPower(uint16_t status)
+void LSM6DSL_GyroLowPower(uint16_t status)
 {
-	uint8_t ctrl = 0x00;
+	/* Set or clear Low Power Mode in CTRL7_G */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL7_G,
+			REGMAP_SETV(LSM6DSL_LP_G_FIELD, status != 0));
+}
 
-	/* Read CTRL6_C value */
-	ctrl = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL6_C);
+void LSM6DSL_GyroReadXYZAngRate(int32_t *pData)
+{
+	uint8_t i;
 
-	/* Clear Low Power Mode bit */
-	ctrl &= ~(0x10);
+	if (LSM6DSL_GyroSens == 0)
+	{
+		LSM6DSL_GyroSens = LSM6DSL_GyroSensitivity(REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL2_G));
+	}
 
-	/* Set Low Power Mode */
-	if (status)
+	/* Read output register X, Y & Z angular rate */
+	LSM6DSL_ReadRaw(LSM6DSL_ACC_GYRO_OUTX_L_G, pData);
+
+	/* Obtain the 0.01 mdps value for the three axis */
+	for (i = 0; i < 3; i++)
 	{
-		ctrl |= LSM6DSL_ACC_GYRO_LP_XL_ENABLED;
+		pData[i] *= LSM6DSL_GyroSens;
 	}
-	else
+}
+
+uint32_t LSM6DSL_AccGetOdr(void)
+{
+	static const uint32_t odr_mhz[] = { 0, 12500, 26000, 52000, 104000, 208000, 416000, 833000,
+			1660000, 3330000, 6660000, 1600, 0, 0, 0, 0 };
+
+	/* Only the driver writes CTRL1_XL: its copy is current */
+	return odr_mhz[REGMAP_GET(LSM6DSL_ODR_XL_FIELD, REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL1_XL))];
+}
+
+uint32_t LSM6DSL_GyroGetOdr(void)
+{
+	static const uint32_t odr_mhz[] = { 0, 12500, 26000, 52000, 104000, 208000, 416000, 833000,
+			1660000, 3330000, 6660000, 0, 0, 0, 0, 0 };
+
+	/* Only the driver writes CTRL2_G: its copy is current */
+	return odr_mhz[REGMAP_GET(LSM6DSL_ODR_G_FIELD, REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL2_G))];
+}
+
+HAL_StatusTypeDef LSM6DSL_MotionConfig(const LSM6DSL_MotionConfig_t *cfg)
+{
+	uint32_t fs_mg, ths;
+	uint8_t ff = 0;
+
+	if ((cfg == NULL) || (cfg->WakeUp_Duration > 3) || (cfg->FreeFall_Duration > 63) || (cfg->SignMotion_Steps == 0))
+	{
+		return HAL_ERROR;
+	}
+
+	if (LSM6DSL_AccSens == 0)
+	{
+		LSM6DSL_AccSens = LSM6DSL_AccSensitivity(REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL1_XL));
+	}
+
+	/* WK_THS weight is full scale / 64: 61 ug/LSB is 2 g */
+	fs_mg = (uint32_t) LSM6DSL_AccSens * 2000UL / LSM6DSL_ACC_SENSITIVITY_2G_UG;
+	ths = ((uint32_t) cfg->WakeUp_Threshold * 64UL + fs_mg / 2) / fs_mg;
+	ths = (ths < 1) ? 1 : ((ths > 63) ? 63 : ths);
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_WAKE_UP_THS, 0x3F, (uint8_t) ths);
+
+	/* Smallest free-fall threshold that is not below the request */
+	while ((ff < 7) && (LSM6DSL_FreeFallMg[ff] < cfg->FreeFall_Threshold))
+	{
+		ff++;
+	}
+
+	/* WAKE_DUR[1:0] and FF_DUR5 in WAKE_UP_DUR, FF_DUR[4:0] and FF_THS in FREE_FALL */
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_WAKE_UP_DUR, 0xE0,
+			(uint8_t) ((cfg->WakeUp_Duration << 5) | ((cfg->FreeFall_Duration & 0x20) << 2)));
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FREE_FALL,
+			(uint8_t) (((cfg->FreeFall_Duration & 0x1F) << 3) | ff));
+
+	LSM6DSL_EmbWrite(LSM6DSL_ACC_GYRO_SM_STEP_THS, cfg->SignMotion_Steps);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef LSM6DSL_MotionRoute(uint8_t int1, uint8_t int2)
+{
+	uint8_t all = int1 | int2;
+	uint8_t md1 = 0, md2 = 0, int1_ctrl = 0;
+
+	if ((int2 & LSM6DSL_MOTION_INT1_ONLY) || (all & ~LSM6DSL_MOTION_ALL))
 	{
-		ctrl |= LSM6DSL_ACC_GYRO_LP_XL_DISABLED;
+		return HAL_ERROR;
 	}
 
-	/* write back control register */
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL6_C, ctrl);
+	md1 |= (int1 & LSM6DSL_MOTION_WAKE_UP) ? LSM6DSL_MD_CFG_WU : 0;
+	md1 |= (int1 & LSM6DSL_MOTION_FREE_FALL) ? LSM6DSL_MD_CFG_FF : 0;
+	md1 |= (int1 & LSM6DSL_MOTION_TILT) ? LSM6DSL_MD_CFG_TILT : 0;
+	md2 |= (int2 & LSM6DSL_MOTION_WAKE_UP) ? LSM6DSL_MD_CFG_WU : 0;
+	md2 |= (int2 & LSM6DSL_MOTION_FREE_FALL) ? LSM6DSL_MD_CFG_FF : 0;
+	md2 |= (int2 & LSM6DSL_MOTION_TILT) ? LSM6DSL_MD_CFG_TILT : 0;
+	int1_ctrl |= (int1 & LSM6DSL_MOTION_SIGN_MOTION) ? LSM6DSL_INT1_SIGN_MOT : 0;
+	int1_ctrl |= (int1 & LSM6DSL_MOTION_STEP) ? LSM6DSL_INT1_STEP_DETECTOR : 0;
+
+	/* Engines first, then the routes, so no stale event reaches the pins */
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL10_C,
+			REGMAP_SETV(LSM6DSL_FUNC_EN_FIELD, (all & (LSM6DSL_MOTION_TILT | LSM6DSL_MOTION_SIGN_MOTION | LSM6DSL_MOTION_STEP)) != 0),
+			REGMAP_SETV(LSM6DSL_TILT_EN_FIELD, (all & LSM6DSL_MOTION_TILT) != 0),
+			REGMAP_SETV(LSM6DSL_SIGN_MOTION_EN_FIELD, (all & LSM6DSL_MOTION_SIGN_MOTION) != 0),
+			REGMAP_SETV(LSM6DSL_PEDO_EN_FIELD, (all & LSM6DSL_MOTION_STEP) != 0));
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_TAP_CFG1, LSM6DSL_TAP_CFG_INTERRUPTS_ENABLE | LSM6DSL_TAP_CFG_LIR,
+			(all & (LSM6DSL_MOTION_WAKE_UP | LSM6DSL_MOTION_FREE_FALL)) ?
+					(LSM6DSL_TAP_CFG_INTERRUPTS_ENABLE | LSM6DSL_TAP_CFG_LIR) : 0);
+
+	LSM6DSL_MotionSource();
+
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_MD1_CFG, LSM6DSL_MD_CFG_WU | LSM6DSL_MD_CFG_FF | LSM6DSL_MD_CFG_TILT, md1);
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_MD2_CFG, LSM6DSL_MD_CFG_WU | LSM6DSL_MD_CFG_FF | LSM6DSL_MD_CFG_TILT, md2);
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_INT1_CTRL, LSM6DSL_INT1_SIGN_MOT | LSM6DSL_INT1_STEP_DETECTOR, int1_ctrl);
+
+	return HAL_OK;
 }
 
-void LSM6DSL_AccReadXYZ(int16_t* pData)
+uint8_t LSM6DSL_MotionSource(void)
 {
-	int16_t pnRawData[3];
-	uint8_t ctrlx = 0;
-	uint8_t buffer[6];
-	uint8_t i = 0;
-	float sensitivity = 0;
+	uint8_t wake, func;
+	uint8_t events = 0;
 
-	/* Read the acceleration control register content */
-	ctrlx = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL1_XL);
+	/* Reading WAKE_UP_SRC releases the latched wake-up/free-fall interrupt */
+	wake = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_WAKE_UP_SRC);
+	func = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FUNC_SRC);
 
-	/* Read output register X, Y & Z acceleration */
-	LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_OUTX_L_XL, buffer, 6);
+	events |= (wake & LSM6DSL_WAKE_UP_SRC_WU_IA) ? LSM6DSL_MOTION_WAKE_UP : 0;
+	events |= (wake & LSM6DSL_WAKE_UP_SRC_FF_IA) ? LSM6DSL_MOTION_FREE_FALL : 0;
+	events |= (func & LSM6DSL_FUNC_SRC_TILT_IA) ? LSM6DSL_MOTION_TILT : 0;
+	events |= (func & LSM6DSL_FUNC_SRC_SIGN_MOTION_IA) ? LSM6DSL_MOTION_SIGN_MOTION : 0;
+	events |= (func & LSM6DSL_FUNC_SRC_STEP_DETECTED) ? LSM6DSL_MOTION_STEP : 0;
 
-	for (i = 0; i < 3; i++)
+	return events;
+}
+
+uint16_t LSM6DSL_StepCount(void)
+{
+	uint8_t buffer[2];
+
+	LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_STEP_COUNTER_L, buffer, 2);
+
+	return (uint16_t) ((buffer[1] << 8) | buffer[0]);
+}
+
+void LSM6DSL_StepReset(void)
+{
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL10_C,
+			REGMAP_SET(LSM6DSL_PEDO_RST_STEP_FIELD, 1));
+	REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL10_C,
+			REGMAP_SET(LSM6DSL_PEDO_RST_STEP_FIELD, 0));
+}
+
+void LSM6DSL_FifoStart(void)
+{
+	/* Bypass empties the FIFO before the new configuration */
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, LSM6DSL_FIFO_MODE_BYPASS);
+	LSM6DSL_FifoStamped = LSM6DSL_FifoStampReq;
+	TSync_Init(&LSM6DSL_Clock, 0);
+
+	if (LSM6DSL_FifoStamped != 0)
 	{
-		pnRawData[i] = ((((uint16_t) buffer[2 * i + 1]) << 8) + (uint16_t) buffer[2 * i]);
+		LSM6DSL_Update(LSM6DSL_ACC_GYRO_WAKE_UP_DUR, LSM6DSL_WAKE_UP_DUR_TIMER_HR, LSM6DSL_WAKE_UP_DUR_TIMER_HR);
+		REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL10_C,
+				REGMAP_SET(LSM6DSL_TIMER_EN_FIELD, 1));
+
+		/* Every point of the line comes from the same read: a write would latch at another spot */
+		LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_TIMESTAMP2_REG, LSM6DSL_TIMESTAMP_RESET);
+		LSM6DSL_ClockLast = 0;
+		LSM6DSL_ClockTicks = 0;
+		LSM6DSL_ClockSample();
 	}
 
-	/* Normal mode */
-	/* Switch the sensitivity value set in the CRTL1_XL */
-	switch (ctrlx & 0x0C)
+	LSM6DSL_Update(LSM6DSL_ACC_GYRO_FIFO_CTRL2, LSM6DSL_FIFO_TIMER_PEDO_EN,
+			(LSM6DSL_FifoStamped != 0) ? LSM6DSL_FIFO_TIMER_PEDO_EN : 0);
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL3, LSM6DSL_FIFO_DEC_XL_NONE);
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL4,
+			(LSM6DSL_FifoStamped != 0) ? LSM6DSL_FIFO_DEC_DS4_NONE : 0x00);
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, LSM6DSL_FifoCtrl5());
+
+	LSM6DSL_FifoSamples = 0;
+	LSM6DSL_FifoOverruns = 0;
+	LSM6DSL_BatchCount = 0;
+	LSM6DSL_FifoRunning = 1;
+}
+
+void LSM6DSL_FifoStop(void)
+{
+	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, LSM6DSL_FIFO_MODE_BYPASS);
+	LSM6DSL_FifoRunning = 0;
+}
+
+uint16_t LSM6DSL_FifoRead(int32_t *raw, uint16_t max)
+{
+	return LSM6DSL_FifoReadStamped(raw, NULL, max);
+}
+
+uint16_t LSM6DSL_FifoReadStamped(int32_t *raw, uint64_t *stamp, uint16_t max)
+{
+	uint8_t buffer[16 * 6];
+	uint8_t status[4];
+	uint16_t words, pattern, count, n, done, i, k;
+	uint16_t size, chunk;
+	uint32_t odr_mhz, period_us = 0;
+	uint64_t now, when = 0;
+	const uint8_t *sample;
+
+	LSM6DSL_BatchCount = 0;
+
+	if (LSM6DSL_FifoRunning == 0)
 	{
-	case LSM6DSL_ACC_FULLSCALE_2G:
-		sensitivity = LSM6DSL_ACC_SENSITIVITY_2G;
-		break;
+		return 0;
+	}
 
-	case LSM6DSL_ACC_FULLSCALE_4G:
-		sensitivity = LSM6DSL_ACC_SENSITIVITY_4G;
-		break;
+	/* Accelerometer data set, followed by the timestamp data set when stored */
+	size = (LSM6DSL_FifoStamped != 0) ? 12 : 6;
+	chunk = sizeof(buffer) / size;
 
-	case LSM6DSL_ACC_FULLSCALE_8G:
-		sensitivity = LSM6DSL_ACC_SENSITIVITY_8G;
-		break;
+	/* DIFF_FIFO (unread words) and FIFO_PATTERN (next word) in one read */
+	if (LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_STATUS1, status, 4) != HAL_OK)
+	{
+		return 0;
+	}
 
-	case LSM6DSL_ACC_FULLSCALE_16G:
-		sensitivity = LSM6DSL_ACC_SENSITIVITY_16G;
-		break;
+	if (status[1] & LSM6DSL_FIFO_STATUS2_OVER_RUN)
+	{
+		LSM6DSL_FifoOverruns++;
 	}
 
-	/* Obtain the mg value for the three axis */
-	for (i = 0; i < 3; i++)
+	if (status[1] & LSM6DSL_FIFO_STATUS2_EMPTY)
+	{
+		return 0;
+	}
+
+	/* Every sample counted above is older than this point */
+	now = Timebase_Us();
+	if (LSM6DSL_FifoStamped != 0)
+	{
+		LSM6DSL_ClockSample();
+	}
+
+	words = (uint16_t) (((status[1] & LSM6DSL_FIFO_STATUS2_DIFF_MASK) << 8) | status[0]);
+	pattern = (uint16_t) (((status[3] & 0x03) << 8) | status[2]);
+
+	/* The pattern is X, Y, Z (and the three timestamp words); realign on X */
+	while (((pattern % (size / 2)) != 0) && (words > 0))
 	{
-		pData[i] = (int16_t) (pnRawData[i] * sensitivity);
+		LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L, buffer, 2);
+		pattern++;
+		words--;
 	}
+
+	count = words / (size / 2);
+	count = (count > max) ? max : count;
+
+	/* Without the chip timestamp the newest sample is taken as captured now */
+	odr_mhz = LSM6DSL_AccGetOdr();
+	if (odr_mhz != 0)
+	{
+		period_us = (uint32_t) (1000000000ULL / odr_mhz);
+	}
+
+	/* With IF_INC the address rolls back from FIFO_DATA_OUT_H to _L */
+	for (done = 0; done < count; done += n)
+	{
+		n = ((count - done) > chunk) ? chunk : (count - done);
+
+		if (LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_DATA_OUT_L, buffer, n * size) != HAL_OK)
+		{
+			break;
+		}
+
+		for (i = 0; i < n; i++)
+		{
+			sample = &buffer[i * size];
+
+			for (k = 0; k < 3; k++)
+			{
+				raw[3 * (done + i) + k] = (int16_t) ((((uint16_t) sample[2 * k + 1]) << 8) + (uint16_t) sample[2 * k]);
+			}
+
+			/* Timestamp data set: TS[15:8], TS[23:16], unused, TS[7:0], step counter */
+			if (LSM6DSL_FifoStamped != 0)
+			{
+				when = LSM6DSL_ClockToUs(((uint32_t) sample[7] << 16) | ((uint32_t) sample[6] << 8) | sample[9]);
+			}
+			else
+			{
+				when = now - (uint64_t) (count - 1 - done - i) * period_us;
+			}
+
+			if (stamp != NULL)
+			{
+				stamp[done + i] = when;
+			}
+
+			if ((done + i) == 0)
+			{
+				LSM6DSL_BatchFirst = when;
+			}
+		}
+	}
+
+	LSM6DSL_FifoSamples += done;
+	LSM6DSL_BatchLast = when;
+	LSM6DSL_BatchCount = done;
+
+	return done;
 }
 
-void LSM6DSL_GyroInit(uint16_t InitStruct)
+void LSM6DSL_FifoSetTimestamp(uint8_t enable)
 {
-	uint8_t ctrl = 0x00;
-	uint8_t tmp;
+	LSM6DSL_FifoStampReq = (enable != 0) ? 1 : 0;
+}
 
-	/* Read CTRL2_G */
-	tmp = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW,
-			LSM6DSL_ACC_GYRO_CTRL2_G);
+uint16_t LSM6DSL_FifoGetBatchStamps(uint64_t *first, uint64_t *last)
+{
+	*first = LSM6DSL_BatchFirst;
+	*last = LSM6DSL_BatchLast;
 
-	/* Write value to GYRO MEMS CTRL2_G register: FS and Data Rate */
-	ctrl = (uint8_t) InitStruct;
-	tmp &= ~(0xFC);
-	tmp |= ctrl;
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL2_G, tmp);
+	return LSM6DSL_BatchCount;
+}
 
-	/* Read CTRL3_C */
-	tmp = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL3_C);
+void LSM6DSL_FifoGetClock(TSyncEstimate_t *est)
+{
+	taskENTER_CRITICAL();
+	*est = LSM6DSL_Clock.est;
+	taskEXIT_CRITICAL();
+}
 
-	/* Write value to GYRO MEMS CTRL3_C register: BDU and Auto-increment */
-	ctrl = ((uint8_t) (InitStruct >> 8));
-	tmp &= ~(0x44);
-	tmp |= ctrl;
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL3_C, tmp);
+void LSM6DSL_FifoGetStats(uint32_t *samples, uint32_t *overruns)
+{
+	taskENTER_CRITICAL();
+	*samples = LSM6DSL_FifoSamples;
+	*overruns = LSM6DSL_FifoOverruns;
+	taskEXIT_CRITICAL();
 }
 
-void LSM6DSL_GyroDeInit(void)
+void LSM6DSL_GetBusStats(uint32_t *transfers, uint32_t *bytes)
 {
-	uint8_t ctrl = 0x00;
+	taskENTER_CRITICAL();
+	*transfers = LSM6DSL_BusTransfers;
+	*bytes = LSM6DSL_BusBytes;
+	taskEXIT_CRITICAL();
+}
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+static const uint32_t LSM6DSL_Odrs[] = { 12500, 26000, 52000, 104000, 208000, 416000, 833000, 1660000, 3330000, 6660000 };
 
-	/* Read control register 1 value */
-	ctrl = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL2_G);
+static const uint32_t LSM6DSL_GyroRanges[] = { 245, 500, 1000, 2000 };
+static const uint8_t LSM6DSL_GyroFs[] = { LSM6DSL_GYRO_FS_245, LSM6DSL_GYRO_FS_500, LSM6DSL_GYRO_FS_1000, LSM6DSL_GYRO_FS_2000 };
 
-	/* Clear ODR bits */
-	ctrl &= ~(LSM6DSL_ODR_BITPOSITION);
+static const uint32_t LSM6DSL_AccRanges[] = { 2, 4, 8, 16 };
+static const uint8_t LSM6DSL_AccFs[] = { LSM6DSL_ACC_FULLSCALE_2G, LSM6DSL_ACC_FULLSCALE_4G, LSM6DSL_ACC_FULLSCALE_8G, LSM6DSL_ACC_FULLSCALE_16G };
 
-	/* Set Power down */
-	ctrl |= LSM6DSL_ODR_POWER_DOWN;
+static const SensorChannelDesc_t LSM6DSL_Channels[] =
+{
+	{ "gyro", SENSOR_TYPE_GYRO, 3, "mdps", 100, LSM6DSL_Odrs, 10, LSM6DSL_GyroRanges, 4 },
+	{ "accelero", SENSOR_TYPE_ACCELERO, 3, "mg", 1000, LSM6DSL_Odrs, 10, LSM6DSL_AccRanges, 4 },
+};
 
-	/* write back control register */
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL2_G, ctrl);
+/**
+ * @brief  Copy of the control register of a channel (CTRL2_G or CTRL1_XL).
+ */
+static uint8_t LSM6DSL_DrvCtrl(uint8_t ch)
+{
+	return (ch == LSM6DSL_CH_GYRO) ? REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL2_G) :
+			REGMAP_AT(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_ACC_GYRO_CTRL1_XL);
 }
 
-uint8_t LSM6DSL_GyroReadID(void)
+/**
+ * @brief  Writes the ODR code (LSM6DSL_ODR_xxx) of a channel.
+ */
+static void LSM6DSL_DrvWriteOdr(uint8_t ch, uint8_t odr)
 {
-	/* Read value at Who am I register address */
-	return LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_WHO_AM_I_REG);
+	if (ch == LSM6DSL_CH_GYRO)
+	{
+		REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL2_G,
+				REGMAP_SETV(LSM6DSL_ODR_G_FIELD, REGMAP_GET(LSM6DSL_ODR_G_FIELD, odr)));
+	}
+	else
+	{
+		REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL1_XL,
+				REGMAP_SETV(LSM6DSL_ODR_XL_FIELD, REGMAP_GET(LSM6DSL_ODR_XL_FIELD, odr)));
+	}
 }
 
-void LSM6DSL_GyroLowPower(uint16_t status)
+static HAL_StatusTypeDef LSM6DSL_DrvProbe(void)
+{
+	return (LSM6DSL_AccReadID() == LSM6DSL_ACC_GYRO_WHO_AM_I) ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef LSM6DSL_DrvInit(void)
 {
-	uint8_t ctrl = 0x00;
+	LSM6DSL_myInit();
+	LSM6DSL_PowerMask = (1 << LSM6DSL_CH_GYRO) | (1 << LSM6DSL_CH_ACCELERO);
 
-	/* Read CTRL7_G value */
-	ctrl = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL7_G);
+	return HAL_OK;
+}
 
-	/* Clear Low Power Mode bit */
-	ctrl &= ~(0x80);
+static HAL_StatusTypeDef LSM6DSL_DrvSetOdr(uint8_t ch, uint32_t odr_mhz)
+{
+	/* ODR codes 1..10 follow LSM6DSL_Odrs */
+	uint8_t odr = (uint8_t) ((SensorDrv_OdrIndex(&LSM6DSL_Channels[ch], odr_mhz) + 1) << 4);
 
-	/* Set Low Power Mode */
-	if (status)
+	if (ch == LSM6DSL_CH_GYRO)
 	{
-		ctrl |= LSM6DSL_ACC_GYRO_LP_G_ENABLED;
+		LSM6DSL_GyroOdr = odr;
 	}
 	else
 	{
-		ctrl |= LSM6DSL_ACC_GYRO_LP_G_DISABLED;
+		LSM6DSL_AccOdr = odr;
+
+		/* The FIFO follows the accelerometer rate */
+		if (LSM6DSL_FifoRunning != 0)
+		{
+			LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_FIFO_CTRL5, LSM6DSL_FifoCtrl5());
+		}
+	}
+
+	/* A powered-down channel only keeps the new rate for the next start */
+	if (LSM6DSL_PowerMask & (1 << ch))
+	{
+		LSM6DSL_DrvWriteOdr(ch, odr);
 	}
 
-	/* write back control register */
-	LSM6DSL_IO_Write(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL7_G, ctrl);
+	return HAL_OK;
 }
 
-void LSM6DSL_GyroReadXYZAngRate(float *pfData)
+static uint32_t LSM6DSL_DrvGetOdr(uint8_t ch)
 {
-	int16_t pnRawData[3];
-	uint8_t ctrlg = 0;
-	uint8_t buffer[6];
-	uint8_t i = 0;
-	float sensitivity = 0;
+	return (ch == LSM6DSL_CH_GYRO) ? LSM6DSL_GyroGetOdr() : LSM6DSL_AccGetOdr();
+}
 
-	/* Read the gyro control register content */
-	ctrlg = LSM6DSL_IO_Read(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_CTRL2_G);
+static HAL_StatusTypeDef LSM6DSL_DrvSetRange(uint8_t ch, uint32_t range)
+{
+	uint8_t fs;
 
-	/* Read output register X, Y & Z acceleration */
-	LSM6DSL_IO_ReadMultiple(LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW, LSM6DSL_ACC_GYRO_OUTX_L_G, buffer, 6);
+	if (ch == LSM6DSL_CH_GYRO)
+	{
+		fs = LSM6DSL_GyroFs[SensorDrv_RangeIndex(&LSM6DSL_Channels[ch], range)];
+		LSM6DSL_GyroSens = LSM6DSL_GyroSensitivity(fs);
+		REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL2_G,
+				REGMAP_SETV(LSM6DSL_FS_G_FIELD, REGMAP_GET(LSM6DSL_FS_G_FIELD, fs)));
+	}
+	else
+	{
+		fs = LSM6DSL_AccFs[SensorDrv_RangeIndex(&LSM6DSL_Channels[ch], range)];
+		LSM6DSL_AccSens = LSM6DSL_AccSensitivity(fs);
+		REGMAP_UPDATE(LSM6DSL_Ctrl, LSM6DSL_ACC_GYRO_CTRL1_XL, LSM6DSL_WriteReg, LSM6DSL_ACC_GYRO_CTRL1_XL,
+				REGMAP_SETV(LSM6DSL_FS_XL_FIELD, REGMAP_GET(LSM6DSL_FS_XL_FIELD, fs)));
+	}
 
-	for (i = 0; i < 3; i++)
+	return HAL_OK;
+}
+
+static uint32_t LSM6DSL_DrvGetRange(uint8_t ch)
+{
+	uint8_t fs = LSM6DSL_DrvCtrl(ch) & REGMAP_MASK(LSM6DSL_FS_XL_FIELD);
+	uint8_t i;
+
+	for (i = 0; i < 4; i++)
 	{
-		pnRawData[i] = ((((uint16_t) buffer[2 * i + 1]) << 8) + (uint16_t) buffer[2 * i]);
+		if ((ch == LSM6DSL_CH_GYRO) && (LSM6DSL_GyroFs[i] == fs))
+		{
+			return LSM6DSL_GyroRanges[i];
+		}
+
+		if ((ch == LSM6DSL_CH_ACCELERO) && (LSM6DSL_AccFs[i] == fs))
+		{
+			return LSM6DSL_AccRanges[i];
+		}
 	}
 
-	/* Normal mode */
-	/* Switch the sensitivity value set in the CRTL2_G */
-	switch (ctrlg & 0x0C)
+	return 0;
+}
+
+static HAL_StatusTypeDef LSM6DSL_DrvSetPower(uint8_t ch, SensorPower_e power)
+{
+	uint8_t odr = (ch == LSM6DSL_CH_GYRO) ? LSM6DSL_GyroOdr : LSM6DSL_AccOdr;
+
+	if (power == SENSOR_POWER_OFF)
 	{
-	case LSM6DSL_GYRO_FS_245:
-		sensitivity = LSM6DSL_GYRO_SENSITIVITY_245DPS;
-		break;
+		/* ODR = 0 is power-down; the last code is kept for the next start */
+		LSM6DSL_PowerMask &= ~(1 << ch);
+		LSM6DSL_DrvWriteOdr(ch, LSM6DSL_ODR_POWER_DOWN);
+		return HAL_OK;
+	}
 
-	case LSM6DSL_GYRO_FS_500:
-		sensitivity = LSM6DSL_GYRO_SENSITIVITY_500DPS;
-		break;
+	/* High-performance mode off selects the low-power/normal modes below 208 Hz */
+	if (ch == LSM6DSL_CH_GYRO)
+	{
+		LSM6DSL_GyroLowPower(power == SENSOR_POWER_LOW);
+	}
+	else
+	{
+		LSM6DSL_AccLowPower(power == SENSOR_POWER_LOW);
+	}
 
-	case LSM6DSL_GYRO_FS_1000:
-		sensitivity = LSM6DSL_GYRO_SENSITIVITY_1000DPS;
-		break;
+	LSM6DSL_PowerMask |= (1 << ch);
+	LSM6DSL_DrvWriteOdr(ch, odr);
 
-	case LSM6DSL_GYRO_FS_2000:
-		sensitivity = LSM6DSL_GYRO_SENSITIVITY_2000DPS;
-		break;
+	return HAL_OK;
+}
+
+static HAL_StatusTypeDef LSM6DSL_DrvReadRaw(uint8_t ch, int32_t *raw)
+{
+	return LSM6DSL_ReadRaw((ch == LSM6DSL_CH_GYRO) ? LSM6DSL_ACC_GYRO_OUTX_L_G : LSM6DSL_ACC_GYRO_OUTX_L_XL, raw);
+}
+
+static uint16_t LSM6DSL_DrvReadBatch(uint8_t ch, int32_t *raw, uint16_t max)
+{
+	/* Only the accelerometer goes through the FIFO */
+	if ((ch == LSM6DSL_CH_ACCELERO) && (LSM6DSL_FifoRunning != 0))
+	{
+		return LSM6DSL_FifoRead(raw, max);
 	}
 
-	/* Obtain the mg value for the three axis */
+	return (LSM6DSL_DrvReadRaw(ch, raw) == HAL_OK) ? 1 : 0;
+}
+
+static void LSM6DSL_DrvConvert(uint8_t ch, const int32_t *raw, int32_t *out, uint16_t count)
+{
+	int32_t sens;
+	uint8_t i;
+
+	if (count > 1)
+	{
+		/* FIFO blocks go through the block kernel */
+		ImuConv_Int32(LSM6DSL_GetConv(ch), raw, out, count);
+		return;
+	}
+
+	/* A single sample costs less as a plain multiply (identity, no bias) */
+	sens = (ch == LSM6DSL_CH_GYRO) ? LSM6DSL_GyroSens : LSM6DSL_AccSens;
 	for (i = 0; i < 3; i++)
 	{
-		pfData[i] = (float) (pnRawData[i] * sensitivity);
+		out[i] = raw[i] * sens;
 	}
 }
+
+const SensorDriver_t LSM6DSL_Driver =
+{
+	.name = "LSM6DSL",
+	.address = LSM6DSL_ACC_GYRO_I2C_ADDRESS_LOW,
+	.num_channels = 2,
+	.channels = LSM6DSL_Channels,
+	.shared_odr = false,
+	.probe = LSM6DSL_DrvProbe,
+	.init = LSM6DSL_DrvInit,
+	.set_odr = LSM6DSL_DrvSetOdr,
+	.get_odr = LSM6DSL_DrvGetOdr,
+	.set_range = LSM6DSL_DrvSetRange,
+	.get_range = LSM6DSL_DrvGetRange,
+	.set_power = LSM6DSL_DrvSetPower,
+	.read_raw = LSM6DSL_DrvReadRaw,
+	.read_batch = LSM6DSL_DrvReadBatch,
+	.convert = LSM6DSL_DrvConvert,
+	.one_shot = NULL,
+	.set_filter = NULL,
+};
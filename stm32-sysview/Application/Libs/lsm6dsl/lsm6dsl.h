@@ -20,6 +20,9 @@ extern "C" {
 //==============================================================================
 
 #include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+#include "regmap/regmap.h"
+#include "timesync/timesync.h"
 
 //==============================================================================
 // PUBLIC DEFINES
@@ -34,6 +37,10 @@ extern "C" {
 
 #define LSM6DSL_ACC_GYRO_WHO_AM_I           0x6A
 
+/* Channels exported through LSM6DSL_Driver */
+#define LSM6DSL_CH_GYRO                     0
+#define LSM6DSL_CH_ACCELERO                 1
+
 /************** Device Register  *******************/
 
 #define LSM6DSL_ACC_GYRO_FUNC_CFG_ACCESS    0x01
@@ -181,10 +188,10 @@ extern "C" {
 #define LSM6DSL_ACC_FULLSCALE_16G         ((uint8_t)0x04) /*!< �16 g */
 
 /* Accelero Full Scale Sensitivity */
-#define LSM6DSL_ACC_SENSITIVITY_2G     ((float)0.061f)  /*!< accelerometer sensitivity with 2 g full scale  [mgauss/LSB] */
-#define LSM6DSL_ACC_SENSITIVITY_4G     ((float)0.122f)  /*!< accelerometer sensitivity with 4 g full scale  [mgauss/LSB] */
-#define LSM6DSL_ACC_SENSITIVITY_8G     ((float)0.244f)  /*!< accelerometer sensitivity with 8 g full scale  [mgauss/LSB] */
-#define LSM6DSL_ACC_SENSITIVITY_16G    ((float)0.488f)  /*!< accelerometer sensitivity with 12 g full scale [mgauss/LSB] */
+#define LSM6DSL_ACC_SENSITIVITY_2G_UG     ((int32_t)61)   /*!< accelerometer sensitivity with 2 g full scale  [ug/LSB] */
+#define LSM6DSL_ACC_SENSITIVITY_4G_UG     ((int32_t)122)  /*!< accelerometer sensitivity with 4 g full scale  [ug/LSB] */
+#define LSM6DSL_ACC_SENSITIVITY_8G_UG     ((int32_t)244)  /*!< accelerometer sensitivity with 8 g full scale  [ug/LSB] */
+#define LSM6DSL_ACC_SENSITIVITY_16G_UG    ((int32_t)488)  /*!< accelerometer sensitivity with 16 g full scale [ug/LSB] */
 
 /* Accelero Power Mode selection */
 #define LSM6DSL_ACC_GYRO_LP_XL_DISABLED     ((uint8_t)0x00) /* LP disabled*/
@@ -211,10 +218,10 @@ extern "C" {
 #define LSM6DSL_GYRO_FS_2000           ((uint8_t)0x0C)
 
 /* Gyro Full Scale Sensitivity */ 
-#define LSM6DSL_GYRO_SENSITIVITY_245DPS            ((float)8.750f) /**< Sensitivity value for 245 dps full scale  [mdps/LSB] */ 
-#define LSM6DSL_GYRO_SENSITIVITY_500DPS            ((float)17.50f) /**< Sensitivity value for 500 dps full scale  [mdps/LSB] */ 
-#define LSM6DSL_GYRO_SENSITIVITY_1000DPS           ((float)35.00f) /**< Sensitivity value for 1000 dps full scale [mdps/LSB] */ 
-#define LSM6DSL_GYRO_SENSITIVITY_2000DPS           ((float)70.00f) /**< Sensitivity value for 2000 dps full scale [mdps/LSB] */ 
+#define LSM6DSL_GYRO_SENSITIVITY_245DPS_10UDPS     ((int32_t)875)  /**< Sensitivity value for 245 dps full scale  [0.01 mdps/LSB] */
+#define LSM6DSL_GYRO_SENSITIVITY_500DPS_10UDPS     ((int32_t)1750) /**< Sensitivity value for 500 dps full scale  [0.01 mdps/LSB] */
+#define LSM6DSL_GYRO_SENSITIVITY_1000DPS_10UDPS    ((int32_t)3500) /**< Sensitivity value for 1000 dps full scale [0.01 mdps/LSB] */
+#define LSM6DSL_GYRO_SENSITIVITY_2000DPS_10UDPS    ((int32_t)7000) /**< Sensitivity value for 2000 dps full scale [0.01 mdps/LSB] */
 
 /* Gyro Power Mode selection */
 #define LSM6DSL_ACC_GYRO_LP_G_DISABLED     ((uint8_t)0x00) /* LP disabled*/
@@ -228,6 +235,95 @@ extern "C" {
 #define LSM6DSL_ACC_GYRO_IF_INC_DISABLED    ((uint8_t)0x00)
 #define LSM6DSL_ACC_GYRO_IF_INC_ENABLED     ((uint8_t)0x04)
 
+/* Control register fields (regmap) */
+#define LSM6DSL_ODR_XL_FIELD                REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL1_XL, 4, 4)
+#define LSM6DSL_FS_XL_FIELD                 REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL1_XL, 2, 2)
+#define LSM6DSL_ODR_G_FIELD                 REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL2_G, 4, 4)
+#define LSM6DSL_FS_G_FIELD                  REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL2_G, 2, 2)
+#define LSM6DSL_BDU_FIELD                   REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL3_C, 6, 1)
+#define LSM6DSL_IF_INC_FIELD                REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL3_C, 2, 1)
+#define LSM6DSL_LP_XL_FIELD                 REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL6_C, 4, 1)
+#define LSM6DSL_LP_G_FIELD                  REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL7_G, 7, 1)
+#define LSM6DSL_TIMER_EN_FIELD              REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL10_C, 5, 1)
+#define LSM6DSL_PEDO_EN_FIELD               REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL10_C, 4, 1)
+#define LSM6DSL_TILT_EN_FIELD               REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL10_C, 3, 1)
+#define LSM6DSL_FUNC_EN_FIELD               REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL10_C, 2, 1)
+#define LSM6DSL_PEDO_RST_STEP_FIELD         REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL10_C, 1, 1)
+#define LSM6DSL_SIGN_MOTION_EN_FIELD        REGMAP_FIELD(LSM6DSL_ACC_GYRO_CTRL10_C, 0, 1)
+
+/* Embedded functions access (FUNC_CFG_ACCESS) */
+#define LSM6DSL_FUNC_CFG_EN                 ((uint8_t)0x80)
+
+/* CTRL10_C: embedded functions enable */
+#define LSM6DSL_CTRL10_SIGN_MOTION_EN       ((uint8_t)0x01)
+#define LSM6DSL_CTRL10_PEDO_RST_STEP        ((uint8_t)0x02)
+#define LSM6DSL_CTRL10_FUNC_EN              ((uint8_t)0x04)
+#define LSM6DSL_CTRL10_TILT_EN              ((uint8_t)0x08)
+#define LSM6DSL_CTRL10_PEDO_EN              ((uint8_t)0x10)
+
+/* TAP_CFG: basic interrupts (wake-up, free-fall) enable and latch */
+#define LSM6DSL_TAP_CFG_LIR                 ((uint8_t)0x01)
+#define LSM6DSL_TAP_CFG_INTERRUPTS_ENABLE   ((uint8_t)0x80)
+
+/* MD1_CFG / MD2_CFG routing */
+#define LSM6DSL_MD_CFG_TILT                 ((uint8_t)0x02)
+#define LSM6DSL_MD_CFG_FF                   ((uint8_t)0x10)
+#define LSM6DSL_MD_CFG_WU                   ((uint8_t)0x20)
+
+/* INT1_CTRL routing of the pedometer based functions (INT1 only) */
+#define LSM6DSL_INT1_SIGN_MOT               ((uint8_t)0x40)
+#define LSM6DSL_INT1_STEP_DETECTOR          ((uint8_t)0x80)
+
+/* WAKE_UP_SRC */
+#define LSM6DSL_WAKE_UP_SRC_WU_IA           ((uint8_t)0x08)
+#define LSM6DSL_WAKE_UP_SRC_FF_IA           ((uint8_t)0x20)
+
+/* FUNC_SRC1 */
+#define LSM6DSL_FUNC_SRC_STEP_DETECTED      ((uint8_t)0x10)
+#define LSM6DSL_FUNC_SRC_TILT_IA            ((uint8_t)0x20)
+#define LSM6DSL_FUNC_SRC_SIGN_MOTION_IA     ((uint8_t)0x40)
+
+/* Embedded motion functions (masks of LSM6DSL_MotionRoute / LSM6DSL_MotionSource) */
+#define LSM6DSL_MOTION_WAKE_UP              ((uint8_t)0x01)
+#define LSM6DSL_MOTION_FREE_FALL            ((uint8_t)0x02)
+#define LSM6DSL_MOTION_TILT                 ((uint8_t)0x04)
+#define LSM6DSL_MOTION_SIGN_MOTION          ((uint8_t)0x08)
+#define LSM6DSL_MOTION_STEP                 ((uint8_t)0x10)
+#define LSM6DSL_MOTION_ALL                  ((uint8_t)0x1F)
+
+/* Functions that can only be routed to INT1 */
+#define LSM6DSL_MOTION_INT1_ONLY            (LSM6DSL_MOTION_SIGN_MOTION | LSM6DSL_MOTION_STEP)
+
+/* FIFO_CTRL2: timestamp and step counter as the fourth FIFO data set */
+#define LSM6DSL_FIFO_TIMER_PEDO_EN          ((uint8_t)0x80)
+
+/* FIFO_CTRL3: accelerometer data set without decimation */
+#define LSM6DSL_FIFO_DEC_XL_NONE            ((uint8_t)0x01)
+
+/* FIFO_CTRL4: fourth data set without decimation */
+#define LSM6DSL_FIFO_DEC_DS4_NONE           ((uint8_t)0x08)
+
+/* FIFO_CTRL5: FIFO_MODE[2:0], ODR_FIFO[3:0] from bit 3 (same codes as CTRL1_XL) */
+#define LSM6DSL_FIFO_MODE_BYPASS            ((uint8_t)0x00)
+#define LSM6DSL_FIFO_MODE_CONTINUOUS        ((uint8_t)0x06)
+#define LSM6DSL_FIFO_ODR_SHIFT              3
+
+/* FIFO_STATUS2 */
+#define LSM6DSL_FIFO_STATUS2_DIFF_MASK      ((uint8_t)0x07)
+#define LSM6DSL_FIFO_STATUS2_EMPTY          ((uint8_t)0x10)
+#define LSM6DSL_FIFO_STATUS2_OVER_RUN       ((uint8_t)0x40)
+
+/* FIFO depth in XYZ accelerometer samples (4 kbyte) */
+#define LSM6DSL_FIFO_SAMPLES                682
+
+/* WAKE_UP_DUR: TIMER_HR, timestamp LSB of 25 us instead of 6.4 ms */
+#define LSM6DSL_WAKE_UP_DUR_TIMER_HR        ((uint8_t)0x10)
+
+/* Timestamp: 24-bit counter, 25 us per LSB (TIMER_HR), reset by writing 0xAA to TIMESTAMP2 */
+#define LSM6DSL_TIMESTAMP_US                25
+#define LSM6DSL_TIMESTAMP_MASK              0x00FFFFFFUL
+#define LSM6DSL_TIMESTAMP_RESET             ((uint8_t)0xAA)
+
 //==============================================================================
 // PUBLIC TYPEDEFS
 //==============================================================================
@@ -275,6 +371,16 @@ typedef struct
   uint8_t HighPassFilter_CutOff_Frequency;    /* High pass filter cut-off frequency */
 }GYRO_FilterConfig_t;
 
+/** @brief Thresholds of the embedded motion functions */
+typedef struct
+{
+  uint16_t WakeUp_Threshold;                  /* Slope threshold in mg (steps of full scale / 64) */
+  uint8_t WakeUp_Duration;                    /* Samples above threshold before the event, 0 to 3 */
+  uint16_t FreeFall_Threshold;                /* mg, rounded up to 156/219/250/312/344/406/469/500 */
+  uint8_t FreeFall_Duration;                  /* Samples below threshold before the event, 0 to 63 */
+  uint8_t SignMotion_Steps;                   /* Steps that make a significant motion, 1 to 255 */
+} LSM6DSL_MotionConfig_t;
+
 /*GYRO Interrupt struct */
 typedef struct
 {
@@ -318,9 +424,15 @@ void LSM6DSL_AccLowPower(uint16_t status);
 
 /**
  * @brief  Read X, Y & Z Acceleration values
- * @param  pData: Data out pointer
+ * @param  pData: Data out pointer, 3 values in ug
  */
-void LSM6DSL_AccReadXYZ(int16_t* pData);
+void LSM6DSL_AccReadXYZ(int32_t* pData);
+
+/**
+ * @brief  Read the accelerometer output data rate configured in CTRL1_XL.
+ * @retval ODR in mHz (0 when powered down)
+ */
+uint32_t LSM6DSL_AccGetOdr(void);
 
 //==============================================================================
 // Sensor Configuration Functions
@@ -351,12 +463,153 @@ void LSM6DSL_GyroLowPower(uint16_t status);
 
 /**
  * @brief  Calculate the LSM6DSL angular data.
- * @param  pfData: Data out pointer
+ * @param  pData: Data out pointer, 3 values in 0.01 mdps
+ */
+void LSM6DSL_GyroReadXYZAngRate(int32_t *pData);
+
+/**
+ * @brief  Read the gyroscope output data rate configured in CTRL2_G.
+ * @retval ODR in mHz (0 when powered down)
  */
-void LSM6DSL_GyroReadXYZAngRate(float *pfData);
+uint32_t LSM6DSL_GyroGetOdr(void);
 
 void LSM6DSL_myInit(void);
 
+//==============================================================================
+// Embedded Motion Functions
+//==============================================================================
+
+/*
+ * The wake-up, free-fall, tilt, significant motion and step detector engines
+ * run inside the LSM6DSL on the accelerometer data (ODR of at least 26 Hz
+ * for tilt, significant motion and step). On the B-L475E-IOT01A only INT1 is
+ * wired to the MCU (PD11, EXTI11). The functions below access the bus
+ * directly: call them between SensorDrv_Lock and SensorDrv_Unlock when the
+ * registry is running.
+ */
+
+/**
+ * @brief  Program the thresholds of the motion engines.
+ * @param  cfg: Thresholds, see LSM6DSL_MotionConfig_t
+ * @retval HAL_OK, HAL_ERROR on invalid parameters
+ */
+HAL_StatusTypeDef LSM6DSL_MotionConfig(const LSM6DSL_MotionConfig_t *cfg);
+
+/**
+ * @brief  Enable the engines and route their events to the interrupt pins.
+ *         Engines not present in either mask are disabled. Wake-up and
+ *         free-fall are latched until LSM6DSL_MotionSource is called.
+ * @param  int1: LSM6DSL_MOTION_* events on INT1
+ * @param  int2: LSM6DSL_MOTION_* events on INT2 (not LSM6DSL_MOTION_INT1_ONLY)
+ * @retval HAL_OK, HAL_ERROR on invalid routing
+ */
+HAL_StatusTypeDef LSM6DSL_MotionRoute(uint8_t int1, uint8_t int2);
+
+/**
+ * @brief  Read (and clear) the event sources.
+ * @retval LSM6DSL_MOTION_* events that fired since the last call
+ */
+uint8_t LSM6DSL_MotionSource(void);
+
+/**
+ * @brief  Read the pedometer step counter.
+ * @retval Steps since the last reset
+ */
+uint16_t LSM6DSL_StepCount(void);
+
+/**
+ * @brief  Reset the pedometer step counter.
+ */
+void LSM6DSL_StepReset(void);
+
+//==============================================================================
+// FIFO Functions
+//==============================================================================
+
+/*
+ * Accelerometer-only FIFO in continuous mode at the accelerometer ODR. While
+ * it runs the read_batch entry of the sensor interface drains it, so
+ * SensorDrv_ReadBatch returns every sample since the previous call. The
+ * functions below access the bus directly: call them between SensorDrv_Lock
+ * and SensorDrv_Unlock when the registry is running.
+ *
+ * Every read stamps its samples in Timebase_Us. With LSM6DSL_FifoSetTimestamp
+ * the chip stores its 24-bit timestamp after each sample and each read also
+ * samples the timestamp registers between two Timebase_Us reads: those pairs
+ * feed a TSync_t line (chip clock against the core clock), so the stamps
+ * carry the real capture time instead of the read time minus the ODR period.
+ */
+
+/**
+ * @brief  Empty the FIFO and start storing accelerometer samples.
+ */
+void LSM6DSL_FifoStart(void);
+
+/**
+ * @brief  Put the FIFO in bypass mode (samples are discarded).
+ */
+void LSM6DSL_FifoStop(void);
+
+/**
+ * @brief  Read up to max accelerometer samples from the FIFO, oldest first.
+ * @param  raw: Raw X, Y, Z of each sample (3 * max values)
+ * @param  max: Maximum number of samples
+ * @retval Samples read (0 when stopped or empty)
+ */
+uint16_t LSM6DSL_FifoRead(int32_t *raw, uint16_t max);
+
+/**
+ * @brief  Read up to max accelerometer samples with their capture time.
+ * @param  raw: Raw X, Y, Z of each sample (3 * max values)
+ * @param  stamp: Capture time of each sample in Timebase_Us (max values, may be NULL)
+ * @param  max: Maximum number of samples
+ * @retval Samples read (0 when stopped or empty)
+ */
+uint16_t LSM6DSL_FifoReadStamped(int32_t *raw, uint64_t *stamp, uint16_t max);
+
+/**
+ * @brief  Store the on-chip timestamp with each sample from the next LSM6DSL_FifoStart.
+ * @param  enable: 1 to store it, 0 to stamp from the read time and the ODR
+ */
+void LSM6DSL_FifoSetTimestamp(uint8_t enable);
+
+/**
+ * @brief  Capture time of the first and last sample of the last read.
+ * @param  first: Oldest sample in Timebase_Us
+ * @param  last: Newest sample in Timebase_Us
+ * @retval Samples of the last read
+ */
+uint16_t LSM6DSL_FifoGetBatchStamps(uint64_t *first, uint64_t *last);
+
+/**
+ * @brief  Line that maps the chip timestamp to Timebase_Us.
+ * @param  est: Fitted line (dev = chip, ref = Timebase_Us); not valid without timestamps
+ */
+void LSM6DSL_FifoGetClock(TSyncEstimate_t *est);
+
+/**
+ * @brief  FIFO counters since the last LSM6DSL_FifoStart.
+ * @param  samples: Samples read
+ * @param  overruns: Reads that found the FIFO overwritten
+ */
+void LSM6DSL_FifoGetStats(uint32_t *samples, uint32_t *overruns);
+
+/**
+ * @brief  Bus traffic of the driver since boot.
+ * @param  transfers: I2C transactions
+ * @param  bytes: Bytes on the bus (device and register addresses included)
+ */
+void LSM6DSL_GetBusStats(uint32_t *transfers, uint32_t *bytes);
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+/**
+ * @brief  LSM6DSL descriptor for the sensor registry (gyroscope and accelerometer).
+ */
+extern const SensorDriver_t LSM6DSL_Driver;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,431 @@
+/**
+ * @file    magcal.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Calibracao online de hard-iron e soft-iron do magnetometro
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "magcal.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Numero de incognitas do elipsoide geral */
+#define MAGCAL_N				9
+
+/** @brief Peso de cada amostra na media movel do residuo */
+#define MAGCAL_RESIDUAL_ALPHA	0.01f
+
+/** @brief Indice do elemento (i, j), i <= j, no triangulo superior compactado */
+#define MAGCAL_IDX(i, j)		(((i) * (2 * MAGCAL_N - (i) - 1)) / 2 + (j))
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Resolve A.x = b por Cholesky. A e destruida.
+ * @return false se A nao for positiva definida.
+ */
+static bool MagCal_Cholesky(double a[MAGCAL_N][MAGCAL_N], const double b[MAGCAL_N], double x[MAGCAL_N]);
+
+/**
+ * Autovalores e autovetores de uma matriz 3x3 simetrica (Jacobi).
+ * @param a Matriz de entrada, destruida.
+ * @param v Autovetores nas colunas.
+ * @param e Autovalores.
+ */
+static void MagCal_Eigen3(double a[3][3], double v[3][3], double e[3]);
+
+/** @brief Regiao da esfera de um vetor: face dominante x quadrante. */
+static uint8_t MagCal_Bin(const float u[3]);
+
+static uint8_t MagCal_PopCount(uint32_t x);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static bool MagCal_Cholesky(double a[MAGCAL_N][MAGCAL_N], const double b[MAGCAL_N], double x[MAGCAL_N])
+{
+	double sum;
+	int i, j, k;
+
+	for (i = 0; i < MAGCAL_N; i++)
+	{
+		for (j = 0; j <= i; j++)
+		{
+			sum = a[i][j];
+			for (k = 0; k < j; k++)
+			{
+				sum -= a[i][k] * a[j][k];
+			}
+
+			if (i == j)
+			{
+				if (sum <= 0.0)
+				{
+					return false;
+				}
+				a[i][i] = sqrt(sum);
+			}
+			else
+			{
+				a[i][j] = sum / a[j][j];
+			}
+		}
+	}
+
+	/* L.y = b */
+	for (i = 0; i < MAGCAL_N; i++)
+	{
+		sum = b[i];
+		for (k = 0; k < i; k++)
+		{
+			sum -= a[i][k] * x[k];
+		}
+		x[i] = sum / a[i][i];
+	}
+
+	/* L'.x = y */
+	for (i = MAGCAL_N - 1; i >= 0; i--)
+	{
+		sum = x[i];
+		for (k = i + 1; k < MAGCAL_N; k++)
+		{
+			sum -= a[k][i] * x[k];
+		}
+		x[i] = sum / a[i][i];
+	}
+
+	return true;
+}
+
+static void MagCal_Eigen3(double a[3][3], double v[3][3], double e[3])
+{
+	static const uint8_t pairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+	double theta, t, c, s, tmp_p, tmp_q;
+	uint8_t sweep, n, k, p, q;
+
+	memset(v, 0, sizeof(double) * 9);
+	v[0][0] = v[1][1] = v[2][2] = 1.0;
+
+	for (sweep = 0; sweep < 16; sweep++)
+	{
+		if ((fabs(a[0][1]) + fabs(a[0][2]) + fabs(a[1][2])) < 1e-15)
+		{
+			break;
+		}
+
+		for (n = 0; n < 3; n++)
+		{
+			p = pairs[n][0];
+			q = pairs[n][1];
+
+			if (a[p][q] == 0.0)
+			{
+				continue;
+			}
+
+			theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+			t = ((theta >= 0.0) ? 1.0 : -1.0) / (fabs(theta) + sqrt((theta * theta) + 1.0));
+			c = 1.0 / sqrt((t * t) + 1.0);
+			s = t * c;
+
+			for (k = 0; k < 3; k++)
+			{
+				tmp_p = a[k][p];
+				tmp_q = a[k][q];
+				a[k][p] = (c * tmp_p) - (s * tmp_q);
+				a[k][q] = (s * tmp_p) + (c * tmp_q);
+			}
+
+			for (k = 0; k < 3; k++)
+			{
+				tmp_p = a[p][k];
+				tmp_q = a[q][k];
+				a[p][k] = (c * tmp_p) - (s * tmp_q);
+				a[q][k] = (s * tmp_p) + (c * tmp_q);
+			}
+
+			for (k = 0; k < 3; k++)
+			{
+				tmp_p = v[k][p];
+				tmp_q = v[k][q];
+				v[k][p] = (c * tmp_p) - (s * tmp_q);
+				v[k][q] = (s * tmp_p) + (c * tmp_q);
+			}
+		}
+	}
+
+	e[0] = a[0][0];
+	e[1] = a[1][1];
+	e[2] = a[2][2];
+}
+
+static uint8_t MagCal_Bin(const float u[3])
+{
+	float ax = fabsf(u[0]), ay = fabsf(u[1]), az = fabsf(u[2]);
+	uint8_t face;
+	uint8_t quad;
+
+	/* Face do cubo atingida pelo vetor e sinal das outras duas componentes */
+	if ((ax >= ay) && (ax >= az))
+	{
+		face = (u[0] >= 0.0f) ? 0 : 1;
+		quad = ((u[1] >= 0.0f) ? 0 : 1) | ((u[2] >= 0.0f) ? 0 : 2);
+	}
+	else if (ay >= az)
+	{
+		face = (u[1] >= 0.0f) ? 2 : 3;
+		quad = ((u[0] >= 0.0f) ? 0 : 1) | ((u[2] >= 0.0f) ? 0 : 2);
+	}
+	else
+	{
+		face = (u[2] >= 0.0f) ? 4 : 5;
+		quad = ((u[0] >= 0.0f) ? 0 : 1) | ((u[1] >= 0.0f) ? 0 : 2);
+	}
+
+	return (face * 4) + quad;
+}
+
+static uint8_t MagCal_PopCount(uint32_t x)
+{
+	uint8_t n = 0;
+
+	while (x != 0)
+	{
+		x &= x - 1;
+		n++;
+	}
+
+	return n;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void MagCal_Init(MagCal_t *cal, float lambda)
+{
+	memset(cal, 0, sizeof(MagCal_t));
+
+	cal->lambda = ((lambda > 0.0f) && (lambda < 1.0f)) ? lambda : 1.0f;
+	cal->params.soft[0][0] = 1.0f;
+	cal->params.soft[1][1] = 1.0f;
+	cal->params.soft[2][2] = 1.0f;
+	cal->params.radius = 1.0f;
+
+	/* Residuo comeca alto: so converge depois de amostras suficientes */
+	cal->residual_ms = 1.0f;
+	cal->quality.residual = 1.0f;
+}
+
+void MagCal_AddSample(MagCal_t *cal, const float m[3])
+{
+	double d[MAGCAL_N];
+	float u[3], corr[3], r;
+	uint8_t i, j, idx;
+
+	d[0] = (double) m[0] * m[0];
+	d[1] = (double) m[1] * m[1];
+	d[2] = (double) m[2] * m[2];
+	d[3] = 2.0 * m[1] * m[2];
+	d[4] = 2.0 * m[0] * m[2];
+	d[5] = 2.0 * m[0] * m[1];
+	d[6] = 2.0 * m[0];
+	d[7] = 2.0 * m[1];
+	d[8] = 2.0 * m[2];
+
+	if (cal->lambda < 1.0f)
+	{
+		for (i = 0; i < 45; i++)
+		{
+			cal->dtd[i] *= cal->lambda;
+		}
+		for (i = 0; i < MAGCAL_N; i++)
+		{
+			cal->dt1[i] *= cal->lambda;
+		}
+	}
+
+	idx = 0;
+	for (i = 0; i < MAGCAL_N; i++)
+	{
+		for (j = i; j < MAGCAL_N; j++)
+		{
+			cal->dtd[idx++] += d[i] * d[j];
+		}
+		cal->dt1[i] += d[i];
+	}
+
+	cal->quality.samples++;
+
+	/* Cobertura medida em relacao ao centro atual */
+	for (i = 0; i < 3; i++)
+	{
+		u[i] = m[i] - cal->params.offset[i];
+	}
+	cal->bins |= 1UL << MagCal_Bin(u);
+	cal->quality.coverage = MagCal_PopCount(cal->bins);
+
+	if (cal->quality.valid)
+	{
+		MagCal_Apply(&cal->params, m, corr);
+		r = sqrtf((corr[0] * corr[0]) + (corr[1] * corr[1]) + (corr[2] * corr[2])) / cal->params.radius - 1.0f;
+		cal->residual_ms += MAGCAL_RESIDUAL_ALPHA * ((r * r) - cal->residual_ms);
+		cal->quality.residual = sqrtf(cal->residual_ms);
+	}
+}
+
+bool MagCal_Solve(MagCal_t *cal)
+{
+	double ata[MAGCAL_N][MAGCAL_N];
+	double v[MAGCAL_N];
+	double A[3][3], inv[3][3], vec[3][3], e[3];
+	double center[3], det, k, radius, sq[3];
+	float delta;
+	uint8_t i, j, n;
+
+	if (cal->quality.samples < MAGCAL_N)
+	{
+		return false;
+	}
+
+	for (i = 0; i < MAGCAL_N; i++)
+	{
+		for (j = i; j < MAGCAL_N; j++)
+		{
+			ata[i][j] = ata[j][i] = cal->dtd[MAGCAL_IDX(i, j)];
+		}
+	}
+
+	if (MagCal_Cholesky(ata, cal->dt1, v) == false)
+	{
+		return false;
+	}
+
+	A[0][0] = v[0]; A[0][1] = v[5]; A[0][2] = v[4];
+	A[1][0] = v[5]; A[1][1] = v[1]; A[1][2] = v[3];
+	A[2][0] = v[4]; A[2][1] = v[3]; A[2][2] = v[2];
+
+	/* Centro: A.c = -[p q r] */
+	inv[0][0] = (A[1][1] * A[2][2]) - (A[1][2] * A[2][1]);
+	inv[0][1] = (A[0][2] * A[2][1]) - (A[0][1] * A[2][2]);
+	inv[0][2] = (A[0][1] * A[1][2]) - (A[0][2] * A[1][1]);
+	inv[1][0] = (A[1][2] * A[2][0]) - (A[1][0] * A[2][2]);
+	inv[1][1] = (A[0][0] * A[2][2]) - (A[0][2] * A[2][0]);
+	inv[1][2] = (A[0][2] * A[1][0]) - (A[0][0] * A[1][2]);
+	inv[2][0] = (A[1][0] * A[2][1]) - (A[1][1] * A[2][0]);
+	inv[2][1] = (A[0][1] * A[2][0]) - (A[0][0] * A[2][1]);
+	inv[2][2] = (A[0][0] * A[1][1]) - (A[0][1] * A[1][0]);
+
+	det = (A[0][0] * inv[0][0]) + (A[0][1] * inv[1][0]) + (A[0][2] * inv[2][0]);
+	if (fabs(det) < 1e-30)
+	{
+		return false;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		center[i] = -((inv[i][0] * v[6]) + (inv[i][1] * v[7]) + (inv[i][2] * v[8])) / det;
+	}
+
+	/*
+	 * (x - c)' A (x - c) = 1 + c' A c. Se a origem estiver fora do elipsoide
+	 * (offset maior que o campo), A e k saem negativos e A / k continua valida.
+	 */
+	k = 1.0;
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			k += center[i] * A[i][j] * center[j];
+		}
+	}
+
+	if (fabs(k) < 1e-30)
+	{
+		return false;
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		for (j = 0; j < 3; j++)
+		{
+			A[i][j] /= k;
+		}
+	}
+
+	MagCal_Eigen3(A, vec, e);
+
+	if ((e[0] <= 0.0) || (e[1] <= 0.0) || (e[2] <= 0.0))
+	{
+		return false;
+	}
+
+	/* Raio medio = media geometrica dos semi-eixos 1/sqrt(e) */
+	radius = pow(e[0] * e[1] * e[2], -1.0 / 6.0);
+
+	for (n = 0; n < 3; n++)
+	{
+		sq[n] = sqrt(e[n]) * radius;
+	}
+
+	delta = 0.0f;
+	for (i = 0; i < 3; i++)
+	{
+		delta += fabsf((float) center[i] - cal->params.offset[i]);
+		cal->params.offset[i] = (float) center[i];
+
+		/* soft = radius * V.sqrt(E).V' */
+		for (j = 0; j < 3; j++)
+		{
+			cal->params.soft[i][j] = (float) ((vec[i][0] * sq[0] * vec[j][0]) +
+					(vec[i][1] * sq[1] * vec[j][1]) +
+					(vec[i][2] * sq[2] * vec[j][2]));
+		}
+	}
+	cal->params.radius = (float) radius;
+
+	cal->quality.delta = delta / cal->params.radius;
+	cal->quality.valid = true;
+	cal->quality.solves++;
+	cal->quality.converged = (cal->quality.coverage >= MAGCAL_MIN_BINS) &&
+			(cal->quality.delta < MAGCAL_MAX_DELTA) &&
+			(cal->quality.solves > 1) &&
+			(cal->quality.residual < MAGCAL_MAX_RESIDUAL);
+
+	return true;
+}
+
+void MagCal_Apply(const MagCalParams_t *params, const float in[3], float out[3])
+{
+	float u[3];
+	uint8_t i;
+
+	for (i = 0; i < 3; i++)
+	{
+		u[i] = in[i] - params->offset[i];
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		out[i] = (params->soft[i][0] * u[0]) + (params->soft[i][1] * u[1]) + (params->soft[i][2] * u[2]);
+	}
+}
+
+void MagCal_SetParams(MagCal_t *cal, const MagCalParams_t *params)
+{
+	cal->params = *params;
+	cal->quality.valid = true;
+}
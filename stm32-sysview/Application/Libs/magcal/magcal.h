@@ -0,0 +1,141 @@
+/**
+ * @file    magcal.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Calibracao online de hard-iron e soft-iron do magnetometro
+ * @details
+ * Ajusta um elipsoide geral aos pontos medidos por minimos quadrados:
+ *
+ *   a.x^2 + b.y^2 + c.z^2 + 2f.yz + 2g.xz + 2h.xy + 2p.x + 2q.y + 2r.z = 1
+ *
+ * Cada amostra so atualiza as somas das equacoes normais (9x9 simetrica),
+ * entao o custo e a memoria por amostra sao constantes. MagCal_Solve resolve
+ * o sistema, extrai o centro (hard-iron) e a matriz que transforma o
+ * elipsoide em uma esfera (soft-iron):
+ *
+ *   corrigido = soft * (medido - offset)
+ *
+ * O raio da esfera e a media geometrica dos semi-eixos, de modo que o
+ * modulo corrigido continua na unidade de entrada. Um fator de esquecimento
+ * opcional permite acompanhar mudancas lentas do campo da placa.
+ *
+ * A lib nao depende do HAL e pode ser compilada no PC.
+ */
+
+#ifndef _MAGCAL_H_
+#define _MAGCAL_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Numero de regioes da esfera usadas para medir a cobertura */
+#define MAGCAL_NUM_BINS				24
+
+/** @brief Cobertura minima (em regioes) para considerar o ajuste convergido */
+#define MAGCAL_MIN_BINS				18
+
+/** @brief Variacao maxima do offset entre solucoes, relativa ao raio */
+#define MAGCAL_MAX_DELTA			0.01f
+
+/** @brief Residuo RMS maximo, relativo ao raio */
+#define MAGCAL_MAX_RESIDUAL			0.05f
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Parametros de calibracao */
+typedef struct
+{
+	float offset[3];   /**< Centro do elipsoide (hard-iron) */
+	float soft[3][3];  /**< Matriz de correcao (soft-iron) */
+	float radius;      /**< Raio da esfera corrigida */
+} MagCalParams_t;
+
+/** @brief Indicadores de qualidade do ajuste */
+typedef struct
+{
+	uint32_t samples;  /**< Amostras acumuladas */
+	uint32_t solves;   /**< Solucoes validas calculadas */
+	uint8_t coverage;  /**< Regioes da esfera visitadas (0..MAGCAL_NUM_BINS) */
+	float residual;    /**< Residuo RMS do raio corrigido, relativo ao raio */
+	float delta;       /**< Variacao do offset na ultima solucao, relativa ao raio */
+	bool valid;        /**< Existe solucao valida */
+	bool converged;    /**< Cobertura, residuo e variacao dentro dos limites */
+} MagCalQuality_t;
+
+/** @brief Estado do calibrador */
+typedef struct
+{
+	double dtd[45];        /**< Triangulo superior de D'D */
+	double dt1[9];         /**< D'1 */
+	float lambda;          /**< Fator de esquecimento (1 = sem esquecimento) */
+	uint32_t bins;         /**< Mascara das regioes visitadas */
+	float residual_ms;     /**< Media movel do quadrado do residuo */
+	MagCalParams_t params; /**< Ultima solucao valida */
+	MagCalQuality_t quality;
+} MagCal_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Zera o calibrador. Os parametros ficam como identidade.
+ * @param cal Estado do calibrador.
+ * @param lambda Fator de esquecimento por amostra (0 < lambda <= 1).
+ */
+void MagCal_Init(MagCal_t *cal, float lambda);
+
+/**
+ * Acumula uma amostra. Custo constante.
+ * @param cal Estado do calibrador.
+ * @param m Campo medido x, y, z (sem correcao). Recomenda-se usar gauss para
+ *        manter as somas bem condicionadas.
+ */
+void MagCal_AddSample(MagCal_t *cal, const float m[3]);
+
+/**
+ * Resolve o ajuste com as somas acumuladas. A solucao so e aceita se o
+ * resultado for um elipsoide (matriz positiva definida).
+ * @param cal Estado do calibrador.
+ * @return true se uma nova solucao foi aceita.
+ */
+bool MagCal_Solve(MagCal_t *cal);
+
+/**
+ * Aplica os parametros a uma amostra.
+ * @param params Parametros de calibracao.
+ * @param in Campo medido.
+ * @param out Campo corrigido (pode ser o mesmo vetor de entrada).
+ */
+void MagCal_Apply(const MagCalParams_t *params, const float in[3], float out[3]);
+
+/**
+ * Carrega parametros conhecidos (por exemplo lidos da flash). As somas nao
+ * sao alteradas; o proximo MagCal_Solve substitui os parametros.
+ * @param cal Estado do calibrador.
+ * @param params Parametros a carregar.
+ */
+void MagCal_SetParams(MagCal_t *cal, const MagCalParams_t *params);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _MAGCAL_H_ */
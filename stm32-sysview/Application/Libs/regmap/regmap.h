@@ -0,0 +1,226 @@
+/**
+ * @file    regmap.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Descricao dos campos dos registradores dos sensores I2C, resolvida em compilacao
+ * @details
+ * Um campo e a tupla (registrador, primeiro bit, largura) criada por
+ * REGMAP_FIELD. Mascaras, deslocamentos e valores saem de expressoes
+ * constantes: o codigo gerado e o mesmo das mascaras escritas a mao.
+ *
+ * Os drivers guardam em RAM uma copia (espelho) dos registradores de
+ * controle, lida de uma vez no init. REGMAP_UPDATE junta os campos pedidos
+ * em uma mascara e um valor, mescla no espelho e so escreve o registrador
+ * se o valor mudou: uma transacao no lugar do ciclo leitura-modificacao-
+ * escrita, e nenhuma quando nada muda.
+ *
+ * Nao compilam:
+ *   - campo que nao cabe em 8 bits;
+ *   - valor constante que nao cabe no campo (REGMAP_SET);
+ *   - campo de outro registrador em REGMAP_UPDATE/REGMAP_MASKS;
+ *   - dois campos sobrepostos na mesma atualizacao;
+ *   - registrador fora do espelho ou do buffer de uma leitura em rajada
+ *     (REGMAP_AT) e rajada com o fim antes do inicio (REGMAP_COUNT).
+ *
+ * Os bits que a escrita dispara e o CI limpa sozinho (ONE_SHOT, BOOT,
+ * SW_RESET) nao devem ficar no espelho: escrever espelho | REGMAP_BITS(...)
+ * direto. Registradores alterados pelo proprio CI (reset, BOOT) exigem
+ * reler o espelho.
+ *
+ * Ate REGMAP_MAX_FIELDS campos por atualizacao.
+ */
+
+#ifndef _REGMAP_H_
+#define _REGMAP_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdbool.h>
+#include <stdint.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Campos aceitos por REGMAP_UPDATE, REGMAP_MASKS e REGMAP_BITS */
+#define REGMAP_MAX_FIELDS		8
+
+/**
+ * @brief Avalia para 0 ou interrompe a compilacao com msg se cond for falsa
+ * (cond deve ser constante).
+ */
+#define REGMAP_CHECK(cond, msg)			(0 * sizeof(struct { _Static_assert(cond, msg); char c; }))
+
+/**
+ * @brief Campo de um registrador.
+ * @param reg Endereco do registrador.
+ * @param pos Primeiro bit.
+ * @param width Largura em bits.
+ */
+#define REGMAP_FIELD(reg, pos, width)	(reg, pos, width)
+
+/** @brief Registrador de um campo */
+#define REGMAP_REG(field)				REGMAP_REG_ field
+
+/** @brief Primeiro bit de um campo */
+#define REGMAP_POS(field)				REGMAP_POS_ field
+
+/** @brief Mascara do campo no registrador */
+#define REGMAP_MASK(field)				REGMAP_MASK_ field
+
+/** @brief Le o campo de um valor do registrador */
+#define REGMAP_GET(field, value)		((uint8_t) (((value) & REGMAP_MASK(field)) >> REGMAP_POS(field)))
+
+/** @brief Atribuicao constante de um campo: nao compila se value nao couber */
+#define REGMAP_SET(field, value)		REGMAP_SET_(REGMAP_EXPAND field, value)
+
+/** @brief Atribuicao de um campo com valor calculado em execucao (truncado na largura) */
+#define REGMAP_SETV(field, value)		REGMAP_SETV_(REGMAP_EXPAND field, value)
+
+/** @brief Mascara das atribuicoes (REGMAP_SET/SETV) de reg */
+#define REGMAP_MASKS(reg, ...) \
+	((uint8_t) (REGMAP_JOIN(REGMAP_O, __VA_ARGS__)(reg, __VA_ARGS__) + \
+			REGMAP_CHECK(REGMAP_JOIN(REGMAP_S, __VA_ARGS__)(reg, __VA_ARGS__) == \
+			REGMAP_JOIN(REGMAP_O, __VA_ARGS__)(reg, __VA_ARGS__), "campos sobrepostos")))
+
+/** @brief Valor das atribuicoes de reg, ja deslocado */
+#define REGMAP_BITS(reg, ...)			((uint8_t) (REGMAP_JOIN(REGMAP_B, __VA_ARGS__)(reg, __VA_ARGS__)))
+
+/**
+ * @brief Atualiza campos de um registrador espelhado e escreve se mudou.
+ * @param shadow Vetor com a copia dos registradores a partir de first.
+ * @param first Registrador da posicao 0 do espelho.
+ * @param write Funcao void write(uint8_t reg, uint8_t value) do driver.
+ * @param reg Registrador.
+ * @param ... Uma ou mais atribuicoes REGMAP_SET/REGMAP_SETV de reg.
+ * @return true se o registrador foi escrito.
+ */
+#define REGMAP_UPDATE(shadow, first, write, reg, ...) \
+	RegMap_Update(&REGMAP_AT(shadow, first, reg), (reg), REGMAP_MASKS(reg, __VA_ARGS__), \
+			REGMAP_BITS(reg, __VA_ARGS__), (write))
+
+/** @brief Posicao de reg num espelho ou buffer de rajada que comeca em first */
+#define REGMAP_AT(buffer, first, reg) \
+	(buffer)[(reg) - (first) + REGMAP_CHECK(((reg) >= (first)) && (((reg) - (first)) < sizeof(buffer)), \
+			"registrador fora do buffer")]
+
+/** @brief Bytes de uma rajada de first a last (inclusive) */
+#define REGMAP_COUNT(first, last) \
+	((last) - (first) + 1 + REGMAP_CHECK((last) >= (first), "rajada com o fim antes do inicio"))
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define REGMAP_EXPAND(...)				__VA_ARGS__
+#define REGMAP_REG_(reg, pos, width)	(reg)
+#define REGMAP_POS_(reg, pos, width)	(pos)
+#define REGMAP_MASK_(reg, pos, width) \
+	((uint8_t) ((((1u << (width)) - 1u) << (pos)) + REGMAP_CHECK(((pos) + (width)) <= 8, "campo maior que o registrador")))
+
+#define REGMAP_SET_(...)				REGMAP_SET__(__VA_ARGS__)
+#define REGMAP_SET__(reg, pos, width, value) \
+	(reg, REGMAP_MASK_(reg, pos, width), \
+			((uint8_t) ((value) << (pos)) + REGMAP_CHECK(((value) >= 0) && ((value) < (1 << (width))), "valor nao cabe no campo")))
+
+#define REGMAP_SETV_(...)				REGMAP_SETV__(__VA_ARGS__)
+#define REGMAP_SETV__(reg, pos, width, value) \
+	(reg, REGMAP_MASK_(reg, pos, width), ((uint8_t) (((value) << (pos)) & REGMAP_MASK_(reg, pos, width))))
+
+/* Partes de uma atribuicao (reg, mascara, valor) */
+#define REGMAP_A_REG(reg, mask, bits)	(reg)
+#define REGMAP_A_MASK(reg, mask, bits)	(mask)
+#define REGMAP_A_BITS(reg, mask, bits)	(bits)
+
+/* Mascara de uma atribuicao, conferindo o registrador */
+#define REGMAP_AM(reg, a) \
+	(REGMAP_A_MASK a + REGMAP_CHECK((REGMAP_A_REG a) == (reg), "campo de outro registrador"))
+
+/*
+ * Cadeias de ate 8 atribuicoes: OU das mascaras, soma das mascaras (igual ao
+ * OU so se nenhum bit se repetir) e OU dos valores.
+ */
+#define REGMAP_O1(r, a)					REGMAP_AM(r, a)
+#define REGMAP_O2(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O1(r, __VA_ARGS__))
+#define REGMAP_O3(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O2(r, __VA_ARGS__))
+#define REGMAP_O4(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O3(r, __VA_ARGS__))
+#define REGMAP_O5(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O4(r, __VA_ARGS__))
+#define REGMAP_O6(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O5(r, __VA_ARGS__))
+#define REGMAP_O7(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O6(r, __VA_ARGS__))
+#define REGMAP_O8(r, a, ...)			(REGMAP_AM(r, a) | REGMAP_O7(r, __VA_ARGS__))
+
+#define REGMAP_S1(r, a)					REGMAP_A_MASK a
+#define REGMAP_S2(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S1(r, __VA_ARGS__))
+#define REGMAP_S3(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S2(r, __VA_ARGS__))
+#define REGMAP_S4(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S3(r, __VA_ARGS__))
+#define REGMAP_S5(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S4(r, __VA_ARGS__))
+#define REGMAP_S6(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S5(r, __VA_ARGS__))
+#define REGMAP_S7(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S6(r, __VA_ARGS__))
+#define REGMAP_S8(r, a, ...)			(REGMAP_A_MASK a + REGMAP_S7(r, __VA_ARGS__))
+
+#define REGMAP_B1(r, a)					REGMAP_A_BITS a
+#define REGMAP_B2(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B1(r, __VA_ARGS__))
+#define REGMAP_B3(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B2(r, __VA_ARGS__))
+#define REGMAP_B4(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B3(r, __VA_ARGS__))
+#define REGMAP_B5(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B4(r, __VA_ARGS__))
+#define REGMAP_B6(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B5(r, __VA_ARGS__))
+#define REGMAP_B7(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B6(r, __VA_ARGS__))
+#define REGMAP_B8(r, a, ...)			(REGMAP_A_BITS a | REGMAP_B7(r, __VA_ARGS__))
+
+/* Prefixo seguido do numero de atribuicoes */
+#define REGMAP_NARGS(...)				REGMAP_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define REGMAP_NARGS_(a, b, c, d, e, f, g, h, n, ...)	n
+#define REGMAP_JOIN(prefix, ...)		REGMAP_CAT(prefix, REGMAP_NARGS(__VA_ARGS__))
+#define REGMAP_CAT(a, b)				REGMAP_CAT_(a, b)
+#define REGMAP_CAT_(a, b)				a##b
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Escrita de um registrador pelo driver */
+typedef void (*RegMapWrite_t)(uint8_t reg, uint8_t value);
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Mescla campos na copia de um registrador e o escreve se o valor mudou
+ * (use REGMAP_UPDATE, que calcula e confere mask e bits).
+ * @param shadow Copia do registrador.
+ * @param reg Registrador.
+ * @param mask Bits alterados.
+ * @param bits Novo valor dos bits alterados.
+ * @param write Escrita do driver.
+ * @return true se o registrador foi escrito.
+ */
+static inline bool RegMap_Update(uint8_t *shadow, uint8_t reg, uint8_t mask, uint8_t bits, RegMapWrite_t write)
+{
+	uint8_t value = (uint8_t) ((*shadow & ~mask) | bits);
+
+	if (value == *shadow)
+	{
+		return false;
+	}
+
+	*shadow = value;
+	write(reg, value);
+
+	return true;
+}
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _REGMAP_H_ */
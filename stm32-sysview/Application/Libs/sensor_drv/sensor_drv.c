@@ -0,0 +1,769 @@
+/**
+ * @file    sensor_drv.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.3
+ * @brief   Interface comum dos drivers de sensores e tabela de registro
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "sensor_drv.h"
+
+#include <stddef.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Entrada da tabela de canais */
+typedef struct
+{
+	const SensorDriver_t *drv;
+	uint8_t ch;
+	SensorDrvStatus_t status;
+	SensorDrvFilter_t filter;
+	bool manual;                 /* SensorDrv_SetPower vale ate a proxima assinatura do CI */
+	SensorPower_e manual_power;
+} SensorDrvChannel_t;
+
+/** @brief Assinatura de um consumidor */
+typedef struct
+{
+	bool used;
+	uint8_t id;
+	uint32_t rate;
+	SensorPower_e power;
+} SensorDrvSub_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static const SensorDriver_t *sensorDrivers[SENSOR_DRV_MAX_DRIVERS];
+static uint8_t numDrivers = 0;
+
+static SensorDrvChannel_t sensorChannels[SENSOR_DRV_MAX_CHANNELS];
+static uint8_t numChannels = 0;
+
+static SensorDrvSub_t sensorSubs[SENSOR_DRV_MAX_SUBSCRIPTIONS];
+
+static SensorDrvNotify_t sensorNotify[SENSOR_DRV_MAX_NOTIFY];
+static uint8_t numNotify = 0;
+
+/** @brief Serializa o barramento entre leituras e reconfiguracoes */
+static SemaphoreHandle_t mutex_sensorDrv = NULL;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Recalcula as assinaturas dos canais de um driver e aplica o modo de cada
+ * um. Deve ser chamada com o mutex do registro.
+ * @param drv Driver a reconfigurar.
+ * @return HAL_OK ou o primeiro erro do driver.
+ */
+static HAL_StatusTypeDef SensorDrv_Apply(const SensorDriver_t *drv);
+
+/**
+ * Descarta os ajustes manuais de energia dos canais de um driver. Deve ser
+ * chamada com o mutex do registro.
+ * @param drv Driver cujas assinaturas mudaram.
+ */
+static void SensorDrv_ClearManual(const SensorDriver_t *drv);
+
+/**
+ * Avisa os callbacks registrados sobre todos os canais de um driver.
+ * @param drv Driver reconfigurado.
+ */
+static void SensorDrv_Notify(const SensorDriver_t *drv);
+
+/**
+ * Le uma amostra crua, disparando uma conversao unica se o canal nao estiver
+ * convertendo. Deve ser chamada com o mutex do registro.
+ * @param c Canal.
+ * @param raw Saida com axes valores.
+ * @return Status da leitura.
+ */
+static HAL_StatusTypeDef SensorDrv_Acquire(SensorDrvChannel_t *c, int32_t *raw);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static HAL_StatusTypeDef SensorDrv_Apply(const SensorDriver_t *drv)
+{
+	const SensorChannelDesc_t *desc;
+	SensorDrvStatus_t *st;
+	SensorPower_e shared_power = SENSOR_POWER_LOW;
+	HAL_StatusTypeDef status = HAL_OK, ret;
+	uint32_t shared_odr = 0;
+	uint8_t id, i;
+
+	/* Maior taxa e modo de energia mais exigente de cada canal */
+	for (id = 0; id < numChannels; id++)
+	{
+		if (sensorChannels[id].drv != drv)
+		{
+			continue;
+		}
+
+		st = &sensorChannels[id].status;
+		desc = &drv->channels[sensorChannels[id].ch];
+
+		st->demand = 0;
+		st->power = SENSOR_POWER_LOW;
+		st->subscribers = 0;
+
+		for (i = 0; i < SENSOR_DRV_MAX_SUBSCRIPTIONS; i++)
+		{
+			if ((sensorSubs[i].used == false) || (sensorSubs[i].id != id))
+			{
+				continue;
+			}
+
+			st->subscribers++;
+			if (sensorSubs[i].rate > st->demand)
+			{
+				st->demand = sensorSubs[i].rate;
+			}
+			if (sensorSubs[i].power > st->power)
+			{
+				st->power = sensorSubs[i].power;
+			}
+		}
+
+		if (sensorChannels[id].manual == true)
+		{
+			/* Ajuste do shell: liga continuo no ODR configurado ou desliga */
+			st->power = sensorChannels[id].manual_power;
+			st->mode = (st->power == SENSOR_POWER_OFF) ? SENSOR_MODE_OFF : SENSOR_MODE_CONTINUOUS;
+		}
+		else if (st->subscribers == 0)
+		{
+			st->mode = SENSOR_MODE_OFF;
+		}
+		else if ((drv->one_shot != NULL) && ((desc->num_odrs == 0) || (st->demand < desc->odrs[0])))
+		{
+			/* Abaixo do menor ODR sai mais barato converter so quando alguem le */
+			st->mode = SENSOR_MODE_ONE_SHOT;
+		}
+		else
+		{
+			st->mode = SENSOR_MODE_CONTINUOUS;
+		}
+
+		if (st->mode == SENSOR_MODE_CONTINUOUS)
+		{
+			if (st->demand > shared_odr)
+			{
+				shared_odr = st->demand;
+			}
+			if (st->power > shared_power)
+			{
+				shared_power = st->power;
+			}
+		}
+	}
+
+	/* Com ODR compartilhado o canal mais exigente define o CI inteiro */
+	for (id = 0; id < numChannels; id++)
+	{
+		if (sensorChannels[id].drv != drv)
+		{
+			continue;
+		}
+
+		st = &sensorChannels[id].status;
+		desc = &drv->channels[sensorChannels[id].ch];
+
+		if (drv->shared_odr == true)
+		{
+			st->demand = (st->mode == SENSOR_MODE_CONTINUOUS) ? shared_odr : st->demand;
+			st->power = (st->mode == SENSOR_MODE_CONTINUOUS) ? shared_power : st->power;
+		}
+
+		if (st->mode != SENSOR_MODE_CONTINUOUS)
+		{
+			if (drv->set_power != NULL)
+			{
+				ret = drv->set_power(sensorChannels[id].ch, SENSOR_POWER_OFF);
+				status = (status == HAL_OK) ? ret : status;
+			}
+			continue;
+		}
+
+		/* Sem taxa pedida (so ajuste manual) o ODR configurado e mantido */
+		if ((drv->set_odr != NULL) && (desc->num_odrs > 0) && ((st->demand > 0) || (sensorChannels[id].manual == false)))
+		{
+			ret = drv->set_odr(sensorChannels[id].ch, desc->odrs[SensorDrv_OdrIndex(desc, st->demand)]);
+			status = (status == HAL_OK) ? ret : status;
+		}
+
+		if (drv->set_power != NULL)
+		{
+			ret = drv->set_power(sensorChannels[id].ch, st->power);
+			status = (status == HAL_OK) ? ret : status;
+		}
+	}
+
+	return status;
+}
+
+static void SensorDrv_ClearManual(const SensorDriver_t *drv)
+{
+	uint8_t id;
+
+	for (id = 0; id < numChannels; id++)
+	{
+		if (sensorChannels[id].drv == drv)
+		{
+			sensorChannels[id].manual = false;
+		}
+	}
+}
+
+static void SensorDrv_Notify(const SensorDriver_t *drv)
+{
+	uint8_t id, i;
+
+	for (id = 0; id < numChannels; id++)
+	{
+		if (sensorChannels[id].drv != drv)
+		{
+			continue;
+		}
+
+		for (i = 0; i < numNotify; i++)
+		{
+			sensorNotify[i](id);
+		}
+	}
+}
+
+static HAL_StatusTypeDef SensorDrv_Acquire(SensorDrvChannel_t *c, int32_t *raw)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+
+	if (c->status.mode != SENSOR_MODE_CONTINUOUS)
+	{
+		if (c->drv->one_shot == NULL)
+		{
+			return HAL_ERROR;
+		}
+
+		status = c->drv->one_shot(c->ch);
+		c->status.triggers++;
+	}
+
+	if (status == HAL_OK)
+	{
+		status = c->drv->read_raw(c->ch, raw);
+		c->status.reads++;
+	}
+
+	return status;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+HAL_StatusTypeDef SensorDrv_Register(const SensorDriver_t *drv)
+{
+	uint8_t ch;
+
+	DBG_ASSERT_PARAM(drv);
+	DBG_ASSERT_PARAM(drv->read_raw);
+	DBG_ASSERT_PARAM(drv->convert);
+
+	if ((numDrivers >= SENSOR_DRV_MAX_DRIVERS) || ((numChannels + drv->num_channels) > SENSOR_DRV_MAX_CHANNELS))
+	{
+		return HAL_ERROR;
+	}
+
+	/* CI ausente ou com outro WHO_AM_I nao entra na tabela */
+	if ((drv->probe != NULL) && (drv->probe() != HAL_OK))
+	{
+		return HAL_ERROR;
+	}
+
+	if ((drv->init != NULL) && (drv->init() != HAL_OK))
+	{
+		return HAL_ERROR;
+	}
+
+	if (mutex_sensorDrv == NULL)
+	{
+		mutex_sensorDrv = xSemaphoreCreateMutex();
+		DBG_ASSERT_PARAM(mutex_sensorDrv);
+		vQueueAddToRegistry(mutex_sensorDrv, "sensDrv");
+	}
+
+	xSemaphoreTake(mutex_sensorDrv, portMAX_DELAY);
+
+	sensorDrivers[numDrivers++] = drv;
+
+	for (ch = 0; ch < drv->num_channels; ch++)
+	{
+		memset(&sensorChannels[numChannels], 0, sizeof(SensorDrvChannel_t));
+		sensorChannels[numChannels].drv = drv;
+		sensorChannels[numChannels].ch = ch;
+		numChannels++;
+	}
+
+	/* Ninguem assinou ainda: o CI sai do init desligado */
+	SensorDrv_Apply(drv);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	return HAL_OK;
+}
+
+uint8_t SensorDrv_GetNumDrivers(void)
+{
+	return numDrivers;
+}
+
+const SensorDriver_t *SensorDrv_GetDriver(uint8_t index)
+{
+	return (index < numDrivers) ? sensorDrivers[index] : NULL;
+}
+
+uint8_t SensorDrv_GetNumChannels(void)
+{
+	return numChannels;
+}
+
+uint8_t SensorDrv_Find(SensorType_e type, const char *driver)
+{
+	const SensorDrvChannel_t *c;
+	uint8_t id;
+
+	for (id = 0; id < numChannels; id++)
+	{
+		c = &sensorChannels[id];
+
+		if ((c->drv->channels[c->ch].type == type) &&
+				((driver == NULL) || (strcmp(driver, c->drv->name) == 0)))
+		{
+			return id;
+		}
+	}
+
+	return SENSOR_DRV_INVALID;
+}
+
+const SensorChannelDesc_t *SensorDrv_GetDesc(uint8_t id)
+{
+	if (id >= numChannels)
+	{
+		return NULL;
+	}
+
+	return &sensorChannels[id].drv->channels[sensorChannels[id].ch];
+}
+
+const SensorDriver_t *SensorDrv_GetOwner(uint8_t id)
+{
+	return (id < numChannels) ? sensorChannels[id].drv : NULL;
+}
+
+HAL_StatusTypeDef SensorDrv_Read(uint8_t id, int32_t *value)
+{
+	SensorDrvChannel_t *c;
+	HAL_StatusTypeDef status;
+
+	if (id >= numChannels)
+	{
+		return HAL_ERROR;
+	}
+
+	c = &sensorChannels[id];
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	status = SensorDrv_Acquire(c, value);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	if (status == HAL_OK)
+	{
+		c->drv->convert(c->ch, value, value, 1);
+
+		if (c->filter != NULL)
+		{
+			c->filter(id, value, 1, true);
+		}
+	}
+
+	return status;
+}
+
+uint16_t SensorDrv_ReadBatch(uint8_t id, int32_t *values, uint16_t max)
+{
+	SensorDrvChannel_t *c;
+	uint16_t count = 0;
+
+	if ((id >= numChannels) || (max == 0))
+	{
+		return 0;
+	}
+
+	c = &sensorChannels[id];
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return 0;
+	}
+
+	if ((c->drv->read_batch != NULL) && (c->status.mode == SENSOR_MODE_CONTINUOUS))
+	{
+		count = c->drv->read_batch(c->ch, values, max);
+		c->status.reads += count;
+	}
+	else if (SensorDrv_Acquire(c, values) == HAL_OK)
+	{
+		count = 1;
+	}
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	/* Conversao em bloco, depois de liberar o barramento */
+	if (count > 0)
+	{
+		c->drv->convert(c->ch, values, values, count);
+
+		if (c->filter != NULL)
+		{
+			count = c->filter(id, values, count, false);
+		}
+	}
+
+	return count;
+}
+
+HAL_StatusTypeDef SensorDrv_SetOdr(uint8_t id, uint32_t odr_mhz)
+{
+	const SensorChannelDesc_t *desc = SensorDrv_GetDesc(id);
+	HAL_StatusTypeDef status;
+
+	if ((desc == NULL) || (desc->num_odrs == 0) || (sensorChannels[id].drv->set_odr == NULL))
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	status = sensorChannels[id].drv->set_odr(sensorChannels[id].ch, desc->odrs[SensorDrv_OdrIndex(desc, odr_mhz)]);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	/* A taxa efetiva (SensorDrv_GetRate) mudou para quem acompanha o ODR */
+	SensorDrv_Notify(sensorChannels[id].drv);
+
+	return status;
+}
+
+uint32_t SensorDrv_GetOdr(uint8_t id)
+{
+	if ((id >= numChannels) || (sensorChannels[id].drv->get_odr == NULL))
+	{
+		return 0;
+	}
+
+	return sensorChannels[id].drv->get_odr(sensorChannels[id].ch);
+}
+
+HAL_StatusTypeDef SensorDrv_SetRange(uint8_t id, uint32_t range)
+{
+	const SensorChannelDesc_t *desc = SensorDrv_GetDesc(id);
+	HAL_StatusTypeDef status;
+
+	if ((desc == NULL) || (desc->num_ranges == 0) || (sensorChannels[id].drv->set_range == NULL))
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	status = sensorChannels[id].drv->set_range(sensorChannels[id].ch, desc->ranges[SensorDrv_RangeIndex(desc, range)]);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	return status;
+}
+
+uint32_t SensorDrv_GetRange(uint8_t id)
+{
+	if ((id >= numChannels) || (sensorChannels[id].drv->get_range == NULL))
+	{
+		return 0;
+	}
+
+	return sensorChannels[id].drv->get_range(sensorChannels[id].ch);
+}
+
+HAL_StatusTypeDef SensorDrv_SetPower(uint8_t id, SensorPower_e power)
+{
+	HAL_StatusTypeDef status;
+
+	if ((id >= numChannels) || (sensorChannels[id].drv->set_power == NULL))
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	/* Ajuste manual: vale ate a proxima mudanca nas assinaturas do CI */
+	sensorChannels[id].manual = true;
+	sensorChannels[id].manual_power = power;
+	status = SensorDrv_Apply(sensorChannels[id].drv);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	SensorDrv_Notify(sensorChannels[id].drv);
+
+	return status;
+}
+
+HAL_StatusTypeDef SensorDrv_Start(uint8_t id)
+{
+	return SensorDrv_SetPower(id, SENSOR_POWER_NORMAL);
+}
+
+HAL_StatusTypeDef SensorDrv_SetFilter(uint8_t id, uint16_t level)
+{
+	HAL_StatusTypeDef status;
+
+	if ((id >= numChannels) || (sensorChannels[id].drv->set_filter == NULL))
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	status = sensorChannels[id].drv->set_filter(sensorChannels[id].ch, level);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	return status;
+}
+
+uint8_t SensorDrv_Subscribe(uint8_t id, uint32_t rate_mhz, SensorPower_e power)
+{
+	uint8_t handle;
+
+	if ((id >= numChannels) || (power == SENSOR_POWER_OFF))
+	{
+		return SENSOR_DRV_INVALID;
+	}
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return SENSOR_DRV_INVALID;
+	}
+
+	for (handle = 0; handle < SENSOR_DRV_MAX_SUBSCRIPTIONS; handle++)
+	{
+		if (sensorSubs[handle].used == false)
+		{
+			break;
+		}
+	}
+
+	if (handle < SENSOR_DRV_MAX_SUBSCRIPTIONS)
+	{
+		sensorSubs[handle].used = true;
+		sensorSubs[handle].id = id;
+		sensorSubs[handle].rate = rate_mhz;
+		sensorSubs[handle].power = power;
+
+		SensorDrv_ClearManual(sensorChannels[id].drv);
+		SensorDrv_Apply(sensorChannels[id].drv);
+	}
+	else
+	{
+		handle = SENSOR_DRV_INVALID;
+	}
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	if (handle != SENSOR_DRV_INVALID)
+	{
+		SensorDrv_Notify(sensorChannels[id].drv);
+	}
+
+	return handle;
+}
+
+HAL_StatusTypeDef SensorDrv_Unsubscribe(uint8_t handle)
+{
+	const SensorDriver_t *drv;
+
+	if ((handle >= SENSOR_DRV_MAX_SUBSCRIPTIONS) || (sensorSubs[handle].used == false))
+	{
+		return HAL_ERROR;
+	}
+
+	if (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	drv = sensorChannels[sensorSubs[handle].id].drv;
+	sensorSubs[handle].used = false;
+
+	SensorDrv_ClearManual(drv);
+	SensorDrv_Apply(drv);
+
+	xSemaphoreGive(mutex_sensorDrv);
+
+	SensorDrv_Notify(drv);
+
+	return HAL_OK;
+}
+
+uint32_t SensorDrv_GetRate(uint8_t id)
+{
+	if (id >= numChannels)
+	{
+		return 0;
+	}
+
+	switch (sensorChannels[id].status.mode)
+	{
+	case SENSOR_MODE_CONTINUOUS:
+		return SensorDrv_GetOdr(id);
+
+	case SENSOR_MODE_ONE_SHOT:
+		return sensorChannels[id].status.demand;
+
+	default:
+		return 0;
+	}
+}
+
+void SensorDrv_GetStatus(uint8_t id, SensorDrvStatus_t *status)
+{
+	DBG_ASSERT_PARAM(status);
+
+	if (id >= numChannels)
+	{
+		memset(status, 0, sizeof(SensorDrvStatus_t));
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	*status = sensorChannels[id].status;
+	taskEXIT_CRITICAL();
+}
+
+void SensorDrv_ResetStats(void)
+{
+	uint8_t id;
+
+	taskENTER_CRITICAL();
+	for (id = 0; id < numChannels; id++)
+	{
+		sensorChannels[id].status.reads = 0;
+		sensorChannels[id].status.triggers = 0;
+	}
+	taskEXIT_CRITICAL();
+}
+
+HAL_StatusTypeDef SensorDrv_Lock(void)
+{
+	if ((mutex_sensorDrv == NULL) || (xSemaphoreTake(mutex_sensorDrv, SENSOR_DRV_MUTEX_TIMEOUT) != pdTRUE))
+	{
+		return HAL_TIMEOUT;
+	}
+
+	return HAL_OK;
+}
+
+void SensorDrv_Unlock(void)
+{
+	xSemaphoreGive(mutex_sensorDrv);
+}
+
+HAL_StatusTypeDef SensorDrv_AddNotify(SensorDrvNotify_t notify)
+{
+	HAL_StatusTypeDef status = HAL_ERROR;
+
+	DBG_ASSERT_PARAM(notify);
+
+	/* Lista so cresce: quem percorre ve o callback antigo ou o novo completo */
+	taskENTER_CRITICAL();
+	if (numNotify < SENSOR_DRV_MAX_NOTIFY)
+	{
+		sensorNotify[numNotify] = notify;
+		numNotify++;
+		status = HAL_OK;
+	}
+	taskEXIT_CRITICAL();
+
+	return status;
+}
+
+HAL_StatusTypeDef SensorDrv_SetPostFilter(uint8_t id, SensorDrvFilter_t filter)
+{
+	if (id >= numChannels)
+	{
+		return HAL_ERROR;
+	}
+
+	/* Um leitor no meio de Read/ReadBatch usa o ponteiro antigo ou o novo, nunca metade */
+	sensorChannels[id].filter = filter;
+
+	return HAL_OK;
+}
+
+uint8_t SensorDrv_OdrIndex(const SensorChannelDesc_t *desc, uint32_t odr_mhz)
+{
+	uint8_t i;
+
+	for (i = 0; i < (desc->num_odrs - 1); i++)
+	{
+		if (desc->odrs[i] >= odr_mhz)
+		{
+			break;
+		}
+	}
+
+	return i;
+}
+
+uint8_t SensorDrv_RangeIndex(const SensorChannelDesc_t *desc, uint32_t range)
+{
+	uint8_t i;
+
+	for (i = 0; i < (desc->num_ranges - 1); i++)
+	{
+		if (desc->ranges[i] >= range)
+		{
+			break;
+		}
+	}
+
+	return i;
+}
@@ -0,0 +1,412 @@
+/**
+ * @file    sensor_drv.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.3
+ * @brief   Interface comum dos drivers de sensores e tabela de registro
+ * @details
+ * Cada driver exporta um SensorDriver_t constante com a descricao dos seus
+ * canais e as operacoes do dispositivo. Um canal e uma grandeza do sensor
+ * (ex.: temperatura do HTS221, giroscopio do LSM6DSL) com 1 a 3 eixos.
+ *
+ * SensorDrv_Register verifica o WHO_AM_I, aplica a configuracao padrao e
+ * adiciona os canais do driver a uma tabela unica. O resto da aplicacao
+ * (cache, aquisicao, shell) trabalha apenas com o indice do canal nessa
+ * tabela, entao um novo sensor ou um mock so precisa de um SensorDriver_t.
+ *
+ * As leituras sao divididas em duas etapas: read_raw devolve as contagens
+ * do registrador e convert as transforma na unidade inteira do canal
+ * (SensorChannelDesc_t.unit/scale). Assim um lote pode ser lido primeiro e
+ * convertido depois, fora do barramento.
+ *
+ * Energia: os consumidores assinam um canal com a taxa que precisam
+ * (SensorDrv_Subscribe) e o registro escolhe o modo do CI a partir da maior
+ * taxa pedida. Sem assinantes o canal e desligado; abaixo do menor ODR, e se
+ * o driver suporta, o CI fica desligado e cada leitura dispara uma conversao
+ * unica (one_shot); nos demais casos o canal converte continuamente no menor
+ * ODR que atende ao pedido.
+ */
+
+#ifndef _SENSOR_DRV_H_
+#define _SENSOR_DRV_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Quantidade maxima de drivers registrados */
+#define SENSOR_DRV_MAX_DRIVERS		8
+
+/** @brief Quantidade maxima de canais somando todos os drivers */
+#define SENSOR_DRV_MAX_CHANNELS		16
+
+/** @brief Eixos maximos de um canal */
+#define SENSOR_DRV_MAX_AXES			3
+
+/** @brief Quantidade maxima de assinaturas somando todos os canais */
+#define SENSOR_DRV_MAX_SUBSCRIPTIONS	16
+
+/** @brief Callbacks de SensorDrv_AddNotify */
+#define SENSOR_DRV_MAX_NOTIFY		4
+
+/** @brief Indice retornado quando o canal ou a assinatura nao existe */
+#define SENSOR_DRV_INVALID			0xFF
+
+/** @brief Tempo maximo de espera pelo mutex do registro */
+#define SENSOR_DRV_MUTEX_TIMEOUT	1000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Tipo de grandeza de um canal */
+typedef enum
+{
+	SENSOR_TYPE_TEMPERATURE = 0,
+	SENSOR_TYPE_HUMIDITY,
+	SENSOR_TYPE_PRESSURE,
+	SENSOR_TYPE_GYRO,
+	SENSOR_TYPE_ACCELERO,
+	SENSOR_TYPE_MAGNETO,
+	SENSOR_TYPE_DISTANCE,
+	SENSOR_TYPE_MAX
+} SensorType_e;
+
+/** @brief Estado de energia de um canal */
+typedef enum
+{
+	SENSOR_POWER_OFF = 0,  /**< Sem conversao, consumo minimo */
+	SENSOR_POWER_LOW,      /**< Convertendo em modo de baixo consumo */
+	SENSOR_POWER_NORMAL    /**< Convertendo em modo normal */
+} SensorPower_e;
+
+/** @brief Modo de aquisicao escolhido pelo registro para um canal */
+typedef enum
+{
+	SENSOR_MODE_OFF = 0,   /**< Sem assinantes: desligado (leituras usam one_shot, se houver) */
+	SENSOR_MODE_ONE_SHOT,  /**< Desligado entre leituras; cada leitura dispara uma conversao */
+	SENSOR_MODE_CONTINUOUS /**< Convertendo no menor ODR que atende as assinaturas */
+} SensorMode_e;
+
+/** @brief Descricao de um canal */
+typedef struct
+{
+	const char *name;      /**< Nome da grandeza ("temperature", "gyro"...) */
+	SensorType_e type;     /**< Tipo da grandeza */
+	uint8_t axes;          /**< Valores por amostra (1 a SENSOR_DRV_MAX_AXES) */
+	const char *unit;      /**< Unidade apos a conversao dividida por scale */
+	int32_t scale;         /**< LSB do valor convertido por unidade */
+	const uint32_t *odrs;  /**< ODRs suportados em mHz, em ordem crescente */
+	uint8_t num_odrs;
+	const uint32_t *ranges;/**< Fundos de escala suportados na unidade do canal (NULL se fixo) */
+	uint8_t num_ranges;
+} SensorChannelDesc_t;
+
+/**
+ * @brief Operacoes de um driver. Todas recebem o indice local do canal
+ * (0 .. num_channels-1). Ponteiros opcionais podem ser NULL.
+ */
+typedef struct
+{
+	const char *name;                     /**< Nome do CI */
+	uint8_t address;                      /**< Endereco I2C (8 bits) */
+	uint8_t num_channels;
+	const SensorChannelDesc_t *channels;
+	bool shared_odr;                      /**< Canais dividem o mesmo ODR e modo de energia */
+
+	/** Verifica se o CI responde com o WHO_AM_I esperado */
+	HAL_StatusTypeDef (*probe)(void);
+
+	/** Aplica a configuracao padrao (ja convertendo) */
+	HAL_StatusTypeDef (*init)(void);
+
+	/** Configura o ODR; recebe sempre um valor da lista odrs do canal */
+	HAL_StatusTypeDef (*set_odr)(uint8_t ch, uint32_t odr_mhz);
+
+	/** ODR atual em mHz (0 = sem conversao continua) */
+	uint32_t (*get_odr)(uint8_t ch);
+
+	/** Configura o fundo de escala; recebe um valor da lista ranges (opcional) */
+	HAL_StatusTypeDef (*set_range)(uint8_t ch, uint32_t range);
+
+	/** Fundo de escala atual (opcional) */
+	uint32_t (*get_range)(uint8_t ch);
+
+	/** Altera o estado de energia do canal */
+	HAL_StatusTypeDef (*set_power)(uint8_t ch, SensorPower_e power);
+
+	/** Le uma amostra crua (axes valores em contagens do registrador) */
+	HAL_StatusTypeDef (*read_raw)(uint8_t ch, int32_t *raw);
+
+	/** Le ate max amostras cruas acumuladas no CI (opcional) */
+	uint16_t (*read_batch)(uint8_t ch, int32_t *raw, uint16_t max);
+
+	/** Converte count amostras cruas para a unidade do canal (pode ser no lugar) */
+	void (*convert)(uint8_t ch, const int32_t *raw, int32_t *out, uint16_t count);
+
+	/**
+	 * Dispara uma conversao unica com o canal desligado e aguarda o fim
+	 * (opcional). Retorna HAL_OK sem disparar se o CI ja estiver convertendo.
+	 */
+	HAL_StatusTypeDef (*one_shot)(uint8_t ch);
+
+	/**
+	 * Configura a media/filtro interno do CI (opcional). level e o numero de
+	 * amostras medias por saida ou o divisor de banda ODR/level; 0 ou 1 desliga.
+	 * O driver usa o menor valor suportado maior ou igual ao pedido.
+	 */
+	HAL_StatusTypeDef (*set_filter)(uint8_t ch, uint16_t level);
+} SensorDriver_t;
+
+/** @brief Estado de energia e contadores de um canal */
+typedef struct
+{
+	SensorMode_e mode;
+	SensorPower_e power;   /**< Modo de energia no modo continuo */
+	uint32_t demand;       /**< Maior taxa assinada em mHz */
+	uint8_t subscribers;
+	uint32_t reads;        /**< Amostras lidas do barramento */
+	uint32_t triggers;     /**< Conversoes unicas disparadas */
+} SensorDrvStatus_t;
+
+/**
+ * @brief Chamado depois que o modo ou a taxa de um canal muda, fora do mutex
+ * do registro (ex.: para o cache recalcular a janela de validade).
+ * @param id Canal alterado.
+ */
+typedef void (*SensorDrvNotify_t)(uint8_t id);
+
+/**
+ * @brief Filtro aplicado as amostras ja convertidas de um canal, fora do
+ * mutex do registro. Pode decimar: devolve quantas amostras ficaram no
+ * inicio de values.
+ * @param id Canal.
+ * @param values count * axes valores, filtrados no lugar.
+ * @param count Amostras.
+ * @param hold true em SensorDrv_Read: sem saida nova, values recebe a ultima.
+ */
+typedef uint16_t (*SensorDrvFilter_t)(uint8_t id, int32_t *values, uint16_t count, bool hold);
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Verifica, inicializa e adiciona um driver na tabela.
+ * @param drv Driver a registrar (deve ser constante).
+ * @return HAL_OK, HAL_ERROR se o CI nao respondeu ou a tabela esta cheia.
+ */
+HAL_StatusTypeDef SensorDrv_Register(const SensorDriver_t *drv);
+
+/** @brief Quantidade de drivers registrados. */
+uint8_t SensorDrv_GetNumDrivers(void);
+
+/**
+ * Retorna um driver registrado.
+ * @param index Posicao na tabela.
+ * @return Driver ou NULL.
+ */
+const SensorDriver_t *SensorDrv_GetDriver(uint8_t index);
+
+/** @brief Quantidade total de canais registrados. */
+uint8_t SensorDrv_GetNumChannels(void);
+
+/**
+ * Procura um canal pelo tipo.
+ * @param type Tipo da grandeza.
+ * @param driver Nome do CI ou NULL para o primeiro encontrado.
+ * @return Indice do canal ou SENSOR_DRV_INVALID.
+ */
+uint8_t SensorDrv_Find(SensorType_e type, const char *driver);
+
+/**
+ * Retorna a descricao de um canal.
+ * @param id Indice do canal.
+ * @return Descricao ou NULL.
+ */
+const SensorChannelDesc_t *SensorDrv_GetDesc(uint8_t id);
+
+/**
+ * Retorna o driver dono de um canal.
+ * @param id Indice do canal.
+ * @return Driver ou NULL.
+ */
+const SensorDriver_t *SensorDrv_GetOwner(uint8_t id);
+
+/**
+ * Le uma amostra ja convertida. Um canal desligado dispara uma conversao
+ * unica se o driver suportar.
+ * @param id Indice do canal.
+ * @param value Saida com axes valores.
+ * @return HAL_OK, HAL_ERROR se o canal estiver desligado sem one_shot, ou
+ * erro do driver.
+ */
+HAL_StatusTypeDef SensorDrv_Read(uint8_t id, int32_t *value);
+
+/**
+ * Le um lote de amostras convertidas. Drivers sem read_batch devolvem uma
+ * unica amostra.
+ * @param id Indice do canal.
+ * @param values Saida com max * axes valores.
+ * @param max Amostras maximas.
+ * @return Amostras lidas.
+ */
+uint16_t SensorDrv_ReadBatch(uint8_t id, int32_t *values, uint16_t max);
+
+/**
+ * Configura o menor ODR suportado que atende ao pedido.
+ * @param id Indice do canal.
+ * @param odr_mhz ODR desejado em mHz.
+ * @return HAL_OK, erro do driver ou HAL_TIMEOUT sem o mutex do registro.
+ */
+HAL_StatusTypeDef SensorDrv_SetOdr(uint8_t id, uint32_t odr_mhz);
+
+/**
+ * @param id Indice do canal.
+ * @return ODR atual em mHz (0 = sem conversao continua).
+ */
+uint32_t SensorDrv_GetOdr(uint8_t id);
+
+/**
+ * Configura o menor fundo de escala suportado que cobre o pedido.
+ * @param id Indice do canal.
+ * @param range Fundo de escala desejado na unidade do canal.
+ * @return HAL_OK, HAL_ERROR se o canal tem escala fixa, HAL_TIMEOUT sem o
+ *         mutex do registro.
+ */
+HAL_StatusTypeDef SensorDrv_SetRange(uint8_t id, uint32_t range);
+
+/**
+ * @param id Indice do canal.
+ * @return Fundo de escala atual (0 se fixo).
+ */
+uint32_t SensorDrv_GetRange(uint8_t id);
+
+/**
+ * Altera o estado de energia de um canal por cima das assinaturas (shell).
+ * Passa pelo mesmo caminho das assinaturas: o modo do canal e do CI e
+ * recalculado e os callbacks de SensorDrv_AddNotify sao avisados. Vale ate a
+ * proxima mudanca nas assinaturas do CI.
+ * @param id Indice do canal.
+ * @param power Estado desejado.
+ * @return HAL_OK, erro do driver ou HAL_TIMEOUT sem o mutex do registro.
+ */
+HAL_StatusTypeDef SensorDrv_SetPower(uint8_t id, SensorPower_e power);
+
+/**
+ * Inicia a conversao continua no ODR configurado (SENSOR_POWER_NORMAL).
+ * @param id Indice do canal.
+ * @return HAL_OK ou erro do driver.
+ */
+HAL_StatusTypeDef SensorDrv_Start(uint8_t id);
+
+/**
+ * Configura a media/filtro interno do CI.
+ * @param id Indice do canal.
+ * @param level Amostras medias ou divisor de banda (0 ou 1 desliga).
+ * @return HAL_OK, HAL_ERROR se o canal nao tem filtro.
+ */
+HAL_StatusTypeDef SensorDrv_SetFilter(uint8_t id, uint16_t level);
+
+/**
+ * Assina um canal. O modo do CI passa a atender a maior taxa entre as
+ * assinaturas do canal.
+ * @param id Indice do canal.
+ * @param rate_mhz Taxa necessaria em mHz.
+ * @param power SENSOR_POWER_NORMAL se o consumidor precisa do menor ruido,
+ * SENSOR_POWER_LOW se aceita o modo de baixo consumo.
+ * @return Identificador da assinatura ou SENSOR_DRV_INVALID.
+ */
+uint8_t SensorDrv_Subscribe(uint8_t id, uint32_t rate_mhz, SensorPower_e power);
+
+/**
+ * Cancela uma assinatura; o canal e reconfigurado para as restantes.
+ * @param handle Retorno de SensorDrv_Subscribe.
+ * @return HAL_OK, HAL_ERROR se a assinatura nao existe.
+ */
+HAL_StatusTypeDef SensorDrv_Unsubscribe(uint8_t handle);
+
+/**
+ * Taxa efetiva de amostras novas: o ODR no modo continuo, a taxa assinada
+ * no modo de conversao unica e 0 com o canal desligado.
+ * @param id Indice do canal.
+ * @return Taxa em mHz.
+ */
+uint32_t SensorDrv_GetRate(uint8_t id);
+
+/**
+ * @param id Indice do canal.
+ * @param status Saida com o modo, as assinaturas e os contadores.
+ */
+void SensorDrv_GetStatus(uint8_t id, SensorDrvStatus_t *status);
+
+/** @brief Zera os contadores de leitura e disparo de todos os canais. */
+void SensorDrv_ResetStats(void);
+
+/**
+ * Reserva os drivers (e o barramento) para funcoes especificas de um CI que
+ * nao passam pela interface comum (ex.: funcoes embarcadas do LSM6DSL). Nao
+ * chame outras funcoes do registro antes de SensorDrv_Unlock.
+ * @return HAL_OK, HAL_TIMEOUT se o registro continuou ocupado.
+ */
+HAL_StatusTypeDef SensorDrv_Lock(void);
+
+/** @brief Libera a reserva de SensorDrv_Lock. */
+void SensorDrv_Unlock(void);
+
+/**
+ * Registra mais um interessado em mudancas de modo ou taxa dos canais
+ * (cache, tasks que seguem o ODR). Chamada na inicializacao.
+ * @param notify Callback.
+ * @return HAL_OK, HAL_ERROR se ja houver SENSOR_DRV_MAX_NOTIFY callbacks.
+ */
+HAL_StatusTypeDef SensorDrv_AddNotify(SensorDrvNotify_t notify);
+
+/**
+ * Instala um filtro nas leituras de um canal. A cadeia ve toda amostra que
+ * passa por SensorDrv_Read e SensorDrv_ReadBatch, de qualquer consumidor;
+ * o projeto deve usar a taxa em que o canal e lido (SensorDrv_GetRate com o
+ * FIFO ou um unico consumidor na taxa do ODR).
+ * @param id Indice do canal.
+ * @param filter Filtro ou NULL para remover.
+ * @return HAL_OK, HAL_ERROR se o canal nao existir.
+ */
+HAL_StatusTypeDef SensorDrv_SetPostFilter(uint8_t id, SensorDrvFilter_t filter);
+
+/**
+ * Procura na lista de ODRs o menor valor maior ou igual ao pedido.
+ * Usada pelos drivers para traduzir o ODR em bits de registrador.
+ * @param desc Descricao do canal.
+ * @param odr_mhz ODR desejado.
+ * @return Posicao na lista (a ultima se o pedido for maior que todas).
+ */
+uint8_t SensorDrv_OdrIndex(const SensorChannelDesc_t *desc, uint32_t odr_mhz);
+
+/**
+ * Procura na lista de fundos de escala o menor valor que cobre o pedido.
+ * @param desc Descricao do canal.
+ * @param range Fundo de escala desejado.
+ * @return Posicao na lista (a ultima se o pedido for maior que todas).
+ */
+uint8_t SensorDrv_RangeIndex(const SensorChannelDesc_t *desc, uint32_t range);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_DRV_H_ */
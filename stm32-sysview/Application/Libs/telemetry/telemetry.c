@@ -0,0 +1,278 @@
+/**
+ * @file    telemetry.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.2.0
+ * @brief   Quadros binarios de telemetria com esquema, sequencia e CRC
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "telemetry.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Preenche cabecalho e CRC em volta de um payload ja escrito em
+ * frame + TLM_HEADER_SIZE.
+ * @param schema Versao do esquema (0 nos quadros da foto do sistema).
+ * @return Tamanho total do quadro.
+ */
+static uint16_t Tlm_Seal(uint8_t schema, TlmFrame_e type, uint16_t seq, uint8_t len, uint8_t *frame);
+
+/**
+ * Escreve um inteiro little-endian.
+ * @param value Valor.
+ * @param size Bytes (2 ou 4).
+ * @param out Saida.
+ * @return out + size.
+ */
+static uint8_t *Tlm_PutLE(uint32_t value, uint8_t size, uint8_t *out);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint16_t Tlm_Seal(uint8_t schema, TlmFrame_e type, uint16_t seq, uint8_t len, uint8_t *frame)
+{
+	uint16_t crc;
+
+	frame[0] = TLM_SYNC0;
+	frame[1] = TLM_SYNC1;
+	frame[2] = (uint8_t) (((schema & 0x0F) << 4) | ((uint8_t) type & 0x0F));
+	frame[3] = len;
+	frame[4] = (uint8_t) (seq & 0xFF);
+	frame[5] = (uint8_t) (seq >> 8);
+
+	/* Sincronismo fora do CRC: o receptor recalcula a partir do tipo */
+	crc = Tlm_Crc16(&frame[2], (uint16_t) (TLM_HEADER_SIZE - 2 + len));
+	frame[TLM_HEADER_SIZE + len] = (uint8_t) (crc & 0xFF);
+	frame[TLM_HEADER_SIZE + len + 1] = (uint8_t) (crc >> 8);
+
+	return (uint16_t) (TLM_HEADER_SIZE + len + TLM_CRC_SIZE);
+}
+
+static uint8_t *Tlm_PutLE(uint32_t value, uint8_t size, uint8_t *out)
+{
+	uint8_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		*out++ = (uint8_t) (value & 0xFF);
+		value >>= 8;
+	}
+
+	return out;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void Tlm_Init(TlmEncoder_t *enc, const TlmSignal_t *signals, uint8_t count, uint8_t schema)
+{
+	bool delta = enc->delta;
+	uint16_t key_interval = enc->key_interval;
+
+	memset(enc, 0, sizeof(TlmEncoder_t));
+
+	enc->signals = signals;
+	enc->count = (count > TLM_MAX_SIGNALS) ? TLM_MAX_SIGNALS : count;
+	enc->schema = schema & 0x0F;
+
+	/* Mantem a escolha de DELTA entre trocas de esquema */
+	enc->delta = delta;
+	enc->key_interval = (key_interval == 0) ? TLM_DEFAULT_KEY_INTERVAL : key_interval;
+}
+
+void Tlm_SetDelta(TlmEncoder_t *enc, bool delta, uint16_t key_interval)
+{
+	enc->delta = delta;
+	enc->key_interval = (key_interval == 0) ? TLM_DEFAULT_KEY_INTERVAL : key_interval;
+	enc->has_prev = false;
+}
+
+void Tlm_ForceKey(TlmEncoder_t *enc)
+{
+	enc->has_prev = false;
+}
+
+uint16_t Tlm_EncodeSchema(const TlmEncoder_t *enc, uint8_t index, uint8_t *frame)
+{
+	const TlmSignal_t *sig;
+	uint8_t *p = &frame[TLM_HEADER_SIZE];
+	size_t name_len, unit_len;
+	uint32_t scale;
+
+	if (index >= enc->count)
+	{
+		return 0;
+	}
+
+	sig = &enc->signals[index];
+	name_len = strlen(sig->name) + 1;
+	unit_len = strlen(sig->unit) + 1;
+
+	if ((6 + name_len + unit_len) > TLM_MAX_PAYLOAD)
+	{
+		return 0;
+	}
+
+	scale = (uint32_t) sig->scale;
+
+	*p++ = enc->count;
+	*p++ = index;
+	*p++ = (uint8_t) (scale & 0xFF);
+	*p++ = (uint8_t) ((scale >> 8) & 0xFF);
+	*p++ = (uint8_t) ((scale >> 16) & 0xFF);
+	*p++ = (uint8_t) (scale >> 24);
+	memcpy(p, sig->name, name_len);
+	p += name_len;
+	memcpy(p, sig->unit, unit_len);
+	p += unit_len;
+
+	/* O esquema leva a sequencia atual sem consumir um numero dos dados */
+	return Tlm_Seal(enc->schema, TLM_FRAME_SCHEMA, enc->seq, (uint8_t) (p - &frame[TLM_HEADER_SIZE]), frame);
+}
+
+uint16_t Tlm_EncodeSample(TlmEncoder_t *enc, uint32_t timestamp, const int32_t *values, uint8_t *frame)
+{
+	uint8_t *p = &frame[TLM_HEADER_SIZE];
+	TlmFrame_e type;
+	uint8_t i;
+
+	if ((enc->delta == true) && (enc->has_prev == true) && (enc->since_key < enc->key_interval))
+	{
+		type = TLM_FRAME_DELTA;
+		enc->since_key++;
+
+		p += Tlm_PutVarint((int32_t) (timestamp - enc->prev_ts), p);
+		for (i = 0; i < enc->count; i++)
+		{
+			/* Diferenca em 32 bits com wrap: o receptor soma do mesmo jeito */
+			p += Tlm_PutVarint((int32_t) ((uint32_t) values[i] - (uint32_t) enc->prev[i]), p);
+		}
+	}
+	else
+	{
+		type = TLM_FRAME_FULL;
+		enc->since_key = 0;
+
+		*p++ = (uint8_t) (timestamp & 0xFF);
+		*p++ = (uint8_t) ((timestamp >> 8) & 0xFF);
+		*p++ = (uint8_t) ((timestamp >> 16) & 0xFF);
+		*p++ = (uint8_t) (timestamp >> 24);
+		for (i = 0; i < enc->count; i++)
+		{
+			p += Tlm_PutVarint(values[i], p);
+		}
+	}
+
+	memcpy(enc->prev, values, enc->count * sizeof(int32_t));
+	enc->prev_ts = timestamp;
+	enc->has_prev = true;
+
+	/* 4 + 32 * 5 bytes no pior caso: sempre cabe em len */
+	return Tlm_Seal(enc->schema, type, enc->seq++, (uint8_t) (p - &frame[TLM_HEADER_SIZE]), frame);
+}
+
+uint16_t Tlm_EncodeSystem(uint16_t seq, const TlmSystem_t *sys, uint8_t *frame)
+{
+	uint8_t *p = &frame[TLM_HEADER_SIZE];
+
+	p = Tlm_PutLE(sys->timestamp, 4, p);
+	p = Tlm_PutLE(sys->heap_free, 4, p);
+	p = Tlm_PutLE(sys->heap_min, 4, p);
+	p = Tlm_PutLE(sys->load, 2, p);
+	*p++ = sys->tasks;
+
+	return Tlm_Seal(0, TLM_FRAME_SYSTEM, seq, (uint8_t) (p - &frame[TLM_HEADER_SIZE]), frame);
+}
+
+uint16_t Tlm_EncodeTask(uint16_t seq, const TlmTask_t *task, uint8_t *frame)
+{
+	uint8_t *p = &frame[TLM_HEADER_SIZE];
+	size_t name_len = strlen(task->name) + 1;
+
+	if ((9 + name_len) > TLM_MAX_PAYLOAD)
+	{
+		return 0;
+	}
+
+	*p++ = task->index;
+	p = Tlm_PutLE(task->number, 2, p);
+	*p++ = task->state;
+	*p++ = task->priority;
+	p = Tlm_PutLE(task->cpu, 2, p);
+	p = Tlm_PutLE(task->stack_free, 2, p);
+	memcpy(p, task->name, name_len);
+	p += name_len;
+
+	return Tlm_Seal(0, TLM_FRAME_TASK, seq, (uint8_t) (p - &frame[TLM_HEADER_SIZE]), frame);
+}
+
+uint16_t Tlm_Crc16(const uint8_t *data, uint16_t len)
+{
+	uint16_t crc = 0xFFFF;
+	uint8_t bit;
+
+	while (len--)
+	{
+		crc ^= (uint16_t) (*data++) << 8;
+		for (bit = 0; bit < 8; bit++)
+		{
+			crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+		}
+	}
+
+	return crc;
+}
+
+uint8_t Tlm_PutVarint(int32_t value, uint8_t *out)
+{
+	/* zigzag: valores pequenos, positivos ou negativos, viram poucos bytes */
+	uint32_t v = ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+	uint8_t n = 0;
+
+	while (v >= 0x80)
+	{
+		out[n++] = (uint8_t) (v | 0x80);
+		v >>= 7;
+	}
+	out[n++] = (uint8_t) v;
+
+	return n;
+}
+
+bool Tlm_GetVarint(const uint8_t **in, const uint8_t *end, int32_t *value)
+{
+	const uint8_t *p = *in;
+	uint32_t v = 0;
+	uint8_t shift = 0;
+
+	while (p < end)
+	{
+		v |= (uint32_t) (*p & 0x7F) << shift;
+
+		if ((*p++ & 0x80) == 0)
+		{
+			*value = (int32_t) ((v >> 1) ^ (0U - (v & 1U)));
+			*in = p;
+			return true;
+		}
+
+		shift += 7;
+		if (shift >= (7 * TLM_VARINT_MAX))
+		{
+			break;
+		}
+	}
+
+	return false;
+}
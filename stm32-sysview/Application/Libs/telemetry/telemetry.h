@@ -0,0 +1,232 @@
+/**
+ * @file    telemetry.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.2.0
+ * @brief   Quadros binarios de telemetria com esquema, sequencia e CRC
+ * @details
+ * Formato de um quadro (inteiros little-endian):
+ *
+ *   0xA5 0x5A | tipo | len | seq (2) | payload (len) | crc16 (2)
+ *
+ * - tipo: bits 0-3 = TLM_FRAME_*, bits 4-7 = versao do esquema (0-15).
+ * - seq: contador de quadros de dados, permite detectar perdas.
+ * - crc16: CRC-16/CCITT-FALSE de tipo ate o fim do payload.
+ *
+ * Payloads:
+ * - SCHEMA: total (1), indice (1), escala int32 (4), nome\0, unidade\0.
+ *   Um quadro por sinal; o receptor so decodifica dados depois de ter o
+ *   esquema completo da mesma versao.
+ * - FULL: timestamp em ms (4) e os valores absolutos em varint zigzag.
+ * - DELTA: diferenca do timestamp e dos valores para o quadro anterior, em
+ *   varint zigzag. Apos um quadro perdido (seq) o receptor espera o proximo
+ *   FULL.
+ * - SYSTEM: timestamp em ms (4), heap livre (4), menor heap livre (4),
+ *   carga da CPU em permil (2), quantidade de tasks (1). Abre uma foto do
+ *   sistema; seq e o numero da foto, nao o dos dados.
+ * - TASK: indice (1), numero da task (2), estado (1), prioridade (1), CPU no
+ *   intervalo em permil (2), menor folga da pilha em palavras (2), nome\0.
+ *   Um quadro por task com o seq do SYSTEM da mesma foto.
+ *
+ * Os valores sao os inteiros do registro de sensores; valor / escala da a
+ * grandeza na unidade do sinal. O codigo e C puro para ser usado tambem pelo
+ * decodificador do PC (Tools/telemetry).
+ */
+
+#ifndef _TELEMETRY_H_
+#define _TELEMETRY_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define TLM_SYNC0				0xA5
+#define TLM_SYNC1				0x5A
+
+/** @brief Bytes de sincronismo, tipo, len e seq */
+#define TLM_HEADER_SIZE			6
+
+/** @brief Bytes do CRC */
+#define TLM_CRC_SIZE			2
+
+/** @brief Sinais maximos de um esquema (mascara de 32 bits) */
+#define TLM_MAX_SIGNALS			32
+
+/** @brief Payload maximo (len e um byte) */
+#define TLM_MAX_PAYLOAD			255
+
+/** @brief Tamanho maximo de um quadro */
+#define TLM_MAX_FRAME			(TLM_HEADER_SIZE + TLM_MAX_PAYLOAD + TLM_CRC_SIZE)
+
+/** @brief Bytes maximos de um varint de 32 bits */
+#define TLM_VARINT_MAX			5
+
+/** @brief Intervalo padrao entre quadros FULL */
+#define TLM_DEFAULT_KEY_INTERVAL	50
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Tipo de quadro (bits 0-3 do byte de tipo) */
+typedef enum
+{
+	TLM_FRAME_SCHEMA = 1,
+	TLM_FRAME_FULL,
+	TLM_FRAME_DELTA,
+	TLM_FRAME_SYSTEM,
+	TLM_FRAME_TASK
+} TlmFrame_e;
+
+/** @brief Descricao de um sinal */
+typedef struct
+{
+	const char *name;
+	const char *unit;
+	int32_t scale;      /**< LSB por unidade */
+} TlmSignal_t;
+
+/** @brief Cabecalho de uma foto do sistema (quadro SYSTEM) */
+typedef struct
+{
+	uint32_t timestamp;         /**< ms */
+	uint32_t heap_free;
+	uint32_t heap_min;
+	uint16_t load;              /**< Permil */
+	uint8_t tasks;              /**< Quadros TASK da foto */
+} TlmSystem_t;
+
+/** @brief Uma task da foto (quadro TASK) */
+typedef struct
+{
+	const char *name;
+	uint16_t number;            /**< Numero unico da task no kernel */
+	uint16_t cpu;               /**< Permil do intervalo */
+	uint16_t stack_free;        /**< Palavras */
+	uint8_t index;
+	uint8_t state;              /**< eTaskState */
+	uint8_t priority;
+} TlmTask_t;
+
+/** @brief Estado do codificador */
+typedef struct
+{
+	const TlmSignal_t *signals;
+	uint8_t count;
+	uint8_t schema;            /**< Versao do esquema (0-15) */
+	uint16_t seq;
+	bool delta;                /**< Usa quadros DELTA entre os FULL */
+	uint16_t key_interval;     /**< Quadros entre dois FULL */
+	uint16_t since_key;
+	bool has_prev;
+	uint32_t prev_ts;
+	int32_t prev[TLM_MAX_SIGNALS];
+} TlmEncoder_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Inicia o codificador para uma lista de sinais.
+ * @param enc Codificador.
+ * @param signals Sinais, na ordem em que os valores serao passados.
+ * @param count Quantidade de sinais (ate TLM_MAX_SIGNALS).
+ * @param schema Versao do esquema; deve mudar quando a lista mudar.
+ */
+void Tlm_Init(TlmEncoder_t *enc, const TlmSignal_t *signals, uint8_t count, uint8_t schema);
+
+/**
+ * Habilita ou desabilita os quadros DELTA.
+ * @param enc Codificador.
+ * @param delta true para codificar diferencas entre quadros FULL.
+ * @param key_interval Quadros entre dois FULL (0 = padrao).
+ */
+void Tlm_SetDelta(TlmEncoder_t *enc, bool delta, uint16_t key_interval);
+
+/**
+ * Obriga o proximo quadro de dados a ser FULL (ex.: apos descartar um quadro).
+ * @param enc Codificador.
+ */
+void Tlm_ForceKey(TlmEncoder_t *enc);
+
+/**
+ * Monta o quadro de esquema de um sinal.
+ * @param enc Codificador.
+ * @param index Indice do sinal.
+ * @param frame Saida com pelo menos TLM_MAX_FRAME bytes.
+ * @return Tamanho do quadro ou 0 se nao couber.
+ */
+uint16_t Tlm_EncodeSchema(const TlmEncoder_t *enc, uint8_t index, uint8_t *frame);
+
+/**
+ * Monta um quadro de dados (FULL ou DELTA).
+ * @param enc Codificador.
+ * @param timestamp Tempo da amostra em ms.
+ * @param values count valores na ordem dos sinais.
+ * @param frame Saida com pelo menos TLM_MAX_FRAME bytes.
+ * @return Tamanho do quadro.
+ */
+uint16_t Tlm_EncodeSample(TlmEncoder_t *enc, uint32_t timestamp, const int32_t *values, uint8_t *frame);
+
+/**
+ * Monta o quadro SYSTEM que abre uma foto do sistema.
+ * @param seq Numero da foto.
+ * @param sys Cabecalho.
+ * @param frame Saida com pelo menos TLM_MAX_FRAME bytes.
+ * @return Tamanho do quadro.
+ */
+uint16_t Tlm_EncodeSystem(uint16_t seq, const TlmSystem_t *sys, uint8_t *frame);
+
+/**
+ * Monta o quadro de uma task da foto.
+ * @param seq Numero da foto (o mesmo do SYSTEM).
+ * @param task Task.
+ * @param frame Saida com pelo menos TLM_MAX_FRAME bytes.
+ * @return Tamanho do quadro ou 0 se o nome nao couber.
+ */
+uint16_t Tlm_EncodeTask(uint16_t seq, const TlmTask_t *task, uint8_t *frame);
+
+/**
+ * CRC-16/CCITT-FALSE (poly 0x1021, inicial 0xFFFF).
+ * @param data Bytes.
+ * @param len Quantidade.
+ * @return CRC.
+ */
+uint16_t Tlm_Crc16(const uint8_t *data, uint16_t len);
+
+/**
+ * Escreve um inteiro com sinal em varint zigzag.
+ * @param value Valor.
+ * @param out Saida com pelo menos TLM_VARINT_MAX bytes.
+ * @return Bytes escritos.
+ */
+uint8_t Tlm_PutVarint(int32_t value, uint8_t *out);
+
+/**
+ * Le um varint zigzag.
+ * @param in Entrada; avanca ate o fim do varint.
+ * @param end Fim da entrada.
+ * @param value Valor lido.
+ * @return true se o varint estava completo.
+ */
+bool Tlm_GetVarint(const uint8_t **in, const uint8_t *end, int32_t *value);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TELEMETRY_H_ */
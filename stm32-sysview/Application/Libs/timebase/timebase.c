@@ -0,0 +1,103 @@
+/**
+ * @file    timebase.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.3.0
+ * @brief   Base de tempo de 64 bits sobre o contador de ciclos do DWT
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "timebase.h"
+#include "setup_hw.h"
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Ultima leitura do CYCCNT e voltas acumuladas (bits 63..32) */
+static uint32_t tbLast = 0;
+static uint64_t tbHigh = 0;
+
+static uint32_t tbHz = 0;
+static uint32_t tbMhz = 1;
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void Timebase_Init(void)
+{
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	tbHz = SystemCoreClock;
+	tbMhz = (tbHz >= 1000000UL) ? (tbHz / 1000000UL) : 1;
+
+	/* O SystemView tambem carimba os eventos pelo CYCCNT: o contador nao e zerado */
+	Timebase_Update();
+}
+
+uint64_t Timebase_Cycles(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint64_t cycles;
+	uint32_t now;
+
+	__disable_irq();
+
+	now = DWT->CYCCNT;
+	if (now < tbLast)
+	{
+		tbHigh += 0x100000000ULL;
+	}
+	tbLast = now;
+	cycles = tbHigh | now;
+
+	__set_PRIMASK(primask);
+
+	return cycles;
+}
+
+uint64_t Timebase_Us(void)
+{
+	return Timebase_Cycles() / tbMhz;
+}
+
+uint64_t Timebase_CyclesToUs(uint64_t cycles)
+{
+	return cycles / tbMhz;
+}
+
+uint32_t Timebase_Hz(void)
+{
+	return tbHz;
+}
+
+uint32_t Timebase_Cycles32(void)
+{
+	return DWT->CYCCNT;
+}
+
+uint32_t Timebase_RunTime(void)
+{
+	return (uint32_t) (Timebase_Cycles() >> TIMEBASE_RUNTIME_SHIFT);
+}
+
+uint32_t Timebase_RunTimeHz(void)
+{
+	return tbHz >> TIMEBASE_RUNTIME_SHIFT;
+}
+
+void Timebase_Update(void)
+{
+	(void) Timebase_Cycles();
+}
+
+void Timebase_Correct(uint32_t start, uint32_t elapsed)
+{
+	/* So para frente: a extensao de 64 bits ve a volta na proxima leitura */
+	DWT->CYCCNT = start + elapsed;
+}
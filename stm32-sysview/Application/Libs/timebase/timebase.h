@@ -0,0 +1,113 @@
+/**
+ * @file    timebase.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.3.0
+ * @brief   Base de tempo de 64 bits sobre o contador de ciclos do DWT
+ * @details
+ * O CYCCNT tem 32 bits e da a volta em 53.7 s a 80 MHz. Timebase_Cycles
+ * guarda a ultima leitura e soma 2^32 quando o contador volta, entao basta
+ * uma chamada por volta para a extensao nao perder uma: a task default
+ * chama Timebase_Update a cada segundo. A leitura e feita com as
+ * interrupcoes mascaradas (PRIMASK salvo e restaurado), podendo ser usada
+ * em task ou interrupcao.
+ *
+ * E a referencia dos carimbos de tempo das amostras e da sincronizacao com
+ * o PC (app_timesync), das estatisticas de tempo de execucao do FreeRTOS
+ * (Timebase_RunTime) e das medidas de ciclos das apps (Timebase_Cycles32).
+ * O SystemView carimba os eventos com o mesmo CYCCNT. Nenhum deles usa
+ * interrupcao periodica. O clock do core deve ser multiplo de 1 MHz.
+ *
+ * Em STOP2 o core para e o CYCCNT junto: quem sai do STOP2 mede o tempo
+ * parado por outro relogio (o LPTIM1 no LSE) e chama Timebase_Correct,
+ * que adianta o contador como se ele tivesse continuado contando.
+ */
+
+#ifndef _TIMEBASE_H_
+#define _TIMEBASE_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/**
+ * @brief Ciclos por contagem das estatisticas do FreeRTOS, em bits: 64 ciclos
+ * (0.8 us a 80 MHz). Os contadores do FreeRTOS 10.0.1 sao de 32 bits e com
+ * isso dao a volta em 57 min; com ciclo inteiro dariam em 53 s.
+ */
+#define TIMEBASE_RUNTIME_SHIFT		6
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Liga o DWT CYCCNT (sem zerar) e guarda o clock do core (SystemCoreClock). */
+void Timebase_Init(void);
+
+/**
+ * Ciclos do core em 64 bits (origem no ultimo reset do CYCCNT).
+ * @return Ciclos.
+ */
+uint64_t Timebase_Cycles(void);
+
+/**
+ * Microssegundos na mesma origem de Timebase_Cycles.
+ * @return Tempo em us.
+ */
+uint64_t Timebase_Us(void);
+
+/**
+ * Converte ciclos em microssegundos no clock atual.
+ * @param cycles Ciclos.
+ * @return Tempo em us (arredondado para baixo).
+ */
+uint64_t Timebase_CyclesToUs(uint64_t cycles);
+
+/** @brief Frequencia do contador em Hz. */
+uint32_t Timebase_Hz(void);
+
+/**
+ * CYCCNT de 32 bits, sem a extensao: para medir trechos de ate 53 s, com
+ * fim - inicio em uint32_t (a volta se cancela).
+ * @return Ciclos.
+ */
+uint32_t Timebase_Cycles32(void);
+
+/**
+ * Contador das estatisticas de tempo de execucao do FreeRTOS
+ * (portGET_RUN_TIME_COUNTER_VALUE): Timebase_Cycles >> TIMEBASE_RUNTIME_SHIFT.
+ * @return Contagens em Timebase_RunTimeHz.
+ */
+uint32_t Timebase_RunTime(void);
+
+/** @brief Frequencia de Timebase_RunTime em Hz. */
+uint32_t Timebase_RunTimeHz(void);
+
+/** @brief Mantem a extensao de 64 bits; chamar pelo menos uma vez a cada 50 s. */
+void Timebase_Update(void);
+
+/**
+ * Recoloca o CYCCNT depois de um periodo com o core parado. Chamar com as
+ * interrupcoes mascaradas; o periodo deve ser menor que a volta (53 s).
+ * @param start CYCCNT (Timebase_Cycles32) no inicio do periodo.
+ * @param elapsed Duracao real do periodo em ciclos.
+ */
+void Timebase_Correct(uint32_t start, uint32_t elapsed);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TIMEBASE_H_ */
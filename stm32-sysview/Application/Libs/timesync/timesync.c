@@ -0,0 +1,177 @@
+/**
+ * @file    timesync.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Estimativa de offset e drift entre dois relogios por trocas de ida e volta
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "timesync.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Ajusta a reta nas trocas de menor atraso da janela.
+ * @param ts Estado.
+ */
+static void TSync_Fit(TSync_t *ts);
+
+/** @brief Arredonda para o inteiro mais proximo. */
+static int64_t TSync_Round(double x);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void TSync_Fit(TSync_t *ts)
+{
+	uint8_t order[TSYNC_WINDOW] = { 0 };
+	const TSyncSample_t *s;
+	TSyncEstimate_t est;
+	double x, y, r, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, sr = 0.0, dmax = 0.0;
+	uint8_t i, j, k, newest;
+
+	memset(&est, 0, sizeof(est));
+
+	/* Indices em ordem de atraso (insercao: no maximo TSYNC_WINDOW) */
+	for (i = 0; i < ts->count; i++)
+	{
+		for (j = i; (j > 0) && (ts->window[order[j - 1]].delay > ts->window[i].delay); j--)
+		{
+			order[j] = order[j - 1];
+		}
+		order[j] = i;
+	}
+
+	est.used = (uint8_t) ((ts->count + 1) / 2);
+	if ((est.used < 2) && (ts->count >= 2))
+	{
+		est.used = 2;
+	}
+
+	/* Origem na troca mais nova: as conversoes ficam perto dela */
+	newest = (uint8_t) ((ts->next + TSYNC_WINDOW - 1) % TSYNC_WINDOW);
+	est.ref_us = ts->window[newest].mid;
+	est.delay_us = ts->window[order[0]].delay;
+
+	for (k = 0; k < est.used; k++)
+	{
+		s = &ts->window[order[k]];
+		x = (double) (s->mid - est.ref_us);
+		sx += x;
+		sy += s->offset;
+		sxx += x * x;
+		sxy += x * s->offset;
+		dmax = (s->delay > dmax) ? s->delay : dmax;
+	}
+
+	x = sx / est.used;
+	y = sy / est.used;
+
+	/* Uma troca so, ou todas no mesmo instante: sem drift */
+	if ((est.used >= 2) && ((sxx - sx * x) > 0.0))
+	{
+		est.drift = (sxy - sx * y) / (sxx - sx * x);
+	}
+	est.offset_us = y - est.drift * x;
+
+	for (k = 0; k < est.used; k++)
+	{
+		s = &ts->window[order[k]];
+		r = s->offset - (est.offset_us + est.drift * (double) (s->mid - est.ref_us));
+		sr += r * r;
+	}
+
+	/* Cada troca usada erra ate metade do seu atraso; a reta nao passa disso mais o espalhamento */
+	est.error_us = dmax / 2.0 + sqrt(sr / est.used);
+	est.valid = true;
+
+	ts->est = est;
+}
+
+static int64_t TSync_Round(double x)
+{
+	return (int64_t) ((x >= 0.0) ? (x + 0.5) : (x - 0.5));
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void TSync_Init(TSync_t *ts, uint32_t baud)
+{
+	memset(ts, 0, sizeof(TSync_t));
+	ts->baud = baud;
+}
+
+double TSync_SerialUs(uint32_t baud, uint32_t bytes)
+{
+	if (baud == 0)
+	{
+		return 0.0;
+	}
+
+	return (double) bytes * TSYNC_BITS_PER_BYTE * 1e6 / (double) baud;
+}
+
+bool TSync_Add(TSync_t *ts, int64_t t1, int64_t t2, int64_t t3, int64_t t4, uint32_t req_bytes,
+		uint32_t rep_bytes)
+{
+	TSyncSample_t *s;
+	double req = TSync_SerialUs(ts->baud, req_bytes);
+	double rep = TSync_SerialUs(ts->baud, rep_bytes);
+	double delay;
+
+	if ((t4 < t1) || (t3 < t2))
+	{
+		ts->rejected++;
+		return false;
+	}
+
+	/* A serializacao estimada pode passar um pouco do medido: atraso nunca negativo */
+	delay = (double) ((t4 - t1) - (t3 - t2)) - req - rep;
+	if (delay < 0.0)
+	{
+		delay = 0.0;
+	}
+
+	s = &ts->window[ts->next];
+	s->mid = t1 + (t4 - t1) / 2;
+
+	/* O pedido termina de chegar em t1 + req e a resposta comeca a sair em t4 - rep */
+	s->offset = ((double) ((t2 - t1) + (t3 - t4)) - req + rep) / 2.0;
+	s->delay = delay;
+
+	ts->next = (uint8_t) ((ts->next + 1) % TSYNC_WINDOW);
+	if (ts->count < TSYNC_WINDOW)
+	{
+		ts->count++;
+	}
+	ts->exchanges++;
+
+	TSync_Fit(ts);
+
+	return true;
+}
+
+int64_t TSync_DevToRef(const TSyncEstimate_t *est, int64_t dev_us)
+{
+	/* dev = ref + offset + drift * (ref - ref_us), resolvido para ref */
+	return est->ref_us + TSync_Round(((double) (dev_us - est->ref_us) - est->offset_us) / (1.0 + est->drift));
+}
+
+int64_t TSync_RefToDev(const TSyncEstimate_t *est, int64_t ref_us)
+{
+	double x = (double) (ref_us - est->ref_us);
+
+	return ref_us + TSync_Round(est->offset_us + est->drift * x);
+}
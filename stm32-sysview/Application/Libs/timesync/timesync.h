@@ -0,0 +1,145 @@
+/**
+ * @file    timesync.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Estimativa de offset e drift entre dois relogios por trocas de ida e volta
+ * @details
+ * Cada troca da quatro instantes, como no NTP: t1 (referencia envia o
+ * pedido), t2 (dispositivo recebe), t3 (dispositivo envia a resposta) e
+ * t4 (referencia recebe), todos em us no relogio de quem mediu. Numa serial
+ * t1 e t3 sao o inicio do primeiro byte e t2 e t4 o fim do ultimo: o tempo
+ * de serializacao (10 bits por byte no baud rate) sai do atraso e do offset.
+ *
+ *   atraso = (t4 - t1) - (t3 - t2) - serializacao
+ *   offset = ((t2 - t1) + (t3 - t4)) / 2     (dispositivo - referencia)
+ *
+ * Se a ida e a volta nao tem o mesmo atraso, o offset de uma troca erra no
+ * maximo metade do atraso. A janela guarda as ultimas TSYNC_WINDOW trocas;
+ * a reta offset(t) = offset + drift * (t - ref_us) e ajustada por minimos
+ * quadrados na metade com menor atraso (as trocas que sofreram fila ou
+ * preempcao ficam de fora). O erro informado e metade do maior atraso
+ * usado mais o desvio RMS da reta.
+ *
+ * Tambem serve para um relogio lido por barramento (o timestamp do
+ * LSM6DSL): t1 e t4 antes e depois da leitura, t2 = t3 = valor lido.
+ * O codigo e C puro para ser usado tambem pela ferramenta do PC
+ * (Tools/timesync).
+ */
+
+#ifndef _TIMESYNC_H_
+#define _TIMESYNC_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Trocas guardadas para o ajuste */
+#define TSYNC_WINDOW			16
+
+/** @brief Bits por byte na serial (8N1) */
+#define TSYNC_BITS_PER_BYTE		10
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Uma troca ja reduzida */
+typedef struct
+{
+	int64_t mid;            /**< Meio da troca no relogio de referencia (us) */
+	double offset;          /**< Dispositivo - referencia (us) */
+	double delay;           /**< Ida e volta sem serializacao e sem o tempo no dispositivo (us) */
+} TSyncSample_t;
+
+/** @brief Reta ajustada; copiavel para quem so converte */
+typedef struct
+{
+	bool valid;
+	int64_t ref_us;         /**< Origem da reta no relogio de referencia */
+	double offset_us;       /**< Dispositivo - referencia em ref_us */
+	double drift;           /**< Variacao do offset por us de referencia (1e-6 = 1 ppm) */
+	double error_us;        /**< Erro estimado de uma conversao */
+	double delay_us;        /**< Menor atraso da janela */
+	uint8_t used;           /**< Trocas usadas no ajuste */
+} TSyncEstimate_t;
+
+/** @brief Estado do estimador */
+typedef struct
+{
+	TSyncSample_t window[TSYNC_WINDOW];
+	uint8_t count;
+	uint8_t next;
+	uint32_t baud;          /**< 0 = sem tempo de serializacao */
+	uint32_t exchanges;     /**< Trocas aceitas */
+	uint32_t rejected;      /**< Trocas com instantes fora de ordem */
+	TSyncEstimate_t est;
+} TSync_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Inicia o estimador sem trocas.
+ * @param ts Estado.
+ * @param baud Baud rate do enlace, ou 0 quando nao ha serializacao.
+ */
+void TSync_Init(TSync_t *ts, uint32_t baud);
+
+/**
+ * Tempo para transmitir bytes na serial.
+ * @param baud Baud rate (0 = instantaneo).
+ * @param bytes Bytes.
+ * @return Tempo em us.
+ */
+double TSync_SerialUs(uint32_t baud, uint32_t bytes);
+
+/**
+ * Acrescenta uma troca e refaz o ajuste.
+ * @param ts Estado.
+ * @param t1 Envio do pedido (referencia, us).
+ * @param t2 Recepcao do pedido (dispositivo, us).
+ * @param t3 Envio da resposta (dispositivo, us).
+ * @param t4 Recepcao da resposta (referencia, us).
+ * @param req_bytes Tamanho do pedido na serial.
+ * @param rep_bytes Tamanho da resposta na serial.
+ * @return false se a troca foi descartada.
+ */
+bool TSync_Add(TSync_t *ts, int64_t t1, int64_t t2, int64_t t3, int64_t t4, uint32_t req_bytes,
+		uint32_t rep_bytes);
+
+/**
+ * Converte um instante do dispositivo para o relogio de referencia.
+ * @param est Reta ajustada (valid).
+ * @param dev_us Instante no dispositivo.
+ * @return Instante na referencia.
+ */
+int64_t TSync_DevToRef(const TSyncEstimate_t *est, int64_t dev_us);
+
+/**
+ * Converte um instante da referencia para o relogio do dispositivo.
+ * @param est Reta ajustada (valid).
+ * @param ref_us Instante na referencia.
+ * @return Instante no dispositivo.
+ */
+int64_t TSync_RefToDev(const TSyncEstimate_t *est, int64_t ref_us);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _TIMESYNC_H_ */
@@ -0,0 +1,299 @@
+/**
+ * @file    vibration.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Caracteristicas de vibracao a partir de quadros do acelerometro
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "vibration.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define VIB_2PI					6.28318530717959f
+
+/** @brief Bins de cada lado do pico somados no RMS do pico */
+#define VIB_PEAK_SPAN			2
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * cos(2*pi*k/n) pelas twiddles do plano.
+ * @param vib Estado.
+ * @param k Indice (reduzido modulo n).
+ */
+static float Vib_Cos(const Vib_t *vib, uint32_t k);
+
+/**
+ * Coeficiente da janela (periodica) na amostra i.
+ * @param vib Estado.
+ * @param i Indice da amostra.
+ */
+static float Vib_Window(const Vib_t *vib, uint16_t i);
+
+/**
+ * Maiores maximos locais da potencia, em ordem decrescente.
+ * @param power n/2 bins.
+ * @param half Quantidade de bins.
+ * @param bins Saida com VIB_MAX_PEAKS indices (0 sem pico).
+ */
+static void Vib_FindPeaks(const float *power, uint16_t half, uint16_t *bins);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static float Vib_Cos(const Vib_t *vib, uint32_t k)
+{
+	uint32_t n = vib->plan.n;
+
+	k %= n;
+
+	/* A tabela tem k < n/2; a outra metade e simetrica: cos(x + pi) = -cos(x) */
+	return (k < n / 2) ? vib->plan.twiddle[2 * k] : -vib->plan.twiddle[2 * (k - n / 2)];
+}
+
+static float Vib_Window(const Vib_t *vib, uint16_t i)
+{
+	switch (vib->window)
+	{
+	case FFT_WINDOW_HANN:
+		return 0.5f - 0.5f * Vib_Cos(vib, i);
+
+	case FFT_WINDOW_HAMMING:
+		return 0.54f - 0.46f * Vib_Cos(vib, i);
+
+	case FFT_WINDOW_BLACKMAN:
+		return 0.42f - 0.5f * Vib_Cos(vib, i) + 0.08f * Vib_Cos(vib, 2UL * i);
+
+	default:
+		return 1.0f;
+	}
+}
+
+static void Vib_FindPeaks(const float *power, uint16_t half, uint16_t *bins)
+{
+	uint16_t k;
+	int8_t j;
+
+	memset(bins, 0, VIB_MAX_PEAKS * sizeof(uint16_t));
+
+	/* Bins 0 e 1 ficam com o vazamento do DC removido */
+	for (k = 2; k + 1 < half; k++)
+	{
+		if ((power[k] <= power[k - 1]) || (power[k] < power[k + 1]) || (power[k] <= 0.0f))
+		{
+			continue;
+		}
+
+		/* Insercao na lista ordenada, descartando o menor */
+		for (j = VIB_MAX_PEAKS - 1; j >= 0; j--)
+		{
+			if ((bins[j] != 0) && (power[bins[j]] >= power[k]))
+			{
+				break;
+			}
+
+			if (j < VIB_MAX_PEAKS - 1)
+			{
+				bins[j + 1] = bins[j];
+			}
+		}
+
+		if (j < VIB_MAX_PEAKS - 1)
+		{
+			bins[j + 1] = k;
+		}
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+bool Vib_Init(Vib_t *vib, uint16_t n, float rate_hz, FftWindow_e window, float *work)
+{
+	float w, sum = 0.0f;
+	uint16_t i;
+
+	if ((n < VIB_MIN_SIZE) || (n > VIB_MAX_SIZE) || (rate_hz <= 0.0f))
+	{
+		return false;
+	}
+
+	memset(vib, 0, sizeof(Vib_t));
+
+	if (Fft_Init(&vib->plan, n, work + n) == false)
+	{
+		return false;
+	}
+
+	vib->frame = work;
+	vib->rate_hz = rate_hz;
+	vib->window = window;
+
+	for (i = 0; i < n; i++)
+	{
+		w = Vib_Window(vib, i);
+		sum += w * w;
+	}
+	vib->wpower = sum / (float) n;
+
+	Vib_SetVelocityBand(vib, VIB_DEF_VELOCITY_LO_HZ, VIB_DEF_VELOCITY_HI_HZ);
+
+	return true;
+}
+
+bool Vib_SetBands(Vib_t *vib, const VibBand_t *bands, uint8_t count)
+{
+	uint8_t i;
+
+	if (count > VIB_MAX_BANDS)
+	{
+		return false;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if ((bands[i].lo_hz < 0.0f) || (bands[i].hi_hz <= bands[i].lo_hz))
+		{
+			return false;
+		}
+	}
+
+	memcpy(vib->bands, bands, count * sizeof(VibBand_t));
+	vib->num_bands = count;
+
+	return true;
+}
+
+bool Vib_SetVelocityBand(Vib_t *vib, float lo_hz, float hi_hz)
+{
+	float nyquist = 0.5f * vib->rate_hz;
+
+	if ((lo_hz <= 0.0f) || (hi_hz <= lo_hz) || (lo_hz >= nyquist))
+	{
+		return false;
+	}
+
+	vib->velocity.lo_hz = lo_hz;
+	vib->velocity.hi_hz = (hi_hz > nyquist) ? nyquist : hi_hz;
+
+	return true;
+}
+
+float *Vib_Frame(Vib_t *vib)
+{
+	return vib->frame;
+}
+
+void Vib_Process(Vib_t *vib, VibResult_t *result)
+{
+	float *x = vib->frame;
+	uint16_t n = vib->plan.n;
+	uint16_t half = n / 2;
+	uint16_t bins[VIB_MAX_PEAKS];
+	float band[VIB_MAX_BANDS];
+	float mean = 0.0f, total = 0.0f, vel = 0.0f;
+	float norm, df, f, ms, w;
+	float lm, l0, lp, d;
+	uint16_t i, k, lo, hi;
+	uint8_t b;
+
+	memset(result, 0, sizeof(VibResult_t));
+	memset(band, 0, sizeof(band));
+
+	for (i = 0; i < n; i++)
+	{
+		mean += x[i];
+	}
+	mean /= (float) n;
+
+	for (i = 0; i < n; i++)
+	{
+		x[i] = (x[i] - mean) * Vib_Window(vib, i);
+	}
+
+	/* Espectro empacotado e potencia por bin no proprio quadro */
+	Fft_Real(&vib->plan, x);
+	Fft_Power(&vib->plan, x, x);
+
+	/* Soma de um lado do espectro -> media quadratica no tempo */
+	norm = 2.0f / ((float) n * (float) n * vib->wpower);
+	df = vib->rate_hz / (float) n;
+	result->resolution_hz = df;
+
+	for (k = 1; k < half; k++)
+	{
+		ms = x[k] * norm;
+		f = (float) k * df;
+
+		total += ms;
+
+		for (b = 0; b < vib->num_bands; b++)
+		{
+			if ((f >= vib->bands[b].lo_hz) && (f < vib->bands[b].hi_hz))
+			{
+				band[b] += ms;
+			}
+		}
+
+		/* Integracao no dominio da frequencia: v = a / (2*pi*f) */
+		if ((f >= vib->velocity.lo_hz) && (f <= vib->velocity.hi_hz))
+		{
+			w = VIB_2PI * f;
+			vel += ms / (w * w);
+		}
+	}
+
+	result->rms = sqrtf(total);
+	result->velocity_rms = 1000.0f * sqrtf(vel);
+
+	for (b = 0; b < vib->num_bands; b++)
+	{
+		result->band_rms[b] = sqrtf(band[b]);
+	}
+
+	Vib_FindPeaks(x, half, bins);
+
+	for (b = 0; b < VIB_MAX_PEAKS; b++)
+	{
+		k = bins[b];
+		if (k == 0)
+		{
+			break;
+		}
+
+		/* Interpolacao gaussiana: erro pequeno no lobulo principal de Hann */
+		d = 0.0f;
+		if ((x[k - 1] > 0.0f) && (x[k + 1] > 0.0f))
+		{
+			lm = logf(x[k - 1]);
+			l0 = logf(x[k]);
+			lp = logf(x[k + 1]);
+			d = 2.0f * l0 - lm - lp;
+			d = (d > 0.0f) ? 0.5f * (lp - lm) / d : 0.0f;
+		}
+		result->peak_hz[b] = ((float) k + d) * df;
+
+		lo = (k > VIB_PEAK_SPAN) ? (k - VIB_PEAK_SPAN) : 1;
+		hi = (k + VIB_PEAK_SPAN < half) ? (k + VIB_PEAK_SPAN) : (half - 1);
+
+		for (ms = 0.0f, i = lo; i <= hi; i++)
+		{
+			ms += x[i];
+		}
+		result->peak_rms[b] = sqrtf(ms * norm);
+	}
+}
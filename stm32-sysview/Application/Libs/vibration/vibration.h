@@ -0,0 +1,150 @@
+/**
+ * @file    vibration.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Caracteristicas de vibracao a partir de quadros do acelerometro
+ * @details
+ * Um quadro de n amostras (m/s2) passa por:
+ *
+ *   remocao de DC  -> media do quadro (gravidade e offset)
+ *   janela         -> Hann, Hamming ou Blackman calculada das twiddles da
+ *                     FFT, sem buffer proprio
+ *   espectro       -> Fft_Real e potencia por bin, no proprio quadro
+ *
+ * e so as caracteristicas saem, normalizadas pela potencia da janela para
+ * que a soma dos bins de uma senoide de amplitude A de A / sqrt(2):
+ *
+ *   RMS total      -> todos os bins sem o DC, ate Nyquist
+ *   bandas         -> RMS em ate VIB_MAX_BANDS faixas [lo, hi) em Hz
+ *   picos          -> os VIB_MAX_PEAKS maiores maximos locais, frequencia
+ *                     interpolada (gaussiana sobre tres bins) e RMS de +-2 bins
+ *   velocidade RMS -> cada bin dividido por (2*pi*f)^2 dentro de uma faixa
+ *                     (padrao 10 a 1000 Hz, como na ISO 10816), em mm/s
+ *
+ * C puro, sem HAL: roda na task de vibracao e no PC (Tools/vibration). A
+ * memoria vem do chamador (VIB_WORK_SIZE floats: quadro e twiddles).
+ */
+
+#ifndef _VIBRATION_H_
+#define _VIBRATION_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "fft/fft.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Floats de trabalho: quadro e twiddles */
+#define VIB_WORK_SIZE(n)			(2 * (n))
+
+#define VIB_MIN_SIZE				256
+#define VIB_MAX_SIZE				2048
+
+#define VIB_MAX_BANDS				4
+#define VIB_MAX_PEAKS				3
+
+/** @brief Faixa padrao da velocidade RMS */
+#define VIB_DEF_VELOCITY_LO_HZ		10.0f
+#define VIB_DEF_VELOCITY_HI_HZ		1000.0f
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Faixa de frequencias [lo, hi) */
+typedef struct
+{
+	float lo_hz;
+	float hi_hz;
+} VibBand_t;
+
+/** @brief Caracteristicas de um quadro */
+typedef struct
+{
+	float resolution_hz;                /**< Largura de um bin */
+	float rms;                          /**< m/s2, sem o DC */
+	float band_rms[VIB_MAX_BANDS];      /**< m/s2 */
+	float peak_hz[VIB_MAX_PEAKS];       /**< 0 sem pico */
+	float peak_rms[VIB_MAX_PEAKS];      /**< m/s2 */
+	float velocity_rms;                 /**< mm/s */
+} VibResult_t;
+
+/** @brief Configuracao e estado */
+typedef struct
+{
+	FftPlan_t plan;
+	float *frame;           /**< n amostras em m/s2; processado no lugar */
+	float rate_hz;
+	FftWindow_e window;
+	float wpower;           /**< Media de w^2 */
+	uint8_t num_bands;
+	VibBand_t bands[VIB_MAX_BANDS];
+	VibBand_t velocity;
+} Vib_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Prepara a analise de quadros de n amostras.
+ * @param vib Estado.
+ * @param n Potencia de 2 entre VIB_MIN_SIZE e VIB_MAX_SIZE.
+ * @param rate_hz Taxa de amostragem.
+ * @param window Janela.
+ * @param work VIB_WORK_SIZE(n) floats.
+ * @return false se n ou a taxa forem invalidos.
+ */
+bool Vib_Init(Vib_t *vib, uint16_t n, float rate_hz, FftWindow_e window, float *work);
+
+/**
+ * Troca as bandas de energia.
+ * @param vib Estado.
+ * @param bands Faixas.
+ * @param count Ate VIB_MAX_BANDS.
+ * @return false se alguma faixa for invalida.
+ */
+bool Vib_SetBands(Vib_t *vib, const VibBand_t *bands, uint8_t count);
+
+/**
+ * Troca a faixa da velocidade RMS.
+ * @param vib Estado.
+ * @param lo_hz Inicio (maior que zero).
+ * @param hi_hz Fim, limitado a Nyquist.
+ * @return false se a faixa for invalida.
+ */
+bool Vib_SetVelocityBand(Vib_t *vib, float lo_hz, float hi_hz);
+
+/**
+ * Quadro a preencher com n amostras antes de Vib_Process.
+ * @param vib Estado.
+ * @return Ponteiro para n floats.
+ */
+float *Vib_Frame(Vib_t *vib);
+
+/**
+ * Processa o quadro (destruindo as amostras) e calcula as caracteristicas.
+ * @param vib Estado.
+ * @param result Saida.
+ */
+void Vib_Process(Vib_t *vib, VibResult_t *result);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _VIBRATION_H_ */
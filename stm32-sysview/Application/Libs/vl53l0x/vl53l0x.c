@@ -0,0 +1,908 @@
+/**
+ * @file    vl53l0x.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Driver enxuto do sensor de distancia por tempo de voo VL53L0X
+ * @details
+ * A sequencia de inicializacao e as contas de timeout seguem a API da ST
+ * (VL53L0X_DataInit, StaticInit e PerformRefCalibration), sem as camadas
+ * de plataforma e sem os perfis que a placa nao usa.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "vl53l0x.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Custos fixos da sequencia de medida em us (API da ST) */
+#define VL53L0X_START_OVERHEAD_GET		1910
+#define VL53L0X_START_OVERHEAD_SET		1320
+#define VL53L0X_END_OVERHEAD			960
+#define VL53L0X_MSRC_OVERHEAD			660
+#define VL53L0X_TCC_OVERHEAD			590
+#define VL53L0X_DSS_OVERHEAD			690
+#define VL53L0X_PRE_RANGE_OVERHEAD		660
+#define VL53L0X_FINAL_RANGE_OVERHEAD	550
+
+/** @brief Bits de SYSTEM_SEQUENCE_CONFIG */
+#define VL53L0X_SEQ_TCC					0x10
+#define VL53L0X_SEQ_DSS					0x08
+#define VL53L0X_SEQ_MSRC				0x04
+#define VL53L0X_SEQ_PRE_RANGE			0x40
+#define VL53L0X_SEQ_FINAL_RANGE			0x80
+
+/** @brief GPIO1: interrupcao de nova amostra, ativa em nivel alto (EXTI7 na borda de subida) */
+#define VL53L0X_GPIO_NEW_SAMPLE			0x04
+#define VL53L0X_GPIO_ACTIVE_HIGH		0x10
+
+/** @brief XSHUT em alto ate o boot do firmware do sensor (1.2 ms no datasheet) */
+#define VL53L0X_BOOT_MS					2
+
+/** @brief Bytes do bloco de resultado lido em rajada a partir de RESULT_RANGE_STATUS */
+#define VL53L0X_RESULT_SIZE				12
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Escrita de um registrador da tabela de ajustes */
+typedef struct
+{
+	uint8_t reg;
+	uint8_t value;
+} VL53L0X_RegValue_t;
+
+/** @brief Timeouts das etapas da sequencia de medida */
+typedef struct
+{
+	uint8_t steps;           /**< SYSTEM_SEQUENCE_CONFIG */
+	uint16_t pre_vcsel;      /**< Periodo do VCSEL do pre-range em PCLKs */
+	uint16_t final_vcsel;    /**< Periodo do VCSEL do final-range em PCLKs */
+	uint32_t msrc_us;        /**< MSRC, DSS e TCC */
+	uint32_t pre_mclks;
+	uint32_t pre_us;
+	uint32_t final_us;
+} VL53L0X_Timeouts_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static I2C_HandleTypeDef *pI2C_VL53L0X;
+
+/** @brief Ajustes padrao da ST (DefaultTuningSettings), com as trocas de pagina em 0xFF */
+static const VL53L0X_RegValue_t VL53L0X_Tuning[] =
+{
+	{ 0xFF, 0x01 }, { 0x00, 0x00 },
+	{ 0xFF, 0x00 }, { 0x09, 0x00 }, { 0x10, 0x00 }, { 0x11, 0x00 },
+	{ 0x24, 0x01 }, { 0x25, 0xFF }, { 0x75, 0x00 },
+	{ 0xFF, 0x01 }, { 0x4E, 0x2C }, { 0x48, 0x00 }, { 0x30, 0x20 },
+	{ 0xFF, 0x00 }, { 0x30, 0x09 }, { 0x54, 0x00 }, { 0x31, 0x04 }, { 0x32, 0x03 },
+	{ 0x40, 0x83 }, { 0x46, 0x25 }, { 0x60, 0x00 }, { 0x27, 0x00 }, { 0x50, 0x06 },
+	{ 0x51, 0x00 }, { 0x52, 0x96 }, { 0x56, 0x08 }, { 0x57, 0x30 }, { 0x61, 0x00 },
+	{ 0x62, 0x00 }, { 0x64, 0x00 }, { 0x65, 0x00 }, { 0x66, 0xA0 },
+	{ 0xFF, 0x01 }, { 0x22, 0x32 }, { 0x47, 0x14 }, { 0x49, 0xFF }, { 0x4A, 0x00 },
+	{ 0xFF, 0x00 }, { 0x7A, 0x0A }, { 0x7B, 0x00 }, { 0x78, 0x21 },
+	{ 0xFF, 0x01 }, { 0x23, 0x34 }, { 0x42, 0x00 }, { 0x44, 0xFF }, { 0x45, 0x26 },
+	{ 0x46, 0x05 }, { 0x40, 0x40 }, { 0x0E, 0x06 }, { 0x20, 0x1A }, { 0x43, 0x40 },
+	{ 0xFF, 0x00 }, { 0x34, 0x03 }, { 0x35, 0x44 },
+	{ 0xFF, 0x01 }, { 0x31, 0x04 }, { 0x4B, 0x09 }, { 0x4C, 0x05 }, { 0x4D, 0x04 },
+	{ 0xFF, 0x00 }, { 0x44, 0x00 }, { 0x45, 0x20 }, { 0x47, 0x08 }, { 0x48, 0x28 },
+	{ 0x67, 0x00 }, { 0x70, 0x04 }, { 0x71, 0x01 }, { 0x72, 0xFE }, { 0x76, 0x00 },
+	{ 0x77, 0x00 },
+	{ 0xFF, 0x01 }, { 0x0D, 0x01 },
+	{ 0xFF, 0x00 }, { 0x80, 0x01 }, { 0x01, 0xF8 },
+	{ 0xFF, 0x01 }, { 0x8E, 0x01 }, { 0x00, 0x01 }, { 0xFF, 0x00 }, { 0x80, 0x00 },
+};
+
+/** @brief Lido na inicializacao e reescrito a cada inicio de medida */
+static uint8_t VL53L0X_StopVariable;
+
+static uint32_t VL53L0X_BudgetUs = VL53L0X_BUDGET_DEFAULT_US;
+
+/** @brief Modo em andamento: SYSRANGE_START e periodo pedido (0 = emendado) */
+static uint8_t VL53L0X_Mode;
+static uint32_t VL53L0X_PeriodMs;
+
+/** @brief ODR pedido pelo registro */
+static uint32_t VL53L0X_OdrMhz;
+
+static uint32_t VL53L0X_BusTransfers;
+static uint32_t VL53L0X_BusBytes;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * @brief  Escreve um ou mais registradores consecutivos.
+ */
+static HAL_StatusTypeDef VL53L0X_IO_WriteMultiple(uint8_t Addr, uint8_t Reg, const uint8_t *Buffer, uint16_t Length);
+
+/**
+ * @brief  Le um ou mais registradores consecutivos em uma transacao.
+ */
+static HAL_StatusTypeDef VL53L0X_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length);
+
+static void VL53L0X_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value);
+static void VL53L0X_IO_Write16(uint8_t Addr, uint8_t Reg, uint16_t Value);
+static void VL53L0X_IO_Write32(uint8_t Addr, uint8_t Reg, uint32_t Value);
+static uint8_t VL53L0X_IO_Read(uint8_t Addr, uint8_t Reg);
+static uint16_t VL53L0X_IO_Read16(uint8_t Addr, uint8_t Reg);
+
+/**
+ * Le do NVM o numero e o tipo dos SPADs de referencia.
+ * @param count Quantidade de SPADs.
+ * @param aperture true se sao SPADs de abertura.
+ */
+static HAL_StatusTypeDef VL53L0X_GetSpadInfo(uint8_t Addr, uint8_t *count, bool *aperture);
+
+/**
+ * Calibracao de referencia (VHV ou fase).
+ * @param vhv_init 0x40 para VHV, 0x00 para fase.
+ */
+static HAL_StatusTypeDef VL53L0X_RefCalibration(uint8_t Addr, uint8_t vhv_init);
+
+/**
+ * Le as etapas habilitadas e os timeouts programados.
+ * @param t Saida.
+ */
+static void VL53L0X_GetTimeouts(uint8_t Addr, VL53L0X_Timeouts_t *t);
+
+/** @brief Orcamento de tempo atual calculado dos timeouts. */
+static uint32_t VL53L0X_CalcTimingBudget(uint8_t Addr);
+
+/**
+ * Espera o fim de uma medida pelo RESULT_INTERRUPT_STATUS.
+ * @return HAL_OK, HAL_TIMEOUT apos VL53L0X_TIMEOUT_MS.
+ */
+static HAL_StatusTypeDef VL53L0X_WaitReady(uint8_t Addr);
+
+/** @brief Reescreve a stop variable antes de iniciar uma medida. */
+static void VL53L0X_PrepareStart(uint8_t Addr);
+
+/** @brief Periodo do macro clock em ns para um periodo de VCSEL em PCLKs. */
+static uint32_t VL53L0X_MacroPeriodNs(uint16_t vcsel_pclks);
+
+/** @brief Timeout codificado (LSB << MSB) + 1 para MCLKs. */
+static uint32_t VL53L0X_DecodeTimeout(uint16_t value);
+
+/** @brief MCLKs para o formato (LSB << MSB) + 1. */
+static uint16_t VL53L0X_EncodeTimeout(uint32_t mclks);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static HAL_StatusTypeDef VL53L0X_IO_WriteMultiple(uint8_t Addr, uint8_t Reg, const uint8_t *Buffer, uint16_t Length)
+{
+	HAL_StatusTypeDef status;
+
+	status = HAL_I2C_Mem_Write(pI2C_VL53L0X, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, (uint8_t *) Buffer, Length, 1000);
+
+	VL53L0X_BusTransfers++;
+	VL53L0X_BusBytes += 2U + Length;
+
+	if (status != HAL_OK)
+	{
+		DBG("ERRO I2C");
+	}
+
+	return status;
+}
+
+static HAL_StatusTypeDef VL53L0X_IO_ReadMultiple(uint8_t Addr, uint8_t Reg, uint8_t *Buffer, uint16_t Length)
+{
+	HAL_StatusTypeDef status;
+
+	status = HAL_I2C_Mem_Read(pI2C_VL53L0X, Addr, (uint16_t) Reg, I2C_MEMADD_SIZE_8BIT, Buffer, Length, 1000);
+
+	/* Endereco, registrador, endereco de novo no restart e os dados */
+	VL53L0X_BusTransfers++;
+	VL53L0X_BusBytes += 3U + Length;
+
+	if (status != HAL_OK)
+	{
+		DBG("ERRO I2C");
+	}
+
+	return status;
+}
+
+static void VL53L0X_IO_Write(uint8_t Addr, uint8_t Reg, uint8_t Value)
+{
+	VL53L0X_IO_WriteMultiple(Addr, Reg, &Value, 1);
+}
+
+static void VL53L0X_IO_Write16(uint8_t Addr, uint8_t Reg, uint16_t Value)
+{
+	uint8_t buffer[2];
+
+	/* Registradores de varios bytes sao big-endian */
+	buffer[0] = (uint8_t) (Value >> 8);
+	buffer[1] = (uint8_t) Value;
+
+	VL53L0X_IO_WriteMultiple(Addr, Reg, buffer, 2);
+}
+
+static void VL53L0X_IO_Write32(uint8_t Addr, uint8_t Reg, uint32_t Value)
+{
+	uint8_t buffer[4];
+
+	buffer[0] = (uint8_t) (Value >> 24);
+	buffer[1] = (uint8_t) (Value >> 16);
+	buffer[2] = (uint8_t) (Value >> 8);
+	buffer[3] = (uint8_t) Value;
+
+	VL53L0X_IO_WriteMultiple(Addr, Reg, buffer, 4);
+}
+
+static uint8_t VL53L0X_IO_Read(uint8_t Addr, uint8_t Reg)
+{
+	uint8_t value = 0;
+
+	VL53L0X_IO_ReadMultiple(Addr, Reg, &value, 1);
+
+	return value;
+}
+
+static uint16_t VL53L0X_IO_Read16(uint8_t Addr, uint8_t Reg)
+{
+	uint8_t buffer[2] = { 0, 0 };
+
+	VL53L0X_IO_ReadMultiple(Addr, Reg, buffer, 2);
+
+	return (uint16_t) ((buffer[0] << 8) | buffer[1]);
+}
+
+static uint32_t VL53L0X_MacroPeriodNs(uint16_t vcsel_pclks)
+{
+	/* 2304 PCLKs de 1.655 ns por periodo de VCSEL */
+	return ((2304UL * vcsel_pclks * 1655UL) + 500UL) / 1000UL;
+}
+
+static uint32_t VL53L0X_DecodeTimeout(uint16_t value)
+{
+	return ((uint32_t) (value & 0x00FF) << ((value & 0xFF00) >> 8)) + 1UL;
+}
+
+static uint16_t VL53L0X_EncodeTimeout(uint32_t mclks)
+{
+	uint32_t lsb;
+	uint16_t msb = 0;
+
+	if (mclks == 0)
+	{
+		return 0;
+	}
+
+	lsb = mclks - 1UL;
+	while ((lsb & 0xFFFFFF00UL) > 0)
+	{
+		lsb >>= 1;
+		msb++;
+	}
+
+	return (uint16_t) ((msb << 8) | (lsb & 0xFF));
+}
+
+static void VL53L0X_GetTimeouts(uint8_t Addr, VL53L0X_Timeouts_t *t)
+{
+	uint32_t macro_ns, final_mclks;
+
+	t->steps = VL53L0X_IO_Read(Addr, VL53L0X_SYSTEM_SEQUENCE_CONFIG);
+
+	/* Registrador do VCSEL guarda (PCLKs / 2) - 1 */
+	t->pre_vcsel = (uint16_t) ((VL53L0X_IO_Read(Addr, VL53L0X_PRE_RANGE_VCSEL_PERIOD) + 1) << 1);
+	t->final_vcsel = (uint16_t) ((VL53L0X_IO_Read(Addr, VL53L0X_FINAL_RANGE_VCSEL_PERIOD) + 1) << 1);
+
+	macro_ns = VL53L0X_MacroPeriodNs(t->pre_vcsel);
+
+	t->msrc_us = (((uint32_t) VL53L0X_IO_Read(Addr, VL53L0X_MSRC_CONFIG_TIMEOUT) + 1UL) * macro_ns + macro_ns / 2) / 1000UL;
+
+	t->pre_mclks = VL53L0X_DecodeTimeout(VL53L0X_IO_Read16(Addr, VL53L0X_PRE_RANGE_TIMEOUT));
+	t->pre_us = (t->pre_mclks * macro_ns + macro_ns / 2) / 1000UL;
+
+	/* O timeout do final-range inclui o do pre-range quando este esta habilitado */
+	final_mclks = VL53L0X_DecodeTimeout(VL53L0X_IO_Read16(Addr, VL53L0X_FINAL_RANGE_TIMEOUT));
+	if (t->steps & VL53L0X_SEQ_PRE_RANGE)
+	{
+		final_mclks -= t->pre_mclks;
+	}
+
+	macro_ns = VL53L0X_MacroPeriodNs(t->final_vcsel);
+	t->final_us = (final_mclks * macro_ns + macro_ns / 2) / 1000UL;
+}
+
+static uint32_t VL53L0X_CalcTimingBudget(uint8_t Addr)
+{
+	VL53L0X_Timeouts_t t;
+	uint32_t budget = VL53L0X_START_OVERHEAD_GET + VL53L0X_END_OVERHEAD;
+
+	VL53L0X_GetTimeouts(Addr, &t);
+
+	if (t.steps & VL53L0X_SEQ_TCC)
+	{
+		budget += t.msrc_us + VL53L0X_TCC_OVERHEAD;
+	}
+
+	if (t.steps & VL53L0X_SEQ_DSS)
+	{
+		budget += 2UL * (t.msrc_us + VL53L0X_DSS_OVERHEAD);
+	}
+	else if (t.steps & VL53L0X_SEQ_MSRC)
+	{
+		budget += t.msrc_us + VL53L0X_MSRC_OVERHEAD;
+	}
+
+	if (t.steps & VL53L0X_SEQ_PRE_RANGE)
+	{
+		budget += t.pre_us + VL53L0X_PRE_RANGE_OVERHEAD;
+	}
+
+	if (t.steps & VL53L0X_SEQ_FINAL_RANGE)
+	{
+		budget += t.final_us + VL53L0X_FINAL_RANGE_OVERHEAD;
+	}
+
+	return budget;
+}
+
+static HAL_StatusTypeDef VL53L0X_GetSpadInfo(uint8_t Addr, uint8_t *count, bool *aperture)
+{
+	HAL_StatusTypeDef status = HAL_TIMEOUT;
+	uint32_t t;
+	uint8_t tmp;
+
+	VL53L0X_IO_Write(Addr, 0x80, 0x01);
+	VL53L0X_IO_Write(Addr, 0xFF, 0x01);
+	VL53L0X_IO_Write(Addr, 0x00, 0x00);
+
+	VL53L0X_IO_Write(Addr, 0xFF, 0x06);
+	VL53L0X_IO_Write(Addr, 0x83, VL53L0X_IO_Read(Addr, 0x83) | 0x04);
+	VL53L0X_IO_Write(Addr, 0xFF, 0x07);
+	VL53L0X_IO_Write(Addr, 0x81, 0x01);
+
+	VL53L0X_IO_Write(Addr, 0x80, 0x01);
+
+	/* Pede o bloco do NVM com as informacoes dos SPADs */
+	VL53L0X_IO_Write(Addr, 0x94, 0x6B);
+	VL53L0X_IO_Write(Addr, 0x83, 0x00);
+
+	for (t = 0; t < VL53L0X_TIMEOUT_MS; t++)
+	{
+		if (VL53L0X_IO_Read(Addr, 0x83) != 0x00)
+		{
+			status = HAL_OK;
+			break;
+		}
+		HAL_Delay(1);
+	}
+
+	VL53L0X_IO_Write(Addr, 0x83, 0x01);
+	tmp = VL53L0X_IO_Read(Addr, 0x92);
+
+	*count = tmp & 0x7F;
+	*aperture = ((tmp & 0x80) != 0);
+
+	VL53L0X_IO_Write(Addr, 0x81, 0x00);
+	VL53L0X_IO_Write(Addr, 0xFF, 0x06);
+	VL53L0X_IO_Write(Addr, 0x83, VL53L0X_IO_Read(Addr, 0x83) & ~0x04);
+	VL53L0X_IO_Write(Addr, 0xFF, 0x01);
+	VL53L0X_IO_Write(Addr, 0x00, 0x01);
+
+	VL53L0X_IO_Write(Addr, 0xFF, 0x00);
+	VL53L0X_IO_Write(Addr, 0x80, 0x00);
+
+	return status;
+}
+
+static HAL_StatusTypeDef VL53L0X_WaitReady(uint8_t Addr)
+{
+	uint32_t t;
+
+	for (t = 0; t < VL53L0X_TIMEOUT_MS; t++)
+	{
+		if ((VL53L0X_IO_Read(Addr, VL53L0X_RESULT_INTERRUPT_STATUS) & 0x07) != 0)
+		{
+			return HAL_OK;
+		}
+		HAL_Delay(1);
+	}
+
+	return HAL_TIMEOUT;
+}
+
+static HAL_StatusTypeDef VL53L0X_RefCalibration(uint8_t Addr, uint8_t vhv_init)
+{
+	HAL_StatusTypeDef status;
+
+	VL53L0X_IO_Write(Addr, VL53L0X_SYSRANGE_START, VL53L0X_START_SINGLE | vhv_init);
+
+	status = VL53L0X_WaitReady(Addr);
+
+	VL53L0X_IO_Write(Addr, VL53L0X_SYSTEM_INTERRUPT_CLEAR, 0x01);
+	VL53L0X_IO_Write(Addr, VL53L0X_SYSRANGE_START, 0x00);
+
+	return status;
+}
+
+static void VL53L0X_PrepareStart(uint8_t Addr)
+{
+	VL53L0X_IO_Write(Addr, 0x80, 0x01);
+	VL53L0X_IO_Write(Addr, 0xFF, 0x01);
+	VL53L0X_IO_Write(Addr, 0x00, 0x00);
+	VL53L0X_IO_Write(Addr, 0x91, VL53L0X_StopVariable);
+	VL53L0X_IO_Write(Addr, 0x00, 0x01);
+	VL53L0X_IO_Write(Addr, 0xFF, 0x00);
+	VL53L0X_IO_Write(Addr, 0x80, 0x00);
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void VL53L0X_attach(I2C_HandleTypeDef *hI2Handler)
+{
+	pI2C_VL53L0X = hI2Handler;
+}
+
+uint8_t VL53L0X_ReadID(uint16_t DeviceAddr)
+{
+	return VL53L0X_IO_Read(DeviceAddr, VL53L0X_IDENTIFICATION_MODEL_ID);
+}
+
+HAL_StatusTypeDef VL53L0X_Init(uint16_t DeviceAddr)
+{
+	uint8_t spad_map[6];
+	uint8_t spad_count, enabled = 0, first, i;
+	bool aperture;
+	uint32_t budget;
+
+	VL53L0X_Mode = 0;
+	VL53L0X_PeriodMs = 0;
+
+	/* I/O em 2.8 V */
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_VHV_CONFIG_PAD_SCL_SDA,
+			VL53L0X_IO_Read(DeviceAddr, VL53L0X_VHV_CONFIG_PAD_SCL_SDA) | 0x01);
+
+	/* Modo I2C padrao e leitura da stop variable */
+	VL53L0X_IO_Write(DeviceAddr, 0x88, 0x00);
+	VL53L0X_IO_Write(DeviceAddr, 0x80, 0x01);
+	VL53L0X_IO_Write(DeviceAddr, 0xFF, 0x01);
+	VL53L0X_IO_Write(DeviceAddr, 0x00, 0x00);
+	VL53L0X_StopVariable = VL53L0X_IO_Read(DeviceAddr, 0x91);
+	VL53L0X_IO_Write(DeviceAddr, 0x00, 0x01);
+	VL53L0X_IO_Write(DeviceAddr, 0xFF, 0x00);
+	VL53L0X_IO_Write(DeviceAddr, 0x80, 0x00);
+
+	/* Desliga as checagens de limite de SIGNAL_RATE_MSRC e PRE_RANGE */
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_MSRC_CONFIG_CONTROL,
+			VL53L0X_IO_Read(DeviceAddr, VL53L0X_MSRC_CONFIG_CONTROL) | 0x12);
+
+	/* Limite de sinal de retorno em 0.25 MCPS (ponto fixo 9.7) */
+	VL53L0X_IO_Write16(DeviceAddr, VL53L0X_FINAL_RANGE_MIN_SIGNAL, (uint16_t) (0.25f * (1 << 7)));
+
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_SEQUENCE_CONFIG, 0xFF);
+
+	/* SPADs de referencia: habilita os primeiros spad_count do tipo gravado no NVM */
+	if (VL53L0X_GetSpadInfo(DeviceAddr, &spad_count, &aperture) != HAL_OK)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	VL53L0X_IO_ReadMultiple(DeviceAddr, VL53L0X_SPAD_ENABLES_REF_0, spad_map, sizeof(spad_map));
+
+	VL53L0X_IO_Write(DeviceAddr, 0xFF, 0x01);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_DYNAMIC_SPAD_REF_OFFSET, 0x00);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_DYNAMIC_SPAD_NUM_REF, 0x2C);
+	VL53L0X_IO_Write(DeviceAddr, 0xFF, 0x00);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SPAD_REF_EN_START_SELECT, 0xB4);
+
+	/* SPADs de abertura comecam no 12 */
+	first = aperture ? 12 : 0;
+
+	for (i = 0; i < 48; i++)
+	{
+		if ((i < first) || (enabled == spad_count))
+		{
+			spad_map[i / 8] &= (uint8_t) ~(1U << (i % 8));
+		}
+		else if ((spad_map[i / 8] >> (i % 8)) & 0x01)
+		{
+			enabled++;
+		}
+	}
+
+	VL53L0X_IO_WriteMultiple(DeviceAddr, VL53L0X_SPAD_ENABLES_REF_0, spad_map, sizeof(spad_map));
+
+	for (i = 0; i < sizeof(VL53L0X_Tuning) / sizeof(VL53L0X_Tuning[0]); i++)
+	{
+		VL53L0X_IO_Write(DeviceAddr, VL53L0X_Tuning[i].reg, VL53L0X_Tuning[i].value);
+	}
+
+	/* GPIO1: nova amostra, ativo em alto para a borda de subida do EXTI7 */
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_INTERRUPT_GPIO, VL53L0X_GPIO_NEW_SAMPLE);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_GPIO_HV_MUX_ACTIVE_HIGH,
+			VL53L0X_IO_Read(DeviceAddr, VL53L0X_GPIO_HV_MUX_ACTIVE_HIGH) | VL53L0X_GPIO_ACTIVE_HIGH);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_INTERRUPT_CLEAR, 0x01);
+
+	/* Sem MSRC e TCC por padrao; o orcamento e recalculado com a nova sequencia */
+	budget = VL53L0X_CalcTimingBudget(DeviceAddr);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_SEQUENCE_CONFIG, 0xE8);
+	if (VL53L0X_SetTimingBudget(DeviceAddr, budget) != HAL_OK)
+	{
+		return HAL_ERROR;
+	}
+
+	/* Calibracoes de referencia: VHV e fase */
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_SEQUENCE_CONFIG, 0x01);
+	if (VL53L0X_RefCalibration(DeviceAddr, 0x40) != HAL_OK)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_SEQUENCE_CONFIG, 0x02);
+	if (VL53L0X_RefCalibration(DeviceAddr, 0x00) != HAL_OK)
+	{
+		return HAL_TIMEOUT;
+	}
+
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_SEQUENCE_CONFIG, 0xE8);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef VL53L0X_SetTimingBudget(uint16_t DeviceAddr, uint32_t budget_us)
+{
+	VL53L0X_Timeouts_t t;
+	uint32_t used = VL53L0X_START_OVERHEAD_SET + VL53L0X_END_OVERHEAD;
+	uint32_t final_us, final_mclks, macro_ns;
+	uint32_t period = VL53L0X_PeriodMs;
+	uint8_t mode = VL53L0X_Mode;
+
+	if (budget_us < VL53L0X_BUDGET_MIN_US)
+	{
+		return HAL_ERROR;
+	}
+
+	VL53L0X_GetTimeouts(DeviceAddr, &t);
+
+	if (t.steps & VL53L0X_SEQ_TCC)
+	{
+		used += t.msrc_us + VL53L0X_TCC_OVERHEAD;
+	}
+
+	if (t.steps & VL53L0X_SEQ_DSS)
+	{
+		used += 2UL * (t.msrc_us + VL53L0X_DSS_OVERHEAD);
+	}
+	else if (t.steps & VL53L0X_SEQ_MSRC)
+	{
+		used += t.msrc_us + VL53L0X_MSRC_OVERHEAD;
+	}
+
+	if (t.steps & VL53L0X_SEQ_PRE_RANGE)
+	{
+		used += t.pre_us + VL53L0X_PRE_RANGE_OVERHEAD;
+	}
+
+	if ((t.steps & VL53L0X_SEQ_FINAL_RANGE) == 0)
+	{
+		return HAL_ERROR;
+	}
+
+	used += VL53L0X_FINAL_RANGE_OVERHEAD;
+	if (used > budget_us)
+	{
+		return HAL_ERROR;
+	}
+
+	if (mode != 0)
+	{
+		VL53L0X_StopContinuous(DeviceAddr);
+	}
+
+	/* O que sobra do orcamento vai para o final-range */
+	final_us = budget_us - used;
+	macro_ns = VL53L0X_MacroPeriodNs(t.final_vcsel);
+	final_mclks = ((final_us * 1000UL) + (macro_ns / 2)) / macro_ns;
+
+	if (t.steps & VL53L0X_SEQ_PRE_RANGE)
+	{
+		final_mclks += t.pre_mclks;
+	}
+
+	VL53L0X_IO_Write16(DeviceAddr, VL53L0X_FINAL_RANGE_TIMEOUT, VL53L0X_EncodeTimeout(final_mclks));
+	VL53L0X_BudgetUs = budget_us;
+
+	if (mode != 0)
+	{
+		return VL53L0X_StartContinuous(DeviceAddr, period);
+	}
+
+	return HAL_OK;
+}
+
+uint32_t VL53L0X_GetTimingBudget(void)
+{
+	return VL53L0X_BudgetUs;
+}
+
+HAL_StatusTypeDef VL53L0X_StartContinuous(uint16_t DeviceAddr, uint32_t period_ms)
+{
+	uint16_t osc;
+
+	/* No modo temporizado o intervalo precisa caber uma medida inteira */
+	if ((period_ms != 0) && (period_ms * 1000UL <= VL53L0X_BudgetUs))
+	{
+		return HAL_ERROR;
+	}
+
+	VL53L0X_PrepareStart(DeviceAddr);
+
+	if (period_ms != 0)
+	{
+		/* O periodo e contado no oscilador interno, calibrado de fabrica */
+		osc = VL53L0X_IO_Read16(DeviceAddr, VL53L0X_OSC_CALIBRATE_VAL);
+		VL53L0X_IO_Write32(DeviceAddr, VL53L0X_SYSTEM_INTERMEASUREMENT, (osc != 0) ? period_ms * osc : period_ms);
+
+		VL53L0X_Mode = VL53L0X_START_TIMED;
+	}
+	else
+	{
+		VL53L0X_Mode = VL53L0X_START_BACK_TO_BACK;
+	}
+
+	VL53L0X_PeriodMs = period_ms;
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSRANGE_START, VL53L0X_Mode);
+
+	return HAL_OK;
+}
+
+void VL53L0X_StopContinuous(uint16_t DeviceAddr)
+{
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSRANGE_START, VL53L0X_START_SINGLE);
+
+	VL53L0X_IO_Write(DeviceAddr, 0xFF, 0x01);
+	VL53L0X_IO_Write(DeviceAddr, 0x00, 0x00);
+	VL53L0X_IO_Write(DeviceAddr, 0x91, 0x00);
+	VL53L0X_IO_Write(DeviceAddr, 0x00, 0x01);
+	VL53L0X_IO_Write(DeviceAddr, 0xFF, 0x00);
+
+	VL53L0X_Mode = 0;
+	VL53L0X_PeriodMs = 0;
+}
+
+uint32_t VL53L0X_GetPeriod(void)
+{
+	if (VL53L0X_Mode == 0)
+	{
+		return 0;
+	}
+
+	return (VL53L0X_PeriodMs != 0) ? VL53L0X_PeriodMs : (VL53L0X_BudgetUs + 999UL) / 1000UL;
+}
+
+HAL_StatusTypeDef VL53L0X_ReadSingle(uint16_t DeviceAddr, VL53L0X_Result_t *result)
+{
+	HAL_StatusTypeDef status;
+	uint32_t t;
+
+	if (VL53L0X_Mode != 0)
+	{
+		return HAL_BUSY;
+	}
+
+	VL53L0X_PrepareStart(DeviceAddr);
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSRANGE_START, VL53L0X_START_SINGLE);
+
+	/* O bit de start se apaga quando a medida comeca */
+	for (t = 0; t < VL53L0X_TIMEOUT_MS; t++)
+	{
+		if ((VL53L0X_IO_Read(DeviceAddr, VL53L0X_SYSRANGE_START) & VL53L0X_START_SINGLE) == 0)
+		{
+			break;
+		}
+		HAL_Delay(1);
+	}
+
+	status = VL53L0X_WaitReady(DeviceAddr);
+	if (status != HAL_OK)
+	{
+		return status;
+	}
+
+	return VL53L0X_ReadResult(DeviceAddr, result);
+}
+
+HAL_StatusTypeDef VL53L0X_ReadResult(uint16_t DeviceAddr, VL53L0X_Result_t *result)
+{
+	uint8_t buffer[VL53L0X_RESULT_SIZE];
+	HAL_StatusTypeDef status;
+
+	/* Uma rajada: status, SPADs, sinal, ambiente e distancia da mesma medida */
+	status = VL53L0X_IO_ReadMultiple(DeviceAddr, VL53L0X_RESULT_RANGE_STATUS, buffer, sizeof(buffer));
+	if (status != HAL_OK)
+	{
+		return status;
+	}
+
+	result->status = (buffer[0] & 0x78) >> 3;
+	result->spads = (uint16_t) ((buffer[2] << 8) | buffer[3]);
+	result->signal = (uint16_t) ((buffer[6] << 8) | buffer[7]);
+	result->ambient = (uint16_t) ((buffer[8] << 8) | buffer[9]);
+	result->range_mm = (uint16_t) ((buffer[10] << 8) | buffer[11]);
+
+	VL53L0X_IO_Write(DeviceAddr, VL53L0X_SYSTEM_INTERRUPT_CLEAR, 0x01);
+
+	return HAL_OK;
+}
+
+bool VL53L0X_DataReady(uint16_t DeviceAddr)
+{
+	return ((VL53L0X_IO_Read(DeviceAddr, VL53L0X_RESULT_INTERRUPT_STATUS) & 0x07) != 0);
+}
+
+void VL53L0X_GetBusStats(uint32_t *transfers, uint32_t *bytes)
+{
+	taskENTER_CRITICAL();
+	*transfers = VL53L0X_BusTransfers;
+	*bytes = VL53L0X_BusBytes;
+	taskEXIT_CRITICAL();
+}
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+/** @brief Taxas de 1 a 30 Hz; acima do orcamento de tempo as medidas sao emendadas */
+static const uint32_t VL53L0X_Odrs[] = { 1000, 2000, 5000, 10000, 20000, 30000 };
+
+static const SensorChannelDesc_t VL53L0X_Channels[] =
+{
+	{ "distance", SENSOR_TYPE_DISTANCE, 1, "mm", 1, VL53L0X_Odrs, 6, NULL, 0 },
+};
+
+static HAL_StatusTypeDef VL53L0X_DrvProbe(void)
+{
+	/* O CubeMX deixa o XSHUT em baixo: sensor desligado */
+	HAL_GPIO_WritePin(VL53L0X_XSHUT_GPIO_Port, VL53L0X_XSHUT_Pin, GPIO_PIN_SET);
+	HAL_Delay(VL53L0X_BOOT_MS);
+
+	return (VL53L0X_ReadID(VL53L0X_I2C_ADDRESS) == VL53L0X_MODEL_ID) ? HAL_OK : HAL_ERROR;
+}
+
+static HAL_StatusTypeDef VL53L0X_DrvInit(void)
+{
+	VL53L0X_OdrMhz = VL53L0X_Odrs[0];
+
+	return VL53L0X_Init(VL53L0X_I2C_ADDRESS);
+}
+
+/**
+ * @brief  Periodo das medidas para o ODR pedido: 0 (emendadas) quando o
+ *         intervalo nao cabe uma medida mais a folga do modo temporizado.
+ */
+static uint32_t VL53L0X_DrvPeriod(void)
+{
+	uint32_t period_ms = 1000000UL / VL53L0X_OdrMhz;
+
+	return (period_ms * 1000UL <= VL53L0X_BudgetUs + 5000UL) ? 0 : period_ms;
+}
+
+static HAL_StatusTypeDef VL53L0X_DrvSetOdr(uint8_t ch, uint32_t odr_mhz)
+{
+	VL53L0X_OdrMhz = odr_mhz;
+
+	/* Em andamento: reinicia somente se o periodo mudou */
+	if ((VL53L0X_Mode != 0) && (VL53L0X_DrvPeriod() != VL53L0X_PeriodMs))
+	{
+		VL53L0X_StopContinuous(VL53L0X_I2C_ADDRESS);
+		return VL53L0X_StartContinuous(VL53L0X_I2C_ADDRESS, VL53L0X_DrvPeriod());
+	}
+
+	return HAL_OK;
+}
+
+static uint32_t VL53L0X_DrvGetOdr(uint8_t ch)
+{
+	return (VL53L0X_Mode != 0) ? VL53L0X_OdrMhz : 0;
+}
+
+static HAL_StatusTypeDef VL53L0X_DrvSetPower(uint8_t ch, SensorPower_e power)
+{
+	if (power == SENSOR_POWER_OFF)
+	{
+		if (VL53L0X_Mode != 0)
+		{
+			VL53L0X_StopContinuous(VL53L0X_I2C_ADDRESS);
+		}
+		return HAL_OK;
+	}
+
+	if (VL53L0X_Mode != 0)
+	{
+		return HAL_OK;
+	}
+
+	return VL53L0X_StartContinuous(VL53L0X_I2C_ADDRESS, VL53L0X_DrvPeriod());
+}
+
+static HAL_StatusTypeDef VL53L0X_DrvOneShot(uint8_t ch)
+{
+	uint32_t t;
+
+	if (VL53L0X_Mode != 0)
+	{
+		return HAL_OK;
+	}
+
+	VL53L0X_PrepareStart(VL53L0X_I2C_ADDRESS);
+	VL53L0X_IO_Write(VL53L0X_I2C_ADDRESS, VL53L0X_SYSRANGE_START, VL53L0X_START_SINGLE);
+
+	/* Uma medida leva o orcamento de tempo: espera sem ocupar o barramento */
+	osDelay(VL53L0X_BudgetUs / 1000UL);
+
+	for (t = 0; t < VL53L0X_TIMEOUT_MS; t++)
+	{
+		if (VL53L0X_DataReady(VL53L0X_I2C_ADDRESS) == true)
+		{
+			return HAL_OK;
+		}
+		osDelay(1);
+	}
+
+	return HAL_TIMEOUT;
+}
+
+static HAL_StatusTypeDef VL53L0X_DrvReadRaw(uint8_t ch, int32_t *raw)
+{
+	VL53L0X_Result_t result;
+	HAL_StatusTypeDef status;
+
+	status = VL53L0X_ReadResult(VL53L0X_I2C_ADDRESS, &result);
+
+	/* Sem alvo (fase ou sinal fora do limite) a distancia nao vale nada */
+	raw[0] = (result.status == VL53L0X_RANGE_VALID) ? (int32_t) result.range_mm : -1;
+
+	return status;
+}
+
+static void VL53L0X_DrvConvert(uint8_t ch, const int32_t *raw, int32_t *out, uint16_t count)
+{
+	/* A distancia ja sai em mm */
+	if (out != raw)
+	{
+		memcpy(out, raw, count * sizeof(int32_t));
+	}
+}
+
+const SensorDriver_t VL53L0X_Driver =
+{
+	.name = "VL53L0X",
+	.address = VL53L0X_I2C_ADDRESS,
+	.num_channels = 1,
+	.channels = VL53L0X_Channels,
+	.shared_odr = false,
+	.probe = VL53L0X_DrvProbe,
+	.init = VL53L0X_DrvInit,
+	.set_odr = VL53L0X_DrvSetOdr,
+	.get_odr = VL53L0X_DrvGetOdr,
+	.set_range = NULL,
+	.get_range = NULL,
+	.set_power = VL53L0X_DrvSetPower,
+	.read_raw = VL53L0X_DrvReadRaw,
+	.read_batch = NULL,
+	.convert = VL53L0X_DrvConvert,
+	.one_shot = VL53L0X_DrvOneShot,
+	.set_filter = NULL,
+};
@@ -0,0 +1,200 @@
+/**
+ * @file    vl53l0x.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Driver enxuto do sensor de distancia por tempo de voo VL53L0X
+ * @details
+ * Substitui a API da ST por apenas o necessario para medir: a sequencia de
+ * inicializacao (ajustes de fabrica, SPADs de referencia e calibracao de
+ * referencia), o orcamento de tempo por medida e tres modos:
+ *
+ *   unica      -> uma medida por chamada (one_shot do registro)
+ *   continua   -> medidas emendadas, uma a cada orcamento de tempo
+ *   temporizada-> uma medida a cada periodo, sensor ocioso no intervalo
+ *
+ * Cada medida pronta aciona o GPIO1 (PC7, EXTI7) em nivel alto ate ser
+ * limpa. VL53L0X_ReadResult le status, sinal, ambiente, SPADs e distancia
+ * em uma unica leitura em rajada de 12 bytes e limpa a interrupcao com uma
+ * escrita: duas transacoes curtas por medida, sem polling no barramento.
+ *
+ * Orcamento de tempo x precisao: a medida integra por mais tempo com um
+ * orcamento maior; o desvio cai aproximadamente com a raiz do orcamento.
+ * 20 ms e o minimo (alta velocidade), 33 ms o padrao e 200 ms o de alta
+ * precisao.
+ *
+ * O XSHUT (PC6) sai do reset em VL53L0X_DrvProbe. O sensor divide o hi2c2
+ * com os demais: chamadas fora do registro devem ficar entre
+ * SensorDrv_Lock/SensorDrv_Unlock.
+ *
+ * Tools/vl53l0x tem um modelo dos registradores para rodar este driver no PC.
+ */
+
+#ifndef _VL53L0X_H_
+#define _VL53L0X_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "setup_hw.h"
+#include "sensor_drv/sensor_drv.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define VL53L0X_I2C_ADDRESS					(uint8_t)0x52
+
+/** @brief Canal exportado por VL53L0X_Driver */
+#define VL53L0X_CH_DISTANCE					0
+
+/** @brief Registradores usados pelo driver */
+#define VL53L0X_SYSRANGE_START				0x00
+#define VL53L0X_SYSTEM_SEQUENCE_CONFIG		0x01
+#define VL53L0X_SYSTEM_INTERMEASUREMENT		0x04
+#define VL53L0X_SYSTEM_INTERRUPT_GPIO		0x0A
+#define VL53L0X_SYSTEM_INTERRUPT_CLEAR		0x0B
+#define VL53L0X_RESULT_INTERRUPT_STATUS		0x13
+#define VL53L0X_RESULT_RANGE_STATUS			0x14
+#define VL53L0X_MSRC_CONFIG_CONTROL			0x60
+#define VL53L0X_FINAL_RANGE_MIN_SIGNAL		0x44
+#define VL53L0X_MSRC_CONFIG_TIMEOUT			0x46
+#define VL53L0X_PRE_RANGE_VCSEL_PERIOD		0x50
+#define VL53L0X_PRE_RANGE_TIMEOUT			0x51
+#define VL53L0X_FINAL_RANGE_VCSEL_PERIOD	0x70
+#define VL53L0X_FINAL_RANGE_TIMEOUT			0x71
+#define VL53L0X_GPIO_HV_MUX_ACTIVE_HIGH		0x84
+#define VL53L0X_VHV_CONFIG_PAD_SCL_SDA		0x89
+#define VL53L0X_SPAD_ENABLES_REF_0			0xB0
+#define VL53L0X_SPAD_REF_EN_START_SELECT	0xB6
+#define VL53L0X_DYNAMIC_SPAD_NUM_REF		0x4E
+#define VL53L0X_DYNAMIC_SPAD_REF_OFFSET		0x4F
+#define VL53L0X_OSC_CALIBRATE_VAL			0xF8
+#define VL53L0X_IDENTIFICATION_MODEL_ID		0xC0
+
+#define VL53L0X_MODEL_ID					0xEE
+
+/** @brief Bits de SYSRANGE_START */
+#define VL53L0X_START_SINGLE				0x01
+#define VL53L0X_START_BACK_TO_BACK			0x02
+#define VL53L0X_START_TIMED					0x04
+
+/** @brief Status do dispositivo para uma medida valida */
+#define VL53L0X_RANGE_VALID					11
+
+/** @brief Limites do orcamento de tempo em us */
+#define VL53L0X_BUDGET_MIN_US				20000
+#define VL53L0X_BUDGET_DEFAULT_US			33000
+#define VL53L0X_BUDGET_ACCURATE_US			200000
+
+/** @brief Espera maxima por uma medida ou calibracao */
+#define VL53L0X_TIMEOUT_MS					500
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Uma medida */
+typedef struct
+{
+	uint16_t range_mm;      /**< Distancia */
+	uint8_t status;         /**< Status do dispositivo; VL53L0X_RANGE_VALID se valida */
+	uint16_t signal;        /**< Taxa de retorno do alvo em MCPS (ponto fixo 9.7) */
+	uint16_t ambient;       /**< Taxa ambiente em MCPS (ponto fixo 9.7) */
+	uint16_t spads;         /**< SPADs efetivos (ponto fixo 8.8) */
+} VL53L0X_Result_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Guarda o barramento usado pelo driver.
+ * @param hI2Handler I2C do sensor.
+ */
+void VL53L0X_attach(I2C_HandleTypeDef *hI2Handler);
+
+/**
+ * Inicializa o sensor: ajustes, SPADs de referencia, GPIO1 e calibracao.
+ * @param DeviceAddr Endereco I2C.
+ * @return HAL_OK, HAL_TIMEOUT se o sensor nao completou alguma etapa.
+ */
+HAL_StatusTypeDef VL53L0X_Init(uint16_t DeviceAddr);
+
+/**
+ * Le o registrador de identificacao do modelo.
+ * @return VL53L0X_MODEL_ID se o sensor respondeu.
+ */
+uint8_t VL53L0X_ReadID(uint16_t DeviceAddr);
+
+/**
+ * Configura o orcamento de tempo de cada medida. Com medidas em andamento,
+ * para e reinicia no mesmo modo.
+ * @param budget_us VL53L0X_BUDGET_MIN_US ou mais.
+ * @return HAL_OK, HAL_ERROR se o orcamento nao cabe na sequencia.
+ */
+HAL_StatusTypeDef VL53L0X_SetTimingBudget(uint16_t DeviceAddr, uint32_t budget_us);
+
+/** @brief Orcamento de tempo atual em us. */
+uint32_t VL53L0X_GetTimingBudget(void);
+
+/**
+ * Inicia medidas continuas.
+ * @param period_ms 0 para emendar as medidas; senao o intervalo entre elas
+ * (modo temporizado), maior que o orcamento de tempo.
+ */
+HAL_StatusTypeDef VL53L0X_StartContinuous(uint16_t DeviceAddr, uint32_t period_ms);
+
+/** @brief Para as medidas continuas. */
+void VL53L0X_StopContinuous(uint16_t DeviceAddr);
+
+/**
+ * Periodo das medidas em andamento.
+ * @return Periodo em ms, 0 se parado. No modo continuo, o orcamento de tempo.
+ */
+uint32_t VL53L0X_GetPeriod(void);
+
+/**
+ * Inicia uma medida unica e aguarda o resultado.
+ * @param result Saida.
+ */
+HAL_StatusTypeDef VL53L0X_ReadSingle(uint16_t DeviceAddr, VL53L0X_Result_t *result);
+
+/**
+ * Le a ultima medida em uma rajada e limpa a interrupcao do GPIO1.
+ * @param result Saida.
+ */
+HAL_StatusTypeDef VL53L0X_ReadResult(uint16_t DeviceAddr, VL53L0X_Result_t *result);
+
+/** @brief true se ha medida nova (RESULT_INTERRUPT_STATUS). */
+bool VL53L0X_DataReady(uint16_t DeviceAddr);
+
+/**
+ * Trafego do driver desde o boot.
+ * @param transfers Transacoes I2C.
+ * @param bytes Bytes no barramento, enderecos incluidos.
+ */
+void VL53L0X_GetBusStats(uint32_t *transfers, uint32_t *bytes);
+
+//==============================================================================
+// SENSOR DRIVER INTERFACE
+//==============================================================================
+
+/** @brief Descritor do VL53L0X para o registro (distancia em mm). */
+extern const SensorDriver_t VL53L0X_Driver;
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _VL53L0X_H_ */
@@ -0,0 +1,253 @@
+/**
+ * @file    winstats.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Estatisticas em janelas deslizantes com atualizacao O(1)
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "winstats.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Idade de uma posicao do anel em relacao a amostra mais nova.
+ * @return 0 para a mais nova.
+ */
+static uint16_t WinStats_Age(const WinStats_t *ws, uint16_t pos, uint16_t newest);
+
+/**
+ * Insere uma posicao no fim da fila monotonica, descartando as que a nova
+ * amostra domina.
+ * @param q Fila.
+ * @param ring Anel de amostras.
+ * @param pos Posicao da nova amostra.
+ * @param is_max true para a fila do maximo.
+ */
+static void WinStats_DequePush(WinStatsDeque_t *q, const int32_t *ring, uint16_t pos, bool is_max);
+
+/**
+ * Remove da frente da fila as posicoes que sairam da janela.
+ * @param ws Sinal.
+ * @param q Fila.
+ * @param length Tamanho da janela.
+ * @param newest Posicao da amostra mais nova.
+ */
+static void WinStats_DequeExpire(const WinStats_t *ws, WinStatsDeque_t *q, uint16_t length, uint16_t newest);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint16_t WinStats_Age(const WinStats_t *ws, uint16_t pos, uint16_t newest)
+{
+	return (uint16_t) ((newest >= pos) ? (newest - pos) : ((uint32_t) newest + ws->capacity - pos));
+}
+
+static void WinStats_DequePush(WinStatsDeque_t *q, const int32_t *ring, uint16_t pos, bool is_max)
+{
+	int32_t value = ring[pos];
+	uint16_t back;
+
+	while (q->count > 0)
+	{
+		back = (uint16_t) ((q->head + q->count - 1U) % q->size);
+
+		if ((is_max && (ring[q->pos[back]] > value)) || (!is_max && (ring[q->pos[back]] < value)))
+		{
+			break;
+		}
+		q->count--;
+	}
+
+	q->pos[(q->head + q->count) % q->size] = pos;
+	q->count++;
+}
+
+static void WinStats_DequeExpire(const WinStats_t *ws, WinStatsDeque_t *q, uint16_t length, uint16_t newest)
+{
+	while ((q->count > 0) && (WinStats_Age(ws, q->pos[q->head], newest) >= length))
+	{
+		q->head = (uint16_t) ((q->head + 1U) % q->size);
+		q->count--;
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+uint32_t WinStats_MemSize(const uint16_t *lengths, uint8_t count)
+{
+	uint32_t capacity = 0;
+	uint32_t deques = 0;
+	uint8_t i;
+
+	if ((count == 0) || (count > WINSTATS_MAX_WINDOWS))
+	{
+		return 0;
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		if ((lengths[i] == 0) || (lengths[i] > WINSTATS_MAX_LENGTH))
+		{
+			return 0;
+		}
+
+		capacity = (lengths[i] > capacity) ? lengths[i] : capacity;
+
+		/* Duas filas por janela, alinhadas em 4 bytes */
+		deques += 2UL * (((uint32_t) lengths[i] * sizeof(uint16_t) + 3UL) & ~3UL);
+	}
+
+	/* Uma posicao a mais: a amostra que sai da maior janela ainda tem idade distinta */
+	return (capacity + 1UL) * sizeof(int32_t) + deques;
+}
+
+bool WinStats_Init(WinStats_t *ws, const uint16_t *lengths, uint8_t count, void *mem, uint32_t size)
+{
+	uint8_t *p = (uint8_t *) mem;
+	uint32_t bytes;
+	uint8_t i;
+
+	if ((WinStats_MemSize(lengths, count) == 0) || (WinStats_MemSize(lengths, count) > size))
+	{
+		return false;
+	}
+
+	memset(ws, 0, sizeof(WinStats_t));
+	ws->num_windows = count;
+
+	for (i = 0; i < count; i++)
+	{
+		ws->capacity = (lengths[i] > ws->capacity) ? lengths[i] : ws->capacity;
+	}
+	ws->capacity++;
+
+	ws->ring = (int32_t *) p;
+	p += ws->capacity * sizeof(int32_t);
+
+	for (i = 0; i < count; i++)
+	{
+		bytes = ((uint32_t) lengths[i] * sizeof(uint16_t) + 3UL) & ~3UL;
+
+		ws->windows[i].length = lengths[i];
+		ws->windows[i].min.pos = (uint16_t *) p;
+		ws->windows[i].min.size = lengths[i];
+		p += bytes;
+		ws->windows[i].max.pos = (uint16_t *) p;
+		ws->windows[i].max.size = lengths[i];
+		p += bytes;
+	}
+
+	return true;
+}
+
+void WinStats_Reset(WinStats_t *ws)
+{
+	WinStatsWindow_t *w;
+	uint8_t i;
+
+	ws->next = 0;
+	ws->total = 0;
+	ws->offset = 0;
+
+	for (i = 0; i < ws->num_windows; i++)
+	{
+		w = &ws->windows[i];
+		w->count = 0;
+		w->sum = 0;
+		w->sumsq = 0;
+		w->min.head = w->min.count = 0;
+		w->max.head = w->max.count = 0;
+	}
+}
+
+void WinStats_Push(WinStats_t *ws, int32_t value)
+{
+	WinStatsWindow_t *w;
+	uint16_t pos = ws->next;
+	uint16_t out;
+	int64_t d;
+	uint8_t i;
+
+	if (ws->total == 0)
+	{
+		ws->offset = value;
+	}
+
+	/* Antes de sobrescrever o anel: a janela cheia perde a amostra mais velha */
+	for (i = 0; i < ws->num_windows; i++)
+	{
+		w = &ws->windows[i];
+
+		if (w->count == w->length)
+		{
+			out = (uint16_t) ((pos >= w->length) ? (pos - w->length) : ((uint32_t) pos + ws->capacity - w->length));
+			d = (int64_t) ws->ring[out] - ws->offset;
+			w->sum -= d;
+			w->sumsq -= d * d;
+		}
+		else
+		{
+			w->count++;
+		}
+	}
+
+	ws->ring[pos] = value;
+	d = (int64_t) value - ws->offset;
+
+	for (i = 0; i < ws->num_windows; i++)
+	{
+		w = &ws->windows[i];
+
+		w->sum += d;
+		w->sumsq += d * d;
+
+		WinStats_DequeExpire(ws, &w->min, w->length, pos);
+		WinStats_DequeExpire(ws, &w->max, w->length, pos);
+		WinStats_DequePush(&w->min, ws->ring, pos, false);
+		WinStats_DequePush(&w->max, ws->ring, pos, true);
+	}
+
+	ws->next = (uint16_t) ((pos + 1U == ws->capacity) ? 0 : pos + 1U);
+	ws->total++;
+}
+
+bool WinStats_Get(const WinStats_t *ws, uint8_t window, WinStatsResult_t *result)
+{
+	const WinStatsWindow_t *w;
+	float mean, var;
+
+	if (window >= ws->num_windows)
+	{
+		return false;
+	}
+
+	w = &ws->windows[window];
+	if (w->count == 0)
+	{
+		return false;
+	}
+
+	mean = (float) w->sum / (float) w->count;
+	var = (float) w->sumsq / (float) w->count - mean * mean;
+
+	result->count = w->count;
+	result->mean = (float) ws->offset + mean;
+	result->std = (var > 0.0f) ? sqrtf(var) : 0.0f;
+	result->min = ws->ring[w->min.pos[w->min.head]];
+	result->max = ws->ring[w->max.pos[w->max.head]];
+
+	return true;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file    winstats.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Estatisticas em janelas deslizantes com atualizacao O(1)
+ * @details
+ * Um sinal guarda as ultimas amostras em um anel do tamanho da maior janela
+ * (mais uma posicao). Cada janela mantem:
+ *
+ *   - soma e soma dos quadrados em 64 bits (relativas a primeira amostra,
+ *     para a variancia nao perder precisao): a amostra que sai da janela e
+ *     subtraida, a que entra e somada;
+ *   - minimo e maximo por filas monotonicas: cada amostra entra e sai da
+ *     fila uma vez, entao o custo amortizado por amostra e constante.
+ *
+ * As filas guardam posicoes do anel em 16 bits. A memoria e passada pelo
+ * chamador (WinStats_MemSize diz quanto) para ficar onde a aplicacao quiser.
+ * O codigo e C puro, sem dependencias do HAL.
+ */
+
+#ifndef _WINSTATS_H_
+#define _WINSTATS_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Janelas maximas por sinal */
+#define WINSTATS_MAX_WINDOWS		3
+
+/** @brief Amostras maximas de uma janela (posicoes de 16 bits) */
+#define WINSTATS_MAX_LENGTH			65534U
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Fila circular de posicoes do anel */
+typedef struct
+{
+	uint16_t *pos;
+	uint16_t size;
+	uint16_t head;
+	uint16_t count;
+} WinStatsDeque_t;
+
+/** @brief Uma janela de um sinal */
+typedef struct
+{
+	uint16_t length;        /**< Tamanho em amostras */
+	uint16_t count;         /**< Amostras dentro da janela (ate length) */
+	int64_t sum;
+	int64_t sumsq;
+	WinStatsDeque_t min;    /**< Frente = posicao do minimo */
+	WinStatsDeque_t max;    /**< Frente = posicao do maximo */
+} WinStatsWindow_t;
+
+/** @brief Estado de um sinal */
+typedef struct
+{
+	int32_t *ring;
+	uint16_t capacity;      /**< Maior janela mais 1 */
+	uint16_t next;          /**< Posicao da proxima amostra */
+	uint32_t total;         /**< Amostras recebidas */
+	int32_t offset;         /**< Primeira amostra: referencia das somas */
+	uint8_t num_windows;
+	WinStatsWindow_t windows[WINSTATS_MAX_WINDOWS];
+} WinStats_t;
+
+/** @brief Resultado de uma janela */
+typedef struct
+{
+	uint16_t count;
+	float mean;
+	float std;              /**< Desvio padrao populacional */
+	int32_t min;
+	int32_t max;
+} WinStatsResult_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Memoria necessaria para um conjunto de janelas.
+ * @param lengths Tamanho de cada janela em amostras.
+ * @param count Quantidade de janelas (ate WINSTATS_MAX_WINDOWS).
+ * @return Bytes, ou 0 se a configuracao for invalida.
+ */
+uint32_t WinStats_MemSize(const uint16_t *lengths, uint8_t count);
+
+/**
+ * Inicia um sinal sobre a memoria dada.
+ * @param ws Sinal.
+ * @param lengths Tamanho de cada janela em amostras.
+ * @param count Quantidade de janelas.
+ * @param mem Memoria alinhada em 4 bytes.
+ * @param size Bytes disponiveis em mem (pelo menos WinStats_MemSize).
+ * @return false se a configuracao for invalida ou a memoria nao bastar.
+ */
+bool WinStats_Init(WinStats_t *ws, const uint16_t *lengths, uint8_t count, void *mem, uint32_t size);
+
+/**
+ * Esvazia as janelas mantendo a configuracao.
+ * @param ws Sinal.
+ */
+void WinStats_Reset(WinStats_t *ws);
+
+/**
+ * Acrescenta uma amostra a todas as janelas.
+ * @param ws Sinal.
+ * @param value Amostra.
+ */
+void WinStats_Push(WinStats_t *ws, int32_t value);
+
+/**
+ * Le as estatisticas de uma janela.
+ * @param ws Sinal.
+ * @param window Indice da janela.
+ * @param result Saida.
+ * @return false se a janela nao existe ou esta vazia.
+ */
+bool WinStats_Get(const WinStats_t *ws, uint8_t window, WinStatsResult_t *result);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _WINSTATS_H_ */
@@ -13,6 +13,9 @@
 
 #include "setup_debug.h"
 #include "micro-shell/micro-shell.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
 
 //==============================================================================
 // PRIVATE DEFINITIONS
@@ -38,10 +41,75 @@ static uint8_t bufferSerial[SERIAL_BUFFER_SIZE];
 volatile uint8_t dataRX;  /* byte usado para receber os dados vindos da serial via DMA */
 SemaphoreHandle_t mutex_debug;
 
+static uint8_t txRing[DEBUG_TX_BUFFER_SIZE];
+static volatile uint16_t txHead = 0;   /* Proxima posicao livre */
+static volatile uint16_t txTail = 0;   /* Inicio do bloco entregue ao DMA */
+static volatile uint16_t txChunk = 0;  /* Bytes em transmissao (0 = DMA ocioso) */
+static SemaphoreHandle_t sem_debugTx = NULL;
+static DebugTxStats_t txStats;
+
+static volatile uint16_t rxCount = 0;       /* Bytes da linha em recepcao */
+static volatile uint16_t rxLineLen = 0;     /* Bytes da ultima linha, com o terminador */
+static volatile uint64_t rxLineStamp = 0;   /* Timebase_Us do terminador da ultima linha */
+
 //==============================================================================
 // PRIVATE FUNCTIONS
 //==============================================================================
 
+/** @brief Bytes ocupados na fila de transmissao. */
+static uint16_t Debug_TxUsed(void);
+
+/**
+ * Bytes que ainda saem antes de um bloco colocado agora na fila: a fila
+ * menos o que o DMA ja levou do bloco em transmissao. Chamada em secao
+ * critica.
+ */
+static uint16_t Debug_TxPending(void);
+
+/**
+ * Entrega ao DMA o proximo bloco continuo da fila, se ele estiver ocioso.
+ * Chamada em secao critica ou na interrupcao da USART.
+ */
+static void Debug_TxStart(void);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint16_t Debug_TxUsed(void)
+{
+	return (uint16_t) ((txHead + DEBUG_TX_BUFFER_SIZE - txTail) % DEBUG_TX_BUFFER_SIZE);
+}
+
+static uint16_t Debug_TxPending(void)
+{
+	uint16_t used = Debug_TxUsed();
+
+	if (txChunk != 0)
+	{
+		/* CNDTR = bytes do bloco que o DMA ainda nao copiou para o TDR */
+		used = (uint16_t) (used - txChunk + __HAL_DMA_GET_COUNTER(pUartDebug->hdmatx));
+	}
+
+	return used;
+}
+
+static void Debug_TxStart(void)
+{
+	if ((txChunk != 0) || (txHead == txTail))
+	{
+		return;
+	}
+
+	/* Ate o fim do buffer; o resto vai no proximo bloco */
+	txChunk = (txHead > txTail) ? (txHead - txTail) : (DEBUG_TX_BUFFER_SIZE - txTail);
+
+	if (HAL_UART_Transmit_DMA(pUartDebug, &txRing[txTail], txChunk) != HAL_OK)
+	{
+		txChunk = 0;
+	}
+}
+
 //==============================================================================
 // SOURCE CODE
 //==============================================================================
@@ -76,6 +144,121 @@ void Debug_RX_Init(UART_HandleTypeDef *pUart)
 		DBG_ASSERT_PARAM(mutex_debug);
 	}
 
+	if (sem_debugTx == NULL)
+	{
+		sem_debugTx = xSemaphoreCreateBinary();
+		DBG_ASSERT_PARAM(sem_debugTx);
+		vQueueAddToRegistry(sem_debugTx, "debugTx");
+	}
+
+}
+
+void Debug_TX_Complete(BaseType_t *pxHigherPriorityTaskWoken)
+{
+	txTail = (txTail + txChunk) % DEBUG_TX_BUFFER_SIZE;
+	txChunk = 0;
+
+	Debug_TxStart();
+
+	/* Acorda quem espera espaco na fila */
+	xSemaphoreGiveFromISR(sem_debugTx, pxHigherPriorityTaskWoken);
+}
+
+void Debug_RX_Byte(uint8_t data)
+{
+	rxCount++;
+
+	/* Mesmo criterio do micro-shell: terminador sozinho nao fecha linha */
+	if ((data == '\r') || (data == '\n'))
+	{
+		if (rxCount > 1)
+		{
+			rxLineStamp = Timebase_Us();
+			rxLineLen = rxCount;
+		}
+		rxCount = 0;
+	}
+}
+
+void Debug_GetRxLine(uint64_t *stamp_us, uint16_t *len)
+{
+	taskENTER_CRITICAL();
+	*stamp_us = rxLineStamp;
+	*len = rxLineLen;
+	taskEXIT_CRITICAL();
+}
+
+HAL_StatusTypeDef Debug_Write(const uint8_t *data, uint16_t len, TickType_t timeout)
+{
+	return Debug_WriteStamp(data, len, timeout, NULL);
+}
+
+HAL_StatusTypeDef Debug_WriteStamp(const uint8_t *data, uint16_t len, TickType_t timeout, uint64_t *start_us)
+{
+	TickType_t start = xTaskGetTickCount();
+	TickType_t elapsed;
+	uint16_t first, used, pending;
+
+	if ((pUartDebug == NULL) || (len >= DEBUG_TX_BUFFER_SIZE))
+	{
+		return HAL_ERROR;
+	}
+
+	for (;;)
+	{
+		taskENTER_CRITICAL();
+
+		used = Debug_TxUsed();
+		if ((DEBUG_TX_BUFFER_SIZE - 1 - used) >= len)
+		{
+			if (start_us != NULL)
+			{
+				/* Com o DMA ativo ainda ha um byte no TDR alem do que o CNDTR conta */
+				pending = Debug_TxPending() + ((txChunk != 0) ? 1 : 0);
+				*start_us = Timebase_Us() + (uint64_t) pending * DEBUG_BITS_PER_BYTE * 1000000ULL
+						/ pUartDebug->Init.BaudRate;
+			}
+
+			/* Copia inteira dentro da secao critica: quadros nunca se misturam */
+			first = DEBUG_TX_BUFFER_SIZE - txHead;
+			if (first > len)
+			{
+				first = len;
+			}
+			memcpy(&txRing[txHead], data, first);
+			memcpy(txRing, data + first, len - first);
+			txHead = (txHead + len) % DEBUG_TX_BUFFER_SIZE;
+
+			txStats.bytes += len;
+			if ((used + len) > txStats.used_max)
+			{
+				txStats.used_max = used + len;
+			}
+
+			Debug_TxStart();
+
+			taskEXIT_CRITICAL();
+			return HAL_OK;
+		}
+
+		taskEXIT_CRITICAL();
+
+		elapsed = xTaskGetTickCount() - start;
+		if (elapsed >= timeout)
+		{
+			txStats.dropped++;
+			return HAL_BUSY;
+		}
+
+		xSemaphoreTake(sem_debugTx, timeout - elapsed);
+	}
+}
+
+void Debug_GetTxStats(DebugTxStats_t *stats)
+{
+	taskENTER_CRITICAL();
+	*stats = txStats;
+	taskEXIT_CRITICAL();
 }
 
 uint8_t Debug_Get_Data(void)
@@ -95,7 +278,14 @@ HAL_StatusTypeDef Debug_Printf(char * format, ...)
 		len = vsnprintf((char *) bufferSerial, SERIAL_BUFFER_SIZE, format, args);
 		va_end(args);
 
-		resp = HAL_UART_Transmit(pUartDebug, bufferSerial, len, 1000);
+		/* vsnprintf devolve o tamanho que teria sem o corte */
+		if (len >= SERIAL_BUFFER_SIZE)
+		{
+			len = SERIAL_BUFFER_SIZE - 1;
+		}
+
+		/* Texto espera espaco na fila; so a telemetria descarta quadros */
+		resp = Debug_Write(bufferSerial, len, 1000);
 
 		xSemaphoreGive(mutex_debug);
 	}
@@ -63,6 +63,24 @@ extern "C" {
 #define SHELL_PRINTF(fmt, ...)      Debug_Printf(fmt"\r\n", ##__VA_ARGS__)
 #define DBG_ASSERT_PARAM(expr)     ((expr) ? (void)0U : Debug_AssertFailed(__FILE__, __LINE__))
 
+/** @brief Fila de transmissao esvaziada pelo DMA (texto e telemetria) */
+#define DEBUG_TX_BUFFER_SIZE        2048
+
+/** @brief Bits por byte na serial (8N1) */
+#define DEBUG_BITS_PER_BYTE         10
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Contadores da fila de transmissao da serial de debug */
+typedef struct
+{
+	uint32_t bytes;     /**< Bytes aceitos na fila */
+	uint32_t dropped;   /**< Escritas recusadas por falta de espaco */
+	uint16_t used_max;  /**< Maior ocupacao da fila em bytes */
+} DebugTxStats_t;
+
 //==============================================================================
 // PUBLIC FUNCTIONS
 //==============================================================================
@@ -71,6 +89,50 @@ extern "C" {
 uint8_t Debug_Get_Data(void);
 void Debug_RX_Init(UART_HandleTypeDef *pUart);
 HAL_StatusTypeDef Debug_Printf(char * format, ...);
+
+/**
+ * Coloca um bloco na fila de transmissao; o DMA envia em segundo plano.
+ * O bloco entra inteiro ou nao entra.
+ * @param data Bytes a enviar.
+ * @param len Tamanho do bloco.
+ * @param timeout Ticks de espera por espaco (0 = nao bloqueia).
+ * @return HAL_OK, HAL_BUSY se nao houve espaco a tempo.
+ */
+HAL_StatusTypeDef Debug_Write(const uint8_t *data, uint16_t len, TickType_t timeout);
+
+/**
+ * Debug_Write que tambem estima quando o primeiro byte do bloco comeca a
+ * sair: agora mais o tempo dos bytes que estao na frente dele na fila.
+ * @param data Bytes a enviar.
+ * @param len Tamanho do bloco.
+ * @param timeout Ticks de espera por espaco (0 = nao bloqueia).
+ * @param start_us Saida em Timebase_Us (so escrita quando o bloco entra).
+ * @return HAL_OK, HAL_BUSY se nao houve espaco a tempo.
+ */
+HAL_StatusTypeDef Debug_WriteStamp(const uint8_t *data, uint16_t len, TickType_t timeout, uint64_t *start_us);
+
+/**
+ * Conta um byte recebido e carimba o fim de cada linha; chamada na
+ * interrupcao de recepcao, antes de Shell_ISR_Getc.
+ * @param data Byte recebido.
+ */
+void Debug_RX_Byte(uint8_t data);
+
+/**
+ * Fim da ultima linha recebida (o byte do terminador).
+ * @param stamp_us Saida em Timebase_Us.
+ * @param len Saida com os bytes da linha, terminador incluido.
+ */
+void Debug_GetRxLine(uint64_t *stamp_us, uint16_t *len);
+
+/**
+ * Fim de um bloco do DMA de transmissao; chamada em HAL_UART_TxCpltCallback.
+ * @param pxHigherPriorityTaskWoken Repassado a xSemaphoreGiveFromISR.
+ */
+void Debug_TX_Complete(BaseType_t *pxHigherPriorityTaskWoken);
+
+/** @brief Copia os contadores da fila de transmissao. */
+void Debug_GetTxStats(DebugTxStats_t *stats);
 void Debug_AssertFailed(const char* s8File, int s16Line);
 
 
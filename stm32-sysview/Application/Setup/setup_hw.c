@@ -14,13 +14,23 @@
 #include "setup_hw.h"
 #include "setup_debug.h"
 #include "sensores.h"
+#include "sensor_cache.h"
+#include "app_ahrs.h"
+#include "app_magcal.h"
+#include "app_telemetry.h"
+#include "app_audio.h"
+#include "app_motion.h"
+#include "app_range.h"
+#include "app_winstats.h"
+#include "app_vibration.h"
+#include "app_filter.h"
+#include "app_baro.h"
+#include "app_timesync.h"
+#include "app_sysmon.h"
 
 #include "leds/leds.h"
-#include "hts221/hts221.h"
-#include "lps22hb/lps22hb.h"
-#include "lsm6dsl/lsm6dsl.h"
-#include "lis3mdl/lis3mdl.h"
 #include "micro-shell/micro-shell.h"
+#include "freertos_utils/freertos_utils.h"
 
 //==============================================================================
 // PRIVATE DEFINITIONS
@@ -34,6 +44,8 @@
 
 extern UART_HandleTypeDef huart1;
 extern I2C_HandleTypeDef hi2c2;
+extern TIM_HandleTypeDef htim6;
+extern TIM_HandleTypeDef htim15;
 
 //==============================================================================
 // PRIVATE VARIABLES
@@ -58,20 +70,26 @@ static void Setup_InitMiddlware(void)
     /* Inicializa Led */
 	Leds_Attach(N_LED1, GPIOB, GPIO_PIN_14, LED_ATIVE_HIGH);
 
-	HTS221_attach(&hi2c2);
-	HTS221_Init(HTS221_I2C_ADDRESS);
+	/* PB14 e o TIM15_CH1: os padroes do led 1 rodam no PWM, com passo do TIM6 */
+	Leds_AttachPwm(N_LED1, &htim15, TIM_CHANNEL_1, &htim6);
 
-	LPS22HB_attach(&hi2c2);
-	LPS22HB_Init(LPS22HB_I2C_ADDRESS);
+	/* Verifica, configura e registra os sensores do barramento I2C2 */
+	Sensores_Init(&hi2c2);
 
-	LSM6DSL_attach(&hi2c2);
-	LSM6DSL_myInit();
+	/* Carrega a calibracao do magnetometro gravada na flash */
+	AppMagCal_Init();
 
-	LIS3MDL_attach(&hi2c2);
-	LIS3MDL_myInit();
+	/* Janelas do cache dependem do ODR configurado nos sensores */
+	SensorCache_Init();
 
 	/* Inicializa recepcao de dado pela serial */
 	Debug_RX_Init(&huart1);
+
+	/* A recepcao circular do console pode ficar ligada em STOP2; o RX acorda a placa */
+	RTOS_LowPowerSetConsole(&huart1, ST_LINK_UART1_RX_GPIO_Port, ST_LINK_UART1_RX_Pin);
+
+	/* Pedidos de sincronizacao chegam pelo shell da mesma serial */
+	AppTimeSync_Init(huart1.Init.BaudRate);
 }
 
 static void Setup_InitApps(void)
@@ -80,16 +98,44 @@ static void Setup_InitApps(void)
 
 	DBG("%s[ OK ]%s\t %s\r\n", ANSI_COLOR_GREEN, DEF_CONSOLE_DEFAULT, "Mensagem Colorida");
 
+	/* Inicializa task de orientacao; as assinaturas ligam LSM6DSL e LIS3MDL */
+	AppAhrs_TaskInit();
+
 	Sensores_Read(&sens);
 	Sensor_Print(&sens);
-	Sensor_Print_SerialPlot(&sens);
+
+	/* Inicializa task de telemetria (parada ate o comando "tlm start") */
+	AppTelemetry_TaskInit();
+
+	/* Janelas deslizantes sem slots; acrescenta os sinais a telemetria */
+	AppWStats_TaskInit();
+
+	/* Inicializa task de audio (parada ate o comando "audio start") */
+	AppAudio_TaskInit();
+
+	/* Inicializa task de movimento (desarmada ate o comando "motion arm") */
+	AppMotion_TaskInit();
+
+	/* Inicializa task de distancia (parada ate o comando "range start") */
+	AppRange_TaskInit();
+
+	/* Inicializa task de vibracao (parada ate o comando "vib start") */
+	AppVib_TaskInit();
+
+	/* Cadeias de filtros vazias (configuradas pelo comando "filter set") */
+	AppFilter_Init();
+
+	/* Inicializa task do barometro (parada ate o comando "baro start") */
+	AppBaro_TaskInit();
+
+	/* Carga da CPU medida na task idle, sinais na telemetria e task do top (parada) */
+	AppSysMon_Init();
 
 	/* Inicializa task shell */
 	Shell_TaskInit(SHELL_MULTIPLY_TASK_SIZE);
 
 	Leds_TaskInit();
 	Leds_Set(N_LED1, LED_BLINK_HEARTBEAT);
-
 }
 
 void Setup_Init(void)
@@ -13,7 +13,12 @@
 #include "setup_hw_isr.h"
 #include "setup_hw.h"
 #include "setup_debug.h"
+#include "app_audio.h"
+#include "app_motion.h"
+#include "app_range.h"
+#include "app_baro.h"
 #include "micro-shell/micro-shell.h"
+#include "freertos_utils/freertos_utils.h"
 
 //==============================================================================
 // PRIVATE DEFINITIONS
@@ -46,6 +51,8 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *uart)
 	{
 		data = Debug_Get_Data();
 
+		Debug_RX_Byte(data);
+		RTOS_LowPowerConsoleActivity();
 		Shell_ISR_Getc(data, &xHigherPriorityTaskWoken);
 	}
 
@@ -55,6 +62,74 @@ void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef *uart)
 	}
 }
 
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *uart)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if(uart->Instance == USART1)
+	{
+		Debug_TX_Complete(&xHigherPriorityTaskWoken);
+	}
+
+	if( xHigherPriorityTaskWoken == pdTRUE )
+	{
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
+void HAL_DFSDM_FilterRegConvHalfCpltCallback(DFSDM_Filter_HandleTypeDef *hdfsdm_filter)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if(hdfsdm_filter->Instance == DFSDM1_Filter2)
+	{
+		AppAudio_DmaHalf(&xHigherPriorityTaskWoken);
+	}
+
+	if( xHigherPriorityTaskWoken == pdTRUE )
+	{
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
+void HAL_DFSDM_FilterRegConvCpltCallback(DFSDM_Filter_HandleTypeDef *hdfsdm_filter)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if(hdfsdm_filter->Instance == DFSDM1_Filter2)
+	{
+		AppAudio_DmaFull(&xHigherPriorityTaskWoken);
+	}
+
+	if( xHigherPriorityTaskWoken == pdTRUE )
+	{
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if(GPIO_Pin == LSM6DSL_INT1_EXTI11_Pin)
+	{
+		AppMotion_Int(&xHigherPriorityTaskWoken);
+	}
+	else if(GPIO_Pin == VL53L0X_GPIO1_EXTI7_Pin)
+	{
+		AppRange_Int(&xHigherPriorityTaskWoken);
+	}
+	else if(GPIO_Pin == LPS22HB_INT_DRDY_EXTI0_Pin)
+	{
+		AppBaro_Int(&xHigherPriorityTaskWoken);
+	}
+
+	if( xHigherPriorityTaskWoken == pdTRUE )
+	{
+		portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+	}
+}
+
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *uart)
 {
 	if(uart->Instance == USART1)
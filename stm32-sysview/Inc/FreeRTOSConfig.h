@@ -136,6 +136,11 @@ standard names. */
 /* Definitions needed when configGENERATE_RUN_TIME_STATS is on */
 #define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS configureTimerForRunTimeStats
 #define portGET_RUN_TIME_COUNTER_VALUE getRunTimeCounterValue    
+
+/* Tickless idle: the tick comes from LPTIM1 on the LSE and the idle task
+enters STOP2 between events (Application/Libs/freertos_utils/freertos_lowpower.c) */
+#define configUSE_TICKLESS_IDLE                  1
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP    2
 /* USER CODE END 2 */
 
 /* USER CODE BEGIN Defines */   	      
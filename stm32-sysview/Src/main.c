@@ -25,7 +25,10 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "setup_hw.h"
+#include "leds/leds.h"
 #include "freertos_utils/freertos_utils.h"
+#include "timebase/timebase.h"
+#include "cpuload/cpuload.h"
 
 #if defined(USE_SYSVIEW)
 #include "SEGGER_SYSVIEW.h" // include SystemView header file
@@ -70,7 +73,11 @@ PCD_HandleTypeDef hpcd_USB_OTG_FS;
 
 osThreadId defaultTaskHandle;
 /* USER CODE BEGIN PV */
-
+TIM_HandleTypeDef htim6;
+TIM_HandleTypeDef htim15;
+DMA_HandleTypeDef hdma_tim6_up;
+DFSDM_Filter_HandleTypeDef hdfsdm1_filter2;
+DMA_HandleTypeDef hdma_dfsdm1_flt2;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
@@ -89,6 +96,7 @@ static void MX_TIM16_Init(void);
 void StartDefaultTask(void const * argument);
 
 /* USER CODE BEGIN PFP */
+static void LED_PWM_Init(void);
 
 /* USER CODE END PFP */
 
@@ -137,6 +145,10 @@ int main(void)
   MX_IWDG_Init();
   MX_TIM16_Init();
   /* USER CODE BEGIN 2 */
+  LED_PWM_Init();
+
+  /* DWT CYCCNT: SystemView timestamps, run-time stats and sample stamps */
+  Timebase_Init();
 
   /* USER CODE END 2 */
 
@@ -150,7 +162,6 @@ int main(void)
 
   /* USER CODE BEGIN RTOS_TIMERS */
   /* start timers, add new ones, ... */
-  RTOS_TimerAttachStatics20Khz(&htim16);
   /* USER CODE END RTOS_TIMERS */
 
   /* USER CODE BEGIN RTOS_QUEUES */
@@ -298,6 +309,43 @@ static void MX_DFSDM1_Init(void)
   }
   /* USER CODE BEGIN DFSDM1_Init 2 */
 
+  /* MP34DT01 microphone accepts 1 to 3.25 MHz: 80 MHz / 40 = 2 MHz (16 kHz
+     with FOSR 125). The audio task reprograms divider and FOSR per rate. */
+  HAL_DFSDM_ChannelDeInit(&hdfsdm1_channel1);
+  hdfsdm1_channel1.Init.OutputClock.Divider = 40;
+  if (HAL_DFSDM_ChannelInit(&hdfsdm1_channel1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* Filter 2 on channel 1 (DATIN2 pins), regular continuous conversions
+     moved by DMA1 Channel 6 (DMA1 Channels 4 and 5 serve USART1) */
+  hdfsdm1_filter2.Instance = DFSDM1_Filter2;
+  hdfsdm1_filter2.Init.RegularParam.Trigger = DFSDM_FILTER_SW_TRIGGER;
+  hdfsdm1_filter2.Init.RegularParam.FastMode = ENABLE;
+  hdfsdm1_filter2.Init.RegularParam.DmaMode = ENABLE;
+  hdfsdm1_filter2.Init.InjectedParam.Trigger = DFSDM_FILTER_SW_TRIGGER;
+  hdfsdm1_filter2.Init.InjectedParam.ScanMode = DISABLE;
+  hdfsdm1_filter2.Init.InjectedParam.DmaMode = DISABLE;
+  hdfsdm1_filter2.Init.InjectedParam.ExtTrigger = DFSDM_FILTER_EXT_TRIG_TIM1_TRGO;
+  hdfsdm1_filter2.Init.InjectedParam.ExtTriggerEdge = DFSDM_FILTER_EXT_TRIG_RISING_EDGE;
+  hdfsdm1_filter2.Init.FilterParam.SincOrder = DFSDM_FILTER_SINC3_ORDER;
+  hdfsdm1_filter2.Init.FilterParam.Oversampling = 125;
+  hdfsdm1_filter2.Init.FilterParam.IntOversampling = 1;
+  if (HAL_DFSDM_FilterInit(&hdfsdm1_filter2) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  if (HAL_DFSDM_FilterConfigRegChannel(&hdfsdm1_filter2, DFSDM_CHANNEL_1, DFSDM_CONTINUOUS_CONV_ON) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* DMA1_Channel6_IRQn interrupt configuration */
+  HAL_NVIC_SetPriority(DMA1_Channel6_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(DMA1_Channel6_IRQn);
+
   /* USER CODE END DFSDM1_Init 2 */
 
 }
@@ -786,6 +834,90 @@ static void MX_GPIO_Init(void)
 
 /* USER CODE BEGIN 4 */
 
+/**
+  * @brief LED2 (PB14) on TIM15 CH1 PWM, with the pattern tables moved to
+  *        TIM15->CCR1 by DMA2 Channel 4 on each TIM6 update.
+  *        TIM15 CH1 DMA is only on DMA1 Channel 5, which serves USART1 RX,
+  *        so the step clock comes from TIM6 (DMA2 Channel 4, request 3).
+  * @param None
+  * @retval None
+  */
+static void LED_PWM_Init(void)
+{
+  TIM_OC_InitTypeDef sConfigOC = {0};
+  TIM_MasterConfigTypeDef sMasterConfig = {0};
+  GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+  __HAL_RCC_TIM6_CLK_ENABLE();
+  __HAL_RCC_TIM15_CLK_ENABLE();
+  __HAL_RCC_DMA2_CLK_ENABLE();
+
+  /* 1 kHz PWM, duty in LEDS_LEVEL_MAX steps */
+  htim15.Instance = TIM15;
+  htim15.Init.Prescaler = 80-1;
+  htim15.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim15.Init.Period = LEDS_LEVEL_MAX-1;
+  htim15.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
+  htim15.Init.RepetitionCounter = 0;
+  htim15.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
+  if (HAL_TIM_PWM_Init(&htim15) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sConfigOC.OCMode = TIM_OCMODE_PWM1;
+  sConfigOC.Pulse = 0;
+  sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+  sConfigOC.OCNPolarity = TIM_OCNPOLARITY_HIGH;
+  sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+  sConfigOC.OCIdleState = TIM_OCIDLESTATE_RESET;
+  sConfigOC.OCNIdleState = TIM_OCNIDLESTATE_RESET;
+  if (HAL_TIM_PWM_ConfigChannel(&htim15, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* Step clock at LEDS_STEP_CLOCK_HZ; the LED library sets the period per table */
+  htim6.Instance = TIM6;
+  htim6.Init.Prescaler = (SystemCoreClock / LEDS_STEP_CLOCK_HZ)-1;
+  htim6.Init.CounterMode = TIM_COUNTERMODE_UP;
+  htim6.Init.Period = 1000-1;
+  htim6.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  if (HAL_TIM_Base_Init(&htim6) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  if (HAL_TIMEx_MasterConfigSynchronization(&htim6, &sMasterConfig) != HAL_OK)
+  {
+    Error_Handler();
+  }
+
+  /* Circular table -> CCR, no interrupts */
+  hdma_tim6_up.Instance = DMA2_Channel4;
+  hdma_tim6_up.Init.Request = DMA_REQUEST_3;
+  hdma_tim6_up.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_tim6_up.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_tim6_up.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_tim6_up.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+  hdma_tim6_up.Init.MemDataAlignment = DMA_MDATAALIGN_HALFWORD;
+  hdma_tim6_up.Init.Mode = DMA_CIRCULAR;
+  hdma_tim6_up.Init.Priority = DMA_PRIORITY_LOW;
+  if (HAL_DMA_Init(&hdma_tim6_up) != HAL_OK)
+  {
+    Error_Handler();
+  }
+  __HAL_LINKDMA(&htim6,hdma[TIM_DMA_ID_UPDATE],hdma_tim6_up);
+
+  /* PB14 from GPIO output (MX_GPIO_Init) to TIM15_CH1 */
+  GPIO_InitStruct.Pin = LED2_Pin;
+  GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+  GPIO_InitStruct.Pull = GPIO_NOPULL;
+  GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
+  GPIO_InitStruct.Alternate = GPIO_AF14_TIM15;
+  HAL_GPIO_Init(LED2_GPIO_Port, &GPIO_InitStruct);
+}
+
 /* USER CODE END 4 */
 
 /* USER CODE BEGIN Header_StartDefaultTask */
@@ -809,6 +941,12 @@ void StartDefaultTask(void const * argument)
    // osThreadTerminate(StartDefaultTask);
 	  osDelay(1000);
 	  HAL_IWDG_Refresh(&hiwdg);
+
+	  /* Nao deixa o CYCCNT dar a volta sem ser visto */
+	  Timebase_Update();
+
+	  /* Fecha o intervalo de um segundo da carga da CPU */
+	  CpuLoad_Update();
   }
   /* USER CODE END 5 */ 
 }
@@ -830,10 +968,7 @@ void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
     HAL_IncTick();
   }
   /* USER CODE BEGIN Callback 1 */
-  if ( htim->Instance == TIM16 )
-  {
-	  RTOS_ISR_Timer20Khz();
-  }
+
   /* USER CODE END Callback 1 */
 }
 
@@ -661,6 +661,50 @@ void HAL_PCD_MspDeInit(PCD_HandleTypeDef* hpcd)
 
 /* USER CODE BEGIN 1 */
 
+extern DMA_HandleTypeDef hdma_dfsdm1_flt2;
+
+/**
+* @brief DFSDM_Filter MSP Initialization
+* Regular conversions of DFSDM1 Filter 2 go to memory through DMA1 Channel 6
+* (request 0), circular, one 32-bit word per sample.
+* @param hdfsdm_filter: DFSDM_Filter handle pointer
+* @retval None
+*/
+void HAL_DFSDM_FilterMspInit(DFSDM_Filter_HandleTypeDef* hdfsdm_filter)
+{
+  if(hdfsdm_filter->Instance == DFSDM1_Filter2)
+  {
+    hdma_dfsdm1_flt2.Instance = DMA1_Channel6;
+    hdma_dfsdm1_flt2.Init.Request = DMA_REQUEST_0;
+    hdma_dfsdm1_flt2.Init.Direction = DMA_PERIPH_TO_MEMORY;
+    hdma_dfsdm1_flt2.Init.PeriphInc = DMA_PINC_DISABLE;
+    hdma_dfsdm1_flt2.Init.MemInc = DMA_MINC_ENABLE;
+    hdma_dfsdm1_flt2.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    hdma_dfsdm1_flt2.Init.MemDataAlignment = DMA_MDATAALIGN_WORD;
+    hdma_dfsdm1_flt2.Init.Mode = DMA_CIRCULAR;
+    hdma_dfsdm1_flt2.Init.Priority = DMA_PRIORITY_HIGH;
+    if (HAL_DMA_Init(&hdma_dfsdm1_flt2) != HAL_OK)
+    {
+      Error_Handler();
+    }
+
+    __HAL_LINKDMA(hdfsdm_filter,hdmaReg,hdma_dfsdm1_flt2);
+  }
+}
+
+/**
+* @brief DFSDM_Filter MSP De-Initialization
+* @param hdfsdm_filter: DFSDM_Filter handle pointer
+* @retval None
+*/
+void HAL_DFSDM_FilterMspDeInit(DFSDM_Filter_HandleTypeDef* hdfsdm_filter)
+{
+  if(hdfsdm_filter->Instance == DFSDM1_Filter2)
+  {
+    HAL_DMA_DeInit(hdfsdm_filter->hdmaReg);
+  }
+}
+
 /* USER CODE END 1 */
 
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
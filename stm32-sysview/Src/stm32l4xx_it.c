@@ -67,7 +67,7 @@ extern UART_HandleTypeDef huart3;
 extern TIM_HandleTypeDef htim17;
 
 /* USER CODE BEGIN EV */
-
+extern DMA_HandleTypeDef hdma_dfsdm1_flt2;
 /* USER CODE END EV */
 
 /******************************************************************************/
@@ -311,5 +311,21 @@ void EXTI15_10_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief This function handles DMA1 channel6 global interrupt (DFSDM1 filter 2).
+  */
+void DMA1_Channel6_IRQHandler(void)
+{
+#if defined(USE_SYSVIEW)
+  SEGGER_SYSVIEW_RecordEnterISR();
+#endif
+
+  HAL_DMA_IRQHandler(&hdma_dfsdm1_flt2);
+
+#if defined(USE_SYSVIEW)
+  SEGGER_SYSVIEW_RecordExitISR();
+#endif
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,588 @@
+/**
+ * @file    ahrs_bench.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.1
+ * @brief   Confere e mede no PC o filtro de Application/Libs/ahrs
+ * @details
+ * Compilar (dentro de Tools/ahrs):
+ *
+ *   gcc -O2 -Wall -I../../Application/Libs ahrs_bench.c \
+ *       ../../Application/Libs/ahrs/ahrs.c -lm -o ahrs_bench
+ *
+ * Gera uma trajetoria conhecida (velocidade angular senoidal nos tres eixos,
+ * integrada em double com subpassos), e dela as leituras de giroscopio (com
+ * bias e ruido), acelerometro e magnetometro. As amostras chegam a 52 Hz com
+ * jitter e depois a 208 Hz, como quando app_motion sobe o ODR, e o dt de
+ * cada uma e passado por AHRS_SetPeriod como faz app_ahrs.
+ *
+ * A mesma sequencia passa pela lib e por uma referencia em double do mesmo
+ * filtro de Mahony (raiz exata em vez de AHRS_InvSqrt). Falha se a lib se
+ * afastar da referencia ou se alguma das duas se afastar da trajetoria
+ * depois de convergir. Com magnetometro compara a orientacao inteira; sem,
+ * so a inclinacao, ja que o rumo nao e observavel.
+ *
+ * Confere tambem AHRS_VerticalAccel com leituras no formato do canal do
+ * LSM6DSL (ug: "mg" com scale 1000): parada em qualquer orientacao da
+ * trajetoria a aceleracao vertical deve ser ~0 e, com 1 m/s2 para cima
+ * somado, ~1 m/s2.
+ *
+ * Por fim mede o tempo e os ciclos do PC por AHRS_Update (ciclos do TSC em
+ * x86). No alvo o comando "ahrs" do shell mostra os ciclos do DWT.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "ahrs/ahrs.h"
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAS_TSC			1
+#else
+#define BENCH_HAS_TSC			0
+#endif
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define BENCH_PI				3.14159265358979
+
+#define BENCH_RAD_TO_DEG		(180.0 / BENCH_PI)
+
+/** @brief Duracao de cada trecho (s) e taxas das amostras (Hz) */
+#define BENCH_SECONDS			60.0
+#define BENCH_RATE_LOW			52.0
+#define BENCH_RATE_HIGH			208.0
+
+/** @brief Jitter do instante das amostras (fracao do periodo) */
+#define BENCH_JITTER			0.1
+
+/** @brief Subpassos da integracao da trajetoria por amostra */
+#define BENCH_SUBSTEPS			64
+
+/** @brief Tempo para o filtro convergir antes de comparar com a trajetoria (s) */
+#define BENCH_SETTLE			20.0
+
+/** @brief Ruido das leituras: rad/s, fracao de 1 g e do campo */
+#define BENCH_GYRO_NOISE		0.005
+#define BENCH_ACC_NOISE			0.01
+#define BENCH_MAG_NOISE			0.01
+
+/**
+ * @brief Limites: lib contra referencia e filtro contra trajetoria (graus).
+ * Com AHRS_DEFAULT_KI o bias ainda nao convergiu e o Kp compensa com alguns
+ * graus de atraso; o limite contra a trajetoria so pega divergencia.
+ */
+#define BENCH_MAX_LIB_ERR		0.25
+#define BENCH_MAX_TRUTH_ERR		6.0
+
+/** @brief Folga sobre BENCH_SECONDS * (52 + 208) amostras */
+#define BENCH_MAX_SAMPLES		20000
+
+#define BENCH_MIN_SECONDS		0.2
+
+/** @brief Canal do acelerometro do LSM6DSL: mg com scale 1000, ou seja ug */
+#define BENCH_ACC_PER_G			(1000.0 * 1000.0)
+
+/** @brief Erro maximo de AHRS_VerticalAccel (m/s2) */
+#define BENCH_MAX_VERT_ERR		0.01
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Uma amostra dos tres sensores e a orientacao verdadeira */
+typedef struct
+{
+	double dt;
+	double gyro[3];
+	double acc[3];
+	double mag[3];
+	double q[4];
+	double t;
+} BenchSample_t;
+
+/** @brief Referencia em double do mesmo filtro da lib */
+typedef struct
+{
+	double q[4];
+	double bias[3];
+	double kp;
+	double ki;
+	double dt;
+} BenchRef_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static BenchSample_t samples[BENCH_MAX_SAMPLES];
+static int numSamples;
+
+/** @brief Bias do giroscopio simulado (rad/s) */
+static const double gyroBias[3] = { 0.010, -0.020, 0.015 };
+
+/** @brief Campo da terra no plano x-z, com inclinacao de ~37 graus */
+static const double earthMag[3] = { 0.4, 0.0, -0.3 };
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Segundos de um relogio monotonico. */
+static double Bench_Now(void);
+
+/** @brief Ruido gaussiano de desvio 1 (Box-Muller). */
+static double Bench_Gauss(void);
+
+/**
+ * Velocidade angular verdadeira no referencial da placa.
+ * @param t Instante em s.
+ * @param w Saida em rad/s.
+ */
+static void Bench_Rate(double t, double w[3]);
+
+/**
+ * Leva um vetor da terra para o referencial da placa (R(q) transposta).
+ * @param q Orientacao placa -> terra.
+ * @param v Vetor na terra.
+ * @param out Vetor na placa.
+ */
+static void Bench_ToBody(const double q[4], const double v[3], double out[3]);
+
+/**
+ * Angulo entre duas orientacoes.
+ * @param a Quaternion.
+ * @param b Quaternion.
+ * @param tilt_only true para comparar so a vertical (sem rumo).
+ * @return Graus.
+ */
+static double Bench_Angle(const double a[4], const double b[4], bool tilt_only);
+
+/**
+ * Gera a trajetoria e as leituras dos sensores.
+ */
+static void Bench_Generate(void);
+
+/**
+ * Uma iteracao da referencia, linha a linha igual a AHRS_Update.
+ * @param ref Estado.
+ * @param gyro rad/s.
+ * @param acc Qualquer unidade.
+ * @param mag Qualquer unidade ou NULL.
+ */
+static void Bench_RefUpdate(BenchRef_t *ref, const double gyro[3], const double acc[3], const double mag[3]);
+
+/**
+ * Passa a trajetoria pela lib e pela referencia e confere os erros.
+ * @param use_mag true para 9 eixos.
+ * @return Erros encontrados.
+ */
+static int Bench_Check(bool use_mag);
+
+/**
+ * Confere AHRS_VerticalAccel nas orientacoes da trajetoria.
+ * @return Erros encontrados.
+ */
+static int Bench_Vertical(void);
+
+/**
+ * Tempo e ciclos por AHRS_Update.
+ * @param use_mag true para 9 eixos.
+ * @param cycles Saida com os ciclos do TSC (0 sem TSC).
+ * @return ns por atualizacao.
+ */
+static double Bench_Time(bool use_mag, double *cycles);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static double Bench_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static double Bench_Gauss(void)
+{
+	double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * BENCH_PI * u2);
+}
+
+static void Bench_Rate(double t, double w[3])
+{
+	w[0] = 0.6 * sin(0.31 * t);
+	w[1] = 0.5 * sin(0.23 * t + 1.0);
+	w[2] = 0.4 * cos(0.17 * t);
+}
+
+static void Bench_ToBody(const double q[4], const double v[3], double out[3])
+{
+	double q0 = q[0], q1 = q[1], q2 = q[2], q3 = q[3];
+
+	out[0] = (1.0 - 2.0 * (q2 * q2 + q3 * q3)) * v[0] + 2.0 * (q1 * q2 + q0 * q3) * v[1] + 2.0 * (q1 * q3 - q0 * q2) * v[2];
+	out[1] = 2.0 * (q1 * q2 - q0 * q3) * v[0] + (1.0 - 2.0 * (q1 * q1 + q3 * q3)) * v[1] + 2.0 * (q2 * q3 + q0 * q1) * v[2];
+	out[2] = 2.0 * (q1 * q3 + q0 * q2) * v[0] + 2.0 * (q2 * q3 - q0 * q1) * v[1] + (1.0 - 2.0 * (q1 * q1 + q2 * q2)) * v[2];
+}
+
+static double Bench_Angle(const double a[4], const double b[4], bool tilt_only)
+{
+	static const double up[3] = { 0.0, 0.0, 1.0 };
+	double ua[3], ub[3], dot, na, nb;
+
+	if (tilt_only == true)
+	{
+		Bench_ToBody(a, up, ua);
+		Bench_ToBody(b, up, ub);
+		dot = ua[0] * ub[0] + ua[1] * ub[1] + ua[2] * ub[2];
+		na = sqrt(ua[0] * ua[0] + ua[1] * ua[1] + ua[2] * ua[2]);
+		nb = sqrt(ub[0] * ub[0] + ub[1] * ub[1] + ub[2] * ub[2]);
+
+		return acos(fmin(dot / (na * nb), 1.0)) * BENCH_RAD_TO_DEG;
+	}
+
+	/* q e -q sao a mesma orientacao */
+	dot = fabs(a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3]);
+	na = sqrt(a[0] * a[0] + a[1] * a[1] + a[2] * a[2] + a[3] * a[3]);
+	nb = sqrt(b[0] * b[0] + b[1] * b[1] + b[2] * b[2] + b[3] * b[3]);
+
+	return 2.0 * acos(fmin(dot / (na * nb), 1.0)) * BENCH_RAD_TO_DEG;
+}
+
+static void Bench_Generate(void)
+{
+	static const double up[3] = { 0.0, 0.0, 1.0 };
+	double q[4], w[3], qa, qb, qc, h, t = 0.0, norm, rate;
+	BenchSample_t *s;
+	int i, k;
+
+	/* Comeca inclinada e girada para o filtro (em identidade) ter o que convergir */
+	q[0] = cos(0.25);
+	q[1] = sin(0.25) * 0.6;
+	q[2] = sin(0.25) * -0.48;
+	q[3] = sin(0.25) * 0.64;
+
+	for (numSamples = 0; t < 2.0 * BENCH_SECONDS; numSamples++)
+	{
+		s = &samples[numSamples];
+		rate = (t < BENCH_SECONDS) ? BENCH_RATE_LOW : BENCH_RATE_HIGH;
+		s->dt = (1.0 + BENCH_JITTER * (2.0 * rand() / RAND_MAX - 1.0)) / rate;
+
+		h = s->dt / BENCH_SUBSTEPS;
+		for (k = 0; k < BENCH_SUBSTEPS; k++)
+		{
+			/* Ponto medio de cada subpasso */
+			Bench_Rate(t + (k + 0.5) * h, w);
+			qa = q[0];
+			qb = q[1];
+			qc = q[2];
+			q[0] += 0.5 * h * (-qb * w[0] - qc * w[1] - q[3] * w[2]);
+			q[1] += 0.5 * h * (qa * w[0] + qc * w[2] - q[3] * w[1]);
+			q[2] += 0.5 * h * (qa * w[1] - qb * w[2] + q[3] * w[0]);
+			q[3] += 0.5 * h * (qa * w[2] + qb * w[1] - qc * w[0]);
+			norm = sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+			for (i = 0; i < 4; i++)
+			{
+				q[i] /= norm;
+			}
+		}
+		t += s->dt;
+
+		/* O filtro integra por retangulo: a leitura e a media do intervalo */
+		Bench_Rate(t - 0.5 * s->dt, w);
+		Bench_ToBody(q, up, s->acc);
+		Bench_ToBody(q, earthMag, s->mag);
+		for (i = 0; i < 3; i++)
+		{
+			s->gyro[i] = w[i] + gyroBias[i] + BENCH_GYRO_NOISE * Bench_Gauss();
+			s->acc[i] += BENCH_ACC_NOISE * Bench_Gauss();
+			s->mag[i] += BENCH_MAG_NOISE * 0.5 * Bench_Gauss();
+		}
+		memcpy(s->q, q, sizeof(s->q));
+		s->t = t;
+	}
+}
+
+static void Bench_RefUpdate(BenchRef_t *ref, const double gyro[3], const double acc[3], const double mag[3])
+{
+	double q0 = ref->q[0], q1 = ref->q[1], q2 = ref->q[2], q3 = ref->q[3];
+	double gx = gyro[0], gy = gyro[1], gz = gyro[2];
+	double ax = acc[0], ay = acc[1], az = acc[2];
+	double mx, my, mz, hx, hy, bx, bz, norm;
+	double halfvx, halfvy, halfvz, halfwx, halfwy, halfwz, halfex, halfey, halfez;
+	double qa, qb, qc;
+
+	norm = sqrt(ax * ax + ay * ay + az * az);
+	if (norm > 0.0)
+	{
+		ax /= norm;
+		ay /= norm;
+		az /= norm;
+
+		halfvx = q1 * q3 - q0 * q2;
+		halfvy = q0 * q1 + q2 * q3;
+		halfvz = q0 * q0 - 0.5 + q3 * q3;
+
+		halfex = ay * halfvz - az * halfvy;
+		halfey = az * halfvx - ax * halfvz;
+		halfez = ax * halfvy - ay * halfvx;
+
+		if (mag != NULL)
+		{
+			norm = sqrt(mag[0] * mag[0] + mag[1] * mag[1] + mag[2] * mag[2]);
+			mx = mag[0] / norm;
+			my = mag[1] / norm;
+			mz = mag[2] / norm;
+
+			hx = 2.0 * (mx * (0.5 - q2 * q2 - q3 * q3) + my * (q1 * q2 - q0 * q3) + mz * (q1 * q3 + q0 * q2));
+			hy = 2.0 * (mx * (q1 * q2 + q0 * q3) + my * (0.5 - q1 * q1 - q3 * q3) + mz * (q2 * q3 - q0 * q1));
+			bz = 2.0 * (mx * (q1 * q3 - q0 * q2) + my * (q2 * q3 + q0 * q1) + mz * (0.5 - q1 * q1 - q2 * q2));
+			bx = sqrt(hx * hx + hy * hy);
+
+			halfwx = bx * (0.5 - q2 * q2 - q3 * q3) + bz * (q1 * q3 - q0 * q2);
+			halfwy = bx * (q1 * q2 - q0 * q3) + bz * (q0 * q1 + q2 * q3);
+			halfwz = bx * (q0 * q2 + q1 * q3) + bz * (0.5 - q1 * q1 - q2 * q2);
+
+			halfex += my * halfwz - mz * halfwy;
+			halfey += mz * halfwx - mx * halfwz;
+			halfez += mx * halfwy - my * halfwx;
+		}
+
+		if (ref->ki > 0.0)
+		{
+			ref->bias[0] -= ref->ki * halfex * ref->dt;
+			ref->bias[1] -= ref->ki * halfey * ref->dt;
+			ref->bias[2] -= ref->ki * halfez * ref->dt;
+		}
+
+		gx += ref->kp * halfex;
+		gy += ref->kp * halfey;
+		gz += ref->kp * halfez;
+	}
+
+	gx = (gx - ref->bias[0]) * 0.5 * ref->dt;
+	gy = (gy - ref->bias[1]) * 0.5 * ref->dt;
+	gz = (gz - ref->bias[2]) * 0.5 * ref->dt;
+
+	qa = q0;
+	qb = q1;
+	qc = q2;
+	q0 += -qb * gx - qc * gy - q3 * gz;
+	q1 += qa * gx + qc * gz - q3 * gy;
+	q2 += qa * gy - qb * gz + q3 * gx;
+	q3 += qa * gz + qb * gy - qc * gx;
+
+	norm = sqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+	ref->q[0] = q0 / norm;
+	ref->q[1] = q1 / norm;
+	ref->q[2] = q2 / norm;
+	ref->q[3] = q3 / norm;
+}
+
+static int Bench_Check(bool use_mag)
+{
+	BenchRef_t ref;
+	Ahrs_t ahrs;
+	float gyro[3], acc[3], mag[3];
+	double lib_q[4], lib_err = 0.0, ref_truth = 0.0, lib_truth = 0.0, e;
+	int errors = 0, n, i;
+
+	AHRS_Init(&ahrs, (float) BENCH_RATE_LOW, AHRS_DEFAULT_KP, AHRS_DEFAULT_KI);
+	memset(&ref, 0, sizeof(ref));
+	ref.q[0] = 1.0;
+	ref.kp = AHRS_DEFAULT_KP;
+	ref.ki = AHRS_DEFAULT_KI;
+
+	for (n = 0; n < numSamples; n++)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			gyro[i] = (float) samples[n].gyro[i];
+			acc[i] = (float) samples[n].acc[i];
+			mag[i] = (float) samples[n].mag[i];
+		}
+
+		AHRS_SetPeriod(&ahrs, (float) samples[n].dt);
+		AHRS_Update(&ahrs, gyro, acc, use_mag ? mag : NULL);
+
+		/* A referencia ve as mesmas entradas ja arredondadas para float */
+		ref.dt = (float) samples[n].dt;
+		Bench_RefUpdate(&ref, (double[3]) { gyro[0], gyro[1], gyro[2] }, (double[3]) { acc[0], acc[1], acc[2] },
+				use_mag ? (double[3]) { mag[0], mag[1], mag[2] } : NULL);
+
+		for (i = 0; i < 4; i++)
+		{
+			lib_q[i] = ahrs.q[i];
+		}
+
+		e = Bench_Angle(lib_q, ref.q, false);
+		lib_err = fmax(lib_err, e);
+
+		if (samples[n].t >= BENCH_SETTLE)
+		{
+			ref_truth = fmax(ref_truth, Bench_Angle(ref.q, samples[n].q, !use_mag));
+			lib_truth = fmax(lib_truth, Bench_Angle(lib_q, samples[n].q, !use_mag));
+		}
+	}
+
+	printf("%-8s %8d %12.4f %12.3f %12.3f   %+.4f %+.4f %+.4f\n", use_mag ? "9 eixos" : "6 eixos", numSamples, lib_err, ref_truth,
+			lib_truth, ahrs.bias[0] - gyroBias[0], ahrs.bias[1] - gyroBias[1], ahrs.bias[2] - gyroBias[2]);
+
+	if (lib_err > BENCH_MAX_LIB_ERR)
+	{
+		printf("FAIL: lib se afasta %.4f graus da referencia (limite %.2f)\n", lib_err, BENCH_MAX_LIB_ERR);
+		errors++;
+	}
+
+	if ((ref_truth > BENCH_MAX_TRUTH_ERR) || (lib_truth > BENCH_MAX_TRUTH_ERR))
+	{
+		printf("FAIL: erro contra a trajetoria acima de %.1f graus\n", BENCH_MAX_TRUTH_ERR);
+		errors++;
+	}
+
+	return errors;
+}
+
+static int Bench_Vertical(void)
+{
+	static const double up[3] = { 0.0, 0.0, 1.0 };
+	double body[3], rest, moving, err_rest = 0.0, err_moving = 0.0;
+	float acc[3];
+	Ahrs_t ahrs;
+	int errors = 0, n, i;
+
+	AHRS_Init(&ahrs, (float) BENCH_RATE_LOW, AHRS_DEFAULT_KP, AHRS_DEFAULT_KI);
+
+	for (n = 0; n < numSamples; n += 10)
+	{
+		for (i = 0; i < 4; i++)
+		{
+			ahrs.q[i] = (float) samples[n].q[i];
+		}
+		Bench_ToBody(samples[n].q, up, body);
+
+		/* Parada: le 1 g para cima no referencial da placa */
+		for (i = 0; i < 3; i++)
+		{
+			acc[i] = (float) lrint(body[i] * BENCH_ACC_PER_G);
+		}
+		rest = AHRS_VerticalAccel(&ahrs, acc, (float) BENCH_ACC_PER_G);
+		err_rest = fmax(err_rest, fabs(rest));
+
+		/* Subindo com 1 m/s2 */
+		for (i = 0; i < 3; i++)
+		{
+			acc[i] = (float) lrint(body[i] * BENCH_ACC_PER_G * (1.0 + 1.0 / AHRS_GRAVITY));
+		}
+		moving = AHRS_VerticalAccel(&ahrs, acc, (float) BENCH_ACC_PER_G);
+		err_moving = fmax(err_moving, fabs(moving - 1.0));
+	}
+
+	printf("\nvertical (ug por g = %.0f): erro max parada %.5f m/s2, subindo a 1 m/s2 %.5f m/s2\n", BENCH_ACC_PER_G, err_rest,
+			err_moving);
+
+	if ((err_rest > BENCH_MAX_VERT_ERR) || (err_moving > BENCH_MAX_VERT_ERR))
+	{
+		printf("FAIL: AHRS_VerticalAccel erra mais de %.2f m/s2\n", BENCH_MAX_VERT_ERR);
+		errors++;
+	}
+
+	return errors;
+}
+
+static double Bench_Time(bool use_mag, double *cycles)
+{
+	static float gyro[BENCH_MAX_SAMPLES][3], acc[BENCH_MAX_SAMPLES][3], mag[BENCH_MAX_SAMPLES][3];
+	volatile float sink;
+	Ahrs_t ahrs;
+	double start, elapsed;
+	uint64_t tsc = 0;
+	long runs = 0;
+	int n, i;
+
+	for (n = 0; n < numSamples; n++)
+	{
+		for (i = 0; i < 3; i++)
+		{
+			gyro[n][i] = (float) samples[n].gyro[i];
+			acc[n][i] = (float) samples[n].acc[i];
+			mag[n][i] = (float) samples[n].mag[i];
+		}
+	}
+
+	AHRS_Init(&ahrs, (float) BENCH_RATE_LOW, AHRS_DEFAULT_KP, AHRS_DEFAULT_KI);
+
+	start = Bench_Now();
+	do
+	{
+#if BENCH_HAS_TSC
+		uint64_t t0 = __rdtsc();
+#endif
+		for (n = 0; n < numSamples; n++)
+		{
+			AHRS_Update(&ahrs, gyro[n], acc[n], use_mag ? mag[n] : NULL);
+		}
+#if BENCH_HAS_TSC
+		tsc += __rdtsc() - t0;
+#endif
+		runs++;
+		elapsed = Bench_Now() - start;
+	} while (elapsed < BENCH_MIN_SECONDS);
+
+	sink = ahrs.q[0];
+	(void) sink;
+
+	*cycles = (double) tsc / ((double) runs * numSamples);
+
+	return elapsed * 1e9 / ((double) runs * numSamples);
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(void)
+{
+	double ns, cycles;
+	int errors = 0;
+
+	srand(1);
+
+	Bench_Generate();
+
+	printf("%.0f s a %.0f Hz e %.0f s a %.0f Hz, jitter %.0f%%, comparacao com a trajetoria apos %.0f s\n\n", BENCH_SECONDS,
+			BENCH_RATE_LOW, BENCH_SECONDS, BENCH_RATE_HIGH, BENCH_JITTER * 100.0, BENCH_SETTLE);
+	printf("%-8s %8s %12s %12s %12s   %s\n", "modo", "amostras", "lib-ref (o)", "ref-traj (o)", "lib-traj (o)", "erro do bias (rad/s)");
+	errors += Bench_Check(true);
+	errors += Bench_Check(false);
+	errors += Bench_Vertical();
+
+	printf("\n%-8s %10s %14s\n", "modo", "ns/update", "ciclos/update");
+	ns = Bench_Time(true, &cycles);
+	printf("%-8s %10.1f %14.0f\n", "9 eixos", ns, cycles);
+	ns = Bench_Time(false, &cycles);
+	printf("%-8s %10.1f %14.0f\n", "6 eixos", ns, cycles);
+#if !BENCH_HAS_TSC
+	printf("(sem TSC neste PC: ciclos nao medidos)\n");
+#endif
+
+	printf("\n%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}
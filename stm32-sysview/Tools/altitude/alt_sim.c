@@ -0,0 +1,309 @@
+/**
+ * @file    alt_sim.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Simula no PC o filtro de Libs/altitude com lotes do FIFO do LPS22HB
+ * @details
+ * Compilar (dentro de Tools/altitude):
+ *
+ *   gcc -O2 -Wall -I../../Application/Libs alt_sim.c \
+ *       ../../Application/Libs/altitude/altitude.c -lm -o alt_sim
+ *
+ * Uma trajetoria vertical conhecida (soma de senoides, alguns metros) vira
+ * pressao pela atmosfera padrao, com ruido branco, quantizacao de 1/4096
+ * hPa e o LPF do CI em ODR/9, amostrada a 75 Hz e entregue em lotes de
+ * 16 como faz o app_baro. A aceleracao vertical chega a 52 Hz (taxa do
+ * AHRS) com ruido e bias, integrada como em AppAhrs_GetVertical.
+ *
+ * Compara a altitude e a velocidade vertical contra a verdade em tres
+ * casos: a media do lote (velocidade por diferenca), o filtro so com o
+ * barometro e o filtro com o acelerometro. Confere que a fusao reduz os
+ * erros e que o bias do acelerometro e estimado. Por fim mostra o custo
+ * de barramento do FIFO para alguns watermarks contra a leitura de uma
+ * amostra por vez; no alvo o comando "baro" mostra os valores medidos.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "altitude/altitude.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define SIM_PI					3.14159265358979
+
+#define SIM_SECONDS				300.0
+#define SIM_WARMUP_S			30.0
+
+/** @brief Passo da simulacao (s) */
+#define SIM_STEP_S				1.0e-4
+
+#define SIM_BARO_ODR			75.0
+#define SIM_WATERMARK			16
+#define SIM_ACC_ODR				52.0
+
+/** @brief Ruido por amostra do barometro antes do LPF (hPa) */
+#define SIM_BARO_NOISE_HPA		0.01
+#define SIM_LSB_HPA				4096.0
+
+/** @brief Ruido e bias da aceleracao vertical depois do AHRS (m/s2) */
+#define SIM_ACC_NOISE			0.05
+#define SIM_ACC_BIAS			0.04
+
+/** @brief Tolerancia na estimativa do bias (m/s2) */
+#define SIM_BIAS_TOL			0.02
+
+/** @brief Barramento: 9 bits por byte a 100 kHz */
+#define SIM_I2C_HZ				100000.0
+#define SIM_I2C_BITS			9.0
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Um caso comparado */
+typedef enum
+{
+	SIM_BATCH = 0,
+	SIM_BARO,
+	SIM_FUSED,
+	SIM_CASES
+} SimCase_e;
+
+/** @brief Soma dos erros quadraticos */
+typedef struct
+{
+	double alt2;
+	double vz2;
+	uint32_t n;
+} SimError_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static const char * const strCase[SIM_CASES] = { "lote", "baro", "baro+acc" };
+
+static const uint8_t busWatermarks[] = { 1, 4, 16, 24 };
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Gaussiana de media zero e variancia 1 (Box-Muller). */
+static double Sim_Gauss(void);
+
+/**
+ * Trajetoria vertical.
+ * @param t Tempo em s.
+ * @param h Altitude (m).
+ * @param v Velocidade (m/s).
+ * @param a Aceleracao (m/s2).
+ */
+static void Sim_Truth(double t, double *h, double *v, double *a);
+
+/**
+ * Soma um erro.
+ * @param e Acumulador.
+ * @param alt Erro de altitude.
+ * @param vz Erro de velocidade.
+ */
+static void Sim_Add(SimError_t *e, double alt, double vz);
+
+/** @brief Custo de barramento a 75 Hz. */
+static void Sim_BusTable(void);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static double Sim_Gauss(void)
+{
+	double u1 = (rand() + 1.0) / ((double) RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / ((double) RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * SIM_PI * u2);
+}
+
+static void Sim_Truth(double t, double *h, double *v, double *a)
+{
+	/* Subida lenta de alguns metros (escada, elevador) com balanco de passo */
+	static const double amp[3] = { 4.0, 1.0, 0.05 };
+	static const double freq[3] = { 0.01, 0.07, 1.8 };
+	double w;
+	uint8_t i;
+
+	*h = *v = *a = 0.0;
+
+	for (i = 0; i < 3; i++)
+	{
+		w = 2.0 * SIM_PI * freq[i];
+		*h += amp[i] * sin(w * t);
+		*v += amp[i] * w * cos(w * t);
+		*a -= amp[i] * w * w * sin(w * t);
+	}
+}
+
+static void Sim_Add(SimError_t *e, double alt, double vz)
+{
+	e->alt2 += alt * alt;
+	e->vz2 += vz * vz;
+	e->n++;
+}
+
+static void Sim_BusTable(void)
+{
+	double drains, bytes, transfers;
+	uint8_t i, wtm;
+
+	printf("\n%-10s %8s %12s %10s %12s\n", "leitura", "lotes/s", "transacoes/s", "bytes/s", "barramento");
+
+	/* Uma amostra por vez: PRESS_OUT_XL..H em uma leitura multipla */
+	transfers = SIM_BARO_ODR;
+	bytes = SIM_BARO_ODR * (3.0 + 3.0);
+	printf("%-10s %8.1f %12.1f %10.0f %11.2f%%\n", "amostra", SIM_BARO_ODR, transfers, bytes,
+			100.0 * bytes * SIM_I2C_BITS / SIM_I2C_HZ);
+
+	/* FIFO: STATUS_FIFO (4 bytes) e uma rajada de 5 bytes por amostra */
+	for (i = 0; i < sizeof(busWatermarks); i++)
+	{
+		wtm = busWatermarks[i];
+		drains = SIM_BARO_ODR / wtm;
+		transfers = drains * 2.0;
+		bytes = drains * (4.0 + 3.0 + 5.0 * wtm);
+		printf("fifo %-5u %8.1f %12.1f %10.0f %11.2f%%\n", wtm, drains, transfers, bytes,
+				100.0 * bytes * SIM_I2C_BITS / SIM_I2C_HZ);
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(void)
+{
+	Alt_t baro, fused;
+	SimError_t err[SIM_CASES] = { { 0 } };
+	double t, h, v, a, p, lpf, alpha, sum = 0.0;
+	double next_baro = 0.0, next_acc = 0.0, acc_dt = 1.0 / SIM_ACC_ODR;
+	double dv = 0.0, dp = 0.0, dt_acc = 0.0, am;
+	double last_drain = 0.0, batch_h, prev_batch_h = 0.0, batch_v, rms[SIM_CASES][2];
+	float h_m, age, dt;
+	int32_t raw;
+	uint16_t count = 0;
+	uint32_t drains = 0;
+	int errors = 0;
+	uint8_t c;
+
+	srand(1);
+
+	Alt_Init(&baro, ALT_DEF_TAU_S);
+	Alt_Init(&fused, ALT_DEF_TAU_S);
+
+	/* LPF do CI em ODR/9 como um polo */
+	alpha = 1.0 - exp(-2.0 * SIM_PI / 9.0);
+	Sim_Truth(0.0, &h, &v, &a);
+	lpf = ALT_STD_PRESSURE_HPA * pow(1.0 - h / 44330.8, 1.0 / 0.190263);
+
+	for (t = 0.0; t < SIM_SECONDS; t += SIM_STEP_S)
+	{
+		Sim_Truth(t, &h, &v, &a);
+
+		if (t >= next_acc)
+		{
+			next_acc += acc_dt;
+			am = a + SIM_ACC_BIAS + SIM_ACC_NOISE * Sim_Gauss();
+			dp += dv * acc_dt + 0.5 * am * acc_dt * acc_dt;
+			dv += am * acc_dt;
+			dt_acc += acc_dt;
+		}
+
+		if (t < next_baro)
+		{
+			continue;
+		}
+		next_baro += 1.0 / SIM_BARO_ODR;
+
+		p = ALT_STD_PRESSURE_HPA * pow(1.0 - h / 44330.8, 1.0 / 0.190263) + SIM_BARO_NOISE_HPA * Sim_Gauss();
+		lpf += alpha * (p - lpf);
+		raw = (int32_t) lrint(lpf * SIM_LSB_HPA);
+		sum += raw;
+
+		if (++count < SIM_WATERMARK)
+		{
+			continue;
+		}
+
+		/* Lote completo: o mesmo passo do app_baro */
+		h_m = Alt_FromPressure((float) (sum / (count * SIM_LSB_HPA)), ALT_STD_PRESSURE_HPA);
+		age = (float) ((count - 1) / (2.0 * SIM_BARO_ODR));
+		dt = (float) (t - last_drain);
+
+		Alt_Predict(&baro, 0.0f, 0.0f, dt);
+		Alt_Correct(&baro, h_m, age, dt);
+
+		Alt_Predict(&fused, (float) dv, (float) dp, (float) dt_acc);
+		Alt_Correct(&fused, h_m, age, dt);
+
+		batch_h = h_m;
+		batch_v = (drains > 0) ? (batch_h - prev_batch_h) / dt : 0.0;
+		prev_batch_h = batch_h;
+
+		if (t > SIM_WARMUP_S)
+		{
+			Sim_Add(&err[SIM_BATCH], batch_h - h, batch_v - v);
+			Sim_Add(&err[SIM_BARO], baro.h - h, baro.v - v);
+			Sim_Add(&err[SIM_FUSED], fused.h - h, fused.v - v);
+		}
+
+		last_drain = t;
+		dv = dp = dt_acc = 0.0;
+		sum = 0.0;
+		count = 0;
+		drains++;
+	}
+
+	printf("\n%.0f s, %u lotes de %u a %.0f Hz, acc a %.0f Hz (ruido %.2f, bias %.2f m/s2), tau %.1f s\n",
+			SIM_SECONDS, drains, SIM_WATERMARK, SIM_BARO_ODR, SIM_ACC_ODR, SIM_ACC_NOISE, SIM_ACC_BIAS,
+			ALT_DEF_TAU_S);
+	printf("%-10s %12s %12s\n", "caso", "alt rms (m)", "vz rms (m/s)");
+
+	for (c = 0; c < SIM_CASES; c++)
+	{
+		rms[c][0] = sqrt(err[c].alt2 / err[c].n);
+		rms[c][1] = sqrt(err[c].vz2 / err[c].n);
+		printf("%-10s %12.3f %12.3f\n", strCase[c], rms[c][0], rms[c][1]);
+	}
+
+	printf("bias estimado %.3f m/s2 (real %.3f)\n", fused.bias, SIM_ACC_BIAS);
+
+	if (rms[SIM_FUSED][0] >= rms[SIM_BATCH][0])
+	{
+		printf("FAIL: a fusao nao melhora a altitude do lote\n");
+		errors++;
+	}
+	if (rms[SIM_FUSED][1] >= 0.5 * rms[SIM_BARO][1])
+	{
+		printf("FAIL: a fusao nao reduz a velocidade a metade do filtro so com barometro\n");
+		errors++;
+	}
+	if (fabs(fused.bias - SIM_ACC_BIAS) > SIM_BIAS_TOL)
+	{
+		printf("FAIL: bias fora da tolerancia\n");
+		errors++;
+	}
+
+	Sim_BusTable();
+
+	printf("\n%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}
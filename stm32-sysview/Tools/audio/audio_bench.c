@@ -0,0 +1,309 @@
+/**
+ * @file    audio_bench.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Roda e mede no PC os estagios de Application/Libs/audio_dsp
+ * @details
+ * Le PCM gravado (WAV 16 bits ou cru s16le; de um WAV multicanal so o
+ * primeiro canal e usado) e passa em blocos de 10 ms pelos mesmos estagios
+ * da task de audio do firmware: remocao de DC, nivel, atividade e espectro.
+ * Opcionalmente grava um CSV por bloco para conferir o VAD contra a
+ * gravacao. Depois repete o arquivo inteiro ate somar meio segundo de CPU e
+ * informa us por bloco (media e maximo) e o fator de tempo real.
+ *
+ * O tempo medido e o do PC; no alvo o comando "audio" do shell mostra os
+ * ciclos por bloco medidos com o DWT.
+ *
+ * Compilacao:
+ *   gcc -O2 -I../../Application/Libs audio_bench.c \
+ *       ../../Application/Libs/audio_dsp/audio_dsp.c \
+ *       ../../Application/Libs/fft/fft.c -lm -o audio_bench
+ *
+ * Uso:
+ *   arecord -f S16_LE -r 16000 -c 1 -d 10 fala.wav
+ *   ./audio_bench [-r taxa] [-n fft] [-a] fala.wav [blocos.csv]
+ *     -r taxa  taxa do PCM cru (padrao 16000; WAV usa a do cabecalho)
+ *     -n fft   pontos do espectro (padrao 512)
+ *     -a       espectro em todos os quadros, nao so com atividade
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "audio_dsp/audio_dsp.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define BENCH_DEFAULT_RATE			16000
+#define BENCH_DEFAULT_FFT			512
+#define BENCH_BLOCKS_PER_SECOND		100
+#define BENCH_MIN_SECONDS			0.5
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief PCM carregado */
+typedef struct
+{
+	int16_t *pcm;
+	uint32_t count;
+	uint32_t rate;
+} BenchAudio_t;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static double Bench_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static uint32_t Bench_Le32(const uint8_t *p)
+{
+	return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint16_t Bench_Le16(const uint8_t *p)
+{
+	return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+/**
+ * Carrega WAV PCM 16 bits (primeiro canal) ou, sem cabecalho RIFF, s16le cru.
+ * @return 0 ou -1 com mensagem em stderr.
+ */
+static int Bench_Load(const char *path, BenchAudio_t *audio)
+{
+	FILE *f = fopen(path, "rb");
+	uint8_t *data;
+	const uint8_t *p, *end;
+	const uint8_t *pcm = NULL;
+	uint32_t size = 0, chunk, pcm_size = 0;
+	uint16_t channels = 1, bits = 16, format = 1;
+	long len;
+	uint32_t i;
+
+	if (f == NULL)
+	{
+		perror(path);
+		return -1;
+	}
+
+	fseek(f, 0, SEEK_END);
+	len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	data = malloc((size_t) len + 1);
+	if ((data == NULL) || (fread(data, 1, (size_t) len, f) != (size_t) len))
+	{
+		fprintf(stderr, "%s: erro de leitura\n", path);
+		fclose(f);
+		free(data);
+		return -1;
+	}
+	fclose(f);
+	size = (uint32_t) len;
+
+	if ((size >= 12) && (memcmp(data, "RIFF", 4) == 0) && (memcmp(data + 8, "WAVE", 4) == 0))
+	{
+		p = data + 12;
+		end = data + size;
+
+		while (p + 8 <= end)
+		{
+			chunk = Bench_Le32(p + 4);
+			if ((memcmp(p, "fmt ", 4) == 0) && (chunk >= 16) && (p + 8 + 16 <= end))
+			{
+				format = Bench_Le16(p + 8);
+				channels = Bench_Le16(p + 10);
+				audio->rate = Bench_Le32(p + 12);
+				bits = Bench_Le16(p + 22);
+			}
+			else if (memcmp(p, "data", 4) == 0)
+			{
+				pcm = p + 8;
+				pcm_size = ((uint32_t) (end - pcm) < chunk) ? (uint32_t) (end - pcm) : chunk;
+				break;
+			}
+			p += 8 + chunk + (chunk & 1);
+		}
+
+		/* 0xFFFE = WAVE_FORMAT_EXTENSIBLE, usado por alguns gravadores */
+		if ((pcm == NULL) || ((format != 1) && (format != 0xFFFE)) || (bits != 16) || (channels == 0))
+		{
+			fprintf(stderr, "%s: so WAV PCM 16 bits\n", path);
+			free(data);
+			return -1;
+		}
+	}
+	else
+	{
+		pcm = data;
+		pcm_size = size;
+	}
+
+	audio->count = pcm_size / (2U * channels);
+	audio->pcm = malloc(audio->count * sizeof(int16_t) + 1);
+	for (i = 0; i < audio->count; i++)
+	{
+		audio->pcm[i] = (int16_t) Bench_Le16(pcm + 2U * channels * i);
+	}
+
+	free(data);
+
+	return 0;
+}
+
+//==============================================================================
+// SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	BenchAudio_t audio = { NULL, 0, BENCH_DEFAULT_RATE };
+	const char *in_path = NULL, *csv_path = NULL;
+	uint16_t fft_size = BENCH_DEFAULT_FFT;
+	bool gated = true;
+	AudioDsp_t dsp;
+	float *work;
+	int16_t *block;
+	FILE *csv = NULL;
+	uint32_t block_size, pos, n, blocks, passes;
+	double t0, t1, dt, worst = 0.0, total, audio_s;
+	float max_level = AUDIO_DSP_MIN_DB;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc))
+		{
+			audio.rate = (uint32_t) strtoul(argv[++i], NULL, 10);
+		}
+		else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc))
+		{
+			fft_size = (uint16_t) strtoul(argv[++i], NULL, 10);
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			gated = false;
+		}
+		else if (in_path == NULL)
+		{
+			in_path = argv[i];
+		}
+		else
+		{
+			csv_path = argv[i];
+		}
+	}
+
+	if (in_path == NULL)
+	{
+		fprintf(stderr, "uso: %s [-r taxa] [-n fft] [-a] audio.wav [blocos.csv]\n", argv[0]);
+		return 1;
+	}
+
+	if (Bench_Load(in_path, &audio) != 0)
+	{
+		return 1;
+	}
+
+	block_size = audio.rate / BENCH_BLOCKS_PER_SECOND;
+	if ((block_size == 0) || (audio.count < block_size))
+	{
+		fprintf(stderr, "%s: menos de um bloco de audio\n", in_path);
+		return 1;
+	}
+
+	work = malloc(AUDIO_DSP_WORK_SIZE(fft_size) * sizeof(float));
+	block = malloc(block_size * sizeof(int16_t));
+	if (AudioDsp_Init(&dsp, audio.rate, fft_size, work) == false)
+	{
+		fprintf(stderr, "fft de %u pontos invalida\n", fft_size);
+		return 1;
+	}
+	dsp.fft_gated = gated;
+
+	if (csv_path != NULL)
+	{
+		csv = fopen(csv_path, "w");
+		if (csv == NULL)
+		{
+			perror(csv_path);
+			return 1;
+		}
+		fprintf(csv, "time_s,level_db,peak_db,noise_db,active,peak_hz\n");
+	}
+
+	/* Primeira passada: resultados por bloco e pior caso de tempo */
+	blocks = audio.count / block_size;
+	for (pos = 0, n = 0; n < blocks; n++, pos += block_size)
+	{
+		memcpy(block, audio.pcm + pos, block_size * sizeof(int16_t));
+
+		t0 = Bench_Now();
+		AudioDsp_Process(&dsp, block, block_size);
+		dt = Bench_Now() - t0;
+		worst = (dt > worst) ? dt : worst;
+
+		max_level = (dsp.res.level_db > max_level) ? dsp.res.level_db : max_level;
+
+		if (csv != NULL)
+		{
+			fprintf(csv, "%.2f,%.1f,%.1f,%.1f,%d,%.1f\n", (double) pos / audio.rate, dsp.res.level_db,
+					dsp.res.peak_db, dsp.res.noise_db, dsp.res.active, dsp.res.peak_hz);
+		}
+	}
+
+	if (csv != NULL)
+	{
+		fclose(csv);
+	}
+
+	printf("%s: %u Hz, %.2f s, blocks of %u samples, fft %u (%s)\n", in_path, audio.rate,
+			(double) audio.count / audio.rate, block_size, fft_size, gated ? "gated" : "always");
+	printf("blocks %u, active %u (%.1f%%), spectra %u\n", dsp.res.blocks, dsp.res.active_blocks,
+			100.0 * dsp.res.active_blocks / dsp.res.blocks, dsp.res.spectra);
+	printf("max level %.1f dBFS, noise floor %.1f dBFS, last peak %.1f Hz at %.1f dBFS\n", max_level,
+			dsp.res.noise_db, dsp.res.peak_hz, dsp.res.peak_bin_db);
+
+	/* Passadas repetidas para uma media estavel */
+	passes = 0;
+	t0 = Bench_Now();
+	do
+	{
+		AudioDsp_Reset(&dsp);
+		for (pos = 0, n = 0; n < blocks; n++, pos += block_size)
+		{
+			memcpy(block, audio.pcm + pos, block_size * sizeof(int16_t));
+			AudioDsp_Process(&dsp, block, block_size);
+		}
+		passes++;
+		t1 = Bench_Now();
+	} while (t1 - t0 < BENCH_MIN_SECONDS);
+
+	total = t1 - t0;
+	audio_s = (double) passes * blocks * block_size / audio.rate;
+	printf("host: %.2f us/block avg, %.2f us/block max, %.0fx real time\n",
+			total * 1e6 / ((double) passes * blocks), worst * 1e6, audio_s / total);
+
+	free(work);
+	free(block);
+	free(audio.pcm);
+
+	return 0;
+}
@@ -0,0 +1,552 @@
+/**
+ * @file    filter_bench.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Confere e mede no PC os filtros de Libs/filter
+ * @details
+ * Compilar (dentro de Tools/filter):
+ *
+ *   gcc -O2 -Wall -I../../Application/Libs filter_bench.c \
+ *       ../../Application/Libs/filter/filter.c -lm -o filter_bench
+ *
+ * Para cada filtro e formato (float, Q15 e Q31) compara a saida com uma
+ * referencia em double sobre ruido: biquads pela equacao de diferencas com
+ * os mesmos coeficientes (ja quantizados nos formatos Q), FIR pela
+ * convolucao direta seguida da decimacao, media movel pela soma da janela e
+ * exponencial pela recorrencia. Confere tambem que o Butterworth projetado
+ * tem -3 dB no corte e que dividir o sinal em blocos aleatorios da
+ * exatamente a mesma saida que um bloco so.
+ *
+ * Por fim mede o tempo por amostra de cada variante. O tempo e o do PC; no
+ * alvo o comando "filter" mostra os ciclos por amostra das cadeias.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "filter/filter.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define BENCH_PI				3.14159265358979
+
+#define BENCH_SAMPLES			4096
+
+#define BENCH_MIN_SECONDS		0.2
+
+/** @brief Butterworth de teste: ordem 4, corte em 5% da taxa */
+#define BENCH_ORDER				4
+#define BENCH_FC				0.05f
+
+/** @brief FIR de teste: decimacao por 4 com 33 taps */
+#define BENCH_TAPS				33
+#define BENCH_FACTOR			4
+
+#define BENCH_MA_LENGTH			16
+#define BENCH_EMA_ALPHA			0.05
+
+/** @brief Amplitude do ruido de entrada (fracao do fundo de escala) */
+#define BENCH_AMPLITUDE			0.25
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Uma variante medida */
+typedef enum
+{
+	BENCH_BIQUAD = 0,
+	BENCH_FIR,
+	BENCH_MOVAVG,
+	BENCH_EMA,
+	BENCH_KINDS
+} BenchKind_e;
+
+/** @brief Estado de qualquer variante em um formato */
+typedef struct
+{
+	FilterBiquadF32_t bq_f;
+	FilterBiquadQ15_t bq_q15;
+	FilterBiquadQ31_t bq_q31;
+	FilterFirDecimF32_t fir_f;
+	FilterFirDecimQ15_t fir_q15;
+	FilterFirDecimQ31_t fir_q31;
+	FilterMovAvgF32_t ma_f;
+	FilterMovAvgQ15_t ma_q15;
+	FilterMovAvgQ31_t ma_q31;
+	FilterEmaF32_t ema_f;
+	FilterEmaQ15_t ema_q15;
+	FilterEmaQ31_t ema_q31;
+} BenchFilters_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static const char * const strKind[BENCH_KINDS] = { "biquad x2", "fir dec 4", "movavg 16", "ema" };
+static const char * const strFormat[3] = { "f32", "q15", "q31" };
+
+/* Coeficientes */
+static float bqCoeffs[FILTER_MAX_ORDER / 2 * FILTER_BIQUAD_COEFFS];
+static int16_t bqQ15[FILTER_MAX_ORDER / 2 * FILTER_BIQUAD_COEFFS];
+static int32_t bqQ31[FILTER_MAX_ORDER / 2 * FILTER_BIQUAD_COEFFS];
+static uint8_t shiftQ15, shiftQ31;
+static float firCoeffs[BENCH_TAPS];
+static int16_t firQ15[BENCH_TAPS];
+static int32_t firQ31[BENCH_TAPS];
+
+/* Estados */
+static float bqStateF[FILTER_MAX_ORDER];
+static int64_t bqStateQ15[FILTER_MAX_ORDER];
+static int64_t bqStateQ31[FILTER_MAX_ORDER];
+static float firStateF[FILTER_FIR_STATE(BENCH_TAPS)];
+static int16_t firStateQ15[FILTER_FIR_STATE(BENCH_TAPS)];
+static int32_t firStateQ31[FILTER_FIR_STATE(BENCH_TAPS)];
+static float maBufF[BENCH_MA_LENGTH];
+static int16_t maBufQ15[BENCH_MA_LENGTH];
+static int32_t maBufQ31[BENCH_MA_LENGTH];
+
+/* Sinais */
+static double input[BENCH_SAMPLES];
+static double ref[BENCH_SAMPLES];
+static float inF[BENCH_SAMPLES], outF[BENCH_SAMPLES], outF2[BENCH_SAMPLES];
+static int16_t inQ15[BENCH_SAMPLES], outQ15[BENCH_SAMPLES], outQ15b[BENCH_SAMPLES];
+static int32_t inQ31[BENCH_SAMPLES], outQ31[BENCH_SAMPLES], outQ31b[BENCH_SAMPLES];
+
+static BenchFilters_t flt;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Segundos de um relogio monotonico. */
+static double Bench_Now(void);
+
+/** @brief Ruido gaussiano de desvio 1 (Box-Muller). */
+static double Bench_Gauss(void);
+
+/**
+ * Ganho de uma cascata de biquads na frequencia f.
+ * @param c Coeficientes.
+ * @param stages Secoes.
+ * @param f Frequencia dividida pela taxa.
+ * @return Ganho em dB.
+ */
+static double Bench_Gain(const float *c, uint8_t stages, double f);
+
+/**
+ * Confere o -3 dB dos projetos de Butterworth.
+ * @return Erros encontrados.
+ */
+static int Bench_Design(void);
+
+/**
+ * (Re)inicia todos os filtros.
+ */
+static void Bench_Reset(void);
+
+/**
+ * Roda uma variante sobre um bloco.
+ * @param kind Filtro.
+ * @param format 0 = float, 1 = Q15, 2 = Q31.
+ * @param offset Primeira amostra.
+ * @param count Amostras.
+ * @param out_pos Posicao de saida (avanca com as amostras produzidas).
+ */
+static void Bench_Run(BenchKind_e kind, uint8_t format, uint16_t offset, uint16_t count, uint16_t *out_pos);
+
+/**
+ * Calcula a saida de referencia em double de uma variante.
+ * @param kind Filtro.
+ * @param format Define os coeficientes usados (ja quantizados nos formatos Q).
+ * @return Amostras de saida.
+ */
+static uint16_t Bench_Reference(BenchKind_e kind, uint8_t format);
+
+/**
+ * Confere uma variante contra a referencia e contra a divisao em blocos.
+ * @param kind Filtro.
+ * @param format Formato.
+ * @return Erros encontrados.
+ */
+static int Bench_Check(BenchKind_e kind, uint8_t format);
+
+/**
+ * Tempo por amostra de uma variante.
+ * @return ns por amostra de entrada.
+ */
+static double Bench_Time(BenchKind_e kind, uint8_t format);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static double Bench_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static double Bench_Gauss(void)
+{
+	double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * BENCH_PI * u2);
+}
+
+static double Bench_Gain(const float *c, uint8_t stages, double f)
+{
+	double w = 2.0 * BENCH_PI * f;
+	double gain = 1.0;
+	double nr, ni, dr, di;
+	uint8_t k;
+
+	for (k = 0; k < stages; k++, c += FILTER_BIQUAD_COEFFS)
+	{
+		nr = c[0] + c[1] * cos(w) + c[2] * cos(2.0 * w);
+		ni = -c[1] * sin(w) - c[2] * sin(2.0 * w);
+		dr = 1.0 + c[3] * cos(w) + c[4] * cos(2.0 * w);
+		di = -c[3] * sin(w) - c[4] * sin(2.0 * w);
+		gain *= sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+	}
+
+	return 20.0 * log10(gain);
+}
+
+static int Bench_Design(void)
+{
+	static const float fcs[] = { 0.01f, 0.05f, 0.2f, 0.4f };
+	float c[FILTER_MAX_ORDER / 2 * FILTER_BIQUAD_COEFFS];
+	double at_fc, pass, stop;
+	int errors = 0;
+	uint8_t order, stages, f, type;
+
+	printf("%4s %5s %6s %9s %10s %10s\n", "tipo", "ordem", "fc", "dB em fc", "dB passa", "dB corta");
+	for (type = 0; type < 2; type++)
+	{
+		for (order = 2; order <= FILTER_MAX_ORDER; order += 2)
+		{
+			for (f = 0; f < sizeof(fcs) / sizeof(fcs[0]); f++)
+			{
+				stages = Filter_DesignButterworth((FilterType_e) type, order, fcs[f], c);
+				at_fc = Bench_Gain(c, stages, fcs[f]);
+
+				/* Uma oitava para cada lado: passa ~0 dB, corta ~-6 dB por ordem */
+				pass = Bench_Gain(c, stages, (type == FILTER_LOWPASS) ? fcs[f] / 2.0 : fmin(fcs[f] * 2.0, 0.499));
+				stop = Bench_Gain(c, stages, (type == FILTER_LOWPASS) ? fmin(fcs[f] * 2.0, 0.499) : fcs[f] / 2.0);
+
+				if ((order == 4) || (order == FILTER_MAX_ORDER))
+				{
+					printf("%4s %5u %6.2f %9.3f %10.3f %10.2f\n", type ? "hp" : "lp", order, fcs[f], at_fc, pass, stop);
+				}
+
+				if ((stages != order / 2) || (fabs(at_fc + 3.0103) > 0.01) || (pass < -0.5) || (stop > -6.0 * order + 3.0))
+				{
+					printf("FAIL: %s ordem %u fc %.2f\n", type ? "hp" : "lp", order, fcs[f]);
+					errors++;
+				}
+			}
+		}
+	}
+
+	if ((Filter_DesignButterworth(FILTER_LOWPASS, 3, 0.1f, c) != 0) || (Filter_DesignButterworth(FILTER_LOWPASS, 4, 0.5f, c) != 0))
+	{
+		printf("FAIL: projeto invalido aceito\n");
+		errors++;
+	}
+
+	return errors;
+}
+
+static void Bench_Reset(void)
+{
+	Filter_BiquadInitF32(&flt.bq_f, BENCH_ORDER / 2, bqCoeffs, bqStateF);
+	Filter_BiquadInitQ15(&flt.bq_q15, BENCH_ORDER / 2, shiftQ15, bqQ15, bqStateQ15);
+	Filter_BiquadInitQ31(&flt.bq_q31, BENCH_ORDER / 2, shiftQ31, bqQ31, bqStateQ31);
+	Filter_FirDecimInitF32(&flt.fir_f, BENCH_TAPS, BENCH_FACTOR, firCoeffs, firStateF);
+	Filter_FirDecimInitQ15(&flt.fir_q15, BENCH_TAPS, BENCH_FACTOR, firQ15, firStateQ15);
+	Filter_FirDecimInitQ31(&flt.fir_q31, BENCH_TAPS, BENCH_FACTOR, firQ31, firStateQ31);
+	Filter_MovAvgInitF32(&flt.ma_f, BENCH_MA_LENGTH, maBufF);
+	Filter_MovAvgInitQ15(&flt.ma_q15, BENCH_MA_LENGTH, maBufQ15);
+	Filter_MovAvgInitQ31(&flt.ma_q31, BENCH_MA_LENGTH, maBufQ31);
+	Filter_EmaInitF32(&flt.ema_f, (float) BENCH_EMA_ALPHA);
+	Filter_EmaInitQ15(&flt.ema_q15, (int16_t) lrint(BENCH_EMA_ALPHA * 32768.0));
+	Filter_EmaInitQ31(&flt.ema_q31, (int32_t) lrint(BENCH_EMA_ALPHA * 2147483648.0));
+}
+
+static void Bench_Run(BenchKind_e kind, uint8_t format, uint16_t offset, uint16_t count, uint16_t *out_pos)
+{
+	uint16_t n = count;
+
+	switch (kind * 3 + format)
+	{
+	case BENCH_BIQUAD * 3 + 0:
+		Filter_BiquadF32(&flt.bq_f, &inF[offset], &outF[*out_pos], count);
+		break;
+	case BENCH_BIQUAD * 3 + 1:
+		Filter_BiquadQ15(&flt.bq_q15, &inQ15[offset], &outQ15[*out_pos], count);
+		break;
+	case BENCH_BIQUAD * 3 + 2:
+		Filter_BiquadQ31(&flt.bq_q31, &inQ31[offset], &outQ31[*out_pos], count);
+		break;
+	case BENCH_FIR * 3 + 0:
+		n = Filter_FirDecimF32(&flt.fir_f, &inF[offset], &outF[*out_pos], count);
+		break;
+	case BENCH_FIR * 3 + 1:
+		n = Filter_FirDecimQ15(&flt.fir_q15, &inQ15[offset], &outQ15[*out_pos], count);
+		break;
+	case BENCH_FIR * 3 + 2:
+		n = Filter_FirDecimQ31(&flt.fir_q31, &inQ31[offset], &outQ31[*out_pos], count);
+		break;
+	case BENCH_MOVAVG * 3 + 0:
+		Filter_MovAvgF32(&flt.ma_f, &inF[offset], &outF[*out_pos], count);
+		break;
+	case BENCH_MOVAVG * 3 + 1:
+		Filter_MovAvgQ15(&flt.ma_q15, &inQ15[offset], &outQ15[*out_pos], count);
+		break;
+	case BENCH_MOVAVG * 3 + 2:
+		Filter_MovAvgQ31(&flt.ma_q31, &inQ31[offset], &outQ31[*out_pos], count);
+		break;
+	case BENCH_EMA * 3 + 0:
+		Filter_EmaF32(&flt.ema_f, &inF[offset], &outF[*out_pos], count);
+		break;
+	case BENCH_EMA * 3 + 1:
+		Filter_EmaQ15(&flt.ema_q15, &inQ15[offset], &outQ15[*out_pos], count);
+		break;
+	default:
+		Filter_EmaQ31(&flt.ema_q31, &inQ31[offset], &outQ31[*out_pos], count);
+		break;
+	}
+
+	*out_pos += n;
+}
+
+static uint16_t Bench_Reference(BenchKind_e kind, uint8_t format)
+{
+	double c[FILTER_MAX_ORDER / 2 * FILTER_BIQUAD_COEFFS];
+	double h[BENCH_TAPS];
+	double x[FILTER_MAX_ORDER / 2][2], yp[FILTER_MAX_ORDER / 2][2];
+	const double *cs;
+	double in, y, acc, alpha;
+	uint16_t i, k, n = 0;
+	uint8_t s;
+
+	/* Coeficientes na precisao de cada formato */
+	for (i = 0; i < BENCH_ORDER / 2 * FILTER_BIQUAD_COEFFS; i++)
+	{
+		c[i] = (format == 0) ? bqCoeffs[i] : (format == 1) ? ldexp(bqQ15[i], shiftQ15 - 15) : ldexp(bqQ31[i], shiftQ31 - 31);
+	}
+
+	for (i = 0; i < BENCH_TAPS; i++)
+	{
+		h[i] = (format == 0) ? firCoeffs[i] : (format == 1) ? ldexp(firQ15[i], -15) : ldexp(firQ31[i], -31);
+	}
+
+	switch (kind)
+	{
+	case BENCH_BIQUAD:
+		/* Forma direta I em double: x e yp guardam entradas e saidas de cada secao */
+		memset(x, 0, sizeof(x));
+		memset(yp, 0, sizeof(yp));
+		for (i = 0; i < BENCH_SAMPLES; i++)
+		{
+			in = input[i];
+			for (s = 0; s < BENCH_ORDER / 2; s++)
+			{
+				cs = &c[s * FILTER_BIQUAD_COEFFS];
+				y = cs[0] * in + cs[1] * x[s][0] + cs[2] * x[s][1] - cs[3] * yp[s][0] - cs[4] * yp[s][1];
+				x[s][1] = x[s][0];
+				x[s][0] = in;
+				yp[s][1] = yp[s][0];
+				yp[s][0] = y;
+				in = y;
+			}
+			ref[i] = in;
+		}
+		return BENCH_SAMPLES;
+
+	case BENCH_FIR:
+		for (i = 0; i < BENCH_SAMPLES; i += BENCH_FACTOR)
+		{
+			for (acc = 0.0, k = 0; (k < BENCH_TAPS) && (k <= i); k++)
+			{
+				acc += h[k] * input[i - k];
+			}
+			ref[n++] = acc;
+		}
+		return n;
+
+	case BENCH_MOVAVG:
+		for (i = 0; i < BENCH_SAMPLES; i++)
+		{
+			for (acc = 0.0, k = 0; (k < BENCH_MA_LENGTH) && (k <= i); k++)
+			{
+				acc += input[i - k];
+			}
+			ref[i] = acc / k;
+		}
+		return BENCH_SAMPLES;
+
+	default:
+		alpha = (format == 0) ? (double) (float) BENCH_EMA_ALPHA : (format == 1)
+				? ldexp(lrint(BENCH_EMA_ALPHA * 32768.0), -15) : ldexp(lrint(BENCH_EMA_ALPHA * 2147483648.0), -31);
+		y = input[0];
+		for (i = 0; i < BENCH_SAMPLES; i++)
+		{
+			y += alpha * (input[i] - y);
+			ref[i] = y;
+		}
+		return BENCH_SAMPLES;
+	}
+}
+
+static int Bench_Check(BenchKind_e kind, uint8_t format)
+{
+	/* Erro maximo aceito, em fracao do fundo de escala */
+	static const double tol[BENCH_KINDS][3] =
+	{
+		{ 1e-5, 2e-3, 1e-7 },   /* biquad em Q15: ruido da realimentacao com polos perto de 1 */
+		{ 1e-6, 2e-4, 1e-8 },
+		{ 1e-6, 4e-5, 1e-9 },
+		{ 1e-6, 4e-5, 1e-9 },
+	};
+	double err = 0.0, v;
+	uint16_t n, pos, offset, count, i;
+	bool same = true;
+	int errors = 0;
+
+	n = Bench_Reference(kind, format);
+
+	Bench_Reset();
+	pos = 0;
+	Bench_Run(kind, format, 0, BENCH_SAMPLES, &pos);
+
+	for (i = 0; i < n; i++)
+	{
+		v = (format == 0) ? outF[i] : (format == 1) ? ldexp(outQ15[i], -15) : ldexp(outQ31[i], -31);
+		err = fmax(err, fabs(v - ref[i]));
+	}
+
+	/* O mesmo sinal em blocos de 1 a 100 amostras */
+	memcpy(outF2, outF, sizeof(outF));
+	memcpy(outQ15b, outQ15, sizeof(outQ15));
+	memcpy(outQ31b, outQ31, sizeof(outQ31));
+
+	Bench_Reset();
+	for (pos = 0, offset = 0; offset < BENCH_SAMPLES; offset += count)
+	{
+		count = (uint16_t) (1 + rand() % 100);
+		if (offset + count > BENCH_SAMPLES)
+		{
+			count = BENCH_SAMPLES - offset;
+		}
+		Bench_Run(kind, format, offset, count, &pos);
+	}
+
+	same = (pos == n) && ((format == 0) ? (memcmp(outF, outF2, n * sizeof(float)) == 0)
+			: (format == 1) ? (memcmp(outQ15, outQ15b, n * sizeof(int16_t)) == 0)
+			: (memcmp(outQ31, outQ31b, n * sizeof(int32_t)) == 0));
+
+	printf("%-10s %3s %6u %12.2e %10.2e %7s", strKind[kind], strFormat[format], n, err, tol[kind][format],
+			same ? "igual" : "DIFERE");
+
+	if ((err > tol[kind][format]) || (same == false))
+	{
+		printf("  FAIL");
+		errors++;
+	}
+	printf("\n");
+
+	return errors;
+}
+
+static double Bench_Time(BenchKind_e kind, uint8_t format)
+{
+	double start = Bench_Now();
+	double elapsed;
+	uint32_t runs = 0;
+	uint16_t pos;
+
+	Bench_Reset();
+
+	do
+	{
+		pos = 0;
+		Bench_Run(kind, format, 0, BENCH_SAMPLES, &pos);
+		runs++;
+		elapsed = Bench_Now() - start;
+	} while (elapsed < BENCH_MIN_SECONDS);
+
+	return elapsed * 1e9 / ((double) runs * BENCH_SAMPLES);
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(void)
+{
+	double ns;
+	int errors = 0;
+	uint16_t i;
+	uint8_t kind, format;
+
+	srand(1);
+
+	errors += Bench_Design();
+
+	Filter_DesignButterworth(FILTER_LOWPASS, BENCH_ORDER, BENCH_FC, bqCoeffs);
+	shiftQ15 = Filter_BiquadToQ15(bqCoeffs, BENCH_ORDER / 2, bqQ15);
+	shiftQ31 = Filter_BiquadToQ31(bqCoeffs, BENCH_ORDER / 2, bqQ31);
+
+	Filter_DesignFirLowpass(firCoeffs, BENCH_TAPS, 0.4f / BENCH_FACTOR);
+	Filter_FloatToQ15(firCoeffs, firQ15, BENCH_TAPS);
+	Filter_FloatToQ31(firCoeffs, firQ31, BENCH_TAPS);
+
+	/* A entrada ja quantizada em Q15: a mesma para os tres formatos */
+	for (i = 0; i < BENCH_SAMPLES; i++)
+	{
+		inQ15[i] = (int16_t) lrint(fmax(fmin(BENCH_AMPLITUDE * Bench_Gauss(), 0.999), -1.0) * 32768.0);
+		input[i] = ldexp(inQ15[i], -15);
+		inF[i] = (float) input[i];
+		inQ31[i] = (int32_t) inQ15[i] * 65536;
+	}
+
+	printf("\nshift dos biquads: q15 %u, q31 %u\n", shiftQ15, shiftQ31);
+	printf("%-10s %3s %6s %12s %10s %7s\n", "filtro", "fmt", "saidas", "erro max", "limite", "blocos");
+	for (kind = 0; kind < BENCH_KINDS; kind++)
+	{
+		for (format = 0; format < 3; format++)
+		{
+			errors += Bench_Check((BenchKind_e) kind, format);
+		}
+	}
+
+	printf("\n%-10s %3s %10s %10s\n", "filtro", "fmt", "ns/amostra", "Mamostra/s");
+	for (kind = 0; kind < BENCH_KINDS; kind++)
+	{
+		for (format = 0; format < 3; format++)
+		{
+			ns = Bench_Time((BenchKind_e) kind, format);
+			printf("%-10s %3s %10.2f %10.1f\n", strKind[kind], strFormat[format], ns, 1e3 / ns);
+		}
+	}
+
+	printf("\n%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}
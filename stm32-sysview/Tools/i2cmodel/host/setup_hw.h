@@ -0,0 +1,116 @@
+/**
+ * @file    setup_hw.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Substitui Application/Setup/setup_hw.h para compilar os sensores no PC
+ * @details
+ * Declara so o que os drivers I2C de Application/Libs, o registro
+ * (sensor_drv.c) e o cache (sensor_cache.c) usam do HAL, do FreeRTOS e do
+ * debug. O I2C_HandleTypeDef do PC guarda so o clock do barramento: as
+ * transacoes sao respondidas pelos modelos de registradores (i2c_model.c),
+ * que contam o tempo de barramento nesse clock. O tempo do FreeRTOS
+ * (ticks de 1 ms, osDelay) e o Timebase_Us dos carimbos sao o mesmo tempo
+ * simulado.
+ */
+
+#ifndef _SETUP_HW_H_
+#define _SETUP_HW_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define I2C_MEMADD_SIZE_8BIT		1
+
+#define DBG(fmt, ...)				fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+
+#define DBG_ASSERT_PARAM(x)			do { if (!(x)) { DBG("assert: %s", #x); abort(); } } while (0)
+#define configASSERT(x)				DBG_ASSERT_PARAM(x)
+
+/* Um unico contexto no PC: nada a proteger */
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#define pdTRUE						1
+#define pdFALSE						0
+#define portMAX_DELAY				0xFFFFFFFFUL
+
+/* Tick de 1 ms como no alvo (configTICK_RATE_HZ = 1000) */
+#define pdMS_TO_TICKS(ms)			((TickType_t) (ms))
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+typedef enum
+{
+	HAL_OK = 0,
+	HAL_ERROR,
+	HAL_BUSY,
+	HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+/** @brief Barramento simulado: so o clock (Hz) define o custo das transacoes */
+typedef struct
+{
+	uint32_t clock_hz;
+} I2C_HandleTypeDef;
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+
+/** @brief Mutex sem disputa: uma so task no PC */
+typedef struct
+{
+	int taken;
+} HostSemaphore_t;
+
+typedef HostSemaphore_t *SemaphoreHandle_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+/** @brief Avancam o tempo simulado */
+void HAL_Delay(uint32_t Delay);
+
+void osDelay(uint32_t millisec);
+
+uint32_t HAL_GetTick(void);
+
+TickType_t xTaskGetTickCount(void);
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait);
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+
+void vQueueAddToRegistry(SemaphoreHandle_t xQueue, const char *pcQueueName);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SETUP_HW_H_ */
@@ -0,0 +1,297 @@
+/**
+ * @file    hts221_model.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelo dos registradores do HTS221 (umidade e temperatura)
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "sensor_models.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define MODEL_ADDRESS			0xBE
+
+#define REG_WHO_AM_I			0x0F
+#define REG_AV_CONF				0x10
+#define REG_CTRL1				0x20
+#define REG_CTRL2				0x21
+#define REG_CTRL3				0x22
+#define REG_STATUS				0x27
+#define REG_HR_OUT_L			0x28
+#define REG_HR_OUT_H			0x29
+#define REG_TEMP_OUT_L			0x2A
+#define REG_TEMP_OUT_H			0x2B
+#define REG_CALIB_FIRST			0x30
+#define REG_CALIB_LAST			0x3F
+
+#define CTRL1_PD				0x80
+#define CTRL1_ODR				0x03
+#define CTRL2_BOOT				0x80
+#define CTRL2_ONE_SHOT			0x01
+#define STATUS_H_DA				0x02
+#define STATUS_T_DA				0x01
+
+/** @brief Pontos de calibracao de fabrica (de um CI tipico, arredondados) */
+#define CAL_T0_DEGC_X8			160     /* 20 C */
+#define CAL_T1_DEGC_X8			280     /* 35 C */
+#define CAL_T0_OUT				300
+#define CAL_T1_OUT				1260
+#define CAL_H0_RH_X2			50      /* 25 %RH */
+#define CAL_H1_RH_X2			150     /* 75 %RH */
+#define CAL_H0_T0_OUT			(-3000)
+#define CAL_H1_T0_OUT			9000
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static uint8_t regs[128];
+
+static float truthTemp = 25.0f;
+static float truthRh = 50.0f;
+
+static uint64_t nextSample;
+static uint64_t oneShotDone;
+static bool oneShotPending;
+static uint32_t conversionUs = HTS221_MODEL_CONVERSION_US;
+static uint32_t samples;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Registradores de calibracao (reset e BOOT). */
+static void Model_Calibration(void);
+
+/** @brief Grava uma conversao nas saidas e liga H_DA/T_DA. */
+static void Model_Sample(void);
+
+/** @brief Periodo do modo continuo em us (0 sem conversao continua). */
+static uint32_t Model_Period(void);
+
+/** @brief Saida crua pela reta entre dois pontos, arredondada e saturada. */
+static int16_t Model_Raw(float x, float x0, float x1, int16_t out0, int16_t out1);
+
+static void Model_Reset(void);
+static void Model_Advance(uint64_t now_us);
+static uint8_t Model_Select(uint8_t sub, bool *inc);
+static uint8_t Model_Next(uint8_t reg);
+static uint8_t Model_Read(uint8_t reg);
+static void Model_Write(uint8_t reg, uint8_t value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void Model_Calibration(void)
+{
+	regs[0x30] = CAL_H0_RH_X2;
+	regs[0x31] = CAL_H1_RH_X2;
+	regs[0x32] = (uint8_t) CAL_T0_DEGC_X8;
+	regs[0x33] = (uint8_t) CAL_T1_DEGC_X8;
+	regs[0x35] = (uint8_t) (((CAL_T1_DEGC_X8 >> 8) << 2) | (CAL_T0_DEGC_X8 >> 8));
+	regs[0x36] = (uint8_t) (CAL_H0_T0_OUT & 0xFF);
+	regs[0x37] = (uint8_t) ((CAL_H0_T0_OUT >> 8) & 0xFF);
+	regs[0x3A] = (uint8_t) (CAL_H1_T0_OUT & 0xFF);
+	regs[0x3B] = (uint8_t) ((CAL_H1_T0_OUT >> 8) & 0xFF);
+	regs[0x3C] = (uint8_t) (CAL_T0_OUT & 0xFF);
+	regs[0x3D] = (uint8_t) ((CAL_T0_OUT >> 8) & 0xFF);
+	regs[0x3E] = (uint8_t) (CAL_T1_OUT & 0xFF);
+	regs[0x3F] = (uint8_t) ((CAL_T1_OUT >> 8) & 0xFF);
+}
+
+static int16_t Model_Raw(float x, float x0, float x1, int16_t out0, int16_t out1)
+{
+	float raw = (float) out0 + (x - x0) * (float) (out1 - out0) / (x1 - x0);
+
+	raw = roundf(raw);
+	raw = (raw > 32767.0f) ? 32767.0f : ((raw < -32768.0f) ? -32768.0f : raw);
+
+	return (int16_t) raw;
+}
+
+static void Model_Sample(void)
+{
+	int16_t h, t;
+
+	h = Model_Raw(truthRh, CAL_H0_RH_X2 / 2.0f, CAL_H1_RH_X2 / 2.0f, CAL_H0_T0_OUT, CAL_H1_T0_OUT);
+	t = Model_Raw(truthTemp, CAL_T0_DEGC_X8 / 8.0f, CAL_T1_DEGC_X8 / 8.0f, CAL_T0_OUT, CAL_T1_OUT);
+
+	regs[REG_HR_OUT_L] = (uint8_t) h;
+	regs[REG_HR_OUT_H] = (uint8_t) ((uint16_t) h >> 8);
+	regs[REG_TEMP_OUT_L] = (uint8_t) t;
+	regs[REG_TEMP_OUT_H] = (uint8_t) ((uint16_t) t >> 8);
+	regs[REG_STATUS] |= STATUS_H_DA | STATUS_T_DA;
+	samples++;
+}
+
+static uint32_t Model_Period(void)
+{
+	static const uint32_t period_us[] = { 0, 1000000, 142857, 80000 };
+
+	if ((regs[REG_CTRL1] & CTRL1_PD) == 0)
+	{
+		return 0;
+	}
+
+	return period_us[regs[REG_CTRL1] & CTRL1_ODR];
+}
+
+static void Model_Reset(void)
+{
+	memset(regs, 0, sizeof(regs));
+	regs[REG_WHO_AM_I] = 0xBC;
+	regs[REG_AV_CONF] = 0x1B;
+	Model_Calibration();
+
+	oneShotPending = false;
+	nextSample = 0;
+	samples = 0;
+}
+
+static void Model_Advance(uint64_t now_us)
+{
+	uint32_t period = Model_Period();
+
+	if (oneShotPending && (now_us >= oneShotDone))
+	{
+		oneShotPending = false;
+		regs[REG_CTRL2] &= ~CTRL2_ONE_SHOT;
+		Model_Sample();
+	}
+
+	if (period == 0)
+	{
+		return;
+	}
+
+	while (nextSample <= now_us)
+	{
+		Model_Sample();
+		nextSample += period;
+	}
+}
+
+static uint8_t Model_Select(uint8_t sub, bool *inc)
+{
+	/* Bit 7 do subendereco pede o incremento */
+	*inc = (sub & 0x80) != 0;
+
+	return sub & 0x7F;
+}
+
+static uint8_t Model_Next(uint8_t reg)
+{
+	return (reg + 1) & 0x7F;
+}
+
+static uint8_t Model_Read(uint8_t reg)
+{
+	uint8_t value = regs[reg & 0x7F];
+
+	/* O byte alto de cada saida limpa o seu flag de dado novo */
+	if (reg == REG_HR_OUT_H)
+	{
+		regs[REG_STATUS] &= ~STATUS_H_DA;
+	}
+	else if (reg == REG_TEMP_OUT_H)
+	{
+		regs[REG_STATUS] &= ~STATUS_T_DA;
+	}
+
+	return value;
+}
+
+static void Model_Write(uint8_t reg, uint8_t value)
+{
+	uint32_t period;
+
+	switch (reg)
+	{
+	case REG_AV_CONF:
+		regs[reg] = value & 0x3F;
+		break;
+
+	case REG_CTRL1:
+		regs[reg] = value & 0x87;
+
+		/* Novo modo: a primeira conversao continua sai um periodo depois */
+		period = Model_Period();
+		nextSample = I2CModel_Now() + period;
+		break;
+
+	case REG_CTRL2:
+		regs[reg] = value & 0x83;
+
+		if (value & CTRL2_BOOT)
+		{
+			Model_Calibration();
+			regs[reg] &= ~CTRL2_BOOT;
+		}
+
+		/* Conversao unica so com o CI ativo e ODR = 00 */
+		if ((value & CTRL2_ONE_SHOT) && (oneShotPending == false))
+		{
+			if (((regs[REG_CTRL1] & CTRL1_PD) != 0) && ((regs[REG_CTRL1] & CTRL1_ODR) == 0))
+			{
+				oneShotPending = true;
+				oneShotDone = I2CModel_Now() + conversionUs;
+			}
+			else if ((regs[REG_CTRL1] & CTRL1_PD) != 0)
+			{
+				regs[reg] &= ~CTRL2_ONE_SHOT;
+			}
+		}
+		break;
+
+	case REG_CTRL3:
+		regs[reg] = value & 0xC4;
+		break;
+
+	default:
+		/* WHO_AM_I, STATUS, saidas e calibracao sao so de leitura */
+		break;
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+const I2CModelDevice_t HTS221_Model =
+{
+	.name = "HTS221",
+	.address = MODEL_ADDRESS,
+	.reset = Model_Reset,
+	.advance = Model_Advance,
+	.select = Model_Select,
+	.next = Model_Next,
+	.read = Model_Read,
+	.write = Model_Write,
+};
+
+void HTS221_Model_Set(float temp_c, float rh)
+{
+	truthTemp = temp_c;
+	truthRh = rh;
+}
+
+uint32_t HTS221_Model_Samples(void)
+{
+	return samples;
+}
+
+void HTS221_Model_SetConversion(uint32_t us)
+{
+	conversionUs = us;
+}
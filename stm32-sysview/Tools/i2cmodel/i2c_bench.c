@@ -0,0 +1,802 @@
+/**
+ * @file    i2c_bench.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Roda os drivers I2C da placa contra os modelos de registradores no PC
+ * @details
+ * Compilar (dentro de Tools/i2cmodel):
+ *
+ *   L=../../Application/Libs
+ *   gcc -O2 -Wall -Ihost -I. -I$L -I../../Application/App i2c_bench.c i2c_model.c \
+ *       hts221_model.c lps22hb_model.c lsm6dsl_model.c lis3mdl_model.c \
+ *       $L/sensor_drv/sensor_drv.c ../../Application/App/sensor_cache.c \
+ *       $L/hts221/hts221.c $L/lps22hb/lps22hb.c $L/lsm6dsl/lsm6dsl.c \
+ *       $L/lis3mdl/lis3mdl.c $L/imuconv/imuconv.c $L/timesync/timesync.c \
+ *       -lm -o i2c_bench
+ *
+ * Uso: ./i2c_bench [-t]
+ *
+ *   -t  registra cada transacao I2C em stderr
+ *
+ * Registra HTS221, LPS22HB, LSM6DSL e LIS3MDL pelo sensor_drv como o
+ * Sensores_Init (com os filtros do boot) e mede, em transacoes, bytes e us
+ * de barramento a 100 kHz (o hi2c2 da placa) e a 400 kHz:
+ *
+ *   1. o boot de cada CI (WHO_AM_I, init e a leitura da calibracao);
+ *   2. uma amostra de cada canal no modo continuo e por conversao unica,
+ *      conferindo o valor convertido contra a grandeza do modelo;
+ *   3. o acelerometro a 416 Hz e a pressao a 75 Hz lidos amostra a amostra
+ *      contra o FIFO (ReadBatch a cada 50 ms e no watermark 16 do INT_DRDY),
+ *      conferindo as amostras e os contadores de barramento dos drivers; o
+ *      FIFO do acelerometro tambem com o timestamp do CI (relogio do CI
+ *      150 ppm adiantado), conferindo os carimbos da primeira e da ultima
+ *      amostra de cada lote contra o instante real da gravacao;
+ *   4. dois consumidores lendo os 7 campos do Sensores_Read a 10 Hz com e
+ *      sem o sensor_cache.
+ *
+ * No modo continuo cada amostra deve custar uma transacao: as calibracoes
+ * e sensibilidades ficam em RAM nos drivers. O tempo de CPU nao entra nas
+ * contas (no alvo o barramento e bloqueante: os us de barramento sao
+ * tambem us de CPU da task).
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "i2c_model.h"
+#include "sensor_models.h"
+
+#include "sensor_drv/sensor_drv.h"
+#include "sensor_cache.h"
+#include "hts221/hts221.h"
+#include "lps22hb/lps22hb.h"
+#include "lsm6dsl/lsm6dsl.h"
+#include "lis3mdl/lis3mdl.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Clock do hi2c2 na placa */
+#define BENCH_BOARD_HZ			100000
+
+#define BENCH_NUM_CLOCKS		2
+
+/** @brief Amostras por medida do custo de leitura */
+#define BENCH_READS				20
+
+/** @brief Taxa assinada para forcar a conversao unica (abaixo de todo ODR) */
+#define BENCH_ONE_SHOT_MHZ		100
+
+/** @brief Intervalo entre leituras por conversao unica */
+#define BENCH_ONE_SHOT_GAP_US	100000ULL
+
+#define BENCH_FIFO_RUN_US		2000000ULL
+#define BENCH_ACC_MHZ			416000
+#define BENCH_ACC_DRAIN_US		50000ULL
+#define BENCH_CHIP_PPM			150.0
+#define BENCH_BARO_MHZ			75000
+#define BENCH_BARO_WATERMARK	16
+#define BENCH_BARO_POLL_US		1000ULL
+
+/** @brief Consumidores do Sensores_Read */
+#define BENCH_CACHE_RUN_US		10000000ULL
+#define BENCH_CACHE_PERIOD_US	100000ULL
+#define BENCH_CACHE_PHASE_US	37000ULL
+
+#define BENCH_MAX_ROWS			24
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Canal medido e o valor esperado depois da conversao */
+typedef struct
+{
+	SensorType_e type;
+	const char *driver;
+	int32_t expected[SENSOR_DRV_MAX_AXES]; /**< Grandeza * scale do canal */
+	int32_t tolerance;                     /**< Meio LSB do registrador, na unidade do canal */
+} BenchChannel_t;
+
+/** @brief Media de uma medida */
+typedef struct
+{
+	const char *chip;
+	const char *name;
+	const char *mode;
+	uint32_t samples;
+	double transfers;       /**< Por amostra */
+	double bytes;
+	double bus_us[BENCH_NUM_CLOCKS];
+	double occupancy[BENCH_NUM_CLOCKS]; /**< Fracao do tempo com o barramento ocupado */
+} BenchRow_t;
+
+/** @brief Filtro do boot (o mesmo de sensores.c) */
+typedef struct
+{
+	SensorType_e type;
+	const char *driver;
+	uint16_t level;
+} BenchFilter_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static I2C_HandleTypeDef hi2c = { BENCH_BOARD_HZ };
+
+static const uint32_t benchClocks[BENCH_NUM_CLOCKS] = { 100000, 400000 };
+
+static const SensorDriver_t * const benchDrivers[] =
+{
+	&HTS221_Driver,
+	&LPS22HB_Driver,
+	&LSM6DSL_Driver,
+	&LIS3MDL_Driver,
+};
+
+static const BenchFilter_t benchFilters[] =
+{
+	{ SENSOR_TYPE_TEMPERATURE, "HTS221", 16 },
+	{ SENSOR_TYPE_HUMIDITY, "HTS221", 32 },
+	{ SENSOR_TYPE_PRESSURE, "LPS22HB", 9 },
+};
+
+/* Grandezas dos modelos */
+static const float truthAcc[3] = { 12.0f, -35.0f, 998.0f };
+static const float truthGyro[3] = { 1250.0f, -420.0f, 75.0f };
+static const float truthMag[3] = { 231.0f, -87.0f, 412.0f };
+
+/* Na unidade de cada canal: 0.01 C, 0.1 %RH, 1/4096 hPa, 0.01 mdps, ug e ugauss */
+static const BenchChannel_t benchChannels[] =
+{
+	{ SENSOR_TYPE_TEMPERATURE, "HTS221", { 2340 }, 2 },
+	{ SENSOR_TYPE_HUMIDITY, "HTS221", { 417 }, 1 },
+	{ SENSOR_TYPE_PRESSURE, "LPS22HB", { 4130284 }, 1 },
+	{ SENSOR_TYPE_TEMPERATURE, "LPS22HB", { 2390 }, 1 },
+	{ SENSOR_TYPE_GYRO, "LSM6DSL", { 125000, -42000, 7500 }, 3500 },
+	{ SENSOR_TYPE_ACCELERO, "LSM6DSL", { 12000, -35000, 998000 }, 31 },
+	{ SENSOR_TYPE_MAGNETO, "LIS3MDL", { 231000, -87000, 412000 }, 70 },
+};
+
+#define BENCH_NUM_CHANNELS		(sizeof(benchChannels) / sizeof(benchChannels[0]))
+
+static BenchRow_t rows[BENCH_MAX_ROWS];
+static uint8_t numRows;
+
+static int errors;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Liga os modelos e registra os drivers como o Sensores_Init. */
+static void Bench_Boot(void);
+
+/**
+ * Avanca ate o proximo instante de um ritmo fixo (o tempo gasto no
+ * barramento nao atrasa as leituras seguintes).
+ * @param next Instante anterior; atualizado.
+ * @param period Periodo (us).
+ */
+static void Bench_Wait(uint64_t *next, uint64_t period);
+
+/**
+ * Confere uma amostra convertida.
+ * @param bc Canal e valor esperado.
+ * @param id Indice do canal no registro.
+ * @param value Valores convertidos.
+ * @param what Caso, para a mensagem.
+ */
+static void Bench_Check(const BenchChannel_t *bc, uint8_t id, const int32_t *value, const char *what);
+
+/**
+ * Diferenca entre duas leituras dos contadores.
+ * @param a Antes.
+ * @param b Depois.
+ * @param d Saida.
+ */
+static void Bench_Delta(const I2CModelStats_t *a, const I2CModelStats_t *b, I2CModelStats_t *d);
+
+/**
+ * Linha da tabela para um caso, criada na primeira passada.
+ * @param index Posicao.
+ * @param chip CI.
+ * @param name Canal.
+ * @param mode Modo de leitura.
+ */
+static BenchRow_t *Bench_Row(uint8_t index, const char *chip, const char *name, const char *mode);
+
+/**
+ * Guarda o custo medio de uma medida no clock atual.
+ * @param row Linha.
+ * @param clock Indice do clock.
+ * @param d Contadores da medida.
+ * @param samples Amostras entregues.
+ * @param elapsed_us Tempo simulado da medida.
+ */
+static void Bench_Store(BenchRow_t *row, uint8_t clock, const I2CModelStats_t *d, uint32_t samples,
+		uint64_t elapsed_us);
+
+/**
+ * Custo por amostra de cada canal, continuo e por conversao unica.
+ * @param clock Indice do clock.
+ * @return Linhas usadas na tabela.
+ */
+static uint8_t Bench_PerSample(uint8_t clock);
+
+/**
+ * Confere o carimbo de um data set do FIFO do LSM6DSL.
+ * @param index Contagem do modelo do data set.
+ * @param stamp Carimbo do driver (Timebase_Us).
+ * @param worst Maior erro visto (us).
+ * @return false se o erro passou do informado pelo driver.
+ */
+static bool Bench_Stamp(uint32_t index, uint64_t stamp, double *worst);
+
+/**
+ * Amostra a amostra contra o FIFO.
+ * @param clock Indice do clock.
+ * @param first Primeira linha da tabela.
+ */
+static void Bench_Fifo(uint8_t clock, uint8_t first);
+
+/** @brief Sensores_Read de dois consumidores com e sem o cache. */
+static void Bench_Cache(void);
+
+/**
+ * Imprime as linhas.
+ * @param title Titulo.
+ * @param first Primeira linha.
+ * @param last Depois da ultima.
+ */
+static void Bench_Print(const char *title, uint8_t first, uint8_t last);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void Bench_Delta(const I2CModelStats_t *a, const I2CModelStats_t *b, I2CModelStats_t *d)
+{
+	d->transfers = b->transfers - a->transfers;
+	d->reads = b->reads - a->reads;
+	d->nacks = b->nacks - a->nacks;
+	d->bytes = b->bytes - a->bytes;
+	d->bus_ns = b->bus_ns - a->bus_ns;
+}
+
+static void Bench_Wait(uint64_t *next, uint64_t period)
+{
+	*next += period;
+
+	if (*next > I2CModel_Now())
+	{
+		I2CModel_Advance(*next - I2CModel_Now());
+	}
+}
+
+static bool Bench_Stamp(uint32_t index, uint64_t stamp, double *worst)
+{
+	TSyncEstimate_t est;
+	double err = fabs((double) stamp - (double) LSM6DSL_Model_FifoTime(index) / 1000.0);
+
+	LSM6DSL_FifoGetClock(&est);
+	*worst = (err > *worst) ? err : *worst;
+
+	/* Reta do relogio mais um LSB do timestamp e o arredondamento para us */
+	return err <= (est.error_us + LSM6DSL_TIMESTAMP_US + 1.0);
+}
+
+static void Bench_Boot(void)
+{
+	I2CModelStats_t before, after, d;
+	uint8_t i;
+
+	I2CModel_Init();
+	I2CModel_Attach(&HTS221_Model);
+	I2CModel_Attach(&LPS22HB_Model);
+	I2CModel_Attach(&LSM6DSL_Model);
+	I2CModel_Attach(&LIS3MDL_Model);
+
+	HTS221_Model_Set(23.4f, 41.7f);
+	LPS22HB_Model_Set(4130284.0f / 4096.0f, 23.9f);
+	LSM6DSL_Model_Set(truthAcc, truthGyro);
+	LIS3MDL_Model_Set(truthMag);
+
+	HTS221_attach(&hi2c);
+	LPS22HB_attach(&hi2c);
+	LSM6DSL_attach(&hi2c);
+	LIS3MDL_attach(&hi2c);
+
+	printf("\nboot a %u kHz\n", BENCH_BOARD_HZ / 1000);
+	printf("%-10s %10s %8s %10s\n", "CI", "transacoes", "bytes", "us");
+
+	for (i = 0; i < (sizeof(benchDrivers) / sizeof(benchDrivers[0])); i++)
+	{
+		I2CModel_GetStats(benchDrivers[i]->address, &before);
+
+		if (SensorDrv_Register(benchDrivers[i]) != HAL_OK)
+		{
+			printf("FAIL: %s nao registrou\n", benchDrivers[i]->name);
+			errors++;
+			continue;
+		}
+
+		I2CModel_GetStats(benchDrivers[i]->address, &after);
+		Bench_Delta(&before, &after, &d);
+		printf("%-10s %10u %8u %10.1f\n", benchDrivers[i]->name, d.transfers, d.bytes, d.bus_ns / 1000.0);
+	}
+
+	for (i = 0; i < (sizeof(benchFilters) / sizeof(benchFilters[0])); i++)
+	{
+		SensorDrv_SetFilter(SensorDrv_Find(benchFilters[i].type, benchFilters[i].driver), benchFilters[i].level);
+	}
+
+	SensorCache_Init();
+}
+
+static void Bench_Check(const BenchChannel_t *bc, uint8_t id, const int32_t *value, const char *what)
+{
+	const SensorChannelDesc_t *desc = SensorDrv_GetDesc(id);
+	uint8_t axis;
+
+	for (axis = 0; axis < desc->axes; axis++)
+	{
+		if (labs((long) (value[axis] - bc->expected[axis])) > bc->tolerance)
+		{
+			printf("FAIL: %s %s (%s) eixo %u: %d, esperado %d\n", bc->driver, desc->name, what, axis,
+					(int) value[axis], (int) bc->expected[axis]);
+			errors++;
+			return;
+		}
+	}
+}
+
+static BenchRow_t *Bench_Row(uint8_t index, const char *chip, const char *name, const char *mode)
+{
+	BenchRow_t *row = &rows[index];
+
+	if (index >= numRows)
+	{
+		memset(row, 0, sizeof(BenchRow_t));
+		row->chip = chip;
+		row->name = name;
+		row->mode = mode;
+		numRows = index + 1;
+	}
+
+	return row;
+}
+
+static void Bench_Store(BenchRow_t *row, uint8_t clock, const I2CModelStats_t *d, uint32_t samples,
+		uint64_t elapsed_us)
+{
+	if (samples == 0)
+	{
+		printf("FAIL: %s %s %s sem amostras\n", row->chip, row->name, row->mode);
+		errors++;
+		return;
+	}
+
+	/* Transacoes e bytes nao dependem do clock (fora a conversao unica, que pode mudar o numero de consultas) */
+	row->samples = samples;
+	row->transfers = (double) d->transfers / samples;
+	row->bytes = (double) d->bytes / samples;
+	row->bus_us[clock] = d->bus_ns / 1000.0 / samples;
+	row->occupancy[clock] = (elapsed_us > 0) ? (d->bus_ns / 1000.0 / elapsed_us) : 0.0;
+}
+
+static uint8_t Bench_PerSample(uint8_t clock)
+{
+	const BenchChannel_t *bc;
+	const SensorChannelDesc_t *desc;
+	const SensorDriver_t *drv;
+	I2CModelStats_t before, after, d;
+	int32_t value[SENSOR_DRV_MAX_AXES];
+	uint64_t period, start, next;
+	uint8_t i, id, handle, row = 0;
+	uint32_t n, ok;
+
+	for (i = 0; i < BENCH_NUM_CHANNELS; i++)
+	{
+		bc = &benchChannels[i];
+		id = SensorDrv_Find(bc->type, bc->driver);
+		desc = SensorDrv_GetDesc(id);
+		drv = SensorDrv_GetOwner(id);
+
+		/* Continuo no menor ODR: a primeira amostra sai um periodo depois */
+		handle = SensorDrv_Subscribe(id, desc->odrs[0], SENSOR_POWER_NORMAL);
+		period = 1000000000ULL / desc->odrs[0];
+		I2CModel_Advance(period);
+
+		I2CModel_GetStats(drv->address, &before);
+		start = I2CModel_Now();
+		for (n = 0, ok = 0, next = start; n < BENCH_READS; n++)
+		{
+			Bench_Wait(&next, period);
+			if (SensorDrv_Read(id, value) == HAL_OK)
+			{
+				Bench_Check(bc, id, value, "continuo");
+				ok++;
+			}
+		}
+		I2CModel_GetStats(drv->address, &after);
+		Bench_Delta(&before, &after, &d);
+		Bench_Store(Bench_Row(row++, bc->driver, desc->name, "continuo"), clock, &d, ok, I2CModel_Now() - start);
+
+		SensorDrv_Unsubscribe(handle);
+
+		if (drv->one_shot == NULL)
+		{
+			continue;
+		}
+
+		/* Abaixo do menor ODR o registro desliga o CI e dispara uma conversao por leitura */
+		handle = SensorDrv_Subscribe(id, BENCH_ONE_SHOT_MHZ, SENSOR_POWER_NORMAL);
+
+		I2CModel_GetStats(drv->address, &before);
+		start = I2CModel_Now();
+		for (n = 0, ok = 0, next = start; n < BENCH_READS; n++)
+		{
+			Bench_Wait(&next, BENCH_ONE_SHOT_GAP_US);
+			if (SensorDrv_Read(id, value) == HAL_OK)
+			{
+				Bench_Check(bc, id, value, "unica");
+				ok++;
+			}
+		}
+		I2CModel_GetStats(drv->address, &after);
+		Bench_Delta(&before, &after, &d);
+		Bench_Store(Bench_Row(row++, bc->driver, desc->name, "unica"), clock, &d, ok, I2CModel_Now() - start);
+
+		SensorDrv_Unsubscribe(handle);
+	}
+
+	return row;
+}
+
+static void Bench_Fifo(uint8_t clock, uint8_t first)
+{
+	static int32_t batch[LSM6DSL_FIFO_SAMPLES * 3];
+	const BenchChannel_t *bcAcc = &benchChannels[5];
+	const BenchChannel_t *bcBaro = &benchChannels[2];
+	uint8_t acc = SensorDrv_Find(SENSOR_TYPE_ACCELERO, "LSM6DSL");
+	uint8_t baro = SensorDrv_Find(SENSOR_TYPE_PRESSURE, "LPS22HB");
+	I2CModelStats_t before, after, d;
+	SensorModelFifo_t fifo;
+	uint32_t drvTransfers[2], drvBytes[2], samples, n, k;
+	uint64_t start, next, oldest, newest;
+	TSyncEstimate_t est;
+	double worst;
+	uint32_t late;
+	uint8_t handle, row = first;
+	int32_t value[SENSOR_DRV_MAX_AXES];
+
+	/* Acelerometro: uma leitura por amostra no ODR */
+	handle = SensorDrv_Subscribe(acc, BENCH_ACC_MHZ, SENSOR_POWER_NORMAL);
+	I2CModel_Advance(1000000000ULL / BENCH_ACC_MHZ);
+
+	I2CModel_GetStats(LSM6DSL_Driver.address, &before);
+	start = I2CModel_Now();
+	for (samples = 0, next = start; (I2CModel_Now() - start) < BENCH_FIFO_RUN_US; samples++)
+	{
+		Bench_Wait(&next, 1000000000ULL / BENCH_ACC_MHZ);
+		SensorDrv_Read(acc, value);
+	}
+	I2CModel_GetStats(LSM6DSL_Driver.address, &after);
+	Bench_Delta(&before, &after, &d);
+	Bench_Store(Bench_Row(row++, "LSM6DSL", "accelero", "amostra 416 Hz"), clock, &d, samples, I2CModel_Now() - start);
+
+	/* Acelerometro: FIFO esvaziado a cada 50 ms */
+	SensorDrv_Lock();
+	LSM6DSL_FifoStart();
+	SensorDrv_Unlock();
+
+	/* Um data set pode ser gravado durante a ultima escrita do LSM6DSL_FifoStart */
+	LSM6DSL_Model_GetFifo(&fifo);
+	k = fifo.written - fifo.level;
+	LSM6DSL_GetBusStats(&drvTransfers[0], &drvBytes[0]);
+	I2CModel_GetStats(LSM6DSL_Driver.address, &before);
+	start = I2CModel_Now();
+	for (samples = 0, next = start; (I2CModel_Now() - start) < BENCH_FIFO_RUN_US;)
+	{
+		Bench_Wait(&next, BENCH_ACC_DRAIN_US);
+		n = SensorDrv_ReadBatch(acc, batch, LSM6DSL_FIFO_SAMPLES);
+		while (n-- > 0)
+		{
+			Bench_Check(bcAcc, acc, &batch[3 * n], "fifo");
+			samples++;
+		}
+	}
+	I2CModel_GetStats(LSM6DSL_Driver.address, &after);
+	LSM6DSL_GetBusStats(&drvTransfers[1], &drvBytes[1]);
+	Bench_Delta(&before, &after, &d);
+	Bench_Store(Bench_Row(row++, "LSM6DSL", "accelero", "fifo 50 ms"), clock, &d, samples, I2CModel_Now() - start);
+
+	LSM6DSL_Model_GetFifo(&fifo);
+	if ((fifo.dropped != 0) || ((fifo.written - k) != (samples + fifo.level)))
+	{
+		printf("FAIL: FIFO do LSM6DSL gravou %u, lidas %u, no FIFO %u, perdidas %u\n", fifo.written - k, samples,
+				fifo.level, fifo.dropped);
+		errors++;
+	}
+	if (((drvTransfers[1] - drvTransfers[0]) != d.transfers) || ((drvBytes[1] - drvBytes[0]) != d.bytes))
+	{
+		printf("FAIL: contadores do LSM6DSL (%u/%u) diferentes do barramento (%u/%u)\n",
+				drvTransfers[1] - drvTransfers[0], drvBytes[1] - drvBytes[0], d.transfers, d.bytes);
+		errors++;
+	}
+
+	/* Acelerometro: FIFO com o timestamp do CI; o carimbo deve cair no instante da gravacao */
+	LSM6DSL_Model_SetClock(BENCH_CHIP_PPM);
+	SensorDrv_Lock();
+	LSM6DSL_FifoSetTimestamp(1);
+	LSM6DSL_FifoStart();
+	SensorDrv_Unlock();
+
+	LSM6DSL_Model_GetFifo(&fifo);
+	k = fifo.written - fifo.level;
+	I2CModel_GetStats(LSM6DSL_Driver.address, &before);
+	start = I2CModel_Now();
+	for (samples = 0, late = 0, worst = 0.0, next = start; (I2CModel_Now() - start) < BENCH_FIFO_RUN_US;)
+	{
+		Bench_Wait(&next, BENCH_ACC_DRAIN_US);
+		n = SensorDrv_ReadBatch(acc, batch, LSM6DSL_FIFO_SAMPLES);
+		if (LSM6DSL_FifoGetBatchStamps(&oldest, &newest) > 0)
+		{
+			late += Bench_Stamp(k + samples, oldest, &worst) ? 0 : 1;
+			late += Bench_Stamp(k + samples + n - 1, newest, &worst) ? 0 : 1;
+		}
+
+		samples += n;
+		while (n-- > 0)
+		{
+			Bench_Check(bcAcc, acc, &batch[3 * n], "fifo ts");
+		}
+	}
+	I2CModel_GetStats(LSM6DSL_Driver.address, &after);
+	Bench_Delta(&before, &after, &d);
+	Bench_Store(Bench_Row(row++, "LSM6DSL", "accelero", "fifo 50 ms ts"), clock, &d, samples, I2CModel_Now() - start);
+
+	LSM6DSL_FifoGetClock(&est);
+	printf("\ntimestamp do LSM6DSL a %u kHz: drift %.1f ppm (modelo %.1f), erro informado %.1f us, maior erro %.1f us\n",
+			benchClocks[clock] / 1000, est.drift * 1e6, BENCH_CHIP_PPM, est.error_us, worst);
+
+	LSM6DSL_Model_GetFifo(&fifo);
+	if ((fifo.dropped != 0) || ((fifo.written - k) != (samples + fifo.level)) || (late != 0) || (worst >= 1000.0))
+	{
+		printf("FAIL: FIFO com timestamp gravou %u, lidas %u, no FIFO %u, %u carimbos fora do erro\n",
+				fifo.written - k, samples, fifo.level, late);
+		errors++;
+	}
+
+	SensorDrv_Lock();
+	LSM6DSL_FifoSetTimestamp(0);
+	LSM6DSL_FifoStop();
+	SensorDrv_Unlock();
+	SensorDrv_Unsubscribe(handle);
+	LSM6DSL_Model_SetClock(0.0);
+
+	/* Pressao: uma leitura por amostra no ODR */
+	handle = SensorDrv_Subscribe(baro, BENCH_BARO_MHZ, SENSOR_POWER_NORMAL);
+	I2CModel_Advance(1000000000ULL / BENCH_BARO_MHZ);
+
+	I2CModel_GetStats(LPS22HB_Driver.address, &before);
+	start = I2CModel_Now();
+	for (samples = 0, next = start; (I2CModel_Now() - start) < BENCH_FIFO_RUN_US; samples++)
+	{
+		Bench_Wait(&next, 1000000000ULL / BENCH_BARO_MHZ);
+		SensorDrv_Read(baro, value);
+	}
+	I2CModel_GetStats(LPS22HB_Driver.address, &after);
+	Bench_Delta(&before, &after, &d);
+	Bench_Store(Bench_Row(row++, "LPS22HB", "pressure", "amostra 75 Hz"), clock, &d, samples, I2CModel_Now() - start);
+
+	/* Pressao: FIFO esvaziado no watermark, como o app_baro */
+	SensorDrv_Lock();
+	LPS22HB_FifoStart(BENCH_BARO_WATERMARK);
+	SensorDrv_Unlock();
+
+	LPS22HB_Model_GetFifo(&fifo);
+	k = fifo.written;
+	LPS22HB_GetBusStats(&drvTransfers[0], &drvBytes[0]);
+	I2CModel_GetStats(LPS22HB_Driver.address, &before);
+	start = I2CModel_Now();
+	for (samples = 0, next = start; (I2CModel_Now() - start) < BENCH_FIFO_RUN_US;)
+	{
+		Bench_Wait(&next, BENCH_BARO_POLL_US);
+
+		if (LPS22HB_Model_Int() == false)
+		{
+			continue;
+		}
+
+		n = SensorDrv_ReadBatch(baro, batch, LPS22HB_FIFO_SIZE);
+		while (n-- > 0)
+		{
+			Bench_Check(bcBaro, baro, &batch[n], "fifo");
+			samples++;
+		}
+	}
+	I2CModel_GetStats(LPS22HB_Driver.address, &after);
+	LPS22HB_GetBusStats(&drvTransfers[1], &drvBytes[1]);
+	Bench_Delta(&before, &after, &d);
+	Bench_Store(Bench_Row(row++, "LPS22HB", "pressure", "fifo wtm 16"), clock, &d, samples, I2CModel_Now() - start);
+
+	LPS22HB_Model_GetFifo(&fifo);
+	if ((fifo.dropped != 0) || ((fifo.written - k) != (samples + fifo.level)))
+	{
+		printf("FAIL: FIFO do LPS22HB gravou %u, lidas %u, no FIFO %u, perdidas %u\n", fifo.written - k, samples,
+				fifo.level, fifo.dropped);
+		errors++;
+	}
+	if (((drvTransfers[1] - drvTransfers[0]) != d.transfers) || ((drvBytes[1] - drvBytes[0]) != d.bytes))
+	{
+		printf("FAIL: contadores do LPS22HB (%u/%u) diferentes do barramento (%u/%u)\n",
+				drvTransfers[1] - drvTransfers[0], drvBytes[1] - drvBytes[0], d.transfers, d.bytes);
+		errors++;
+	}
+
+	SensorDrv_Lock();
+	LPS22HB_FifoStop();
+	SensorDrv_Unlock();
+	SensorDrv_Unsubscribe(handle);
+
+	/* O lote deve sair mais barato por amostra que a leitura uma a uma */
+	for (row = first; row < (first + 4); row += 2)
+	{
+		if (rows[row + 1].bus_us[clock] >= rows[row].bus_us[clock])
+		{
+			printf("FAIL: %s %s: FIFO nao reduz o barramento por amostra\n", rows[row].chip, rows[row].name);
+			errors++;
+		}
+	}
+}
+
+static void Bench_Cache(void)
+{
+	uint8_t ids[BENCH_NUM_CHANNELS], handles[BENCH_NUM_CHANNELS];
+	int32_t value[SENSOR_DRV_MAX_AXES];
+	I2CModelStats_t before, after, d[2];
+	SensorCacheStats_t stats;
+	uint64_t start, t[2];
+	uint32_t hits = 0, misses = 0, reads[2] = { 0 };
+	uint8_t i, c, pass;
+
+	/* Cada canal convertendo no menor ODR, como com um assinante de baixa taxa */
+	for (i = 0; i < BENCH_NUM_CHANNELS; i++)
+	{
+		ids[i] = SensorDrv_Find(benchChannels[i].type, benchChannels[i].driver);
+		handles[i] = SensorDrv_Subscribe(ids[i], SensorDrv_GetDesc(ids[i])->odrs[0], SENSOR_POWER_NORMAL);
+	}
+	I2CModel_Advance(2000000ULL);
+
+	/* Passada 0 com o cache; passada 1 sempre lendo o sensor */
+	for (pass = 0; pass < 2; pass++)
+	{
+		SensorCache_ResetStats();
+		SensorCache_Invalidate(SENSOR_CACHE_ALL);
+		I2CModel_GetStats(0, &before);
+		start = I2CModel_Now();
+		t[0] = start;
+		t[1] = start + BENCH_CACHE_PHASE_US;
+
+		while ((I2CModel_Now() - start) < BENCH_CACHE_RUN_US)
+		{
+			/* Proximo consumidor a ler */
+			c = (t[0] <= t[1]) ? 0 : 1;
+			if (t[c] > I2CModel_Now())
+			{
+				I2CModel_Advance(t[c] - I2CModel_Now());
+			}
+			t[c] += BENCH_CACHE_PERIOD_US;
+
+			for (i = 0; i < BENCH_NUM_CHANNELS; i++)
+			{
+				if (SensorCache_Read(ids[i], value, pass == 1) == HAL_OK)
+				{
+					Bench_Check(&benchChannels[i], ids[i], value, "cache");
+				}
+				reads[pass]++;
+			}
+		}
+
+		I2CModel_GetStats(0, &after);
+		Bench_Delta(&before, &after, &d[pass]);
+
+		if (pass == 0)
+		{
+			for (i = 0; i < BENCH_NUM_CHANNELS; i++)
+			{
+				SensorCache_GetStats(ids[i], &stats);
+				hits += stats.hits;
+				misses += stats.misses;
+			}
+		}
+	}
+
+	for (i = 0; i < BENCH_NUM_CHANNELS; i++)
+	{
+		SensorDrv_Unsubscribe(handles[i]);
+	}
+
+	printf("\nSensores_Read de 2 consumidores a 10 Hz por %.0f s, %u kHz\n", BENCH_CACHE_RUN_US / 1e6,
+			hi2c.clock_hz / 1000);
+	printf("%-10s %8s %8s %10s %10s %12s\n", "caso", "leituras", "hits", "transacoes", "bytes", "barramento");
+	printf("%-10s %8u %8u %10u %10u %11.2f%%\n", "cache", reads[0], hits, d[0].transfers, d[0].bytes,
+			100.0 * d[0].bus_ns / 1000.0 / BENCH_CACHE_RUN_US);
+	printf("%-10s %8u %8u %10u %10u %11.2f%%\n", "sem cache", reads[1], 0, d[1].transfers, d[1].bytes,
+			100.0 * d[1].bus_ns / 1000.0 / BENCH_CACHE_RUN_US);
+
+	if ((hits == 0) || (misses != d[0].transfers) || (d[0].bus_ns >= d[1].bus_ns))
+	{
+		printf("FAIL: cache com %u hits e %u misses para %u transacoes\n", hits, misses, d[0].transfers);
+		errors++;
+	}
+}
+
+static void Bench_Print(const char *title, uint8_t first, uint8_t last)
+{
+	uint8_t i, c;
+
+	printf("\n%s\n", title);
+	printf("%-8s %-12s %-14s %8s %8s", "CI", "canal", "modo", "trans", "bytes");
+	for (c = 0; c < BENCH_NUM_CLOCKS; c++)
+	{
+		printf("   us@%-3u ocup", benchClocks[c] / 1000);
+	}
+	printf("\n");
+
+	for (i = first; i < last; i++)
+	{
+		printf("%-8s %-12s %-14s %8.2f %8.1f", rows[i].chip, rows[i].name, rows[i].mode,
+				rows[i].transfers, rows[i].bytes);
+		for (c = 0; c < BENCH_NUM_CLOCKS; c++)
+		{
+			printf(" %8.1f %5.2f%%", rows[i].bus_us[c], 100.0 * rows[i].occupancy[c]);
+		}
+		printf("\n");
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	uint8_t c, perSample;
+
+	if ((argc > 1) && (strcmp(argv[1], "-t") == 0))
+	{
+		I2CModel_Trace(true);
+	}
+
+	Bench_Boot();
+
+	for (c = 0; c < BENCH_NUM_CLOCKS; c++)
+	{
+		hi2c.clock_hz = benchClocks[c];
+		perSample = Bench_PerSample(c);
+		Bench_Fifo(c, perSample);
+	}
+
+	Bench_Print("custo por amostra (trans e bytes por amostra, us de barramento, ocupacao no ritmo da medida)",
+			0, perSample);
+	Bench_Print("amostra a amostra contra o FIFO", perSample, numRows);
+
+	hi2c.clock_hz = BENCH_BOARD_HZ;
+	Bench_Cache();
+
+	printf("\n%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,354 @@
+/**
+ * @file    i2c_model.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Barramento I2C simulado para rodar os drivers dos sensores no PC
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "i2c_model.h"
+#include "setup_hw.h"
+#include "timebase/timebase.h"
+
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief 9 bits por byte: 8 de dado e o ACK */
+#define MODEL_BITS_BYTE			9ULL
+
+/** @brief Condicoes de START/STOP, um bit cada */
+#define MODEL_WRITE_CONDITIONS	2ULL
+#define MODEL_READ_CONDITIONS	3ULL
+
+/** @brief Bytes alem dos dados: endereco e subendereco (e o endereco de novo na leitura) */
+#define MODEL_WRITE_OVERHEAD	2
+#define MODEL_READ_OVERHEAD		3
+
+/** @brief Clock do core no Timebase do PC: os carimbos saem no tempo do barramento */
+#define MODEL_CORE_HZ			80000000UL
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static const I2CModelDevice_t *devices[I2C_MODEL_MAX_DEVICES];
+static I2CModelStats_t devStats[I2C_MODEL_MAX_DEVICES];
+static uint8_t numDevices;
+
+static I2CModelStats_t busStats;
+static uint64_t now_ns;
+static bool trace;
+
+static HostSemaphore_t semaphores[16];
+static uint8_t numSemaphores;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Procura o modelo de um endereco.
+ * @param address Endereco de 8 bits (bit 0 ignorado).
+ * @return Posicao na tabela ou -1.
+ */
+static int Model_Find(uint16_t address);
+
+/**
+ * Conta uma transacao e avanca o tempo pela sua duracao.
+ * @param index Dispositivo ou -1 (NACK).
+ * @param read Leitura.
+ * @param bytes Bytes no barramento.
+ * @param clock_hz Clock do barramento.
+ */
+static void Model_Bus(int index, bool read, uint32_t bytes, uint32_t clock_hz);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static int Model_Find(uint16_t address)
+{
+	uint8_t i;
+
+	for (i = 0; i < numDevices; i++)
+	{
+		if (devices[i]->address == (uint8_t) (address & 0xFE))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static void Model_Bus(int index, bool read, uint32_t bytes, uint32_t clock_hz)
+{
+	uint64_t bits = bytes * MODEL_BITS_BYTE + (read ? MODEL_READ_CONDITIONS : MODEL_WRITE_CONDITIONS);
+	uint64_t ns = (bits * 1000000000ULL + clock_hz / 2) / clock_hz;
+	I2CModelStats_t *stats = (index < 0) ? NULL : &devStats[index];
+
+	if (stats == NULL)
+	{
+		busStats.nacks++;
+	}
+	else
+	{
+		stats->transfers++;
+		stats->reads += read ? 1 : 0;
+		stats->bytes += bytes;
+		stats->bus_ns += ns;
+
+		busStats.transfers++;
+		busStats.reads += read ? 1 : 0;
+	}
+
+	busStats.bytes += bytes;
+	busStats.bus_ns += ns;
+
+	now_ns += ns;
+	I2CModel_Advance(0);
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void I2CModel_Init(void)
+{
+	numDevices = 0;
+	now_ns = 0;
+	memset(devStats, 0, sizeof(devStats));
+	memset(&busStats, 0, sizeof(busStats));
+}
+
+bool I2CModel_Attach(const I2CModelDevice_t *dev)
+{
+	if ((numDevices >= I2C_MODEL_MAX_DEVICES) || (Model_Find(dev->address) >= 0))
+	{
+		return false;
+	}
+
+	devices[numDevices] = dev;
+	memset(&devStats[numDevices], 0, sizeof(I2CModelStats_t));
+	numDevices++;
+
+	dev->reset();
+	dev->advance(now_ns / 1000ULL);
+
+	return true;
+}
+
+void I2CModel_Advance(uint64_t us)
+{
+	uint8_t i;
+
+	now_ns += us * 1000ULL;
+
+	for (i = 0; i < numDevices; i++)
+	{
+		devices[i]->advance(now_ns / 1000ULL);
+	}
+}
+
+uint64_t I2CModel_Now(void)
+{
+	return now_ns / 1000ULL;
+}
+
+void I2CModel_GetStats(uint8_t address, I2CModelStats_t *stats)
+{
+	int index;
+
+	if (address == 0)
+	{
+		*stats = busStats;
+		return;
+	}
+
+	index = Model_Find(address);
+	if (index < 0)
+	{
+		memset(stats, 0, sizeof(I2CModelStats_t));
+		return;
+	}
+
+	*stats = devStats[index];
+}
+
+void I2CModel_ResetStats(void)
+{
+	memset(devStats, 0, sizeof(devStats));
+	memset(&busStats, 0, sizeof(busStats));
+}
+
+void I2CModel_Trace(bool enable)
+{
+	trace = enable;
+}
+
+//==============================================================================
+// HAL / FREERTOS DO PC
+//==============================================================================
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	int index = Model_Find(DevAddress);
+	const I2CModelDevice_t *dev;
+	uint8_t reg;
+	bool inc;
+	uint16_t i;
+
+	if (index < 0)
+	{
+		/* So o endereco vai ao barramento antes do NACK */
+		Model_Bus(-1, false, 1, hi2c->clock_hz);
+		return HAL_ERROR;
+	}
+
+	dev = devices[index];
+	reg = dev->select((uint8_t) MemAddress, &inc);
+
+	for (i = 0; i < Size; i++)
+	{
+		if (trace)
+		{
+			DBG("%10llu us %s W %02X = %02X", (unsigned long long) I2CModel_Now(), dev->name, reg, pData[i]);
+		}
+
+		dev->write(reg, pData[i]);
+		reg = inc ? dev->next(reg) : reg;
+	}
+
+	Model_Bus(index, false, MODEL_WRITE_OVERHEAD + Size, hi2c->clock_hz);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	int index = Model_Find(DevAddress);
+	const I2CModelDevice_t *dev;
+	uint8_t reg;
+	bool inc;
+	uint16_t i;
+
+	if (index < 0)
+	{
+		Model_Bus(-1, true, 1, hi2c->clock_hz);
+		return HAL_ERROR;
+	}
+
+	dev = devices[index];
+	reg = dev->select((uint8_t) MemAddress, &inc);
+
+	for (i = 0; i < Size; i++)
+	{
+		pData[i] = dev->read(reg);
+
+		if (trace)
+		{
+			DBG("%10llu us %s R %02X = %02X", (unsigned long long) I2CModel_Now(), dev->name, reg, pData[i]);
+		}
+
+		reg = inc ? dev->next(reg) : reg;
+	}
+
+	Model_Bus(index, true, MODEL_READ_OVERHEAD + Size, hi2c->clock_hz);
+
+	return HAL_OK;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	I2CModel_Advance((uint64_t) Delay * 1000ULL);
+}
+
+void osDelay(uint32_t millisec)
+{
+	I2CModel_Advance((uint64_t) millisec * 1000ULL);
+}
+
+uint32_t HAL_GetTick(void)
+{
+	return (uint32_t) (I2CModel_Now() / 1000ULL);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+	return (TickType_t) (I2CModel_Now() / 1000ULL);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+	if (numSemaphores >= (sizeof(semaphores) / sizeof(semaphores[0])))
+	{
+		return NULL;
+	}
+
+	return &semaphores[numSemaphores++];
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
+{
+	/* Uma so task: um mutex ja tomado seria um deadlock no alvo */
+	if (xSemaphore->taken)
+	{
+		return pdFALSE;
+	}
+
+	xSemaphore->taken = 1;
+
+	return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+	xSemaphore->taken = 0;
+
+	return pdTRUE;
+}
+
+void vQueueAddToRegistry(SemaphoreHandle_t xQueue, const char *pcQueueName)
+{
+}
+
+//==============================================================================
+// TIMEBASE DO PC
+//==============================================================================
+
+void Timebase_Init(void)
+{
+}
+
+uint64_t Timebase_Cycles(void)
+{
+	return now_ns * (MODEL_CORE_HZ / 1000000UL) / 1000ULL;
+}
+
+uint64_t Timebase_Us(void)
+{
+	return I2CModel_Now();
+}
+
+uint64_t Timebase_CyclesToUs(uint64_t cycles)
+{
+	return cycles / (MODEL_CORE_HZ / 1000000UL);
+}
+
+uint32_t Timebase_Hz(void)
+{
+	return MODEL_CORE_HZ;
+}
+
+void Timebase_Update(void)
+{
+}
@@ -0,0 +1,141 @@
+/**
+ * @file    i2c_model.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Barramento I2C simulado para rodar os drivers dos sensores no PC
+ * @details
+ * Implementa HAL_I2C_Mem_Read/Write de host/setup_hw.h sobre uma tabela de
+ * dispositivos (um modelo de registradores por endereco) e um tempo
+ * simulado em us, o mesmo de osDelay, HAL_Delay e xTaskGetTickCount.
+ *
+ * Custo de uma transacao no clock de hi2c->clock_hz, 9 bits por byte (com
+ * o ACK) mais um bit por condicao de START, repeated START e STOP:
+ *
+ *   escrita: START, endereco, subendereco, dados, STOP   -> 2 + n bytes
+ *   leitura: START, endereco, subendereco, START,
+ *            endereco, dados, STOP                       -> 3 + n bytes
+ *
+ * O tempo avanca pela duracao de cada transacao, entao os modelos geram
+ * amostras durante as leituras como no CI. As amostras so mudam entre
+ * transacoes: uma leitura multipla sempre ve um conjunto coerente (o efeito
+ * do BDU). O tempo de CPU do driver nao e contado, so o do barramento.
+ *
+ * Um endereco sem modelo responde NACK (HAL_ERROR), contado a parte.
+ */
+
+#ifndef _I2C_MODEL_H_
+#define _I2C_MODEL_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Dispositivos no barramento */
+#define I2C_MODEL_MAX_DEVICES		8
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/**
+ * @brief Modelo de um CI. Os registradores ficam no modelo; o barramento
+ * so entrega bytes e pede o proximo endereco em leituras e escritas
+ * multiplas.
+ */
+typedef struct
+{
+	const char *name;
+	uint8_t address;                         /**< Endereco I2C (8 bits) */
+
+	/** Estado de fabrica (registradores e FIFO) */
+	void (*reset)(void);
+
+	/** Gera as amostras ate o instante now_us */
+	void (*advance)(uint64_t now_us);
+
+	/**
+	 * Subendereco recebido no inicio da transacao.
+	 * @param sub Byte enviado depois do endereco.
+	 * @param inc Saida: a transacao incrementa o endereco.
+	 * @return Primeiro registrador.
+	 */
+	uint8_t (*select)(uint8_t sub, bool *inc);
+
+	/** Proximo registrador de uma transacao com incremento */
+	uint8_t (*next)(uint8_t reg);
+
+	/** Le um registrador, com os efeitos da leitura (flags, FIFO) */
+	uint8_t (*read)(uint8_t reg);
+
+	/** Escreve um registrador, com os efeitos da escrita */
+	void (*write)(uint8_t reg, uint8_t value);
+} I2CModelDevice_t;
+
+/** @brief Contadores do barramento (total ou de um dispositivo) */
+typedef struct
+{
+	uint32_t transfers;     /**< Transacoes respondidas */
+	uint32_t reads;         /**< Das quais leituras */
+	uint32_t nacks;         /**< Transacoes sem dispositivo no endereco */
+	uint32_t bytes;         /**< Bytes no barramento, enderecos incluidos */
+	uint64_t bus_ns;        /**< Tempo de barramento ocupado */
+} I2CModelStats_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/** @brief Remove os dispositivos, zera os contadores e o tempo. */
+void I2CModel_Init(void);
+
+/**
+ * Liga um modelo ao barramento e o poe no estado de fabrica.
+ * @param dev Modelo (constante).
+ * @return false se o endereco ja existe ou a tabela esta cheia.
+ */
+bool I2CModel_Attach(const I2CModelDevice_t *dev);
+
+/**
+ * Avanca o tempo simulado, gerando as amostras dos modelos.
+ * @param us Microssegundos.
+ */
+void I2CModel_Advance(uint64_t us);
+
+/** @brief Tempo simulado em us. */
+uint64_t I2CModel_Now(void);
+
+/**
+ * Copia os contadores.
+ * @param address Endereco de um dispositivo ou 0 para o total.
+ * @param stats Saida.
+ */
+void I2CModel_GetStats(uint8_t address, I2CModelStats_t *stats);
+
+/** @brief Zera os contadores (o tempo continua). */
+void I2CModel_ResetStats(void);
+
+/**
+ * Registra cada transacao em stderr.
+ * @param enable true liga.
+ */
+void I2CModel_Trace(bool enable);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _I2C_MODEL_H_ */
@@ -0,0 +1,292 @@
+/**
+ * @file    lis3mdl_model.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelo dos registradores do LIS3MDL (magnetometro)
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "sensor_models.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define MODEL_ADDRESS			0x3C
+
+#define REG_WHO_AM_I			0x0F
+#define REG_CTRL1				0x20
+#define REG_CTRL2				0x21
+#define REG_CTRL3				0x22
+#define REG_CTRL4				0x23
+#define REG_CTRL5				0x24
+#define REG_STATUS				0x27
+#define REG_OUTX_L				0x28
+#define REG_OUTZ_H				0x2D
+#define REG_INT_CFG				0x30
+#define REG_INT_THS_H			0x33
+
+#define CTRL1_OM_XY				0x60
+#define CTRL1_DO				0x1C
+#define CTRL1_FAST_ODR			0x02
+#define CTRL2_REBOOT			0x08
+#define CTRL2_SOFT_RST			0x04
+#define CTRL3_LP				0x20
+#define CTRL3_MD				0x03
+
+#define MD_CONTINUOUS			0
+#define MD_SINGLE				1
+#define MD_IDLE					3
+
+#define STATUS_ZYXOR			0x80
+#define STATUS_ZYXDA			0x08
+#define STATUS_XYZDA			0x07
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static uint8_t regs[128];
+
+static float truth[3] = { 200.0f, -50.0f, 400.0f };
+
+static uint64_t nextSampleNs;
+static uint64_t singleDone;
+static bool singlePending;
+static uint32_t samples;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Periodo do modo continuo em ns (0 sem conversao continua). */
+static uint64_t Model_PeriodNs(void);
+
+/** @brief Duracao de uma conversao unica: 1/FAST_ODR do modo dos eixos. */
+static uint32_t Model_SingleUs(void);
+
+/** @brief Grava uma conversao nas saidas e liga ZYXDA. */
+static void Model_Sample(void);
+
+/** @brief Registradores de fabrica. */
+static void Model_Registers(void);
+
+static void Model_Reset(void);
+static void Model_Advance(uint64_t now_us);
+static uint8_t Model_Select(uint8_t sub, bool *inc);
+static uint8_t Model_Next(uint8_t reg);
+static uint8_t Model_Read(uint8_t reg);
+static void Model_Write(uint8_t reg, uint8_t value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint64_t Model_PeriodNs(void)
+{
+	static const uint64_t do_ns[8] = { 1600000000ULL, 800000000ULL, 400000000ULL, 200000000ULL,
+			100000000ULL, 50000000ULL, 25000000ULL, 12500000ULL };
+	static const uint64_t fast_ns[4] = { 1000000ULL, 1785714ULL, 3333333ULL, 6451613ULL };
+
+	if ((regs[REG_CTRL3] & CTRL3_MD) != MD_CONTINUOUS)
+	{
+		return 0;
+	}
+
+	/* LP fixa 0.625 Hz qualquer que seja o DO */
+	if (regs[REG_CTRL3] & CTRL3_LP)
+	{
+		return do_ns[0];
+	}
+
+	if (regs[REG_CTRL1] & CTRL1_FAST_ODR)
+	{
+		return fast_ns[(regs[REG_CTRL1] & CTRL1_OM_XY) >> 5];
+	}
+
+	return do_ns[(regs[REG_CTRL1] & CTRL1_DO) >> 2];
+}
+
+static uint32_t Model_SingleUs(void)
+{
+	static const uint32_t single_us[4] = { 1000, 1786, 3333, 6452 };
+
+	return single_us[(regs[REG_CTRL1] & CTRL1_OM_XY) >> 5];
+}
+
+static void Model_Sample(void)
+{
+	/* Sensibilidade por FS[1:0] em ugauss/LSB (a mesma do driver) */
+	static const float ug_lsb[4] = { 140.0f, 290.0f, 430.0f, 580.0f };
+	float sens = ug_lsb[(regs[REG_CTRL2] >> 5) & 0x03];
+	float raw;
+	uint8_t i;
+
+	for (i = 0; i < 3; i++)
+	{
+		raw = roundf(truth[i] * 1000.0f / sens);
+		raw = (raw > 32767.0f) ? 32767.0f : ((raw < -32768.0f) ? -32768.0f : raw);
+
+		regs[REG_OUTX_L + 2 * i] = (uint8_t) (int16_t) raw;
+		regs[REG_OUTX_L + 2 * i + 1] = (uint8_t) ((uint16_t) (int16_t) raw >> 8);
+	}
+
+	if (regs[REG_STATUS] & STATUS_ZYXDA)
+	{
+		regs[REG_STATUS] |= STATUS_ZYXOR | (STATUS_XYZDA << 4);
+	}
+
+	regs[REG_STATUS] |= STATUS_ZYXDA | STATUS_XYZDA;
+	samples++;
+}
+
+static void Model_Registers(void)
+{
+	memset(regs, 0, sizeof(regs));
+	regs[REG_WHO_AM_I] = 0x3D;
+	regs[REG_CTRL1] = 0x10;
+	regs[REG_CTRL3] = 0x03;
+	regs[REG_INT_CFG] = 0xE8;
+
+	singlePending = false;
+}
+
+static void Model_Reset(void)
+{
+	Model_Registers();
+	nextSampleNs = 0;
+	samples = 0;
+}
+
+static void Model_Advance(uint64_t now_us)
+{
+	uint64_t period = Model_PeriodNs();
+	uint64_t now_ns = now_us * 1000ULL;
+
+	/* Conversao unica: depois dela o CI volta sozinho para idle */
+	if (singlePending && (now_us >= singleDone))
+	{
+		singlePending = false;
+		regs[REG_CTRL3] = (uint8_t) ((regs[REG_CTRL3] & ~CTRL3_MD) | MD_IDLE);
+		Model_Sample();
+	}
+
+	if (period == 0)
+	{
+		return;
+	}
+
+	while (nextSampleNs <= now_ns)
+	{
+		Model_Sample();
+		nextSampleNs += period;
+	}
+}
+
+static uint8_t Model_Select(uint8_t sub, bool *inc)
+{
+	/* Bit 7 do subendereco pede o incremento */
+	*inc = (sub & 0x80) != 0;
+
+	return sub & 0x7F;
+}
+
+static uint8_t Model_Next(uint8_t reg)
+{
+	return (reg + 1) & 0x7F;
+}
+
+static uint8_t Model_Read(uint8_t reg)
+{
+	uint8_t value = regs[reg & 0x7F];
+
+	/* O ultimo byte do conjunto libera o dado novo */
+	if (reg == REG_OUTZ_H)
+	{
+		regs[REG_STATUS] = 0;
+	}
+
+	return value;
+}
+
+static void Model_Write(uint8_t reg, uint8_t value)
+{
+	switch (reg)
+	{
+	case REG_CTRL1:
+	case REG_CTRL4:
+	case REG_CTRL5:
+		regs[reg] = value;
+
+		/* Novo ODR: a primeira conversao continua sai um periodo depois */
+		nextSampleNs = I2CModel_Now() * 1000ULL + Model_PeriodNs();
+		break;
+
+	case REG_CTRL2:
+		if (value & CTRL2_SOFT_RST)
+		{
+			Model_Registers();
+			break;
+		}
+
+		regs[reg] = value & 0x60;
+		break;
+
+	case REG_CTRL3:
+		regs[reg] = value & 0x27;
+
+		if (((value & CTRL3_MD) == MD_SINGLE) && (singlePending == false))
+		{
+			singlePending = true;
+			singleDone = I2CModel_Now() + Model_SingleUs();
+		}
+		else if ((value & CTRL3_MD) != MD_SINGLE)
+		{
+			singlePending = false;
+		}
+
+		nextSampleNs = I2CModel_Now() * 1000ULL + Model_PeriodNs();
+		break;
+
+	default:
+		/* INT_CFG, INT_SRC e INT_THS so armazenados */
+		if ((reg >= REG_INT_CFG) && (reg <= REG_INT_THS_H) && (reg != REG_INT_CFG + 1))
+		{
+			regs[reg] = value;
+		}
+		break;
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+const I2CModelDevice_t LIS3MDL_Model =
+{
+	.name = "LIS3MDL",
+	.address = MODEL_ADDRESS,
+	.reset = Model_Reset,
+	.advance = Model_Advance,
+	.select = Model_Select,
+	.next = Model_Next,
+	.read = Model_Read,
+	.write = Model_Write,
+};
+
+void LIS3MDL_Model_Set(const float mgauss[3])
+{
+	memcpy(truth, mgauss, sizeof(truth));
+}
+
+uint32_t LIS3MDL_Model_Samples(void)
+{
+	return samples;
+}
@@ -0,0 +1,454 @@
+/**
+ * @file    lps22hb_model.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelo dos registradores do LPS22HB (pressao e temperatura) com FIFO
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "sensor_models.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define MODEL_ADDRESS			0xBA
+
+#define REG_WHO_AM_I			0x0F
+#define REG_CTRL1				0x10
+#define REG_CTRL2				0x11
+#define REG_CTRL3				0x12
+#define REG_FIFO_CTRL			0x14
+#define REG_RES_CONF			0x1A
+#define REG_FIFO_STATUS			0x26
+#define REG_STATUS				0x27
+#define REG_PRESS_OUT_XL		0x28
+#define REG_PRESS_OUT_H			0x2A
+#define REG_TEMP_OUT_H			0x2C
+#define REG_LPFP_RES			0x33
+
+#define CTRL1_ODR				0x70
+#define CTRL1_EN_LPFP			0x08
+#define CTRL1_LPFP_CFG			0x04
+
+#define CTRL2_BOOT				0x80
+#define CTRL2_FIFO_EN			0x40
+#define CTRL2_STOP_ON_FTH		0x20
+#define CTRL2_IF_ADD_INC		0x10
+#define CTRL2_SWRESET			0x04
+#define CTRL2_ONE_SHOT			0x01
+
+#define CTRL3_INT_H_L			0x80
+#define CTRL3_F_FSS5			0x20
+#define CTRL3_F_FTH				0x10
+#define CTRL3_F_OVR				0x08
+#define CTRL3_DRDY				0x04
+
+#define FIFO_MODE_BYPASS		0
+#define FIFO_MODE_FIFO			1
+
+#define FIFO_STATUS_FTH			0x80
+#define FIFO_STATUS_OVR			0x40
+
+#define STATUS_P_DA				0x01
+#define STATUS_T_DA				0x02
+#define STATUS_P_OR				0x10
+#define STATUS_T_OR				0x20
+
+#define FIFO_SLOTS				32
+#define SLOT_BYTES				5
+
+#define MODEL_PI				3.14159265f
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static uint8_t regs[128];
+
+/* Saida atual (PRESS_OUT_XL..TEMP_OUT_H) e o FIFO de posicoes de 5 bytes */
+static uint8_t fifo[FIFO_SLOTS][SLOT_BYTES];
+static uint8_t fifoHead;
+static uint8_t fifoLevel;
+static bool fifoOverrun;
+static SensorModelFifo_t fifoStats;
+
+static float truthPressure = 1013.25f;
+static float truthTemp = 25.0f;
+static float lpf;
+static bool lpfStarted;
+
+static uint64_t nextSampleNs;
+static uint64_t oneShotDone;
+static bool oneShotPending;
+static uint32_t conversionUs = LPS22HB_MODEL_CONVERSION_US;
+static uint32_t samples;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Periodo do modo continuo em ns (0 = ODR 000, conversao unica). */
+static uint64_t Model_PeriodNs(void);
+
+/** @brief O FIFO guarda amostras (FIFO_EN e modo diferente de bypass). */
+static bool Model_FifoActive(void);
+
+/** @brief Profundidade do FIFO: o watermark com STOP_ON_FTH, 32 sem. */
+static uint8_t Model_FifoDepth(void);
+
+/**
+ * Grava uma conversao nas saidas e no FIFO.
+ * @param filtered Passa pelo LPF (modo continuo).
+ */
+static void Model_Sample(bool filtered);
+
+/** @brief Registradores de fabrica. */
+static void Model_Registers(void);
+
+static void Model_Reset(void);
+static void Model_Advance(uint64_t now_us);
+static uint8_t Model_Select(uint8_t sub, bool *inc);
+static uint8_t Model_Next(uint8_t reg);
+static uint8_t Model_Read(uint8_t reg);
+static void Model_Write(uint8_t reg, uint8_t value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint64_t Model_PeriodNs(void)
+{
+	static const uint64_t period_ns[] = { 0, 1000000000ULL, 100000000ULL, 40000000ULL, 20000000ULL, 13333333ULL, 0, 0 };
+
+	return period_ns[(regs[REG_CTRL1] & CTRL1_ODR) >> 4];
+}
+
+static bool Model_FifoActive(void)
+{
+	return ((regs[REG_CTRL2] & CTRL2_FIFO_EN) != 0) && ((regs[REG_FIFO_CTRL] >> 5) != FIFO_MODE_BYPASS);
+}
+
+static uint8_t Model_FifoDepth(void)
+{
+	uint8_t wtm = regs[REG_FIFO_CTRL] & 0x1F;
+
+	return ((regs[REG_CTRL2] & CTRL2_STOP_ON_FTH) && (wtm > 0)) ? wtm : FIFO_SLOTS;
+}
+
+static void Model_Sample(bool filtered)
+{
+	float p = truthPressure;
+	float alpha;
+	int32_t press;
+	int16_t temp;
+	uint8_t *slot;
+
+	/* LPF de um polo com banda ODR/9 ou ODR/20 */
+	if (filtered && (regs[REG_CTRL1] & CTRL1_EN_LPFP))
+	{
+		alpha = 1.0f - expf(-2.0f * MODEL_PI / ((regs[REG_CTRL1] & CTRL1_LPFP_CFG) ? 20.0f : 9.0f));
+		lpf = lpfStarted ? (lpf + alpha * (p - lpf)) : p;
+		lpfStarted = true;
+		p = lpf;
+	}
+
+	press = (int32_t) lrintf(p * 4096.0f);
+	temp = (int16_t) lrintf(truthTemp * 100.0f);
+
+	if (regs[REG_STATUS] & STATUS_P_DA)
+	{
+		regs[REG_STATUS] |= STATUS_P_OR;
+	}
+	if (regs[REG_STATUS] & STATUS_T_DA)
+	{
+		regs[REG_STATUS] |= STATUS_T_OR;
+	}
+
+	regs[0x28] = (uint8_t) press;
+	regs[0x29] = (uint8_t) (press >> 8);
+	regs[0x2A] = (uint8_t) (press >> 16);
+	regs[0x2B] = (uint8_t) temp;
+	regs[0x2C] = (uint8_t) ((uint16_t) temp >> 8);
+	regs[REG_STATUS] |= STATUS_P_DA | STATUS_T_DA;
+	samples++;
+
+	if (Model_FifoActive() == false)
+	{
+		return;
+	}
+
+	if (fifoLevel >= Model_FifoDepth())
+	{
+		fifoStats.dropped++;
+
+		/* Modo FIFO para de gravar; stream sobrescreve a mais antiga */
+		if ((regs[REG_FIFO_CTRL] >> 5) == FIFO_MODE_FIFO)
+		{
+			return;
+		}
+
+		fifoHead = (fifoHead + 1) % FIFO_SLOTS;
+		fifoLevel--;
+		fifoOverrun = true;
+	}
+
+	slot = fifo[(fifoHead + fifoLevel) % FIFO_SLOTS];
+	memcpy(slot, &regs[REG_PRESS_OUT_XL], SLOT_BYTES);
+	fifoLevel++;
+	fifoStats.written++;
+	fifoStats.peak = (fifoLevel > fifoStats.peak) ? fifoLevel : fifoStats.peak;
+}
+
+static void Model_Registers(void)
+{
+	memset(regs, 0, sizeof(regs));
+	regs[REG_WHO_AM_I] = 0xB1;
+	regs[REG_CTRL2] = CTRL2_IF_ADD_INC;
+
+	fifoHead = 0;
+	fifoLevel = 0;
+	fifoOverrun = false;
+	lpfStarted = false;
+	oneShotPending = false;
+}
+
+static void Model_Reset(void)
+{
+	Model_Registers();
+	memset(&fifoStats, 0, sizeof(fifoStats));
+	nextSampleNs = 0;
+	samples = 0;
+}
+
+static void Model_Advance(uint64_t now_us)
+{
+	uint64_t period = Model_PeriodNs();
+	uint64_t now_ns = now_us * 1000ULL;
+
+	if (oneShotPending && (now_us >= oneShotDone))
+	{
+		oneShotPending = false;
+		regs[REG_CTRL2] &= ~CTRL2_ONE_SHOT;
+		Model_Sample(false);
+	}
+
+	if (period == 0)
+	{
+		return;
+	}
+
+	while (nextSampleNs <= now_ns)
+	{
+		Model_Sample(true);
+		nextSampleNs += period;
+	}
+}
+
+static uint8_t Model_Select(uint8_t sub, bool *inc)
+{
+	*inc = (regs[REG_CTRL2] & CTRL2_IF_ADD_INC) != 0;
+
+	return sub & 0x7F;
+}
+
+static uint8_t Model_Next(uint8_t reg)
+{
+	/* Com FIFO_EN o endereco volta de TEMP_OUT_H para PRESS_OUT_XL */
+	if ((reg == REG_TEMP_OUT_H) && (regs[REG_CTRL2] & CTRL2_FIFO_EN))
+	{
+		return REG_PRESS_OUT_XL;
+	}
+
+	return (reg + 1) & 0x7F;
+}
+
+static uint8_t Model_Read(uint8_t reg)
+{
+	uint8_t wtm = regs[REG_FIFO_CTRL] & 0x1F;
+	uint8_t value;
+
+	reg &= 0x7F;
+
+	switch (reg)
+	{
+	case REG_FIFO_STATUS:
+		value = fifoLevel & 0x3F;
+		value |= fifoOverrun ? FIFO_STATUS_OVR : 0;
+		value |= ((wtm > 0) && (fifoLevel >= wtm)) ? FIFO_STATUS_FTH : 0;
+		return value;
+
+	case REG_LPFP_RES:
+		/* Ler LPFP_RES reinicia o filtro */
+		lpfStarted = false;
+		return 0;
+
+	default:
+		break;
+	}
+
+	if ((reg < REG_PRESS_OUT_XL) || (reg > REG_TEMP_OUT_H))
+	{
+		return regs[reg];
+	}
+
+	/* Saidas: com o FIFO ativo e nao vazio, a posicao mais antiga */
+	if (Model_FifoActive() && (fifoLevel > 0))
+	{
+		value = fifo[fifoHead][reg - REG_PRESS_OUT_XL];
+
+		if (reg == REG_TEMP_OUT_H)
+		{
+			fifoHead = (fifoHead + 1) % FIFO_SLOTS;
+			fifoLevel--;
+			fifoOverrun = false;
+		}
+	}
+	else
+	{
+		value = regs[reg];
+	}
+
+	if (reg == REG_PRESS_OUT_H)
+	{
+		regs[REG_STATUS] &= ~(STATUS_P_DA | STATUS_P_OR);
+	}
+	else if (reg == REG_TEMP_OUT_H)
+	{
+		regs[REG_STATUS] &= ~(STATUS_T_DA | STATUS_T_OR);
+	}
+
+	return value;
+}
+
+static void Model_Write(uint8_t reg, uint8_t value)
+{
+	switch (reg)
+	{
+	case REG_CTRL1:
+		regs[reg] = value & 0x7F;
+
+		/* Novo ODR: a primeira conversao continua sai um periodo depois */
+		nextSampleNs = I2CModel_Now() * 1000ULL + Model_PeriodNs();
+		break;
+
+	case REG_CTRL2:
+		if (value & CTRL2_SWRESET)
+		{
+			Model_Registers();
+			break;
+		}
+
+		regs[reg] = value & 0xF9;
+		regs[reg] &= ~CTRL2_BOOT;
+
+		if ((regs[reg] & CTRL2_FIFO_EN) == 0)
+		{
+			fifoLevel = 0;
+			fifoOverrun = false;
+		}
+
+		/* Conversao unica so com ODR = 000 */
+		if ((value & CTRL2_ONE_SHOT) && (oneShotPending == false))
+		{
+			if (Model_PeriodNs() == 0)
+			{
+				oneShotPending = true;
+				oneShotDone = I2CModel_Now() + conversionUs;
+			}
+			else
+			{
+				regs[reg] &= ~CTRL2_ONE_SHOT;
+			}
+		}
+		break;
+
+	case REG_FIFO_CTRL:
+		regs[reg] = value;
+
+		/* Bypass esvazia o FIFO */
+		if ((value >> 5) == FIFO_MODE_BYPASS)
+		{
+			fifoLevel = 0;
+			fifoOverrun = false;
+		}
+		break;
+
+	case REG_CTRL3:
+	case REG_RES_CONF:
+	case 0x0B: /* INT_CFG */
+	case 0x0C: /* THS_P_L */
+	case 0x0D: /* THS_P_H */
+	case 0x15: /* REF_P_XL */
+	case 0x16: /* REF_P_L */
+	case 0x17: /* REF_P_H */
+	case 0x18: /* RPDS_L */
+	case 0x19: /* RPDS_H */
+		regs[reg] = value;
+		break;
+
+	default:
+		/* WHO_AM_I, status e saidas sao so de leitura */
+		break;
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+const I2CModelDevice_t LPS22HB_Model =
+{
+	.name = "LPS22HB",
+	.address = MODEL_ADDRESS,
+	.reset = Model_Reset,
+	.advance = Model_Advance,
+	.select = Model_Select,
+	.next = Model_Next,
+	.read = Model_Read,
+	.write = Model_Write,
+};
+
+void LPS22HB_Model_Set(float p_hpa, float temp_c)
+{
+	truthPressure = p_hpa;
+	truthTemp = temp_c;
+}
+
+uint32_t LPS22HB_Model_Samples(void)
+{
+	return samples;
+}
+
+void LPS22HB_Model_SetConversion(uint32_t us)
+{
+	conversionUs = us;
+}
+
+bool LPS22HB_Model_Int(void)
+{
+	uint8_t ctrl3 = regs[REG_CTRL3];
+	uint8_t wtm = regs[REG_FIFO_CTRL] & 0x1F;
+	bool level = false;
+
+	level |= (ctrl3 & CTRL3_F_FTH) && (wtm > 0) && (fifoLevel >= wtm);
+	level |= (ctrl3 & CTRL3_F_OVR) && fifoOverrun;
+	level |= (ctrl3 & CTRL3_F_FSS5) && (fifoLevel >= FIFO_SLOTS);
+	level |= (ctrl3 & CTRL3_DRDY) && (regs[REG_STATUS] & STATUS_P_DA);
+
+	/* INT_H_L: ativo em baixo */
+	return (ctrl3 & CTRL3_INT_H_L) ? !level : level;
+}
+
+void LPS22HB_Model_GetFifo(SensorModelFifo_t *fifoOut)
+{
+	*fifoOut = fifoStats;
+	fifoOut->level = fifoLevel;
+}
@@ -0,0 +1,625 @@
+/**
+ * @file    lsm6dsl_model.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelo dos registradores do LSM6DSL (acelerometro e giroscopio) com FIFO
+ * @details
+ * O FIFO guarda palavras de 16 bits na ordem do CI: o data set do
+ * giroscopio e depois o do acelerometro, cada um X, Y, Z, no ODR_FIFO de
+ * FIFO_CTRL5. Um codigo de decimacao diferente de zero em FIFO_CTRL3 so liga
+ * o data set (sem decimar), que e o que o driver usa. Com o ODR_FIFO igual
+ * ao ODR do sensor o FIFO grava na mesma fase das amostras.
+ *
+ * O timestamp (TIMER_EN, LSB de 25 us com TIMER_HR) conta no relogio do CI,
+ * que pode andar fora do tempo do barramento (LSM6DSL_Model_SetClock).
+ * Com TIMER_PEDO_FIFO_EN e DEC_DS4 o quarto data set vai ao FIFO depois do
+ * acelerometro, e o instante real de cada data set fica guardado para o
+ * bench conferir os carimbos do driver.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "sensor_models.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define MODEL_ADDRESS			0xD4
+
+#define REG_FUNC_CFG_ACCESS		0x01
+#define REG_FIFO_CTRL1			0x06
+#define REG_FIFO_CTRL2			0x07
+#define REG_FIFO_CTRL3			0x08
+#define REG_FIFO_CTRL4			0x09
+#define REG_FIFO_CTRL5			0x0A
+#define REG_WHO_AM_I			0x0F
+#define REG_CTRL1_XL			0x10
+#define REG_CTRL2_G				0x11
+#define REG_CTRL3_C				0x12
+#define REG_CTRL10_C			0x19
+#define REG_STATUS				0x1E
+#define REG_OUT_TEMP_H			0x21
+#define REG_OUTX_L_G			0x22
+#define REG_OUTZ_H_G			0x27
+#define REG_OUTX_L_XL			0x28
+#define REG_OUTZ_H_XL			0x2D
+#define REG_FIFO_STATUS1		0x3A
+#define REG_FIFO_STATUS2		0x3B
+#define REG_FIFO_STATUS3		0x3C
+#define REG_FIFO_STATUS4		0x3D
+#define REG_FIFO_DATA_OUT_L		0x3E
+#define REG_FIFO_DATA_OUT_H		0x3F
+#define REG_TIMESTAMP0			0x40
+#define REG_TIMESTAMP1			0x41
+#define REG_TIMESTAMP2			0x42
+#define REG_WAKE_UP_DUR			0x5C
+
+#define FUNC_CFG_EN				0x80
+
+#define CTRL3_IF_INC			0x04
+#define CTRL3_SW_RESET			0x01
+
+#define CTRL10_TIMER_EN			0x20
+#define WAKE_UP_DUR_TIMER_HR	0x10
+#define FIFO_CTRL2_TIMER_PEDO	0x80
+
+/** @brief Escrita em TIMESTAMP2 que zera o contador */
+#define TIMESTAMP_RESET			0xAA
+
+/** @brief LSB do timestamp com e sem TIMER_HR */
+#define TIMESTAMP_HR_NS			25000ULL
+#define TIMESTAMP_LR_NS			6400000ULL
+
+#define STATUS_XLDA				0x01
+#define STATUS_GDA				0x02
+#define STATUS_TDA				0x04
+
+#define FIFO_MODE_BYPASS		0
+#define FIFO_MODE_FIFO			1
+
+#define FIFO_STATUS2_WTM		0x80
+#define FIFO_STATUS2_OVER_RUN	0x40
+#define FIFO_STATUS2_FULL_SMART	0x20
+#define FIFO_STATUS2_EMPTY		0x10
+
+/** @brief 4 kB de FIFO */
+#define FIFO_WORDS				2048
+
+/** @brief Instantes reais guardados (data sets) */
+#define FIFO_TIMES				4096
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Um sensor (acelerometro ou giroscopio) */
+typedef struct
+{
+	uint8_t ctrl;           /**< CTRL1_XL ou CTRL2_G */
+	uint8_t out;            /**< OUTX_L do sensor */
+	uint8_t flag;           /**< Bit de dado novo no STATUS_REG */
+	uint64_t next_ns;       /**< Proxima amostra */
+	float truth[3];
+} ModelSensor_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static uint8_t regs[128];
+static uint8_t bankA[128];
+
+static ModelSensor_t acc = { REG_CTRL1_XL, REG_OUTX_L_XL, STATUS_XLDA, 0, { 0.0f, 0.0f, 1000.0f } };
+static ModelSensor_t gyro = { REG_CTRL2_G, REG_OUTX_L_G, STATUS_GDA, 0, { 0.0f, 0.0f, 0.0f } };
+
+static uint16_t fifo[FIFO_WORDS];
+static uint16_t fifoHead;
+static uint16_t fifoCount;
+static uint16_t fifoPattern;
+static bool fifoOverrun;
+static uint64_t fifoNextNs;
+static SensorModelFifo_t fifoStats;
+static uint64_t fifoTimeNs[FIFO_TIMES];
+
+/* Relogio do timestamp: origem no ultimo reset e erro em ppm */
+static uint64_t tsOriginNs;
+static double tsPpm;
+static uint32_t tsLatch;
+
+static uint32_t samples;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Periodo de um codigo de ODR (CTRL1_XL, CTRL2_G e ODR_FIFO).
+ * @param code ODR[3:0].
+ * @return Periodo em ns, 0 desligado.
+ */
+static uint64_t Model_PeriodNs(uint8_t code);
+
+/** @brief Grava uma amostra do sensor nas saidas. */
+static void Model_Sample(ModelSensor_t *s);
+
+/** @brief Palavras por data set do FIFO (3 por sensor ligado e 3 do timestamp). */
+static uint16_t Model_SetWords(void);
+
+/** @brief O quarto data set (timestamp e passos) esta no FIFO. */
+static bool Model_Ds4(void);
+
+/**
+ * Valor do contador de timestamp.
+ * @param now_ns Tempo do barramento.
+ * @return 24 bits, 0 com TIMER_EN desligado.
+ */
+static uint32_t Model_Timestamp(uint64_t now_ns);
+
+/**
+ * Grava um data set no FIFO.
+ * @param t_ns Instante da gravacao.
+ */
+static void Model_FifoWrite(uint64_t t_ns);
+
+/** @brief Esvazia o FIFO (bypass, reset). */
+static void Model_FifoClear(void);
+
+/** @brief Reinicia o relogio do FIFO, na fase do sensor de mesmo ODR. */
+static void Model_FifoRestart(void);
+
+/** @brief Registradores de fabrica. */
+static void Model_Registers(void);
+
+/** @brief Registradores que nao aceitam escrita. */
+static bool Model_ReadOnly(uint8_t reg);
+
+static void Model_Reset(void);
+static void Model_Advance(uint64_t now_us);
+static uint8_t Model_Select(uint8_t sub, bool *inc);
+static uint8_t Model_Next(uint8_t reg);
+static uint8_t Model_Read(uint8_t reg);
+static void Model_Write(uint8_t reg, uint8_t value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static uint64_t Model_PeriodNs(uint8_t code)
+{
+	static const uint64_t period_ns[16] = { 0, 80000000ULL, 38461538ULL, 19230769ULL, 9615385ULL, 4807692ULL,
+			2403846ULL, 1200480ULL, 602410ULL, 300300ULL, 150150ULL, 625000000ULL, 0, 0, 0, 0 };
+
+	return period_ns[code & 0x0F];
+}
+
+static void Model_Sample(ModelSensor_t *s)
+{
+	/* Sensibilidade por FS[1:0]: ug/LSB no acelerometro, 0.01 mdps/LSB no giroscopio */
+	static const float acc_ug[4] = { 61.0f, 488.0f, 122.0f, 244.0f };
+	static const float gyro_cdps[4] = { 875.0f, 1750.0f, 3500.0f, 7000.0f };
+	uint8_t fs = (regs[s->ctrl] >> 2) & 0x03;
+	float raw;
+	uint8_t i;
+
+	for (i = 0; i < 3; i++)
+	{
+		raw = (s == &acc) ? (s->truth[i] * 1000.0f / acc_ug[fs]) : (s->truth[i] * 100.0f / gyro_cdps[fs]);
+		raw = roundf(raw);
+		raw = (raw > 32767.0f) ? 32767.0f : ((raw < -32768.0f) ? -32768.0f : raw);
+
+		regs[s->out + 2 * i] = (uint8_t) (int16_t) raw;
+		regs[s->out + 2 * i + 1] = (uint8_t) ((uint16_t) (int16_t) raw >> 8);
+	}
+
+	regs[REG_STATUS] |= s->flag;
+
+	if (s == &acc)
+	{
+		samples++;
+	}
+}
+
+static uint16_t Model_SetWords(void)
+{
+	uint8_t ctrl3 = regs[REG_FIFO_CTRL3];
+
+	return (uint16_t) ((((ctrl3 >> 3) & 0x07) ? 3 : 0) + ((ctrl3 & 0x07) ? 3 : 0) + (Model_Ds4() ? 3 : 0));
+}
+
+static bool Model_Ds4(void)
+{
+	return ((regs[REG_FIFO_CTRL2] & FIFO_CTRL2_TIMER_PEDO) != 0) && (((regs[REG_FIFO_CTRL4] >> 3) & 0x07) != 0);
+}
+
+static uint32_t Model_Timestamp(uint64_t now_ns)
+{
+	uint64_t lsb = (regs[REG_WAKE_UP_DUR] & WAKE_UP_DUR_TIMER_HR) ? TIMESTAMP_HR_NS : TIMESTAMP_LR_NS;
+	double chip_ns;
+
+	if ((regs[REG_CTRL10_C] & CTRL10_TIMER_EN) == 0)
+	{
+		return 0;
+	}
+
+	chip_ns = (double) (now_ns - tsOriginNs) * (1.0 + tsPpm * 1e-6);
+
+	return (uint32_t) ((uint64_t) (chip_ns / (double) lsb) & 0xFFFFFF);
+}
+
+static void Model_FifoWrite(uint64_t t_ns)
+{
+	uint16_t words = Model_SetWords();
+	uint8_t ctrl3 = regs[REG_FIFO_CTRL3];
+	uint32_t ts;
+	uint16_t i, tail;
+
+	if (words == 0)
+	{
+		return;
+	}
+
+	if ((fifoCount + words) > FIFO_WORDS)
+	{
+		fifoStats.dropped++;
+
+		/* Modo FIFO para de gravar; continuo descarta o data set mais antigo */
+		if ((regs[REG_FIFO_CTRL5] & 0x07) == FIFO_MODE_FIFO)
+		{
+			return;
+		}
+
+		fifoHead = (fifoHead + words) % FIFO_WORDS;
+		fifoCount -= words;
+		fifoOverrun = true;
+	}
+
+	tail = (fifoHead + fifoCount) % FIFO_WORDS;
+
+	/* Giroscopio primeiro, depois o acelerometro */
+	for (i = 0; i < 3; i++)
+	{
+		if ((ctrl3 >> 3) & 0x07)
+		{
+			fifo[tail] = (uint16_t) (regs[REG_OUTX_L_G + 2 * i] | (regs[REG_OUTX_L_G + 2 * i + 1] << 8));
+			tail = (tail + 1) % FIFO_WORDS;
+		}
+	}
+	for (i = 0; i < 3; i++)
+	{
+		if (ctrl3 & 0x07)
+		{
+			fifo[tail] = (uint16_t) (regs[REG_OUTX_L_XL + 2 * i] | (regs[REG_OUTX_L_XL + 2 * i + 1] << 8));
+			tail = (tail + 1) % FIFO_WORDS;
+		}
+	}
+
+	/* Quarto data set: TS[15:8] | TS[23:16], -- | TS[7:0], passos (sempre 0) */
+	if (Model_Ds4())
+	{
+		ts = Model_Timestamp(t_ns);
+		fifo[tail] = (uint16_t) (((ts >> 8) & 0xFF) | (((ts >> 16) & 0xFF) << 8));
+		tail = (tail + 1) % FIFO_WORDS;
+		fifo[tail] = (uint16_t) ((ts & 0xFF) << 8);
+		tail = (tail + 1) % FIFO_WORDS;
+		fifo[tail] = 0;
+	}
+
+	fifoTimeNs[fifoStats.written % FIFO_TIMES] = t_ns;
+	fifoCount += words;
+	fifoStats.written++;
+	fifoStats.peak = ((fifoCount / words) > fifoStats.peak) ? (fifoCount / words) : fifoStats.peak;
+}
+
+static void Model_FifoClear(void)
+{
+	fifoHead = 0;
+	fifoCount = 0;
+	fifoPattern = 0;
+	fifoOverrun = false;
+}
+
+static void Model_FifoRestart(void)
+{
+	uint8_t code = (regs[REG_FIFO_CTRL5] >> 3) & 0x0F;
+	uint64_t now_ns = I2CModel_Now() * 1000ULL;
+
+	if (code == (regs[REG_CTRL1_XL] >> 4))
+	{
+		fifoNextNs = acc.next_ns;
+	}
+	else if (code == (regs[REG_CTRL2_G] >> 4))
+	{
+		fifoNextNs = gyro.next_ns;
+	}
+	else
+	{
+		fifoNextNs = now_ns + Model_PeriodNs(code);
+	}
+}
+
+static void Model_Registers(void)
+{
+	memset(regs, 0, sizeof(regs));
+	memset(bankA, 0, sizeof(bankA));
+	regs[REG_WHO_AM_I] = 0x6A;
+	regs[REG_CTRL3_C] = CTRL3_IF_INC;
+
+	Model_FifoClear();
+}
+
+static bool Model_ReadOnly(uint8_t reg)
+{
+	return (reg == REG_WHO_AM_I) || ((reg >= 0x1B) && (reg <= 0x1E)) || ((reg >= 0x20) && (reg <= 0x42)) ||
+			((reg >= 0x49) && (reg <= 0x4C)) || ((reg >= 0x53) && (reg <= 0x55));
+}
+
+static void Model_Reset(void)
+{
+	Model_Registers();
+	memset(&fifoStats, 0, sizeof(fifoStats));
+	acc.next_ns = 0;
+	gyro.next_ns = 0;
+	samples = 0;
+	tsOriginNs = 0;
+}
+
+static void Model_Advance(uint64_t now_us)
+{
+	uint64_t now_ns = now_us * 1000ULL;
+	uint64_t acc_period = Model_PeriodNs(regs[REG_CTRL1_XL] >> 4);
+	uint64_t gyro_period = Model_PeriodNs(regs[REG_CTRL2_G] >> 4);
+	uint64_t fifo_period = Model_PeriodNs(regs[REG_FIFO_CTRL5] >> 3);
+	bool fifo_on = ((regs[REG_FIFO_CTRL5] & 0x07) != FIFO_MODE_BYPASS) && (fifo_period != 0);
+	uint64_t t;
+
+	/* Eventos em ordem de tempo; no empate o sensor antes do FIFO */
+	for (;;)
+	{
+		t = UINT64_MAX;
+		t = (acc_period && (acc.next_ns < t)) ? acc.next_ns : t;
+		t = (gyro_period && (gyro.next_ns < t)) ? gyro.next_ns : t;
+		t = (fifo_on && (fifoNextNs < t)) ? fifoNextNs : t;
+
+		if (t > now_ns)
+		{
+			break;
+		}
+
+		if (acc_period && (acc.next_ns == t))
+		{
+			Model_Sample(&acc);
+			acc.next_ns += acc_period;
+		}
+		else if (gyro_period && (gyro.next_ns == t))
+		{
+			Model_Sample(&gyro);
+			gyro.next_ns += gyro_period;
+		}
+		else
+		{
+			Model_FifoWrite(t);
+			fifoNextNs += fifo_period;
+		}
+	}
+}
+
+static uint8_t Model_Select(uint8_t sub, bool *inc)
+{
+	*inc = (regs[REG_CTRL3_C] & CTRL3_IF_INC) != 0;
+
+	return sub & 0x7F;
+}
+
+static uint8_t Model_Next(uint8_t reg)
+{
+	/* Com IF_INC o endereco volta de FIFO_DATA_OUT_H para _L */
+	if (reg == REG_FIFO_DATA_OUT_H)
+	{
+		return REG_FIFO_DATA_OUT_L;
+	}
+
+	return (reg + 1) & 0x7F;
+}
+
+static uint8_t Model_Read(uint8_t reg)
+{
+	uint16_t fth = (uint16_t) (regs[REG_FIFO_CTRL1] | ((regs[REG_FIFO_CTRL2] & 0x07) << 8));
+	uint16_t words = Model_SetWords();
+	uint8_t value;
+
+	reg &= 0x7F;
+
+	if ((regs[REG_FUNC_CFG_ACCESS] & FUNC_CFG_EN) && (reg != REG_FUNC_CFG_ACCESS))
+	{
+		return bankA[reg];
+	}
+
+	switch (reg)
+	{
+	case REG_FIFO_STATUS1:
+		return (uint8_t) fifoCount;
+
+	case REG_FIFO_STATUS2:
+		value = (uint8_t) ((fifoCount >> 8) & 0x07);
+		value |= ((fth > 0) && (fifoCount >= fth)) ? FIFO_STATUS2_WTM : 0;
+		value |= fifoOverrun ? FIFO_STATUS2_OVER_RUN : 0;
+		value |= ((words > 0) && ((fifoCount + words) > FIFO_WORDS)) ? FIFO_STATUS2_FULL_SMART : 0;
+		value |= (fifoCount == 0) ? FIFO_STATUS2_EMPTY : 0;
+		return value;
+
+	case REG_FIFO_STATUS3:
+		return (uint8_t) fifoPattern;
+
+	case REG_FIFO_STATUS4:
+		return (uint8_t) ((fifoPattern >> 8) & 0x03);
+
+	case REG_FIFO_DATA_OUT_L:
+		return (fifoCount > 0) ? (uint8_t) fifo[fifoHead] : 0;
+
+	case REG_FIFO_DATA_OUT_H:
+		if (fifoCount == 0)
+		{
+			return 0;
+		}
+
+		/* O byte alto tira a palavra do FIFO */
+		value = (uint8_t) (fifo[fifoHead] >> 8);
+		fifoHead = (fifoHead + 1) % FIFO_WORDS;
+		fifoCount--;
+		fifoPattern = (words > 0) ? ((fifoPattern + 1) % words) : 0;
+		fifoOverrun = false;
+		return value;
+
+	case REG_TIMESTAMP0:
+		/* A leitura em rajada ve os tres bytes do mesmo instante */
+		tsLatch = Model_Timestamp(I2CModel_Now() * 1000ULL);
+		return (uint8_t) tsLatch;
+
+	case REG_TIMESTAMP1:
+		return (uint8_t) (tsLatch >> 8);
+
+	case REG_TIMESTAMP2:
+		return (uint8_t) (tsLatch >> 16);
+
+	case REG_OUT_TEMP_H:
+		regs[REG_STATUS] &= ~STATUS_TDA;
+		break;
+
+	case REG_OUTZ_H_G:
+		regs[REG_STATUS] &= ~STATUS_GDA;
+		break;
+
+	case REG_OUTZ_H_XL:
+		regs[REG_STATUS] &= ~STATUS_XLDA;
+		break;
+
+	default:
+		break;
+	}
+
+	return regs[reg];
+}
+
+static void Model_Write(uint8_t reg, uint8_t value)
+{
+	if (reg == REG_FUNC_CFG_ACCESS)
+	{
+		regs[reg] = value & 0xA0;
+		return;
+	}
+
+	if (regs[REG_FUNC_CFG_ACCESS] & FUNC_CFG_EN)
+	{
+		bankA[reg] = value;
+		return;
+	}
+
+	if ((reg == REG_TIMESTAMP2) && (value == TIMESTAMP_RESET))
+	{
+		tsOriginNs = I2CModel_Now() * 1000ULL;
+		return;
+	}
+
+	if (Model_ReadOnly(reg))
+	{
+		return;
+	}
+
+	switch (reg)
+	{
+	case REG_CTRL3_C:
+		if (value & CTRL3_SW_RESET)
+		{
+			Model_Registers();
+			return;
+		}
+
+		regs[reg] = value & 0x7E;
+		break;
+
+	case REG_CTRL1_XL:
+		regs[reg] = value;
+
+		/* Novo modo: a primeira amostra sai um periodo depois */
+		acc.next_ns = I2CModel_Now() * 1000ULL + Model_PeriodNs(value >> 4);
+		break;
+
+	case REG_CTRL2_G:
+		regs[reg] = value;
+		gyro.next_ns = I2CModel_Now() * 1000ULL + Model_PeriodNs(value >> 4);
+		break;
+
+	case REG_FIFO_CTRL3:
+	case REG_FIFO_CTRL4:
+		/* Outro conjunto de data sets: o padrao recomeca */
+		regs[reg] = value;
+		Model_FifoClear();
+		break;
+
+	case REG_FIFO_CTRL5:
+		regs[reg] = value & 0x7F;
+
+		if ((value & 0x07) == FIFO_MODE_BYPASS)
+		{
+			Model_FifoClear();
+		}
+		Model_FifoRestart();
+		break;
+
+	default:
+		regs[reg] = value;
+		break;
+	}
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+const I2CModelDevice_t LSM6DSL_Model =
+{
+	.name = "LSM6DSL",
+	.address = MODEL_ADDRESS,
+	.reset = Model_Reset,
+	.advance = Model_Advance,
+	.select = Model_Select,
+	.next = Model_Next,
+	.read = Model_Read,
+	.write = Model_Write,
+};
+
+void LSM6DSL_Model_Set(const float acc_mg[3], const float gyro_mdps[3])
+{
+	memcpy(acc.truth, acc_mg, sizeof(acc.truth));
+	memcpy(gyro.truth, gyro_mdps, sizeof(gyro.truth));
+}
+
+uint32_t LSM6DSL_Model_Samples(void)
+{
+	return samples;
+}
+
+void LSM6DSL_Model_SetClock(double ppm)
+{
+	tsPpm = ppm;
+}
+
+uint64_t LSM6DSL_Model_FifoTime(uint32_t index)
+{
+	return fifoTimeNs[index % FIFO_TIMES];
+}
+
+void LSM6DSL_Model_GetFifo(SensorModelFifo_t *fifoOut)
+{
+	uint16_t words = Model_SetWords();
+
+	*fifoOut = fifoStats;
+	fifoOut->level = (words > 0) ? (fifoCount / words) : 0;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file    sensor_models.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelos dos registradores dos sensores I2C da B-L475E-IOT01A
+ * @details
+ * Cada modelo tem os registradores que os drivers de Application/Libs usam,
+ * com os valores de reset, o WHO_AM_I e a regra de incremento de endereco
+ * do CI:
+ *
+ *   - HTS221: incremento pelo bit 7 do subendereco; PD, ODR de 1/7/12.5 Hz,
+ *     ONE_SHOT que se limpa sozinho, H_DA/T_DA e os registradores de
+ *     calibracao de fabrica (a saida crua e a inversa da calibracao);
+ *   - LPS22HB: IF_ADD_INC, ODR de 1 a 75 Hz, ONE_SHOT com ODR = 0, LPF em
+ *     ODR/9 ou ODR/20 e o FIFO de 32 posicoes (bypass, FIFO e stream) com
+ *     watermark, STATUS_FIFO e o retorno de TEMP_OUT_H para PRESS_OUT_XL;
+ *   - LSM6DSL: IF_INC, ODR de 12.5 Hz a 6.66 kHz por canal, fundo de escala,
+ *     banco de funcoes embarcadas e o FIFO de 2048 palavras (bypass, FIFO e
+ *     continuo) com os data sets do giroscopio e do acelerometro, DIFF_FIFO,
+ *     FIFO_PATTERN, OVER_RUN e o retorno de FIFO_DATA_OUT_H para _L;
+ *   - LIS3MDL: incremento pelo bit 7 do subendereco, modos continuo, unico
+ *     (volta a idle sozinho) e desligado, DO/FAST_ODR, fundo de escala e
+ *     ZYXDA/ZYXOR.
+ *
+ * As grandezas sao constantes ate a proxima chamada de *_Model_Set; a saida
+ * crua e a grandeza dividida pela sensibilidade, arredondada e saturada.
+ * As sensibilidades sao as tipicas usadas pelos drivers (no LIS3MDL, as
+ * 140/290/430/580 ugauss/LSB do driver, nao o 6842 LSB/G da tabela).
+ * Sem ruido: o valor convertido pelo driver pode ser comparado com o real.
+ * Os tempos de conversao unica sao aproximados (o datasheet nao os da para
+ * todos os modos) e podem ser trocados por *_Model_SetConversion.
+ * O que os drivers nao usam (interrupcoes de limiar, pedometro, aquecedor)
+ * e so armazenado.
+ */
+
+#ifndef _SENSOR_MODELS_H_
+#define _SENSOR_MODELS_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "i2c_model.h"
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+/** @brief Tempos padrao de uma conversao unica (us) */
+#define HTS221_MODEL_CONVERSION_US		4500
+#define LPS22HB_MODEL_CONVERSION_US		10000
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Contadores de um FIFO simulado */
+typedef struct
+{
+	uint32_t written;       /**< Amostras (data sets) gravadas */
+	uint32_t dropped;       /**< Sobrescritas ou descartadas com o FIFO cheio */
+	uint16_t level;         /**< Amostras no FIFO agora */
+	uint16_t peak;          /**< Maior nivel desde o reset */
+} SensorModelFifo_t;
+
+//==============================================================================
+// PUBLIC VARIABLES
+//==============================================================================
+
+extern const I2CModelDevice_t HTS221_Model;
+extern const I2CModelDevice_t LPS22HB_Model;
+extern const I2CModelDevice_t LSM6DSL_Model;
+extern const I2CModelDevice_t LIS3MDL_Model;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Grandezas medidas pelo HTS221.
+ * @param temp_c Temperatura em C.
+ * @param rh Umidade em %RH.
+ */
+void HTS221_Model_Set(float temp_c, float rh);
+
+/** @brief Conversoes concluidas desde o reset. */
+uint32_t HTS221_Model_Samples(void);
+
+/** @brief Duracao de uma conversao unica (us). */
+void HTS221_Model_SetConversion(uint32_t us);
+
+/**
+ * Grandezas medidas pelo LPS22HB.
+ * @param p_hpa Pressao em hPa.
+ * @param temp_c Temperatura em C.
+ */
+void LPS22HB_Model_Set(float p_hpa, float temp_c);
+
+/** @brief Conversoes concluidas desde o reset. */
+uint32_t LPS22HB_Model_Samples(void);
+
+/** @brief Duracao de uma conversao unica (us). */
+void LPS22HB_Model_SetConversion(uint32_t us);
+
+/** @brief Nivel do INT_DRDY (fontes F_FTH, F_OVR, F_FSS5 e DRDY do CTRL_REG3). */
+bool LPS22HB_Model_Int(void);
+
+/** @brief Contadores do FIFO. */
+void LPS22HB_Model_GetFifo(SensorModelFifo_t *fifo);
+
+/**
+ * Grandezas medidas pelo LSM6DSL.
+ * @param acc_mg Aceleracao X, Y, Z em mg.
+ * @param gyro_mdps Velocidade angular X, Y, Z em mdps.
+ */
+void LSM6DSL_Model_Set(const float acc_mg[3], const float gyro_mdps[3]);
+
+/** @brief Amostras do acelerometro geradas desde o reset. */
+uint32_t LSM6DSL_Model_Samples(void);
+
+/** @brief Contadores do FIFO (em data sets). */
+void LSM6DSL_Model_GetFifo(SensorModelFifo_t *fifo);
+
+/**
+ * Erro do relogio do timestamp contra o tempo do barramento.
+ * @param ppm Positivo adianta.
+ */
+void LSM6DSL_Model_SetClock(double ppm);
+
+/**
+ * Instante real em que um data set foi gravado no FIFO.
+ * @param index Contagem de SensorModelFifo_t.written do data set (guarda os ultimos 4096).
+ * @return Tempo do barramento em ns.
+ */
+uint64_t LSM6DSL_Model_FifoTime(uint32_t index);
+
+/**
+ * Campo medido pelo LIS3MDL.
+ * @param mgauss Campo X, Y, Z em mgauss.
+ */
+void LIS3MDL_Model_Set(const float mgauss[3]);
+
+/** @brief Conversoes concluidas desde o reset. */
+uint32_t LIS3MDL_Model_Samples(void);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SENSOR_MODELS_H_ */
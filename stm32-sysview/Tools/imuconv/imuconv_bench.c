@@ -0,0 +1,283 @@
+/**
+ * @file    imuconv_bench.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Confere e mede no PC os kernels de Application/Libs/imuconv
+ * @details
+ * O caminho SIMD da lib e compilado aqui com as instrucoes DSP do Cortex-M4
+ * (QSUB16, SMLAD, SSAT, PKHBT) emuladas em C, e comparado bit a bit com as
+ * versoes de referencia sobre blocos aleatorios, incluindo bias e matrizes
+ * que saturam. Em seguida mede a vazao (amostras/us) das versoes de
+ * referencia, que sao as usadas no PC. A vazao do caminho emulado nao diz
+ * nada do alvo: no alvo use o comando "imuconv" do shell, que mede os dois
+ * caminhos com o DWT.
+ *
+ * Compilacao:
+ *   gcc -O2 -I../../Application/Libs imuconv_bench.c -o imuconv_bench
+ *
+ * Uso:
+ *   ./imuconv_bench [amostras por bloco]
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//==============================================================================
+// EMULACAO DAS INSTRUCOES DSP
+//==============================================================================
+
+#define IMUCONV_USE_DSP				1
+#define IMUCONV_HOST_INTRINSICS
+
+static inline int32_t Bench_Sat(int32_t v, int bits)
+{
+	int32_t max = (1 << (bits - 1)) - 1;
+	int32_t min = -max - 1;
+
+	return (v > max) ? max : ((v < min) ? min : v);
+}
+
+static inline uint32_t __QSUB16(uint32_t a, uint32_t b)
+{
+	int32_t lo = Bench_Sat((int16_t) a - (int16_t) b, 16);
+	int32_t hi = Bench_Sat((int16_t) (a >> 16) - (int16_t) (b >> 16), 16);
+
+	return (uint16_t) lo | ((uint32_t) (uint16_t) hi << 16);
+}
+
+static inline uint32_t __SMLAD(uint32_t a, uint32_t b, uint32_t acc)
+{
+	return acc + (uint32_t) ((int16_t) a * (int16_t) b) + (uint32_t) ((int16_t) (a >> 16) * (int16_t) (b >> 16));
+}
+
+#define __SSAT(v, bits)					Bench_Sat((v), (bits))
+#define __PKHBT(a, b, sh)				(((uint32_t) (a) & 0xFFFFUL) | ((uint32_t) (b) << (sh)))
+
+static inline uint32_t Bench_Read32(const void *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline uint16_t Bench_Read16(const void *p)
+{
+	uint16_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+#define __UNALIGNED_UINT32_READ(p)		Bench_Read32(p)
+#define __UNALIGNED_UINT16_READ(p)		Bench_Read16(p)
+
+#include "imuconv/imuconv.c"
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define BENCH_DEFAULT_SAMPLES		256
+#define BENCH_CHECK_ROUNDS			2000
+#define BENCH_MIN_SECONDS			0.5
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+static double Bench_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static int16_t Bench_Rand16(void)
+{
+	return (int16_t) (rand() & 0xFFFF);
+}
+
+/** @brief Matriz e bias aleatorios; parte das vezes perto da saturacao. */
+static void Bench_RandomConv(ImuConv_t *conv)
+{
+	static const int8_t maps[][3] = { { 1, 2, 3 }, { 2, -1, 3 }, { -1, -2, 3 }, { 3, 1, -2 } };
+	int16_t m[3][3], bias[3];
+	int i, j;
+
+	ImuConv_Init(conv, (rand() % 2000) - 1000);
+
+	if (rand() & 1)
+	{
+		ImuConv_SetRemap(conv, maps[rand() % 4]);
+	}
+	else
+	{
+		/* Linhas com soma dos modulos abaixo de 4.0 */
+		for (i = 0; i < 3; i++)
+		{
+			for (j = 0; j < 3; j++)
+			{
+				m[i][j] = (int16_t) ((rand() % 43690) - 21845);
+			}
+		}
+		ImuConv_SetMatrix(conv, m);
+	}
+
+	for (i = 0; i < 3; i++)
+	{
+		bias[i] = (rand() & 3) ? (int16_t) ((rand() % 2000) - 1000) : Bench_Rand16();
+	}
+	ImuConv_SetBias(conv, bias);
+}
+
+/** @brief Compara o caminho SIMD emulado com a referencia. */
+static int Bench_Check(uint32_t n)
+{
+	uint8_t *bytes = malloc(n * IMUCONV_SAMPLE_BYTES);
+	int16_t *s16 = malloc(n * 3 * sizeof(int16_t));
+	int16_t *r16 = malloc(n * 3 * sizeof(int16_t));
+	int32_t *s32 = malloc(n * 3 * sizeof(int32_t));
+	int32_t *a = malloc(n * 3 * sizeof(int32_t));
+	int32_t *b = malloc(n * 3 * sizeof(int32_t));
+	ImuConv_t conv;
+	int round, errors = 0;
+	uint32_t i;
+
+	for (round = 0; round < BENCH_CHECK_ROUNDS; round++)
+	{
+		Bench_RandomConv(&conv);
+		for (i = 0; i < n * IMUCONV_SAMPLE_BYTES; i++)
+		{
+			bytes[i] = (uint8_t) rand();
+		}
+
+		ImuConv_Unpack(bytes, s16, n);
+		ImuConv_UnpackRef(bytes, r16, n);
+		errors += (memcmp(s16, r16, n * 3 * sizeof(int16_t)) != 0);
+
+		ImuConv_Bytes(&conv, bytes, a, n);
+		ImuConv_BytesRef(&conv, bytes, b, n);
+		errors += (memcmp(a, b, n * 3 * sizeof(int32_t)) != 0);
+
+		ImuConv_Int16(&conv, r16, a, n);
+		errors += (memcmp(a, b, n * 3 * sizeof(int32_t)) != 0);
+
+		ImuConv_Int16Ref(&conv, r16, a, n);
+		errors += (memcmp(a, b, n * 3 * sizeof(int32_t)) != 0);
+
+		/* Int32 no lugar, como no convert dos drivers */
+		for (i = 0; i < n * 3; i++)
+		{
+			s32[i] = r16[i];
+		}
+		memcpy(a, s32, n * 3 * sizeof(int32_t));
+		ImuConv_Int32(&conv, a, a, n);
+		errors += (memcmp(a, b, n * 3 * sizeof(int32_t)) != 0);
+
+		ImuConv_Int32Ref(&conv, s32, a, n);
+		errors += (memcmp(a, b, n * 3 * sizeof(int32_t)) != 0);
+	}
+
+	free(bytes);
+	free(s16);
+	free(r16);
+	free(s32);
+	free(a);
+	free(b);
+
+	return errors;
+}
+
+/** @brief Vazao de um kernel em amostras por microssegundo. */
+static double Bench_Rate(const char *name, void (*kernel)(const ImuConv_t *, const uint8_t *, int32_t *, uint32_t),
+		const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t n)
+{
+	unsigned long calls = 0;
+	double start = Bench_Now(), elapsed;
+	double rate;
+
+	do
+	{
+		kernel(conv, bytes, out, n);
+		calls++;
+		elapsed = Bench_Now() - start;
+	} while (elapsed < BENCH_MIN_SECONDS);
+
+	rate = (double) calls * n / (elapsed * 1e6);
+	printf("%-22s %8.1f samples/us\n", name, rate);
+
+	return rate;
+}
+
+static void Bench_Int16Ref(const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t n)
+{
+	ImuConv_Int16Ref(conv, (const int16_t *) (const void *) bytes, out, n);
+}
+
+/** @brief Laco original dos drivers: montagem de bytes e multiplicacao por eixo. */
+static void Bench_Legacy(const ImuConv_t *conv, const uint8_t *bytes, int32_t *out, uint32_t n)
+{
+	uint32_t i;
+
+	for (i = 0; i < n * 3; i++)
+	{
+		out[i] = (int16_t) ((((uint16_t) bytes[2 * i + 1]) << 8) + (uint16_t) bytes[2 * i]) * conv->scale;
+	}
+}
+
+//==============================================================================
+// SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	uint32_t n = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_SAMPLES;
+	static const int8_t remap[3] = { 2, -1, 3 };
+	static const int16_t bias[3] = { 12, -30, 7 };
+	uint8_t *bytes;
+	int32_t *out;
+	ImuConv_t conv;
+	uint32_t i;
+	int errors;
+
+	if (n == 0)
+	{
+		n = BENCH_DEFAULT_SAMPLES;
+	}
+
+	srand(1);
+	errors = Bench_Check(n);
+	printf("check: %d mismatches in %d random blocks of %u samples\n", errors, BENCH_CHECK_ROUNDS, n);
+
+	bytes = malloc(n * IMUCONV_SAMPLE_BYTES);
+	out = malloc(n * 3 * sizeof(int32_t));
+	for (i = 0; i < n * IMUCONV_SAMPLE_BYTES; i++)
+	{
+		bytes[i] = (uint8_t) rand();
+	}
+
+	/* Caso tipico: gyro a 2000 dps (70 mdps/LSB em 0.01 mdps), eixos trocados e bias */
+	ImuConv_Init(&conv, 7000);
+	ImuConv_SetRemap(&conv, remap);
+	ImuConv_SetBias(&conv, bias);
+
+	printf("block of %u samples, host reference kernels:\n", n);
+	Bench_Rate("legacy scale only", Bench_Legacy, &conv, bytes, out, n);
+	Bench_Rate("ImuConv_BytesRef", ImuConv_BytesRef, &conv, bytes, out, n);
+	Bench_Rate("ImuConv_Int16Ref", Bench_Int16Ref, &conv, bytes, out, n);
+
+	free(bytes);
+	free(out);
+
+	return (errors == 0) ? 0 : 2;
+}
@@ -0,0 +1,167 @@
+/**
+ * @file    magcal_replay.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Roda a calibracao do magnetometro no PC sobre dados gravados
+ * @details
+ * Usa a mesma lib Application/Libs/magcal do firmware. A entrada e um
+ * arquivo texto com uma amostra por linha; as tres ultimas colunas numericas
+ * sao o campo x, y, z em mgauss. Isso aceita tanto um arquivo "x,y,z" quanto
+ * o CSV gerado por Tools/telemetry/tlm_decode com todos os sinais
+ * selecionados (o magnetometro e o ultimo canal do registro).
+ *
+ * Compilacao:
+ *   gcc -O2 -I../../Application/Libs magcal_replay.c \
+ *       ../../Application/Libs/magcal/magcal.c -lm -o magcal_replay
+ *
+ * Uso:
+ *   ./magcal_replay captura.csv [corrigido.csv]
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "magcal/magcal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Mesmo intervalo de solucao usado em app_magcal.c */
+#define REPLAY_SOLVE_INTERVAL	40
+
+#define REPLAY_MAX_COLUMNS		32
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Extrai as tres ultimas colunas numericas de uma linha.
+ * @return 1 se a linha tinha pelo menos tres numeros.
+ */
+static int Replay_ParseLine(char *line, float m[3])
+{
+	float cols[REPLAY_MAX_COLUMNS];
+	char *tok, *end;
+	int n = 0;
+
+	for (tok = strtok(line, ",; \t\r\n"); (tok != NULL) && (n < REPLAY_MAX_COLUMNS); tok = strtok(NULL, ",; \t\r\n"))
+	{
+		cols[n] = strtof(tok, &end);
+		if (end != tok)
+		{
+			n++;
+		}
+	}
+
+	if (n < 3)
+	{
+		return 0;
+	}
+
+	/* mgauss para gauss, como no firmware */
+	m[0] = cols[n - 3] / 1000.0f;
+	m[1] = cols[n - 2] / 1000.0f;
+	m[2] = cols[n - 1] / 1000.0f;
+
+	return 1;
+}
+
+//==============================================================================
+// SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	static MagCal_t cal;
+	FILE *in, *out = NULL;
+	char line[512];
+	float m[3], c[3];
+	unsigned long since = 0;
+	int i;
+
+	if (argc < 2)
+	{
+		fprintf(stderr, "uso: %s captura.csv [corrigido.csv]\n", argv[0]);
+		return 1;
+	}
+
+	in = fopen(argv[1], "r");
+	if (in == NULL)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+
+	MagCal_Init(&cal, 1.0f);
+
+	while (fgets(line, sizeof(line), in) != NULL)
+	{
+		if (Replay_ParseLine(line, m) == 0)
+		{
+			continue;
+		}
+
+		MagCal_AddSample(&cal, m);
+
+		if (++since >= REPLAY_SOLVE_INTERVAL)
+		{
+			since = 0;
+			MagCal_Solve(&cal);
+		}
+	}
+
+	MagCal_Solve(&cal);
+
+	printf("samples   %lu\n", (unsigned long) cal.quality.samples);
+	printf("solves    %lu\n", (unsigned long) cal.quality.solves);
+	printf("coverage  %u/%u\n", cal.quality.coverage, MAGCAL_NUM_BINS);
+	printf("residual  %.3f %%\n", cal.quality.residual * 100.0f);
+	printf("delta     %.4f %%\n", cal.quality.delta * 100.0f);
+	printf("converged %d\n", cal.quality.converged);
+	printf("offset    %.5f %.5f %.5f gauss\n", cal.params.offset[0], cal.params.offset[1], cal.params.offset[2]);
+	printf("radius    %.5f gauss\n", cal.params.radius);
+	for (i = 0; i < 3; i++)
+	{
+		printf("soft[%d]   %.5f %.5f %.5f\n", i, cal.params.soft[i][0], cal.params.soft[i][1], cal.params.soft[i][2]);
+	}
+
+	/* Segunda passada: grava as amostras corrigidas com a solucao final */
+	if ((argc > 2) && (cal.quality.valid))
+	{
+		out = fopen(argv[2], "w");
+		if (out == NULL)
+		{
+			perror(argv[2]);
+			fclose(in);
+			return 1;
+		}
+
+		rewind(in);
+		fprintf(out, "mx,my,mz,cx,cy,cz\n");
+		while (fgets(line, sizeof(line), in) != NULL)
+		{
+			if (Replay_ParseLine(line, m) == 0)
+			{
+				continue;
+			}
+
+			MagCal_Apply(&cal.params, m, c);
+			fprintf(out, "%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n",
+					m[0] * 1000.0f, m[1] * 1000.0f, m[2] * 1000.0f,
+					c[0] * 1000.0f, c[1] * 1000.0f, c[2] * 1000.0f);
+		}
+		fclose(out);
+	}
+
+	fclose(in);
+
+	return cal.quality.valid ? 0 : 2;
+}
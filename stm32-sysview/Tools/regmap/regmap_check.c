@@ -0,0 +1,137 @@
+/**
+ * @file    regmap_check.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Confere no PC as mascaras, valores e atualizacoes do regmap
+ * @details
+ * Compilar (dentro de Tools/regmap):
+ *
+ *   gcc -O2 -Wall -I../../Application/Libs regmap_check.c -o regmap_check
+ *
+ * Com -DREGMAP_CHECK_MISUSE=n (1 a 6) o programa inclui um uso errado e a
+ * compilacao deve falhar com a mensagem do REGMAP_CHECK correspondente:
+ *
+ *   1  campo maior que o registrador
+ *   2  valor nao cabe no campo
+ *   3  campo de outro registrador
+ *   4  campos sobrepostos
+ *   5  registrador fora do buffer
+ *   6  rajada com o fim antes do inicio
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "regmap/regmap.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/* CTRL_REG1 a CTRL_REG3 do HTS221 */
+#define CTRL_REG1				0x20
+#define CTRL_REG2				0x21
+#define CTRL_REG3				0x22
+
+#define F_PD					REGMAP_FIELD(CTRL_REG1, 7, 1)
+#define F_BDU					REGMAP_FIELD(CTRL_REG1, 2, 1)
+#define F_ODR					REGMAP_FIELD(CTRL_REG1, 0, 2)
+#define F_BOOT					REGMAP_FIELD(CTRL_REG2, 7, 1)
+#define F_ONE_SHOT				REGMAP_FIELD(CTRL_REG2, 0, 1)
+#define F_OVERLAP					REGMAP_FIELD(CTRL_REG2, 6, 2)
+
+#define CHECK(cond) \
+	do \
+	{ \
+		if (!(cond)) \
+		{ \
+			printf("FAIL: linha %d: %s\n", __LINE__, #cond); \
+			errors++; \
+		} \
+	} while (0)
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static uint8_t shadow[3];
+static uint8_t written[3];
+static uint32_t writes;
+static int errors;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Escrita simulada de um registrador.
+ * @param reg Registrador.
+ * @param value Valor.
+ */
+static void Check_Write(uint8_t reg, uint8_t value);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void Check_Write(uint8_t reg, uint8_t value)
+{
+	written[reg - CTRL_REG1] = value;
+	writes++;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(void)
+{
+	uint8_t burst[REGMAP_COUNT(CTRL_REG1, CTRL_REG3)];
+	uint8_t odr = 3;
+
+	/* Tudo constante: usavel em dimensao de vetor e em case */
+	CHECK(REGMAP_MASK(F_ODR) == 0x03);
+	CHECK(REGMAP_MASK(F_PD) == 0x80);
+	CHECK(REGMAP_REG(F_BOOT) == CTRL_REG2);
+	CHECK(REGMAP_GET(F_ODR, 0x86) == 2);
+	CHECK(REGMAP_MASKS(CTRL_REG1, REGMAP_SET(F_PD, 1), REGMAP_SET(F_BDU, 1), REGMAP_SET(F_ODR, 2)) == 0x87);
+	CHECK(REGMAP_BITS(CTRL_REG1, REGMAP_SET(F_PD, 1), REGMAP_SET(F_BDU, 0), REGMAP_SET(F_ODR, 2)) == 0x82);
+	CHECK(REGMAP_BITS(CTRL_REG1, REGMAP_SETV(F_ODR, odr + 4)) == 0x03);
+	CHECK(sizeof(burst) == 3);
+	CHECK(&REGMAP_AT(burst, CTRL_REG1, CTRL_REG3) == &burst[2]);
+
+	/* Tres campos em uma escrita; repetir a mesma atualizacao nao escreve */
+	memset(shadow, 0, sizeof(shadow));
+	shadow[0] = 0x70;
+	CHECK(REGMAP_UPDATE(shadow, CTRL_REG1, Check_Write, CTRL_REG1, REGMAP_SET(F_PD, 1), REGMAP_SET(F_BDU, 1),
+			REGMAP_SETV(F_ODR, odr)) == true);
+	CHECK((writes == 1) && (written[0] == 0xF7) && (shadow[0] == 0xF7));
+	CHECK(REGMAP_UPDATE(shadow, CTRL_REG1, Check_Write, CTRL_REG1, REGMAP_SET(F_PD, 1), REGMAP_SETV(F_ODR, odr))
+			== false);
+	CHECK(writes == 1);
+	CHECK(REGMAP_UPDATE(shadow, CTRL_REG1, Check_Write, CTRL_REG2, REGMAP_SET(F_BOOT, 1)) == true);
+	CHECK((writes == 2) && (written[1] == 0x80) && (shadow[0] == 0xF7));
+
+#if REGMAP_CHECK_MISUSE == 1
+	CHECK(REGMAP_MASK(REGMAP_FIELD(CTRL_REG1, 6, 4)) != 0);
+#elif REGMAP_CHECK_MISUSE == 2
+	CHECK(REGMAP_BITS(CTRL_REG1, REGMAP_SET(F_ODR, 4)) != 0);
+#elif REGMAP_CHECK_MISUSE == 3
+	REGMAP_UPDATE(shadow, CTRL_REG1, Check_Write, CTRL_REG1, REGMAP_SET(F_PD, 1), REGMAP_SET(F_ONE_SHOT, 1));
+#elif REGMAP_CHECK_MISUSE == 4
+	REGMAP_UPDATE(shadow, CTRL_REG1, Check_Write, CTRL_REG2, REGMAP_SET(F_BOOT, 1), REGMAP_SET(F_OVERLAP, 1));
+#elif REGMAP_CHECK_MISUSE == 5
+	CHECK(REGMAP_AT(burst, CTRL_REG2, CTRL_REG3 + 2) == 0);
+#elif REGMAP_CHECK_MISUSE == 6
+	CHECK(REGMAP_COUNT(CTRL_REG3, CTRL_REG1) != 0);
+#endif
+
+	printf("%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}
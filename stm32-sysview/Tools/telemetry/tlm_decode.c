@@ -0,0 +1,640 @@
+/**
+ * @file    tlm_decode.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.2.0
+ * @brief   Decodifica no PC o fluxo binario de telemetria da serial
+ * @details
+ * Usa a mesma lib Application/Libs/telemetry do firmware. A entrada e a
+ * captura crua da serial (texto do shell no meio e ignorado); os quadros sao
+ * achados pelo sincronismo e validados pelo CRC. Quadros de dados so sao
+ * decodificados depois do esquema completo; apos uma perda (seq) os DELTA sao
+ * descartados ate o proximo FULL.
+ *
+ * Saidas:
+ * - CSV: time_ms, seq e uma coluna por sinal na unidade do sinal. Uma troca
+ *   de esquema gera um novo cabecalho.
+ * - Colunas (-c dir): um arquivo float64 little-endian por coluna em
+ *   dir/segN/, com um manifest.csv (coluna, unidade, escala, linhas, arquivo)
+ *   por esquema, para carregar direto em numpy/pandas/arrow.
+ * - Tasks (-t arquivo): uma linha por task de cada foto do sistema (quadros
+ *   SYSTEM e TASK), com o heap e a carga da foto.
+ *
+ * Compilacao:
+ *   gcc -O2 -I../../Application/Libs tlm_decode.c \
+ *       ../../Application/Libs/telemetry/telemetry.c -o tlm_decode
+ *
+ * Uso:
+ *   stty -F /dev/ttyACM0 115200 raw && cat /dev/ttyACM0 > captura.bin
+ *   ./tlm_decode [-b baud] [-c dir] [-t tasks.csv] captura.bin [saida.csv]
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "telemetry/telemetry.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define DECODE_NAME_SIZE		64
+#define DECODE_PATH_SIZE		512
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Esquema recebido */
+typedef struct
+{
+	int version;                /**< -1 = nenhum */
+	uint8_t count;
+	uint32_t received;          /**< Bit n = sinal n recebido */
+	bool complete;
+	char name[TLM_MAX_SIGNALS][DECODE_NAME_SIZE];
+	char unit[TLM_MAX_SIGNALS][DECODE_NAME_SIZE];
+	int32_t scale[TLM_MAX_SIGNALS];
+} DecodeSchema_t;
+
+/** @brief Ultimo quadro SYSTEM recebido */
+typedef struct
+{
+	bool valid;
+	uint16_t seq;               /**< Numero da foto */
+	uint32_t ts;
+	uint32_t heap_free;
+	uint32_t heap_min;
+	uint16_t load;
+	uint8_t tasks;
+	uint8_t received;           /**< Quadros TASK da foto */
+} DecodeSystem_t;
+
+/** @brief Estado do decodificador e contadores */
+typedef struct
+{
+	DecodeSchema_t schema;
+	bool synced;                /**< Tem a referencia para os DELTA */
+	bool has_seq;
+	uint16_t last_seq;
+	uint32_t ts;
+	int32_t values[TLM_MAX_SIGNALS];
+
+	/* Saidas */
+	FILE *csv;
+	const char *dir;
+	int segment;
+	FILE *col[TLM_MAX_SIGNALS + 2];
+	unsigned long rows;
+	FILE *tasks;
+	DecodeSystem_t system;
+
+	/* Contadores */
+	unsigned long frames[TLM_FRAME_TASK + 1];
+	unsigned long snapshots;    /**< Fotos com todas as tasks */
+	unsigned long data_bytes;
+	unsigned long crc_errors;
+	unsigned long lost;
+	unsigned long skipped;      /**< DELTA sem referencia ou dados sem esquema */
+	unsigned long noise;        /**< Bytes fora de quadros (texto do shell) */
+	bool has_first_ts;
+	uint32_t first_ts;
+} Decode_t;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Fecha os arquivos de colunas e grava o manifest do segmento. */
+static void Decode_CloseColumns(Decode_t *d)
+{
+	char path[DECODE_PATH_SIZE];
+	FILE *man;
+	uint8_t i;
+
+	if (d->col[0] == NULL)
+	{
+		return;
+	}
+
+	for (i = 0; i < d->schema.count + 2; i++)
+	{
+		fclose(d->col[i]);
+		d->col[i] = NULL;
+	}
+
+	snprintf(path, sizeof(path), "%s/seg%d/manifest.csv", d->dir, d->segment);
+	man = fopen(path, "w");
+	if (man == NULL)
+	{
+		perror(path);
+		return;
+	}
+
+	fprintf(man, "column,unit,scale,rows,file\n");
+	fprintf(man, "time_ms,ms,1,%lu,time_ms.f64\n", d->rows);
+	fprintf(man, "seq,,1,%lu,seq.f64\n", d->rows);
+	for (i = 0; i < d->schema.count; i++)
+	{
+		fprintf(man, "%s,%s,%d,%lu,%02u.f64\n", d->schema.name[i], d->schema.unit[i], d->schema.scale[i], d->rows, i);
+	}
+	fclose(man);
+
+	d->segment++;
+}
+
+/** @brief Comeca um segmento novo das saidas para o esquema atual. */
+static void Decode_OpenOutputs(Decode_t *d)
+{
+	char path[DECODE_PATH_SIZE];
+	uint8_t i;
+
+	if (d->csv != NULL)
+	{
+		fprintf(d->csv, "time_ms,seq");
+		for (i = 0; i < d->schema.count; i++)
+		{
+			fprintf(d->csv, ",%s", d->schema.name[i]);
+		}
+		fprintf(d->csv, "\n");
+	}
+
+	if (d->dir == NULL)
+	{
+		return;
+	}
+
+	Decode_CloseColumns(d);
+	d->rows = 0;
+
+	snprintf(path, sizeof(path), "%s/seg%d", d->dir, d->segment);
+	mkdir(path, 0755);
+
+	for (i = 0; i < d->schema.count + 2; i++)
+	{
+		if (i == 0)
+		{
+			snprintf(path, sizeof(path), "%s/seg%d/time_ms.f64", d->dir, d->segment);
+		}
+		else if (i == 1)
+		{
+			snprintf(path, sizeof(path), "%s/seg%d/seq.f64", d->dir, d->segment);
+		}
+		else
+		{
+			snprintf(path, sizeof(path), "%s/seg%d/%02u.f64", d->dir, d->segment, i - 2);
+		}
+
+		d->col[i] = fopen(path, "wb");
+		if (d->col[i] == NULL)
+		{
+			perror(path);
+			exit(1);
+		}
+	}
+}
+
+/** @brief Grava uma linha com os valores atuais. */
+static void Decode_Emit(Decode_t *d, uint16_t seq)
+{
+	double v;
+	uint8_t i;
+
+	if (d->has_first_ts == false)
+	{
+		d->has_first_ts = true;
+		d->first_ts = d->ts;
+	}
+
+	if (d->csv != NULL)
+	{
+		fprintf(d->csv, "%lu,%u", (unsigned long) d->ts, seq);
+		for (i = 0; i < d->schema.count; i++)
+		{
+			fprintf(d->csv, ",%.6g", (double) d->values[i] / (double) d->schema.scale[i]);
+		}
+		fprintf(d->csv, "\n");
+	}
+
+	if (d->col[0] != NULL)
+	{
+		/* float64 nativo: o PC e little-endian */
+		v = (double) d->ts;
+		fwrite(&v, sizeof(v), 1, d->col[0]);
+		v = (double) seq;
+		fwrite(&v, sizeof(v), 1, d->col[1]);
+		for (i = 0; i < d->schema.count; i++)
+		{
+			v = (double) d->values[i] / (double) d->schema.scale[i];
+			fwrite(&v, sizeof(v), 1, d->col[i + 2]);
+		}
+	}
+
+	d->rows++;
+}
+
+/** @brief Acumula um quadro de esquema. */
+static void Decode_Schema(Decode_t *d, uint8_t version, const uint8_t *p, uint8_t len)
+{
+	DecodeSchema_t *s = &d->schema;
+	const uint8_t *end = p + len;
+	uint8_t count, index;
+	size_t n;
+
+	if (len < 8)
+	{
+		return;
+	}
+
+	count = p[0];
+	index = p[1];
+	if ((count == 0) || (count > TLM_MAX_SIGNALS) || (index >= count))
+	{
+		return;
+	}
+
+	/* Versao nova ou reenvio periodico da mesma */
+	if ((s->version != version) || (s->count != count))
+	{
+		memset(s, 0, sizeof(DecodeSchema_t));
+		s->version = version;
+		s->count = count;
+		d->synced = false;
+	}
+
+	s->scale[index] = (int32_t) ((uint32_t) p[2] | ((uint32_t) p[3] << 8) | ((uint32_t) p[4] << 16) | ((uint32_t) p[5] << 24));
+	if (s->scale[index] == 0)
+	{
+		s->scale[index] = 1;
+	}
+	p += 6;
+
+	n = strnlen((const char *) p, (size_t) (end - p));
+	snprintf(s->name[index], DECODE_NAME_SIZE, "%.*s", (int) n, (const char *) p);
+	p += (n < (size_t) (end - p)) ? n + 1 : n;
+	n = strnlen((const char *) p, (size_t) (end - p));
+	snprintf(s->unit[index], DECODE_NAME_SIZE, "%.*s", (int) n, (const char *) p);
+
+	s->received |= 1UL << index;
+	if ((s->complete == false) && (s->received == ((count >= 32) ? 0xFFFFFFFFUL : ((1UL << count) - 1))))
+	{
+		s->complete = true;
+		Decode_OpenOutputs(d);
+	}
+}
+
+/** @brief Decodifica um quadro FULL ou DELTA. */
+static void Decode_Data(Decode_t *d, TlmFrame_e type, uint8_t version, uint16_t seq, const uint8_t *p, uint8_t len)
+{
+	const uint8_t *end = p + len;
+	int32_t values[TLM_MAX_SIGNALS];
+	int32_t dts;
+	uint32_t ts;
+	uint8_t i;
+
+	d->data_bytes += TLM_HEADER_SIZE + len + TLM_CRC_SIZE;
+
+	if (d->has_seq && (seq != (uint16_t) (d->last_seq + 1)))
+	{
+		d->lost += (uint16_t) (seq - d->last_seq - 1);
+		d->synced = false;
+	}
+	d->has_seq = true;
+	d->last_seq = seq;
+
+	if ((d->schema.complete == false) || (d->schema.version != version))
+	{
+		d->skipped++;
+		return;
+	}
+
+	if (type == TLM_FRAME_FULL)
+	{
+		if (len < 4)
+		{
+			return;
+		}
+		ts = (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+		p += 4;
+
+		for (i = 0; i < d->schema.count; i++)
+		{
+			if (Tlm_GetVarint(&p, end, &values[i]) == false)
+			{
+				return;
+			}
+		}
+	}
+	else
+	{
+		if (d->synced == false)
+		{
+			d->skipped++;
+			return;
+		}
+
+		if (Tlm_GetVarint(&p, end, &dts) == false)
+		{
+			return;
+		}
+		ts = d->ts + (uint32_t) dts;
+
+		for (i = 0; i < d->schema.count; i++)
+		{
+			if (Tlm_GetVarint(&p, end, &values[i]) == false)
+			{
+				return;
+			}
+			values[i] = (int32_t) ((uint32_t) d->values[i] + (uint32_t) values[i]);
+		}
+	}
+
+	d->ts = ts;
+	memcpy(d->values, values, sizeof(values));
+	d->synced = true;
+
+	Decode_Emit(d, seq);
+}
+
+/** @brief Le um inteiro little-endian. */
+static uint32_t Decode_GetLE(const uint8_t *p, uint8_t size)
+{
+	uint32_t v = 0;
+
+	while (size--)
+	{
+		v = (v << 8) | p[size];
+	}
+
+	return v;
+}
+
+/** @brief Abre uma foto do sistema. */
+static void Decode_System(Decode_t *d, uint16_t seq, const uint8_t *p, uint8_t len)
+{
+	DecodeSystem_t *sys = &d->system;
+
+	if (len < 15)
+	{
+		return;
+	}
+
+	sys->valid = true;
+	sys->seq = seq;
+	sys->ts = Decode_GetLE(&p[0], 4);
+	sys->heap_free = Decode_GetLE(&p[4], 4);
+	sys->heap_min = Decode_GetLE(&p[8], 4);
+	sys->load = (uint16_t) Decode_GetLE(&p[12], 2);
+	sys->tasks = p[14];
+	sys->received = 0;
+}
+
+/** @brief Grava uma task da foto aberta pelo ultimo SYSTEM. */
+static void Decode_Task(Decode_t *d, uint16_t seq, const uint8_t *p, uint8_t len)
+{
+	static const char state[] = { 'X', 'R', 'B', 'S', 'D' };
+	DecodeSystem_t *sys = &d->system;
+	uint16_t cpu;
+	size_t n;
+
+	/* Sem o SYSTEM da mesma foto nao ha tempo nem heap */
+	if ((len < 10) || (sys->valid == false) || (sys->seq != seq))
+	{
+		d->skipped++;
+		return;
+	}
+
+	sys->received++;
+	if (sys->received == sys->tasks)
+	{
+		d->snapshots++;
+	}
+
+	if (d->tasks == NULL)
+	{
+		return;
+	}
+
+	cpu = (uint16_t) Decode_GetLE(&p[5], 2);
+	n = strnlen((const char *) &p[9], (size_t) (len - 9));
+
+	fprintf(d->tasks, "%lu,%u,%u,%.*s,%c,%u,%u.%u,%u,%lu,%lu,%u.%u\n",
+			(unsigned long) sys->ts, seq, (unsigned) Decode_GetLE(&p[1], 2), (int) n, (const char *) &p[9],
+			(p[3] < sizeof(state)) ? state[p[3]] : '?', p[4], cpu / 10, cpu % 10,
+			(unsigned) Decode_GetLE(&p[7], 2), (unsigned long) sys->heap_free, (unsigned long) sys->heap_min,
+			sys->load / 10, sys->load % 10);
+}
+
+/**
+ * Procura quadros em um buffer.
+ * @return Bytes consumidos; o resto pode ser o inicio de um quadro.
+ */
+static size_t Decode_Buffer(Decode_t *d, const uint8_t *buf, size_t n)
+{
+	size_t i = 0, total;
+	uint8_t type, len;
+	uint16_t crc, seq;
+
+	while (i + 1 < n)
+	{
+		if ((buf[i] != TLM_SYNC0) || (buf[i + 1] != TLM_SYNC1))
+		{
+			d->noise++;
+			i++;
+			continue;
+		}
+
+		if (i + TLM_HEADER_SIZE > n)
+		{
+			break;
+		}
+
+		len = buf[i + 3];
+		total = TLM_HEADER_SIZE + len + TLM_CRC_SIZE;
+		if (i + total > n)
+		{
+			break;
+		}
+
+		crc = (uint16_t) (buf[i + total - 2] | (buf[i + total - 1] << 8));
+		if (Tlm_Crc16(&buf[i + 2], (uint16_t) (TLM_HEADER_SIZE - 2 + len)) != crc)
+		{
+			/* Sincronismo falso ou quadro corrompido: tenta no proximo byte */
+			d->crc_errors++;
+			d->noise++;
+			i++;
+			continue;
+		}
+
+		type = buf[i + 2];
+		seq = (uint16_t) (buf[i + 4] | (buf[i + 5] << 8));
+
+		switch (type & 0x0F)
+		{
+		case TLM_FRAME_SCHEMA:
+			d->frames[TLM_FRAME_SCHEMA]++;
+			Decode_Schema(d, type >> 4, &buf[i + TLM_HEADER_SIZE], len);
+			break;
+
+		case TLM_FRAME_FULL:
+		case TLM_FRAME_DELTA:
+			d->frames[type & 0x0F]++;
+			Decode_Data(d, (TlmFrame_e) (type & 0x0F), type >> 4, seq, &buf[i + TLM_HEADER_SIZE], len);
+			break;
+
+		case TLM_FRAME_SYSTEM:
+			d->frames[TLM_FRAME_SYSTEM]++;
+			Decode_System(d, seq, &buf[i + TLM_HEADER_SIZE], len);
+			break;
+
+		case TLM_FRAME_TASK:
+			d->frames[TLM_FRAME_TASK]++;
+			Decode_Task(d, seq, &buf[i + TLM_HEADER_SIZE], len);
+			break;
+
+		default:
+			break;
+		}
+
+		i += total;
+	}
+
+	return i;
+}
+
+//==============================================================================
+// SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	static Decode_t d;
+	static uint8_t buf[8192];
+	const char *in_path = NULL, *csv_path = NULL, *tasks_path = NULL;
+	unsigned long baud = 115200;
+	unsigned long data_frames;
+	size_t have = 0, used, got;
+	double secs, avg;
+	FILE *in;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-b") == 0) && (i + 1 < argc))
+		{
+			baud = strtoul(argv[++i], NULL, 10);
+		}
+		else if ((strcmp(argv[i], "-c") == 0) && (i + 1 < argc))
+		{
+			d.dir = argv[++i];
+		}
+		else if ((strcmp(argv[i], "-t") == 0) && (i + 1 < argc))
+		{
+			tasks_path = argv[++i];
+		}
+		else if (in_path == NULL)
+		{
+			in_path = argv[i];
+		}
+		else
+		{
+			csv_path = argv[i];
+		}
+	}
+
+	if (in_path == NULL)
+	{
+		fprintf(stderr, "uso: %s [-b baud] [-c dir] [-t tasks.csv] captura.bin [saida.csv]\n", argv[0]);
+		return 1;
+	}
+
+	in = fopen(in_path, "rb");
+	if (in == NULL)
+	{
+		perror(in_path);
+		return 1;
+	}
+
+	if (csv_path != NULL)
+	{
+		d.csv = fopen(csv_path, "w");
+		if (d.csv == NULL)
+		{
+			perror(csv_path);
+			fclose(in);
+			return 1;
+		}
+	}
+
+	if (tasks_path != NULL)
+	{
+		d.tasks = fopen(tasks_path, "w");
+		if (d.tasks == NULL)
+		{
+			perror(tasks_path);
+			fclose(in);
+			return 1;
+		}
+		fprintf(d.tasks, "time_ms,snapshot,number,task,state,prio,cpu_pct,stack_free,heap_free,heap_min,load_pct\n");
+	}
+
+	if (d.dir != NULL)
+	{
+		mkdir(d.dir, 0755);
+	}
+
+	d.schema.version = -1;
+
+	while ((got = fread(&buf[have], 1, sizeof(buf) - have, in)) > 0)
+	{
+		have += got;
+		used = Decode_Buffer(&d, buf, have);
+
+		/* Guarda um quadro incompleto para a proxima leitura */
+		memmove(buf, &buf[used], have - used);
+		have -= used;
+	}
+	d.noise += have;
+
+	Decode_CloseColumns(&d);
+	if (d.csv != NULL)
+	{
+		fclose(d.csv);
+	}
+	if (d.tasks != NULL)
+	{
+		fclose(d.tasks);
+	}
+	fclose(in);
+
+	data_frames = d.frames[TLM_FRAME_FULL] + d.frames[TLM_FRAME_DELTA];
+	secs = (double) (d.ts - d.first_ts) / 1000.0;
+	avg = (data_frames > 0) ? (double) d.data_bytes / (double) data_frames : 0.0;
+
+	fprintf(stderr, "schema    %lu frames, %u signals, version %d\n", d.frames[TLM_FRAME_SCHEMA], d.schema.count, d.schema.version);
+	fprintf(stderr, "data      %lu frames (full %lu, delta %lu)\n", data_frames, d.frames[TLM_FRAME_FULL], d.frames[TLM_FRAME_DELTA]);
+	fprintf(stderr, "lost      %lu frames, skipped %lu, crc errors %lu, other bytes %lu\n", d.lost, d.skipped, d.crc_errors, d.noise);
+	fprintf(stderr, "size      %.1f bytes/frame\n", avg);
+	if (d.frames[TLM_FRAME_SYSTEM] > 0)
+	{
+		fprintf(stderr, "tasks     %lu snapshots (%lu complete), %lu task frames\n",
+				d.frames[TLM_FRAME_SYSTEM], d.snapshots, d.frames[TLM_FRAME_TASK]);
+	}
+	if (secs > 0.0)
+	{
+		fprintf(stderr, "rate      %.1f frames/s over %.1f s\n", (double) data_frames / secs, secs);
+	}
+	if (avg > 0.0)
+	{
+		/* 8N1: 10 bits por byte */
+		fprintf(stderr, "limit     %.0f frames/s at %lu baud\n", (double) baud / 10.0 / avg, baud);
+	}
+
+	return 0;
+}
@@ -0,0 +1,498 @@
+/**
+ * @file    tsync_host.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Lado do PC da sincronizacao de relogio com a placa pela serial
+ * @details
+ * Manda os pedidos "tsync <seq> <t1> <t4>" para o shell da placa e fecha
+ * cada troca com o mesmo estimador do firmware (Application/Libs/timesync),
+ * imprimindo o offset (placa - PC), o drift e o erro estimado. O relogio do
+ * PC e o CLOCK_MONOTONIC em us: e nele que a placa passa a converter os
+ * carimbos das amostras ("get", "vib"). O texto do shell e a telemetria no
+ * meio da serial sao ignorados: so linhas que comecam com "tsync " contam.
+ *
+ * Com -s a placa e simulada num pseudo-terminal (processo filho) com offset,
+ * drift e atrasos de ida e volta aleatorios e assimetricos conhecidos; no fim
+ * o erro real da reta e conferido contra o erro informado.
+ *
+ * Compilacao:
+ *   gcc -O2 -Wall -I../../Application/Libs tsync_host.c \
+ *       ../../Application/Libs/timesync/timesync.c -lm -o tsync_host
+ *
+ * Uso:
+ *   ./tsync_host [-b baud] [-n trocas] [-p ms] /dev/ttyACM0
+ *   ./tsync_host -s [-n trocas] [-p ms]
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#define _XOPEN_SOURCE 600
+#define _DEFAULT_SOURCE
+
+#include "timesync/timesync.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define HOST_LINE_SIZE			256
+#define HOST_REPLY_TIMEOUT_MS	1000
+
+#define HOST_DEF_BAUD			115200
+#define HOST_DEF_COUNT			30
+#define HOST_DEF_PERIOD_MS		200
+
+/** @brief Placa simulada: offset inicial, drift e atrasos (us) */
+#define SIM_OFFSET_US			5000000LL
+#define SIM_DRIFT_PPM			-37.5
+#define SIM_FORWARD_MAX_US		1000
+#define SIM_PROCESS_MAX_US		800
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Linhas recebidas da serial */
+typedef struct
+{
+	int fd;
+	char buf[HOST_LINE_SIZE];
+	size_t len;
+} HostLink_t;
+
+/** @brief Troca aguardando o t3 da placa */
+typedef struct
+{
+	bool valid;
+	uint32_t seq;
+	int64_t t1;
+	int64_t t2;
+	int64_t t4;
+	uint32_t req_bytes;
+	uint32_t rep_bytes;
+} HostPending_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+/** @brief Origem do relogio da placa simulada (us do PC) */
+static int64_t simEpoch;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Relogio do PC (CLOCK_MONOTONIC) em us. */
+static int64_t Host_Us(void);
+
+/**
+ * Abre a serial em modo cru.
+ * @param path Dispositivo.
+ * @param baud Baud rate.
+ * @return Descritor ou -1.
+ */
+static int Host_Open(const char *path, uint32_t baud);
+
+/** @brief Poe um terminal em modo cru (sem eco nem traducao de fim de linha). */
+static void Host_Raw(int fd);
+
+/**
+ * Le a proxima linha completa.
+ * @param link Serial.
+ * @param line Saida sem o fim de linha.
+ * @param size Tamanho de line.
+ * @param timeout_ms Espera maxima.
+ * @param stamp Chegada do ultimo byte da linha (us do PC).
+ * @return Bytes da linha com o fim de linha, 0 no timeout, -1 com a serial fechada.
+ */
+static int Host_ReadLine(HostLink_t *link, char *line, size_t size, int timeout_ms, int64_t *stamp);
+
+/** @brief Relogio da placa simulada. */
+static int64_t Sim_BoardUs(void);
+
+/**
+ * Placa simulada: responde aos pedidos como o app_timesync.
+ * @param fd Lado escravo do pseudo-terminal.
+ */
+static void Sim_Board(int fd);
+
+/**
+ * Roda as trocas.
+ * @param fd Serial.
+ * @param baud Baud rate (0 = sem serializacao).
+ * @param count Trocas.
+ * @param period_ms Intervalo entre pedidos.
+ * @param ts Estimador.
+ * @return Trocas sem resposta.
+ */
+static uint32_t Host_Run(int fd, uint32_t baud, uint32_t count, uint32_t period_ms, TSync_t *ts);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static int64_t Host_Us(void)
+{
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+
+	return (int64_t) t.tv_sec * 1000000LL + t.tv_nsec / 1000;
+}
+
+static void Host_Raw(int fd)
+{
+	struct termios tio;
+
+	if (tcgetattr(fd, &tio) == 0)
+	{
+		cfmakeraw(&tio);
+		tio.c_cc[VMIN] = 1;
+		tio.c_cc[VTIME] = 0;
+		tcsetattr(fd, TCSANOW, &tio);
+	}
+}
+
+static int Host_Open(const char *path, uint32_t baud)
+{
+	static const struct
+	{
+		uint32_t baud;
+		speed_t speed;
+	} speeds[] = { { 9600, B9600 }, { 19200, B19200 }, { 38400, B38400 }, { 57600, B57600 },
+			{ 115200, B115200 }, { 230400, B230400 }, { 460800, B460800 }, { 921600, B921600 } };
+	struct termios tio;
+	size_t i;
+	int fd;
+
+	fd = open(path, O_RDWR | O_NOCTTY);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	Host_Raw(fd);
+
+	for (i = 0; i < (sizeof(speeds) / sizeof(speeds[0])); i++)
+	{
+		if ((speeds[i].baud == baud) && (tcgetattr(fd, &tio) == 0))
+		{
+			cfsetispeed(&tio, speeds[i].speed);
+			cfsetospeed(&tio, speeds[i].speed);
+			tcsetattr(fd, TCSANOW, &tio);
+		}
+	}
+
+	tcflush(fd, TCIOFLUSH);
+
+	return fd;
+}
+
+static int Host_ReadLine(HostLink_t *link, char *line, size_t size, int timeout_ms, int64_t *stamp)
+{
+	struct pollfd pfd = { link->fd, POLLIN, 0 };
+	int64_t deadline = Host_Us() + (int64_t) timeout_ms * 1000LL;
+	char *end;
+	size_t n;
+	ssize_t r;
+	int wait;
+
+	for (;;)
+	{
+		end = memchr(link->buf, '\n', link->len);
+		if (end != NULL)
+		{
+			n = (size_t) (end - link->buf) + 1;
+
+			/* Sem o \r\n; a telemetria binaria vira lixo que nao comeca com "tsync " */
+			snprintf(line, size, "%.*s", (int) ((n > 1) && (end[-1] == '\r') ? n - 2 : n - 1), link->buf);
+			memmove(link->buf, &link->buf[n], link->len - n);
+			link->len -= n;
+
+			return (int) n;
+		}
+
+		/* Linha maior que o buffer: descarta */
+		if (link->len == sizeof(link->buf))
+		{
+			link->len = 0;
+		}
+
+		wait = (int) ((deadline - Host_Us()) / 1000);
+		if ((wait <= 0) || (poll(&pfd, 1, wait) <= 0))
+		{
+			return 0;
+		}
+
+		r = read(link->fd, &link->buf[link->len], sizeof(link->buf) - link->len);
+		*stamp = Host_Us();
+
+		if ((r < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+		if (r <= 0)
+		{
+			return -1;
+		}
+
+		link->len += (size_t) r;
+	}
+}
+
+static int64_t Sim_BoardUs(void)
+{
+	double elapsed = (double) (Host_Us() - simEpoch);
+
+	return SIM_OFFSET_US + (int64_t) (elapsed * (1.0 + SIM_DRIFT_PPM * 1e-6));
+}
+
+static void Sim_Board(int fd)
+{
+	HostLink_t link = { fd, { 0 }, 0 };
+	char line[HOST_LINE_SIZE], reply[HOST_LINE_SIZE], echo[HOST_LINE_SIZE];
+	int64_t t1, t2, t4, pending = 0, stamp;
+	unsigned int seq;
+	int len;
+
+	Host_Raw(fd);
+	srand((unsigned int) getpid());
+
+	for (;;)
+	{
+		if (Host_ReadLine(&link, line, sizeof(line), 60000, &stamp) < 0)
+		{
+			break;
+		}
+
+		if (sscanf(line, "tsync %u %" SCNd64 " %" SCNd64, &seq, &t1, &t4) != 3)
+		{
+			continue;
+		}
+
+		/* Ida mais lenta que a volta: o offset de cada troca erra ate metade do atraso */
+		usleep((useconds_t) (rand() % SIM_FORWARD_MAX_US));
+		t2 = Sim_BoardUs();
+
+		/* Tempo no shell: nao entra no atraso */
+		usleep((useconds_t) (rand() % SIM_PROCESS_MAX_US));
+
+		/* O shell ecoa o comando antes da resposta, como na placa */
+		len = snprintf(echo, sizeof(echo), "$ %s\n", line);
+		if (write(fd, echo, (size_t) len) != len)
+		{
+			break;
+		}
+
+		len = snprintf(reply, sizeof(reply), "tsync %u %" PRId64 " %" PRId64 "\r\n", seq, t2, pending);
+		pending = Sim_BoardUs();
+		if (write(fd, reply, (size_t) len) != len)
+		{
+			break;
+		}
+	}
+
+	close(fd);
+}
+
+static uint32_t Host_Run(int fd, uint32_t baud, uint32_t count, uint32_t period_ms, TSync_t *ts)
+{
+	HostLink_t link = { fd, { 0 }, 0 };
+	HostPending_t prev = { 0 };
+	char req[HOST_LINE_SIZE], line[HOST_LINE_SIZE];
+	int64_t t1, t2, t3, t4 = 0;
+	unsigned int seq_rx;
+	uint32_t seq, lost = 0;
+	int len, n;
+
+	TSync_Init(ts, baud);
+
+	printf("%6s %14s %12s %10s %10s %6s\n", "seq", "offset us", "drift ppm", "erro us", "atraso us", "usadas");
+
+	for (seq = 1; seq <= count; seq++)
+	{
+		/* t1 e o inicio do envio; o t4 vai so se a troca anterior foi respondida */
+		t1 = Host_Us();
+		len = snprintf(req, sizeof(req), "tsync %u %" PRId64 " %" PRId64 "\n", seq, t1,
+				(prev.valid && (prev.seq == (seq - 1))) ? prev.t4 : (int64_t) 0);
+		if (write(fd, req, (size_t) len) != len)
+		{
+			fprintf(stderr, "erro ao escrever: %s\n", strerror(errno));
+			break;
+		}
+
+		do
+		{
+			n = Host_ReadLine(&link, line, sizeof(line), HOST_REPLY_TIMEOUT_MS, &t4);
+		} while ((n > 0) && ((sscanf(line, "tsync %u %" SCNd64 " %" SCNd64, &seq_rx, &t2, &t3) != 3)
+				|| (seq_rx != seq)));
+
+		if (n <= 0)
+		{
+			lost++;
+			prev.valid = false;
+			printf("%6u sem resposta\n", seq);
+			if (n < 0)
+			{
+				break;
+			}
+			continue;
+		}
+
+		/* O t3 da resposta e o da troca anterior: agora ela fecha */
+		if (prev.valid && (prev.seq == (seq - 1)) && (t3 != 0))
+		{
+			TSync_Add(ts, prev.t1, prev.t2, t3, prev.t4, prev.req_bytes, prev.rep_bytes);
+
+			printf("%6u %14.1f %12.3f %10.1f %10.1f %3u/%u\n", prev.seq, ts->est.offset_us, ts->est.drift * 1e6,
+					ts->est.error_us, ts->est.delay_us, ts->est.used, ts->count);
+		}
+
+		prev.valid = true;
+		prev.seq = seq;
+		prev.t1 = t1;
+		prev.t2 = t2;
+		prev.t4 = t4;
+		prev.req_bytes = (uint32_t) len;
+		prev.rep_bytes = (uint32_t) n;
+
+		usleep(period_ms * 1000U);
+	}
+
+	return lost;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	TSync_t ts;
+	uint32_t baud = HOST_DEF_BAUD, count = HOST_DEF_COUNT, period = HOST_DEF_PERIOD_MS, lost;
+	const char *path = NULL;
+	bool sim = false;
+	int64_t now, truth, guess;
+	double err;
+	pid_t child = -1;
+	int fd, slave, opt;
+
+	while ((opt = getopt(argc, argv, "b:n:p:s")) != -1)
+	{
+		switch (opt)
+		{
+		case 'b':
+			baud = (uint32_t) strtoul(optarg, NULL, 10);
+			break;
+		case 'n':
+			count = (uint32_t) strtoul(optarg, NULL, 10);
+			break;
+		case 'p':
+			period = (uint32_t) strtoul(optarg, NULL, 10);
+			break;
+		case 's':
+			sim = true;
+			break;
+		default:
+			fprintf(stderr, "uso: %s [-b baud] [-n trocas] [-p ms] <serial> | -s [-n trocas] [-p ms]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	if (sim == true)
+	{
+		/* Pseudo-terminal: o filho e a placa, sem tempo de serializacao */
+		fd = posix_openpt(O_RDWR | O_NOCTTY);
+		if ((fd < 0) || (grantpt(fd) != 0) || (unlockpt(fd) != 0))
+		{
+			fprintf(stderr, "sem pseudo-terminal: %s\n", strerror(errno));
+			return 1;
+		}
+		Host_Raw(fd);
+		path = ptsname(fd);
+
+		simEpoch = Host_Us();
+		baud = 0;
+
+		child = fork();
+		if (child == 0)
+		{
+			close(fd);
+			slave = open(path, O_RDWR | O_NOCTTY);
+			if (slave >= 0)
+			{
+				Sim_Board(slave);
+			}
+			_exit(0);
+		}
+
+		printf("placa simulada: offset %" PRId64 " us, drift %.1f ppm, ida ate %d us a mais\n", (int64_t) SIM_OFFSET_US,
+				SIM_DRIFT_PPM, SIM_FORWARD_MAX_US);
+	}
+	else
+	{
+		if (optind >= argc)
+		{
+			fprintf(stderr, "falta a serial (ou -s)\n");
+			return 2;
+		}
+
+		path = argv[optind];
+		fd = Host_Open(path, baud);
+		if (fd < 0)
+		{
+			fprintf(stderr, "%s: %s\n", path, strerror(errno));
+			return 1;
+		}
+	}
+
+	lost = Host_Run(fd, baud, count, period, &ts);
+
+	printf("\n%u trocas, %u aceitas, %u descartadas, %u sem resposta\n", count, ts.exchanges, ts.rejected, lost);
+
+	if (sim == false)
+	{
+		close(fd);
+		return (ts.est.valid == true) ? 0 : 1;
+	}
+
+	close(fd);
+	kill(child, SIGTERM);
+	waitpid(child, NULL, 0);
+
+	if (ts.est.valid == false)
+	{
+		printf("\nFALHOU\n");
+		return 1;
+	}
+
+	/* Relogio real da placa contra o da reta, agora */
+	now = Host_Us();
+	truth = SIM_OFFSET_US + (int64_t) ((double) (now - simEpoch) * (1.0 + SIM_DRIFT_PPM * 1e-6));
+	guess = TSync_RefToDev(&ts.est, now);
+	err = fabs((double) (guess - truth));
+
+	printf("drift %.3f ppm (real %.1f), erro real %.1f us, informado %.1f us\n", ts.est.drift * 1e6, SIM_DRIFT_PPM,
+			err, ts.est.error_us);
+	printf("\n%s\n", (err <= ts.est.error_us) ? "OK" : "FALHOU");
+
+	return (err <= ts.est.error_us) ? 0 : 1;
+}
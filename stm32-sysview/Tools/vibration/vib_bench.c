@@ -0,0 +1,283 @@
+/**
+ * @file    vib_bench.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Confere e mede no PC a FFT e as caracteristicas de Libs/vibration
+ * @details
+ * Compilar (dentro de Tools/vibration):
+ *
+ *   gcc -O2 -Wall -DFFT_USE_RADIX4=1 -I../../Application/Libs vib_bench.c \
+ *       ../../Application/Libs/vibration/vibration.c \
+ *       ../../Application/Libs/fft/fft.c -lm -o vib_bench
+ *
+ * Uso: ./vib_bench [taxa_hz]   (padrao 833, o ODR usado no alvo)
+ *
+ * FFT_USE_RADIX4=1 forca no PC o mesmo caminho do alvo. Para 256 a 2048
+ * pontos compara Fft_Real (radix-2^2) com Fft_RealRef (radix-2) e mede o
+ * tempo de cada uma. Depois gera quadros com gravidade, duas senoides,
+ * ruido e a quantizacao do LSM6DSL em 2 g e confere RMS, bandas, picos e
+ * velocidade RMS contra os valores analiticos.
+ *
+ * O tempo medido e o do PC; no alvo o comando "vib bench" mostra os ciclos
+ * por tamanho medidos com o DWT.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "vibration/vibration.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define BENCH_PI				3.14159265358979
+
+#define BENCH_MIN_SECONDS		0.2
+
+/** @brief Quantizacao do acelerometro em 2 g: 61 ug por LSB em m/s2 */
+#define BENCH_LSB_MS2			(61e-6 * 9.80665)
+
+#define BENCH_NOISE_MS2			0.02
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Senoide do sinal de teste */
+typedef struct
+{
+	double hz;
+	double amplitude;       /**< m/s2 de pico */
+} BenchTone_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static float work[VIB_WORK_SIZE(VIB_MAX_SIZE)];
+static float ref[VIB_MAX_SIZE];
+static float input[VIB_MAX_SIZE];
+
+static const BenchTone_t tones[] = { { 49.7, 2.0 }, { 157.3, 0.5 } };
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Segundos de um relogio monotonico. */
+static double Bench_Now(void);
+
+/** @brief Ruido gaussiano de desvio 1 (Box-Muller). */
+static double Bench_Gauss(void);
+
+/**
+ * Tempo medio de uma transformada.
+ * @param plan Plano.
+ * @param ref_path true para Fft_RealRef.
+ * @return us por FFT.
+ */
+static double Bench_Time(const FftPlan_t *plan, bool ref_path);
+
+/**
+ * Gera, processa e confere um quadro.
+ * @param n Pontos.
+ * @param rate Taxa de amostragem.
+ * @return Erros encontrados.
+ */
+static int Bench_Features(uint16_t n, double rate);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static double Bench_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (double) ts.tv_sec + (double) ts.tv_nsec * 1e-9;
+}
+
+static double Bench_Gauss(void)
+{
+	double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+	double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+	return sqrt(-2.0 * log(u1)) * cos(2.0 * BENCH_PI * u2);
+}
+
+static double Bench_Time(const FftPlan_t *plan, bool ref_path)
+{
+	double start = Bench_Now();
+	double elapsed;
+	uint32_t runs = 0;
+
+	do
+	{
+		/* A entrada e refeita a cada rodada para os valores nao crescerem */
+		memcpy(ref, input, plan->n * sizeof(float));
+
+		if (ref_path)
+		{
+			Fft_RealRef(plan, ref);
+		}
+		else
+		{
+			Fft_Real(plan, ref);
+		}
+
+		runs++;
+		elapsed = Bench_Now() - start;
+	} while (elapsed < BENCH_MIN_SECONDS);
+
+	return elapsed * 1e6 / runs;
+}
+
+static int Bench_Features(uint16_t n, double rate)
+{
+	static const VibBand_t bands[] = { { 10.0f, 100.0f }, { 100.0f, 300.0f } };
+	VibResult_t r;
+	Vib_t vib;
+	float *x;
+	double t, v, rms, vel, band0, band1;
+	double tol_hz;
+	int errors = 0;
+	uint16_t i;
+	uint8_t k;
+
+	if ((Vib_Init(&vib, n, (float) rate, FFT_WINDOW_HANN, work) == false) || (Vib_SetBands(&vib, bands, 2) == false))
+	{
+		printf("FAIL: init n=%u\n", n);
+		return 1;
+	}
+
+	x = Vib_Frame(&vib);
+	for (i = 0; i < n; i++)
+	{
+		t = i / rate;
+		v = 9.80665 + BENCH_NOISE_MS2 * Bench_Gauss();
+
+		for (k = 0; k < sizeof(tones) / sizeof(tones[0]); k++)
+		{
+			v += tones[k].amplitude * sin(2.0 * BENCH_PI * tones[k].hz * t + k);
+		}
+
+		/* Como o firmware: contagens do registrador -> m/s2 */
+		x[i] = (float) (floor(v / BENCH_LSB_MS2 + 0.5) * BENCH_LSB_MS2);
+	}
+
+	Vib_Process(&vib, &r);
+
+	/* Valores analiticos */
+	rms = BENCH_NOISE_MS2 * BENCH_NOISE_MS2;
+	vel = 0.0;
+	for (k = 0; k < sizeof(tones) / sizeof(tones[0]); k++)
+	{
+		rms += tones[k].amplitude * tones[k].amplitude / 2.0;
+		v = tones[k].amplitude / (2.0 * BENCH_PI * tones[k].hz);
+		vel += v * v / 2.0;
+	}
+	rms = sqrt(rms);
+	vel = 1000.0 * sqrt(vel);
+	band0 = tones[0].amplitude / sqrt(2.0);
+	band1 = tones[1].amplitude / sqrt(2.0);
+	tol_hz = 0.1 * rate / n;
+
+	printf("%5u %8.3f %8.3f %8.3f %8.3f %8.3f %8.2f %8.2f %8.3f %8.3f\n", n, r.resolution_hz, r.rms, r.band_rms[0],
+			r.band_rms[1], r.velocity_rms, r.peak_hz[0], r.peak_hz[1], r.peak_rms[0], r.peak_rms[1]);
+
+	if ((fabs(r.rms - rms) > 0.02 * rms) || (fabs(r.band_rms[0] - band0) > 0.02 * band0)
+			|| (fabs(r.band_rms[1] - band1) > 0.02 * band1) || (fabs(r.velocity_rms - vel) > 0.03 * vel))
+	{
+		printf("FAIL: esperado rms %.3f bandas %.3f %.3f vel %.3f\n", rms, band0, band1, vel);
+		errors++;
+	}
+
+	for (k = 0; k < 2; k++)
+	{
+		if ((fabs(r.peak_hz[k] - tones[k].hz) > tol_hz)
+				|| (fabs(r.peak_rms[k] - tones[k].amplitude / sqrt(2.0)) > 0.03 * tones[k].amplitude))
+		{
+			printf("FAIL: pico %u em %.2f Hz (%.3f), esperado %.2f Hz +- %.2f\n", k, r.peak_hz[k], r.peak_rms[k],
+					tones[k].hz, tol_hz);
+			errors++;
+		}
+	}
+
+	return errors;
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	FftPlan_t plan;
+	double rate = 833.0;
+	double us, us_ref, err, peak;
+	int errors = 0;
+	uint16_t n, i;
+
+	if (argc > 1)
+	{
+		rate = atof(argv[1]);
+	}
+
+	srand(1);
+
+	printf("%5s %10s %10s %8s %12s\n", "n", "r2^2 us", "r2 us", "ganho", "erro max");
+	for (n = VIB_MIN_SIZE; n <= VIB_MAX_SIZE; n *= 2)
+	{
+		Fft_Init(&plan, n, work + n);
+
+		for (i = 0; i < n; i++)
+		{
+			input[i] = (float) Bench_Gauss();
+		}
+
+		memcpy(work, input, n * sizeof(float));
+		memcpy(ref, input, n * sizeof(float));
+		Fft_Real(&plan, work);
+		Fft_RealRef(&plan, ref);
+
+		for (err = 0.0, peak = 0.0, i = 0; i < n; i++)
+		{
+			err = fmax(err, fabs(work[i] - ref[i]));
+			peak = fmax(peak, fabs(ref[i]));
+		}
+
+		us = Bench_Time(&plan, false);
+		us_ref = Bench_Time(&plan, true);
+		printf("%5u %10.2f %10.2f %7.2fx %12.2e\n", n, us, us_ref, us_ref / us, err / peak);
+
+		if (err > 1e-5 * peak)
+		{
+			printf("FAIL: radix-2^2 difere da referencia\n");
+			errors++;
+		}
+	}
+
+	printf("\ntaxa %.1f Hz, tons %.1f Hz (%.1f m/s2) e %.1f Hz (%.1f m/s2)\n", rate, tones[0].hz, tones[0].amplitude,
+			tones[1].hz, tones[1].amplitude);
+	printf("%5s %8s %8s %8s %8s %8s %8s %8s %8s %8s\n", "n", "df", "rms", "b10-100", "b100-300", "vel", "pico0",
+			"pico1", "rms0", "rms1");
+	for (n = VIB_MIN_SIZE; n <= VIB_MAX_SIZE; n *= 2)
+	{
+		errors += Bench_Features(n, rate);
+	}
+
+	printf("\n%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * @file    setup_hw.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Substitui Application/Setup/setup_hw.h para compilar drivers no PC
+ * @details
+ * Declara so o que os drivers de Application/Libs usam do HAL, do CMSIS-OS e
+ * do debug. As funcoes sao implementadas pelo modelo (vl53l0x_model.c), que
+ * responde as transacoes I2C a partir de um mapa de registradores.
+ */
+
+#ifndef _SETUP_HW_H_
+#define _SETUP_HW_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdio.h>
+
+//==============================================================================
+// PUBLIC DEFINITIONS
+//==============================================================================
+
+#define I2C_MEMADD_SIZE_8BIT		1
+
+#define VL53L0X_XSHUT_Pin			0x0040
+#define VL53L0X_XSHUT_GPIO_Port		GPIOC
+#define VL53L0X_GPIO1_EXTI7_Pin		0x0080
+#define VL53L0X_GPIO1_EXTI7_GPIO_Port GPIOC
+
+#define GPIOC						(&host_gpioc)
+
+#define DBG(fmt, ...)				fprintf(stderr, fmt "\n", ##__VA_ARGS__)
+
+/* Um unico contexto no PC: nada a proteger */
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+typedef enum
+{
+	HAL_OK = 0,
+	HAL_ERROR,
+	HAL_BUSY,
+	HAL_TIMEOUT
+} HAL_StatusTypeDef;
+
+typedef enum
+{
+	GPIO_PIN_RESET = 0,
+	GPIO_PIN_SET
+} GPIO_PinState;
+
+typedef struct
+{
+	uint16_t odr;
+} GPIO_TypeDef;
+
+typedef struct
+{
+	int bus;
+} I2C_HandleTypeDef;
+
+//==============================================================================
+// PUBLIC VARIABLES
+//==============================================================================
+
+extern GPIO_TypeDef host_gpioc;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/** @brief Avanca o tempo simulado */
+void HAL_Delay(uint32_t Delay);
+
+void osDelay(uint32_t millisec);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SETUP_HW_H_ */
@@ -0,0 +1,473 @@
+/**
+ * @file    vl53l0x_model.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelo dos registradores do VL53L0X para rodar o driver no PC
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "vl53l0x_model.h"
+#include "setup_hw.h"
+
+#include <math.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+#define MODEL_I2C_ADDRESS		0x52
+#define MODEL_PAGES				8
+
+/** @brief 400 kHz: 9 bits por byte (ACK incluido) */
+#define MODEL_BIT_NS			2500ULL
+
+/** @brief Status do dispositivo */
+#define MODEL_STATUS_VALID		11
+#define MODEL_STATUS_NO_TARGET	4
+#define MODEL_RANGE_INVALID		8190
+
+/** @brief Valores de fabrica lidos pela inicializacao */
+#define MODEL_STOP_VARIABLE		0x3C
+#define MODEL_SPAD_INFO			0x85    /* 5 SPADs de abertura */
+#define MODEL_OSC_CALIBRATE		64
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+typedef enum
+{
+	MODEL_IDLE = 0,
+	MODEL_SINGLE,
+	MODEL_BACK_TO_BACK,
+	MODEL_TIMED
+} ModelMode_e;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+GPIO_TypeDef host_gpioc;
+
+static uint8_t regs[MODEL_PAGES][256];
+static uint8_t page;
+static bool powered;
+
+static ModelMode_e mode;
+static uint64_t now_us;
+static uint64_t next_us;
+static uint32_t period_us;
+
+static uint32_t target_mm = 600;
+static uint32_t rng = 1;
+static bool trace;
+
+static VL53L0X_ModelStats_t stats;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/** @brief Valores de fabrica. */
+static void Model_Boot(void);
+
+/** @brief Conclui uma medida: resultado, status e GPIO1. */
+static void Model_Complete(void);
+
+/** @brief Escrita com efeito colateral. */
+static void Model_Write(uint8_t reg, uint8_t value);
+
+/** @brief Leitura com efeito colateral. */
+static uint8_t Model_Read(uint8_t reg);
+
+/** @brief Gaussiana com media 0 e desvio 1. */
+static float Model_Gauss(void);
+
+/** @brief Tempo de uma transacao de n bytes mais start, restart e stop. */
+static void Model_Bus(uint32_t bytes);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void Model_Boot(void)
+{
+	memset(regs, 0, sizeof(regs));
+	page = 0;
+	mode = MODEL_IDLE;
+
+	regs[0][0xC0] = 0xEE;
+	regs[0][0xC1] = 0xAA;
+	regs[0][0xC2] = 0x10;
+	regs[0][0x84] = 0x01;
+	regs[0][0xF8] = (uint8_t) (MODEL_OSC_CALIBRATE >> 8);
+	regs[0][0xF9] = (uint8_t) MODEL_OSC_CALIBRATE;
+	memset(&regs[0][0xB0], 0xFF, 6);
+	regs[1][0x91] = MODEL_STOP_VARIABLE;
+	regs[7][0x92] = MODEL_SPAD_INFO;
+}
+
+static float Model_Gauss(void)
+{
+	float u1, u2;
+
+	rng = rng * 1103515245UL + 12345UL;
+	u1 = ((float) ((rng >> 8) & 0xFFFFFF) + 1.0f) / 16777217.0f;
+	rng = rng * 1103515245UL + 12345UL;
+	u2 = (float) ((rng >> 8) & 0xFFFFFF) / 16777216.0f;
+
+	return sqrtf(-2.0f * logf(u1)) * cosf(6.2831853f * u2);
+}
+
+static void Model_Bus(uint32_t bytes)
+{
+	uint64_t ns = (bytes * 9ULL + 3ULL) * MODEL_BIT_NS;
+
+	stats.bytes += bytes;
+	stats.bus_us += ns / 1000ULL;
+	VL53L0X_Model_Advance(ns / 1000ULL);
+}
+
+static void Model_Complete(void)
+{
+	uint8_t *r = regs[0];
+	float budget = (float) VL53L0X_Model_MeasureUs();
+	float limit = (float) ((r[0x44] << 8) | r[0x45]) / 128.0f;
+	float signal, sigma, d;
+	uint16_t range, sig, amb;
+	uint8_t status;
+
+	/* Retorno cai com o quadrado da distancia */
+	signal = 30.0f * (200.0f / (float) target_mm) * (200.0f / (float) target_mm);
+
+	/* Desvio de 0.4% da distancia com 33 ms, caindo com a raiz do orcamento */
+	sigma = 0.004f * (float) target_mm * sqrtf(33000.0f / budget);
+	d = (float) target_mm + sigma * Model_Gauss();
+
+	if (signal >= limit)
+	{
+		status = MODEL_STATUS_VALID;
+		range = (uint16_t) ((d < 0.0f) ? 0.0f : d + 0.5f);
+	}
+	else
+	{
+		status = MODEL_STATUS_NO_TARGET;
+		range = MODEL_RANGE_INVALID;
+	}
+
+	sig = (uint16_t) (signal * 128.0f);
+	amb = (uint16_t) (0.12f * 128.0f);
+
+	if (r[0x13] & 0x07)
+	{
+		stats.overwritten++;
+	}
+
+	r[0x14] = (uint8_t) (status << 3);
+	r[0x16] = 0x05;
+	r[0x17] = 0x00;
+	r[0x1A] = (uint8_t) (sig >> 8);
+	r[0x1B] = (uint8_t) sig;
+	r[0x1C] = (uint8_t) (amb >> 8);
+	r[0x1D] = (uint8_t) amb;
+	r[0x1E] = (uint8_t) (range >> 8);
+	r[0x1F] = (uint8_t) range;
+
+	/* Nova amostra pronta */
+	r[0x13] = 0x04;
+	stats.measurements++;
+}
+
+static void Model_Write(uint8_t reg, uint8_t value)
+{
+	uint32_t period;
+	uint16_t osc;
+
+	if (reg == 0xFF)
+	{
+		page = value & (MODEL_PAGES - 1);
+		return;
+	}
+
+	regs[page][reg] = value;
+
+	if (page == 7)
+	{
+		/* Leitura do NVM: pronta logo apos o pedido */
+		if ((reg == 0x83) && (value == 0x00))
+		{
+			regs[7][0x83] = 0x10;
+		}
+		return;
+	}
+
+	if (page != 0)
+	{
+		return;
+	}
+
+	if (reg == 0x0B)
+	{
+		if (value & 0x01)
+		{
+			regs[0][0x13] = 0x00;
+		}
+		regs[0][0x0B] = 0x00;
+	}
+	else if (reg == 0x00)
+	{
+		/* O bit de start se apaga quando a medida comeca */
+		regs[0][0x00] = value & (uint8_t) ~0x01;
+
+		if (value & 0x02)
+		{
+			mode = MODEL_BACK_TO_BACK;
+			period_us = VL53L0X_Model_MeasureUs();
+			next_us = now_us + period_us;
+		}
+		else if (value & 0x04)
+		{
+			period = ((uint32_t) regs[0][0x04] << 24) | ((uint32_t) regs[0][0x05] << 16) |
+					((uint32_t) regs[0][0x06] << 8) | regs[0][0x07];
+			osc = (uint16_t) ((regs[0][0xF8] << 8) | regs[0][0xF9]);
+
+			mode = MODEL_TIMED;
+			period_us = ((osc != 0) ? period / osc : period) * 1000UL;
+			if (period_us < VL53L0X_Model_MeasureUs())
+			{
+				period_us = VL53L0X_Model_MeasureUs();
+			}
+			next_us = now_us + VL53L0X_Model_MeasureUs();
+		}
+		else if (value & 0x01)
+		{
+			/* Com medidas continuas, SYSRANGE_START = 1 so para */
+			if ((mode == MODEL_BACK_TO_BACK) || (mode == MODEL_TIMED))
+			{
+				mode = MODEL_IDLE;
+			}
+			else
+			{
+				mode = MODEL_SINGLE;
+				next_us = now_us + VL53L0X_Model_MeasureUs();
+			}
+		}
+	}
+}
+
+static uint8_t Model_Read(uint8_t reg)
+{
+	if (reg == 0xFF)
+	{
+		return page;
+	}
+
+	return regs[page][reg];
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+void VL53L0X_Model_Reset(uint32_t seed)
+{
+	memset(&stats, 0, sizeof(stats));
+	memset(&host_gpioc, 0, sizeof(host_gpioc));
+	now_us = 0;
+	rng = seed;
+	powered = false;
+	Model_Boot();
+}
+
+void VL53L0X_Model_SetTarget(uint32_t mm)
+{
+	target_mm = (mm == 0) ? 1 : mm;
+}
+
+void VL53L0X_Model_Advance(uint64_t us)
+{
+	uint64_t end = now_us + us;
+
+	while ((mode != MODEL_IDLE) && (next_us <= end))
+	{
+		now_us = next_us;
+		Model_Complete();
+
+		if (mode == MODEL_SINGLE)
+		{
+			mode = MODEL_IDLE;
+		}
+		else
+		{
+			next_us += period_us;
+		}
+	}
+
+	now_us = end;
+}
+
+uint64_t VL53L0X_Model_Now(void)
+{
+	return now_us;
+}
+
+bool VL53L0X_Model_Gpio1(void)
+{
+	bool active = ((regs[0][0x13] & 0x07) != 0);
+
+	/* 0x84 bit 4: ativo em alto; senao o pino fica em alto ate a amostra */
+	return (regs[0][0x84] & 0x10) ? active : !active;
+}
+
+uint32_t VL53L0X_Model_MeasureUs(void)
+{
+	uint8_t *r = regs[0];
+	uint8_t steps = r[0x01];
+	uint32_t pre_vcsel = (r[0x50] + 1U) << 1;
+	uint32_t final_vcsel = (r[0x70] + 1U) << 1;
+	uint32_t pre_ns = ((2304UL * pre_vcsel * 1655UL) + 500UL) / 1000UL;
+	uint32_t final_ns = ((2304UL * final_vcsel * 1655UL) + 500UL) / 1000UL;
+	uint16_t pre_enc = (uint16_t) ((r[0x51] << 8) | r[0x52]);
+	uint16_t final_enc = (uint16_t) ((r[0x71] << 8) | r[0x72]);
+	uint32_t pre_mclks = ((uint32_t) (pre_enc & 0xFF) << (pre_enc >> 8)) + 1UL;
+	uint32_t final_mclks = ((uint32_t) (final_enc & 0xFF) << (final_enc >> 8)) + 1UL;
+	uint32_t msrc_us = ((r[0x46] + 1UL) * pre_ns + pre_ns / 2) / 1000UL;
+	uint32_t us = 1910 + 960;
+
+	if (steps & 0x10)
+	{
+		us += msrc_us + 590;
+	}
+	if (steps & 0x08)
+	{
+		us += 2 * (msrc_us + 690);
+	}
+	else if (steps & 0x04)
+	{
+		us += msrc_us + 660;
+	}
+	if (steps & 0x40)
+	{
+		us += (pre_mclks * pre_ns + pre_ns / 2) / 1000UL + 660;
+		final_mclks -= pre_mclks;
+	}
+	if (steps & 0x80)
+	{
+		us += (final_mclks * final_ns + final_ns / 2) / 1000UL + 550;
+	}
+
+	return us;
+}
+
+void VL53L0X_Model_GetStats(VL53L0X_ModelStats_t *out)
+{
+	*out = stats;
+}
+
+void VL53L0X_Model_Trace(bool on)
+{
+	trace = on;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint16_t i;
+
+	if ((powered == false) || (DevAddress != MODEL_I2C_ADDRESS))
+	{
+		stats.nacks++;
+		Model_Bus(1);
+		return HAL_ERROR;
+	}
+
+	stats.transfers++;
+	Model_Bus(2U + Size);
+
+	for (i = 0; i < Size; i++)
+	{
+		if (trace)
+		{
+			fprintf(stderr, "%10llu W p%u %02X = %02X\n", (unsigned long long) now_us, page,
+					(unsigned) (MemAddress + i), pData[i]);
+		}
+		Model_Write((uint8_t) (MemAddress + i), pData[i]);
+	}
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+		uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	uint16_t i;
+
+	if ((powered == false) || (DevAddress != MODEL_I2C_ADDRESS))
+	{
+		stats.nacks++;
+		Model_Bus(1);
+		return HAL_ERROR;
+	}
+
+	stats.transfers++;
+	Model_Bus(3U + Size);
+
+	for (i = 0; i < Size; i++)
+	{
+		pData[i] = Model_Read((uint8_t) (MemAddress + i));
+		if (trace)
+		{
+			fprintf(stderr, "%10llu R p%u %02X : %02X\n", (unsigned long long) now_us, page,
+					(unsigned) (MemAddress + i), pData[i]);
+		}
+	}
+
+	return HAL_OK;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (PinState == GPIO_PIN_SET)
+	{
+		GPIOx->odr |= GPIO_Pin;
+	}
+	else
+	{
+		GPIOx->odr &= (uint16_t) ~GPIO_Pin;
+	}
+
+	/* XSHUT: em baixo o sensor perde o estado; a subida e um boot */
+	if ((GPIOx == VL53L0X_XSHUT_GPIO_Port) && (GPIO_Pin & VL53L0X_XSHUT_Pin))
+	{
+		if ((PinState == GPIO_PIN_SET) && (powered == false))
+		{
+			Model_Boot();
+		}
+		powered = (PinState == GPIO_PIN_SET);
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	if ((GPIOx == VL53L0X_GPIO1_EXTI7_GPIO_Port) && (GPIO_Pin == VL53L0X_GPIO1_EXTI7_Pin))
+	{
+		return VL53L0X_Model_Gpio1() ? GPIO_PIN_SET : GPIO_PIN_RESET;
+	}
+
+	return (GPIOx->odr & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	VL53L0X_Model_Advance(Delay * 1000ULL);
+}
+
+void osDelay(uint32_t millisec)
+{
+	VL53L0X_Model_Advance(millisec * 1000ULL);
+}
@@ -0,0 +1,105 @@
+/**
+ * @file    vl53l0x_model.h
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Modelo dos registradores do VL53L0X para rodar o driver no PC
+ * @details
+ * O modelo implementa HAL_I2C_Mem_Read/Write, HAL_GPIO_* e HAL_Delay de
+ * host/setup_hw.h sobre um tempo simulado:
+ *
+ *   - paginas selecionadas por 0xFF, com os valores de fabrica que a
+ *     inicializacao le (modelo, stop variable, SPADs, oscilador);
+ *   - XSHUT em baixo: o sensor nao responde (NACK) e volta ao reset;
+ *   - SYSRANGE_START unico, continuo e temporizado, com a duracao de cada
+ *     medida calculada dos timeouts programados (como no sensor);
+ *   - RESULT_INTERRUPT_STATUS, GPIO1 com a polaridade de 0x84 e o bloco de
+ *     resultado de 12 bytes em 0x14;
+ *   - cada transacao consome o tempo do barramento a 400 kHz.
+ *
+ * A distancia medida e a do alvo mais um ruido que cai com a raiz do
+ * orcamento de tempo; sem sinal suficiente o status indica sem alvo (4) e a distancia 8190.
+ */
+
+#ifndef _VL53L0X_MODEL_H_
+#define _VL53L0X_MODEL_H_
+
+/* C++ detection */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//==============================================================================
+// PUBLIC TYPEDEFS
+//==============================================================================
+
+/** @brief Contadores do barramento e do sensor */
+typedef struct
+{
+	uint32_t transfers;     /**< Transacoes I2C respondidas */
+	uint32_t nacks;         /**< Transacoes sem resposta (XSHUT em baixo) */
+	uint32_t bytes;         /**< Bytes no barramento, enderecos incluidos */
+	uint64_t bus_us;        /**< Tempo de barramento ocupado */
+	uint32_t measurements;  /**< Medidas concluidas */
+	uint32_t overwritten;   /**< Medidas sobrescritas antes de limpar a interrupcao */
+} VL53L0X_ModelStats_t;
+
+//==============================================================================
+// PUBLIC FUNCTIONS
+//==============================================================================
+
+/**
+ * Estado de fabrica, XSHUT em baixo e tempo zero.
+ * @param seed Semente do ruido.
+ */
+void VL53L0X_Model_Reset(uint32_t seed);
+
+/**
+ * Distancia do alvo.
+ * @param mm Distancia real; acima de ~2 m o sinal nao passa no limite.
+ */
+void VL53L0X_Model_SetTarget(uint32_t mm);
+
+/**
+ * Avanca o tempo simulado, concluindo as medidas no caminho.
+ * @param us Microssegundos.
+ */
+void VL53L0X_Model_Advance(uint64_t us);
+
+/** @brief Tempo simulado em us. */
+uint64_t VL53L0X_Model_Now(void);
+
+/** @brief Nivel do GPIO1. */
+bool VL53L0X_Model_Gpio1(void);
+
+/**
+ * Duracao de uma medida calculada dos registradores programados.
+ * @return us.
+ */
+uint32_t VL53L0X_Model_MeasureUs(void);
+
+/**
+ * Copia os contadores.
+ * @param stats Saida.
+ */
+void VL53L0X_Model_GetStats(VL53L0X_ModelStats_t *stats);
+
+/**
+ * Liga o registro de cada transacao em stderr.
+ * @param on true para registrar.
+ */
+void VL53L0X_Model_Trace(bool on);
+
+/* C++ detection */
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _VL53L0X_MODEL_H_ */
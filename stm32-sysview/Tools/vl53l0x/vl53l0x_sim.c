@@ -0,0 +1,286 @@
+/**
+ * @file    vl53l0x_sim.c
+ * @author  Jorge Guzman
+ * @date    Oct 19, 2026
+ * @version 0.1.0
+ * @brief   Roda o driver do VL53L0X contra o modelo de registradores no PC
+ * @details
+ * Compilar (dentro de Tools/vl53l0x):
+ *
+ *   gcc -O2 -Wall -Ihost -I../../Application/Libs vl53l0x_sim.c vl53l0x_model.c \
+ *       ../../Application/Libs/vl53l0x/vl53l0x.c -lm -o vl53l0x_sim
+ *
+ * Uso: ./vl53l0x_sim [-t] [distancia_mm]
+ *
+ *   -t  registra cada transacao I2C em stderr
+ *
+ * Percorre probe e inicializacao pelo VL53L0X_Driver, mede com varios
+ * orcamentos de tempo lendo o resultado na subida do GPIO1 (como a task de
+ * app_range.c) e confere os modos temporizado, unico e o caminho do registro.
+ */
+
+//==============================================================================
+// INCLUDE FILES
+//==============================================================================
+
+#include "vl53l0x/vl53l0x.h"
+#include "vl53l0x_model.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//==============================================================================
+// PRIVATE DEFINITIONS
+//==============================================================================
+
+/** @brief Passo do tempo simulado entre leituras do GPIO1 */
+#define SIM_STEP_US			100
+
+#define SIM_RUN_US			2000000ULL
+
+//==============================================================================
+// PRIVATE TYPEDEFS
+//==============================================================================
+
+/** @brief Resultado de uma rodada */
+typedef struct
+{
+	uint32_t samples;
+	uint32_t invalid;
+	double mean;
+	double m2;
+	VL53L0X_ModelStats_t bus;
+} SimRun_t;
+
+//==============================================================================
+// PRIVATE VARIABLES
+//==============================================================================
+
+static I2C_HandleTypeDef hi2c;
+
+//==============================================================================
+// PRIVATE FUNCTIONS
+//==============================================================================
+
+/**
+ * Le o resultado a cada subida do GPIO1 durante um intervalo.
+ * @param us Duracao simulada.
+ * @param run Saida.
+ */
+static void Sim_Run(uint64_t us, SimRun_t *run);
+
+/** @brief Diferenca entre duas leituras dos contadores do modelo. */
+static void Sim_Delta(const VL53L0X_ModelStats_t *a, const VL53L0X_ModelStats_t *b, VL53L0X_ModelStats_t *d);
+
+//==============================================================================
+// PRIVATE SOURCE CODE
+//==============================================================================
+
+static void Sim_Delta(const VL53L0X_ModelStats_t *a, const VL53L0X_ModelStats_t *b, VL53L0X_ModelStats_t *d)
+{
+	d->transfers = b->transfers - a->transfers;
+	d->nacks = b->nacks - a->nacks;
+	d->bytes = b->bytes - a->bytes;
+	d->bus_us = b->bus_us - a->bus_us;
+	d->measurements = b->measurements - a->measurements;
+	d->overwritten = b->overwritten - a->overwritten;
+}
+
+static void Sim_Run(uint64_t us, SimRun_t *run)
+{
+	VL53L0X_ModelStats_t before, after;
+	VL53L0X_Result_t result;
+	uint64_t end = VL53L0X_Model_Now() + us;
+	bool level = VL53L0X_Model_Gpio1();
+	bool now;
+	double delta;
+
+	memset(run, 0, sizeof(*run));
+	VL53L0X_Model_GetStats(&before);
+
+	while (VL53L0X_Model_Now() < end)
+	{
+		VL53L0X_Model_Advance(SIM_STEP_US);
+
+		/* EXTI7 na borda de subida */
+		now = VL53L0X_Model_Gpio1();
+		if ((now == true) && (level == false))
+		{
+			if (VL53L0X_ReadResult(VL53L0X_I2C_ADDRESS, &result) == HAL_OK)
+			{
+				run->samples++;
+				if (result.status != VL53L0X_RANGE_VALID)
+				{
+					run->invalid++;
+				}
+				else
+				{
+					delta = result.range_mm - run->mean;
+					run->mean += delta / (run->samples - run->invalid);
+					run->m2 += delta * (result.range_mm - run->mean);
+				}
+			}
+		}
+		level = VL53L0X_Model_Gpio1();
+	}
+
+	VL53L0X_Model_GetStats(&after);
+	Sim_Delta(&before, &after, &run->bus);
+}
+
+//==============================================================================
+// PUBLIC SOURCE CODE
+//==============================================================================
+
+int main(int argc, char **argv)
+{
+	static const uint32_t budgets[] = { 20000, 33000, 66000, 200000 };
+	VL53L0X_ModelStats_t before, after, d;
+	VL53L0X_Result_t result;
+	SimRun_t run;
+	uint32_t target = 600;
+	uint32_t valid;
+	int32_t raw;
+	int errors = 0;
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0)
+		{
+			VL53L0X_Model_Trace(true);
+		}
+		else
+		{
+			target = (uint32_t) strtoul(argv[i], NULL, 0);
+		}
+	}
+
+	VL53L0X_Model_Reset(1);
+	VL53L0X_Model_SetTarget(target);
+	VL53L0X_attach(&hi2c);
+
+	/* Sem XSHUT o sensor nao responde */
+	if (VL53L0X_ReadID(VL53L0X_I2C_ADDRESS) == VL53L0X_MODEL_ID)
+	{
+		printf("FAIL: sensor respondeu com XSHUT em baixo\n");
+		errors++;
+	}
+
+	VL53L0X_Model_GetStats(&before);
+	if ((VL53L0X_Driver.probe() != HAL_OK) || (VL53L0X_Driver.init() != HAL_OK))
+	{
+		printf("FAIL: probe/init\n");
+		return 1;
+	}
+	VL53L0X_Model_GetStats(&after);
+	Sim_Delta(&before, &after, &d);
+
+	printf("init: %u transacoes, %u bytes, %llu us de barramento, %.1f ms no total\n",
+			d.transfers, d.bytes, (unsigned long long) d.bus_us, VL53L0X_Model_Now() / 1000.0);
+	printf("orcamento: driver %u us, modelo %u us\n", VL53L0X_GetTimingBudget(), VL53L0X_Model_MeasureUs());
+
+	/* Medidas emendadas com cada orcamento */
+	printf("\n%8s %8s %8s %8s %8s %8s %8s %8s\n", "budget", "med_us", "Hz", "mean", "std", "tr/amo", "B/amo", "bus_us");
+	for (i = 0; i < (int) (sizeof(budgets) / sizeof(budgets[0])); i++)
+	{
+		if (VL53L0X_SetTimingBudget(VL53L0X_I2C_ADDRESS, budgets[i]) != HAL_OK)
+		{
+			printf("FAIL: budget %u\n", budgets[i]);
+			errors++;
+			continue;
+		}
+
+		VL53L0X_StartContinuous(VL53L0X_I2C_ADDRESS, 0);
+		Sim_Run(SIM_RUN_US, &run);
+		VL53L0X_StopContinuous(VL53L0X_I2C_ADDRESS);
+
+		valid = run.samples - run.invalid;
+		printf("%8u %8u %8.1f %8.1f %8.2f %8.2f %8.1f %8.1f\n", budgets[i], VL53L0X_Model_MeasureUs(),
+				run.samples / (SIM_RUN_US / 1e6), run.mean, (valid > 1) ? sqrt(run.m2 / (valid - 1)) : 0.0,
+				(double) run.bus.transfers / (run.samples ? run.samples : 1),
+				(double) run.bus.bytes / (run.samples ? run.samples : 1),
+				(double) run.bus.bus_us / (run.samples ? run.samples : 1));
+
+		if ((run.samples == 0) || (run.bus.overwritten != 0) || (fabs(run.mean - target) > 5.0 && valid > 0))
+		{
+			printf("FAIL: %u amostras, %u sobrescritas\n", run.samples, run.bus.overwritten);
+			errors++;
+		}
+	}
+
+	/* Temporizado a 100 ms */
+	VL53L0X_SetTimingBudget(VL53L0X_I2C_ADDRESS, VL53L0X_BUDGET_DEFAULT_US);
+	VL53L0X_StartContinuous(VL53L0X_I2C_ADDRESS, 100);
+	Sim_Run(SIM_RUN_US, &run);
+	VL53L0X_StopContinuous(VL53L0X_I2C_ADDRESS);
+	printf("\ntemporizado 100 ms: %u amostras em 2 s, %.2f transacoes/amostra\n", run.samples,
+			(double) run.bus.transfers / (run.samples ? run.samples : 1));
+	if ((run.samples < 19) || (run.samples > 21))
+	{
+		printf("FAIL: esperado 20 amostras\n");
+		errors++;
+	}
+
+	/* Parado: nenhuma medida */
+	Sim_Run(500000ULL, &run);
+	if (run.bus.measurements != 0)
+	{
+		printf("FAIL: %u medidas apos parar\n", run.bus.measurements);
+		errors++;
+	}
+
+	/* Medida unica */
+	if (VL53L0X_ReadSingle(VL53L0X_I2C_ADDRESS, &result) != HAL_OK)
+	{
+		printf("FAIL: medida unica\n");
+		errors++;
+	}
+	else
+	{
+		printf("unica: %u mm status %u sinal %.2f MCPS\n", result.range_mm, result.status, result.signal / 128.0);
+	}
+
+	/* Caminho do registro: 10 Hz temporizado, 30 Hz emendado, desligado */
+	VL53L0X_Driver.set_odr(0, 10000);
+	VL53L0X_Driver.set_power(0, SENSOR_POWER_NORMAL);
+	printf("registro 10 Hz: periodo %u ms\n", VL53L0X_GetPeriod());
+	Sim_Run(1000000ULL, &run);
+	errors += (run.samples < 9) || (run.samples > 11);
+
+	VL53L0X_Driver.set_odr(0, 30000);
+	VL53L0X_Driver.set_power(0, SENSOR_POWER_NORMAL);
+	printf("registro 30 Hz: intervalo %u ms (emendadas)\n", VL53L0X_GetPeriod());
+	Sim_Run(1000000ULL, &run);
+	printf("  %u amostras em 1 s\n", run.samples);
+	errors += (run.samples < 25);
+
+	VL53L0X_Driver.set_power(0, SENSOR_POWER_OFF);
+	Sim_Run(500000ULL, &run);
+	errors += (run.bus.measurements != 0);
+
+	/* Um registro de uma medida so pelo one_shot */
+	if ((VL53L0X_Driver.one_shot(0) != HAL_OK) || (VL53L0X_Driver.read_raw(0, &raw) != HAL_OK))
+	{
+		printf("FAIL: one_shot\n");
+		errors++;
+	}
+	else
+	{
+		printf("one_shot: %d mm\n", raw);
+	}
+
+	/* Fora do alcance */
+	VL53L0X_Model_SetTarget(2600);
+	if ((VL53L0X_ReadSingle(VL53L0X_I2C_ADDRESS, &result) != HAL_OK) || (result.status == VL53L0X_RANGE_VALID))
+	{
+		printf("FAIL: alvo a 2.6 m deveria ser invalido\n");
+		errors++;
+	}
+
+	printf("\n%s\n", errors ? "FALHOU" : "OK");
+
+	return errors ? 1 : 0;
+}